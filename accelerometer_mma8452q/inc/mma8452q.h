@@ -292,6 +292,28 @@ typedef struct {
   bool                          enable;             // set to active mode
 } mma8452q_sensor_config_t;
 
+/***************************************************************************//**
+ * @brief
+ *    Structure to store a sample captured by the data ready interrupt
+ ******************************************************************************/
+typedef struct {
+  uint32_t timestamp;        // sleeptimer tick count at the data ready edge
+  int16_t accel[3];          // raw x, y, z data, see
+                             //   sl_mma8452q_get_acceleration()
+  uint8_t status;            // STATUS register, ZYXOW set if the sensor
+                             //   overwrote a sample that was not read
+  uint8_t int_source;        // INT_SOURCE register, 0 if events are not read
+  uint8_t ff_mt_src;         // FF_MT_SRC if flagged in int_source, else 0
+  uint8_t trans_src;         // TRANSIENT_SRC if flagged in int_source, else 0
+  uint8_t pulse_src;         // PULSE_SRC if flagged in int_source, else 0
+} mma8452q_sample_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Callback invoked from the interrupt context for each streamed sample
+ ******************************************************************************/
+typedef void (*mma8452q_stream_callback_t)(const mma8452q_sample_t *sample);
+
 #define MMA8452Q_ENUM(name) typedef uint8_t name; enum name ## _enum
 
 /***************************************************************************//**
@@ -669,6 +691,63 @@ sl_status_t mma8452q_deinit(void);
  ******************************************************************************/
 sl_status_t mma8452q_set_address(uint8_t i2c_address);
 
+/***************************************************************************//**
+ * @brief
+ *   This function starts a configuration transaction.
+ *
+ * @details
+ *   The control registers are mirrored in RAM, the mirror is loaded with a
+ *   single burst read on first use. This read also clears the latched
+ *   FF_MT_SRC, TRANSIENT_SRC and PULSE_SRC event flags.
+ *   Until mma8452q_config_commit() is called, the configuration functions
+ *   (mma8452q_set_scale(), mma8452q_set_odr(), mma8452q_config_pulse()...)
+ *   and mma8452q_active() only update the RAM mirror. Transactions can be
+ *   nested, only the outermost commit writes to the device.
+ *   Called outside of a transaction, each configuration function runs its
+ *   own transaction.
+ *
+ * @note
+ *   Registers written directly with mma8452q_write_register() are not
+ *   tracked by the RAM mirror.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t mma8452q_config_begin(void);
+
+/***************************************************************************//**
+ * @brief
+ *   This function writes the configuration changed since
+ *   mma8452q_config_begin() into the device.
+ *
+ * @details
+ *   Only the registers whose value changed are written, contiguous ones with
+ *   a single block write. The device enters standby once before the writes
+ *   and is left active or in standby as requested by mma8452q_active().
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_INVALID_STATE if no transaction is open.
+ *
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t mma8452q_config_commit(void);
+
+/***************************************************************************//**
+ * @brief
+ *   This function drops the configuration changed since
+ *   mma8452q_config_begin() and closes all open transactions.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_INVALID_STATE if no transaction is open.
+ ******************************************************************************/
+sl_status_t mma8452q_config_abort(void);
+
 /***************************************************************************//**
  * @brief
  *   This function sets the full-scale range of the x, y, and z axis
@@ -874,6 +953,106 @@ sl_status_t mma8452q_active(bool enable);
  ******************************************************************************/
 sl_status_t mma8452q_auto_calibrate(void);
 
+/***************************************************************************//**
+ * @brief
+ *   This function calibrates the zero-g offsets from the average of several
+ *   samples. The device must be in the FRONT orientation and kept still.
+ *
+ * @param[in] num_samples
+ *   Number of samples to average
+ *
+ * @note
+ *   While streaming the samples are taken from the stream buffer, otherwise
+ *   the data ready flag is polled.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_INVALID_PARAMETER if num_samples is 0.
+ *
+ *    SL_STATUS_TIMEOUT if the samples did not arrive in time.
+ *
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t mma8452q_calibrate(uint16_t num_samples);
+
+/***************************************************************************//**
+ * @brief
+ *   This function starts the interrupt driven acquisition. Each data ready
+ *   interrupt reads the STATUS and OUT_X..Z registers in one burst and
+ *   stores the sample with its timestamp in the stream buffer.
+ *
+ * @param[in] read_events
+ *   If true, INT_SOURCE is read after the burst, and the source registers
+ *   of the freefall/motion, transient and pulse events it flags are read
+ *   too, which also clears their latches.
+ *
+ * @param[in] callback
+ *   Invoked from the interrupt context after each sample, can be NULL
+ *
+ * @note
+ *   The data ready interrupt is routed to the pin set in mma8452q_config.h
+ *   and the device is set active. Register accesses from the application
+ *   are allowed while streaming, the data ready interrupt is held off
+ *   during them.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_INVALID_STATE if the stream is already running.
+ *
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t mma8452q_stream_start(bool read_events,
+                                  mma8452q_stream_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *   This function stops the interrupt driven acquisition. The samples left
+ *   in the stream buffer can still be read.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_INVALID_STATE if the stream is not running.
+ *
+ *    SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t mma8452q_stream_stop(void);
+
+/***************************************************************************//**
+ * @brief
+ *   This function takes the oldest sample from the stream buffer.
+ *
+ * @param[out] sample
+ *   The oldest sample
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *
+ *    SL_STATUS_EMPTY if there is no sample.
+ *
+ *    SL_STATUS_INVALID_PARAMETER if sample is NULL.
+ ******************************************************************************/
+sl_status_t mma8452q_stream_read(mma8452q_sample_t *sample);
+
+/***************************************************************************//**
+ * @brief
+ *   This function returns the number of samples in the stream buffer.
+ ******************************************************************************/
+uint32_t mma8452q_stream_get_count(void);
+
+/***************************************************************************//**
+ * @brief
+ *   This function returns the number of samples dropped because the stream
+ *   buffer was full, or because they could not be read from the device.
+ *
+ * @note
+ *   Samples overwritten inside the sensor are flagged by the ZYXOW bit of
+ *   the STATUS field of the next sample instead.
+ ******************************************************************************/
+uint32_t mma8452q_stream_get_overrun_count(void);
+
 /** @} (end addtogroup mma8452q) */
 #ifdef __cplusplus
 }
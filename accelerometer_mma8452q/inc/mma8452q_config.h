@@ -57,6 +57,23 @@ extern "C" {
 // I2C module used; note that I2CSPM handles the transfers
 #define MMA8452Q_CONFIG_I2C         SL_I2CSPM_QWIIC_PERIPHERAL
 
+/*
+ * GPIO port/pin connected to the MMA8452Q interrupt output used for the data
+ * ready interrupt when streaming. Use a port A/B pin to keep streaming in
+ * EM2/3.
+ */
+#define MMA8452Q_CONFIG_INT_PORT    gpioPortB
+#define MMA8452Q_CONFIG_INT_PIN     3
+
+// Interrupt output of the MMA8452Q connected to the pin [0:INT2, 1:INT1]
+#define MMA8452Q_CONFIG_INT_ROUTE_INT1  1
+
+// Number of samples held by the stream buffer, must be a power of two
+#define MMA8452Q_CONFIG_STREAM_BUFFER_SIZE  64
+
+// Number of samples averaged by mma8452q_auto_calibrate()
+#define MMA8452Q_CONFIG_CALIBRATION_SAMPLES 32
+
 /** @} (end addtogroup mma8452q_config) */
 
 #ifdef __cplusplus
@@ -41,6 +41,7 @@
 #include <mma8452q.h>
 #include <string.h>
 #include <sl_udelay.h>
+#include <sl_sleeptimer.h>
 
 /***************************************************************************//**
  * Definition
@@ -89,6 +90,36 @@
 #define  MMA8452Q_OFF_Y             0x30
 #define  MMA8452Q_OFF_Z             0x31
 
+#define  MMA8452Q_CTRL_REG1_ACTIVE  0x01
+#define  MMA8452Q_STATUS_ZYXDR      0x08
+
+// Control registers mirrored in RAM
+#define  MMA8452Q_SHADOW_FIRST      MMA8452Q_XYZ_DATA_CFG
+#define  MMA8452Q_SHADOW_LAST       MMA8452Q_OFF_Z
+#define  MMA8452Q_SHADOW_SIZE       (MMA8452Q_SHADOW_LAST \
+                                     - MMA8452Q_SHADOW_FIRST + 1)
+// Bit map of the writable registers of the shadow range, bit 0 is
+// XYZ_DATA_CFG. Status and reserved registers are never written.
+#define  MMA8452Q_SHADOW_WRITABLE   0xFFFEE869BULL
+// Clean registers bridged between two dirty ones in a block write
+#define  MMA8452Q_SHADOW_MERGE_GAP  2
+
+#define  MMA8452Q_STREAM_MASK       (MMA8452Q_CONFIG_STREAM_BUFFER_SIZE - 1)
+
+// Time allowed per averaged sample, the calibration runs at 200 Hz
+#define  MMA8452Q_CALIBRATION_TIMEOUT_MS  20
+
+// Stream buffer shared between the data ready interrupt and the application
+typedef struct {
+  mma8452q_sample_t buffer[MMA8452Q_CONFIG_STREAM_BUFFER_SIZE];
+  volatile uint32_t head;                   // written by the interrupt
+  volatile uint32_t tail;                   // written by the application
+  volatile uint32_t overruns;
+  mma8452q_stream_callback_t callback;
+  bool read_events;
+  volatile bool running;
+} mma8452q_stream_t;
+
 /***************************************************************************//**
  * Local Variables
  ******************************************************************************/
@@ -170,6 +201,26 @@ static mma8452q_sensor_config_t mma8452q_cfg = {
 static sl_i2cspm_t *_mma8452q_i2cspm_instance = MMA8452Q_CONFIG_I2C;
 static bool mma8452q_is_initialized = false;
 
+static uint8_t mma8452q_shadow[MMA8452Q_SHADOW_SIZE];  // Device registers
+static uint8_t mma8452q_pending[MMA8452Q_SHADOW_SIZE]; // Not yet committed
+static bool mma8452q_shadow_valid = false;
+static uint8_t mma8452q_config_depth = 0;
+static mma8452q_sensor_config_t mma8452q_cfg_saved; // Restored on abort
+
+static mma8452q_stream_t mma8452q_stream;
+
+/***************************************************************************//**
+ * Local Functions
+ ******************************************************************************/
+static void mma8452q_shadow_set(uint8_t addr, uint8_t mask, uint8_t value);
+static bool mma8452q_shadow_is_dirty(uint8_t index);
+static sl_status_t mma8452q_shadow_flush(void);
+static sl_status_t mma8452q_transfer(I2C_TransferSeq_TypeDef *seq);
+static sl_status_t mma8452q_read_sample(mma8452q_sample_t *sample,
+                                        bool read_events);
+static void mma8452q_int_pin_callback(uint8_t pin);
+static int32_t mma8452q_div_round(int32_t num, int32_t den);
+
 /***************************************************************************//**
 * Return the version information of the MMA8452Q.
 *******************************************************************************/
@@ -200,6 +251,8 @@ sl_status_t mma8452q_init(sl_i2cspm_t *i2cspm)
 
   // Update i2cspm instance
   _mma8452q_i2cspm_instance = i2cspm;
+  mma8452q_shadow_valid = false;
+  mma8452q_config_depth = 0;
 
   // Check WHO_AM_I register
   status = mma8452q_read_register(MMA8452Q_WHO_AM_I, &temp);
@@ -229,11 +282,19 @@ sl_status_t mma8452q_deinit(void)
     return SL_STATUS_NOT_INITIALIZED;
   }
 
+  if (mma8452q_stream.running) {
+    GPIO_ExtIntConfig(MMA8452Q_CONFIG_INT_PORT, MMA8452Q_CONFIG_INT_PIN,
+                      MMA8452Q_CONFIG_INT_PIN, false, false, false);
+    mma8452q_stream.running = false;
+  }
+
   // Reset device
   status = mma8452q_write_register(MMA8452Q_CTRL_REG2, 0x40);
 
   // Must to wait after reset device
   sl_udelay_wait(1000);
+  mma8452q_shadow_valid = false;
+  mma8452q_config_depth = 0;
 
   status |= mma8452q_active(false);
   mma8452q_is_initialized = false;
@@ -270,6 +331,8 @@ sl_status_t mma8452q_set_address(uint8_t i2c_address)
     mma8452q_cfg.dev_addr = prev_addr;
     return SL_STATUS_NOT_FOUND;
   }
+  // Another device, the shadow has to be reloaded
+  mma8452q_shadow_valid = false;
 
   if (status != SL_STATUS_OK) {
     return SL_STATUS_TRANSMIT;
@@ -282,69 +345,121 @@ sl_status_t mma8452q_set_address(uint8_t i2c_address)
 *******************************************************************************/
 sl_status_t mma8452q_active(bool enable)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp;
-
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG1, &temp);
+  sl_status_t status;
 
-  // active mode
-  if (enable == true) {
-    status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, temp | (0x01));
-    mma8452q_cfg.enable = true;
-  }
-  // standby mode
-  else {
-    status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, temp & ~(0x01));
-    mma8452q_cfg.enable = false;
+  mma8452q_cfg.enable = enable;
+  if (mma8452q_config_depth > 0) {
+    // Applied by the commit of the open transaction
+    return SL_STATUS_OK;
   }
 
+  status = mma8452q_config_begin();
   if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
+    return status;
   }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
 * Auto calibration method
 *******************************************************************************/
 sl_status_t mma8452q_auto_calibrate(void)
+{
+  return mma8452q_calibrate(MMA8452Q_CONFIG_CALIBRATION_SAMPLES);
+}
+
+/***************************************************************************//**
+* Calibrate the offsets from the average of several samples
+*******************************************************************************/
+sl_status_t mma8452q_calibrate(uint16_t num_samples)
 {
   sl_status_t status = SL_STATUS_OK;
-  int16_t data[3];
-  uint8_t offset[3];
+  mma8452q_sample_t sample;
+  int32_t sum[3] = { 0, 0, 0 };
+  int32_t offset;
+  uint16_t count = 0;
+  uint32_t start, timeout;
+  uint8_t *off_reg;
+  uint8_t i;
   mma8452q_odr_t prev_odr = mma8452q_cfg.odr;
   mma8452q_scale_t prev_scale = mma8452q_cfg.scale;
-  uint8_t is_data_ready = 0;
 
+  if (num_samples == 0) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status |= mma8452q_config_begin();
   status |= mma8452q_set_scale(MMA8452Q_SCALE_2G);
   status |= mma8452q_set_odr(MMA8452Q_ODR_200);
+  status |= mma8452q_active(true);
+  status |= mma8452q_config_commit();
 
   if (SL_STATUS_OK != status) {
     return SL_STATUS_TRANSMIT;
   }
 
-  // Wait for data status is ready
-  do {
-    status = mma8452q_check_for_data_ready(&is_data_ready);
-    if (SL_STATUS_OK != status) {
-      return status;
+  // Drop the streamed samples taken with the previous settings
+  mma8452q_stream.tail = mma8452q_stream.head;
+
+  timeout = sl_sleeptimer_ms_to_tick(MMA8452Q_CALIBRATION_TIMEOUT_MS)
+            * num_samples;
+  start = sl_sleeptimer_get_tick_count();
+  while (count < num_samples) {
+    if (mma8452q_stream.running) {
+      status = mma8452q_stream_read(&sample);
+      if (status == SL_STATUS_EMPTY) {
+        sample.status = 0;
+        status = SL_STATUS_OK;
+      }
+    } else {
+      // STATUS and data are read in one burst, the data is discarded unless
+      // the data ready flag was set
+      status = mma8452q_read_sample(&sample, false);
+    }
+    if (status != SL_STATUS_OK) {
+      break;
     }
-  } while (!is_data_ready);
-
-  status |= sl_mma8452q_get_acceleration(data);
-  offset[0] = (uint8_t)((((int16_t)data[0] / 2) * (-1)) >> 4);
-  offset[1] = (uint8_t)((((int16_t)data[1] / 2) * (-1)) >> 4);
-  offset[2] = (uint8_t)(((65536 - (int16_t)data[1] / 2) * (-1)) >> 4);
 
-  mma8452q_active(false);
-  status |= mma8452q_write_register(MMA8452Q_OFF_X, offset[0]);
-  status |= mma8452q_write_register(MMA8452Q_OFF_Y, offset[1]);
-  status |= mma8452q_write_register(MMA8452Q_OFF_Z, offset[2]);
-  mma8452q_active(true);
+    if (sample.status & MMA8452Q_STATUS_ZYXDR) {
+      for (i = 0; i < 3; i++) {
+        sum[i] += sample.accel[i] >> 4;
+      }
+      count++;
+    } else if ((sl_sleeptimer_get_tick_count() - start) > timeout) {
+      status = SL_STATUS_TIMEOUT;
+      break;
+    }
+  }
 
-  status |= mma8452q_set_scale(prev_scale);
-  status |= mma8452q_set_odr(prev_odr);
+  // Offsets, scale and rate are written with a single standby cycle
+  if (mma8452q_config_begin() != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
+  if (status == SL_STATUS_OK) {
+    // 12-bit data in the 2 g range is 1 mg/LSB and the offset registers are
+    // 2 mg/LSB. The FRONT orientation reads +1 g on the Z axis.
+    sum[2] -= (int32_t)count * 1024;
+    for (i = 0; i < 3; i++) {
+      off_reg = &mma8452q_pending[MMA8452Q_OFF_X + i - MMA8452Q_SHADOW_FIRST];
+      offset = (int8_t)*off_reg
+               - mma8452q_div_round(sum[i], 2 * (int32_t)count);
+      if (offset > INT8_MAX) {
+        offset = INT8_MAX;
+      } else if (offset < INT8_MIN) {
+        offset = INT8_MIN;
+      }
+      mma8452q_shadow_set(MMA8452Q_OFF_X + i, 0xFF, (uint8_t)offset);
+    }
+  }
+  mma8452q_set_scale(prev_scale);
+  mma8452q_set_odr(prev_odr);
+  if (mma8452q_config_commit() != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
 
+  if (status == SL_STATUS_TIMEOUT) {
+    return status;
+  }
   if (status != SL_STATUS_OK) {
     return SL_STATUS_TRANSMIT;
   }
@@ -561,39 +676,211 @@ sl_status_t mma8452q_get_pulse_status(uint8_t *pulse_status)
   return mma8452q_read_register(MMA8452Q_PULSE_SRC, pulse_status);
 }
 
+/***************************************************************************//**
+* Start the data ready interrupt driven acquisition
+*******************************************************************************/
+sl_status_t mma8452q_stream_start(bool read_events,
+                                  mma8452q_stream_callback_t callback)
+{
+  sl_status_t status;
+  mma8452q_sample_t sample;
+  bool active_hi = mma8452q_cfg.interrupt_cfg.int_active_hi;
+
+  if (mma8452q_stream.running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  mma8452q_stream.head = 0;
+  mma8452q_stream.tail = 0;
+  mma8452q_stream.overruns = 0;
+  mma8452q_stream.callback = callback;
+  mma8452q_stream.read_events = read_events;
+
+  // Route the data ready interrupt to the pin and start sampling
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG4, 0x01, 0x01);
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG5, 0x01,
+                      MMA8452Q_CONFIG_INT_ROUTE_INT1);
+  mma8452q_cfg.interrupt_cfg.en_drdy_int = true;
+  mma8452q_cfg.interrupt_cfg.cfg_drdy_int = MMA8452Q_CONFIG_INT_ROUTE_INT1;
+  mma8452q_cfg.enable = true;
+  status = mma8452q_config_commit();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  GPIOINT_Init();
+  GPIO_PinModeSet(MMA8452Q_CONFIG_INT_PORT,
+                  MMA8452Q_CONFIG_INT_PIN,
+                  gpioModeInputPullFilter,
+                  active_hi ? 0 : 1);
+  GPIOINT_CallbackRegister(MMA8452Q_CONFIG_INT_PIN,
+                           mma8452q_int_pin_callback);
+  GPIO_ExtIntConfig(MMA8452Q_CONFIG_INT_PORT,
+                    MMA8452Q_CONFIG_INT_PIN,
+                    MMA8452Q_CONFIG_INT_PIN,
+                    active_hi,
+                    !active_hi,
+                    true);
+  mma8452q_stream.running = true;
+
+  // The output stays asserted until the data is read, a sample that became
+  // ready before the pin was armed would never raise an edge
+  status = mma8452q_read_sample(&sample, false);
+  if (status != SL_STATUS_OK) {
+    mma8452q_stream_stop();
+    return SL_STATUS_TRANSMIT;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+* Stop the data ready interrupt driven acquisition
+*******************************************************************************/
+sl_status_t mma8452q_stream_stop(void)
+{
+  sl_status_t status;
+
+  if (!mma8452q_stream.running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  GPIO_ExtIntConfig(MMA8452Q_CONFIG_INT_PORT, MMA8452Q_CONFIG_INT_PIN,
+                    MMA8452Q_CONFIG_INT_PIN, false, false, false);
+  mma8452q_stream.running = false;
+
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG4, 0x01, 0x00);
+  mma8452q_cfg.interrupt_cfg.en_drdy_int = false;
+
+  return mma8452q_config_commit();
+}
+
+/***************************************************************************//**
+* Take the oldest sample from the stream buffer
+*******************************************************************************/
+sl_status_t mma8452q_stream_read(mma8452q_sample_t *sample)
+{
+  uint32_t tail = mma8452q_stream.tail;
+
+  // Check for Null pointer
+  if (sample == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (tail == mma8452q_stream.head) {
+    return SL_STATUS_EMPTY;
+  }
+
+  *sample = mma8452q_stream.buffer[tail & MMA8452Q_STREAM_MASK];
+  mma8452q_stream.tail = tail + 1;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+* Get the number of samples in the stream buffer
+*******************************************************************************/
+uint32_t mma8452q_stream_get_count(void)
+{
+  return mma8452q_stream.head - mma8452q_stream.tail;
+}
+
+/***************************************************************************//**
+* Get the number of dropped samples
+*******************************************************************************/
+uint32_t mma8452q_stream_get_overrun_count(void)
+{
+  return mma8452q_stream.overruns;
+}
+
+/***************************************************************************//**
+* Start a configuration transaction
+*******************************************************************************/
+sl_status_t mma8452q_config_begin(void)
+{
+  sl_status_t status;
+
+  if (mma8452q_config_depth == 0) {
+    if (mma8452q_shadow_valid == false) {
+      // Mirror the whole control register range in a single burst read
+      status = mma8452q_read_block(MMA8452Q_SHADOW_FIRST,
+                                   MMA8452Q_SHADOW_SIZE,
+                                   mma8452q_shadow);
+      if (status != SL_STATUS_OK) {
+        return SL_STATUS_TRANSMIT;
+      }
+      mma8452q_shadow_valid = true;
+    }
+    memcpy(mma8452q_pending, mma8452q_shadow, MMA8452Q_SHADOW_SIZE);
+    mma8452q_cfg_saved = mma8452q_cfg;
+  }
+  mma8452q_config_depth++;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+* Write the pending configuration into the device
+*******************************************************************************/
+sl_status_t mma8452q_config_commit(void)
+{
+  if (mma8452q_config_depth == 0) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  mma8452q_config_depth--;
+  if (mma8452q_config_depth > 0) {
+    // Nested transaction, the outermost commit writes the registers
+    return SL_STATUS_OK;
+  }
+
+  return mma8452q_shadow_flush();
+}
+
+/***************************************************************************//**
+* Drop the pending configuration
+*******************************************************************************/
+sl_status_t mma8452q_config_abort(void)
+{
+  if (mma8452q_config_depth == 0) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  mma8452q_config_depth = 0;
+  memcpy(mma8452q_pending, mma8452q_shadow, MMA8452Q_SHADOW_SIZE);
+  mma8452q_cfg = mma8452q_cfg_saved;
+
+  return SL_STATUS_OK;
+}
+
 /***************************************************************************//**
 * Set full scale range of x, y and z axis accelerometers
 *******************************************************************************/
 sl_status_t mma8452q_set_scale(mma8452q_scale_t scale)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t cfg;
+  sl_status_t status;
+
   if ((scale != MMA8452Q_SCALE_2G) && (scale != MMA8452Q_SCALE_4G)
       && (scale != MMA8452Q_SCALE_8G)) {
     return SL_STATUS_INVALID_PARAMETER;
   }
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
-  }
 
-  status |= mma8452q_read_register(MMA8452Q_XYZ_DATA_CFG, &cfg);
-  // Mask out scale bits
-  cfg &= 0xFC;
-  cfg |= (scale >> 2);
-  status |= mma8452q_write_register(MMA8452Q_XYZ_DATA_CFG, cfg);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  // Scale bits
+  mma8452q_shadow_set(MMA8452Q_XYZ_DATA_CFG, 0x03, (uint8_t)(scale >> 2));
 
   // Update local variables
   mma8452q_cfg.scale = scale;
-  // Change to active mode
-  mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -601,36 +888,23 @@ sl_status_t mma8452q_set_scale(mma8452q_scale_t scale)
 *******************************************************************************/
 sl_status_t mma8452q_set_odr(mma8452q_odr_t odr)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t ctrl;
+  sl_status_t status;
 
   if (odr > MMA8452Q_ODR_1) {
     return SL_STATUS_INVALID_PARAMETER;
   }
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
-  }
 
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG1, &ctrl);
-
-  // Mask out data rate bits
-  ctrl &= 0xC7;
-  ctrl |= (odr << 3);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, ctrl);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  // Data rate bits
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG1, 0x38, (uint8_t)(odr << 3));
 
   // Update local variables
   mma8452q_cfg.odr = odr;
 
-  // Change to active mode
-  mma8452q_active(true);
-
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -638,33 +912,23 @@ sl_status_t mma8452q_set_odr(mma8452q_odr_t odr)
 *******************************************************************************/
 sl_status_t mma8452q_set_mods(mma8452q_mods_t mods)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t ctrl;
+  sl_status_t status;
 
   if (mods > MMA8452Q_LPWR) {
     return SL_STATUS_INVALID_PARAMETER;
   }
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG2, &ctrl);
-  // Mask out data rate bits
-  ctrl &= 0x03;
-  ctrl |= mods;
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG2, ctrl);
+  // Active mode power scheme bits
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG2, 0x03, (uint8_t)mods);
+
   // Update local variables
   mma8452q_cfg.active_mode_pwr = mods;
 
-  // Change to active mode
-  status |= mma8452q_active(true);
-
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -674,51 +938,29 @@ sl_status_t mma8452q_config_aslp(mma8452q_aslp_odr_t alsp_rate,
                                  mma8452q_mods_t slp_mode_pwr,
                                  mma8452q_aslp_config_t aslp_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t ctrl;
+  sl_status_t status;
 
   if ((alsp_rate > MMA8452Q_ASLP_ODR_1p56) || (slp_mode_pwr > MMA8452Q_LPWR)) {
     return SL_STATUS_INVALID_PARAMETER;
   }
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
-  }
 
-  // Config sleep mode rate
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG1, &ctrl);
-
-  // Mask out data rate bits
-  ctrl &= 0x3F;
-  ctrl |= (alsp_rate << 5);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, ctrl);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  // Sleep mode rate bits
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG1, 0xC0, (uint8_t)(alsp_rate << 6));
+  // Sleep power mode bits
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG2, 0x18, (uint8_t)(slp_mode_pwr << 3));
+  // Counter autosleep
+  mma8452q_shadow_set(MMA8452Q_ASLP_COUNT, 0xFF, aslp_cfg.alsp_count);
 
   // Update local variables
   mma8452q_cfg.alsp_rate = alsp_rate;
-
-  // Config sleep power mode
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG2, &ctrl);
-  // Mask out data rate bits
-  ctrl &= 0xC7;
-  ctrl |= (slp_mode_pwr << 3);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG2, ctrl);
-  // Update local variables
   mma8452q_cfg.slp_mode_pwr = slp_mode_pwr;
-
-  // Config counter autosleep
-  status |= mma8452q_write_register(MMA8452Q_ASLP_COUNT, aslp_cfg.alsp_count);
-  // Update local variables
   mma8452q_cfg.aslp_cfg = aslp_cfg;
 
-  // Change to active mode
-  status |= mma8452q_active(true);
-
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -726,44 +968,38 @@ sl_status_t mma8452q_config_aslp(mma8452q_aslp_odr_t alsp_rate,
 *******************************************************************************/
 sl_status_t mma8452q_config_trans(mma8452q_trans_config_t *trans_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp = 0;
-  uint8_t sysmode = 0;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  // Check for Null pointer
+  if (trans_cfg == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
 
   // Configure TRANSIENT_CFG register
-  temp =
+  mma8452q_shadow_set(MMA8452Q_TRANSIENT_CFG, 0xFF,
     (uint8_t)(((uint8_t)trans_cfg->en_event_latch << 4)
               | ((uint8_t)trans_cfg->en_z_trans << 3)
               | ((uint8_t)trans_cfg->en_y_trans << 2)
               | ((uint8_t)trans_cfg->en_x_trans << 1)
-              | ((uint8_t)trans_cfg->en_hpf_bypass));
-  status |= mma8452q_write_register(MMA8452Q_TRANSIENT_CFG, temp);
+              | ((uint8_t)trans_cfg->en_hpf_bypass)));
 
   // Configure TRANSIENT_THS register
-  temp =
+  mma8452q_shadow_set(MMA8452Q_TRANSIENT_THS, 0xFF,
     (uint8_t)(((uint8_t)trans_cfg->db_cnt_mode << 7)
-              | (trans_cfg->threshold & 0x7F));
-  status |= mma8452q_write_register(MMA8452Q_TRANSIENT_THS, temp);
+              | (trans_cfg->threshold & 0x7F)));
 
   // Configure TRANSIENT_COUNT register
-  status |= mma8452q_write_register(MMA8452Q_TRANSIENT_COUNT,
-                                    trans_cfg->debounce_cnt);
+  mma8452q_shadow_set(MMA8452Q_TRANSIENT_COUNT, 0xFF, trans_cfg->debounce_cnt);
 
   // Update local variables
   mma8452q_cfg.trans_cfg = *trans_cfg;
-  // Change to active mode
-  status |= mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -772,31 +1008,22 @@ sl_status_t mma8452q_config_trans(mma8452q_trans_config_t *trans_cfg)
 sl_status_t mma8452q_config_orientation(
   mma8452q_orientation_config_t orient_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp = 0;
-  uint8_t sysmode = 0;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
-  temp =
-    (uint8_t)(((uint8_t)orient_cfg.db_cnt_mode << 7)
-              | ((uint8_t)orient_cfg.en_event_latch << 6));
-  status |= mma8452q_write_register(MMA8452Q_PL_CFG, temp);
 
-  status |= mma8452q_write_register(MMA8452Q_PL_COUNT, orient_cfg.debounce_cnt);
+  mma8452q_shadow_set(MMA8452Q_PL_CFG, 0xFF,
+    (uint8_t)(((uint8_t)orient_cfg.db_cnt_mode << 7)
+              | ((uint8_t)orient_cfg.en_event_latch << 6)));
+  mma8452q_shadow_set(MMA8452Q_PL_COUNT, 0xFF, orient_cfg.debounce_cnt);
 
   // Update local variables
   mma8452q_cfg.orient_cfg = orient_cfg;
-  // Change to active mode
-  status |= mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -804,17 +1031,19 @@ sl_status_t mma8452q_config_orientation(
 *******************************************************************************/
 sl_status_t mma8452q_config_pulse(mma8452q_pulse_config_t *pulse_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp = 0;
-  uint8_t sysmode = 0;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  // Check for Null pointer
+  if (pulse_cfg == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
 
-  temp =
+  mma8452q_shadow_set(MMA8452Q_PULSE_CFG, 0xFF,
     (uint8_t)(((uint8_t)pulse_cfg->double_abort << 7)
               | ((uint8_t)pulse_cfg->en_event_latch << 6)
               | ((uint8_t)pulse_cfg->en_z_double << 5)
@@ -822,31 +1051,19 @@ sl_status_t mma8452q_config_pulse(mma8452q_pulse_config_t *pulse_cfg)
               | ((uint8_t)pulse_cfg->en_y_double << 3)
               | ((uint8_t)pulse_cfg->en_y_single << 2)
               | ((uint8_t)pulse_cfg->en_x_double << 1)
-              | (uint8_t)pulse_cfg->en_z_single);
-  status |= mma8452q_write_register(MMA8452Q_PULSE_CFG, temp);
-
-  status |= mma8452q_write_register(MMA8452Q_PULSE_THSX,
-                                    pulse_cfg->pulse_thresh_X);
-  status |= mma8452q_write_register(MMA8452Q_PULSE_THSY,
-                                    pulse_cfg->pulse_thresh_y);
-  status |= mma8452q_write_register(MMA8452Q_PULSE_THSZ,
-                                    pulse_cfg->pulse_thresh_z);
-  status |= mma8452q_write_register(MMA8452Q_PULSE_TMLT,
-                                    pulse_cfg->pulse_time_lmt);
-  status |=
-    mma8452q_write_register(MMA8452Q_PULSE_LTCY, pulse_cfg->pulse_latency);
-  status |=
-    mma8452q_write_register(MMA8452Q_PULSE_WIND, pulse_cfg->pulse_window);
+              | (uint8_t)pulse_cfg->en_x_single));
+
+  mma8452q_shadow_set(MMA8452Q_PULSE_THSX, 0xFF, pulse_cfg->pulse_thresh_X);
+  mma8452q_shadow_set(MMA8452Q_PULSE_THSY, 0xFF, pulse_cfg->pulse_thresh_y);
+  mma8452q_shadow_set(MMA8452Q_PULSE_THSZ, 0xFF, pulse_cfg->pulse_thresh_z);
+  mma8452q_shadow_set(MMA8452Q_PULSE_TMLT, 0xFF, pulse_cfg->pulse_time_lmt);
+  mma8452q_shadow_set(MMA8452Q_PULSE_LTCY, 0xFF, pulse_cfg->pulse_latency);
+  mma8452q_shadow_set(MMA8452Q_PULSE_WIND, 0xFF, pulse_cfg->pulse_window);
 
   // Update local variables
   mma8452q_cfg.pulse_cfg = *pulse_cfg;
-  // Change to active mode
-  status |= mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -854,37 +1071,32 @@ sl_status_t mma8452q_config_pulse(mma8452q_pulse_config_t *pulse_cfg)
 *******************************************************************************/
 sl_status_t mma8452q_config_ff_mt(mma8452q_ff_mt_config_t *ff_mt_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp = 0;
-  uint8_t sysmode = 0;
+  sl_status_t status;
+
+  // Check for Null pointer
+  if (ff_mt_cfg == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
 
-  temp =
+  mma8452q_shadow_set(MMA8452Q_FF_MT_CFG, 0xFF,
     (uint8_t)(((uint8_t)ff_mt_cfg->en_event_latch << 7)
               | ((uint8_t)ff_mt_cfg->ff_mt_sel << 6)
               | ((uint8_t)ff_mt_cfg->en_z_trans << 5)
               | ((uint8_t)ff_mt_cfg->en_y_trans << 4)
-              | ((uint8_t)ff_mt_cfg->en_x_trans << 3));
-  status |= mma8452q_write_register(MMA8452Q_FF_MT_CFG, temp);
+              | ((uint8_t)ff_mt_cfg->en_x_trans << 3)));
 
-  status |= mma8452q_write_register(MMA8452Q_FF_MT_THS, ff_mt_cfg->threshold);
-  status |=
-    mma8452q_write_register(MMA8452Q_FF_MT_COUNT, ff_mt_cfg->debounce_cnt);
+  mma8452q_shadow_set(MMA8452Q_FF_MT_THS, 0xFF, ff_mt_cfg->threshold);
+  mma8452q_shadow_set(MMA8452Q_FF_MT_COUNT, 0xFF, ff_mt_cfg->debounce_cnt);
 
   // Update local variables
   mma8452q_cfg.ff_mt_cfg = *ff_mt_cfg;
-  // Change to active mode
-  status |= mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -893,52 +1105,46 @@ sl_status_t mma8452q_config_ff_mt(mma8452q_ff_mt_config_t *ff_mt_cfg)
 sl_status_t mma8452q_config_interrupt(
   mma8452q_interrupt_config_t *interrupt_cfg)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t temp = 0;
-  uint8_t sysmode = 0;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  // Check for Null pointer
+  if (interrupt_cfg == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
 
-  temp =
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG3, 0xFF,
     (uint8_t)(((uint8_t)interrupt_cfg->en_trans_wake << 6)
               | ((uint8_t)interrupt_cfg->en_orientation_wake << 5)
               | ((uint8_t)interrupt_cfg->en_pulse_wake << 4)
               | ((uint8_t)interrupt_cfg->en_ff_mt_wake << 3)
               | ((uint8_t)interrupt_cfg->int_active_hi << 1)
-              | (uint8_t)interrupt_cfg->int_open_drain);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG3, temp);
+              | (uint8_t)interrupt_cfg->int_open_drain));
 
-  temp =
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG4, 0xFF,
     (uint8_t)(((uint8_t)interrupt_cfg->en_aslp_int << 7)
               | ((uint8_t)interrupt_cfg->en_trans_int << 5)
               | ((uint8_t)interrupt_cfg->en_orientation_int << 4)
               | ((uint8_t)interrupt_cfg->en_pulse_int << 3)
               | ((uint8_t)interrupt_cfg->en_ff_mt_int << 2)
-              | (uint8_t)interrupt_cfg->en_drdy_int);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG4, temp);
+              | (uint8_t)interrupt_cfg->en_drdy_int));
 
-  temp =
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG5, 0xFF,
     (uint8_t)(((uint8_t)interrupt_cfg->cfg_aslp_int << 7)
               | ((uint8_t)interrupt_cfg->cfg_trans_int << 5)
               | ((uint8_t)interrupt_cfg->cfg_orientation_int << 4)
               | ((uint8_t)interrupt_cfg->cfg_pulse_int << 3)
               | ((uint8_t)interrupt_cfg->cfg_ff_mt_int << 2)
-              | (uint8_t)interrupt_cfg->cfg_drdy_int);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG5, temp);
+              | (uint8_t)interrupt_cfg->cfg_drdy_int));
 
   // Update local variables
   mma8452q_cfg.interrupt_cfg = *interrupt_cfg;
-  // Change to active mode
-  status |= mma8452q_active(true);
 
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -946,33 +1152,19 @@ sl_status_t mma8452q_config_interrupt(
 *******************************************************************************/
 sl_status_t mma8452q_enable_low_noise(bool enable)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t ctrl;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
-
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG1, &ctrl);
-
-  // Mask out data rate bits
-  ctrl &= 0x7F;
-  ctrl |= ((uint8_t)enable << 2);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, ctrl);
+  // Reduced noise bit
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG1, 0x04, (uint8_t)((uint8_t)enable << 2));
 
   // Update local variables
   mma8452q_cfg.en_low_noise = enable;
 
-  // Change to active mode
-  status |= mma8452q_active(true);
-
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -980,33 +1172,19 @@ sl_status_t mma8452q_enable_low_noise(bool enable)
 *******************************************************************************/
 sl_status_t mma8452q_enable_fast_read(bool enable)
 {
-  sl_status_t status = SL_STATUS_OK;
-  uint8_t sysmode = 0;
-  uint8_t ctrl;
+  sl_status_t status;
 
-  // Change to standby if currently in other state
-  status |= mma8452q_get_sysmode(&sysmode);
-  if (sysmode != 0b00) {
-    status |= mma8452q_active(false);
+  status = mma8452q_config_begin();
+  if (status != SL_STATUS_OK) {
+    return status;
   }
-
-  status |= mma8452q_read_register(MMA8452Q_CTRL_REG1, &ctrl);
-
-  // Mask out data rate bits
-  ctrl &= 0xFD;
-  ctrl |= ((uint8_t)enable << 1);
-  status |= mma8452q_write_register(MMA8452Q_CTRL_REG1, ctrl);
+  // Fast read bit
+  mma8452q_shadow_set(MMA8452Q_CTRL_REG1, 0x02, (uint8_t)((uint8_t)enable << 1));
 
   // Update local variables
   mma8452q_cfg.en_fast_read = enable;
 
-  // Change to active mode
-  status |= mma8452q_active(true);
-
-  if (status != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_config_commit();
 }
 
 /***************************************************************************//**
@@ -1033,10 +1211,7 @@ sl_status_t mma8452q_read_register(uint8_t addr, uint8_t *data)
     seq.buf[1].data = data;
     seq.buf[1].len = 1;
 
-    if (I2CSPM_Transfer(_mma8452q_i2cspm_instance, &seq) != i2cTransferDone) {
-      return SL_STATUS_TRANSMIT;
-    }
-    return SL_STATUS_OK;
+    return mma8452q_transfer(&seq);
   }
 }
 
@@ -1058,10 +1233,7 @@ sl_status_t mma8452q_write_register(uint8_t addr, uint8_t data)
   seq.buf[0].data = i2c_write_data;
   seq.buf[0].len = 2;
 
-  if (I2CSPM_Transfer(_mma8452q_i2cspm_instance, &seq) != i2cTransferDone) {
-    return SL_STATUS_TRANSMIT;
-  }
-  return SL_STATUS_OK;
+  return mma8452q_transfer(&seq);
 }
 
 /***************************************************************************//**
@@ -1088,10 +1260,7 @@ sl_status_t mma8452q_read_block(uint8_t addr, uint8_t num_bytes, uint8_t *data)
     seq.buf[1].data = data;
     seq.buf[1].len = num_bytes;
 
-    if (I2CSPM_Transfer(_mma8452q_i2cspm_instance, &seq) != i2cTransferDone) {
-      return SL_STATUS_TRANSMIT;
-    }
-    return SL_STATUS_OK;
+    return mma8452q_transfer(&seq);
   }
 }
 
@@ -1112,10 +1281,235 @@ sl_status_t mma8452q_write_block(uint8_t addr, uint8_t num_bytes, uint8_t *data)
 
   /*Write buffer*/
   seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len = num_bytes;
+  seq.buf[0].len = num_bytes + 1;
+
+  return mma8452q_transfer(&seq);
+}
+
+/***************************************************************************//**
+* Update bits of a register in the pending configuration
+*******************************************************************************/
+static void mma8452q_shadow_set(uint8_t addr, uint8_t mask, uint8_t value)
+{
+  uint8_t *reg = &mma8452q_pending[addr - MMA8452Q_SHADOW_FIRST];
+
+  *reg = (uint8_t)((*reg & ~mask) | (value & mask));
+}
+
+/***************************************************************************//**
+* Check if a register of the pending configuration differs from the device
+*******************************************************************************/
+static bool mma8452q_shadow_is_dirty(uint8_t index)
+{
+  uint8_t diff = mma8452q_pending[index] ^ mma8452q_shadow[index];
+
+  if (index == MMA8452Q_CTRL_REG1 - MMA8452Q_SHADOW_FIRST) {
+    // The active bit is handled separately
+    diff &= (uint8_t)~MMA8452Q_CTRL_REG1_ACTIVE;
+  }
+  return diff != 0;
+}
+
+/***************************************************************************//**
+* Write the dirty registers of the pending configuration
+*******************************************************************************/
+static sl_status_t mma8452q_shadow_flush(void)
+{
+  sl_status_t status = SL_STATUS_OK;
+  const uint8_t ctrl1 = MMA8452Q_CTRL_REG1 - MMA8452Q_SHADOW_FIRST;
+  uint8_t active = mma8452q_cfg.enable ? MMA8452Q_CTRL_REG1_ACTIVE : 0;
+  uint8_t first = MMA8452Q_SHADOW_SIZE;
+  uint8_t start, last, i;
+
+  for (i = 0; i < MMA8452Q_SHADOW_SIZE; i++) {
+    if (mma8452q_shadow_is_dirty(i)) {
+      first = i;
+      break;
+    }
+  }
+
+  if (first < MMA8452Q_SHADOW_SIZE) {
+    // Registers can only be changed in standby, enter it once
+    if (mma8452q_shadow[ctrl1] & MMA8452Q_CTRL_REG1_ACTIVE) {
+      mma8452q_shadow[ctrl1] &= (uint8_t)~MMA8452Q_CTRL_REG1_ACTIVE;
+      status |= mma8452q_write_register(MMA8452Q_CTRL_REG1,
+                                        mma8452q_shadow[ctrl1]);
+    }
+    mma8452q_pending[ctrl1] &= (uint8_t)~MMA8452Q_CTRL_REG1_ACTIVE;
+
+    // Write runs of dirty registers, bridging short gaps of clean writable
+    // registers to save the transaction overhead
+    i = first;
+    while (i < MMA8452Q_SHADOW_SIZE) {
+      if (!mma8452q_shadow_is_dirty(i)) {
+        i++;
+        continue;
+      }
+      start = i;
+      last = i;
+      for (i = start + 1; i < MMA8452Q_SHADOW_SIZE; i++) {
+        if (!(MMA8452Q_SHADOW_WRITABLE & (1ULL << i))) {
+          break;
+        }
+        if (mma8452q_shadow_is_dirty(i)) {
+          last = i;
+        } else if ((i - last) > MMA8452Q_SHADOW_MERGE_GAP) {
+          break;
+        }
+      }
+      status |= mma8452q_write_block(MMA8452Q_SHADOW_FIRST + start,
+                                     last - start + 1,
+                                     &mma8452q_pending[start]);
+      memcpy(&mma8452q_shadow[start], &mma8452q_pending[start],
+             last - start + 1);
+      i = last + 1;
+    }
+  }
+
+  // Leave the device in the requested mode
+  mma8452q_pending[ctrl1] = (uint8_t)((mma8452q_pending[ctrl1]
+                                       & ~MMA8452Q_CTRL_REG1_ACTIVE) | active);
+  if (mma8452q_pending[ctrl1] != mma8452q_shadow[ctrl1]) {
+    status |= mma8452q_write_register(MMA8452Q_CTRL_REG1,
+                                      mma8452q_pending[ctrl1]);
+    mma8452q_shadow[ctrl1] = mma8452q_pending[ctrl1];
+  }
+
+  if (status != SL_STATUS_OK) {
+    // Device state is unknown, reload the shadow on next use
+    mma8452q_shadow_valid = false;
+    return SL_STATUS_TRANSMIT;
+  }
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+* Run an I2C transfer with the sensor
+*******************************************************************************/
+static sl_status_t mma8452q_transfer(I2C_TransferSeq_TypeDef *seq)
+{
+  I2C_TransferReturn_TypeDef ret;
+  bool hold_off = mma8452q_stream.running;
+
+  // Keep the data ready interrupt from starting a transfer in the middle of
+  // this one, an edge during the transfer is serviced right after it
+  if (hold_off) {
+    GPIO_IntDisable(1 << MMA8452Q_CONFIG_INT_PIN);
+  }
+  ret = I2CSPM_Transfer(_mma8452q_i2cspm_instance, seq);
+  if (hold_off) {
+    GPIO_IntEnable(1 << MMA8452Q_CONFIG_INT_PIN);
+  }
 
-  if (I2CSPM_Transfer(_mma8452q_i2cspm_instance, &seq) != i2cTransferDone) {
+  if (ret != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
   }
   return SL_STATUS_OK;
 }
+
+/***************************************************************************//**
+* Read the STATUS and data registers, and optionally the event sources
+*******************************************************************************/
+static sl_status_t mma8452q_read_sample(mma8452q_sample_t *sample,
+                                        bool read_events)
+{
+  sl_status_t status;
+  uint8_t raw[7];
+  uint8_t len;
+  uint8_t i;
+
+  // The register pointer wraps back to STATUS after the last data register,
+  // so INT_SOURCE cannot be reached in the same burst
+  if (mma8452q_cfg.en_fast_read) {
+    // STATUS followed by the MSB of each axis
+    len = 4;
+  } else {
+    len = 7;
+  }
+
+  status = mma8452q_read_block(MMA8452Q_STATUS, len, raw);
+  if (status != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  sample->status = raw[0];
+  for (i = 0; i < 3; i++) {
+    if (mma8452q_cfg.en_fast_read) {
+      sample->accel[i] = (int16_t)((uint16_t)raw[1 + i] << 8);
+    } else {
+      sample->accel[i] = (int16_t)((uint16_t)raw[1 + 2 * i] << 8
+                                   | raw[2 + 2 * i]);
+    }
+  }
+
+  sample->int_source = 0;
+  sample->ff_mt_src = 0;
+  sample->trans_src = 0;
+  sample->pulse_src = 0;
+  if (read_events) {
+    status |= mma8452q_read_register(MMA8452Q_INT_SOURCE,
+                                     &sample->int_source);
+    // Reading the sources clears the latched events
+    if (sample->int_source & MMA8452Q_MASK_IRQ_SRC_FF_MT) {
+      status |= mma8452q_read_register(MMA8452Q_FF_MT_SRC,
+                                       &sample->ff_mt_src);
+    }
+    if (sample->int_source & MMA8452Q_MASK_IRQ_SRC_TRANS) {
+      status |= mma8452q_read_register(MMA8452Q_TRANSIENT_SRC,
+                                       &sample->trans_src);
+    }
+    if (sample->int_source & MMA8452Q_MASK_IRQ_SRC_PULSE) {
+      status |= mma8452q_read_register(MMA8452Q_PULSE_SRC,
+                                       &sample->pulse_src);
+    }
+  }
+
+  if (status != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Data ready interrupt callback, reads the sample into the stream buffer.
+ *
+ * @param[in] pin  Pin number where interrupt occurs
+ *
+ * @note This function is called from ISR context.
+ ******************************************************************************/
+static void mma8452q_int_pin_callback(uint8_t pin)
+{
+  uint32_t head = mma8452q_stream.head;
+  uint32_t timestamp = sl_sleeptimer_get_tick_count();
+  mma8452q_sample_t discard;
+  mma8452q_sample_t *sample;
+  bool full;
+
+  (void)pin;
+
+  // The sample has to be read even if it cannot be kept, reading the data
+  // releases the interrupt output for the next one
+  full = (head - mma8452q_stream.tail) >= MMA8452Q_CONFIG_STREAM_BUFFER_SIZE;
+  sample = full ? &discard
+           : &mma8452q_stream.buffer[head & MMA8452Q_STREAM_MASK];
+
+  if ((mma8452q_read_sample(sample, mma8452q_stream.read_events)
+       != SL_STATUS_OK) || full) {
+    mma8452q_stream.overruns++;
+    return;
+  }
+  sample->timestamp = timestamp;
+  mma8452q_stream.head = head + 1;
+
+  if (mma8452q_stream.callback != NULL) {
+    mma8452q_stream.callback(sample);
+  }
+}
+
+/***************************************************************************//**
+* Divide and round to the nearest integer
+*******************************************************************************/
+static int32_t mma8452q_div_round(int32_t num, int32_t den)
+{
+  return (num >= 0) ? (num + den / 2) / den : (num - den / 2) / den;
+}
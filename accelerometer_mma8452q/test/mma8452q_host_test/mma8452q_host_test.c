@@ -0,0 +1,378 @@
+/***************************************************************************//**
+ * @file mma8452q_host_test.c
+ * @brief Host test of the MMA8452Q driver.
+ *
+ * Runs the driver against a register map model. Counts the I2C transactions
+ * of a full reconfiguration, streams samples through the data ready
+ * interrupt, reads the event sources and checks the calibration.
+ *
+ * Build and run on the host:
+ *   gcc -Wall -I../../inc -Imock mma8452q_host_test.c mma8452q_mock.c \
+ *       ../../src/mma8452q.c
+ *   ./a.out
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "mma8452q_config.h"
+#include "mma8452q.h"
+#include "mma8452q_mock.h"
+
+#define CHECK(cond)                                        \
+  do {                                                     \
+    if (!(cond)) {                                         \
+      printf("  FAILED line %d: %s\n", __LINE__, #cond);   \
+      failed = 1;                                          \
+    }                                                      \
+  } while (0)
+
+static int failed = 0;
+static sl_i2cspm_t i2cspm;
+
+static mma8452q_trans_config_t trans_cfg = {
+  .en_event_latch = true,
+  .en_z_trans = true,
+  .en_x_trans = true,
+  .threshold = 0x10,
+  .debounce_cnt = 0x05
+};
+
+static mma8452q_orientation_config_t orient_cfg = {
+  .db_cnt_mode = true,
+  .en_event_latch = true,
+  .debounce_cnt = 0x30
+};
+
+static mma8452q_pulse_config_t pulse_cfg = {
+  .en_event_latch = true,
+  .en_z_single = true,
+  .en_x_single = true,
+  .pulse_thresh_z = 0x20,
+  .pulse_thresh_y = 0x20,
+  .pulse_thresh_X = 0x20,
+  .pulse_time_lmt = 0x18,
+  .pulse_latency = 0x28,
+  .pulse_window = 0x3C
+};
+
+static mma8452q_ff_mt_config_t ff_mt_cfg = {
+  .en_event_latch = true,
+  .ff_mt_sel = true,
+  .en_z_trans = true,
+  .threshold = 0x11,
+  .debounce_cnt = 0x02
+};
+
+static mma8452q_interrupt_config_t int_cfg = {
+  .en_trans_int = true,
+  .en_pulse_int = true,
+  .en_ff_mt_int = true,
+  .cfg_pulse_int = true,
+  .en_drdy_int = true
+};
+
+static mma8452q_aslp_config_t aslp_cfg = {
+  .alsp_count = 0x20
+};
+
+// Full reconfiguration of the sensor
+static sl_status_t configure_all(void)
+{
+  sl_status_t status = SL_STATUS_OK;
+
+  status |= mma8452q_set_scale(MMA8452Q_SCALE_4G);
+  status |= mma8452q_set_odr(MMA8452Q_ODR_400);
+  status |= mma8452q_set_mods(MMA8452Q_HI_RES);
+  status |= mma8452q_config_aslp(MMA8452Q_ASLP_ODR_6p25, MMA8452Q_LPWR,
+                                 aslp_cfg);
+  status |= mma8452q_config_trans(&trans_cfg);
+  status |= mma8452q_config_orientation(orient_cfg);
+  status |= mma8452q_config_pulse(&pulse_cfg);
+  status |= mma8452q_config_ff_mt(&ff_mt_cfg);
+  status |= mma8452q_config_interrupt(&int_cfg);
+  status |= mma8452q_enable_low_noise(true);
+  status |= mma8452q_active(true);
+  return status;
+}
+
+static void print_stats(const char *name)
+{
+  const mma8452q_mock_stats_t *s = mma8452q_mock_stats();
+
+  printf("  %-28s %3u transactions (%u writes, %u reads), "
+         "%u standby entries\n",
+         name, s->transactions, s->writes, s->reads, s->standby_entries);
+}
+
+static uint32_t callback_count;
+
+static void stream_callback(const mma8452q_sample_t *sample)
+{
+  (void)sample;
+  callback_count++;
+}
+
+// Data ready streaming into the stream buffer
+static void test_stream(void)
+{
+  mma8452q_sample_t sample;
+  int16_t accel[3];
+  uint32_t prev_timestamp = 0;
+  uint32_t transactions;
+  uint32_t i;
+
+  printf("MMA8452Q streaming\n");
+
+  mma8452q_mock_reset();
+  CHECK(mma8452q_init(&i2cspm) == SL_STATUS_OK);
+  CHECK(mma8452q_stream_start(false, stream_callback) == SL_STATUS_OK);
+  CHECK(mma8452q_stream_start(false, NULL) == SL_STATUS_INVALID_STATE);
+  CHECK(mma8452q_stream_read(&sample) == SL_STATUS_EMPTY);
+
+  // One burst read per sample
+  mma8452q_mock_clear_stats();
+  for (i = 0; i < MMA8452Q_CONFIG_STREAM_BUFFER_SIZE + 10; i++) {
+    accel[0] = (int16_t)i;
+    accel[1] = (int16_t)-i;
+    accel[2] = 1024;
+    mma8452q_mock_data_ready(accel);
+  }
+  transactions = mma8452q_mock_stats()->transactions;
+  printf("  %u samples: %u transactions, %u buffered, %u overruns\n",
+         i, transactions, mma8452q_stream_get_count(),
+         mma8452q_stream_get_overrun_count());
+  CHECK(transactions == i);
+  CHECK(callback_count == MMA8452Q_CONFIG_STREAM_BUFFER_SIZE);
+  CHECK(mma8452q_stream_get_count() == MMA8452Q_CONFIG_STREAM_BUFFER_SIZE);
+  CHECK(mma8452q_stream_get_overrun_count() == 10);
+
+  for (i = 0; mma8452q_stream_read(&sample) == SL_STATUS_OK; i++) {
+    CHECK(sample.accel[0] == (int16_t)(i << 4));
+    CHECK(sample.accel[1] == (int16_t)(-(int32_t)i * 16));
+    CHECK(sample.accel[2] == (1024 << 4));
+    CHECK(sample.status & 0x08);
+    CHECK((i == 0) || (sample.timestamp > prev_timestamp));
+    prev_timestamp = sample.timestamp;
+  }
+  CHECK(i == MMA8452Q_CONFIG_STREAM_BUFFER_SIZE);
+
+  // An edge during an application transfer is serviced after it
+  mma8452q_mock_regs[0x0C] &= (uint8_t)~0x01;
+  CHECK(mma8452q_get_int_source(&sample.int_source) == SL_STATUS_OK);
+  mma8452q_mock_data_ready(accel);
+  CHECK(mma8452q_stream_get_count() == 1);
+  CHECK(mma8452q_stream_read(&sample) == SL_STATUS_OK);
+  CHECK(mma8452q_stream_stop() == SL_STATUS_OK);
+
+  // Event sources are read and released with the sample
+  CHECK(mma8452q_stream_start(true, NULL) == SL_STATUS_OK);
+  mma8452q_mock_regs[0x0C] |= 0x04;
+  mma8452q_mock_regs[0x16] = 0x82;
+  mma8452q_mock_clear_stats();
+  mma8452q_mock_data_ready(accel);
+  CHECK(mma8452q_mock_stats()->transactions == 3);
+  CHECK(mma8452q_stream_read(&sample) == SL_STATUS_OK);
+  // The data ready source was released by reading the data
+  CHECK(sample.int_source == 0x04);
+  CHECK(sample.ff_mt_src == 0x82);
+  CHECK(sample.trans_src == 0);
+  CHECK((mma8452q_mock_regs[0x0C] & 0x04) == 0);
+
+  CHECK(mma8452q_stream_stop() == SL_STATUS_OK);
+  CHECK(mma8452q_stream_stop() == SL_STATUS_INVALID_STATE);
+  CHECK((mma8452q_mock_regs[0x2D] & 0x01) == 0);
+  CHECK(mma8452q_deinit() == SL_STATUS_OK);
+}
+
+// Event sources read with the sample, with and without fast read. The burst
+// read of the data wraps back to STATUS, INT_SOURCE is not part of it.
+static void test_event_read(void)
+{
+  const int16_t accel[3] = { 0x123, -0x45, 0x3FF };
+  mma8452q_sample_t sample;
+  int16_t expected;
+  int fast;
+  int i;
+
+  printf("MMA8452Q event sources\n");
+
+  for (fast = 0; fast < 2; fast++) {
+    mma8452q_mock_reset();
+    CHECK(mma8452q_init(&i2cspm) == SL_STATUS_OK);
+    CHECK(mma8452q_enable_fast_read(fast) == SL_STATUS_OK);
+    CHECK(mma8452q_stream_start(true, NULL) == SL_STATUS_OK);
+
+    mma8452q_mock_regs[0x0C] |= 0x24;
+    mma8452q_mock_regs[0x16] = 0x82;
+    mma8452q_mock_regs[0x1E] = 0x41;
+    mma8452q_mock_data_ready(accel);
+    CHECK(mma8452q_stream_read(&sample) == SL_STATUS_OK);
+
+    CHECK(sample.int_source == 0x24);
+    CHECK(sample.ff_mt_src == 0x82);
+    CHECK(sample.trans_src == 0x41);
+    CHECK(sample.pulse_src == 0);
+    CHECK((mma8452q_mock_regs[0x0C] & 0x24) == 0);
+    for (i = 0; i < 3; i++) {
+      expected = (int16_t)(accel[i] << 4);
+      if (fast) {
+        expected = (int16_t)(expected & 0xFF00);
+      }
+      CHECK(sample.accel[i] == expected);
+    }
+
+    CHECK(mma8452q_stream_stop() == SL_STATUS_OK);
+    CHECK(mma8452q_enable_fast_read(false) == SL_STATUS_OK);
+    CHECK(mma8452q_deinit() == SL_STATUS_OK);
+  }
+}
+
+// Offsets from the average of several samples
+static void test_calibrate(void)
+{
+  const int16_t accel[3] = { 30, -21, 1024 + 50 };
+
+  printf("MMA8452Q calibration\n");
+
+  mma8452q_mock_reset();
+  CHECK(mma8452q_init(&i2cspm) == SL_STATUS_OK);
+  CHECK(mma8452q_calibrate(0) == SL_STATUS_INVALID_PARAMETER);
+
+  // Polled
+  mma8452q_mock_auto_sample(accel);
+  CHECK(mma8452q_calibrate(16) == SL_STATUS_OK);
+  printf("  offsets: %d %d %d\n", (int8_t)mma8452q_mock_regs[0x2F],
+         (int8_t)mma8452q_mock_regs[0x30], (int8_t)mma8452q_mock_regs[0x31]);
+  CHECK((int8_t)mma8452q_mock_regs[0x2F] == -15);
+  CHECK((int8_t)mma8452q_mock_regs[0x30] == 11);
+  CHECK((int8_t)mma8452q_mock_regs[0x31] == -25);
+
+  // Calibrating again keeps the offsets
+  CHECK(mma8452q_auto_calibrate() == SL_STATUS_OK);
+  CHECK((int8_t)mma8452q_mock_regs[0x2F] == -15);
+  CHECK((int8_t)mma8452q_mock_regs[0x31] == -25);
+
+  // No data ready, the rate is restored
+  CHECK(mma8452q_set_odr(MMA8452Q_ODR_100) == SL_STATUS_OK);
+  mma8452q_mock_auto_sample(NULL);
+  CHECK(mma8452q_calibrate(4) == SL_STATUS_TIMEOUT);
+  CHECK((mma8452q_mock_regs[0x2A] & 0x38) == (MMA8452Q_ODR_100 << 3));
+
+  CHECK(mma8452q_deinit() == SL_STATUS_OK);
+}
+
+int main(void)
+{
+  uint8_t per_call_map[256];
+  uint32_t per_call_transactions;
+
+  printf("MMA8452Q configuration transactions\n");
+
+  // Each function runs its own transaction
+  mma8452q_mock_reset();
+  CHECK(mma8452q_init(&i2cspm) == SL_STATUS_OK);
+  mma8452q_mock_clear_stats();
+  CHECK(configure_all() == SL_STATUS_OK);
+  print_stats("one call at a time:");
+  CHECK(mma8452q_mock_stats()->violations == 0);
+  per_call_transactions = mma8452q_mock_stats()->transactions;
+  memcpy(per_call_map, mma8452q_mock_regs, sizeof(per_call_map));
+  CHECK(mma8452q_deinit() == SL_STATUS_OK);
+
+  // Same configuration in a single transaction
+  mma8452q_mock_reset();
+  CHECK(mma8452q_init(&i2cspm) == SL_STATUS_OK);
+  mma8452q_mock_clear_stats();
+  CHECK(mma8452q_config_begin() == SL_STATUS_OK);
+  CHECK(configure_all() == SL_STATUS_OK);
+  CHECK(mma8452q_mock_stats()->writes == 0);
+  CHECK(mma8452q_config_commit() == SL_STATUS_OK);
+  print_stats("begin/commit:");
+  CHECK(mma8452q_mock_stats()->violations == 0);
+  CHECK(mma8452q_mock_stats()->standby_entries <= 1);
+  CHECK(mma8452q_mock_stats()->transactions < per_call_transactions);
+  CHECK(memcmp(per_call_map, mma8452q_mock_regs, sizeof(per_call_map)) == 0);
+
+  // Nothing changed, nothing written
+  mma8452q_mock_clear_stats();
+  CHECK(mma8452q_config_begin() == SL_STATUS_OK);
+  CHECK(configure_all() == SL_STATUS_OK);
+  CHECK(mma8452q_config_commit() == SL_STATUS_OK);
+  print_stats("unchanged configuration:");
+  CHECK(mma8452q_mock_stats()->transactions == 0);
+
+  // Single register change: standby, write, active
+  mma8452q_mock_clear_stats();
+  CHECK(mma8452q_set_scale(MMA8452Q_SCALE_8G) == SL_STATUS_OK);
+  print_stats("single register change:");
+  CHECK(mma8452q_mock_stats()->transactions == 3);
+  CHECK(mma8452q_mock_stats()->standby_entries == 1);
+  CHECK((mma8452q_mock_regs[0x0E] & 0x03) == 0x02);
+  CHECK(mma8452q_mock_regs[0x2A] & 0x01);
+
+  // Aborted transaction leaves the device untouched
+  mma8452q_mock_clear_stats();
+  CHECK(mma8452q_config_begin() == SL_STATUS_OK);
+  CHECK(mma8452q_set_odr(MMA8452Q_ODR_1) == SL_STATUS_OK);
+  CHECK(mma8452q_config_abort() == SL_STATUS_OK);
+  CHECK(mma8452q_mock_stats()->transactions == 0);
+  CHECK(mma8452q_set_scale(MMA8452Q_SCALE_4G) == SL_STATUS_OK);
+  CHECK((mma8452q_mock_regs[0x2A] & 0x38) == (MMA8452Q_ODR_400 << 3));
+  CHECK(mma8452q_config_commit() == SL_STATUS_INVALID_STATE);
+
+  // Dirty PL_COUNT and FF_MT_CFG are not bridged through the read-only
+  // PL_BF_ZCOMP and P_L_THS_REG registers between them
+  orient_cfg.debounce_cnt++;
+  ff_mt_cfg.en_y_trans = true;
+  mma8452q_mock_clear_stats();
+  CHECK(mma8452q_config_begin() == SL_STATUS_OK);
+  CHECK(mma8452q_config_orientation(orient_cfg) == SL_STATUS_OK);
+  CHECK(mma8452q_config_ff_mt(&ff_mt_cfg) == SL_STATUS_OK);
+  CHECK(mma8452q_config_commit() == SL_STATUS_OK);
+  print_stats("read-only gap:");
+  CHECK(mma8452q_mock_stats()->readonly_writes == 0);
+  CHECK(mma8452q_mock_regs[0x12] == orient_cfg.debounce_cnt);
+  CHECK(mma8452q_mock_regs[0x15] & 0x10);
+
+  CHECK(mma8452q_deinit() == SL_STATUS_OK);
+
+  test_stream();
+  test_event_read();
+  test_calibrate();
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
@@ -0,0 +1,318 @@
+/***************************************************************************//**
+ * @file mma8452q_mock.c
+ * @brief Host register map model of the MMA8452Q.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "sl_i2cspm.h"
+#include "sl_udelay.h"
+#include "sl_sleeptimer.h"
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
+#include "mma8452q_mock.h"
+
+#define MOCK_STATUS          0x00
+#define MOCK_OUT_X_MSB       0x01
+#define MOCK_OUT_Z_LSB       0x06
+#define MOCK_INT_SOURCE      0x0C
+#define MOCK_WHO_AM_I        0x0D
+#define MOCK_PL_STATUS       0x10
+#define MOCK_PL_BF_ZCOMP     0x13
+#define MOCK_PL_THS_REG      0x14
+#define MOCK_FF_MT_SRC       0x16
+#define MOCK_TRANSIENT_SRC   0x1E
+#define MOCK_PULSE_SRC       0x22
+#define MOCK_CTRL_REG4       0x2D
+#define MOCK_OFF_X           0x2F
+#define MOCK_ZYXDR           0x08
+#define MOCK_ZYXOW           0x80
+#define MOCK_SRC_DRDY        0x01
+#define MOCK_SRC_FF_MT       0x04
+#define MOCK_SRC_PULSE       0x08
+#define MOCK_SRC_TRANS       0x20
+#define MOCK_CTRL_REG1       0x2A
+#define MOCK_CTRL_REG2       0x2B
+#define MOCK_DEVICE_ID       0x2A
+#define MOCK_ACTIVE          0x01
+#define MOCK_RST             0x40
+#define MOCK_F_READ          0x02
+#define MOCK_OUT_Z_MSB       0x05
+
+uint8_t mma8452q_mock_regs[256];
+static mma8452q_mock_stats_t stats;
+
+static GPIOINT_IrqCallbackPtr_t int_callback;
+static unsigned int int_pin;
+static bool int_armed;       // edge interrupt configured
+static bool int_masked;      // GPIO_IntDisable() in effect
+static bool int_pending;     // edge latched while masked
+static uint32_t ticks;
+static bool auto_sample;
+static int16_t auto_accel[3];
+
+void mma8452q_mock_reset(void)
+{
+  memset(mma8452q_mock_regs, 0, sizeof(mma8452q_mock_regs));
+  mma8452q_mock_regs[MOCK_WHO_AM_I] = MOCK_DEVICE_ID;
+  auto_sample = false;
+  mma8452q_mock_clear_stats();
+}
+
+void mma8452q_mock_clear_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+const mma8452q_mock_stats_t *mma8452q_mock_stats(void)
+{
+  return &stats;
+}
+
+// Status, data, source and identification registers
+static bool mock_is_readonly(uint8_t addr)
+{
+  return (addr <= MOCK_WHO_AM_I) || (addr == MOCK_PL_STATUS)
+         || (addr == MOCK_PL_BF_ZCOMP) || (addr == MOCK_PL_THS_REG)
+         || (addr == MOCK_FF_MT_SRC) || (addr == MOCK_TRANSIENT_SRC)
+         || (addr == MOCK_PULSE_SRC);
+}
+
+static void mock_write(uint8_t addr, uint8_t value)
+{
+  uint8_t ctrl1 = mma8452q_mock_regs[MOCK_CTRL_REG1];
+
+  stats.bytes_written++;
+  if (mock_is_readonly(addr)) {
+    stats.readonly_writes++;
+    return;
+  }
+  if (addr == MOCK_CTRL_REG1) {
+    // Only the active bit may change while active
+    if ((ctrl1 & MOCK_ACTIVE) && ((ctrl1 ^ value) & ~MOCK_ACTIVE)) {
+      stats.violations++;
+    }
+    if ((ctrl1 & MOCK_ACTIVE) && !(value & MOCK_ACTIVE)) {
+      stats.standby_entries++;
+    }
+  } else if ((addr == MOCK_CTRL_REG2) && (value & MOCK_RST)) {
+    uint32_t bytes = stats.bytes_written;
+    mma8452q_mock_reset();
+    stats.bytes_written = bytes;
+    return;
+  } else if (ctrl1 & MOCK_ACTIVE) {
+    stats.violations++;
+  }
+  mma8452q_mock_regs[addr] = value;
+}
+
+static uint8_t mock_read(uint8_t addr)
+{
+  uint8_t value;
+
+  if ((addr == MOCK_STATUS) && auto_sample) {
+    mma8452q_mock_data_ready(auto_accel);
+  }
+  value = mma8452q_mock_regs[addr];
+
+  // Reading the data releases the data ready flag and interrupt
+  if ((addr >= MOCK_OUT_X_MSB) && (addr <= MOCK_OUT_Z_LSB)) {
+    mma8452q_mock_regs[MOCK_STATUS] &= (uint8_t)~(MOCK_ZYXDR | MOCK_ZYXOW);
+    mma8452q_mock_regs[MOCK_INT_SOURCE] &= (uint8_t)~MOCK_SRC_DRDY;
+  }
+  // Reading a source register clears the latched event
+  if (addr == MOCK_FF_MT_SRC) {
+    mma8452q_mock_regs[MOCK_INT_SOURCE] &= (uint8_t)~MOCK_SRC_FF_MT;
+  } else if (addr == MOCK_TRANSIENT_SRC) {
+    mma8452q_mock_regs[MOCK_INT_SOURCE] &= (uint8_t)~MOCK_SRC_TRANS;
+  } else if (addr == MOCK_PULSE_SRC) {
+    mma8452q_mock_regs[MOCK_INT_SOURCE] &= (uint8_t)~MOCK_SRC_PULSE;
+  }
+  return value;
+}
+
+// Burst reads wrap back to STATUS after the last data register, which is
+// OUT_X_MSB..OUT_Z_MSB only in fast read mode
+static uint8_t mock_next_read_addr(uint8_t addr)
+{
+  uint8_t last = (mma8452q_mock_regs[MOCK_CTRL_REG1] & MOCK_F_READ)
+                 ? MOCK_OUT_Z_MSB : MOCK_OUT_Z_LSB;
+
+  if (addr == last) {
+    return MOCK_STATUS;
+  }
+  // Fast read skips the LSB registers
+  if ((addr < last) && (mma8452q_mock_regs[MOCK_CTRL_REG1] & MOCK_F_READ)
+      && (addr != MOCK_STATUS)) {
+    return addr + 2;
+  }
+  return addr + 1;
+}
+
+I2C_TransferReturn_TypeDef I2CSPM_Transfer(sl_i2cspm_t *i2cspm,
+                                           I2C_TransferSeq_TypeDef *seq)
+{
+  uint8_t addr;
+  (void)i2cspm;
+
+  stats.transactions++;
+  if (seq->buf[0].len == 0) {
+    return i2cTransferNack;
+  }
+  addr = seq->buf[0].data[0];
+
+  if (seq->flags == I2C_FLAG_WRITE) {
+    stats.writes++;
+    // Register address auto-increments on burst writes
+    for (uint16_t i = 1; i < seq->buf[0].len; i++) {
+      mock_write(addr++, seq->buf[0].data[i]);
+    }
+  } else if (seq->flags == I2C_FLAG_WRITE_READ) {
+    stats.reads++;
+    for (uint16_t i = 0; i < seq->buf[1].len; i++) {
+      seq->buf[1].data[i] = mock_read(addr);
+      stats.bytes_read++;
+      addr = mock_next_read_addr(addr);
+    }
+  } else {
+    return i2cTransferNack;
+  }
+  return i2cTransferDone;
+}
+
+void sl_udelay_wait(unsigned us)
+{
+  (void)us;
+}
+
+void mma8452q_mock_data_ready(const int16_t accel[3])
+{
+  uint8_t *regs = mma8452q_mock_regs;
+  int32_t value;
+
+  for (int i = 0; i < 3; i++) {
+    // 12-bit left aligned data, the offset registers are 2 LSB per step
+    value = accel[i] + 2 * (int8_t)regs[MOCK_OFF_X + i];
+    regs[MOCK_OUT_X_MSB + 2 * i] = (uint8_t)((uint16_t)(value << 4) >> 8);
+    regs[MOCK_OUT_X_MSB + 2 * i + 1] = (uint8_t)(value << 4);
+  }
+  if (regs[MOCK_STATUS] & MOCK_ZYXDR) {
+    regs[MOCK_STATUS] |= MOCK_ZYXOW;
+  }
+  regs[MOCK_STATUS] |= MOCK_ZYXDR;
+
+  // The interrupt output is asserted until the data is read, an edge only
+  // happens when it was released
+  if ((regs[MOCK_CTRL_REG4] & MOCK_SRC_DRDY)
+      && !(regs[MOCK_INT_SOURCE] & MOCK_SRC_DRDY)) {
+    regs[MOCK_INT_SOURCE] |= MOCK_SRC_DRDY;
+    if (int_armed && (int_callback != NULL)) {
+      if (int_masked) {
+        int_pending = true;
+      } else {
+        int_callback((uint8_t)int_pin);
+      }
+    }
+  }
+}
+
+void mma8452q_mock_auto_sample(const int16_t *accel)
+{
+  auto_sample = (accel != NULL);
+  if (auto_sample) {
+    memcpy(auto_accel, accel, sizeof(auto_accel));
+  }
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin,
+                     GPIO_Mode_TypeDef mode, unsigned int out)
+{
+  (void)port;
+  (void)pin;
+  (void)mode;
+  (void)out;
+}
+
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin,
+                       unsigned int intNo, bool risingEdge,
+                       bool fallingEdge, bool enable)
+{
+  (void)port;
+  (void)intNo;
+  (void)risingEdge;
+  (void)fallingEdge;
+  int_pin = pin;
+  int_armed = enable;
+  int_pending = false;
+}
+
+void GPIO_IntDisable(uint32_t flags)
+{
+  if (flags & (1u << int_pin)) {
+    int_masked = true;
+  }
+}
+
+void GPIO_IntEnable(uint32_t flags)
+{
+  if (flags & (1u << int_pin)) {
+    int_masked = false;
+    if (int_pending && int_armed && (int_callback != NULL)) {
+      int_pending = false;
+      int_callback((uint8_t)int_pin);
+    }
+  }
+}
+
+void GPIOINT_Init(void)
+{
+}
+
+void GPIOINT_CallbackRegister(uint8_t intNo,
+                              GPIOINT_IrqCallbackPtr_t callbackPtr)
+{
+  (void)intNo;
+  int_callback = callbackPtr;
+}
+
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  return ticks++;
+}
+
+uint32_t sl_sleeptimer_ms_to_tick(uint16_t time_ms)
+{
+  return (uint32_t)time_ms * 32768u / 1000u;
+}
@@ -0,0 +1,76 @@
+/***************************************************************************//**
+ * @file mma8452q_mock.h
+ * @brief Host register map model of the MMA8452Q.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef MMA8452Q_MOCK_H_
+#define MMA8452Q_MOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Transaction counters of the register map model
+typedef struct {
+  uint32_t transactions;    // I2C transfers of any kind
+  uint32_t writes;          // write transfers
+  uint32_t reads;           // write-read transfers
+  uint32_t bytes_written;   // register bytes written
+  uint32_t bytes_read;      // register bytes read
+  uint32_t standby_entries; // active -> standby transitions
+  uint32_t violations;      // registers written while active
+  uint32_t readonly_writes; // writes to read-only registers
+} mma8452q_mock_stats_t;
+
+// Register map of the device, writable by the test
+extern uint8_t mma8452q_mock_regs[256];
+
+// Power-on reset of the register map and of the counters
+void mma8452q_mock_reset(void);
+
+// Clear the counters only
+void mma8452q_mock_clear_stats(void);
+
+// Current counters
+const mma8452q_mock_stats_t *mma8452q_mock_stats(void);
+
+// New sample from the sensor: the user offsets are added, the data ready
+// flag is set and the data ready interrupt raised if it is armed
+void mma8452q_mock_data_ready(const int16_t accel[3]);
+
+// When set, every read of the STATUS register finds a new sample
+void mma8452q_mock_auto_sample(const int16_t *accel);
+
+#endif /* MMA8452Q_MOCK_H_ */
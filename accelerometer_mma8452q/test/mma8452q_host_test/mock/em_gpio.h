@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @file em_gpio.h
+ * @brief Host build replacement of the GPIO interface.
+ ******************************************************************************/
+#ifndef EM_GPIO_H
+#define EM_GPIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  gpioPortA,
+  gpioPortB,
+  gpioPortC,
+  gpioPortD
+} GPIO_Port_TypeDef;
+
+typedef enum {
+  gpioModeDisabled,
+  gpioModeInput,
+  gpioModeInputPull,
+  gpioModeInputPullFilter
+} GPIO_Mode_TypeDef;
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin,
+                     GPIO_Mode_TypeDef mode, unsigned int out);
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin,
+                       unsigned int intNo, bool risingEdge,
+                       bool fallingEdge, bool enable);
+void GPIO_IntDisable(uint32_t flags);
+void GPIO_IntEnable(uint32_t flags);
+
+#endif // EM_GPIO_H
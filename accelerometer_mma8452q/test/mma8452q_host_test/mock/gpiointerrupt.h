@@ -0,0 +1,16 @@
+/***************************************************************************//**
+ * @file gpiointerrupt.h
+ * @brief Host build replacement of the GPIO interrupt dispatcher.
+ ******************************************************************************/
+#ifndef GPIOINTERRUPT_H
+#define GPIOINTERRUPT_H
+
+#include <stdint.h>
+
+typedef void (*GPIOINT_IrqCallbackPtr_t)(uint8_t intNo);
+
+void GPIOINT_Init(void);
+void GPIOINT_CallbackRegister(uint8_t intNo,
+                              GPIOINT_IrqCallbackPtr_t callbackPtr);
+
+#endif // GPIOINTERRUPT_H
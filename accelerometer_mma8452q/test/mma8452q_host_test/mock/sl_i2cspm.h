@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * @file sl_i2cspm.h
+ * @brief Host build replacement of the I2CSPM driver interface.
+ ******************************************************************************/
+#ifndef SL_I2CSPM_H
+#define SL_I2CSPM_H
+
+#include <stdint.h>
+
+#define I2C_FLAG_WRITE        0x0001
+#define I2C_FLAG_READ         0x0002
+#define I2C_FLAG_WRITE_READ   0x0004
+#define I2C_FLAG_WRITE_WRITE  0x0008
+
+typedef enum {
+  i2cTransferInProgress = 1,
+  i2cTransferDone = 0,
+  i2cTransferNack = -1,
+} I2C_TransferReturn_TypeDef;
+
+typedef struct {
+  uint16_t addr;
+  uint16_t flags;
+  struct {
+    uint8_t *data;
+    uint16_t len;
+  } buf[2];
+} I2C_TransferSeq_TypeDef;
+
+typedef struct {
+  int instance;
+} sl_i2cspm_t;
+
+I2C_TransferReturn_TypeDef I2CSPM_Transfer(sl_i2cspm_t *i2cspm,
+                                           I2C_TransferSeq_TypeDef *seq);
+
+#endif // SL_I2CSPM_H
@@ -0,0 +1,10 @@
+/***************************************************************************//**
+ * @file sl_i2cspm_qwiic_config.h
+ * @brief Host build replacement of the I2CSPM instance configuration.
+ ******************************************************************************/
+#ifndef SL_I2CSPM_QWIIC_CONFIG_H
+#define SL_I2CSPM_QWIIC_CONFIG_H
+
+#define SL_I2CSPM_QWIIC_PERIPHERAL  NULL
+
+#endif // SL_I2CSPM_QWIIC_CONFIG_H
@@ -0,0 +1,14 @@
+/***************************************************************************//**
+ * @file sl_sleeptimer.h
+ * @brief Host build replacement of the sleeptimer tick counter.
+ ******************************************************************************/
+#ifndef SL_SLEEPTIMER_H
+#define SL_SLEEPTIMER_H
+
+#include <stdint.h>
+
+// Advances by one tick on every call
+uint32_t sl_sleeptimer_get_tick_count(void);
+uint32_t sl_sleeptimer_ms_to_tick(uint16_t time_ms);
+
+#endif // SL_SLEEPTIMER_H
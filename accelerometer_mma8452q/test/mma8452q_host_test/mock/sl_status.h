@@ -0,0 +1,29 @@
+/***************************************************************************//**
+ * @file sl_status.h
+ * @brief Host build replacement of the GSDK status codes.
+ ******************************************************************************/
+#ifndef SL_STATUS_H
+#define SL_STATUS_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK                      ((sl_status_t)0x0000)
+#define SL_STATUS_FAIL                    ((sl_status_t)0x0001)
+#define SL_STATUS_INVALID_STATE           ((sl_status_t)0x0002)
+#define SL_STATUS_NOT_READY               ((sl_status_t)0x0003)
+#define SL_STATUS_BUSY                    ((sl_status_t)0x0004)
+#define SL_STATUS_IN_PROGRESS             ((sl_status_t)0x0005)
+#define SL_STATUS_FULL                    ((sl_status_t)0x0007)
+#define SL_STATUS_EMPTY                   ((sl_status_t)0x0008)
+#define SL_STATUS_WOULD_OVERFLOW          ((sl_status_t)0x000A)
+#define SL_STATUS_TIMEOUT                 ((sl_status_t)0x000D)
+#define SL_STATUS_NOT_INITIALIZED         ((sl_status_t)0x0011)
+#define SL_STATUS_ALREADY_INITIALIZED     ((sl_status_t)0x0012)
+#define SL_STATUS_NULL_POINTER            ((sl_status_t)0x0022)
+#define SL_STATUS_INVALID_PARAMETER       ((sl_status_t)0x0021)
+#define SL_STATUS_NOT_FOUND               ((sl_status_t)0x0028)
+#define SL_STATUS_TRANSMIT                ((sl_status_t)0x0045)
+
+#endif // SL_STATUS_H
@@ -0,0 +1,12 @@
+/***************************************************************************//**
+ * @file sl_udelay.h
+ * @brief Host build replacement of the microsecond delay.
+ ******************************************************************************/
+#ifndef SL_UDELAY_H
+#define SL_UDELAY_H
+
+#include <stdint.h>
+
+void sl_udelay_wait(unsigned us);
+
+#endif // SL_UDELAY_H
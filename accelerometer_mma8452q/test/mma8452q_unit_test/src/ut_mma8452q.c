@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
 #include "mma8452q_config.h"
 #include "ut_mma8452q.h"
 #include "sl_i2cspm_instances.h"
@@ -63,6 +64,8 @@ static void test_mma8452q_enable_low_noise(void);
 static void test_mma8452q_enable_fast_read(void);
 static void test_mma8452q_active(void);
 static void test_mma8452q_auto_calibrate(void);
+static void test_mma8452q_calibrate(void);
+static void test_mma8452q_stream(void);
 static void test_sl_mma8452q_getAcceleration(void);
 static void test_sl_mma8452q_getCalculatedAcceleration(void);
 static void test_mma8452q_getDataStatus(void);
@@ -91,6 +94,8 @@ static CU_TestInfo mma8452q_unit_test[] = {
     {"test_mma8452q_enable_fast_read",test_mma8452q_enable_fast_read},
     {"test_mma8452q_active",test_mma8452q_active},
     {"test_mma8452q_auto_calibrate",test_mma8452q_auto_calibrate},
+    {"test_mma8452q_calibrate",test_mma8452q_calibrate},
+    {"test_mma8452q_stream",test_mma8452q_stream},
     {"test_sl_mma8452q_get_acceleration",test_sl_mma8452q_getAcceleration},
     {"test_sl_mma8452q_get_calculated_acceleration",test_sl_mma8452q_getCalculatedAcceleration},
     {"test_mma8452q_get_data_status",test_mma8452q_getDataStatus},
@@ -597,6 +602,72 @@ static void test_mma8452q_auto_calibrate(void)
   CU_ASSERT(status == SL_STATUS_OK);
 }
 
+/**
+ * @brief test_mma8452q_calibrate: Test function for mma8452q_calibrate
+ *
+ */
+static void test_mma8452q_calibrate(void)
+{
+  // arrange
+  sl_status_t status = SL_STATUS_OK;
+
+  // normal case.
+  status = mma8452q_calibrate(8);
+  CU_ASSERT(status == SL_STATUS_OK);
+
+  // invalid number of samples
+  status = mma8452q_calibrate(0);
+  CU_ASSERT(status == SL_STATUS_INVALID_PARAMETER);
+}
+
+/**
+ * @brief test_mma8452q_stream: Test function for the data ready streaming
+ *
+ */
+static void test_mma8452q_stream(void)
+{
+  // arrange
+  sl_status_t status = SL_STATUS_OK;
+  mma8452q_sample_t sample;
+  clock_t start;
+
+  // normal case.
+  status = mma8452q_set_odr(MMA8452Q_ODR_800);
+  CU_ASSERT(status == SL_STATUS_OK);
+  status = mma8452q_stream_start(true, NULL);
+  CU_ASSERT(status == SL_STATUS_OK);
+
+  // already running
+  status = mma8452q_stream_start(true, NULL);
+  CU_ASSERT(status == SL_STATUS_INVALID_STATE);
+
+  // 100 ms fills the buffer at 800 Hz
+  start = clock();
+  while ((clock() - start) < (CLOCKS_PER_SEC / 10)) {
+  }
+  CU_ASSERT(mma8452q_stream_get_count() > 0);
+
+  status = mma8452q_stream_read(&sample);
+  CU_ASSERT(status == SL_STATUS_OK);
+  CU_ASSERT(sample.status & 0x08);
+
+  status = mma8452q_stream_stop();
+  CU_ASSERT(status == SL_STATUS_OK);
+
+  while (mma8452q_stream_read(&sample) == SL_STATUS_OK) {
+  }
+  status = mma8452q_stream_read(&sample);
+  CU_ASSERT(status == SL_STATUS_EMPTY);
+
+  // invalid parameter
+  status = mma8452q_stream_read(NULL);
+  CU_ASSERT(status == SL_STATUS_INVALID_PARAMETER);
+
+  // not running
+  status = mma8452q_stream_stop();
+  CU_ASSERT(status == SL_STATUS_INVALID_STATE);
+}
+
 /**
  * @brief test_sl_mma8452q_getAcceleration: Test function for
  * sl_mma8452q_getAcceleration
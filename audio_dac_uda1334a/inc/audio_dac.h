@@ -41,6 +41,7 @@
 #include "em_ldma.h"
 #include "em_usart.h"
 #include "sl_status.h"
+#include "audio_dac_mixer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -83,6 +84,25 @@ extern "C" {
  *  
  *  audio_dac_status() will return whether audio playback is in progress.
  *  
+ * ## Streaming
+ *  Audio that does not fit in RAM, or that is produced while playing, is
+ *  streamed with audio_dac_stream_start(). The LDMA plays a ring of
+ *  2 (ping-pong) to AUDIO_DAC_CONFIG_STREAM_MAX_SLOTS slots of 16 bit
+ *  samples. Each time a slot has been played, the LDMA interrupt renders
+ *  the next block into it from up to two sources attached with
+ *  audio_dac_stream_attach().
+ *
+ *  A source pulls its samples from a producer callback at its own sample
+ *  rate, e.g. 8 or 16 kHz voice prompts, and is converted to the DAC sample
+ *  rate by linear interpolation. Each source has a Q12 gain, and a master
+ *  gain is set with audio_dac_stream_set_gain(). The samples of the two
+ *  sources are added with saturation.
+ *
+ *  Blocks a producer could not fill in time are played with silence where
+ *  samples are missing and are counted, see audio_dac_stream_get_stats().
+ *  Once every attached source returned its last samples, playback stops
+ *  after the ring has played out.
+ *
  * ## Hardware Configuration
  *  The hardware specific configuration, including GPIO pins and peripheral
  *  usage are defined in the audio_dac_config.h file. This file is intended to
@@ -141,6 +161,16 @@ typedef struct {
   sl_status_t (*mute_cb)(void);       ///< User callback for mute control
 } audio_dac_init_t;
 
+// Number of sources mixed by the streaming playback
+#define AUDIO_DAC_STREAM_SOURCES  2
+
+// Streaming playback counters
+typedef struct {
+  uint32_t blocks;      ///< Slots refilled
+  uint32_t underruns;   ///< Slots with samples missing from the sources
+  uint32_t late;        ///< Slots refilled more than one slot late
+} audio_dac_stream_stats_t;
+
 // Default initialization parameters for audio DAC
 // Uses callback function pointers defined in audio_dac_config.h
 #define AUDIO_DAC_INIT_DEFAULT                        \
@@ -236,6 +266,50 @@ sl_status_t audio_dac_volume(int vol);
  ******************************************************************************/
 sl_status_t audio_dac_stop(void);
 
+/***************************************************************************//**
+ * Start streaming playback
+ *
+ * The slots are filled from the attached sources before the LDMA starts.
+ *
+ * @param buffer        Ring of slot_count * slot_samples samples
+ * @param slot_count    Number of slots, 2 to AUDIO_DAC_CONFIG_STREAM_MAX_SLOTS
+ * @param slot_samples  Samples per slot, a multiple of the channels and up to
+ *                      2000. The refill interrupt runs once per slot.
+ *
+ * @note  Streaming needs the resolution16 format. The buffer must not go out
+ *        of scope while playback is active.
+ ******************************************************************************/
+sl_status_t audio_dac_stream_start(int16_t *buffer,
+                                   uint8_t slot_count,
+                                   uint16_t slot_samples);
+
+/***************************************************************************//**
+ * Attach a source to the streaming playback, or detach it with NULL
+ *
+ * The rate converter of the source is set up for the DAC sample rate and
+ * channels. Sources can be attached before and during playback.
+ *
+ * @param index   Source index, below AUDIO_DAC_STREAM_SOURCES
+ * @param source  Pointer to an initialized source or NULL
+ *
+ * @note  The source must not go out of scope while it is attached.
+ ******************************************************************************/
+sl_status_t audio_dac_stream_attach(uint8_t index, audio_dac_source_t *source);
+
+/***************************************************************************//**
+ * Set the master gain of the streaming playback
+ *
+ * @param gain  Gain, Q12 (AUDIO_DAC_GAIN_UNITY for 1)
+ ******************************************************************************/
+void audio_dac_stream_set_gain(uint16_t gain);
+
+/***************************************************************************//**
+ * Get the streaming playback counters
+ *
+ * @param stats  Pointer to the counters to fill
+ ******************************************************************************/
+sl_status_t audio_dac_stream_get_stats(audio_dac_stream_stats_t *stats);
+
 /***************************************************************************//**
  * Get the status of the audio dac driver. Returns true if playback is in
  * progress.
@@ -44,6 +44,14 @@
 // LDMA Channel used for audio output
 #define AUDIO_DAC_CONFIG_LDMA_CHANNEL 0
 
+// Set to 1 when DMADRV is in the project, e.g. for SPIDRV. The LDMA channel
+// is then allocated from DMADRV instead of AUDIO_DAC_CONFIG_LDMA_CHANNEL,
+// and DMADRV owns the LDMA interrupt handler.
+#define AUDIO_DAC_CONFIG_USE_DMADRV 0
+
+// Maximum number of slots of the streaming playback ring
+#define AUDIO_DAC_CONFIG_STREAM_MAX_SLOTS 4
+
 // USART used for audio output, must support I2S
 #define AUDIO_DAC_CONFIG_USART      USART1
 
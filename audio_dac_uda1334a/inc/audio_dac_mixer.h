@@ -0,0 +1,184 @@
+/***************************************************************************//**
+ * @file audio_dac_mixer.h
+ * @brief fixed-point gain, mixer and rate converter for audio dac streaming
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AUDIO_DAC_MIXER_H
+#define AUDIO_DAC_MIXER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup audio_dac
+ * @{
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+// Defines
+
+// Gains are unsigned Q12 fixed point, up to almost 16x
+#define AUDIO_DAC_GAIN_SHIFT          12
+#define AUDIO_DAC_GAIN_UNITY          (1U << AUDIO_DAC_GAIN_SHIFT)
+
+// Source frames fetched from the producer callback at a time
+#define AUDIO_DAC_SOURCE_CHUNK_FRAMES 32
+
+// Maximum number of interleaved channels
+#define AUDIO_DAC_MAX_CHANNELS        2
+
+// -----------------------------------------------------------------------------
+// Data types
+
+/***************************************************************************//**
+ * Producer callback of a streamed source
+ *
+ * @param context  User context of the source
+ * @param samples  Buffer to write interleaved 16 bit samples to
+ * @param count    Number of samples requested, a multiple of the channels
+ * @param end      Set to true if the samples returned are the last ones
+ *
+ * @return  Number of samples written. Fewer than requested without end set
+ *          is an underrun, the missing samples are played as silence and the
+ *          source is called again for the next block.
+ *
+ * @note  When streaming, this is called from the LDMA interrupt.
+ ******************************************************************************/
+typedef uint32_t (*audio_dac_source_cb_t)(void *context,
+                                          int16_t *samples,
+                                          uint32_t count,
+                                          bool *end);
+
+// A streamed source with its own sample rate and gain
+typedef struct {
+  audio_dac_source_cb_t callback;   ///< Producer callback
+  void *context;                    ///< User context passed to the callback
+  uint32_t rate;                    ///< Sample rate of the source
+  volatile uint16_t gain;           ///< Gain, Q12
+  volatile bool ended;              ///< The source returned its last samples
+  volatile uint32_t underruns;      ///< Blocks the source could not fill
+
+  // Rate converter state, set by audio_dac_source_prepare()
+  uint8_t channels;                 ///< Interleaved channels
+  uint32_t step;                    ///< Source frames per output frame, Q16
+  uint32_t step_rem;                ///< Remainder of step, in 1/out_rate
+  uint32_t step_err;                ///< Accumulated remainder
+  uint32_t out_rate;                ///< Sample rate of the output
+  uint32_t phase;                   ///< Position between prev and next, Q16
+  int16_t prev[AUDIO_DAC_MAX_CHANNELS];   ///< Source frame before phase
+  int16_t next[AUDIO_DAC_MAX_CHANNELS];   ///< Source frame after phase
+  int16_t chunk[AUDIO_DAC_SOURCE_CHUNK_FRAMES * AUDIO_DAC_MAX_CHANNELS];
+  uint16_t chunk_frames;            ///< Frames in chunk
+  uint16_t chunk_index;             ///< Next frame to take from chunk
+  bool last_chunk;                  ///< chunk holds the last samples
+} audio_dac_source_t;
+
+// -----------------------------------------------------------------------------
+// Prototypes
+
+/***************************************************************************//**
+ * Initialize a streamed source
+ *
+ * @param source    Pointer to the source
+ * @param callback  Producer callback
+ * @param context   User context passed to the callback
+ * @param rate      Sample rate of the source, e.g. 8000 or 16000
+ ******************************************************************************/
+void audio_dac_source_init(audio_dac_source_t *source,
+                           audio_dac_source_cb_t callback,
+                           void *context,
+                           uint32_t rate);
+
+/***************************************************************************//**
+ * Set up the rate converter of a source for the output format, and restart
+ * it from the current position of the producer
+ *
+ * @param source    Pointer to the source
+ * @param out_rate  Sample rate of the output
+ * @param channels  Interleaved channels of the source and the output
+ ******************************************************************************/
+void audio_dac_source_prepare(audio_dac_source_t *source,
+                              uint32_t out_rate,
+                              uint8_t channels);
+
+/***************************************************************************//**
+ * Set the gain of a source
+ *
+ * @param source  Pointer to the source
+ * @param gain    Gain, Q12 (AUDIO_DAC_GAIN_UNITY for 1)
+ ******************************************************************************/
+void audio_dac_source_set_gain(audio_dac_source_t *source, uint16_t gain);
+
+/***************************************************************************//**
+ * Apply a gain to samples in place, saturating to 16 bits
+ *
+ * @param samples  Samples
+ * @param count    Number of samples
+ * @param gain     Gain, Q12
+ ******************************************************************************/
+void audio_dac_gain_apply(int16_t *samples, uint32_t count, uint16_t gain);
+
+/***************************************************************************//**
+ * Render a block of output from up to two sources
+ *
+ * Each source is rate converted by linear interpolation, scaled by its gain
+ * and the master gain, and the sources are added with saturation. Frames a
+ * source could not provide are silent.
+ *
+ * @param out      Output buffer of frames * channels interleaved samples
+ * @param frames   Number of output frames
+ * @param channels Interleaved channels of the output
+ * @param sources  Sources, NULL entries are skipped
+ * @param count    Number of entries in sources
+ * @param master   Master gain, Q12
+ *
+ * @return  Number of frames to which at least one source contributed
+ ******************************************************************************/
+uint32_t audio_dac_render(int16_t *out,
+                          uint32_t frames,
+                          uint8_t channels,
+                          audio_dac_source_t *const *sources,
+                          uint8_t count,
+                          uint16_t master);
+
+/** @} (end addtogroup audio_dac) */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // AUDIO_DAC_MIXER_H
@@ -39,9 +39,13 @@
 #include "em_emu.h"
 #include "em_usart.h"
 #include "em_ldma.h"
+#include "em_core.h"
 #include "audio_dac.h"
 #include "audio_dac_config.h"
 #include "sl_status.h"
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+#include "dmadrv.h"
+#endif
 
 #define LDMA_MAX_TRANSFER_SIZE 2000
 
@@ -49,6 +53,37 @@
 // Stores whether play back is in progress or stopped
 static bool playback_in_progress = false;
 
+// Output format stored by audio_dac_init() for the streaming playback
+static uint32_t dac_frequency;
+static uint8_t dac_channels;
+static resolution_t dac_res;
+
+// Streaming playback state
+static struct {
+  int16_t *buffer;                  // Ring of slots
+  uint8_t slot_count;               // Number of slots
+  uint16_t slot_samples;            // Samples per slot
+  uint8_t refill_slot;              // Next slot to refill
+  uint8_t drain;                    // Slots left to play once the sources
+                                    //  ended, 0 while they have not
+  bool active;                      // Streaming playback in progress
+  uint16_t master;                  // Master gain, Q12
+  audio_dac_source_t *sources[AUDIO_DAC_STREAM_SOURCES];
+  audio_dac_stream_stats_t stats;
+} stream = { .master = AUDIO_DAC_GAIN_UNITY };
+
+static LDMA_Descriptor_t stream_desc[AUDIO_DAC_CONFIG_STREAM_MAX_SLOTS];
+
+// LDMA channel for audio output, allocated from DMADRV when it is used
+static unsigned int ldma_channel = AUDIO_DAC_CONFIG_LDMA_CHANNEL;
+
+static void stream_refill(void);
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+static bool stream_done(unsigned int channel,
+                        unsigned int sequence_no,
+                        void *user_param);
+#endif
+
 // Required LDMA transfer configuration
 // This configuration is defined by the user customizable 
 // audio_dac_config.h file.
@@ -135,14 +170,57 @@ sl_status_t (*mute_callback)(void) = NULL;
  *****************************************************************************/
 static sl_status_t init_ldma(void)
 {
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+  static bool channel_allocated = false;
+
+  // DMADRV may already be initialized by another driver such as SPIDRV
+  (void)DMADRV_Init();
+  if (!channel_allocated) {
+    if (DMADRV_AllocateChannel(&ldma_channel, NULL) != ECODE_EMDRV_DMADRV_OK) {
+      return SL_STATUS_FAIL;
+    }
+    channel_allocated = true;
+  }
+#else
   CMU_ClockEnable(cmuClock_LDMA, true);
   // Default LDMA init
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
   LDMA_Init(&init);
+#endif
 
   return SL_STATUS_OK;
 }
 
+/**************************************************************************//**
+ * Start the audio output LDMA channel, refill refills the streaming ring
+ * on its done interrupts
+ *****************************************************************************/
+static void start_ldma(const LDMA_Descriptor_t *desc, bool refill)
+{
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+  DMADRV_LdmaStartTransfer((int)ldma_channel,
+                           &txCfg,
+                           (LDMA_Descriptor_t *)desc,
+                           refill ? stream_done : NULL,
+                           NULL);
+#else
+  (void)refill;
+  LDMA_StartTransfer(ldma_channel, &txCfg, desc);
+#endif
+}
+
+/**************************************************************************//**
+ * Stop the audio output LDMA channel
+ *****************************************************************************/
+static void stop_ldma(void)
+{
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+  DMADRV_StopTransfer(ldma_channel);
+#else
+  LDMA_StopTransfer(ldma_channel);
+#endif
+}
+
 /**************************************************************************//**
  * I2S initialization function
  *****************************************************************************/
@@ -214,6 +292,10 @@ sl_status_t audio_dac_init(audio_dac_init_t *init, bool callbacks)
   status |= init_ldma();
   status |= init_i2s(init);
 
+  dac_frequency = init->frequency;
+  dac_channels = init->stereo ? 2 : 1;
+  dac_res = init->res;
+
   // Initialize state and callbacks
   playback_in_progress = false;
   callbacks_valid = false;
@@ -306,14 +388,11 @@ sl_status_t audio_dac_start(audio_dac_data_t *data, bool repeat)
             transferWidth);
   }
 
-  LDMA_StartTransfer(
-      AUDIO_DAC_CONFIG_LDMA_CHANNEL,
-      &txCfg,
-      (const LDMA_Descriptor_t *) data->descriptors);
+  start_ldma((const LDMA_Descriptor_t *) data->descriptors, false);
 
   // Mask LDMA chdone interrupt as this has no handler
-  LDMA->IFC = 1UL << (uint8_t)AUDIO_DAC_CONFIG_LDMA_CHANNEL;
-  LDMA->IEN &= ~(1UL << (uint8_t)AUDIO_DAC_CONFIG_LDMA_CHANNEL);
+  LDMA->IFC = 1UL << (uint8_t)ldma_channel;
+  LDMA->IEN &= ~(1UL << (uint8_t)ldma_channel);
 
   playback_in_progress = true;
   return SL_STATUS_OK;
@@ -368,7 +447,8 @@ sl_status_t audio_dac_volume(int vol)
 sl_status_t audio_dac_stop(void)
 {
   if(audio_dac_status()) {
-    LDMA_StopTransfer(AUDIO_DAC_CONFIG_LDMA_CHANNEL);
+    stop_ldma();
+    stream.active = false;
     playback_in_progress = false;
     return SL_STATUS_OK;
   } else {
@@ -384,3 +464,229 @@ bool audio_dac_status(void)
 {
   return playback_in_progress;
 }
+
+/***************************************************************************//**
+ * Render the next block into a slot of the streaming ring
+ *
+ * @param slot     Slot to fill
+ * @param prefill  The LDMA has not started, the slot is played after the
+ *                 slots before it. Otherwise it is played after all others.
+ ******************************************************************************/
+static void stream_fill(uint8_t slot, bool prefill)
+{
+  uint32_t frames = stream.slot_samples / dac_channels;
+  uint32_t rendered;
+  bool attached = false;
+  bool ended = true;
+
+  rendered = audio_dac_render(&stream.buffer[slot * stream.slot_samples],
+                              frames,
+                              dac_channels,
+                              stream.sources,
+                              AUDIO_DAC_STREAM_SOURCES,
+                              stream.master);
+  stream.stats.blocks++;
+
+  for (uint8_t i = 0; i < AUDIO_DAC_STREAM_SOURCES; i++) {
+    if (stream.sources[i] != NULL) {
+      attached = true;
+      ended = ended && stream.sources[i]->ended;
+    }
+  }
+
+  if (attached && ended) {
+    // Count the slots to play up to and including this one
+    if (stream.drain == 0) {
+      stream.drain = prefill ? (uint8_t)(slot + 1) : stream.slot_count;
+    }
+  } else if (attached && (rendered < frames)) {
+    stream.stats.underruns++;
+  }
+}
+
+/***************************************************************************//**
+ * Start streaming playback
+ ******************************************************************************/
+sl_status_t audio_dac_stream_start(int16_t *buffer,
+                                   uint8_t slot_count,
+                                   uint16_t slot_samples)
+{
+  uint8_t i;
+
+  if (audio_dac_status()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (buffer == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if (dac_res != resolution16) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  if ((slot_count < 2) || (slot_count > AUDIO_DAC_CONFIG_STREAM_MAX_SLOTS)
+      || (slot_samples == 0) || (slot_samples > LDMA_MAX_TRANSFER_SIZE)
+      || ((slot_samples % dac_channels) != 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  stream.buffer = buffer;
+  stream.slot_count = slot_count;
+  stream.slot_samples = slot_samples;
+  stream.refill_slot = 0;
+  stream.drain = 0;
+
+  for (i = 0; i < slot_count; i++) {
+    stream_fill(i, true);
+  }
+
+  // A ring of slots, each interrupting when it has been played
+  for (i = 0; i < slot_count; i++) {
+    stream_desc[i] = (LDMA_Descriptor_t) AUDIO_DAC_DESCRIPTOR_LINK(
+        &buffer[i * slot_samples],
+        &(AUDIO_DAC_CONFIG_USART->TXDOUBLE),
+        slot_samples,
+        ldmaCtrlSizeHalf,
+        (i == slot_count - 1) ? -(slot_count - 1) : 1);
+    stream_desc[i].xfer.doneIfs = 1;
+  }
+
+  stream.active = true;
+  playback_in_progress = true;
+
+  LDMA_IntClear(1UL << ldma_channel);
+  start_ldma(stream_desc, true);
+
+  // Unlike audio_dac_start(), the chdone interrupt drives the refills
+  LDMA->IEN |= 1UL << (uint8_t)ldma_channel;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Attach a source to the streaming playback, or detach it with NULL
+ ******************************************************************************/
+sl_status_t audio_dac_stream_attach(uint8_t index, audio_dac_source_t *source)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (index >= AUDIO_DAC_STREAM_SOURCES) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if ((source != NULL) && (dac_channels == 0)) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+
+  if (source != NULL) {
+    audio_dac_source_prepare(source, dac_frequency, dac_channels);
+  }
+
+  CORE_ENTER_ATOMIC();
+  stream.sources[index] = source;
+  if (source != NULL) {
+    // A new source cancels the end of the stream
+    stream.drain = 0;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Set the master gain of the streaming playback
+ ******************************************************************************/
+void audio_dac_stream_set_gain(uint16_t gain)
+{
+  stream.master = gain;
+}
+
+/***************************************************************************//**
+ * Get the streaming playback counters
+ ******************************************************************************/
+sl_status_t audio_dac_stream_get_stats(audio_dac_stream_stats_t *stats)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (stats == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  *stats = stream.stats;
+  CORE_EXIT_ATOMIC();
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Refill the slots of the streaming ring played since the last done
+ * interrupt
+ ******************************************************************************/
+static void stream_refill(void)
+{
+  uint32_t offset;
+  uint8_t playing, refilled = 0;
+
+  if (!stream.active) {
+    return;
+  }
+
+  // The slot the LDMA is playing, from its source address. Every slot
+  // before it since the last refill has been played.
+  offset = (LDMA->CH[ldma_channel].SRC
+            - (uint32_t)stream.buffer) / sizeof(int16_t);
+  playing = (uint8_t)(offset / stream.slot_samples);
+  if (playing >= stream.slot_count) {
+    playing = 0;
+  }
+
+  while (stream.refill_slot != playing) {
+    if ((stream.drain > 0) && (--stream.drain == 0)) {
+      // The last block has been played
+      stop_ldma();
+      stream.active = false;
+      playback_in_progress = false;
+      return;
+    }
+
+    stream_fill(stream.refill_slot, false);
+    stream.refill_slot = (uint8_t)((stream.refill_slot + 1)
+                                   % stream.slot_count);
+    refilled++;
+  }
+
+  if (refilled > 1) {
+    stream.stats.late += refilled - 1u;
+  }
+}
+
+#if AUDIO_DAC_CONFIG_USE_DMADRV
+/***************************************************************************//**
+ * DMADRV callback of the done interrupt of the streaming ring
+ ******************************************************************************/
+static bool stream_done(unsigned int channel,
+                        unsigned int sequence_no,
+                        void *user_param)
+{
+  (void)channel;
+  (void)sequence_no;
+  (void)user_param;
+
+  stream_refill();
+
+  return true;
+}
+#else
+/***************************************************************************//**
+ * LDMA interrupt of the streaming ring
+ ******************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t mask = 1UL << ldma_channel;
+
+  if ((LDMA_IntGetEnabled() & mask) == 0) {
+    return;
+  }
+  LDMA_IntClear(mask);
+
+  stream_refill();
+}
+#endif
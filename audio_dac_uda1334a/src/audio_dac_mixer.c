@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @file audio_dac_mixer.c
+ * @brief fixed-point gain, mixer and rate converter for audio dac streaming
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_dac_mixer.h"
+
+#define PHASE_ONE   (1UL << 16)
+
+/**************************************************************************//**
+ * Saturate to 16 bits
+ *****************************************************************************/
+static inline int16_t saturate(int32_t value)
+{
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+/**************************************************************************//**
+ * Take the next source frame into next, pulling a chunk from the producer
+ * when needed. Returns false if no frame is available.
+ *****************************************************************************/
+static bool source_advance(audio_dac_source_t *source)
+{
+  uint32_t count;
+  bool end = false;
+  const int16_t *frame;
+
+  if (source->chunk_index == source->chunk_frames) {
+    if (source->last_chunk) {
+      source->ended = true;
+      return false;
+    }
+    count = source->callback(source->context,
+                             source->chunk,
+                             AUDIO_DAC_SOURCE_CHUNK_FRAMES * source->channels,
+                             &end);
+    source->chunk_frames = (uint16_t)(count / source->channels);
+    source->chunk_index = 0;
+    source->last_chunk = end;
+    if (source->chunk_frames == 0) {
+      if (end) {
+        source->ended = true;
+      }
+      return false;
+    }
+  }
+
+  frame = &source->chunk[source->chunk_index * source->channels];
+  source->chunk_index++;
+  for (uint8_t c = 0; c < source->channels; c++) {
+    source->prev[c] = source->next[c];
+    source->next[c] = frame[c];
+  }
+  source->phase -= PHASE_ONE;
+
+  return true;
+}
+
+/**************************************************************************//**
+ * Add a block of a source to the output. Returns the number of frames the
+ * source provided, the block stops at the first frame it could not.
+ *****************************************************************************/
+static uint32_t source_render(audio_dac_source_t *source,
+                              int16_t *out,
+                              uint32_t frames,
+                              uint16_t gain)
+{
+  uint32_t f;
+  int32_t frac, value;
+
+  for (f = 0; f < frames; f++) {
+    while (source->phase >= PHASE_ONE) {
+      if (!source_advance(source)) {
+        if (!source->ended) {
+          source->underruns++;
+        }
+        return f;
+      }
+    }
+
+    // Linear interpolation with a Q15 fraction, the difference of two
+    // samples times the fraction fits 32 bits
+    frac = (int32_t)(source->phase >> 1);
+    for (uint8_t c = 0; c < source->channels; c++) {
+      value = source->prev[c];
+      if (frac != 0) {
+        value += ((int32_t)(source->next[c] - source->prev[c]) * frac) >> 15;
+      }
+      value = (value * (int32_t)gain) >> AUDIO_DAC_GAIN_SHIFT;
+      *out = saturate(*out + value);
+      out++;
+    }
+    // The remainder of the step keeps the rate exact over long streams
+    source->phase += source->step;
+    source->step_err += source->step_rem;
+    if (source->step_err >= source->out_rate) {
+      source->step_err -= source->out_rate;
+      source->phase++;
+    }
+  }
+
+  return frames;
+}
+
+/**************************************************************************//**
+ * Initialize a streamed source
+ *****************************************************************************/
+void audio_dac_source_init(audio_dac_source_t *source,
+                           audio_dac_source_cb_t callback,
+                           void *context,
+                           uint32_t rate)
+{
+  source->callback = callback;
+  source->context = context;
+  source->rate = rate;
+  source->gain = AUDIO_DAC_GAIN_UNITY;
+  source->underruns = 0;
+  audio_dac_source_prepare(source, rate, 1);
+}
+
+/**************************************************************************//**
+ * Set up the rate converter of a source for the output format
+ *****************************************************************************/
+void audio_dac_source_prepare(audio_dac_source_t *source,
+                              uint32_t out_rate,
+                              uint8_t channels)
+{
+  source->channels = channels;
+  source->step = (uint32_t)(((uint64_t)source->rate << 16) / out_rate);
+  source->step_rem = (uint32_t)(((uint64_t)source->rate << 16) % out_rate);
+  source->step_err = 0;
+  source->out_rate = out_rate;
+
+  // Two frames are taken before the first output frame
+  source->phase = 2 * PHASE_ONE;
+  for (uint8_t c = 0; c < AUDIO_DAC_MAX_CHANNELS; c++) {
+    source->prev[c] = 0;
+    source->next[c] = 0;
+  }
+  source->chunk_frames = 0;
+  source->chunk_index = 0;
+  source->last_chunk = false;
+  source->ended = false;
+}
+
+/**************************************************************************//**
+ * Set the gain of a source
+ *****************************************************************************/
+void audio_dac_source_set_gain(audio_dac_source_t *source, uint16_t gain)
+{
+  source->gain = gain;
+}
+
+/**************************************************************************//**
+ * Apply a gain to samples in place
+ *****************************************************************************/
+void audio_dac_gain_apply(int16_t *samples, uint32_t count, uint16_t gain)
+{
+  for (uint32_t i = 0; i < count; i++) {
+    samples[i] = saturate(((int32_t)samples[i] * (int32_t)gain)
+                          >> AUDIO_DAC_GAIN_SHIFT);
+  }
+}
+
+/**************************************************************************//**
+ * Render a block of output from up to two sources
+ *****************************************************************************/
+uint32_t audio_dac_render(int16_t *out,
+                          uint32_t frames,
+                          uint8_t channels,
+                          audio_dac_source_t *const *sources,
+                          uint8_t count,
+                          uint16_t master)
+{
+  uint32_t rendered = 0;
+  uint32_t frames_done, gain;
+
+  for (uint32_t i = 0; i < frames * channels; i++) {
+    out[i] = 0;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    audio_dac_source_t *source = sources[i];
+
+    if ((source == NULL) || source->ended) {
+      continue;
+    }
+
+    gain = ((uint32_t)source->gain * master) >> AUDIO_DAC_GAIN_SHIFT;
+    if (gain > UINT16_MAX) {
+      gain = UINT16_MAX;
+    }
+
+    frames_done = source_render(source, out, frames, (uint16_t)gain);
+    if (frames_done > rendered) {
+      rendered = frames_done;
+    }
+  }
+
+  return rendered;
+}
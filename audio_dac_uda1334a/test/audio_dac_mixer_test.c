@@ -0,0 +1,342 @@
+/***************************************************************************//**
+ * @file audio_dac_mixer_test.c
+ * @brief Host harness of the audio dac streaming refill path
+ *
+ * Checks the gain, the rate converter and the two source mixer that render
+ * the slots of the streaming ring, then measures the cost of rendering one
+ * block for a few typical formats.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc audio_dac_mixer_test.c ../src/audio_dac_mixer.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "audio_dac_mixer.h"
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// Producer of a generated signal: a ramp or a constant per channel
+typedef struct {
+  uint8_t channels;
+  int32_t value[2];         // next value per channel
+  int32_t slope;            // added per frame
+  uint32_t frames_left;     // frames before the end, or before starving
+  bool has_end;             // end when frames_left reaches 0, else starve
+  uint32_t frames_read;
+} producer_t;
+
+static uint32_t producer_cb(void *context,
+                            int16_t *samples,
+                            uint32_t count,
+                            bool *end)
+{
+  producer_t *p = context;
+  uint32_t frames = count / p->channels;
+
+  if (frames > p->frames_left) {
+    frames = p->frames_left;
+  }
+  for (uint32_t f = 0; f < frames; f++) {
+    for (uint8_t c = 0; c < p->channels; c++) {
+      *samples++ = (int16_t)p->value[c];
+      p->value[c] += p->slope;
+    }
+  }
+  p->frames_left -= frames;
+  p->frames_read += frames;
+  *end = p->has_end && (p->frames_left == 0);
+
+  return frames * p->channels;
+}
+
+static void producer_init(producer_t *p, uint8_t channels, int32_t value0,
+                          int32_t value1, int32_t slope)
+{
+  p->channels = channels;
+  p->value[0] = value0;
+  p->value[1] = value1;
+  p->slope = slope;
+  p->frames_left = UINT32_MAX;
+  p->has_end = false;
+  p->frames_read = 0;
+}
+
+static void test_gain(void)
+{
+  int16_t s[4] = { 1000, -1000, 20000, -20000 };
+
+  audio_dac_gain_apply(s, 4, AUDIO_DAC_GAIN_UNITY / 2);
+  CHECK(s[0] == 500 && s[1] == -500 && s[2] == 10000 && s[3] == -10000);
+
+  audio_dac_gain_apply(s, 4, 4 * AUDIO_DAC_GAIN_UNITY);
+  CHECK(s[0] == 2000 && s[1] == -2000);
+  CHECK(s[2] == INT16_MAX && s[3] == INT16_MIN);
+}
+
+static void test_passthrough(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[2] = { &src, NULL };
+  int16_t out[200];
+  uint32_t n;
+  int ok = 1;
+
+  producer_init(&p, 1, -5000, 0, 37);
+  audio_dac_source_init(&src, producer_cb, &p, 44100);
+  audio_dac_source_prepare(&src, 44100, 1);
+
+  n = audio_dac_render(out, 100, 1, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 100);
+  n = audio_dac_render(out + 100, 100, 1, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 100);
+  for (int i = 0; i < 200; i++) {
+    ok &= out[i] == -5000 + 37 * i;
+  }
+  CHECK(ok);
+  CHECK(src.underruns == 0);
+}
+
+static void test_upsample(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[1] = { &src };
+  int16_t out[600];
+  int ok = 1;
+
+  // 8 kHz to 48 kHz, a ramp interpolates to a ramp of 1/6 the slope
+  producer_init(&p, 1, -15000, 0, 300);
+  audio_dac_source_init(&src, producer_cb, &p, 8000);
+  audio_dac_source_prepare(&src, 48000, 1);
+
+  CHECK(audio_dac_render(out, 600, 1, sources, 1, AUDIO_DAC_GAIN_UNITY)
+        == 600);
+  for (int i = 0; i < 600; i++) {
+    ok &= abs(out[i] - (-15000 + 50 * i)) <= 1;
+  }
+  CHECK(ok);
+}
+
+static void test_rate_accuracy(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[1] = { &src };
+  static int16_t out[2 * 441];
+
+  // One second at 16 kHz to 44.1 kHz stereo consumes one second of source
+  producer_init(&p, 2, 0, 0, 1);
+  audio_dac_source_init(&src, producer_cb, &p, 16000);
+  audio_dac_source_prepare(&src, 44100, 2);
+
+  for (int block = 0; block < 100; block++) {
+    audio_dac_render(out, 441, 2, sources, 1, AUDIO_DAC_GAIN_UNITY);
+  }
+  // Frames taken up to the next chunk boundary
+  CHECK(p.frames_read >= 16000);
+  CHECK(p.frames_read <= 16000 + AUDIO_DAC_SOURCE_CHUNK_FRAMES + 2);
+}
+
+static void test_stereo(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[1] = { &src };
+  int16_t out[2 * 64];
+  int ok = 1;
+
+  producer_init(&p, 2, 1000, -1000, 0);
+  audio_dac_source_init(&src, producer_cb, &p, 16000);
+  audio_dac_source_prepare(&src, 48000, 2);
+
+  CHECK(audio_dac_render(out, 64, 2, sources, 1, AUDIO_DAC_GAIN_UNITY) == 64);
+  for (int i = 0; i < 64; i++) {
+    ok &= (out[2 * i] == 1000) && (out[2 * i + 1] == -1000);
+  }
+  CHECK(ok);
+}
+
+static void test_underrun(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[1] = { &src };
+  int16_t out[100];
+  uint32_t n;
+  int ok = 1;
+
+  producer_init(&p, 1, 0, 0, 10);
+  p.frames_left = 42;
+  audio_dac_source_init(&src, producer_cb, &p, 48000);
+  audio_dac_source_prepare(&src, 48000, 1);
+
+  // Two frames are held for the interpolation
+  n = audio_dac_render(out, 100, 1, sources, 1, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 41);
+  CHECK(src.underruns == 1);
+  CHECK(!src.ended);
+  for (uint32_t i = n; i < 100; i++) {
+    ok &= out[i] == 0;
+  }
+  CHECK(ok);
+
+  // The producer catches up, the signal continues where it stopped
+  p.frames_left = 1000;
+  n = audio_dac_render(out, 100, 1, sources, 1, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 100);
+  CHECK(out[0] == 410);
+  CHECK(out[99] == 1400);
+  CHECK(src.underruns == 1);
+}
+
+static void test_end(void)
+{
+  producer_t p;
+  audio_dac_source_t src;
+  audio_dac_source_t *sources[1] = { &src };
+  int16_t out[100];
+  uint32_t n;
+
+  producer_init(&p, 1, 0, 0, 10);
+  p.frames_left = 50;
+  p.has_end = true;
+  audio_dac_source_init(&src, producer_cb, &p, 48000);
+  audio_dac_source_prepare(&src, 48000, 1);
+
+  n = audio_dac_render(out, 100, 1, sources, 1, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 49);
+  CHECK(src.ended);
+  CHECK(src.underruns == 0);
+
+  n = audio_dac_render(out, 100, 1, sources, 1, AUDIO_DAC_GAIN_UNITY);
+  CHECK(n == 0);
+  CHECK(out[0] == 0);
+}
+
+static void test_mix(void)
+{
+  producer_t p0, p1;
+  audio_dac_source_t s0, s1;
+  audio_dac_source_t *sources[2] = { &s0, &s1 };
+  int16_t out[16];
+
+  producer_init(&p0, 1, 20000, 0, 0);
+  producer_init(&p1, 1, 20000, 0, 0);
+  audio_dac_source_init(&s0, producer_cb, &p0, 8000);
+  audio_dac_source_init(&s1, producer_cb, &p1, 16000);
+  audio_dac_source_prepare(&s0, 48000, 1);
+  audio_dac_source_prepare(&s1, 48000, 1);
+
+  // The sum saturates
+  audio_dac_render(out, 16, 1, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  CHECK(out[0] == INT16_MAX && out[15] == INT16_MAX);
+
+  // Source gains
+  audio_dac_source_set_gain(&s0, AUDIO_DAC_GAIN_UNITY / 2);
+  audio_dac_source_set_gain(&s1, AUDIO_DAC_GAIN_UNITY / 4);
+  audio_dac_render(out, 16, 1, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  CHECK(out[0] == 15000);
+
+  // Master gain
+  audio_dac_render(out, 16, 1, sources, 2, AUDIO_DAC_GAIN_UNITY / 2);
+  CHECK(out[0] == 7500);
+
+  // A source that ended no longer contributes
+  s1.ended = true;
+  audio_dac_render(out, 16, 1, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  CHECK(out[0] == 10000);
+}
+
+// Time the rendering of one slot of slot_samples samples
+static void bench(const char *name, uint8_t channels, uint32_t out_rate,
+                  uint32_t rate0, uint32_t rate1, uint16_t slot_samples)
+{
+  producer_t p0, p1;
+  audio_dac_source_t s0, s1;
+  audio_dac_source_t *sources[2] = { &s0, rate1 ? &s1 : NULL };
+  static int16_t out[2048];
+  uint32_t frames = slot_samples / channels;
+  const int blocks = 20000;
+  struct timespec t0, t1;
+  double ns;
+
+  producer_init(&p0, channels, 0, 0, 3);
+  producer_init(&p1, channels, 0, 0, -5);
+  audio_dac_source_init(&s0, producer_cb, &p0, rate0);
+  audio_dac_source_prepare(&s0, out_rate, channels);
+  audio_dac_source_set_gain(&s0, AUDIO_DAC_GAIN_UNITY / 2);
+  if (rate1) {
+    audio_dac_source_init(&s1, producer_cb, &p1, rate1);
+    audio_dac_source_prepare(&s1, out_rate, channels);
+    audio_dac_source_set_gain(&s1, AUDIO_DAC_GAIN_UNITY / 2);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int b = 0; b < blocks; b++) {
+    audio_dac_render(out, frames, channels, sources, 2, AUDIO_DAC_GAIN_UNITY);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / blocks;
+  printf("  %-28s %4u samples/slot: %8.0f ns/block %6.2f ns/sample"
+         " (slot time %.2f ms)\n",
+         name, slot_samples, ns, ns / slot_samples,
+         1000.0 * frames / out_rate);
+}
+
+int main(void)
+{
+  test_gain();
+  test_passthrough();
+  test_upsample();
+  test_rate_accuracy();
+  test_stereo();
+  test_underrun();
+  test_end();
+  test_mix();
+
+  printf("Refill cost per block on this host:\n");
+  bench("mono 8k -> 48k", 1, 48000, 8000, 0, 512);
+  bench("stereo 16k -> 44.1k", 2, 44100, 16000, 0, 1024);
+  bench("stereo 44.1k pass-through", 2, 44100, 44100, 0, 1024);
+  bench("stereo 44.1k + 8k mix", 2, 44100, 44100, 8000, 1024);
+
+  printf(failed ? "FAILED\n" : "PASSED\n");
+
+  return failed;
+}
@@ -136,6 +136,32 @@ at_cmd_scheduler_state_t at_parser_get_scheduler_state(void);
  *****************************************************************************/
 sl_status_t at_parser_add_cmd_to_q(at_cmd_desc_t *at_cmd_descriptor);
 
+/**************************************************************************//**
+ * @brief
+ *    Add a batch of independent queries to the command queue.
+ *    The queries are combined into one command line separated by ";", and
+ *    the response lines are matched to the queries by their prefix.
+ *    Command descriptor and queries MUST be allocated until the scheduler runs.
+ *
+ * @param[in] at_cmd_descriptor
+ *    Pointer to the command descriptor used for the batch.
+ *
+ * @param[in] queries
+ *    Queries to combine.
+ *
+ * @param[in] query_count
+ *    Number of queries.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_ALLOCATION_FAILED if the command line is too long or
+ *    command queue is full.
+ *
+ *****************************************************************************/
+sl_status_t at_parser_add_query_batch(at_cmd_desc_t *at_cmd_descriptor,
+                                      at_query_t *queries,
+                                      uint8_t query_count);
+
 /**************************************************************************//**
  * @brief
  *    Clears the command string in the command descriptor.
@@ -150,6 +176,35 @@ sl_status_t at_parser_add_cmd_to_q(at_cmd_desc_t *at_cmd_descriptor);
  *****************************************************************************/
 void at_parser_clear_cmd(at_cmd_desc_t *at_cmd_descriptor);
 
+/**************************************************************************//**
+ * @brief
+ *    Steps the scheduler to the next command.
+ *    Called from a line callback when the last response line arrived.
+ *
+ *****************************************************************************/
+void at_parser_scheduler_next_cmd(void);
+
+/**************************************************************************//**
+ * @brief
+ *    Stops the scheduler and reports an error in the output object.
+ *    Called from a line callback.
+ *
+ * @param[in] error_code
+ *    Error code reported in the output object.
+ *
+ *****************************************************************************/
+void at_parser_scheduler_error(uint8_t error_code);
+
+/**************************************************************************//**
+ * @brief
+ *    Copies a response line to the response data of the output object.
+ *
+ * @param[in] data
+ *    Zero terminated response line.
+ *
+ *****************************************************************************/
+void at_parser_report_data(uint8_t *data);
+
 /**************************************************************************//**
  * @brief
  *    AT parser process function.
@@ -165,6 +220,8 @@ void at_ok_error_cb(uint8_t *new_line, uint8_t call_number);
 void at_cops_cb(uint8_t *new_line, uint8_t call_number);
 void at_recv_cb(uint8_t *new_line, uint8_t call_number);
 void at_send_cb(uint8_t *new_line, uint8_t call_number);
+void at_prompt_cb(uint8_t *new_line, uint8_t call_number);
+void at_query_cb(uint8_t *new_line, uint8_t call_number);
 void at_data_cb(uint8_t *new_line, uint8_t call_number);
 void at_ip_cb(uint8_t *new_line, uint8_t call_number);
 void at_imei_cb(uint8_t *new_line, uint8_t call_number);
@@ -36,7 +36,17 @@
 #ifndef AT_PARSER_EVENTS_H_
 #define AT_PARSER_EVENTS_H_
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "sl_status.h"
+#include "at_parser_platform.h"
+
+/*******************************************************************************
+ ********************************   MACROS   ***********************************
+ ******************************************************************************/
+#define AT_EVENT_MAX_LISTENERS 8
+#define AT_URC_MAX_SUBSCRIBERS 8
+#define AT_URC_QUEUE_SIZE 4
 
 /*******************************************************************************
  **************************   ENUMS   *******************************
@@ -45,10 +55,15 @@ typedef enum {
   ONCE, ALWAYS,
 } event_type_t;
 
+/*******************************************************************************
+ **************************   TYPE DEFINITIONS   *******************************
+ ******************************************************************************/
+typedef void (*at_urc_handler_t)(uint8_t *line, void *handler_data);
+
 /**************************************************************************//**
  * @brief
  *    AT parser event listener listen function.
- *    This function can handle only one event at the same time.
+ *    The handler is called once, when the flag equals the ok value.
  *
  * @param[in] event_flag
  *    Pointer to the flag to listen to.
@@ -64,7 +79,7 @@ typedef enum {
  *
  * @return
  *   SL_STATUS_OK if event listener has been set.
- *   SL_STATUS_ALLOCATION_FAILED if listener is already running.
+ *   SL_STATUS_ALLOCATION_FAILED if all listeners are in use.
  *
  *****************************************************************************/
 sl_status_t at_listen_event(uint8_t *event_flag,
@@ -72,9 +87,119 @@ sl_status_t at_listen_event(uint8_t *event_flag,
                             void (*handle)(void*),
                             void *handler_data);
 
+/**************************************************************************//**
+ * @brief
+ *    AT parser event listener listen function with event type.
+ *    ONCE listeners are removed after the handler is called, ALWAYS
+ *    listeners are called each time the flag changes to the ok value.
+ *
+ * @param[in] event_flag
+ *    Pointer to the flag to listen to.
+ *
+ * @param[in] event_flag_ok_value
+ *    The decent flag value when the callback function should be called.
+ *
+ * @param[out] handle
+ *    Pointer to a callback function.
+ *
+ * @param[in] handler_data
+ *    Pointer to the data which will be given as callback parameter.
+ *
+ * @param[in] type
+ *    ONCE or ALWAYS.
+ *
+ * @return
+ *   SL_STATUS_OK if event listener has been set.
+ *   SL_STATUS_NULL_POINTER if flag or handler is missing.
+ *   SL_STATUS_ALLOCATION_FAILED if all listeners are in use.
+ *
+ *****************************************************************************/
+sl_status_t at_listen_event_type(uint8_t *event_flag,
+                                 uint8_t event_ok_value,
+                                 void (*handle)(void*),
+                                 void *handler_data,
+                                 event_type_t type);
+
+/**************************************************************************//**
+ * @brief
+ *    Removes the event listeners with the given handler and data.
+ *
+ * @param[in] handle
+ *    Callback function of the listener.
+ *
+ * @param[in] handler_data
+ *    Callback parameter of the listener.
+ *
+ *****************************************************************************/
+void at_remove_event_listener(void (*handle)(void*),
+                              void *handler_data);
+
+/**************************************************************************//**
+ * @brief
+ *    Subscribes a handler to unsolicited result codes.
+ *    Lines starting with the prefix are taken out of the command responses
+ *    and passed to every handler subscribed to a matching prefix from
+ *    at_event_process().
+ *
+ * @param[in] prefix
+ *    Start of the URC line, e.g. "+QIURC:" or "+CEREG:". SHALL be allocated
+ *    while subscribed.
+ *
+ * @param[in] handler
+ *    Called with the URC line and the handler data.
+ *
+ * @param[in] handler_data
+ *    Pointer to the data which will be given as handler parameter.
+ *
+ * @return
+ *   SL_STATUS_OK if the handler has been subscribed.
+ *   SL_STATUS_NULL_POINTER if prefix or handler is missing.
+ *   SL_STATUS_ALLOCATION_FAILED if all subscriber slots are in use.
+ *
+ *****************************************************************************/
+sl_status_t at_urc_subscribe(const char *prefix,
+                             at_urc_handler_t handler,
+                             void *handler_data);
+
+/**************************************************************************//**
+ * @brief
+ *    Removes a URC subscription.
+ *
+ * @param[in] prefix
+ *    Prefix of the subscription.
+ *
+ * @param[in] handler
+ *    Handler of the subscription.
+ *
+ *****************************************************************************/
+void at_urc_unsubscribe(const char *prefix,
+                        at_urc_handler_t handler);
+
+/**************************************************************************//**
+ * @brief
+ *    Takes a received line if it is subscribed to.
+ *    Called by the parser core in interrupt context.
+ *
+ * @param[in] line
+ *    Received line.
+ *
+ * @return
+ *    true if the line is a subscribed URC.
+ *
+ *****************************************************************************/
+bool at_urc_dispatch_line(const uint8_t *line);
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the number of URC lines dropped because the queue was full.
+ *
+ *****************************************************************************/
+uint32_t at_urc_get_dropped_count(void);
+
 /**************************************************************************//**
  * @brief
  *    AT parser event listener process function.
+ *    Calls the event listeners and the URC subscribers.
  *    This function SHALL be called periodically in the main loop.
  *
  *****************************************************************************/
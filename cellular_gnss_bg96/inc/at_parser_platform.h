@@ -35,6 +35,7 @@
 
 #ifndef AT_PARSER_PLATFORM_H_
 #define AT_PARSER_PLATFORM_H_
+#include <stdbool.h>
 #include "sl_status.h"
 
 /*******************************************************************************
@@ -43,6 +44,7 @@
 #define OUT_BUFFER_SIZE 100
 #define IN_BUFFER_SIZE 100
 #define CMD_MAX_SIZE 100
+#define AT_QUERY_RESPONSE_SIZE 64
 
 #define MIKROE_RX_PORT  gpioPortB
 #define MIKROE_TX_PORT  gpioPortB
@@ -57,10 +59,22 @@ typedef enum {
   NOT_INITIALIZED = 0, READY, TRANSMIT
 } at_platform_status_t;
 
+typedef struct {
+  const char *command;      // command without "AT", e.g. "+CEREG?"
+  const char *prefix;       // start of the response line, e.g. "+CEREG:"
+  uint8_t response[AT_QUERY_RESPONSE_SIZE];   // first matching line
+  bool matched;
+} at_query_t;
+
 typedef struct {
   uint8_t cms_string[CMD_MAX_SIZE];
   ln_cb_t ln_cb;
   uint16_t timeout_ms;
+  const uint8_t *data;      // binary data sent instead of cms_string if set
+  uint16_t data_length;
+  uint8_t retries;          // resends on timeout or error
+  at_query_t *queries;      // queries combined in cms_string
+  uint8_t query_count;
 } at_cmd_desc_t;
 
 /**************************************************************************//**
@@ -117,7 +131,7 @@ sl_status_t at_platform_check_device_ready();
  * @brief
  *   Platform driver send command function.
  *   This function adds \r\n to the command string.
- *   Command string SHALL be allocated until command is sent.
+ *   The command is copied to the output buffer.
  *
  * @param[in] cmd
  *   Pointer to the command to send.
@@ -132,11 +146,50 @@ sl_status_t at_platform_check_device_ready();
 sl_status_t at_platform_send_cmd(volatile uint8_t *cmd,
                                  volatile uint16_t timeout_ms);
 
+/**************************************************************************//**
+ * @brief
+ *   Platform driver send raw data function.
+ *   Sends binary data as is, e.g. after the ">" prompt of AT+QISEND.
+ *   Data SHALL be allocated until it is sent.
+ *
+ * @param[in] data
+ *   Pointer to the data to send.
+ *
+ * @param[in] length
+ *   Number of bytes to send.
+ *
+ * @param[in] timeout_ms
+ *    Timeout for the response in milliseconds.
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors.
+ *   SL_STATUS_INVALID_PARAMETER if there is no data to send.
+ *****************************************************************************/
+sl_status_t at_platform_send_raw(const uint8_t *data,
+                                 uint16_t length,
+                                 uint16_t timeout_ms);
+
+/**************************************************************************//**
+ * @brief
+ *   Platform driver receive raw data function.
+ *   Stores the next received bytes in a buffer without line processing.
+ *   Called from a line callback, e.g. on "+QIRD: <length>".
+ *
+ * @param[out] buffer
+ *   Buffer for the data, SHALL be allocated until all bytes are received.
+ *
+ * @param[in] length
+ *   Number of bytes to receive.
+ *
+ *****************************************************************************/
+void at_platform_receive_raw(uint8_t *buffer, uint16_t length);
+
 /**************************************************************************//**
  * @brief
  *   Platform driver finish function.
  *   Used to end ongoing communication.
- *   Stops timeout and hardware interrupts.
+ *   Stops timeout and transmission. The receive interrupt stays enabled for
+ *   unsolicited result codes.
  *
  *****************************************************************************/
 void at_platform_finish_cmd(void);
@@ -0,0 +1,150 @@
+/***************************************************************************//**
+ * @file at_parser_stream.h
+ * @brief header file for AT command parser byte stream handling
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef AT_PARSER_STREAM_H_
+#define AT_PARSER_STREAM_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "at_parser_platform.h"
+
+/*******************************************************************************
+ **************************   TYPE DEFINITIONS   *******************************
+ ******************************************************************************/
+typedef struct {
+  uint8_t line[IN_BUFFER_SIZE];       ///< Line being received, zero terminated
+  uint8_t line_index;                 ///< Characters in line
+  uint8_t line_counter;               ///< Lines received for the command
+  uint8_t *raw_ptr;                   ///< Next byte of a raw receive
+  uint16_t raw_remaining;             ///< Bytes left of a raw receive
+  const volatile uint8_t *tx_ptr;     ///< Next byte to transmit
+  uint16_t tx_remaining;              ///< Bytes left to transmit
+  ln_cb_t line_cb;                    ///< Called for each line
+} at_stream_t;
+
+/**************************************************************************//**
+ * @brief
+ *    Initializes a byte stream.
+ *
+ * @param[out] stream
+ *    Stream state.
+ *
+ * @param[in] line_callback
+ *    Callback function for new line (and ">" character for special commands).
+ *
+ *****************************************************************************/
+void at_stream_init(at_stream_t *stream, ln_cb_t line_callback);
+
+/**************************************************************************//**
+ * @brief
+ *    Starts counting the response lines of a new command.
+ *
+ * @param[in,out] stream
+ *    Stream state.
+ *
+ *****************************************************************************/
+void at_stream_new_command(at_stream_t *stream);
+
+/**************************************************************************//**
+ * @brief
+ *    Processes a received byte.
+ *    Outside of a raw receive, \r characters are removed, the line is passed
+ *    to the line callback on \n, on ">" and when the line buffer is full.
+ *    Empty lines are dropped.
+ *    Do not block in this function, it is called from interrupt context!
+ *
+ * @param[in,out] stream
+ *    Stream state.
+ *
+ * @param[in] byte
+ *    Received byte.
+ *
+ *****************************************************************************/
+void at_stream_receive_byte(at_stream_t *stream, uint8_t byte);
+
+/**************************************************************************//**
+ * @brief
+ *    Stores the next received bytes in a buffer, bypassing the line parser.
+ *    Called from a line callback when the line announces binary data,
+ *    e.g. "+QIRD: <length>". Line processing resumes after the last byte.
+ *
+ * @param[in,out] stream
+ *    Stream state.
+ *
+ * @param[out] buffer
+ *    Buffer for the data, SHALL be allocated until all bytes are received.
+ *
+ * @param[in] length
+ *    Number of bytes to store, 0 cancels an ongoing raw receive.
+ *
+ *****************************************************************************/
+void at_stream_receive_raw(at_stream_t *stream,
+                           uint8_t *buffer,
+                           uint16_t length);
+
+/**************************************************************************//**
+ * @brief
+ *    Starts the transmission of a buffer.
+ *
+ * @param[in,out] stream
+ *    Stream state.
+ *
+ * @param[in] data
+ *    Data to send, SHALL be allocated until all bytes are sent.
+ *
+ * @param[in] length
+ *    Number of bytes to send.
+ *
+ *****************************************************************************/
+void at_stream_transmit(at_stream_t *stream,
+                        const volatile uint8_t *data,
+                        uint16_t length);
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the next byte to transmit.
+ *
+ * @param[in,out] stream
+ *    Stream state.
+ *
+ * @param[out] byte
+ *    Next byte to transmit.
+ *
+ * @return
+ *    true if a byte is returned, false if the transmission has finished.
+ *
+ *****************************************************************************/
+bool at_stream_transmit_byte(at_stream_t *stream, uint8_t *byte);
+
+#endif /* AT_PARSER_STREAM_H_ */
@@ -36,6 +36,7 @@
 #define NB_IOT_H_
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "sl_status.h"
 #include "at_parser_core.h"
 
@@ -43,6 +44,10 @@
  ********************************   MACROS   ***********************************
  ******************************************************************************/
 #define DATA_MAX_LENGTH 80u
+// Maximum data length of one AT+QISEND on a TCP socket
+#define BG96_SEND_CHUNK_SIZE 1460u
+// Maximum data length of one AT+QIRD
+#define BG96_RECV_MAX_LENGTH 1500u
 
 /*******************************************************************************
  *****************************   STRUCTURES   **********************************
@@ -54,6 +59,13 @@ typedef struct {
   uint8_t *address;
 } bg96_nb_connection_t;
 
+typedef struct {
+  uint8_t rssi;             // +CSQ <rssi>, 0..31, 99 if not known
+  uint8_t ber;              // +CSQ <ber>, 0..7, 99 if not known
+  uint8_t reg_status;       // +CEREG <stat>, 1 home, 5 roaming
+  bool attached;            // +CGATT <state>
+} bg96_nb_status_t;
+
 /**************************************************************************//**
  * @brief
  *    BG96 NB IoT initialization.
@@ -185,4 +197,97 @@ sl_status_t read_imei(at_scheduler_status_t *output_object);
  *****************************************************************************/
 sl_status_t bg96_get_operator(at_scheduler_status_t *output_object);
 
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT send binary data on a socket.
+ *    The data is sent in chunks of BG96_SEND_CHUNK_SIZE bytes,
+ *    each with AT+QISEND=<socket>,<length>, the ">" prompt and SEND OK.
+ *
+ * @param[in] connection
+ *    Pointer to the connection descriptor structure.
+ *
+ * @param[in] data
+ *    Pointer to the data to send, SHALL be allocated until the scheduler
+ *    finishes.
+ *
+ * @param[in] length
+ *    Number of bytes to send.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_INVALID_PARAMETER if there is no data to send.
+ *    SL_STATUS_BUSY if scheduler is busy.
+ *    SL_STATUS_ALLOCATION_FAILED if command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_socket_send(bg96_nb_connection_t *connection,
+                                const uint8_t *data,
+                                size_t length,
+                                at_scheduler_status_t *output_object);
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT receive binary data from a socket.
+ *    Data read with AT+QIRD is stored in the buffer directly, without
+ *    passing through the line parser.
+ *
+ * @param[in] connection
+ *    Pointer to the connection descriptor structure.
+ *
+ * @param[out] buffer
+ *    Buffer for the data, SHALL be allocated until the scheduler finishes.
+ *
+ * @param[in] size
+ *    Size of the buffer, at most BG96_RECV_MAX_LENGTH bytes are read.
+ *
+ * @param[out] received
+ *    Number of bytes received, valid when the scheduler finishes.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_INVALID_PARAMETER if there is no buffer.
+ *    SL_STATUS_BUSY if scheduler is busy.
+ *    SL_STATUS_ALLOCATION_FAILED if command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_socket_receive(bg96_nb_connection_t *connection,
+                                   uint8_t *buffer,
+                                   uint16_t size,
+                                   uint16_t *received,
+                                   at_scheduler_status_t *output_object);
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT poll the signal quality, EPS registration and attach state.
+ *    The queries are sent in one command line and resent once on timeout.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_FAIL if scheduler is busy or command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_poll_status(at_scheduler_status_t *output_object);
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT get the result of the last status poll.
+ *
+ * @param[out] status
+ *    Signal quality, registration and attach state.
+ *
+ * @return
+ *    SL_STATUS_OK if every query was answered.
+ *    SL_STATUS_NOT_FOUND if a response is missing.
+ *****************************************************************************/
+sl_status_t bg96_nb_get_status(bg96_nb_status_t *status);
+
 #endif /* NB_IOT_H_ */
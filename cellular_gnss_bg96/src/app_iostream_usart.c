@@ -65,6 +65,7 @@ static void open(void);
 static void send(void);
 static void close(void);
 static void cops(void);
+static void status(void);
 static void receive(void);
 static void gps_start(void);
 static void gps_location(void);
@@ -82,6 +83,7 @@ static void close_handler(void *handler_data);
 static void send_handler(void *handler_data);
 static void recv_handler(void *handler_data);
 static void cops_handler(void *handler_data);
+static void status_handler(void *handler_data);
 static void stop_gnss_handler(void *handler_data);
 static void get_position_handler(void *handler_data);
 static void start_gnss_handler(void *handler_data);
@@ -106,6 +108,7 @@ static cli_cmd_t cli_cmds[] = {
                                 { "send", send },
                                 { "close", close },
                                 { "cops", cops },
+                                { "status", status },
                                 { "recv", receive },
                                 { "gpsstart", gps_start },
                                 { "location", gps_location },
@@ -543,6 +546,47 @@ static void cops_handler(void *handler_data)
   }
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Poll signal quality and registration state function.
+ *    Result will be available in the global output_object.
+ *
+ ******************************************************************************/
+static void status(void)
+{
+  at_parser_init_output_object(&output_object);
+  bg96_nb_poll_status(&output_object);
+  at_listen_event((uint8_t*) &output_object.status, SL_STATUS_OK,
+      status_handler, (void*) &output_object);
+  printf("Polling status!\r\n");
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Poll status handler function.
+ *
+ * @param[in] handler_data
+ *    Data sent by the event handler.
+ *    Currently  handler_data is a pointer to an at_scheduler_status_t.
+ *
+ ******************************************************************************/
+static void status_handler(void *handler_data)
+{
+  at_scheduler_status_t *l_output = (at_scheduler_status_t*) handler_data;
+  bg96_nb_status_t nb_status;
+
+  if (l_output->error_code) {
+    printf("Error while polling status: %d\r\n %s\r\n", l_output->error_code,
+        l_output->response_data);
+  } else if (SL_STATUS_OK == bg96_nb_get_status(&nb_status)) {
+    printf("RSSI: %d BER: %d Registration: %d Attached: %d\r\n",
+        (int) nb_status.rssi, (int) nb_status.ber, (int) nb_status.reg_status,
+        (int) nb_status.attached);
+  } else {
+    printf("Incomplete status response!\r\n");
+  }
+}
+
 /***************************************************************************//**
  * @brief
  *    Receive data function.
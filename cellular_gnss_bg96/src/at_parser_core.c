@@ -33,6 +33,7 @@
  * at the sole discretion of Silicon Labs.
  ******************************************************************************/
 #include "at_parser_core.h"
+#include "at_parser_events.h"
 #include <string.h>
 #include "circular_queue.h"
 #include <stdlib.h>
@@ -46,9 +47,13 @@
 static Queue_t cmd_q;
 static at_cmd_scheduler_state_t sch_state = SCH_READY;
 static at_scheduler_status_t *global_status;
+// Response lines and resends of the command at the head of the queue
+static uint8_t cmd_line_counter;
+static uint8_t cmd_attempt;
 
 static void general_platform_cb(uint8_t *data,
                                 uint8_t call_number);
+static sl_status_t send_cmd_descriptor(at_cmd_desc_t *at_cmd_descriptor);
 
 /**************************************************************************//**
  * @brief
@@ -137,8 +142,8 @@ sl_status_t at_parser_start_scheduler(at_scheduler_status_t *output_object)
     global_status = output_object;
     at_parser_init_output_object(global_status);
     at_cmd_descriptor = queuePeek(&cmd_q);
-    return at_platform_send_cmd(at_cmd_descriptor->cms_string,
-        at_cmd_descriptor->timeout_ms);
+    cmd_attempt = 0;
+    return send_cmd_descriptor(at_cmd_descriptor);
   }
   return SL_STATUS_ALLOCATION_FAILED;
 }
@@ -235,6 +240,57 @@ sl_status_t at_parser_add_cmd_to_q(at_cmd_desc_t *at_cmd_descriptor)
   return SL_STATUS_OK;
 }
 
+/**************************************************************************//**
+ * @brief
+ *    Add a batch of independent queries to the command queue.
+ *    The queries are combined into one command line separated by ";", and
+ *    the response lines are matched to the queries by their prefix.
+ *    Command descriptor and queries MUST be allocated until the scheduler runs.
+ *
+ * @param[in] at_cmd_descriptor
+ *    Pointer to the command descriptor used for the batch.
+ *
+ * @param[in] queries
+ *    Queries to combine.
+ *
+ * @param[in] query_count
+ *    Number of queries.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_ALLOCATION_FAILED if the command line is too long or
+ *    command queue is full.
+ *
+ *****************************************************************************/
+sl_status_t at_parser_add_query_batch(at_cmd_desc_t *at_cmd_descriptor,
+                                      at_query_t *queries,
+                                      uint8_t query_count)
+{
+  uint8_t i;
+  size_t length = 2;
+
+  for (i = 0; i < query_count; i++) {
+    length += strlen(queries[i].command) + 1;
+  }
+  if ((query_count == 0) || (length > CMD_MAX_SIZE - 2)) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+
+  at_parser_clear_cmd(at_cmd_descriptor);
+  strcpy((char*) at_cmd_descriptor->cms_string, "AT");
+  for (i = 0; i < query_count; i++) {
+    if (i > 0) {
+      strcat((char*) at_cmd_descriptor->cms_string, ";");
+    }
+    strcat((char*) at_cmd_descriptor->cms_string, queries[i].command);
+  }
+  at_cmd_descriptor->ln_cb = at_query_cb;
+  at_cmd_descriptor->data = NULL;
+  at_cmd_descriptor->queries = queries;
+  at_cmd_descriptor->query_count = query_count;
+  return at_parser_add_cmd_to_q(at_cmd_descriptor);
+}
+
 /**************************************************************************//**
  * @brief
  *    AT parser process function.
@@ -252,8 +308,8 @@ void at_parser_process(void)
     at_platform_finish_cmd();
     if (!queueIsEmpty(&cmd_q)) {
       at_cmd_descriptor = (at_cmd_desc_t*) queuePeek(&cmd_q);
-      at_platform_send_cmd(at_cmd_descriptor->cms_string,
-          at_cmd_descriptor->timeout_ms);
+      cmd_attempt = 0;
+      send_cmd_descriptor(at_cmd_descriptor);
       sch_state = SCH_SENDING;
     } else {
       global_status->status = SL_STATUS_OK;
@@ -262,6 +318,16 @@ void at_parser_process(void)
     break;
   case SCH_ERROR:
     at_platform_finish_cmd();
+    at_cmd_descriptor = (at_cmd_desc_t*) queuePeek(&cmd_q);
+    if ((at_cmd_descriptor != NULL)
+        && (cmd_attempt < at_cmd_descriptor->retries)) {
+      // resend the failed command, the rest of the queue is kept
+      cmd_attempt++;
+      global_status->error_code = 0;
+      send_cmd_descriptor(at_cmd_descriptor);
+      sch_state = SCH_SENDING;
+      break;
+    }
     while (!queueIsEmpty(&cmd_q)) {
       queueRemove(&cmd_q);
     }
@@ -275,6 +341,56 @@ void at_parser_process(void)
   }
 }
 
+/**************************************************************************//**
+ * @brief
+ *    Sends the command string or the binary data of a command descriptor.
+ *
+ * @param[in] at_cmd_descriptor
+ *    Pointer to the command descriptor to send.
+ *
+ *****************************************************************************/
+static sl_status_t send_cmd_descriptor(at_cmd_desc_t *at_cmd_descriptor)
+{
+  uint8_t i;
+
+  cmd_line_counter = 0;
+  for (i = 0; i < at_cmd_descriptor->query_count; i++) {
+    at_cmd_descriptor->queries[i].matched = false;
+  }
+  if (at_cmd_descriptor->data != NULL) {
+    return at_platform_send_raw(at_cmd_descriptor->data,
+        at_cmd_descriptor->data_length, at_cmd_descriptor->timeout_ms);
+  }
+  return at_platform_send_cmd(at_cmd_descriptor->cms_string,
+      at_cmd_descriptor->timeout_ms);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Checks if a line is the response to a query of the command, so that it
+ *    is not taken by a URC subscriber with the same prefix, e.g. +CEREG:.
+ *
+ *****************************************************************************/
+static bool query_expects_line(at_cmd_desc_t *at_cmd_descriptor,
+                               uint8_t *line)
+{
+  uint8_t i;
+  at_query_t *query;
+
+  if (at_cmd_descriptor == NULL) {
+    return false;
+  }
+  for (i = 0; i < at_cmd_descriptor->query_count; i++) {
+    query = &at_cmd_descriptor->queries[i];
+    if (!query->matched
+        && !strncmp((const char*) line, query->prefix,
+                    strlen(query->prefix))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**************************************************************************//**
  * @brief
  *    General platfrom core callback function.
@@ -296,10 +412,12 @@ static void general_platform_cb(uint8_t *data,
   if (call_number == 0) {
     at_platform_finish_cmd();
     at_parser_scheduler_error(SL_STATUS_TIMEOUT);
-  } else {
+  } else if (query_expects_line(at_cmd_descriptor, data)
+             || !at_urc_dispatch_line(data)) {
+    // lines taken by URC subscribers are not counted
     if (at_cmd_descriptor != NULL) {
       // call line callback of the command descriptor if available
-      at_cmd_descriptor->ln_cb(data, call_number);
+      at_cmd_descriptor->ln_cb(data, ++cmd_line_counter);
     }
   }
 }
@@ -344,6 +462,48 @@ void at_send_cb(uint8_t *new_line,
   }
 }
 
+void at_query_cb(uint8_t *new_line,
+                  uint8_t call_number)
+{
+  at_cmd_desc_t *at_cmd_descriptor = queuePeek(&cmd_q);
+  at_query_t *query;
+  uint8_t i;
+
+  (void) call_number;
+  for (i = 0; i < at_cmd_descriptor->query_count; i++) {
+    query = &at_cmd_descriptor->queries[i];
+    if (!query->matched
+        && !strncmp((const char*) new_line, query->prefix,
+                    strlen(query->prefix))) {
+      strncpy((char*) query->response, (const char*) new_line,
+          AT_QUERY_RESPONSE_SIZE - 1);
+      query->response[AT_QUERY_RESPONSE_SIZE - 1] = '\0';
+      query->matched = true;
+      return;
+    }
+  }
+  //one final result for the whole batch, other lines are the echo
+  if (!strcmp((const char*) new_line, "OK")) {
+    at_parser_scheduler_next_cmd();
+  } else if (has_substring(new_line, "ERROR")) {
+    at_parser_report_data(new_line);
+    at_parser_scheduler_error(SL_STATUS_FAIL);
+  }
+}
+
+void at_prompt_cb(uint8_t *new_line,
+                  uint8_t call_number)
+{
+  //lines before the prompt are the echo of the command
+  (void) call_number;
+  if (has_substring(new_line, ">")) {
+    at_parser_scheduler_next_cmd();
+  } else if (has_substring(new_line, "ERROR")) {
+    at_parser_report_data(new_line);
+    at_parser_scheduler_error(SL_STATUS_FAIL);
+  }
+}
+
 void at_data_cb(uint8_t *new_line,
                 uint8_t call_number)
 {
@@ -36,17 +36,37 @@
 #include "at_parser_events.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
-static void (*global_handle)();
-static uint8_t global_ok_value;
-static uint8_t *global_event_flag;
-static bool event_handled = true;
-static void *global_handler_data;
+typedef struct {
+  uint8_t *event_flag;
+  uint8_t ok_value;
+  void (*handle)(void*);
+  void *handler_data;
+  event_type_t type;
+  bool armed;               // ALWAYS listeners fire again once the flag left
+                            // the ok value
+} at_event_listener_t;
+
+typedef struct {
+  const char *prefix;
+  at_urc_handler_t handler;
+  void *handler_data;
+} at_urc_subscriber_t;
+
+static at_event_listener_t listeners[AT_EVENT_MAX_LISTENERS];
+static at_urc_subscriber_t urc_subscribers[AT_URC_MAX_SUBSCRIBERS];
+
+// URC lines taken in interrupt context, dispatched in the main loop
+static uint8_t urc_lines[AT_URC_QUEUE_SIZE][IN_BUFFER_SIZE];
+static volatile uint8_t urc_head;
+static volatile uint8_t urc_tail;
+static volatile uint32_t urc_dropped;
 
 /**************************************************************************//**
  * @brief
  *    AT parser event listener listen function.
- *    This function can handle only one event at the same time.
+ *    The handler is called once, when the flag equals the ok value.
  *
  * @param[in] event_flag
  *    Pointer to the flag to listen to.
@@ -62,7 +82,7 @@ static void *global_handler_data;
  *
  * @return
  *   SL_STATUS_OK if event listener has been set.
- *   SL_STATUS_ALLOCATION_FAILED if listener is already running.
+ *   SL_STATUS_ALLOCATION_FAILED if all listeners are in use.
  *
  *****************************************************************************/
 sl_status_t at_listen_event(uint8_t *event_flag,
@@ -70,29 +90,183 @@ sl_status_t at_listen_event(uint8_t *event_flag,
                             void (*handle)(void*),
                             void *handler_data)
 {
-  global_event_flag = event_flag;
-  global_ok_value = event_ok_value;
-  global_handler_data = handler_data;
-  if (handle != NULL && event_handled == true) {
-    global_handle = handle;
-    event_handled = false;
-    return SL_STATUS_OK;
+  return at_listen_event_type(event_flag, event_ok_value, handle,
+                              handler_data, ONCE);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    AT parser event listener listen function with event type.
+ *    ONCE listeners are removed after the handler is called, ALWAYS
+ *    listeners are called each time the flag changes to the ok value.
+ *****************************************************************************/
+sl_status_t at_listen_event_type(uint8_t *event_flag,
+                                 uint8_t event_ok_value,
+                                 void (*handle)(void*),
+                                 void *handler_data,
+                                 event_type_t type)
+{
+  uint8_t i;
+
+  if ((event_flag == NULL) || (handle == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  for (i = 0; i < AT_EVENT_MAX_LISTENERS; i++) {
+    if (listeners[i].handle == NULL) {
+      listeners[i].event_flag = event_flag;
+      listeners[i].ok_value = event_ok_value;
+      listeners[i].handler_data = handler_data;
+      listeners[i].type = type;
+      listeners[i].armed = true;
+      listeners[i].handle = handle;
+      return SL_STATUS_OK;
+    }
   }
   return SL_STATUS_ALLOCATION_FAILED;
 }
 
+/**************************************************************************//**
+ * @brief
+ *    Removes the event listeners with the given handler and data.
+ *****************************************************************************/
+void at_remove_event_listener(void (*handle)(void*),
+                              void *handler_data)
+{
+  uint8_t i;
+
+  for (i = 0; i < AT_EVENT_MAX_LISTENERS; i++) {
+    if ((listeners[i].handle == handle)
+        && (listeners[i].handler_data == handler_data)) {
+      listeners[i].handle = NULL;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Subscribes a handler to unsolicited result codes.
+ *    Several handlers may subscribe to the same prefix.
+ *****************************************************************************/
+sl_status_t at_urc_subscribe(const char *prefix,
+                             at_urc_handler_t handler,
+                             void *handler_data)
+{
+  uint8_t i;
+
+  if ((prefix == NULL) || (*prefix == '\0') || (handler == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  for (i = 0; i < AT_URC_MAX_SUBSCRIBERS; i++) {
+    if (urc_subscribers[i].handler == NULL) {
+      urc_subscribers[i].prefix = prefix;
+      urc_subscribers[i].handler_data = handler_data;
+      urc_subscribers[i].handler = handler;
+      return SL_STATUS_OK;
+    }
+  }
+  return SL_STATUS_ALLOCATION_FAILED;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Removes a URC subscription.
+ *****************************************************************************/
+void at_urc_unsubscribe(const char *prefix,
+                        at_urc_handler_t handler)
+{
+  uint8_t i;
+
+  for (i = 0; i < AT_URC_MAX_SUBSCRIBERS; i++) {
+    if ((urc_subscribers[i].handler == handler)
+        && !strcmp(urc_subscribers[i].prefix, prefix)) {
+      urc_subscribers[i].handler = NULL;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Checks if a line starts with the prefix of a subscriber.
+ *****************************************************************************/
+static bool urc_match(const uint8_t *line, const at_urc_subscriber_t *sub)
+{
+  return (sub->handler != NULL)
+         && !strncmp((const char*) line, sub->prefix, strlen(sub->prefix));
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Takes a received line if it is subscribed to.
+ *    Called by the parser core in interrupt context.
+ *****************************************************************************/
+bool at_urc_dispatch_line(const uint8_t *line)
+{
+  uint8_t i;
+  uint8_t next;
+
+  for (i = 0; i < AT_URC_MAX_SUBSCRIBERS; i++) {
+    if (urc_match(line, &urc_subscribers[i])) {
+      next = (uint8_t) ((urc_head + 1) % AT_URC_QUEUE_SIZE);
+      if (next == urc_tail) {
+        urc_dropped++;
+      } else {
+        strncpy((char*) urc_lines[urc_head], (const char*) line,
+                IN_BUFFER_SIZE - 1);
+        urc_lines[urc_head][IN_BUFFER_SIZE - 1] = '\0';
+        urc_head = next;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the number of URC lines dropped because the queue was full.
+ *****************************************************************************/
+uint32_t at_urc_get_dropped_count(void)
+{
+  return urc_dropped;
+}
+
 /**************************************************************************//**
  * @brief
  *    AT parser event listener process function.
+ *    Calls the event listeners and the URC subscribers.
  *    This function SHALL be called periodically in the main loop.
  *
  *****************************************************************************/
 void at_event_process(void)
 {
-  if (!event_handled
-      && *global_event_flag == global_ok_value&& global_handle !=NULL) {
-    global_handle(global_handler_data);
-    event_handled = true;
+  uint8_t i;
+  at_event_listener_t *listener;
+
+  for (i = 0; i < AT_EVENT_MAX_LISTENERS; i++) {
+    listener = &listeners[i];
+    if (listener->handle == NULL) {
+      continue;
+    }
+    if (*listener->event_flag != listener->ok_value) {
+      listener->armed = true;
+    } else if (listener->armed) {
+      void (*handle)(void*) = listener->handle;
+      listener->armed = false;
+      if (listener->type == ONCE) {
+        // free the slot first, the handler may listen again
+        listener->handle = NULL;
+      }
+      handle(listener->handler_data);
+    }
   }
-}
 
+  while (urc_tail != urc_head) {
+    for (i = 0; i < AT_URC_MAX_SUBSCRIBERS; i++) {
+      if (urc_match(urc_lines[urc_tail], &urc_subscribers[i])) {
+        urc_subscribers[i].handler(urc_lines[urc_tail],
+                                   urc_subscribers[i].handler_data);
+      }
+    }
+    urc_tail = (uint8_t) ((urc_tail + 1) % AT_URC_QUEUE_SIZE);
+  }
+}
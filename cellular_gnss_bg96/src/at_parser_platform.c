@@ -34,6 +34,7 @@
  ******************************************************************************/
 
 #include "at_parser_platform.h"
+#include "at_parser_stream.h"
 #include "sl_iostream.h"
 #include "sl_iostream_init_instances.h"
 #include "sl_iostream_handles.h"
@@ -44,14 +45,12 @@
 static void timer_cb(sl_sleeptimer_timer_handle_t *handle,
                      void *data);
 
-volatile uint8_t *output_ptr = NULL;
-uint8_t input_buffer[IN_BUFFER_SIZE];
-uint8_t input_buffer_index;
+static uint8_t output_buffer[OUT_BUFFER_SIZE];
+static at_stream_t stream;
 
 at_platform_status_t status = NOT_INITIALIZED;
 ln_cb_t global_cb = 0;
 sl_sleeptimer_timer_handle_t my_timer;
-uint8_t line_counter = 0;
 
 /**************************************************************************//**
  * @brief
@@ -114,35 +113,14 @@ void initUSART0(void)
  *    The USART0 receive interrupt saves incoming characters.
  *    This function removes \r and \n characters.
  *    Calls global callback if it is defined.
- *    Uses its own buffer to store.
+ *    Bytes of a raw receive are stored in the caller buffer instead.
  *    Do not block in this function!
  *
  *****************************************************************************/
 void USART0_RX_IRQHandler(void)
 {
   // Get the character just received
-  input_buffer[input_buffer_index] = USART0->RXDATA;
-  if (input_buffer[input_buffer_index] == '\r') {
-    //ignore \r character
-    input_buffer[input_buffer_index] = 0;
-  } else if (input_buffer[input_buffer_index] == '\n') {
-    input_buffer[input_buffer_index] = 0;
-    if (input_buffer_index > 0) {
-      global_cb(input_buffer, ++line_counter);
-      memset((void*) input_buffer, 0, IN_BUFFER_SIZE);
-      input_buffer_index = 0;
-    }
-  } else if (input_buffer[input_buffer_index] == '>') {
-    global_cb(input_buffer, ++line_counter);
-    memset(input_buffer, 0, IN_BUFFER_SIZE);
-    input_buffer_index = 0;
-  } else if (input_buffer_index < IN_BUFFER_SIZE - 1) {
-    input_buffer_index++;
-  } else {
-    global_cb(input_buffer, ++line_counter);
-    memset(input_buffer, 0, IN_BUFFER_SIZE);
-    input_buffer_index = 0;
-  }
+  at_stream_receive_byte(&stream, (uint8_t) USART0->RXDATA);
 }
 
 /**************************************************************************//**
@@ -161,12 +139,12 @@ static void tx_ready_cb(void)
  *****************************************************************************/
 void USART0_TX_IRQHandler(void)
 {
-  // Send a previously received character
-  if (*output_ptr != '\0')
-    USART0->TXDATA = *(output_ptr++);
-  else
+  uint8_t byte;
 
-  {
+  // Send the next character of the command or data
+  if (at_stream_transmit_byte(&stream, &byte)) {
+    USART0->TXDATA = byte;
+  } else {
     tx_ready_cb();
     USART_IntDisable(USART0, USART_IEN_TXBL);
   }
@@ -183,6 +161,7 @@ void USART0_TX_IRQHandler(void)
 void at_platform_init(ln_cb_t line_callback)
 {
   global_cb = line_callback;
+  at_stream_init(&stream, line_callback);
   initCMU();
   initGPIO();
   initUSART0();
@@ -255,11 +234,31 @@ sl_status_t at_platform_check_device_ready(void)
   }
 }
 
+/**************************************************************************//**
+ * @brief
+ *   Starts the transmission of the output and the command timeout.
+ *
+ *****************************************************************************/
+static sl_status_t start_transmit(const volatile uint8_t *data,
+                                  uint16_t length,
+                                  uint16_t timeout_ms)
+{
+  at_stream_new_command(&stream);
+  at_stream_transmit(&stream, data, length);
+  status = TRANSMIT;
+  at_platform_enable_ir();
+  // The TX buffer level interrupt sends every byte, the first one included
+  USART_IntEnable(USART0, USART_IEN_TXBL);
+
+  return sl_sleeptimer_restart_timer_ms(&my_timer, timeout_ms, timer_cb,
+      (void*) NULL, 0, 0);
+}
+
 /**************************************************************************//**
  * @brief
  *   Platform driver send command function.
  *   This function adds \r\n to the command string.
- *   Command string SHALL be allocated until command is sent.
+ *   The command is copied to the output buffer.
  *   This function uses UART TX interrupt.
  *
  * @param[in] cmd
@@ -275,35 +274,77 @@ sl_status_t at_platform_check_device_ready(void)
 sl_status_t at_platform_send_cmd(volatile uint8_t *cmd,
                                  volatile uint16_t timeout_ms)
 {
-  sl_status_t st;
   size_t cmd_length = strlen((const char*) cmd);
   if (cmd_length < OUT_BUFFER_SIZE - 2) {
-    strcat((char*) cmd, "\r\n");
-    output_ptr = cmd;
-    USART_IntEnable(USART0, USART_IEN_TXBL);
-    at_platform_enable_ir();
-    USART0->TXDATA = *output_ptr++;
-
-    line_counter = 0;
-    status = TRANSMIT;
-    st = sl_sleeptimer_restart_timer_ms(&my_timer, timeout_ms, timer_cb,
-        (void*) NULL, 0, 0);
-    return st;
+    memcpy(output_buffer, (const void*) cmd, cmd_length);
+    output_buffer[cmd_length++] = '\r';
+    output_buffer[cmd_length++] = '\n';
+    return start_transmit(output_buffer, (uint16_t) cmd_length, timeout_ms);
   }
   return SL_STATUS_ALLOCATION_FAILED;
 }
 
+/**************************************************************************//**
+ * @brief
+ *   Platform driver send raw data function.
+ *   Sends binary data as is, e.g. after the ">" prompt of AT+QISEND.
+ *   Data SHALL be allocated until it is sent.
+ *   This function uses UART TX interrupt.
+ *
+ * @param[in] data
+ *   Pointer to the data to send.
+ *
+ * @param[in] length
+ *   Number of bytes to send.
+ *
+ * @param[in] timeout_ms
+ *    Timeout for the response in milliseconds.
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors.
+ *   SL_STATUS_INVALID_PARAMETER if there is no data to send.
+ *****************************************************************************/
+sl_status_t at_platform_send_raw(const uint8_t *data,
+                                 uint16_t length,
+                                 uint16_t timeout_ms)
+{
+  if ((data == NULL) || (length == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return start_transmit(data, length, timeout_ms);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Platform driver receive raw data function.
+ *   Stores the next received bytes in a buffer without line processing.
+ *   Called from a line callback, e.g. on "+QIRD: <length>".
+ *
+ * @param[out] buffer
+ *   Buffer for the data, SHALL be allocated until all bytes are received.
+ *
+ * @param[in] length
+ *   Number of bytes to receive.
+ *
+ *****************************************************************************/
+void at_platform_receive_raw(uint8_t *buffer, uint16_t length)
+{
+  at_stream_receive_raw(&stream, buffer, length);
+}
+
 /**************************************************************************//**
  * @brief
  *   Platform driver finish function.
  *   Used to end ongoing communication.
- *   Stops timeout and hardware interrupts.
+ *   Stops timeout and transmission. The receive interrupt stays enabled for
+ *   unsolicited result codes.
  *
  *****************************************************************************/
 void at_platform_finish_cmd(void)
 {
   status = READY;
-  at_platform_disable_ir();
+  USART_IntDisable(USART0, USART_IEN_TXBL);
   sl_sleeptimer_stop_timer(&my_timer);
+  at_stream_receive_raw(&stream, NULL, 0);
 }
 
@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ * @file at_parser_stream.c
+ * @brief AT command parser byte stream handling source
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "at_parser_stream.h"
+#include <stddef.h>
+
+/**************************************************************************//**
+ * @brief
+ *    Initializes a byte stream.
+ *****************************************************************************/
+void at_stream_init(at_stream_t *stream, ln_cb_t line_callback)
+{
+  stream->line[0] = 0;
+  stream->line_index = 0;
+  stream->line_counter = 0;
+  stream->raw_ptr = NULL;
+  stream->raw_remaining = 0;
+  stream->tx_ptr = NULL;
+  stream->tx_remaining = 0;
+  stream->line_cb = line_callback;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Starts counting the response lines of a new command.
+ *****************************************************************************/
+void at_stream_new_command(at_stream_t *stream)
+{
+  stream->line_counter = 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Passes the received line to the line callback and starts a new one.
+ *****************************************************************************/
+static void stream_flush_line(at_stream_t *stream)
+{
+  stream->line[stream->line_index] = 0;
+  stream->line_index = 0;
+  if (stream->line_cb != NULL) {
+    stream->line_cb(stream->line, ++stream->line_counter);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Processes a received byte.
+ *****************************************************************************/
+void at_stream_receive_byte(at_stream_t *stream, uint8_t byte)
+{
+  if (stream->raw_remaining > 0) {
+    // Binary data announced by the previous line
+    *stream->raw_ptr++ = byte;
+    stream->raw_remaining--;
+    return;
+  }
+
+  if (byte == '\r') {
+    //ignore \r character
+  } else if (byte == '\n') {
+    if (stream->line_index > 0) {
+      stream_flush_line(stream);
+    }
+  } else {
+    stream->line[stream->line_index++] = byte;
+    // the data prompt of AT+QISEND is not followed by a new line
+    if ((byte == '>') || (stream->line_index >= IN_BUFFER_SIZE - 1)) {
+      stream_flush_line(stream);
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Stores the next received bytes in a buffer, bypassing the line parser.
+ *****************************************************************************/
+void at_stream_receive_raw(at_stream_t *stream,
+                           uint8_t *buffer,
+                           uint16_t length)
+{
+  stream->raw_ptr = buffer;
+  stream->raw_remaining = (buffer != NULL) ? length : 0;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Starts the transmission of a buffer.
+ *****************************************************************************/
+void at_stream_transmit(at_stream_t *stream,
+                        const volatile uint8_t *data,
+                        uint16_t length)
+{
+  stream->tx_ptr = data;
+  stream->tx_remaining = length;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the next byte to transmit.
+ *****************************************************************************/
+bool at_stream_transmit_byte(at_stream_t *stream, uint8_t *byte)
+{
+  if (stream->tx_remaining == 0) {
+    return false;
+  }
+  *byte = *stream->tx_ptr++;
+  stream->tx_remaining--;
+  return true;
+}
@@ -52,8 +52,11 @@
 sl_status_t gnss_start(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_qgps = { "AT+QGPS=1", at_ok_error_cb,
-  AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_qgps = {
+    .cms_string = "AT+QGPS=1",
+    .ln_cb = at_ok_error_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_qgps));
   validate(cmd_status, at_parser_start_scheduler(output_object));
@@ -75,8 +78,11 @@ sl_status_t gnss_start(at_scheduler_status_t *output_object)
 sl_status_t gnss_get_position(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_gpsloc = { "AT+QGPSLOC?", at_gpsloc_cb,
-  AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_gpsloc = {
+    .cms_string = "AT+QGPSLOC?",
+    .ln_cb = at_gpsloc_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_gpsloc));
   validate(cmd_status, at_parser_start_scheduler(output_object));
@@ -98,8 +104,11 @@ sl_status_t gnss_get_position(at_scheduler_status_t *output_object)
 sl_status_t gnss_stop(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_imei = { "AT+QGPSEND", at_ok_error_cb,
-  AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_imei = {
+    .cms_string = "AT+QGPSEND",
+    .ln_cb = at_ok_error_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_imei));
   validate(cmd_status, at_parser_start_scheduler(output_object));
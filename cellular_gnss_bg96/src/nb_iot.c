@@ -38,8 +38,55 @@
 #include "bg96_driver.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "at_parser_utility.h"
 
+#define has_substring(container, substr) \
+  (NULL != strstr((const char*) container, (const char*) substr))
+
+static void socket_data_cb(uint8_t *new_line, uint8_t call_number);
+static void socket_read_cb(uint8_t *new_line, uint8_t call_number);
+
+// Socket transfer in progress, the line callbacks run in interrupt context
+static struct {
+  uint8_t socket;
+  const uint8_t *data;      // first byte not queued yet
+  size_t remaining;         // bytes not queued yet
+} send_ctx;
+
+static struct {
+  uint8_t *buffer;
+  uint16_t size;
+  uint16_t *received;
+} read_ctx;
+
+static at_cmd_desc_t at_socket_qisend = {
+  .cms_string = "",
+  .ln_cb = at_prompt_cb,
+  .timeout_ms = AT_DEFAULT_TIMEOUT
+};
+static at_cmd_desc_t at_socket_data = {
+  .cms_string = "",
+  .ln_cb = socket_data_cb,
+  .timeout_ms = AT_SEND_TIMEOUT
+};
+static at_cmd_desc_t at_socket_qird = {
+  .cms_string = "",
+  .ln_cb = socket_read_cb,
+  .timeout_ms = AT_DEFAULT_TIMEOUT
+};
+
+// Status queries sent in one command line
+static at_query_t status_queries[] = { { "+CSQ", "+CSQ:", "", false },
+                                       { "+CEREG?", "+CEREG:", "", false },
+                                       { "+CGATT?", "+CGATT:", "", false }, };
+static at_cmd_desc_t at_status = {
+  .cms_string = "",
+  .ln_cb = at_query_cb,
+  .timeout_ms = AT_DEFAULT_TIMEOUT,
+  .retries = 1
+};
+
 /**************************************************************************//**
  * @brief
  *    BG96 NB IoT initialization.
@@ -72,9 +119,16 @@ sl_status_t bg96_nb_open_connection(bg96_nb_connection_t *connection,
   //format example: "AT+QIOPEN=1,0,\"TCP\",\"cloudsocket.hologram.io\",9999,0,1"
   uint8_t conn_string[50];
   uint8_t base_cmd[] = "AT+QIOPEN=1,";
-  static at_cmd_desc_t at_open = { "", at_open_cb, AT_OPEN_TIMEOUT };
-  static at_cmd_desc_t at_qstate = { "AT+QISTATE=0,1", at_qistate_cb,
-  AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_open = {
+    .cms_string = "",
+    .ln_cb = at_open_cb,
+    .timeout_ms = AT_OPEN_TIMEOUT
+  };
+  static at_cmd_desc_t at_qstate = {
+    .cms_string = "AT+QISTATE=0,1",
+    .ln_cb = at_qistate_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   at_parser_clear_cmd(&at_open);
   validate(cmd_status, at_parser_extend_cmd(&at_open, base_cmd));
@@ -121,7 +175,11 @@ sl_status_t bg96_nb_close_connection(bg96_nb_connection_t *connection,
   sl_status_t cmd_status = SL_STATUS_OK;
   uint8_t conn_string[5];
   uint8_t base_cmd[] = "AT+QICLOSE=";
-  static at_cmd_desc_t at_close = { "", at_ok_error_cb, AT_OPEN_TIMEOUT };
+  static at_cmd_desc_t at_close = {
+    .cms_string = "",
+    .ln_cb = at_ok_error_cb,
+    .timeout_ms = AT_OPEN_TIMEOUT
+  };
 
   sprintf((char*) conn_string, "%d", (int) connection->socket);
 
@@ -158,8 +216,16 @@ sl_status_t bg96_nb_send_data(bg96_nb_connection_t *connection,
   sl_status_t cmd_status = SL_STATUS_OK;
   uint8_t data_l_string[10];
   uint8_t base_cmd[] = "AT+QISEND=";
-  static at_cmd_desc_t at_qisend = { "", at_send_cb, AT_DEFAULT_TIMEOUT };
-  static at_cmd_desc_t at_data = { "", at_data_cb, AT_SEND_TIMEOUT };
+  static at_cmd_desc_t at_qisend = {
+    .cms_string = "",
+    .ln_cb = at_send_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
+  static at_cmd_desc_t at_data = {
+    .cms_string = "",
+    .ln_cb = at_data_cb,
+    .timeout_ms = AT_SEND_TIMEOUT
+  };
 
   at_parser_clear_cmd(&at_qisend);
   at_parser_clear_cmd(&at_data);
@@ -193,8 +259,11 @@ sl_status_t bg96_nb_send_data(bg96_nb_connection_t *connection,
 sl_status_t bg96_nb_receive_data(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_qird = { "AT+QIRD=11,100", at_recv_cb,
-  AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_qird = {
+    .cms_string = "AT+QIRD=11,100",
+    .ln_cb = at_recv_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_qird));
   validate(cmd_status, at_parser_start_scheduler(output_object));
@@ -217,58 +286,60 @@ sl_status_t bg96_nb_receive_data(at_scheduler_status_t *output_object)
 sl_status_t bg96_network_registration(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_cmds[] = { { "AT+CFUN=0", at_ok_error_cb,
-  AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"nbsibscramble\",0",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"nwscanmode\",0,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"roamservice\",2,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"nwscanseq\",020103,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"band\",0,0,80,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"iotopmode\",1,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QCFG=\"servicedomain\",1,1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+CGDCONT=1,\"IP\",\"hologram\"",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     { "AT+CFUN=1", at_ok_error_cb,
-                                     AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+COPS?",
-                                       at_cops_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+CREG=1;+CGREG=1;+CEREG=1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+COPS=0",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT },
-                                     {
-                                       "AT+QICSGP=1,1,\"hologram\",\"\",\"\",1",
-                                       at_ok_error_cb,
-                                       AT_DEFAULT_TIMEOUT }, };
+  // configuration commands answering OK only are combined, so that they
+  // take one round trip per line
+  static at_cmd_desc_t at_cmds[] = {
+    {
+      .cms_string = "AT+CFUN=0",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+QCFG=\"nbsibscramble\",0;"
+                    "+QCFG=\"nwscanmode\",0,1;"
+                    "+QCFG=\"roamservice\",2,1",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+QCFG=\"nwscanseq\",020103,1;"
+                    "+QCFG=\"band\",0,0,80,1;"
+                    "+QCFG=\"iotopmode\",1,1",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+QCFG=\"servicedomain\",1,1;"
+                    "+CGDCONT=1,\"IP\",\"hologram\"",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+CFUN=1",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+COPS?",
+      .ln_cb = at_cops_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+CREG=1;+CGREG=1;+CEREG=1",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+COPS=0",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+    {
+      .cms_string = "AT+QICSGP=1,1,\"hologram\",\"\",\"\",1",
+      .ln_cb = at_ok_error_cb,
+      .timeout_ms = AT_DEFAULT_TIMEOUT
+    },
+  };
 
   uint8_t at_cmd_size = sizeof(at_cmds) / sizeof(at_cmd_desc_t);
   uint8_t i;
@@ -295,7 +366,11 @@ sl_status_t bg96_network_registration(at_scheduler_status_t *output_object)
 sl_status_t read_ip(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_ip = { "AT+QIACT?", at_ip_cb, AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_ip = {
+    .cms_string = "AT+QIACT?",
+    .ln_cb = at_ip_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_ip));
   validate(cmd_status, at_parser_start_scheduler(output_object));
@@ -316,7 +391,11 @@ sl_status_t read_ip(at_scheduler_status_t *output_object)
 sl_status_t bg96_get_operator(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_cops = { "AT+COPS?", at_cops_cb, AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_cops = {
+    .cms_string = "AT+COPS?",
+    .ln_cb = at_cops_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_cops));
   validate(cmd_status, at_parser_start_scheduler(output_object));
@@ -337,9 +416,299 @@ sl_status_t bg96_get_operator(at_scheduler_status_t *output_object)
 sl_status_t read_imei(at_scheduler_status_t *output_object)
 {
   sl_status_t cmd_status = SL_STATUS_OK;
-  static at_cmd_desc_t at_imei = { "AT+GSN", at_imei_cb, AT_DEFAULT_TIMEOUT };
+  static at_cmd_desc_t at_imei = {
+    .cms_string = "AT+GSN",
+    .ln_cb = at_imei_cb,
+    .timeout_ms = AT_DEFAULT_TIMEOUT
+  };
 
   validate(cmd_status, at_parser_add_cmd_to_q(&at_imei));
   validate(cmd_status, at_parser_start_scheduler(output_object));
   return cmd_status;
 }
+
+/**************************************************************************//**
+ * @brief
+ *    Queues AT+QISEND and the binary data of the next chunk.
+ *
+ * @return
+ *    SL_STATUS_OK if the commands are added to the command queue.
+ *    SL_STATUS_ALLOCATION_FAILED if the command queue is full.
+ *****************************************************************************/
+static sl_status_t socket_queue_chunk(void)
+{
+  sl_status_t cmd_status = SL_STATUS_OK;
+  uint8_t data_l_string[10];
+  uint8_t base_cmd[] = "AT+QISEND=";
+  uint16_t chunk_length = BG96_SEND_CHUNK_SIZE;
+
+  if (send_ctx.remaining < chunk_length) {
+    chunk_length = (uint16_t) send_ctx.remaining;
+  }
+  sprintf((char*) data_l_string, "%d,%d", (int) send_ctx.socket,
+      (int) chunk_length);
+
+  at_parser_clear_cmd(&at_socket_qisend);
+  validate(cmd_status, at_parser_extend_cmd(&at_socket_qisend, base_cmd));
+  validate(cmd_status,
+      at_parser_extend_cmd(&at_socket_qisend, data_l_string));
+  at_socket_data.data = send_ctx.data;
+  at_socket_data.data_length = chunk_length;
+  send_ctx.data += chunk_length;
+  send_ctx.remaining -= chunk_length;
+
+  validate(cmd_status, at_parser_add_cmd_to_q(&at_socket_qisend));
+  validate(cmd_status, at_parser_add_cmd_to_q(&at_socket_data));
+  return cmd_status;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Line callback of a binary data chunk.
+ *    Waits for SEND OK and queues the next chunk until all data is sent.
+ *    Lines before the result are the echo of the data.
+ *****************************************************************************/
+static void socket_data_cb(uint8_t *new_line, uint8_t call_number)
+{
+  (void) call_number;
+  if (has_substring(new_line, "SEND OK")) {
+    if ((send_ctx.remaining == 0) || (SL_STATUS_OK == socket_queue_chunk())) {
+      at_parser_scheduler_next_cmd();
+    } else {
+      at_parser_scheduler_error(SL_STATUS_ALLOCATION_FAILED);
+    }
+  } else if (has_substring(new_line, "SEND FAIL")
+             || has_substring(new_line, "ERROR")) {
+    // SEND FAIL means the send buffer of the module is full
+    at_parser_report_data(new_line);
+    at_parser_scheduler_error(SL_STATUS_FAIL);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Line callback of AT+QIRD.
+ *    Switches the receiver to raw mode for the announced number of bytes,
+ *    so that the data is stored in the caller buffer as is.
+ *****************************************************************************/
+static void socket_read_cb(uint8_t *new_line, uint8_t call_number)
+{
+  uint8_t *colon;
+  uint32_t length;
+
+  (void) call_number;
+  if (has_substring(new_line, "+QIRD:")) {
+    colon = (uint8_t*) strchr((const char*) new_line, ':');
+    length = (uint32_t) strtol((const char*) (colon + 1), NULL, 10);
+    if (length > read_ctx.size) {
+      at_parser_report_data(new_line);
+      at_parser_scheduler_error(SL_STATUS_WOULD_OVERFLOW);
+    } else {
+      *read_ctx.received = (uint16_t) length;
+      if (length > 0) {
+        at_platform_receive_raw(read_ctx.buffer, (uint16_t) length);
+      }
+    }
+  } else if (has_substring(new_line, "OK")) {
+    at_parser_scheduler_next_cmd();
+  } else if (has_substring(new_line, "ERROR")) {
+    at_parser_report_data(new_line);
+    at_parser_scheduler_error(SL_STATUS_FAIL);
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT send binary data on a socket.
+ *    The data is sent in chunks of BG96_SEND_CHUNK_SIZE bytes,
+ *    each with AT+QISEND=<socket>,<length>, the ">" prompt and SEND OK.
+ *
+ * @param[in] connection
+ *    Pointer to the connection descriptor structure.
+ *
+ * @param[in] data
+ *    Pointer to the data to send, SHALL be allocated until the scheduler
+ *    finishes.
+ *
+ * @param[in] length
+ *    Number of bytes to send.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_INVALID_PARAMETER if there is no data to send.
+ *    SL_STATUS_BUSY if scheduler is busy.
+ *    SL_STATUS_ALLOCATION_FAILED if command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_socket_send(bg96_nb_connection_t *connection,
+                                const uint8_t *data,
+                                size_t length,
+                                at_scheduler_status_t *output_object)
+{
+  sl_status_t cmd_status = SL_STATUS_OK;
+
+  if ((data == NULL) || (length == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  // the descriptors of the socket transfers are shared
+  if (SCH_READY != at_parser_get_scheduler_state()) {
+    return SL_STATUS_BUSY;
+  }
+
+  send_ctx.socket = connection->socket;
+  send_ctx.data = data;
+  send_ctx.remaining = length;
+  validate(cmd_status, socket_queue_chunk());
+  validate(cmd_status, at_parser_start_scheduler(output_object));
+  return cmd_status;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT receive binary data from a socket.
+ *    Data read with AT+QIRD is stored in the buffer directly, without
+ *    passing through the line parser.
+ *
+ * @param[in] connection
+ *    Pointer to the connection descriptor structure.
+ *
+ * @param[out] buffer
+ *    Buffer for the data, SHALL be allocated until the scheduler finishes.
+ *
+ * @param[in] size
+ *    Size of the buffer, at most BG96_RECV_MAX_LENGTH bytes are read.
+ *
+ * @param[out] received
+ *    Number of bytes received, valid when the scheduler finishes.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_INVALID_PARAMETER if there is no buffer.
+ *    SL_STATUS_BUSY if scheduler is busy.
+ *    SL_STATUS_ALLOCATION_FAILED if command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_socket_receive(bg96_nb_connection_t *connection,
+                                   uint8_t *buffer,
+                                   uint16_t size,
+                                   uint16_t *received,
+                                   at_scheduler_status_t *output_object)
+{
+  sl_status_t cmd_status = SL_STATUS_OK;
+  uint8_t data_l_string[10];
+  uint8_t base_cmd[] = "AT+QIRD=";
+
+  if ((buffer == NULL) || (size == 0) || (received == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (SCH_READY != at_parser_get_scheduler_state()) {
+    return SL_STATUS_BUSY;
+  }
+  if (size > BG96_RECV_MAX_LENGTH) {
+    size = BG96_RECV_MAX_LENGTH;
+  }
+
+  read_ctx.buffer = buffer;
+  read_ctx.size = size;
+  read_ctx.received = received;
+  *received = 0;
+
+  sprintf((char*) data_l_string, "%d,%d", (int) connection->socket,
+      (int) size);
+  at_parser_clear_cmd(&at_socket_qird);
+  validate(cmd_status, at_parser_extend_cmd(&at_socket_qird, base_cmd));
+  validate(cmd_status, at_parser_extend_cmd(&at_socket_qird, data_l_string));
+  validate(cmd_status, at_parser_add_cmd_to_q(&at_socket_qird));
+  validate(cmd_status, at_parser_start_scheduler(output_object));
+  return cmd_status;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT poll the signal quality, EPS registration and attach state.
+ *    The queries are sent in one command line and resent once on timeout.
+ *
+ * @param[out] output_object
+ *    Pointer to the output object which contains the command status and
+ *    output data.
+ *
+ * @return
+ *    SL_STATUS_OK if command successfully added to the command queue.
+ *    SL_STATUS_FAIL if scheduler is busy or command queue is full.
+ *****************************************************************************/
+sl_status_t bg96_nb_poll_status(at_scheduler_status_t *output_object)
+{
+  sl_status_t cmd_status = SL_STATUS_OK;
+
+  if (SCH_READY != at_parser_get_scheduler_state()) {
+    return SL_STATUS_BUSY;
+  }
+  validate(cmd_status, at_parser_add_query_batch(&at_status, status_queries,
+      sizeof(status_queries) / sizeof(status_queries[0])));
+  validate(cmd_status, at_parser_start_scheduler(output_object));
+  return cmd_status;
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the integer parameter of a query response.
+ *
+ * @param[in] query
+ *    Query with the response line.
+ *
+ * @param[in] index
+ *    Index of the parameter after the colon.
+ *
+ * @return
+ *    Parameter value, -1 if the query is not answered.
+ *****************************************************************************/
+static long query_get_param(const at_query_t *query, uint8_t index)
+{
+  const char *param;
+
+  if (!query->matched) {
+    return -1;
+  }
+  param = strchr((const char*) query->response, ':');
+  while ((param != NULL) && (index-- > 0)) {
+    param = strchr(param + 1, ',');
+  }
+  if (param == NULL) {
+    return -1;
+  }
+  return strtol(param + 1, NULL, 10);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    BG96 NB IoT get the result of the last status poll.
+ *
+ * @param[out] status
+ *    Signal quality, registration and attach state.
+ *
+ * @return
+ *    SL_STATUS_OK if every query was answered.
+ *    SL_STATUS_NOT_FOUND if a response is missing.
+ *****************************************************************************/
+sl_status_t bg96_nb_get_status(bg96_nb_status_t *status)
+{
+  long rssi = query_get_param(&status_queries[0], 0);
+  long ber = query_get_param(&status_queries[0], 1);
+  long reg_status = query_get_param(&status_queries[1], 1);
+  long attached = query_get_param(&status_queries[2], 0);
+
+  if ((rssi < 0) || (ber < 0) || (reg_status < 0) || (attached < 0)) {
+    return SL_STATUS_NOT_FOUND;
+  }
+  status->rssi = (uint8_t) rssi;
+  status->ber = (uint8_t) ber;
+  status->reg_status = (uint8_t) reg_status;
+  status->attached = (attached == 1);
+  return SL_STATUS_OK;
+}
@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ * @file at_parser_scheduler_test.c
+ * @brief Host test of the AT parser scheduler and the event dispatcher.
+ *
+ * Runs the query batches, command retries, URC subscribers and event
+ * listeners on the BG96 UART simulator, and counts the command lines of the
+ * network registration and status polling.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -Ihost -I../inc -I<gsdk>/platform/common/inc
+ *       at_parser_scheduler_test.c host/bg96_sim.c ../src/nb_iot.c
+ *       ../src/at_parser_core.c ../src/at_parser_events.c
+ *       ../src/at_parser_stream.c
+ *   ./a.out
+ *******************************************************************************
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "nb_iot.h"
+#include "at_parser_core.h"
+#include "at_parser_events.h"
+#include "bg96_sim.h"
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+typedef struct {
+  int calls;
+  char last[IN_BUFFER_SIZE];
+} urc_log_t;
+
+static urc_log_t cereg_log_a;
+static urc_log_t cereg_log_b;
+static urc_log_t qiurc_log;
+static int done_calls[3];
+
+static void urc_handler(uint8_t *line, void *handler_data)
+{
+  urc_log_t *log = (urc_log_t*) handler_data;
+  log->calls++;
+  strcpy(log->last, (const char*) line);
+}
+
+static void done_handler(void *handler_data)
+{
+  (*(int*) handler_data)++;
+}
+
+static void set_status_replies(void)
+{
+  bg96_sim_set_reply("+CSQ", "+CSQ: 21,99");
+  bg96_sim_set_reply("+CEREG?", "+CEREG: 2,5");
+  bg96_sim_set_reply("+CGATT?", "+CGATT: 1");
+}
+
+int main(void)
+{
+  int failed = 0;
+  at_scheduler_status_t output_object;
+  bg96_nb_status_t status;
+
+  bg96_nb_init();
+
+  // Network registration, configuration commands combined
+  bg96_sim_reset();
+  bg96_sim_set_reply("+COPS?", "+COPS: 0");
+  CHECK(SL_STATUS_OK == bg96_network_registration(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(bg96_sim.command_lines == 9);
+  printf("network registration: %d command lines\n",
+         (int) bg96_sim.command_lines);
+
+  // Status poll, three queries in one round trip
+  bg96_sim_reset();
+  bg96_sim.echo = true;
+  set_status_replies();
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(bg96_sim.command_lines == 1);
+  CHECK(SL_STATUS_OK == bg96_nb_get_status(&status));
+  CHECK(status.rssi == 21);
+  CHECK(status.ber == 99);
+  CHECK(status.reg_status == 5);
+  CHECK(status.attached);
+
+  // Missing response
+  bg96_sim_reset();
+  bg96_sim_set_reply("+CSQ", "+CSQ: 21,99");
+  bg96_sim_set_reply("+CGATT?", "+CGATT: 0");
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(SL_STATUS_NOT_FOUND == bg96_nb_get_status(&status));
+
+  // Query answered with ERROR
+  bg96_sim_reset();
+  set_status_replies();
+  bg96_sim.error_command = "+CGATT?";
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == SL_STATUS_FAIL);
+  CHECK(!strcmp((const char*) output_object.response_data, "ERROR"));
+
+  // Lost command line, resent once
+  bg96_sim_reset();
+  set_status_replies();
+  bg96_sim.drop_lines = 1;
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(bg96_sim.command_lines == 2);
+  CHECK(SL_STATUS_OK == bg96_nb_get_status(&status));
+
+  // Lost twice, the retry is used up
+  bg96_sim_reset();
+  set_status_replies();
+  bg96_sim.drop_lines = 2;
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == SL_STATUS_TIMEOUT);
+  CHECK(bg96_sim.command_lines == 2);
+
+  // URC subscribers, two on +CEREG: and one on +QIURC:
+  CHECK(SL_STATUS_OK == at_urc_subscribe("+CEREG:", urc_handler,
+                                         &cereg_log_a));
+  CHECK(SL_STATUS_OK == at_urc_subscribe("+CEREG:", urc_handler,
+                                         &cereg_log_b));
+  CHECK(SL_STATUS_OK == at_urc_subscribe("+QIURC:", urc_handler,
+                                         &qiurc_log));
+  bg96_sim_reset();
+  set_status_replies();
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  // URCs before and within the responses of the poll
+  bg96_sim_urc("+QIURC: \"recv\",0");
+  bg96_sim_step();
+  bg96_sim_urc("+CEREG: 1");
+  bg96_sim_run();
+  at_event_process();
+  CHECK(output_object.error_code == 0);
+  CHECK(SL_STATUS_OK == bg96_nb_get_status(&status));
+  // the +CEREG: response of the query is not taken by the subscribers
+  CHECK(status.reg_status == 5);
+  CHECK((cereg_log_a.calls == 1) && (cereg_log_b.calls == 1));
+  CHECK(!strcmp(cereg_log_a.last, "+CEREG: 1"));
+  CHECK(qiurc_log.calls == 1);
+  CHECK(!strcmp(qiurc_log.last, "+QIURC: \"recv\",0"));
+
+  // URC while no command runs
+  bg96_sim_urc("+QIURC: \"closed\",0");
+  bg96_sim_step();
+  at_event_process();
+  CHECK(qiurc_log.calls == 2);
+  CHECK(!strcmp(qiurc_log.last, "+QIURC: \"closed\",0"));
+
+  at_urc_unsubscribe("+CEREG:", urc_handler);
+  bg96_sim_urc("+CEREG: 5");
+  bg96_sim_step();
+  at_event_process();
+  CHECK(cereg_log_a.calls == 1);
+
+  // Several listeners on the same output object
+  at_parser_init_output_object(&output_object);
+  CHECK(SL_STATUS_OK == at_listen_event((uint8_t*) &output_object.status,
+                                        SL_STATUS_OK, done_handler,
+                                        &done_calls[0]));
+  CHECK(SL_STATUS_OK == at_listen_event((uint8_t*) &output_object.status,
+                                        SL_STATUS_OK, done_handler,
+                                        &done_calls[1]));
+  CHECK(SL_STATUS_OK == at_listen_event_type((uint8_t*) &output_object.status,
+                                             SL_STATUS_OK, done_handler,
+                                             &done_calls[2], ALWAYS));
+  at_event_process();
+  CHECK(done_calls[0] == 0);
+  bg96_sim_reset();
+  set_status_replies();
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  at_event_process();
+  bg96_sim_run();
+  at_event_process();
+  at_event_process();
+  CHECK((done_calls[0] == 1) && (done_calls[1] == 1) && (done_calls[2] == 1));
+  CHECK(SL_STATUS_OK == bg96_nb_poll_status(&output_object));
+  at_event_process();
+  bg96_sim_run();
+  at_event_process();
+  CHECK((done_calls[0] == 1) && (done_calls[1] == 1) && (done_calls[2] == 2));
+  at_remove_event_listener(done_handler, &done_calls[2]);
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
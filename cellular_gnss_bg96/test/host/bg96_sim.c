@@ -0,0 +1,304 @@
+/***************************************************************************//**
+ * @file bg96_sim.c
+ * @brief Host UART simulator of the BG96 module for the AT parser tests.
+ *
+ * Replaces the USART platform driver: bytes written by the parser are fed to
+ * a model of the module, and its responses are fed to the byte stream
+ * handling byte by byte, as the receive interrupt does.
+ *******************************************************************************
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "bg96_sim.h"
+#include "at_parser_core.h"
+#include "at_parser_events.h"
+#include "at_parser_stream.h"
+#include "nb_iot.h"
+
+bg96_sim_t bg96_sim;
+
+static at_stream_t stream;
+static ln_cb_t platform_cb;
+static bool rx_enabled;
+static bool transmitting;
+static uint8_t output_buffer[OUT_BUFFER_SIZE];
+
+/*******************************************************************************
+ ****************************   MODULE MODEL   ********************************
+ ******************************************************************************/
+static void sim_output(const void *data, uint16_t length)
+{
+  memcpy(&bg96_sim.out[bg96_sim.out_tail], data, length);
+  bg96_sim.out_tail += length;
+}
+
+static void sim_output_string(const char *str)
+{
+  sim_output(str, (uint16_t) strlen(str));
+}
+
+// Handles one command of a command line, returns false on ERROR
+static bool sim_subcommand(const char *cmd)
+{
+  int socket, length;
+  char header[32];
+  uint8_t i;
+
+  if ((bg96_sim.error_command != NULL)
+      && !strcmp(cmd, bg96_sim.error_command)) {
+    sim_output_string("\r\nERROR\r\n");
+    return false;
+  }
+  if (sscanf(cmd, "+QISEND=%d,%d", &socket, &length) == 2) {
+    if ((length <= 0) || (length > (int) BG96_SEND_CHUNK_SIZE)) {
+      sim_output_string("\r\nERROR\r\n");
+      return false;
+    }
+    bg96_sim.qisend_count++;
+    if (length > bg96_sim.max_chunk) {
+      bg96_sim.max_chunk = (uint16_t) length;
+    }
+    bg96_sim.data_expected = (uint16_t) length;
+    sim_output_string("\r\n> ");
+    return false;
+  }
+  if (sscanf(cmd, "+QIRD=%d,%d", &socket, &length) == 2) {
+    if (length > bg96_sim.unread_length) {
+      length = bg96_sim.unread_length;
+    }
+    sprintf(header, "\r\n+QIRD: %d\r\n", length);
+    sim_output_string(header);
+    if (length > 0) {
+      sim_output(bg96_sim.unread, (uint16_t) length);
+      sim_output_string("\r\n");
+      bg96_sim.unread_length -= (uint16_t) length;
+      memmove(bg96_sim.unread, &bg96_sim.unread[length],
+              bg96_sim.unread_length);
+    }
+    return true;
+  }
+  for (i = 0; i < BG96_SIM_MAX_REPLIES; i++) {
+    if ((bg96_sim.replies[i].command != NULL)
+        && !strcmp(cmd, bg96_sim.replies[i].command)) {
+      sim_output_string("\r\n");
+      sim_output_string(bg96_sim.replies[i].response);
+      sim_output_string("\r\n");
+    }
+  }
+  return true;
+}
+
+static void sim_command_line(void)
+{
+  char *cmd;
+  char *next;
+  bool ok = true;
+
+  bg96_sim.line[bg96_sim.line_index] = 0;
+  bg96_sim.command_lines++;
+  if (bg96_sim.drop_lines > 0) {
+    bg96_sim.drop_lines--;
+    return;
+  }
+  if (bg96_sim.echo) {
+    sim_output(bg96_sim.line, bg96_sim.line_index);
+    sim_output_string("\r\n");
+  }
+  if (strncmp((const char*) bg96_sim.line, "AT", 2)) {
+    return;
+  }
+  // commands of a line are separated by ";", the result code is sent once
+  cmd = (char*) &bg96_sim.line[2];
+  while (ok && (cmd != NULL)) {
+    next = strchr(cmd, ';');
+    if (next != NULL) {
+      *next++ = 0;
+    }
+    ok = sim_subcommand(cmd);
+    cmd = next;
+  }
+  if (ok) {
+    sim_output_string("\r\nOK\r\n");
+  }
+}
+
+static void sim_receive(uint8_t byte)
+{
+  if (bg96_sim.silent) {
+    return;
+  }
+  if (bg96_sim.data_expected > 0) {
+    bg96_sim.sent[bg96_sim.sent_length++] = byte;
+    if (bg96_sim.echo) {
+      sim_output(&byte, 1);
+    }
+    if (--bg96_sim.data_expected == 0) {
+      sim_output_string(bg96_sim.send_fail ? "\r\nSEND FAIL\r\n"
+                        : "\r\nSEND OK\r\n");
+    }
+  } else if (byte == '\n') {
+    sim_command_line();
+    bg96_sim.line_index = 0;
+  } else if (byte != '\r') {
+    bg96_sim.line[bg96_sim.line_index++] = byte;
+  }
+}
+
+void bg96_sim_reset(void)
+{
+  memset(&bg96_sim, 0, sizeof(bg96_sim));
+}
+
+void bg96_sim_set_reply(const char *command, const char *response)
+{
+  uint8_t i;
+
+  for (i = 0; i < BG96_SIM_MAX_REPLIES; i++) {
+    if ((bg96_sim.replies[i].command == NULL)
+        || !strcmp(bg96_sim.replies[i].command, command)) {
+      bg96_sim.replies[i].command = command;
+      bg96_sim.replies[i].response = response;
+      return;
+    }
+  }
+}
+
+void bg96_sim_urc(const char *line)
+{
+  sim_output_string("\r\n");
+  sim_output_string(line);
+  sim_output_string("\r\n");
+}
+
+bool bg96_sim_step(void)
+{
+  bool active = false;
+  uint8_t byte;
+
+  while (transmitting && at_stream_transmit_byte(&stream, &byte)) {
+    sim_receive(byte);
+    active = true;
+  }
+  transmitting = false;
+  while (rx_enabled && (bg96_sim.out_head != bg96_sim.out_tail)) {
+    at_stream_receive_byte(&stream, bg96_sim.out[bg96_sim.out_head++]);
+    active = true;
+  }
+  if (bg96_sim.out_head == bg96_sim.out_tail) {
+    bg96_sim.out_head = 0;
+    bg96_sim.out_tail = 0;
+  }
+  return active;
+}
+
+void bg96_sim_run(void)
+{
+  int guard;
+
+  for (guard = 0; guard < 100000; guard++) {
+    if (SCH_READY == at_parser_get_scheduler_state()) {
+      return;
+    }
+    if (!bg96_sim_step()
+        && (SCH_SENDING == at_parser_get_scheduler_state())) {
+      platform_cb(NULL, 0);
+    }
+    at_parser_process();
+  }
+}
+
+/*******************************************************************************
+ ***********************   PLATFORM DRIVER REPLACEMENT   **********************
+ ******************************************************************************/
+void at_platform_init(ln_cb_t line_callback)
+{
+  platform_cb = line_callback;
+  at_stream_init(&stream, line_callback);
+  rx_enabled = true;
+}
+
+void at_platform_enable_ir(void)
+{
+  rx_enabled = true;
+}
+
+static sl_status_t start_transmit(const volatile uint8_t *data,
+                                  uint16_t length)
+{
+  at_stream_new_command(&stream);
+  at_stream_transmit(&stream, data, length);
+  rx_enabled = true;
+  transmitting = true;
+  return SL_STATUS_OK;
+}
+
+sl_status_t at_platform_send_cmd(volatile uint8_t *cmd,
+                                 volatile uint16_t timeout_ms)
+{
+  size_t cmd_length = strlen((const char*) cmd);
+  (void) timeout_ms;
+  if (cmd_length < OUT_BUFFER_SIZE - 2) {
+    memcpy(output_buffer, (const void*) cmd, cmd_length);
+    output_buffer[cmd_length++] = '\r';
+    output_buffer[cmd_length++] = '\n';
+    return start_transmit(output_buffer, (uint16_t) cmd_length);
+  }
+  return SL_STATUS_ALLOCATION_FAILED;
+}
+
+sl_status_t at_platform_send_raw(const uint8_t *data,
+                                 uint16_t length,
+                                 uint16_t timeout_ms)
+{
+  (void) timeout_ms;
+  if ((data == NULL) || (length == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return start_transmit(data, length);
+}
+
+void at_platform_receive_raw(uint8_t *buffer, uint16_t length)
+{
+  at_stream_receive_raw(&stream, buffer, length);
+}
+
+void at_platform_finish_cmd(void)
+{
+  at_stream_receive_raw(&stream, NULL, 0);
+}
+
+void bg96_init(void)
+{
+  at_parser_init();
+}
@@ -0,0 +1,88 @@
+/***************************************************************************//**
+ * @file bg96_sim.h
+ * @brief Host UART simulator of the BG96 module for the AT parser tests.
+ *******************************************************************************
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef BG96_SIM_H_
+#define BG96_SIM_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "at_parser_platform.h"
+
+#define BG96_SIM_BUFFER_SIZE 8192
+#define BG96_SIM_MAX_REPLIES 8
+
+typedef struct {
+  bool echo;                  // ATE1, commands and data are echoed
+  bool silent;                // no response at all
+  bool send_fail;             // answer SEND FAIL to data
+  uint8_t drop_lines;         // command lines left without response
+  const char *error_command;  // command answered with ERROR
+  struct {
+    const char *command;
+    const char *response;
+  } replies[BG96_SIM_MAX_REPLIES];   // information responses of commands
+  uint8_t line[128];          // command line being received
+  uint16_t line_index;
+  uint16_t data_expected;     // bytes left after the ">" prompt
+  uint8_t out[BG96_SIM_BUFFER_SIZE];  // bytes sent to the host
+  uint16_t out_head;
+  uint16_t out_tail;
+  uint16_t command_lines;     // command lines received (round trips)
+  uint8_t sent[BG96_SIM_BUFFER_SIZE]; // data received on the socket
+  uint16_t sent_length;
+  uint16_t qisend_count;
+  uint16_t max_chunk;
+  uint8_t unread[BG96_SIM_BUFFER_SIZE]; // data waiting for AT+QIRD
+  uint16_t unread_length;
+} bg96_sim_t;
+
+extern bg96_sim_t bg96_sim;
+
+// Resets the module model, the AT parser state is kept
+void bg96_sim_reset(void);
+
+// Sets the information response of a command, e.g. "+CSQ" -> "+CSQ: 21,99"
+void bg96_sim_set_reply(const char *command, const char *response);
+
+// Sends an unsolicited result code line
+void bg96_sim_urc(const char *line);
+
+// Moves the bytes on the wire, returns false if nothing happened
+bool bg96_sim_step(void);
+
+// Runs the main loop until the scheduler finishes, a silent wire times out
+void bg96_sim_run(void);
+
+#endif /* BG96_SIM_H_ */
@@ -0,0 +1,92 @@
+/***************************************************************************//**
+ * @file circular_queue.h
+ * @brief Host replacement of the circular queue used by the AT parser core.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef CIRCULAR_QUEUE_H_
+#define CIRCULAR_QUEUE_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define QUEUE_MAX_SIZE 32
+
+typedef struct {
+  void *data[QUEUE_MAX_SIZE];
+  uint16_t head;
+  uint16_t count;
+  uint16_t size;
+} Queue_t;
+
+static inline void queueInit(Queue_t *queue, uint16_t size)
+{
+  queue->head = 0;
+  queue->count = 0;
+  queue->size = (size < QUEUE_MAX_SIZE) ? size : QUEUE_MAX_SIZE;
+}
+
+static inline bool queueIsEmpty(Queue_t *queue)
+{
+  return queue->count == 0;
+}
+
+static inline bool queueIsFull(Queue_t *queue)
+{
+  return queue->count >= queue->size;
+}
+
+static inline bool queueAdd(Queue_t *queue, void *data)
+{
+  if (queueIsFull(queue)) {
+    return false;
+  }
+  queue->data[(queue->head + queue->count++) % queue->size] = data;
+  return true;
+}
+
+static inline void *queuePeek(Queue_t *queue)
+{
+  return queueIsEmpty(queue) ? NULL : queue->data[queue->head];
+}
+
+static inline void *queueRemove(Queue_t *queue)
+{
+  void *data = queuePeek(queue);
+  if (data != NULL) {
+    queue->head = (queue->head + 1) % queue->size;
+    queue->count--;
+  }
+  return data;
+}
+
+#endif /* CIRCULAR_QUEUE_H_ */
@@ -0,0 +1,177 @@
+/***************************************************************************//**
+ * @file nb_iot_socket_test.c
+ * @brief Host test of the BG96 binary socket transfers.
+ *
+ * Runs the AT parser core, the byte stream handling and the socket functions
+ * of nb_iot.c on the BG96 UART simulator, which models AT+QISEND with the
+ * ">" prompt and AT+QIRD. Payloads contain every byte
+ * value, including \0, \r, \n and ">".
+ *
+ * Build and run on the host:
+ *   gcc -O2 -Ihost -I../inc -I<gsdk>/platform/common/inc
+ *       nb_iot_socket_test.c host/bg96_sim.c ../src/nb_iot.c
+ *       ../src/at_parser_core.c ../src/at_parser_events.c
+ *       ../src/at_parser_stream.c
+ *   ./a.out
+ *******************************************************************************
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "nb_iot.h"
+#include "at_parser_core.h"
+#include "bg96_sim.h"
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static void fill_pattern(uint8_t *data, uint16_t length, uint8_t seed)
+{
+  uint16_t i;
+  for (i = 0; i < length; i++) {
+    data[i] = (uint8_t) (i * 7 + seed);
+  }
+}
+
+int main(void)
+{
+  int failed = 0;
+  static uint8_t payload[4000];
+  static uint8_t buffer[512];
+  uint16_t received;
+  uint16_t i;
+  bg96_nb_connection_t connection = { .socket = 0, .port = 9999,
+                                      .port_type = "TCP", .address = NULL };
+  at_scheduler_status_t output_object;
+
+  bg96_nb_init();
+  fill_pattern(payload, sizeof(payload), 0);
+
+  // Binary send in chunks, echo of commands and data enabled
+  bg96_sim_reset();
+  bg96_sim.echo = true;
+  CHECK(SL_STATUS_OK == bg96_nb_socket_send(&connection, payload,
+                                            sizeof(payload), &output_object));
+  CHECK(SL_STATUS_BUSY == bg96_nb_socket_send(&connection, payload,
+                                              sizeof(payload),
+                                              &output_object));
+  bg96_sim_run();
+  CHECK(output_object.status == SL_STATUS_OK);
+  CHECK(output_object.error_code == 0);
+  CHECK(bg96_sim.qisend_count == 3);
+  CHECK(bg96_sim.max_chunk == BG96_SEND_CHUNK_SIZE);
+  CHECK(bg96_sim.sent_length == sizeof(payload));
+  CHECK(0 == memcmp(bg96_sim.sent, payload, sizeof(payload)));
+
+  // Short send without echo
+  bg96_sim_reset();
+  CHECK(SL_STATUS_OK == bg96_nb_socket_send(&connection, payload, 5,
+                                            &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(bg96_sim.qisend_count == 1);
+  CHECK(bg96_sim.sent_length == 5);
+  CHECK(0 == memcmp(bg96_sim.sent, payload, 5));
+
+  // Module send buffer full
+  bg96_sim_reset();
+  bg96_sim.send_fail = true;
+  CHECK(SL_STATUS_OK == bg96_nb_socket_send(&connection, payload,
+                                            sizeof(payload), &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == SL_STATUS_FAIL);
+  CHECK(NULL != strstr((const char*) output_object.response_data,
+                       "SEND FAIL"));
+  CHECK(bg96_sim.qisend_count == 1);
+
+  // No response
+  bg96_sim_reset();
+  bg96_sim.silent = true;
+  CHECK(SL_STATUS_OK == bg96_nb_socket_send(&connection, payload, 10,
+                                            &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == SL_STATUS_TIMEOUT);
+
+  // Binary receive into the caller buffer, 300 bytes in 256 byte reads
+  bg96_sim_reset();
+  bg96_sim.echo = true;
+  fill_pattern(bg96_sim.unread, 300, 0x3E);
+  bg96_sim.unread_length = 300;
+  CHECK(SL_STATUS_OK == bg96_nb_socket_receive(&connection, buffer, 256,
+                                               &received, &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(received == 256);
+  fill_pattern(payload, 300, 0x3E);
+  CHECK(0 == memcmp(buffer, payload, 256));
+
+  CHECK(SL_STATUS_OK == bg96_nb_socket_receive(&connection, buffer,
+                                               sizeof(buffer), &received,
+                                               &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(received == 44);
+  CHECK(0 == memcmp(buffer, &payload[256], 44));
+
+  CHECK(SL_STATUS_OK == bg96_nb_socket_receive(&connection, buffer,
+                                               sizeof(buffer), &received,
+                                               &output_object));
+  bg96_sim_run();
+  CHECK(output_object.error_code == 0);
+  CHECK(received == 0);
+
+  // Repeated commands, the descriptors must not grow
+  for (i = 0; i < 50; i++) {
+    bg96_sim.unread[0] = (uint8_t) i;
+    bg96_sim.unread_length = 1;
+    CHECK(SL_STATUS_OK == bg96_nb_socket_receive(&connection, buffer, 1,
+                                                 &received, &output_object));
+    bg96_sim_run();
+    CHECK((output_object.error_code == 0) && (received == 1)
+          && (buffer[0] == (uint8_t) i));
+  }
+
+  CHECK(SL_STATUS_INVALID_PARAMETER
+        == bg96_nb_socket_send(&connection, payload, 0, &output_object));
+  CHECK(SL_STATUS_INVALID_PARAMETER
+        == bg96_nb_socket_receive(&connection, NULL, 10, &received,
+                                  &output_object));
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
@@ -88,6 +88,8 @@ extern "C" {
 #include "sl_pwm_letimer.h"
 #include "sl_pwm.h"
 
+#include "dc_motor_TB6549FG_speed.h"
+
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
 // -----------------------------------------------------------------------------
@@ -167,6 +169,63 @@ typedef struct tb6549fg_inst {
     false                                   /* No sleep            */          \
   }
 
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the motor encoder type
+ ******************************************************************************/
+typedef enum {
+  TB6549FG_ENCODER_QUADRATURE,  /**< A/B encoder, decoded in x4 mode         */
+  TB6549FG_ENCODER_TACH,        /**< Single pulse output on B, the direction
+                                     is taken from the driven direction      */
+} tb6549fg_encoder_mode_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the motor encoder counted by a TIMER
+ ******************************************************************************/
+typedef struct tb6549fg_encoder {
+  TIMER_TypeDef *timer;         /**< TIMER counting the encoder      */
+  tb6549fg_encoder_mode_t mode; /**< Encoder type                    */
+  uint8_t A_port;               /**< A (TIMER CC0) GPIO port         */
+  uint8_t A_pin;                /**< A (TIMER CC0) GPIO pin          */
+  uint8_t A_loc;                /**< A (TIMER CC0) GPIO location     */
+  uint8_t B_port;               /**< B (TIMER CC1) GPIO port         */
+  uint8_t B_pin;                /**< B (TIMER CC1) GPIO pin          */
+  uint8_t B_loc;                /**< B (TIMER CC1) GPIO location     */
+} tb6549fg_encoder_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Default init struct for the tb6549fg_encoder_t.
+ ******************************************************************************/
+#define TB6549FG_ENCODER_DEFAULT                                               \
+  {                                                                            \
+    TB6549FG_ENC_TIMER,           /* Encoder TIMER */                          \
+    TB6549FG_ENCODER_QUADRATURE,  /* A/B encoder */                            \
+    TB6549FG_ENC_A_PORT,          /* A port */                                 \
+    TB6549FG_ENC_A_PIN,           /* A pin  */                                 \
+    TB6549FG_ENC_A_LOC,           /* A loc  */                                 \
+    TB6549FG_ENC_B_PORT,          /* B port */                                 \
+    TB6549FG_ENC_B_PIN,           /* B pin  */                                 \
+    TB6549FG_ENC_B_LOC            /* B loc  */                                 \
+  }
+
+/***************************************************************************//**
+ * @brief
+ *    Structure for the closed-loop speed control of a TB6549FG instance. The
+ *    control runs in the overflow interrupt of the PWM TIMER.
+ ******************************************************************************/
+typedef struct tb6549fg_speed_inst {
+  tb6549fg_inst_t *motor;       /**< Driven TB6549FG instance           */
+  tb6549fg_encoder_t encoder;   /**< Encoder config                     */
+  tb6549fg_speed_ctrl_t ctrl;   /**< Speed controller                   */
+  uint32_t divider;             /**< PWM periods per control update     */
+  uint32_t ticks;               /**< PWM periods since the last update  */
+  uint16_t last_count;          /**< Encoder count of the last update   */
+  int8_t direction;             /**< Direction set on IN1 and IN2       */
+  volatile bool running;        /**< Control interrupt enabled          */
+} tb6549fg_speed_inst_t;
+
 /***************************************************************************//**
  * @brief
  *    Symbol used to determine the delay length for transition between
@@ -199,6 +258,18 @@ void tb6549fg_short_break_mode(tb6549fg_inst_t *inst);
 void tb6549fg_stop_mode(tb6549fg_inst_t *inst);
 void tb6549fg_standby_mode(tb6549fg_inst_t *inst);
 uint8_t tb6549fg_get_pwm_duty_cycle(tb6549fg_inst_t *inst);
+sl_status_t tb6549fg_set_pwm_duty(tb6549fg_inst_t *inst,
+                                  uint16_t duty);
+
+sl_status_t tb6549fg_speed_init(tb6549fg_speed_inst_t *speed,
+                                tb6549fg_inst_t *motor,
+                                const tb6549fg_encoder_t *encoder,
+                                const tb6549fg_speed_config_t *config);
+void tb6549fg_speed_set_rpm(tb6549fg_speed_inst_t *speed,
+                            int32_t rpm);
+int32_t tb6549fg_speed_get_rpm(tb6549fg_speed_inst_t *speed);
+void tb6549fg_speed_stop(tb6549fg_speed_inst_t *speed);
+void tb6549fg_speed_irq_handler(tb6549fg_speed_inst_t *speed);
 
 /** @} (end addtogroup DC Motor TB6549FG driver) */
 
@@ -59,6 +59,15 @@ extern "C"
 #define TB6549FG_PWM_PIN    4
 #define TB6549FG_PWM_LOC    0         //0 for compatibility
 
+// Motor encoder for the closed-loop speed control
+#define TB6549FG_ENC_TIMER  TIMER1
+#define TB6549FG_ENC_A_PORT gpioPortA
+#define TB6549FG_ENC_A_PIN  0
+#define TB6549FG_ENC_A_LOC  0         //0 for compatibility
+#define TB6549FG_ENC_B_PORT gpioPortA
+#define TB6549FG_ENC_B_PIN  5
+#define TB6549FG_ENC_B_LOC  0         //0 for compatibility
+
 #ifdef __cplusplus
 }
 #endif
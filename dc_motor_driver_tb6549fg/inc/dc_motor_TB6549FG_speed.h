@@ -0,0 +1,150 @@
+/***************************************************************************//**
+ * @file dc_motor_TB6549FG_speed.h
+ * @brief TB6549FG closed-loop speed controller
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef DC_MOTOR_TB6549FG_SPEED_H_
+#define DC_MOTOR_TB6549FG_SPEED_H_
+
+/***************************************************************************//**
+ * @addtogroup DC Motor TB6549FG driver
+ * @{
+ *
+ * @brief
+ *  Fixed-point PI speed controller of the closed-loop mode. It has no
+ *  hardware dependency: it takes the encoder counts of each control period
+ *  and returns the PWM duty cycle and the direction to drive.
+ *
+ ******************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+/***************************************************************************//**
+ * @brief
+ *    Full scale of the fine PWM duty cycle (0.01 % steps)
+ ******************************************************************************/
+#define TB6549FG_DUTY_MAX 10000
+
+/***************************************************************************//**
+ * @brief
+ *    Speeds are handled in 1/16 RPM internally
+ ******************************************************************************/
+#define TB6549FG_SPEED_FRAC_BITS 4
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the speed controller configuration
+ ******************************************************************************/
+typedef struct tb6549fg_speed_config {
+  uint32_t control_hz;      /**< Rate of the control updates               */
+  uint32_t counts_per_rev;  /**< Encoder counts per shaft revolution        */
+  int32_t kp;               /**< Proportional gain, duty per RPM in Q16     */
+  int32_t ki;               /**< Integral gain, duty per RPM and second
+                                 in Q16                                     */
+  uint32_t accel_rpm_s;     /**< Setpoint ramp in RPM per second            */
+  uint32_t reverse_rpm;     /**< Speed below which the direction may flip   */
+  uint8_t filter_shift;     /**< Speed filter, averages 2^shift updates     */
+} tb6549fg_speed_config_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Default speed controller configuration, tuned for the 639 RPM motor of
+ *    the example with a 12 CPR encoder read in quadrature (x4) on the motor
+ *    shaft and a 1:19 gearbox
+ ******************************************************************************/
+#define TB6549FG_SPEED_CONFIG_DEFAULT                                          \
+  {                                                                            \
+    1000,                 /* 1 kHz control rate */                             \
+    12 * 4 * 19,          /* Counts per output shaft revolution */             \
+    1310720,              /* kp = 20 duty per RPM */                           \
+    52428800,             /* ki = 800 duty per RPM and second */               \
+    1000,                 /* 1000 RPM/s ramp */                                \
+    10,                   /* Reverse below 10 RPM */                           \
+    3                     /* Average 8 updates */                              \
+  }
+
+/***************************************************************************//**
+ * @brief
+ *    Typedef for the speed controller state
+ ******************************************************************************/
+typedef struct tb6549fg_speed_ctrl {
+  tb6549fg_speed_config_t config;   /**< Configuration                       */
+  int64_t count_scale;      /**< Speed of one count per update, Q16        */
+  int32_t ramp;             /**< Setpoint change per update                */
+  int32_t reverse;          /**< Reverse threshold                         */
+  volatile int32_t target;  /**< Requested speed, signed, CW positive      */
+  int32_t setpoint;         /**< Ramped speed setpoint                     */
+  int32_t speed;            /**< Filtered measured speed                   */
+  int32_t integrator;       /**< Integral term, duty in Q16                */
+  int32_t duty;             /**< Duty cycle of the last update             */
+  int8_t direction;         /**< Driven direction, 1 CW, -1 CCW, 0 none    */
+  uint32_t reversals;       /**< Direction changes                         */
+} tb6549fg_speed_ctrl_t;
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+void tb6549fg_speed_ctrl_init(tb6549fg_speed_ctrl_t *ctrl,
+                              const tb6549fg_speed_config_t *config);
+void tb6549fg_speed_ctrl_set_target(tb6549fg_speed_ctrl_t *ctrl,
+                                    int32_t rpm);
+int32_t tb6549fg_speed_ctrl_get_speed(const tb6549fg_speed_ctrl_t *ctrl);
+uint16_t tb6549fg_speed_ctrl_update(tb6549fg_speed_ctrl_t *ctrl,
+                                    int32_t counts);
+
+/** @} (end addtogroup DC Motor TB6549FG driver) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DC_MOTOR_TB6549FG_SPEED_H_ */
@@ -44,6 +44,7 @@
 
 #include "em_gpio.h"
 #include "em_cmu.h"
+#include "em_timer.h"
 
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
@@ -56,6 +57,9 @@ static CMU_Clock_TypeDef get_timer_clock(TIMER_TypeDef *timer);
 static CMU_Clock_TypeDef get_letimer_clock(LETIMER_TypeDef *timer);
 static void tb6549fg_standby_transition(tb6549fg_inst_t *inst);
 static sl_status_t verify_pwm_frequency(tb6549fg_inst_t *inst);
+static IRQn_Type get_timer_irq(TIMER_TypeDef *timer);
+static void tb6549fg_encoder_init(const tb6549fg_encoder_t *encoder);
+static void tb6549fg_set_direction(tb6549fg_inst_t *inst, int8_t direction);
 
 // -----------------------------------------------------------------------------
 //                                Global Variables
@@ -352,6 +356,257 @@ uint8_t tb6549fg_get_pwm_duty_cycle(tb6549fg_inst_t *inst){
   return duty_cycle;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Configure a new duty cycle for the PWM waveform, with a finer resolution
+ *    than tb6549fg_set_pwm_duty_cycle().
+ *
+ * @param[in] inst
+ *    TB6549FG instance.
+ *
+ * @param[in] duty
+ *    Duty cycle in 0.01 % steps, up to TB6549FG_DUTY_MAX. A value of 0 keeps
+ *    the PWM output low, which short brakes the motor.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_PARAMETER if duty is higher than TB6549FG_DUTY_MAX.
+ *    SL_STATUS_INVALID_CONFIGURATION if desired duty cycle would have a high
+ *                                    period lower than 2 us.
+ ******************************************************************************/
+sl_status_t tb6549fg_set_pwm_duty(tb6549fg_inst_t *inst,
+                                  uint16_t duty){
+
+  uint32_t top;
+
+  if (duty > TB6549FG_DUTY_MAX){
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  //Verify that desired duty cycle has a minimum high period of 2 us, in ns
+  if ((duty > 0)
+      && (((uint64_t)duty * 100000) / inst->calc_pwm_frequency < 2000)){
+    return SL_STATUS_INVALID_CONFIGURATION;
+  }
+
+  //Scale to the TIMER/LETIMER resolution
+  if (inst->enable_sleep){
+    top = LETIMER_TopGet(inst->pwm_letimer->timer);
+    LETIMER_CompareSet(inst->pwm_letimer->timer,
+                       inst->pwm_letimer->channel,
+                       (uint32_t)(((uint64_t)top * duty) / TB6549FG_DUTY_MAX));
+  } else {
+    top = TIMER_TopGet(inst->pwm->timer);
+    TIMER_CompareBufSet(inst->pwm->timer,
+                        inst->pwm->channel,
+                        (uint32_t)(((uint64_t)top * duty) / TB6549FG_DUTY_MAX));
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Initializes the closed-loop speed control of a TB6549FG instance.
+ *
+ * @note
+ *    The control updates run in the overflow interrupt of the PWM TIMER, so
+ *    that a new duty cycle is always applied at the start of a PWM period.
+ *    The application calls tb6549fg_speed_irq_handler() from the
+ *    TIMERn_IRQHandler of the PWM TIMER. The LETIMER PWM (enable_sleep) is
+ *    not supported.
+ *
+ * @param[out] speed
+ *    Speed control instance.
+ *
+ * @param[in] motor
+ *    TB6549FG instance, initialized with tb6549fg_init().
+ *
+ * @param[in] encoder
+ *    Encoder config. The TIMER must not be the PWM TIMER.
+ *
+ * @param[in] config
+ *    Speed controller configuration. control_hz is rounded to a whole
+ *    number of PWM periods.
+ *
+ * @return
+ *    SL_STATUS_OK if there are no errors.
+ *    SL_STATUS_INVALID_CONFIGURATION if the motor does not use the TIMER PWM,
+ *                                    or if control_hz is higher than the
+ *                                    PWM frequency.
+ ******************************************************************************/
+sl_status_t tb6549fg_speed_init(tb6549fg_speed_inst_t *speed,
+                                tb6549fg_inst_t *motor,
+                                const tb6549fg_encoder_t *encoder,
+                                const tb6549fg_speed_config_t *config){
+
+  tb6549fg_speed_config_t ctrl_config = *config;
+
+  if (motor->enable_sleep || (encoder->timer == motor->pwm->timer)
+      || (config->control_hz == 0)
+      || (config->control_hz > motor->calc_pwm_frequency)){
+    return SL_STATUS_INVALID_CONFIGURATION;
+  }
+
+  speed->motor = motor;
+  speed->encoder = *encoder;
+  speed->divider = motor->calc_pwm_frequency / config->control_hz;
+  speed->ticks = 0;
+  speed->direction = 0;
+  speed->running = false;
+
+  //Use the actual update rate for the speed calculations
+  ctrl_config.control_hz = motor->calc_pwm_frequency / speed->divider;
+  tb6549fg_speed_ctrl_init(&speed->ctrl, &ctrl_config);
+
+  tb6549fg_encoder_init(encoder);
+  speed->last_count = (uint16_t)TIMER_CounterGet(encoder->timer);
+
+  //The control interrupt is enabled by tb6549fg_speed_set_rpm()
+  TIMER_IntDisable(motor->pwm->timer, TIMER_IEN_OF);
+  TIMER_IntClear(motor->pwm->timer, TIMER_IF_OF);
+  NVIC_ClearPendingIRQ(get_timer_irq(motor->pwm->timer));
+  NVIC_EnableIRQ(get_timer_irq(motor->pwm->timer));
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Sets the speed to regulate to and starts the control.
+ *
+ * @note
+ *    A change of direction is done without going through standby: the motor
+ *    is braked down to standstill first, then ramped up in the new direction.
+ *    A speed of 0 holds the motor in short brake. A motor started with the
+ *    open-loop functions is taken over by the control from a short brake.
+ *    The control is restarted if the motor was left in stop, short brake or
+ *    standby mode by the open-loop functions.
+ *
+ * @param[in] speed
+ *    Speed control instance.
+ *
+ * @param[in] rpm
+ *    Speed in RPM, positive for CW and negative for CCW.
+ ******************************************************************************/
+void tb6549fg_speed_set_rpm(tb6549fg_speed_inst_t *speed,
+                            int32_t rpm){
+
+  tb6549fg_inst_t *motor = speed->motor;
+
+  //The application may have put the motor in stop, short brake or standby
+  //mode directly, the control is then restarted from standstill
+  if (speed->running
+      && (motor->mode != CW_MODE) && (motor->mode != CCW_MODE)){
+    TIMER_IntDisable(motor->pwm->timer, TIMER_IEN_OF);
+    speed->running = false;
+    tb6549fg_speed_ctrl_init(&speed->ctrl, &speed->ctrl.config);
+  }
+
+  tb6549fg_speed_ctrl_set_target(&speed->ctrl, rpm);
+
+  //The motor may be turning from the open-loop functions, the control only
+  //runs once started here
+  if (speed->running){
+    return;
+  }
+
+  //Start from standstill with the PWM output low (short brake)
+  if (motor->mode == STANDBY_MODE){
+    tb6549fg_standby_transition(motor);
+  }
+
+  tb6549fg_set_pwm_duty(motor, 0);
+  speed->direction = 0;
+  tb6549fg_set_direction(motor, (rpm < 0) ? -1 : 1);
+  sl_pwm_start(motor->pwm);
+
+  speed->ticks = 0;
+  speed->last_count = (uint16_t)TIMER_CounterGet(speed->encoder.timer);
+  TIMER_IntClear(motor->pwm->timer, TIMER_IF_OF);
+  speed->running = true;
+  TIMER_IntEnable(motor->pwm->timer, TIMER_IEN_OF);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Gets the measured speed.
+ *
+ * @param[in] speed
+ *    Speed control instance.
+ *
+ * @return
+ *    Filtered speed in RPM, positive for CW.
+ ******************************************************************************/
+int32_t tb6549fg_speed_get_rpm(tb6549fg_speed_inst_t *speed){
+
+  return tb6549fg_speed_ctrl_get_speed(&speed->ctrl);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Stops the control and puts the TB6549FG IC in stop mode.
+ *
+ * @param[in] speed
+ *    Speed control instance.
+ ******************************************************************************/
+void tb6549fg_speed_stop(tb6549fg_speed_inst_t *speed){
+
+  TIMER_IntDisable(speed->motor->pwm->timer, TIMER_IEN_OF);
+  speed->running = false;
+
+  tb6549fg_speed_ctrl_init(&speed->ctrl, &speed->ctrl.config);
+  tb6549fg_stop_mode(speed->motor);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Runs the speed control, to be called from the TIMERn_IRQHandler of the
+ *    PWM TIMER.
+ *
+ * @param[in] speed
+ *    Speed control instance.
+ ******************************************************************************/
+void tb6549fg_speed_irq_handler(tb6549fg_speed_inst_t *speed){
+
+  TIMER_TypeDef *pwm_timer = speed->motor->pwm->timer;
+  uint16_t count;
+  int32_t counts;
+  uint16_t duty;
+
+  if (!(TIMER_IntGet(pwm_timer) & TIMER_IF_OF)){
+    return;
+  }
+  TIMER_IntClear(pwm_timer, TIMER_IF_OF);
+
+  if (++speed->ticks < speed->divider){
+    return;
+  }
+  speed->ticks = 0;
+
+  //Encoder counts since the last update, the counter wraps at its full width
+  count = (uint16_t)TIMER_CounterGet(speed->encoder.timer);
+  counts = (int16_t)(uint16_t)(count - speed->last_count);
+  speed->last_count = count;
+
+  //A tachometer only counts up, in the driven direction
+  if (speed->encoder.mode == TB6549FG_ENCODER_TACH){
+    counts *= speed->ctrl.direction;
+  }
+
+  duty = tb6549fg_speed_ctrl_update(&speed->ctrl, counts);
+
+  if (speed->ctrl.direction != speed->direction){
+    tb6549fg_set_direction(speed->motor, speed->ctrl.direction);
+    speed->direction = speed->ctrl.direction;
+  }
+
+  //Below the minimum high period the output is kept low
+  if (tb6549fg_set_pwm_duty(speed->motor, duty) != SL_STATUS_OK){
+    tb6549fg_set_pwm_duty(speed->motor, 0);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //                          Static Function Definitions
 // -----------------------------------------------------------------------------
@@ -526,3 +781,143 @@ static CMU_Clock_TypeDef get_letimer_clock(LETIMER_TypeDef *timer)
   }
   return timer_clock;
 }
+
+/**************************************************************************//**
+ * @brief
+ *    Configures a TIMER to count the motor encoder
+ *
+ * @param[in] encoder
+ *    Encoder config.
+ *
+ ******************************************************************************/
+static void tb6549fg_encoder_init(const tb6549fg_encoder_t *encoder){
+
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  TIMER_InitCC_TypeDef cc_init = TIMER_INITCC_DEFAULT;
+
+  CMU_ClockEnable(get_timer_clock(encoder->timer), true);
+
+  GPIO_PinModeSet(encoder->B_port, encoder->B_pin, gpioModeInput, 0);
+  if (encoder->mode == TB6549FG_ENCODER_QUADRATURE){
+    GPIO_PinModeSet(encoder->A_port, encoder->A_pin, gpioModeInput, 0);
+  }
+
+  //Quadrature decoding counts every edge of A and B, a tachometer clocks
+  //the TIMER from its CC1 input
+  timer_init.enable = false;
+  if (encoder->mode == TB6549FG_ENCODER_QUADRATURE){
+    timer_init.mode = timerModeQDec;
+    timer_init.quadModeX4 = true;
+  } else {
+    timer_init.clkSel = timerClkSelCC1;
+  }
+  TIMER_Init(encoder->timer, &timer_init);
+
+  //Enable the CC inputs
+  cc_init.mode = timerCCModeCapture;
+  TIMER_InitCC(encoder->timer, 0, &cc_init);
+  TIMER_InitCC(encoder->timer, 1, &cc_init);
+
+#if defined(GPIO_TIMER_ROUTEEN_CC0PEN)
+  GPIO->TIMERROUTE[TIMER_NUM(encoder->timer)].CC0ROUTE =
+    (encoder->A_port << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT)
+    | (encoder->A_pin << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+  GPIO->TIMERROUTE[TIMER_NUM(encoder->timer)].CC1ROUTE =
+    (encoder->B_port << _GPIO_TIMER_CC1ROUTE_PORT_SHIFT)
+    | (encoder->B_pin << _GPIO_TIMER_CC1ROUTE_PIN_SHIFT);
+#else
+  encoder->timer->ROUTELOC0 =
+    ((uint32_t)encoder->A_loc << _TIMER_ROUTELOC0_CC0LOC_SHIFT)
+    | ((uint32_t)encoder->B_loc << _TIMER_ROUTELOC0_CC1LOC_SHIFT);
+  encoder->timer->ROUTEPEN = TIMER_ROUTEPEN_CC0PEN | TIMER_ROUTEPEN_CC1PEN;
+#endif
+
+  //Count over the full TIMER width so that differences wrap correctly
+  TIMER_TopSet(encoder->timer, TIMER_MaxCount(encoder->timer));
+  TIMER_Enable(encoder->timer, true);
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Sets IN1 and IN2 for a direction of the closed-loop control, the PWM
+ *    output sets the duty cycle
+ *
+ * @param[in] inst
+ *    TB6549FG instance.
+ *
+ * @param[in] direction
+ *    1 for CW, -1 for CCW.
+ *
+ ******************************************************************************/
+static void tb6549fg_set_direction(tb6549fg_inst_t *inst, int8_t direction){
+
+  if (direction < 0){
+    GPIO_PinOutSet(inst->gpio.IN1_port,
+                   inst->gpio.IN1_pin);
+
+    GPIO_PinOutClear(inst->gpio.IN2_port,
+                     inst->gpio.IN2_pin);
+
+    inst->mode = CCW_MODE;
+  } else {
+    GPIO_PinOutClear(inst->gpio.IN1_port,
+                     inst->gpio.IN1_pin);
+
+    GPIO_PinOutSet(inst->gpio.IN2_port,
+                   inst->gpio.IN2_pin);
+
+    inst->mode = CW_MODE;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *    Gets the interrupt of a specific TIMER instance
+ *
+ * @param[in] inst
+ *    TIMER instance.
+ *
+ * @return
+ *   IRQ number of the TIMER.
+ *
+ ******************************************************************************/
+static IRQn_Type get_timer_irq(TIMER_TypeDef *timer){
+
+  IRQn_Type irq = TIMER0_IRQn;
+
+  switch ((uint32_t)timer) {
+#if defined(TIMER1_BASE)
+    case TIMER1_BASE:
+      irq = TIMER1_IRQn;
+      break;
+#endif
+#if defined(TIMER2_BASE)
+    case TIMER2_BASE:
+      irq = TIMER2_IRQn;
+      break;
+#endif
+#if defined(TIMER3_BASE)
+    case TIMER3_BASE:
+      irq = TIMER3_IRQn;
+      break;
+#endif
+#if defined(TIMER4_BASE)
+    case TIMER4_BASE:
+      irq = TIMER4_IRQn;
+      break;
+#endif
+#if defined(TIMER5_BASE)
+    case TIMER5_BASE:
+      irq = TIMER5_IRQn;
+      break;
+#endif
+#if defined(TIMER6_BASE)
+    case TIMER6_BASE:
+      irq = TIMER6_IRQn;
+      break;
+#endif
+    default:
+      break;
+  }
+  return irq;
+}
@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @file dc_motor_TB6549FG_speed.c
+ * @brief TB6549FG closed-loop speed controller
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "dc_motor_TB6549FG_speed.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+#define DUTY_MAX_Q16 ((int32_t)TB6549FG_DUTY_MAX << 16)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+static void tb6549fg_speed_ramp(tb6549fg_speed_ctrl_t *ctrl);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+/***************************************************************************//**
+ * @brief
+ *    Initializes a speed controller. The motor is initially not driven.
+ *
+ * @param[out] ctrl
+ *    Speed controller.
+ *
+ * @param[in] config
+ *    Speed controller configuration, control_hz and counts_per_rev must not
+ *    be 0.
+ ******************************************************************************/
+void tb6549fg_speed_ctrl_init(tb6549fg_speed_ctrl_t *ctrl,
+                              const tb6549fg_speed_config_t *config){
+
+  ctrl->config = *config;
+
+  //Speed of one encoder count per update, in Q16
+  ctrl->count_scale = ((int64_t)60 * config->control_hz
+                       << (16 + TB6549FG_SPEED_FRAC_BITS))
+                      / config->counts_per_rev;
+
+  //Setpoint change per update, at least the speed resolution
+  ctrl->ramp = (int32_t)(((int64_t)config->accel_rpm_s << TB6549FG_SPEED_FRAC_BITS)
+                         / config->control_hz);
+  if (ctrl->ramp == 0){
+    ctrl->ramp = 1;
+  }
+
+  ctrl->reverse = (int32_t)config->reverse_rpm << TB6549FG_SPEED_FRAC_BITS;
+  ctrl->target = 0;
+  ctrl->setpoint = 0;
+  ctrl->speed = 0;
+  ctrl->integrator = 0;
+  ctrl->duty = 0;
+  ctrl->direction = 0;
+  ctrl->reversals = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Sets the speed to regulate to.
+ *
+ * @param[in] ctrl
+ *    Speed controller.
+ *
+ * @param[in] rpm
+ *    Speed in RPM, positive for CW and negative for CCW. The setpoint ramps
+ *    to it at the configured acceleration.
+ ******************************************************************************/
+void tb6549fg_speed_ctrl_set_target(tb6549fg_speed_ctrl_t *ctrl,
+                                    int32_t rpm){
+
+  ctrl->target = rpm * (1 << TB6549FG_SPEED_FRAC_BITS);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Gets the measured speed.
+ *
+ * @param[in] ctrl
+ *    Speed controller.
+ *
+ * @return
+ *    Filtered speed in RPM, positive for CW.
+ ******************************************************************************/
+int32_t tb6549fg_speed_ctrl_get_speed(const tb6549fg_speed_ctrl_t *ctrl){
+
+  return ctrl->speed / (1 << TB6549FG_SPEED_FRAC_BITS);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Runs one control update.
+ *
+ * @note
+ *    The bridge can only drive the motor in the direction selected by IN1
+ *    and IN2, and a low PWM output short brakes it. Slowing down therefore
+ *    lowers the duty cycle down to 0, which brakes, and the direction only
+ *    flips once the motor is almost stopped. The setpoint is held at 0 until
+ *    then, so that the ramp restarts from standstill in the new direction.
+ *
+ * @param[in] ctrl
+ *    Speed controller.
+ *
+ * @param[in] counts
+ *    Encoder counts since the previous update, positive for CW.
+ *
+ * @return
+ *    Duty cycle to drive in ctrl->direction, up to TB6549FG_DUTY_MAX.
+ ******************************************************************************/
+uint16_t tb6549fg_speed_ctrl_update(tb6549fg_speed_ctrl_t *ctrl,
+                                    int32_t counts){
+
+  int32_t raw, err, p, integrator, duty;
+
+  //Low-pass filter the speed measured over one update
+  raw = (int32_t)(((int64_t)counts * ctrl->count_scale) / 65536);
+  ctrl->speed += (raw - ctrl->speed) / (1 << ctrl->config.filter_shift);
+
+  tb6549fg_speed_ramp(ctrl);
+
+  //PI in the driven direction
+  err = (ctrl->setpoint - ctrl->speed) * ctrl->direction;
+
+  p = (int32_t)(((int64_t)ctrl->config.kp * err)
+                / (1 << (16 + TB6549FG_SPEED_FRAC_BITS)));
+
+  integrator = ctrl->integrator
+               + (int32_t)(((int64_t)ctrl->config.ki * err)
+                           / ((int64_t)ctrl->config.control_hz
+                              << TB6549FG_SPEED_FRAC_BITS));
+
+  duty = p + (integrator / 65536);
+
+  //Stop integrating while the output saturates (anti-windup)
+  if (duty > TB6549FG_DUTY_MAX){
+    duty = TB6549FG_DUTY_MAX;
+    if (err > 0){
+      integrator = ctrl->integrator;
+    }
+  } else if (duty < 0){
+    duty = 0;
+    if (err < 0){
+      integrator = ctrl->integrator;
+    }
+  }
+
+  if (integrator > DUTY_MAX_Q16){
+    integrator = DUTY_MAX_Q16;
+  } else if (integrator < 0){
+    integrator = 0;
+  }
+
+  ctrl->integrator = integrator;
+  ctrl->duty = duty;
+
+  return (uint16_t)duty;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+/***************************************************************************//**
+ * @brief
+ *    Moves the setpoint toward the target and flips the direction when the
+ *    motor has stopped for a reversal.
+ *
+ * @param[in] ctrl
+ *    Speed controller.
+ ******************************************************************************/
+static void tb6549fg_speed_ramp(tb6549fg_speed_ctrl_t *ctrl){
+
+  int32_t target = ctrl->target;
+  int32_t limit = target;
+
+  //First start: no braking needed
+  if ((ctrl->direction == 0) && (target != 0)){
+    ctrl->direction = (target > 0) ? 1 : -1;
+  }
+
+  //Reversal: ramp down to standstill first
+  if ((target != 0) && ((target > 0) != (ctrl->direction > 0))){
+    limit = 0;
+
+    if ((ctrl->setpoint == 0)
+        && (ctrl->speed <= ctrl->reverse)
+        && (ctrl->speed >= -ctrl->reverse)){
+      ctrl->direction = -ctrl->direction;
+      ctrl->integrator = 0;
+      ctrl->reversals++;
+      limit = target;
+    }
+  }
+
+  if (ctrl->setpoint < limit){
+    ctrl->setpoint = (limit - ctrl->setpoint > ctrl->ramp)
+                     ? ctrl->setpoint + ctrl->ramp : limit;
+  } else if (ctrl->setpoint > limit){
+    ctrl->setpoint = (ctrl->setpoint - limit > ctrl->ramp)
+                     ? ctrl->setpoint - ctrl->ramp : limit;
+  }
+}
@@ -0,0 +1,309 @@
+/***************************************************************************//**
+ * @file dc_motor_TB6549FG_speed_test.c
+ * @brief Host test of the TB6549FG closed-loop speed controller
+ * @version 1.0.0
+ *
+ * Runs the speed controller against a simulated first-order motor with an
+ * encoder, as the PWM interrupt does, and checks the step response, the
+ * recovery from a load step, the soft reversal and the duty cycle
+ * resolution.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc dc_motor_TB6549FG_speed_test.c \
+ *       ../src/dc_motor_TB6549FG_speed.c -lm
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dc_motor_TB6549FG_speed.h"
+
+// Motor of the example: 639 RPM at full duty, 30 ms mechanical time constant
+#define MOTOR_RPM_MAX         639.0
+#define MOTOR_TAU_S           0.030
+
+// Plant integration steps per control update
+#define SUBSTEPS              10
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// Motor, bridge and encoder
+typedef struct {
+  tb6549fg_speed_ctrl_t ctrl;
+  double rpm;                 // Shaft speed, CW positive
+  double position;            // Shaft position in encoder counts
+  long counted;               // Encoder counts reported so far
+  double load_rpm;            // Speed lost to the load torque at any duty
+  double dt;                  // Control period (s)
+  int8_t direction;           // Direction set on IN1 and IN2
+  uint16_t duty;              // Duty cycle of the PWM output
+  unsigned flips;             // Direction changes of IN1 and IN2
+  double flip_rpm;            // Largest speed at a direction change
+  unsigned drives_against;    // Updates driving against a fast rotation
+} sim_t;
+
+static void sim_init(sim_t *sim, const tb6549fg_speed_config_t *config)
+{
+  tb6549fg_speed_ctrl_init(&sim->ctrl, config);
+  sim->rpm = 0.0;
+  sim->position = 0.0;
+  sim->counted = 0;
+  sim->load_rpm = 0.0;
+  sim->dt = 1.0 / config->control_hz;
+  sim->direction = 0;
+  sim->duty = 0;
+  sim->flips = 0;
+  sim->flip_rpm = 0.0;
+  sim->drives_against = 0;
+}
+
+// Average bridge voltage as a no-load speed: the motor is driven for the
+// high part of the PWM period and short braked for the low part
+static void sim_plant(sim_t *sim, double seconds)
+{
+  double h = sim->dt / SUBSTEPS;
+  int steps = (int)(seconds / h + 0.5);
+  int i;
+
+  for (i = 0; i < steps; i++) {
+    double drive = sim->direction * MOTOR_RPM_MAX * sim->duty / TB6549FG_DUTY_MAX;
+    double load = (sim->rpm > 0.5) ? sim->load_rpm
+                  : (sim->rpm < -0.5) ? -sim->load_rpm : 0.0;
+
+    sim->rpm += (drive - load - sim->rpm) * h / MOTOR_TAU_S;
+    sim->position += sim->rpm / 60.0 * sim->ctrl.config.counts_per_rev * h;
+  }
+}
+
+// One control update as run from the PWM TIMER overflow interrupt
+static void sim_step(sim_t *sim)
+{
+  long count;
+
+  sim_plant(sim, sim->dt);
+
+  count = (long)floor(sim->position);
+  sim->duty = tb6549fg_speed_ctrl_update(&sim->ctrl, (int32_t)(count - sim->counted));
+  sim->counted = count;
+
+  if (sim->ctrl.direction != sim->direction) {
+    if (sim->direction != 0) {
+      sim->flips++;
+      if (fabs(sim->rpm) > sim->flip_rpm)
+        sim->flip_rpm = fabs(sim->rpm);
+    }
+    sim->direction = sim->ctrl.direction;
+  }
+
+  // Driving against the rotation above the reversal speed
+  if ((sim->duty > 0)
+      && (sim->rpm * sim->direction < -(double)sim->ctrl.config.reverse_rpm))
+    sim->drives_against++;
+}
+
+static void sim_run(sim_t *sim, double seconds)
+{
+  int n = (int)(seconds / sim->dt + 0.5);
+
+  while (n--)
+    sim_step(sim);
+}
+
+// Mean speed and duty over a time
+static void sim_measure(sim_t *sim, double seconds, double *rpm, double *duty)
+{
+  int n = (int)(seconds / sim->dt + 0.5);
+  int i;
+
+  *rpm = 0.0;
+  *duty = 0.0;
+  for (i = 0; i < n; i++) {
+    sim_step(sim);
+    *rpm += sim->rpm;
+    *duty += sim->duty;
+  }
+  *rpm /= n;
+  *duty /= n;
+}
+
+static void test_step(const tb6549fg_speed_config_t *config)
+{
+  sim_t sim;
+  double rpm, duty, peak = 0.0, settle = -1.0, t;
+
+  sim_init(&sim, config);
+  tb6549fg_speed_ctrl_set_target(&sim.ctrl, 300);
+
+  for (t = 0.0; t < 1.0; t += sim.dt) {
+    sim_step(&sim);
+    if (sim.rpm > peak)
+      peak = sim.rpm;
+    if ((settle < 0.0) && (fabs(sim.rpm - 300.0) < 6.0))
+      settle = t;
+    else if (fabs(sim.rpm - 300.0) >= 6.0)
+      settle = -1.0;
+  }
+
+  sim_measure(&sim, 0.5, &rpm, &duty);
+
+  printf("step 0 -> 300 RPM: settled (2%%) after %.0f ms, peak %.1f RPM, "
+         "mean %.2f RPM, reported %ld RPM\n",
+         settle * 1000.0, peak, rpm,
+         (long)tb6549fg_speed_ctrl_get_speed(&sim.ctrl));
+
+  CHECK((settle >= 0.0) && (settle < 0.5));
+  CHECK(peak < 315.0);
+  CHECK(fabs(rpm - 300.0) < 1.0);
+  // One encoder count per update over the filter length
+  CHECK(labs(tb6549fg_speed_ctrl_get_speed(&sim.ctrl) - 300)
+        <= (long)(60 * config->control_hz / config->counts_per_rev
+                  >> config->filter_shift) + 1);
+  CHECK(sim.flips == 0);
+}
+
+static void test_load_step(const tb6549fg_speed_config_t *config)
+{
+  sim_t sim, open;
+  double rpm, duty, open_rpm, worst = 300.0, t;
+
+  sim_init(&sim, config);
+  tb6549fg_speed_ctrl_set_target(&sim.ctrl, 300);
+  sim_run(&sim, 1.0);
+
+  // Same duty cycle without feedback
+  open = sim;
+  sim.load_rpm = 100.0;
+  open.load_rpm = 100.0;
+
+  for (t = 0.0; t < 0.5; t += sim.dt) {
+    sim_step(&sim);
+    if (sim.rpm < worst)
+      worst = sim.rpm;
+  }
+  sim_measure(&sim, 0.2, &rpm, &duty);
+
+  sim_plant(&open, 1.0);
+  open_rpm = open.rpm;
+
+  printf("load step of 100 RPM at 300 RPM: dip to %.1f RPM, "
+         "recovered to %.2f RPM (open loop %.1f RPM)\n",
+         worst, rpm, open_rpm);
+
+  CHECK(worst > 260.0);
+  CHECK(fabs(rpm - 300.0) < 1.0);
+  CHECK(open_rpm < 210.0);
+}
+
+static void test_reversal(const tb6549fg_speed_config_t *config)
+{
+  sim_t sim;
+  double rpm, duty;
+  unsigned reversals;
+
+  sim_init(&sim, config);
+  tb6549fg_speed_ctrl_set_target(&sim.ctrl, 300);
+  sim_run(&sim, 1.0);
+
+  tb6549fg_speed_ctrl_set_target(&sim.ctrl, -300);
+  sim_run(&sim, 1.5);
+  sim_measure(&sim, 0.5, &rpm, &duty);
+  reversals = sim.ctrl.reversals;
+
+  printf("reversal 300 -> -300 RPM: %u direction change at %.1f RPM, "
+         "%u updates driving against the rotation, mean %.2f RPM\n",
+         sim.flips, sim.flip_rpm, sim.drives_against, rpm);
+
+  CHECK(sim.flips == 1);
+  CHECK(reversals == 1);
+  CHECK(sim.flip_rpm <= config->reverse_rpm + 2.0);
+  CHECK(sim.drives_against == 0);
+  CHECK(fabs(rpm + 300.0) < 1.0);
+
+  // Back to standstill holds the direction and brakes
+  tb6549fg_speed_ctrl_set_target(&sim.ctrl, 0);
+  sim_run(&sim, 1.0);
+  sim_measure(&sim, 0.2, &rpm, &duty);
+
+  printf("stop from -300 RPM: %.2f RPM, duty %.0f\n", rpm, duty);
+
+  CHECK(fabs(rpm) < 1.0);
+  CHECK(duty == 0.0);
+  CHECK(sim.flips == 1);
+}
+
+static void test_resolution(const tb6549fg_speed_config_t *config)
+{
+  sim_t sim;
+  double rpm[2], duty[2];
+  int i;
+
+  for (i = 0; i < 2; i++) {
+    sim_init(&sim, config);
+    tb6549fg_speed_ctrl_set_target(&sim.ctrl, 200 + i);
+    sim_run(&sim, 1.0);
+    sim_measure(&sim, 1.0, &rpm[i], &duty[i]);
+  }
+
+  printf("200 and 201 RPM: %.2f and %.2f RPM, duty %.0f and %.0f "
+         "(0.01 %% steps)\n", rpm[0], rpm[1], duty[0], duty[1]);
+
+  CHECK(fabs(rpm[0] - 200.0) < 0.5);
+  CHECK(fabs(rpm[1] - 201.0) < 0.5);
+  CHECK((duty[1] - duty[0]) > 0.0);
+  CHECK((duty[1] - duty[0]) < (TB6549FG_DUTY_MAX / 100));
+}
+
+int main(void)
+{
+  tb6549fg_speed_config_t config = TB6549FG_SPEED_CONFIG_DEFAULT;
+
+  test_step(&config);
+  test_load_step(&config);
+  test_reversal(&config);
+  test_resolution(&config);
+
+  printf(failed ? "FAILED\n" : "PASSED\n");
+
+  return failed;
+}
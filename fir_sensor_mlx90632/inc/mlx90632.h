@@ -173,4 +173,34 @@ sl_status_t mlx90632_unlock_eeprom(void);
  ******************************************************************************/
 sl_status_t mlx90632_measurment_cb(double *ambient, double *object);
 
+/***************************************************************************//**
+ * @brief  Same as mlx90632_measurment_cb() but calculated in single precision.
+ *         The object temperature iteration stops as soon as it converged.
+ *
+ * @param[out] *ambient Pointer
+ *             to memory location where ambient temperature value is stored.
+ * @param[out] *object Pointer
+ *             to memory location where object temperature value is stored.
+ *
+ * @retval  0 Successfully get temperature values.
+ * @retval  None 0, Something went wrong.
+ ******************************************************************************/
+sl_status_t mlx90632_measurment_cb_float(float *ambient, float *object);
+
+/***************************************************************************//**
+ * @brief  Same as mlx90632_measurment_cb() but calculated in fixed-point,
+ *         without any floating point operation.
+ *
+ * @param[out] *ambient Pointer
+ *             to memory location where ambient temperature value in
+ *             milli-Celsius is stored.
+ * @param[out] *object Pointer
+ *             to memory location where object temperature value in
+ *             milli-Celsius is stored.
+ *
+ * @retval  0 Successfully get temperature values.
+ * @retval  None 0, Something went wrong.
+ ******************************************************************************/
+sl_status_t mlx90632_measurment_cb_fixed(int32_t *ambient, int32_t *object);
+
 #endif // MLX90632_H
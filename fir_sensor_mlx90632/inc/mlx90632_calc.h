@@ -0,0 +1,264 @@
+/***************************************************************************//**
+ * @file  mlx90632_calc.h
+ * @brief IrThremo 3 Click temperature calculations.
+ * @version 0.0.1
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef MLX90632_CALC_H
+#define MLX90632_CALC_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Maximum number of object temperature iterations
+#ifndef MLX90632_CALC_MAX_ITERATIONS
+#define MLX90632_CALC_MAX_ITERATIONS     (5)
+#endif
+
+// Early-exit limit of the single precision iteration in Celsius
+#ifndef MLX90632_CALC_CONVERGENCE
+#define MLX90632_CALC_CONVERGENCE        (0.001f)
+#endif
+
+// Early-exit limit of the fixed-point iteration in Q16 Celsius (~0.001 C)
+#ifndef MLX90632_CALC_CONVERGENCE_Q16
+#define MLX90632_CALC_CONVERGENCE_Q16    (66)
+#endif
+
+// Q16 conversion helpers
+#define MLX90632_Q16_ONE                 (65536L)
+#define MLX90632_Q16_TO_MILLI(x)         ((int32_t)(((int64_t)(x) * 1000) \
+                                                    / MLX90632_Q16_ONE))
+
+/*******************************************************************************
+ ********************************   TYPES   ************************************
+ ******************************************************************************/
+
+/// Raw calibration constants as read from the EEPROM
+typedef struct {
+  int32_t P_R;
+  int32_t P_G;
+  int32_t P_T;
+  int32_t P_O;
+  int32_t Ea;
+  int32_t Eb;
+  int32_t Fa;
+  int32_t Fb;
+  int32_t Ga;
+  int16_t Gb;
+  int16_t Ka;
+  int16_t Ha;
+  int16_t Hb;
+} mlx90632_eeprom_t;
+
+/// Calibration constants derived once from the EEPROM content
+typedef struct {
+  // Shared by all variants
+  int32_t p_r;           ///< P_R / 2^8
+  int32_t p_g;           ///< P_G * 9.53e-7
+  int32_t p_t;           ///< P_T * 2^-44
+  int32_t p_o;           ///< P_O / 2^8
+  int16_t Gb;
+  int16_t Ka;
+
+  // Double precision reference
+  double kEa;            ///< Ea / 2^16
+  double kEb;            ///< Eb / 2^8
+  double kGa;            ///< Ga / 2^36
+  double kFb;            ///< Fb / 2^36
+  double alpha;          ///< Fa * Ha / 2^60
+  double hb;             ///< Hb / 2^14
+
+  // Single precision
+  float inv_kEa_f;       ///< 2^16 / Ea
+  float kEb_f;
+  float kGa_f;
+  float kFb_f;
+  float inv_alpha_f;     ///< 2^60 / (Fa * Ha)
+  float hb_f;
+
+  // Fixed-point
+  int32_t Ea;
+  int32_t Eb;
+  int32_t Ga;
+  int32_t Fb;
+  int64_t inv_alpha_q16; ///< 2^76 / (Fa * Ha)
+  int32_t hb_q16;        ///< Hb / 2^14 in Q16
+} mlx90632_calc_const_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Derive the calculation constants from the EEPROM content.
+ *
+ * Has to be called once after the EEPROM is read, every temperature
+ * calculation below only uses the derived constants.
+ *
+ * @param[in]  ee Calibration constants read from the EEPROM.
+ * @param[out] k Derived constants.
+ ******************************************************************************/
+void mlx90632_calc_init_constants(const mlx90632_eeprom_t *ee,
+                                  mlx90632_calc_const_t *k);
+
+/***************************************************************************//**
+ * @brief Pre-calculations for ambient temperature (AMB value).
+ *
+ * @param[in] k Derived constants.
+ * @param[in] ambient_new_raw value.
+ * @param[in] ambient_old_raw value.
+ *
+ * @retval Calculated AMB value.
+ ******************************************************************************/
+double mlx90632_calc_preprocess_ambient(const mlx90632_calc_const_t *k,
+                                        int16_t ambient_new_raw,
+                                        int16_t ambient_old_raw);
+
+/***************************************************************************//**
+ * @brief Pre-calculations for object temperature (STO value).
+ *
+ * @param[in] k Derived constants.
+ * @param[in] object_new_raw value.
+ * @param[in] object_old_raw value.
+ * @param[in] ambient_new_raw value.
+ * @param[in] ambient_old_raw value.
+ *
+ * @retval Calculated STO value.
+ ******************************************************************************/
+double mlx90632_calc_preprocess_object(const mlx90632_calc_const_t *k,
+                                       int16_t object_new_raw,
+                                       int16_t object_old_raw,
+                                       int16_t ambient_new_raw,
+                                       int16_t ambient_old_raw);
+
+/***************************************************************************//**
+ * @brief Integer pre-calculations for ambient temperature.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] ambient_new_raw value.
+ * @param[in] ambient_old_raw value.
+ *
+ * @retval Calculated AMB value in Q8.
+ ******************************************************************************/
+int32_t mlx90632_calc_preprocess_ambient_q8(const mlx90632_calc_const_t *k,
+                                            int16_t ambient_new_raw,
+                                            int16_t ambient_old_raw);
+
+/***************************************************************************//**
+ * @brief Integer pre-calculations for object temperature.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] object_new_raw value.
+ * @param[in] object_old_raw value.
+ * @param[in] ambient_new_raw value.
+ * @param[in] ambient_old_raw value.
+ *
+ * @retval Calculated STO value truncated to an integer.
+ ******************************************************************************/
+int32_t mlx90632_calc_preprocess_object_int(const mlx90632_calc_const_t *k,
+                                            int16_t object_new_raw,
+                                            int16_t object_old_raw,
+                                            int16_t ambient_new_raw,
+                                            int16_t ambient_old_raw);
+
+/***************************************************************************//**
+ * @brief Ambient temperature, double precision reference.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] ambient AMB value.
+ *
+ * @retval Ambient temperature in Celsius.
+ ******************************************************************************/
+double mlx90632_calc_temp_ambient(const mlx90632_calc_const_t *k,
+                                  double ambient);
+
+/***************************************************************************//**
+ * @brief Ambient temperature, fixed-point.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] ambient_q8 AMB value in Q8.
+ *
+ * @retval Ambient temperature in Q16 Celsius.
+ ******************************************************************************/
+int32_t mlx90632_calc_temp_ambient_q16(const mlx90632_calc_const_t *k,
+                                       int32_t ambient_q8);
+
+/***************************************************************************//**
+ * @brief Object temperature, double precision reference.
+ *
+ * Runs the full MLX90632_CALC_MAX_ITERATIONS iterations.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] object STO value.
+ * @param[in] ambient AMB value.
+ *
+ * @retval Object temperature in Celsius.
+ ******************************************************************************/
+double mlx90632_calc_temp_object(const mlx90632_calc_const_t *k,
+                                 int32_t object, int32_t ambient);
+
+/***************************************************************************//**
+ * @brief Object temperature, single precision.
+ *
+ * Stops iterating as soon as two consecutive results differ by less than
+ * MLX90632_CALC_CONVERGENCE.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] object STO value.
+ * @param[in] ambient AMB value.
+ *
+ * @retval Object temperature in Celsius.
+ ******************************************************************************/
+float mlx90632_calc_temp_object_f(const mlx90632_calc_const_t *k,
+                                  int32_t object, int32_t ambient);
+
+/***************************************************************************//**
+ * @brief Object temperature, fixed-point without any floating point operation.
+ *
+ * Stops iterating as soon as two consecutive results differ by less than
+ * MLX90632_CALC_CONVERGENCE_Q16.
+ *
+ * @param[in] k Derived constants.
+ * @param[in] object STO value.
+ * @param[in] ambient AMB value.
+ *
+ * @retval Object temperature in Q16 Celsius.
+ ******************************************************************************/
+int32_t mlx90632_calc_temp_object_q16(const mlx90632_calc_const_t *k,
+                                      int32_t object, int32_t ambient);
+
+#endif // MLX90632_CALC_H
@@ -36,7 +36,7 @@
 
 #include <mlx90632.h>
 #include <mlx90632_i2c.h>
-#include <math.h>
+#include <mlx90632_calc.h>
 
 
 /// MLX90632 calibration variables
@@ -45,45 +45,21 @@ static int16_t ambient_old_raw;
 static int16_t object_new_raw;
 static int16_t object_old_raw;
 
-static int32_t PR;
-static int32_t PG;
-static int32_t PT;
-static int32_t PO;
-static int32_t Ea;
-static int32_t Eb;
-static int32_t Fa;
-static int32_t Fb;
-static int32_t Ga;
-
-static int16_t Gb;
-static int16_t Ka;
-static int16_t Ha;
-static int16_t Hb;
+static mlx90632_eeprom_t eeprom;
+
+/// Constants derived once from the EEPROM content
+static mlx90632_calc_const_t calc_const;
 
 /***************************************************************************//**
  *                            LOCAL PROTOTYPES
  ******************************************************************************/
 // Implementation of reading all calibration parameters.
-static int32_t mlx90632_read_eeprom(int32_t *PR, int32_t *PG, int32_t *PO,
-                                    int32_t *PT, int32_t *Ea, int32_t *Eb,
-                                    int32_t *Fa, int32_t *Fb, int32_t *Ga,
-                                    int16_t *Gb, int16_t *Ka, int16_t *Ha,
-                                    int16_t *Hb);
+static int32_t mlx90632_read_eeprom(mlx90632_eeprom_t *ee);
 
 // Read ambient raw old and new values.
 static int32_t mlx90632_read_temp_ambient_raw(int16_t *ambient_new_raw,
                                               int16_t *ambient_old_raw);
 
-// Pre-calculations for ambient.
-static double mlx90632_preprocess_temp_ambient(int16_t ambient_new_raw,
-                                               int16_t ambient_old_raw,
-                                               int16_t Gb);
-// Ambient temperature calculations.
-static double mlx90632_calc_temp_ambient(int16_t ambient_new_raw,
-                                         int16_t ambient_old_raw, int32_t P_T,
-                                         int32_t P_R, int32_t P_G, int32_t P_O,
-                                         int16_t Gb);
-
 // Clear REG_STATUS new_data bit.
 static int32_t clear_data_available(void);
 
@@ -117,52 +93,18 @@ static int32_t mlx90632_read_temp_raw(int16_t *ambient_new_raw,
                                       int16_t *object_new_raw,
                                       int16_t *object_old_raw);
 
-// Pre-calculations for object temperature.
-static double mlx90632_preprocess_temp_object(int16_t object_new_raw,
-                                              int16_t object_old_raw,
-                                              int16_t ambient_new_raw,
-                                              int16_t ambient_old_raw,
-                                              int16_t Ka);
-
-// Calculations for object temperature.
-static double mlx90632_calc_temp_object_iteration(double prev_object_temp,
-                                                  int32_t object, double TAdut,
-                                                  int32_t Ga, int32_t Fa,
-                                                  int32_t Fb, int16_t Ha,
-                                                  int16_t Hb, double emissivity);
-
-// Calculation of TAdut and iterate calculations.
-static double mlx90632_calc_temp_object(int32_t object, int32_t ambient,
-                                        int32_t Ea, int32_t Eb, int32_t Ga,
-                                        int32_t Fa, int32_t Fb,
-                                        int16_t Ha, int16_t Hb);
 // Check the eeprom.
 static uint16_t eeprom_busy(void);
 /***************************************************************************//**
  * @brief Read the eeprom registers value from the mlx90632.
  *
- * @param[out]  P_R calibration constant
- * @param[out]  P_G calibration constant
- * @param[out]  P_O calibration constant
- * @param[out]  P_T calibration constant
- * @param[out]  Ea calibration constant
- * @param[out]  Eb calibration constant
- * @param[out]  Fa calibration constant
- * @param[out]  Fb calibration constant
- * @param[out]  Ga calibration constant
- * @param[out]  Gb calibration constant
- * @param[out]  Ka calibration constant
- * @param[out]  Ha Customer calibration constant
- * @param[out]  Hb Customer calibration constant
+ * @param[out]  ee calibration constants (P_R, P_G, P_O, P_T, Ea, Eb, Fa,
+ *              Fb, Ga, Gb, Ka and the Ha, Hb customer constants)
  *
  * @retval  0 Successfully read eeprom register.
  * @retval <0 Something went wrong.
  ******************************************************************************/
-static int32_t mlx90632_read_eeprom(int32_t *PR, int32_t *PG, int32_t *PO,
-                                    int32_t *PT, int32_t *Ea, int32_t *Eb,
-                                    int32_t *Fa, int32_t *Fb, int32_t *Ga,
-                                    int16_t *Gb, int16_t *Ka, int16_t *Ha,
-                                    int16_t *Hb)
+static int32_t mlx90632_read_eeprom(mlx90632_eeprom_t *ee)
 {
   int32_t ret;
   uint8_t mode;
@@ -181,67 +123,67 @@ static int32_t mlx90632_read_eeprom(int32_t *PR, int32_t *PG, int32_t *PO,
 
   mlx90632_set_mode(0x02);
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_P_R, (uint32_t *) PR);
+  ret = mlx90632_i2c_read32(MLX90632_EE_P_R, (uint32_t *) &ee->P_R);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_P_G, (uint32_t *) PG);
+  ret = mlx90632_i2c_read32(MLX90632_EE_P_G, (uint32_t *) &ee->P_G);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_P_O, (uint32_t *) PO);
+  ret = mlx90632_i2c_read32(MLX90632_EE_P_O, (uint32_t *) &ee->P_O);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_P_T, (uint32_t *) PT);
+  ret = mlx90632_i2c_read32(MLX90632_EE_P_T, (uint32_t *) &ee->P_T);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_Ea, (uint32_t *) Ea);
+  ret = mlx90632_i2c_read32(MLX90632_EE_Ea, (uint32_t *) &ee->Ea);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_Eb, (uint32_t *) Eb);
+  ret = mlx90632_i2c_read32(MLX90632_EE_Eb, (uint32_t *) &ee->Eb);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_Fa, (uint32_t *) Fa);
+  ret = mlx90632_i2c_read32(MLX90632_EE_Fa, (uint32_t *) &ee->Fa);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_Fb, (uint32_t *) Fb);
+  ret = mlx90632_i2c_read32(MLX90632_EE_Fb, (uint32_t *) &ee->Fb);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read32(MLX90632_EE_Ga, (uint32_t *) Ga);
+  ret = mlx90632_i2c_read32(MLX90632_EE_Ga, (uint32_t *) &ee->Ga);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read(MLX90632_EE_Gb, (uint16_t *) Gb);
+  ret = mlx90632_i2c_read(MLX90632_EE_Gb, (uint16_t *) &ee->Gb);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read(MLX90632_EE_Ha, (uint16_t *) Ha);
+  ret = mlx90632_i2c_read(MLX90632_EE_Ha, (uint16_t *) &ee->Ha);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read(MLX90632_EE_Hb, (uint16_t *) Hb);
+  ret = mlx90632_i2c_read(MLX90632_EE_Hb, (uint16_t *) &ee->Hb);
   if (ret < 0) {
     return ret;
   }
 
-  ret = mlx90632_i2c_read(MLX90632_EE_Ka, (uint16_t *) Ka);
+  ret = mlx90632_i2c_read(MLX90632_EE_Ka, (uint16_t *) &ee->Ka);
   if (ret < 0) {
     return ret;
   }
@@ -289,61 +231,6 @@ static int32_t mlx90632_read_temp_ambient_raw(int16_t *ambient_new_raw,
   return ret;
 }
 
-/***************************************************************************//**
- * @brief Pre-calculations for ambient temperature.
- *
- * @param[in] *ambient_new_raw Pointer to
- *             memory location where new ambient value from sensor is stored.
- * @param[in] *ambient_old_raw  Pointer
- *             to memory location where old ambient value from sensor is stored.
- * @param[in] Gb calibration constant.
- *
- * @retval Calculated AMB value.
- ******************************************************************************/
-static double mlx90632_preprocess_temp_ambient(int16_t ambient_new_raw,
-                                        int16_t ambient_old_raw, int16_t Gb)
-{
-  double VR_Ta, kGb;
-
-  kGb = (double)Gb * 0.0009765625;
-  VR_Ta = ambient_old_raw + kGb * (ambient_new_raw / 12.0);
-
-  return ((ambient_new_raw / (12.0) ) / VR_Ta) * 524288.0;
-}
-
-/***************************************************************************//**
- * @brief Ambient temperature calculations.
- *
- * @param[in] ambient_new_raw value.
- * @param[in] ambient_old_raw value.
- * @param[in] P_T calibration constant.
- * @param[in] P_R calibration constant.
- * @param[in] P_G calibration constant.
- * @param[in] P_O calibration constant.
- * @param[in] Gb calibration constant.
- *
- * @retval Calculated ambient temperature value in C.
- ******************************************************************************/
-static double mlx90632_calc_temp_ambient(int16_t ambient_new_raw,
-                                  int16_t ambient_old_raw, int32_t P_T,
-                                  int32_t P_R, int32_t P_G,
-                                  int32_t P_O, int16_t Gb)
-{
-  double AMB, ambientTemp;
-
-  AMB = mlx90632_preprocess_temp_ambient(ambient_new_raw,
-                                           ambient_old_raw, Gb);
-
-  P_T = P_T * 5.6843418860808015E-14;
-  P_R = P_R * 0.00390625;
-  P_G = P_G * 0.000000953;
-  P_O = P_O * 0.00390625;
-
-  ambientTemp = P_O + (AMB - P_R) / P_G + P_T * (AMB - P_R)*(AMB - P_R);
-
-  return ambientTemp;
-}
-
 /***************************************************************************//**
  * @brief Clear REG_STATUS new_data bit.
  *
@@ -635,118 +522,6 @@ static int32_t mlx90632_read_temp_raw(int16_t *ambient_new_raw,
   return ret;
 }
 
-/***************************************************************************//**
- * @brief Pre-calculations for object temperature.
- *
- * @param[in] object_new_raw value.
- * @param[in] object_old_raw value.
- * @param[in] ambient_new_raw value.
- * @param[in] ambient_old_raw value.
- * @param[in] Ka calibration constant.
- *
- * @retval Calculated STO value.
- ******************************************************************************/
-static double mlx90632_preprocess_temp_object(int16_t object_new_raw,
-                                              int16_t object_old_raw,
-                                              int16_t ambient_new_raw,
-                                              int16_t ambient_old_raw,
-                                              int16_t Ka)
-{
-  double VR_IR, kKa;
-
-  kKa = ((double)Ka) / 1024.0;
-  VR_IR = ambient_old_raw + kKa * (ambient_new_raw / (MLX90632_REF_3));
-
-  // Return STo=(S/12)/VRTO*2^19
-  return ((((object_new_raw + object_old_raw) / 2) /
-         (MLX90632_REF_12)) / VR_IR) * 524288.0;
-}
-
-/***************************************************************************//**
- * @brief Calculations for object temperature.
- *
- * @param[in] prev_object_temp should be 25.0 C.
- * @param[in] object STO value.
- * @param[in] TAdut value.
- * @param[in] Ga calibration constant.
- * @param[in] Fa calibration constant.
- * @param[in] Fb calibration constant.
- * @param[in] Ha calibration constant.
- * @param[in] Hb calibration constant.
- * @param[in] emissivity, default 1.0.
- *
- * @retval Calculated object temperature value in Celsius.
- ******************************************************************************/
-static double mlx90632_calc_temp_object_iteration(double prev_object_temp,
-                                                  int32_t object, double TAdut,
-                                                  int32_t Ga, int32_t Fa,
-                                                  int32_t Fb, int16_t Ha,
-                                                  int16_t Hb, double emissivity)
-{
-  double calcedGa, calcedGb, calcedFa, TAdut4, first_sqrt;
-  // temp variables
-  double KsTAtmp, Alpha_corr;
-  double Ha_customer, Hb_customer;
-
-  Ha_customer = Ha / ((double)16384.0);
-  Hb_customer = Hb / ((double)16384.0);
-
-  calcedGa = ((double)Ga * (prev_object_temp - 25)) / ((double)68719476736.0);
-  KsTAtmp = (double)Fb * (TAdut - 25);
-  calcedGb = KsTAtmp / ((double)68719476736.0);
-
-  Alpha_corr = (((double)(Fa * POW10)) * Ha_customer *
-               (double)(1 + calcedGa + calcedGb)) /
-               ((double)70368744177664.0);
-
-  calcedFa = object / (emissivity * (Alpha_corr / POW10));
-
-  // TA^4
-  TAdut4 = (TAdut + 273.15) * (TAdut + 273.15) *
-           (TAdut + 273.15) * (TAdut + 273.15);
-
-  first_sqrt = sqrt(calcedFa + TAdut4);
-
-  return (sqrt(first_sqrt) - 273.15 - Hb_customer);
-}
-
-/***************************************************************************//**
- * @brief Calculation of TAdut and iterate calculations.
- *
- * @param[in] object STO value.
- * @param[in] ambient AMB value.
- * @param[in] Ea calibration constant.
- * @param[in] Eb calibration constant.
- * @param[in] Ga calibration constant.
- * @param[in] Fa calibration constant.
- * @param[in] Fb calibration constant.
- * @param[in] Ha calibration constant.
- * @param[in] Hb calibration constant.
- *
- * @retval Calculated object temperature value in Celsius.
- ******************************************************************************/
-static double mlx90632_calc_temp_object(int32_t object, int32_t ambient,
-                                        int32_t Ea, int32_t Eb, int32_t Ga,
-                                        int32_t Fa, int32_t Fb,
-                                        int16_t Ha, int16_t Hb)
-{
-  double kEa, kEb, TAdut;
-  double temp = 25.0;
-  double tmp_emi = 1.0;
-  int8_t i;
-
-  kEa = ((double)Ea) / ((double)65536.0);
-  kEb = ((double)Eb) / ((double)256.0);
-  TAdut = (((double)ambient) - kEb) / kEa + 25;
-
-  //iterate through calculations (minimum 3)
-  for (i = 0; i < 5; ++i) {
-    temp = mlx90632_calc_temp_object_iteration(temp, object, TAdut, Ga,
-                                               Fa, Fb, Ha, Hb, tmp_emi);
-  }
-  return temp;
-}
-
 /***************************************************************************//**
  * @brief Flag indicating that the eeprom is busy.
  *
@@ -829,13 +604,14 @@ sl_status_t mlx90632_init(void)
   }
 
   // Read the eeprom registers value from the mlx90632
-  ret = mlx90632_read_eeprom(&PR, &PG, &PO, &PT,
-                             &Ea, &Eb, &Fa, &Fb,
-                             &Ga, &Gb, &Ka, &Ha, &Hb);
+  ret = mlx90632_read_eeprom(&eeprom);
   if (ret < 0) {
     sc = SL_STATUS_FAIL;
   }
 
+  // Derive the calculation constants once instead of on every measurement
+  mlx90632_calc_init_constants(&eeprom, &calc_const);
+
   return sc;
 }
 
@@ -883,18 +659,85 @@ sl_status_t mlx90632_measurment_cb(double *ambient,double *object)
     return sc = SL_STATUS_FAIL;
   }
 
-  pre_ambient = mlx90632_preprocess_temp_ambient(ambient_new_raw,
-                                                 ambient_old_raw, Gb);
+  pre_ambient = mlx90632_calc_preprocess_ambient(&calc_const,
+                                                 ambient_new_raw,
+                                                 ambient_old_raw);
 
-  *ambient = mlx90632_calc_temp_ambient(ambient_new_raw, ambient_old_raw, PT,
-                                        PR, PG, PO, Gb);
+  *ambient = mlx90632_calc_temp_ambient(&calc_const, pre_ambient);
 
-  pre_object = mlx90632_preprocess_temp_object(object_new_raw, object_old_raw,
-                                               ambient_new_raw, ambient_old_raw,
-                                               Ka);
+  pre_object = mlx90632_calc_preprocess_object(&calc_const,
+                                               object_new_raw, object_old_raw,
+                                               ambient_new_raw,
+                                               ambient_old_raw);
 
-  *object = mlx90632_calc_temp_object(pre_object, pre_ambient, Ea,
-                                      Eb, Ga, Fa, Fb, Ha, Hb);
+  *object = mlx90632_calc_temp_object(&calc_const, (int32_t)pre_object,
+                                      (int32_t)pre_ambient);
 
   return sc;
 }
+
+// Function gives back both temperature values in single precision.
+sl_status_t mlx90632_measurment_cb_float(float *ambient, float *object)
+{
+  int32_t ret;
+  int32_t pre_ambient_q8, pre_object;
+
+  ret = mlx90632_read_temp_raw(&ambient_new_raw, &ambient_old_raw,
+                               &object_new_raw, &object_old_raw);
+
+  if (ret < 0) {
+    return SL_STATUS_FAIL;
+  }
+
+  pre_ambient_q8 = mlx90632_calc_preprocess_ambient_q8(&calc_const,
+                                                       ambient_new_raw,
+                                                       ambient_old_raw);
+
+  *ambient = (float)mlx90632_calc_temp_ambient_q16(&calc_const,
+                                                   pre_ambient_q8)
+             / (float)MLX90632_Q16_ONE;
+
+  pre_object = mlx90632_calc_preprocess_object_int(&calc_const,
+                                                   object_new_raw,
+                                                   object_old_raw,
+                                                   ambient_new_raw,
+                                                   ambient_old_raw);
+
+  *object = mlx90632_calc_temp_object_f(&calc_const, pre_object,
+                                        pre_ambient_q8 / 256);
+
+  return SL_STATUS_OK;
+}
+
+// Function gives back both temperature values in milli-Celsius.
+sl_status_t mlx90632_measurment_cb_fixed(int32_t *ambient, int32_t *object)
+{
+  int32_t ret;
+  int32_t pre_ambient_q8, pre_object;
+
+  ret = mlx90632_read_temp_raw(&ambient_new_raw, &ambient_old_raw,
+                               &object_new_raw, &object_old_raw);
+
+  if (ret < 0) {
+    return SL_STATUS_FAIL;
+  }
+
+  pre_ambient_q8 = mlx90632_calc_preprocess_ambient_q8(&calc_const,
+                                                       ambient_new_raw,
+                                                       ambient_old_raw);
+
+  *ambient = MLX90632_Q16_TO_MILLI(
+    mlx90632_calc_temp_ambient_q16(&calc_const, pre_ambient_q8));
+
+  pre_object = mlx90632_calc_preprocess_object_int(&calc_const,
+                                                   object_new_raw,
+                                                   object_old_raw,
+                                                   ambient_new_raw,
+                                                   ambient_old_raw);
+
+  *object = MLX90632_Q16_TO_MILLI(
+    mlx90632_calc_temp_object_q16(&calc_const, pre_object,
+                                  pre_ambient_q8 / 256));
+
+  return SL_STATUS_OK;
+}
@@ -0,0 +1,341 @@
+/***************************************************************************//**
+ * @file  mlx90632_calc.c
+ * @brief IrThremo 3 Click temperature calculations.
+ * @version 0.0.1
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <mlx90632_calc.h>
+#include <math.h>
+
+// 273.15 K and 25 C in Q16
+#define KELVIN_OFFSET_Q16    (17901158LL)
+#define T_REF_Q16            (25LL << 16)
+
+/***************************************************************************//**
+ *                            LOCAL PROTOTYPES
+ ******************************************************************************/
+// Integer square root of a 64-bit value.
+static uint64_t isqrt64(uint64_t value);
+
+// 2^76 / divisor without overflowing 64 bits.
+static int64_t div_2_76(uint64_t divisor);
+
+/***************************************************************************//**
+ * @brief Integer square root, rounded down.
+ *
+ * @param[in] value Radicand.
+ *
+ * @retval floor(sqrt(value)).
+ ******************************************************************************/
+static uint64_t isqrt64(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+/***************************************************************************//**
+ * @brief Calculate 2^76 / divisor in two division steps.
+ *
+ * @param[in] divisor Fa * Ha, has to be within [2^16, 2^48).
+ *
+ * @retval Quotient, 0 if the divisor is out of range.
+ ******************************************************************************/
+static int64_t div_2_76(uint64_t divisor)
+{
+  uint64_t quotient, remainder;
+
+  if ((divisor < (1ULL << 16)) || (divisor >= (1ULL << 48))) {
+    return 0;
+  }
+
+  quotient = (1ULL << 62) / divisor;
+  remainder = (1ULL << 62) % divisor;
+
+  return (int64_t)((quotient << 14) + ((remainder << 14) / divisor));
+}
+
+/***************************************************************************//**
+ *                            PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+// Derive the calculation constants from the EEPROM content
+void mlx90632_calc_init_constants(const mlx90632_eeprom_t *ee,
+                                  mlx90632_calc_const_t *k)
+{
+  int64_t fa_ha;
+
+  // Same integer truncation as the ambient calculation always had
+  k->p_r = ee->P_R / 256;
+  k->p_g = (int32_t)(((int64_t)ee->P_G * 953) / 1000000000);
+  k->p_t = 0;  // |P_T * 2^-44| is always below 1
+  k->p_o = ee->P_O / 256;
+  k->Gb = ee->Gb;
+  k->Ka = ee->Ka;
+
+  k->kEa = ((double)ee->Ea) / 65536.0;
+  k->kEb = ((double)ee->Eb) / 256.0;
+  k->kGa = ((double)ee->Ga) / 68719476736.0;
+  k->kFb = ((double)ee->Fb) / 68719476736.0;
+  k->alpha = ((double)ee->Fa) * ((double)ee->Ha) / 1152921504606846976.0;
+  k->hb = ((double)ee->Hb) / 16384.0;
+
+  k->inv_kEa_f = 65536.0f / (float)ee->Ea;
+  k->kEb_f = (float)ee->Eb / 256.0f;
+  k->kGa_f = (float)ee->Ga / 68719476736.0f;
+  k->kFb_f = (float)ee->Fb / 68719476736.0f;
+  k->inv_alpha_f = 1152921504606846976.0f / ((float)ee->Fa * (float)ee->Ha);
+  k->hb_f = (float)ee->Hb / 16384.0f;
+
+  k->Ea = ee->Ea;
+  k->Eb = ee->Eb;
+  k->Ga = ee->Ga;
+  k->Fb = ee->Fb;
+  fa_ha = (int64_t)ee->Fa * ee->Ha;
+  k->inv_alpha_q16 = (fa_ha > 0) ? div_2_76((uint64_t)fa_ha) : 0;
+  k->hb_q16 = (int32_t)ee->Hb * 4;
+}
+
+// Pre-calculations for ambient temperature
+double mlx90632_calc_preprocess_ambient(const mlx90632_calc_const_t *k,
+                                        int16_t ambient_new_raw,
+                                        int16_t ambient_old_raw)
+{
+  double VR_Ta, kGb;
+
+  kGb = (double)k->Gb * 0.0009765625;
+  VR_Ta = ambient_old_raw + kGb * (ambient_new_raw / 12.0);
+
+  return ((ambient_new_raw / (12.0)) / VR_Ta) * 524288.0;
+}
+
+// Pre-calculations for object temperature
+double mlx90632_calc_preprocess_object(const mlx90632_calc_const_t *k,
+                                       int16_t object_new_raw,
+                                       int16_t object_old_raw,
+                                       int16_t ambient_new_raw,
+                                       int16_t ambient_old_raw)
+{
+  double VR_IR, kKa;
+
+  kKa = ((double)k->Ka) / 1024.0;
+  VR_IR = ambient_old_raw + kKa * (ambient_new_raw / 12.0);
+
+  // Return STo=(S/12)/VRTO*2^19
+  return ((((object_new_raw + object_old_raw) / 2) / 12.0) / VR_IR)
+         * 524288.0;
+}
+
+// Integer pre-calculations for ambient temperature
+int32_t mlx90632_calc_preprocess_ambient_q8(const mlx90632_calc_const_t *k,
+                                            int16_t ambient_new_raw,
+                                            int16_t ambient_old_raw)
+{
+  int64_t vr_ta;
+
+  // VR_Ta * 12 * 2^10
+  vr_ta = (int64_t)ambient_old_raw * 12288 + (int64_t)k->Gb * ambient_new_raw;
+  if (vr_ta == 0) {
+    return 0;
+  }
+
+  return (int32_t)(((int64_t)ambient_new_raw << 37) / vr_ta);
+}
+
+// Integer pre-calculations for object temperature
+int32_t mlx90632_calc_preprocess_object_int(const mlx90632_calc_const_t *k,
+                                            int16_t object_new_raw,
+                                            int16_t object_old_raw,
+                                            int16_t ambient_new_raw,
+                                            int16_t ambient_old_raw)
+{
+  int64_t vr_ir;
+
+  // VR_IR * 12 * 2^10
+  vr_ir = (int64_t)ambient_old_raw * 12288 + (int64_t)k->Ka * ambient_new_raw;
+  if (vr_ir == 0) {
+    return 0;
+  }
+
+  return (int32_t)(((int64_t)((object_new_raw + object_old_raw) / 2) << 29)
+                   / vr_ir);
+}
+
+// Ambient temperature, double precision reference
+double mlx90632_calc_temp_ambient(const mlx90632_calc_const_t *k,
+                                  double ambient)
+{
+  return k->p_o + (ambient - k->p_r) / k->p_g
+         + k->p_t * (ambient - k->p_r) * (ambient - k->p_r);
+}
+
+// Ambient temperature, fixed-point
+int32_t mlx90632_calc_temp_ambient_q16(const mlx90632_calc_const_t *k,
+                                       int32_t ambient_q8)
+{
+  int64_t diff_q8, temp_q16;
+
+  temp_q16 = (int64_t)k->p_o << 16;
+  if (k->p_g == 0) {
+    return (int32_t)temp_q16;
+  }
+
+  diff_q8 = (int64_t)ambient_q8 - ((int64_t)k->p_r << 8);
+  temp_q16 += (diff_q8 << 8) / k->p_g;
+  temp_q16 += (int64_t)k->p_t * diff_q8 * diff_q8;
+
+  return (int32_t)temp_q16;
+}
+
+// Object temperature, double precision reference
+double mlx90632_calc_temp_object(const mlx90632_calc_const_t *k,
+                                 int32_t object, int32_t ambient)
+{
+  double TAdut, TAdut4, calcedGb, Alpha_corr;
+  double temp = 25.0;
+  int8_t i;
+
+  TAdut = (((double)ambient) - k->kEb) / k->kEa + 25;
+  TAdut4 = (TAdut + 273.15) * (TAdut + 273.15)
+           * (TAdut + 273.15) * (TAdut + 273.15);
+  calcedGb = k->kFb * (TAdut - 25);
+
+  //iterate through calculations (minimum 3)
+  for (i = 0; i < MLX90632_CALC_MAX_ITERATIONS; ++i) {
+    Alpha_corr = k->alpha * (1 + k->kGa * (temp - 25) + calcedGb);
+    temp = sqrt(sqrt(object / Alpha_corr + TAdut4)) - 273.15 - k->hb;
+  }
+
+  return temp;
+}
+
+// Object temperature, single precision
+float mlx90632_calc_temp_object_f(const mlx90632_calc_const_t *k,
+                                  int32_t object, int32_t ambient)
+{
+  float TAdut, TAdutK, TAdut4, calcedGb, calcedFa, next;
+  float temp = 25.0f;
+  int8_t i;
+
+  TAdut = ((float)ambient - k->kEb_f) * k->inv_kEa_f + 25.0f;
+  TAdutK = TAdut + 273.15f;
+  TAdut4 = (TAdutK * TAdutK) * (TAdutK * TAdutK);
+  calcedGb = 1.0f + k->kFb_f * (TAdut - 25.0f);
+
+  for (i = 0; i < MLX90632_CALC_MAX_ITERATIONS; ++i) {
+    calcedFa = ((float)object * k->inv_alpha_f)
+               / (calcedGb + k->kGa_f * (temp - 25.0f));
+    next = sqrtf(sqrtf(calcedFa + TAdut4)) - 273.15f - k->hb_f;
+
+    if (fabsf(next - temp) < MLX90632_CALC_CONVERGENCE) {
+      return next;
+    }
+    temp = next;
+  }
+
+  return temp;
+}
+
+// Object temperature, fixed-point
+int32_t mlx90632_calc_temp_object_q16(const mlx90632_calc_const_t *k,
+                                      int32_t object, int32_t ambient)
+{
+  int64_t ta_q16, ta_k_q16, ta2_q8, ta4_q16, gb_q30, g_q30;
+  int64_t temp_q16 = T_REF_Q16;
+  int64_t next_q16, fa_q16, diff;
+  uint64_t mag, quotient, remainder, k2_q8;
+  int8_t i;
+
+  if (k->Ea == 0) {
+    return (int32_t)temp_q16;
+  }
+
+  // TAdut = (AMB - Eb / 2^8) * 2^16 / Ea + 25
+  ta_q16 = ((((int64_t)ambient << 8) - k->Eb) << 24) / k->Ea + T_REF_Q16;
+  ta_k_q16 = ta_q16 + KELVIN_OFFSET_Q16;
+  ta2_q8 = (ta_k_q16 * ta_k_q16) >> 24;
+  ta4_q16 = ta2_q8 * ta2_q8;
+
+  // 2^30 * (1 + Fb * (TAdut - 25) / 2^36)
+  gb_q30 = (1LL << 30) + (((int64_t)k->Fb * (ta_q16 - T_REF_Q16)) >> 22);
+  mag = (uint64_t)(object < 0 ? -(int64_t)object : object)
+        * (uint64_t)k->inv_alpha_q16;
+
+  for (i = 0; i < MLX90632_CALC_MAX_ITERATIONS; ++i) {
+    g_q30 = gb_q30 + (((int64_t)k->Ga * (temp_q16 - T_REF_Q16)) >> 22);
+    if (g_q30 <= 0) {
+      break;
+    }
+
+    // STO / (alpha * (1 + g)) in Q16 K^4
+    quotient = mag / (uint64_t)g_q30;
+    remainder = mag % (uint64_t)g_q30;
+    fa_q16 = (int64_t)((quotient << 30)
+                       + ((remainder << 30) / (uint64_t)g_q30));
+    if (object < 0) {
+      fa_q16 = -fa_q16;
+    }
+    fa_q16 += ta4_q16;
+    if (fa_q16 < 0) {
+      fa_q16 = 0;
+    }
+
+    // Q16 K^4 -> Q8 K^2 -> Q16 K
+    k2_q8 = isqrt64((uint64_t)fa_q16);
+    next_q16 = (int64_t)isqrt64(k2_q8 << 24) - KELVIN_OFFSET_Q16 - k->hb_q16;
+
+    diff = next_q16 - temp_q16;
+    temp_q16 = next_q16;
+    if ((diff < MLX90632_CALC_CONVERGENCE_Q16)
+        && (diff > -MLX90632_CALC_CONVERGENCE_Q16)) {
+      break;
+    }
+  }
+
+  return (int32_t)temp_q16;
+}
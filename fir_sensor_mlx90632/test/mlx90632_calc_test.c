@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ * @file  mlx90632_calc_test.c
+ * @brief Host test of the MLX90632 temperature calculations.
+ *
+ * Compares the single precision and fixed-point object temperature against
+ * the double precision reference over a grid of raw measurements.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc mlx90632_calc_test.c ../src/mlx90632_calc.c -lm
+ *   ./a.out
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <mlx90632_calc.h>
+
+// Allowed deviation from the double precision reference in Celsius
+#define MAX_ERROR_FLOAT   (0.01)
+#define MAX_ERROR_FIXED   (0.01)
+
+// Calibration constants of a sample device
+static const mlx90632_eeprom_t eeprom = {
+  .P_R = 0x00587f5b,
+  .P_G = 0x04a10289,
+  .P_T = (int32_t)0xfff966f8,
+  .P_O = 0x00001e0f,
+  .Ea = 4859535,
+  .Eb = 5686508,
+  .Fa = 53855361,
+  .Fb = 42874149,
+  .Ga = -14769360,
+  .Gb = 9728,
+  .Ka = 10752,
+  .Ha = 16384,
+  .Hb = 0,
+};
+
+/***************************************************************************//**
+ * Object temperature calculation as it was done before the constants were
+ * cached, used to check that the reference did not change.
+ ******************************************************************************/
+static double legacy_calc_temp_object(int32_t object, int32_t ambient,
+                                      const mlx90632_eeprom_t *ee)
+{
+  double kEa, kEb, TAdut, TAdut4, Ha_customer, Hb_customer;
+  double calcedGa, calcedGb, calcedFa, Alpha_corr;
+  double temp = 25.0;
+  int8_t i;
+
+  kEa = ((double)ee->Ea) / ((double)65536.0);
+  kEb = ((double)ee->Eb) / ((double)256.0);
+  TAdut = (((double)ambient) - kEb) / kEa + 25;
+
+  for (i = 0; i < 5; ++i) {
+    Ha_customer = ee->Ha / ((double)16384.0);
+    Hb_customer = ee->Hb / ((double)16384.0);
+    calcedGa = ((double)ee->Ga * (temp - 25)) / ((double)68719476736.0);
+    calcedGb = ((double)ee->Fb * (TAdut - 25)) / ((double)68719476736.0);
+    Alpha_corr = (((double)(ee->Fa * 10000000000LL)) * Ha_customer
+                  * (double)(1 + calcedGa + calcedGb))
+                 / ((double)70368744177664.0);
+    calcedFa = object / (Alpha_corr / 10000000000LL);
+    TAdut4 = (TAdut + 273.15) * (TAdut + 273.15)
+             * (TAdut + 273.15) * (TAdut + 273.15);
+    temp = sqrt(sqrt(calcedFa + TAdut4)) - 273.15 - Hb_customer;
+  }
+
+  return temp;
+}
+
+int main(void)
+{
+  mlx90632_calc_const_t k;
+  double ref, legacy, err;
+  double max_legacy = 0, max_float = 0, max_fixed = 0;
+  int32_t amb, obj, amb_q8, obj_int;
+  int16_t amb_new, amb_old, obj_raw;
+  unsigned long cases = 0;
+  int failed = 0;
+
+  mlx90632_calc_init_constants(&eeprom, &k);
+
+  for (amb_new = 21000; amb_new <= 24000; amb_new += 250) {
+    for (amb_old = 21000; amb_old <= 24000; amb_old += 500) {
+      for (obj_raw = -3000; obj_raw <= 6000; obj_raw += 37) {
+        amb = (int32_t)mlx90632_calc_preprocess_ambient(&k, amb_new, amb_old);
+        obj = (int32_t)mlx90632_calc_preprocess_object(&k, obj_raw, obj_raw,
+                                                       amb_new, amb_old);
+        amb_q8 = mlx90632_calc_preprocess_ambient_q8(&k, amb_new, amb_old);
+        obj_int = mlx90632_calc_preprocess_object_int(&k, obj_raw, obj_raw,
+                                                      amb_new, amb_old);
+
+        ref = mlx90632_calc_temp_object(&k, obj, amb);
+        if (isnan(ref)) {
+          continue;
+        }
+        cases++;
+
+        legacy = legacy_calc_temp_object(obj, amb, &eeprom);
+        err = fabs(ref - legacy);
+        max_legacy = err > max_legacy ? err : max_legacy;
+
+        err = fabs(ref - mlx90632_calc_temp_object_f(&k, obj_int,
+                                                     amb_q8 / 256));
+        max_float = err > max_float ? err : max_float;
+
+        err = fabs(ref - mlx90632_calc_temp_object_q16(&k, obj_int,
+                                                       amb_q8 / 256)
+                   / 65536.0);
+        max_fixed = err > max_fixed ? err : max_fixed;
+
+        err = fabs(mlx90632_calc_temp_ambient(&k,
+                     mlx90632_calc_preprocess_ambient(&k, amb_new, amb_old))
+                   - mlx90632_calc_temp_ambient_q16(&k, amb_q8) / 65536.0);
+        if (err > MAX_ERROR_FIXED) {
+          printf("ambient mismatch at %d/%d: %f\n", amb_new, amb_old, err);
+          failed = 1;
+        }
+      }
+    }
+  }
+
+  printf("cases: %lu\n", cases);
+  printf("max error legacy: %.6f C\n", max_legacy);
+  printf("max error float:  %.6f C\n", max_float);
+  printf("max error fixed:  %.6f C\n", max_fixed);
+
+  if ((cases == 0) || (max_legacy > 1e-9)
+      || (max_float > MAX_ERROR_FLOAT) || (max_fixed > MAX_ERROR_FIXED)) {
+    failed = 1;
+  }
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
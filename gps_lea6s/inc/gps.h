@@ -43,6 +43,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "sl_status.h"
+#include "gps_nmea.h"
+#include "gps_ubx.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,21 +71,6 @@ typedef enum {
   WEST
 } gps_cardinal_t;
 
-// Container for the UTC time
-typedef struct {
-  uint8_t hour;
-  uint8_t min;
-  uint8_t sec;
-  uint16_t millisec;
-} gps_utctime_t;
-
-// Container for the UTC data
-typedef struct {
-  uint8_t day;
-  uint8_t month;
-  uint8_t year;
-} gps_utcdate_t;
-
 // Container for all the gps data that is parsed from the RMC NMEA sentence.
 typedef struct {
   gps_utctime_t utctime;      ///< UTC Time
@@ -105,13 +92,26 @@ typedef struct {
   uint16_t tx_buffer_size;    ///> Size of TX buffer
 } gps_init_t;
 
+// Receive path counters
+typedef struct {
+  uint32_t rx_overruns;       ///< Characters dropped because the RX buffer
+                              ///<   was full
+  uint32_t sentences;         ///< Sentences with a valid checksum
+  uint32_t checksum_errors;   ///< Sentences dropped on checksum mismatch
+  uint32_t format_errors;     ///< Sentences dropped as too long or malformed
+  uint32_t ubx_frames;        ///< UBX frames with a valid checksum
+  uint32_t ubx_checksum_errors; ///< UBX frames dropped on checksum mismatch
+  uint32_t ubx_length_errors; ///< UBX frames dropped on a bad length
+} gps_statistics_t;
+
 
 /***************************************************************************//**
  * @brief
- *    Excluding the <CR><LF> characters, a single NMEA sentence will never be
- *    more than 80 characters long.
+ *    Default size of the RX buffer. The buffer holds the received characters
+ *    until gps_process_action() parses them, 256 characters are more than
+ *    250 ms at 9600 baud.
  ******************************************************************************/
-#define NMEA_MAX_LENGTH       80
+#define GPS_RX_BUFFER_SIZE    256
 
 
 /***************************************************************************//**
@@ -123,10 +123,9 @@ typedef struct {
  *    default init struct data.
  *
  * @note
- *    Excluding the <CR><LF> characters, the buffer length should be at least
- *    80 characters long.
+ *    The RX buffer length should be at least 80 characters long.
  ******************************************************************************/
-#define GPS_DECLARE_RX_BUFFER   static char gps_rx_buffer[NMEA_MAX_LENGTH];
+#define GPS_DECLARE_RX_BUFFER   static char gps_rx_buffer[GPS_RX_BUFFER_SIZE];
 #define GPS_DECLARE_TX_BUFFER   static char gps_tx_buffer[NMEA_MAX_LENGTH];
 
 
@@ -144,7 +143,7 @@ typedef struct {
 #define GPS_INIT_DEFAULT                                                      \
   {                                                                           \
     gps_rx_buffer,         /* buffer ptr for uart receive operations. */      \
-    NMEA_MAX_LENGTH,       /* buffer size */                                  \
+    GPS_RX_BUFFER_SIZE,    /* buffer size */                                  \
     gps_tx_buffer,         /* buffer ptr for uart transmit operations. */     \
     NMEA_MAX_LENGTH        /* buffer size */                                  \
   }
@@ -172,6 +171,12 @@ sl_status_t gps_init(gps_init_t *init);
  *    Call this often in the while loop to check and process the received in the
  *    foreground. Do not call in an interrupt handler.
  *
+ * @note
+ *    All the characters received since the last call are parsed. RMC, GGA,
+ *    GSA, GSV and VTG sentences and UBX NAV-PVT, NAV-POSLLH, NAV-SOL and
+ *    NAV-VELNED messages with a valid checksum are merged into the fix. UBX
+ *    acknowledges are handled as well.
+ *
  * @return
  *    SL_STATUS_OK                  If new data was processed.
  *    SL_STATUS_IS_WAITING          If there is no new data.
@@ -196,6 +201,36 @@ sl_status_t gps_process_action(void);
 sl_status_t gps_get_data(gps_data_t *data);
 
 
+/***************************************************************************//**
+ * @brief
+ *    Get the most recent fix merged from all the supported NMEA sentences.
+ *
+ * @note
+ *    The updated field tells which sentences were merged since the previous
+ *    call, it is cleared by this function.
+ *
+ * @param[out] fix
+ *    GPS fix with fixed-point coordinates
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_get_fix(gps_fix_t *fix);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the receive path counters.
+ *
+ * @param[out] stats
+ *    Counters since gps_init()
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_get_statistics(gps_statistics_t *stats);
+
+
 /***************************************************************************//**
  * @brief
  *    Send NMEA command to gps module.
@@ -214,6 +249,108 @@ sl_status_t gps_get_data(gps_data_t *data);
 sl_status_t gps_send_cmd(char *cmd);
 
 
+/***************************************************************************//**
+ * @brief
+ *    Send a UBX message to the gps module.
+ *
+ * @note
+ *    CFG messages start waiting for an acknowledge, see gps_ubx_get_ack().
+ *    A message with an empty payload polls the message from the receiver.
+ *
+ * @param[in] msg_class
+ *    Message class
+ *
+ * @param[in] msg_id
+ *    Message ID
+ *
+ * @param[in] payload
+ *    Message payload, may be NULL if length is 0
+ *
+ * @param[in] length
+ *    Payload length, at most the TX buffer size minus 8
+ *
+ * @return
+ *    SL_STATUS_OK              If the frame is being transmitted.
+ *    SL_STATUS_BUSY            If previous data is still being transmitted or
+ *                              a CFG message waits for its acknowledge.
+ *    SL_STATUS_WOULD_OVERFLOW  If the frame does not fit in the TX buffer.
+ ******************************************************************************/
+sl_status_t gps_ubx_send(uint8_t msg_class,
+                         uint8_t msg_id,
+                         const uint8_t *payload,
+                         uint16_t length);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the output rate of a message with CFG-MSG.
+ *
+ * @param[in] msg_class
+ *    Class of the configured message, e.g. GPS_UBX_CLASS_NAV. NMEA sentences
+ *    are class 0xF0.
+ *
+ * @param[in] msg_id
+ *    ID of the configured message
+ *
+ * @param[in] rate
+ *    Output once every rate navigation solutions, 0 disables the message
+ *
+ * @return
+ *    Error status, see gps_ubx_send()
+ ******************************************************************************/
+sl_status_t gps_ubx_config_msg(uint8_t msg_class, uint8_t msg_id, uint8_t rate);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the navigation solution period with CFG-RATE.
+ *
+ * @param[in] meas_rate_ms
+ *    Measurement period in ms, 200 for 5 Hz
+ *
+ * @return
+ *    Error status, see gps_ubx_send()
+ ******************************************************************************/
+sl_status_t gps_ubx_config_rate(uint16_t meas_rate_ms);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Select the protocols of the receiver UART with CFG-PRT.
+ *
+ * @note
+ *    The baud rate stays 9600, the highest rate the EUART can receive in EM2.
+ *
+ * @param[in] in_proto
+ *    GPS_UBX_PROTO_xxx accepted by the receiver
+ *
+ * @param[in] out_proto
+ *    GPS_UBX_PROTO_xxx output by the receiver
+ *
+ * @return
+ *    Error status, see gps_ubx_send()
+ ******************************************************************************/
+sl_status_t gps_ubx_config_prt(uint16_t in_proto, uint16_t out_proto);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the acknowledge of the last UBX configuration message.
+ *
+ * @note
+ *    The acknowledge is received by gps_process_action().
+ *
+ * @return
+ *    SL_STATUS_OK                  If the message was acknowledged.
+ *    SL_STATUS_IN_PROGRESS         If the acknowledge is pending.
+ *    SL_STATUS_FAIL                If the message was rejected.
+ *    SL_STATUS_TIMEOUT             If there was no acknowledge within
+ *                                  GPS_UBX_ACK_TIMEOUT_MS.
+ *    SL_STATUS_INVALID_STATE       If no configuration message was sent.
+ ******************************************************************************/
+sl_status_t gps_ubx_get_ack(void);
+
+
 /***************************************************************************//**
  * @brief
  *    Enable or disable to LDO power. Useful to power cycle and reset the GPS
@@ -53,6 +53,15 @@ extern "C" {
 #define GPS_EUART_RX_PORT   gpioPortB
 #define GPS_EUART_RX_PIN    2
 
+// Satellites in view kept from the GSV sentences
+#define GPS_NMEA_MAX_SATELLITES   16
+
+// Largest UBX payload kept, NAV-PVT is 92 bytes
+#define GPS_UBX_MAX_PAYLOAD       100
+
+// Time the receiver has to acknowledge a UBX configuration message
+#define GPS_UBX_ACK_TIMEOUT_MS    1000
+
 #ifdef __cplusplus
 }
 #endif
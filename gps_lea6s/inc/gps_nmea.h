@@ -0,0 +1,198 @@
+/***************************************************************************//**
+ * @file gps_nmea.h
+ * @brief NMEA 0183 parser for the GPS driver.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef GPS_NMEA_H_
+#define GPS_NMEA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "gps_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup GPS
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief
+ *    Excluding the <CR><LF> characters, a single NMEA sentence will never be
+ *    more than 80 characters long.
+ ******************************************************************************/
+#define NMEA_MAX_LENGTH       80
+
+// Most fields in a supported sentence (GSV), including the address field
+#define GPS_NMEA_MAX_FIELDS   21
+
+// Satellites used in a fix, as reported by GSA
+#define GPS_NMEA_MAX_USED     12
+
+// Sentences merged into the fix
+#define GPS_NMEA_RMC          0x01
+#define GPS_NMEA_GGA          0x02
+#define GPS_NMEA_GSA          0x04
+#define GPS_NMEA_GSV          0x08
+#define GPS_NMEA_VTG          0x10
+
+// Container for the UTC time
+typedef struct {
+  uint8_t hour;
+  uint8_t min;
+  uint8_t sec;
+  uint16_t millisec;
+} gps_utctime_t;
+
+// Container for the UTC data
+typedef struct {
+  uint8_t day;
+  uint8_t month;
+  uint8_t year;
+} gps_utcdate_t;
+
+// Satellite in view, from GSV
+typedef struct {
+  uint8_t prn;                ///< Satellite PRN number
+  int8_t elevation_deg;       ///< Elevation in degrees
+  uint16_t azimuth_deg;       ///< Azimuth in degrees from true north
+  uint8_t snr_dbhz;           ///< C/N0 in dBHz, 0 if not tracked
+} gps_satellite_t;
+
+// Navigation data merged from the RMC, GGA, GSA, GSV and VTG sentences and
+// the UBX NAV messages.
+// Fractional values are fixed-point integers, the suffix gives the unit.
+typedef struct {
+  gps_utctime_t utctime;      ///< UTC Time
+  gps_utcdate_t utcdate;      ///< UTC Date
+  bool valid;                 ///< RMC status of data (valid=1, warning=0)
+  uint8_t quality;            ///< GGA fix quality, 0 if no fix
+  uint8_t mode;               ///< GSA fix mode, 1 none, 2 2D, 3 3D
+  uint8_t sats_used;          ///< GGA number of satellites used
+  int32_t latitude_e7;        ///< Latitude in 1e-7 degrees, south negative
+  int32_t longitude_e7;       ///< Longitude in 1e-7 degrees, west negative
+  int32_t altitude_mm;        ///< GGA altitude above mean sea level in mm
+  int32_t geoid_sep_mm;       ///< GGA geoid separation in mm
+  uint32_t speed_mknots;      ///< Speed over ground in 1/1000 knots
+  uint32_t speed_mkmh;        ///< VTG speed over ground in 1/1000 km/h
+  uint16_t course_cdeg;       ///< Course over ground in 1/100 degrees
+  int16_t mag_var_cdeg;       ///< Magnetic variation in 1/100 degrees,
+                              ///<   west negative
+  uint16_t pdop_e2;           ///< GSA position dilution of precision x100
+  uint16_t hdop_e2;           ///< Horizontal dilution of precision x100
+  uint16_t vdop_e2;           ///< GSA vertical dilution of precision x100
+  uint32_t h_acc_mm;          ///< UBX horizontal accuracy estimate in mm,
+                              ///<   0 if not reported
+  uint32_t v_acc_mm;          ///< UBX vertical accuracy estimate in mm,
+                              ///<   0 if not reported
+  uint8_t used_prn[GPS_NMEA_MAX_USED]; ///< GSA PRN of satellites used
+  uint8_t sats_in_view;       ///< GSV number of satellites in view
+  gps_satellite_t sats[GPS_NMEA_MAX_SATELLITES]; ///< GSV satellites, at most
+                                                 ///<   sats_in_view are valid
+  uint16_t updated;           ///< GPS_NMEA_xxx sentences and GPS_UBX_xxx
+                              ///<   messages merged since the application
+                              ///<   last cleared it
+} gps_fix_t;
+
+// Parser state, one per byte stream
+typedef struct {
+  gps_fix_t *fix;             ///< Fix updated by the parser
+  uint8_t state;              ///< Position in the sentence
+  uint8_t checksum;           ///< XOR of the characters so far
+  uint8_t received_checksum;  ///< Checksum of the *hh field
+  uint8_t length;             ///< Characters in the sentence buffer
+  uint8_t fields;             ///< Fields in the sentence buffer
+  uint8_t field[GPS_NMEA_MAX_FIELDS]; ///< Start of each field
+  char sentence[NMEA_MAX_LENGTH + 1]; ///< Fields of the current sentence,
+                                      ///<   NUL separated
+  gps_satellite_t gsv[GPS_NMEA_MAX_SATELLITES]; ///< GSV group being received
+  uint8_t gsv_next;           ///< Next expected GSV message number
+  uint32_t sentences;         ///< Sentences with a valid checksum
+  uint32_t checksum_errors;   ///< Sentences dropped on checksum mismatch
+  uint32_t format_errors;     ///< Sentences dropped as too long or malformed
+} gps_nmea_parser_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Initializes a NMEA parser.
+ *
+ * @param[out] parser
+ *    Parser state
+ *
+ * @param[in] fix
+ *    Fix updated by the parser
+ ******************************************************************************/
+void gps_nmea_init(gps_nmea_parser_t *parser, gps_fix_t *fix);
+
+/***************************************************************************//**
+ * @brief
+ *    Feeds received characters to the parser.
+ *
+ * @note
+ *    The characters are tokenized in a single pass and the checksum is
+ *    computed on the fly. A sentence is merged into the fix only if its
+ *    checksum matches. Anything outside of a sentence is skipped, so the
+ *    stream can be fed in chunks of any size.
+ *
+ * @param[in,out] parser
+ *    Parser state
+ *
+ * @param[in] data
+ *    Received characters
+ *
+ * @param[in] len
+ *    Number of characters
+ *
+ * @return
+ *    GPS_NMEA_xxx sentences merged into the fix
+ ******************************************************************************/
+uint8_t gps_nmea_process(gps_nmea_parser_t *parser,
+                         const uint8_t *data,
+                         size_t len);
+
+/** @} (end addtogroup GPS) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPS_NMEA_H_ */
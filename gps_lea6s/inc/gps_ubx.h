@@ -0,0 +1,337 @@
+/***************************************************************************//**
+ * @file gps_ubx.h
+ * @brief UBX binary protocol for the GPS driver.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef GPS_UBX_H_
+#define GPS_UBX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "gps_config.h"
+#include "gps_nmea.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup GPS
+ * @{
+ ******************************************************************************/
+
+// Frame synchronization characters
+#define GPS_UBX_SYNC_CHAR_1       0xB5
+#define GPS_UBX_SYNC_CHAR_2       0x62
+
+// Sync characters, class, ID and length before the payload, checksum after it
+#define GPS_UBX_HEADER_LENGTH     6
+#define GPS_UBX_FRAME_OVERHEAD    8
+
+// Message classes
+#define GPS_UBX_CLASS_NAV         0x01
+#define GPS_UBX_CLASS_ACK         0x05
+#define GPS_UBX_CLASS_CFG         0x06
+
+// Message IDs
+#define GPS_UBX_ID_NAV_POSLLH     0x02
+#define GPS_UBX_ID_NAV_SOL        0x06
+#define GPS_UBX_ID_NAV_PVT        0x07
+#define GPS_UBX_ID_NAV_VELNED     0x12
+#define GPS_UBX_ID_ACK_NAK        0x00
+#define GPS_UBX_ID_ACK_ACK        0x01
+#define GPS_UBX_ID_CFG_PRT        0x00
+#define GPS_UBX_ID_CFG_MSG        0x01
+#define GPS_UBX_ID_CFG_RATE       0x08
+
+// CFG-PRT protocol masks
+#define GPS_UBX_PROTO_UBX         0x0001
+#define GPS_UBX_PROTO_NMEA        0x0002
+
+// Messages merged into the fix, next to the GPS_NMEA_xxx sentences
+#define GPS_UBX_NAV_PVT           0x0020
+#define GPS_UBX_NAV_POSLLH        0x0040
+#define GPS_UBX_NAV_SOL           0x0080
+#define GPS_UBX_NAV_VELNED        0x0100
+
+// Acknowledge of the last configuration message
+#define GPS_UBX_ACK_NONE          0   ///< No configuration message sent
+#define GPS_UBX_ACK_PENDING       1   ///< Waiting for ACK-ACK or ACK-NAK
+#define GPS_UBX_ACK_ACKED         2   ///< ACK-ACK received
+#define GPS_UBX_ACK_NAKED         3   ///< ACK-NAK received
+#define GPS_UBX_ACK_TIMEOUT       4   ///< Nothing received in time
+
+// Parser state, one per byte stream
+typedef struct {
+  gps_fix_t *fix;             ///< Fix updated by the parser
+  uint8_t state;              ///< Position in the frame
+  uint8_t ck_a;               ///< Fletcher checksum of the frame so far
+  uint8_t ck_b;
+  uint8_t msg_class;          ///< Class of the current or last frame
+  uint8_t msg_id;             ///< ID of the current or last frame
+  uint16_t length;            ///< Payload length of the current or last frame
+  uint16_t index;             ///< Payload bytes received
+  uint8_t payload[GPS_UBX_MAX_PAYLOAD]; ///< Payload of the current or last
+                                        ///<   frame
+  uint8_t ack_class;          ///< Message an acknowledge is expected for
+  uint8_t ack_id;
+  uint8_t ack_state;          ///< GPS_UBX_ACK_xxx
+  uint32_t frames;            ///< Frames with a valid checksum
+  uint32_t checksum_errors;   ///< Frames dropped on checksum mismatch
+  uint32_t length_errors;     ///< Frames dropped as longer than the payload
+                              ///<   buffer or shorter than the message
+} gps_ubx_parser_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Initializes a UBX parser.
+ *
+ * @param[out] parser
+ *    Parser state
+ *
+ * @param[in] fix
+ *    Fix updated by the parser
+ ******************************************************************************/
+void gps_ubx_init(gps_ubx_parser_t *parser, gps_fix_t *fix);
+
+/***************************************************************************//**
+ * @brief
+ *    Feeds received bytes to the parser up to the end of a frame.
+ *
+ * @note
+ *    The parser stops after the last byte of a frame, and before a byte that
+ *    does not continue the sync characters, so that the caller can hand the
+ *    rest of the stream to the NMEA parser. NAV messages with a valid checksum
+ *    are merged into the fix, and ACK messages complete the pending
+ *    acknowledge.
+ *
+ * @param[in,out] parser
+ *    Parser state
+ *
+ * @param[in] data
+ *    Received bytes
+ *
+ * @param[in] len
+ *    Number of bytes
+ *
+ * @param[out] merged
+ *    GPS_UBX_xxx messages merged into the fix are added to it
+ *
+ * @return
+ *    Number of bytes consumed
+ ******************************************************************************/
+size_t gps_ubx_process(gps_ubx_parser_t *parser,
+                       const uint8_t *data,
+                       size_t len,
+                       uint16_t *merged);
+
+/***************************************************************************//**
+ * @brief
+ *    Checks if the parser is inside a frame.
+ *
+ * @param[in] parser
+ *    Parser state
+ *
+ * @return
+ *    True once the first sync character was received until the end of frame
+ ******************************************************************************/
+bool gps_ubx_in_frame(const gps_ubx_parser_t *parser);
+
+/***************************************************************************//**
+ * @brief
+ *    Splits a receiver output stream between the UBX and the NMEA parser.
+ *
+ * @note
+ *    Outside of a UBX frame, everything up to the next 0xB5 sync character is
+ *    NMEA text, which starts with '$' and never contains 0xB5.
+ *
+ * @param[in,out] ubx
+ *    UBX parser state
+ *
+ * @param[in,out] nmea
+ *    NMEA parser state
+ *
+ * @param[in] data
+ *    Received bytes
+ *
+ * @param[in] len
+ *    Number of bytes
+ *
+ * @return
+ *    GPS_NMEA_xxx sentences and GPS_UBX_xxx messages merged into the fix
+ ******************************************************************************/
+uint16_t gps_ubx_demux(gps_ubx_parser_t *ubx,
+                       gps_nmea_parser_t *nmea,
+                       const uint8_t *data,
+                       size_t len);
+
+/***************************************************************************//**
+ * @brief
+ *    Starts waiting for the acknowledge of a configuration message.
+ *
+ * @param[in,out] parser
+ *    Parser state
+ *
+ * @param[in] msg_class
+ *    Class of the message sent
+ *
+ * @param[in] msg_id
+ *    ID of the message sent
+ ******************************************************************************/
+void gps_ubx_expect_ack(gps_ubx_parser_t *parser,
+                        uint8_t msg_class,
+                        uint8_t msg_id);
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a UBX frame.
+ *
+ * @param[out] frame
+ *    Frame buffer
+ *
+ * @param[in] size
+ *    Size of the frame buffer
+ *
+ * @param[in] msg_class
+ *    Message class
+ *
+ * @param[in] msg_id
+ *    Message ID
+ *
+ * @param[in] payload
+ *    Message payload, may be NULL if length is 0
+ *
+ * @param[in] length
+ *    Payload length
+ *
+ * @return
+ *    Frame length, 0 if it does not fit in the buffer
+ ******************************************************************************/
+uint16_t gps_ubx_frame(uint8_t *frame,
+                       uint16_t size,
+                       uint8_t msg_class,
+                       uint8_t msg_id,
+                       const uint8_t *payload,
+                       uint16_t length);
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-MSG frame setting the output rate of a message on the port
+ *    the frame is received on.
+ *
+ * @param[out] frame
+ *    Frame buffer
+ *
+ * @param[in] size
+ *    Size of the frame buffer
+ *
+ * @param[in] msg_class
+ *    Class of the configured message
+ *
+ * @param[in] msg_id
+ *    ID of the configured message
+ *
+ * @param[in] rate
+ *    Output once every rate navigation solutions, 0 disables the message
+ *
+ * @return
+ *    Frame length, 0 if it does not fit in the buffer
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_msg(uint8_t *frame,
+                               uint16_t size,
+                               uint8_t msg_class,
+                               uint8_t msg_id,
+                               uint8_t rate);
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-RATE frame setting the measurement period, with one
+ *    navigation solution per measurement aligned to UTC.
+ *
+ * @param[out] frame
+ *    Frame buffer
+ *
+ * @param[in] size
+ *    Size of the frame buffer
+ *
+ * @param[in] meas_rate_ms
+ *    Measurement period in ms, 200 for 5 Hz
+ *
+ * @return
+ *    Frame length, 0 if it does not fit in the buffer
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_rate(uint8_t *frame,
+                                uint16_t size,
+                                uint16_t meas_rate_ms);
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-PRT frame configuring UART1 of the receiver for 8N1.
+ *
+ * @param[out] frame
+ *    Frame buffer
+ *
+ * @param[in] size
+ *    Size of the frame buffer
+ *
+ * @param[in] baudrate
+ *    Baud rate
+ *
+ * @param[in] in_proto
+ *    GPS_UBX_PROTO_xxx accepted by the receiver
+ *
+ * @param[in] out_proto
+ *    GPS_UBX_PROTO_xxx output by the receiver
+ *
+ * @return
+ *    Frame length, 0 if it does not fit in the buffer
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_prt(uint8_t *frame,
+                               uint16_t size,
+                               uint32_t baudrate,
+                               uint16_t in_proto,
+                               uint16_t out_proto);
+
+/** @} (end addtogroup GPS) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPS_UBX_H_ */
@@ -40,29 +40,26 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
-#include <stdio.h>
-#include <stdlib.h>
 
 #include "em_cmu.h"
 #include "em_eusart.h"
 #include "em_gpio.h"
 #include "em_core.h"
 #include "sl_status.h"
+#include "sl_sleeptimer.h"
 
 #include "gps.h"
 #include "gps_config.h"
 
-//#define GPS_NMEA_GNRMC_ID     "GNRMC"   // Only one supported
-#define GPS_NMEA_START_TOK_LEN  7
-
 typedef struct {
-  volatile char *rx_buffer_ptr;       // Pointer to store rx data.
-  volatile uint16_t rx_buffer_idx;    // Index to place next received character.
+  volatile char *rx_buffer_ptr;       // Ring of received characters.
   uint16_t rx_buffer_size;            // Size of rx data buffer.
-  volatile bool rx_is_complete;       // Indicator that a full NMEA sentence has
-                                      //    been received through interrupt.
-  volatile bool rx_processed;         // Indicator that a full NMEA sentence has
-                                      //    been processed by application.
+  volatile uint16_t rx_head;          // Index to place next received
+                                      //    character, written by the ISR.
+  volatile uint16_t rx_tail;          // Index of next character to parse,
+                                      //    written by the application.
+  volatile uint32_t rx_overruns;      // Characters dropped because the ring
+                                      //    was full.
 
   volatile char *tx_buffer_ptr;       // Pointer to store tx data.
   volatile uint16_t tx_buffer_idx;    // Index of next character to transmit.
@@ -71,10 +68,18 @@ typedef struct {
   volatile bool tx_busy;              // Indicator that data is currently being
                                       //    transmitted.
 
+  gps_nmea_parser_t nmea;             // NMEA tokenizer state.
+  gps_ubx_parser_t ubx;               // UBX framing state.
+  uint32_t ack_start;                 // Tick the pending UBX configuration
+                                      //    message was sent at.
+  gps_fix_t fix;                      // Fix merged from all the sentences.
   gps_data_t latest_data;             // Holds the latest gps data that was
                                       //    received and processed.
 } gps_handle_t;
 
+// Default baud rate of the receiver
+#define GPS_BAUDRATE  9600
+
 static gps_handle_t handle;
 
 
@@ -108,7 +113,7 @@ static void init_euart(void)
   CMU_ClockEnable(cmuClock_EUART0, true);
 
   EUSART_UartInit_TypeDef euartInit = EUSART_UART_INIT_DEFAULT_LF;
-  euartInit.baudrate = 9600;  // <=9600 baud can only operate in EM2
+  euartInit.baudrate = GPS_BAUDRATE;  // <=9600 baud can only operate in EM2
 
   EUSART_UartInitLf(EUART0, &euartInit);
 
@@ -136,300 +141,147 @@ static void init_gpio(void)
 
 /***************************************************************************//**
  * @brief
- *    Formats the string into the gps data struct.
- *
- * @param[in] degmin
- *    Degrees minutes float value
+ *    Updates the legacy RMC data from the fix.
  *
- * @param[in] cardinal
- *    NORTH, SOUTH, EAST, WEST
+ * @param[in] fix
+ *    Fix merged from the NMEA sentences
  *
- * @return
- *    Decimal degree float value
+ * @param[out] gps
+ *    RMC data with floating point values
  ******************************************************************************/
-static float convert_degmin_to_decdeg(float degmin, gps_cardinal_t cardinal)
+static void update_rmc_data(const gps_fix_t *fix, gps_data_t *gps)
 {
-  int32_t deg = 0;
-  float min = 0;
-  float sign = 1;
-
-  deg = degmin / 100;   // dddmm.mmmm (extract and mask deg = ddd)
-  min = degmin - (deg * 100);
-
-  if(cardinal == SOUTH || cardinal == WEST) {
-      sign = -1;
+  gps->utctime = fix->utctime;
+  gps->utcdate = fix->utcdate;
+  gps->status = fix->valid;
+  gps->latitude_decdeg = fix->latitude_e7 / 1e7f;
+  gps->longitude_decdeg = fix->longitude_e7 / 1e7f;
+  gps->speed_knots = fix->speed_mknots / 1000.0f;
+  gps->course_deg = fix->course_cdeg / 100.0f;
+  if(fix->mag_var_cdeg < 0) {
+    gps->mag_var_deg = -fix->mag_var_cdeg / 100.0f;
+    gps->mag_var_ew = WEST;
+  } else {
+    gps->mag_var_deg = fix->mag_var_cdeg / 100.0f;
+    gps->mag_var_ew = EAST;
   }
-
-  // .d = M.m / 60
-  // Decimal Degrees = Degrees + .d
-  return sign * (deg + min / 60);
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Checks if a nmea start key has been received. The first character of a
- *    nmea sentence is always '$'.
+ *    Stores a received character in the RX ring.
  *
  * @param[in] nmea_char
  *    Next received character
- *
- * @return
- *    True if '$', false if not
  ******************************************************************************/
-static bool nmea_is_start(char nmea_char)
+static void process_char(char nmea_char)
 {
-  if(nmea_char == '$') {
-    return true;
+  uint16_t next = handle.rx_head + 1;
+
+  if(next == handle.rx_buffer_size) {
+    next = 0;
+  }
+
+  // One slot stays free to tell a full ring from an empty one
+  if(next == handle.rx_tail) {
+    handle.rx_overruns++;
+    return;
   }
-  return false;
+
+  handle.rx_buffer_ptr[handle.rx_head] = nmea_char;
+  handle.rx_head = next;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Checks if the token in the nmea sentence is empty or not.
+ *    Starts transmitting the content of the TX buffer.
  *
- * @param[in] nmea_tok
- *    NMEA sentence token
+ * @param[in] length
+ *    Number of bytes to transmit
+ ******************************************************************************/
+static void start_tx(uint16_t length)
+{
+  handle.tx_buffer_out_size = length;
+  handle.tx_buffer_idx = 0;
+  handle.tx_busy = true;
+
+  EUSART_IntEnable(EUART0, EUSART_IEN_TXFLIEN);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Gets the acknowledge state of the last UBX configuration message.
  *
  * @return
- *    True if empty, false if not
+ *    GPS_UBX_ACK_xxx, a pending acknowledge turns into a timeout after
+ *    GPS_UBX_ACK_TIMEOUT_MS
  ******************************************************************************/
-static bool nmea_is_empty(char *nmea_tok)
+static uint8_t ubx_ack_state(void)
 {
-  if(nmea_tok == NULL) {
-    return true;
-  }
+  uint32_t elapsed;
 
-  if(*nmea_tok == ',') {
-    return true;
+  if(handle.ubx.ack_state == GPS_UBX_ACK_PENDING) {
+    elapsed = sl_sleeptimer_get_tick_count() - handle.ack_start;
+    if(elapsed > sl_sleeptimer_ms_to_tick(GPS_UBX_ACK_TIMEOUT_MS)) {
+      handle.ubx.ack_state = GPS_UBX_ACK_TIMEOUT;
+    }
   }
-
-  return false;
+  return handle.ubx.ack_state;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Formats the string into the gps data struct based on the RMC NMEA ID.
- *
- * @param[in] nmea_str
- *    NMEA sentence string
+ *    Sends a UBX frame built in the TX buffer.
  *
- * @param[out] gps
- *    Formatted data from string
+ * @param[in] length
+ *    Frame length, 0 if the frame did not fit in the TX buffer
  *
  * @return
  *    Error status
  ******************************************************************************/
-static sl_status_t nmea_format(char *nmea_str, gps_data_t *gps)
+static sl_status_t ubx_send_frame(uint16_t length)
 {
+  const uint8_t *frame = (const uint8_t *)handle.tx_buffer_ptr;
 
-  if(nmea_str == NULL || gps == NULL) {
-    return SL_STATUS_INVALID_PARAMETER;
+  if(length == 0) {
+    return SL_STATUS_WOULD_OVERFLOW;
   }
 
-  sl_status_t sc = SL_STATUS_IS_WAITING;
-
-  // Helper variables that will be processed to convert to appropriate types.
-  int32_t tmp_int = 0;
-  float tmp_float = 0;
-  gps_cardinal_t tmp_cardinal = NORTH;
-  char *value_tok = nmea_str;
-
-  if(strstr(value_tok, "RMC") != NULL) {
-    // Grab individual variables from nmea string
-    // RMC Recommended Minimum Navigation Information
-    //                                                              12
-    //        1         2 3       4 5        6  7   8   9      10 11|  13
-    //        |         | |       | |        |  |   |   |      |  | |   |
-    //$--RMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,xxxxxx,x.x,a,m,*hh<CR><LF>
-    // 1) Time (UTC)
-    // 2) Status, V = Navigation receiver warning
-    // 3) Latitude
-    // 4) N or S
-    // 5) Longitude
-    // 6) E or W
-    // 7) Speed over ground, knots
-    // 8) Track made good, degrees true
-    // 9) Date, ddmmyy
-    // 10) Magnetic Variation, degrees
-    // 11) E or W
-    // 12) Checksum
-
-    // At this point, the RMC start id is already taken out so first token is
-    // UTC Time (1)
-
-    //--------
-    // 1) UTC time token: hhmmss.sss
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_float = atof(value_tok);
-
-      // Change to fixed pt to avoid float err.
-      tmp_int = tmp_float * 1000;
-
-      // hhmmss[sss]
-      gps->utctime.millisec = tmp_int % 1000;
-      tmp_int /= 1000;    // Shift right by 3 (dec) digits
-
-      // hhmmss
-      gps->utctime.sec = tmp_int % 100;
-      tmp_int /= 100;     // Shift right by 2 (dec) digits
-
-      // hhmm
-      gps->utctime.min = tmp_int % 100;
-      tmp_int /= 100;     // Shift right by 2 (dec) digits
-
-      // hh
-      gps->utctime.hour = tmp_int;
-
-    } else {
-      // Epoch Time: 00:00:00 1 Jan 1970
-      gps->utctime.hour = 0;
-      gps->utctime.min = 0;
-      gps->utctime.sec = 0;
-      gps->utctime.millisec = 0;
-    }
-
-    //--------
-    // 2) Status token: 'A' for data valid, 'V' for data invalid
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    gps->status = (*value_tok == 'A') ? true : false;
-
-    //--------
-    // 3,4) Latitude token: ddmm.mmmm [N or S]
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_float = atof(value_tok);
-    } else {
-      tmp_float = 0;  // default
-    }
-
-    // [N or S]
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_cardinal = (*value_tok == 'N') ? NORTH : SOUTH;
-    } else {
-      tmp_cardinal = NORTH; // default
-    }
-
-    gps->latitude_decdeg = convert_degmin_to_decdeg(tmp_float, tmp_cardinal);
-
-    //--------
-    // 5,6) Longitude token: ddmm.mmmm [E or W]
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_float = atof(value_tok);
-    } else {
-      tmp_float = 0;  // default
-    }
-
-    // [W or W]
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_cardinal = (*value_tok == 'E') ? EAST : WEST;
-    } else {
-      tmp_cardinal = EAST; // default
-    }
-
-    gps->longitude_decdeg = convert_degmin_to_decdeg(tmp_float, tmp_cardinal);
-
-    //--------
-    // 7) Speed token: float
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      gps->speed_knots = atof(value_tok);
-    } else {
-      gps->speed_knots = 0;
-    }
-
-    //--------
-    // 8) Course token: float
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      gps->course_deg = atof(value_tok);
-    } else {
-      gps->course_deg = 0;
-    }
-
-    //--------
-    // 9) UTC date token: ddmmyy
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      tmp_int = atoi(value_tok);
-      gps->utcdate.year = tmp_int % 100;
-      tmp_int /= 100;
-      gps->utcdate.month = tmp_int % 100;
-      tmp_int /= 100;
-      gps->utcdate.day = tmp_int;
-
-    } else {
-      // Epoch Time: 00:00:00 1 Jan 1970
-      gps->utcdate.day = 1;
-      gps->utcdate.month = 1;
-      gps->utcdate.year = 70;
-    }
-
-    //--------
-    // 10,11) Magnetic variation token: float
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      gps->mag_var_deg = atof(value_tok);
-    } else {
-      gps->mag_var_deg = 0;
-    }
-
-    value_tok = strchr(value_tok, ',') + 1; // Get next token location
-    if(!nmea_is_empty(value_tok)) {
-      gps->mag_var_ew = (*value_tok == 'E') ? EAST : WEST;
-    } else {
-      gps->mag_var_ew = EAST; // default
-    }
-
-    sc = SL_STATUS_OK;
+  // The receiver acknowledges every CFG message
+  if(frame[2] == GPS_UBX_CLASS_CFG) {
+    gps_ubx_expect_ack(&handle.ubx, frame[2], frame[3]);
+    handle.ack_start = sl_sleeptimer_get_tick_count();
   }
 
-  return sc;
+  start_tx(length);
+  return SL_STATUS_OK;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Checks if a nmea start key has been received. The first character of a
- *    nmea sentence is always '$'.
+ *    Checks that a UBX frame can be built in the TX buffer.
  *
- * @param[in] nmea_char
- *    Next received character
+ * @return
+ *    Error status
  ******************************************************************************/
-static void process_char(char nmea_char)
+static sl_status_t ubx_check_tx(void)
 {
-  static bool is_data_valid = false;
-
-  if(is_data_valid && !nmea_is_start(nmea_char)) {
-
-    // Check for overflow
-    if(handle.rx_buffer_idx < handle.rx_buffer_size) {
-      handle.rx_buffer_ptr[handle.rx_buffer_idx++] = nmea_char;
-      handle.rx_is_complete = false;
-
-      // Check if entire desired nmea sentence have been recorded.
-      if(nmea_char == '\n') {
-        handle.rx_processed = false;
-        handle.rx_is_complete = true;
-        handle.rx_buffer_idx = 0;
-        is_data_valid = false;
-      }
-    }
+  // tx buffer was not initialized.
+  if(handle.tx_buffer_ptr == NULL) {
+    return SL_STATUS_INVALID_HANDLE;
   }
 
-  // Each NMEA sentence starts with '$' so when that character is seen, the
-  // following bytes should be recorded.
-  else if(nmea_is_start(nmea_char)) {
-    is_data_valid = true;
+  // Only one configuration message is tracked at a time
+  if(handle.tx_busy || (ubx_ack_state() == GPS_UBX_ACK_PENDING)) {
+    return SL_STATUS_BUSY;
   }
 
+  return SL_STATUS_OK;
 }
 
 
@@ -451,20 +303,24 @@ sl_status_t gps_init(gps_init_t *init)
     return SL_STATUS_INVALID_PARAMETER;
   }
 
-  init_gpio();
-  init_euart();
-
   handle.rx_buffer_ptr = init->rx_buffer_ptr;
   handle.rx_buffer_size = init->rx_buffer_size;
-  handle.rx_buffer_idx = 0;
-  handle.rx_is_complete = false;
-  handle.rx_processed = false;
+  handle.rx_head = 0;
+  handle.rx_tail = 0;
+  handle.rx_overruns = 0;
+
+  memset(&handle.fix, 0, sizeof(handle.fix));
+  gps_nmea_init(&handle.nmea, &handle.fix);
+  gps_ubx_init(&handle.ubx, &handle.fix);
 
   handle.tx_buffer_ptr = init->tx_buffer_ptr;
   handle.tx_buffer_max_size = init->tx_buffer_size;
   handle.tx_buffer_out_size = 0;
   handle.tx_buffer_idx = 0;
 
+  init_gpio();
+  init_euart();
+
   return SL_STATUS_OK;
 }
 
@@ -483,13 +339,27 @@ sl_status_t gps_init(gps_init_t *init)
  ******************************************************************************/
 sl_status_t gps_process_action(void)
 {
-  if(!handle.rx_processed & handle.rx_is_complete) {
-    handle.rx_processed = true;
-    handle.rx_is_complete = false;
-    return nmea_format((char *)handle.rx_buffer_ptr, &handle.latest_data);
+  uint16_t head = handle.rx_head;
+  uint16_t tail = handle.rx_tail;
+  uint16_t end;
+  uint16_t merged = 0;
+
+  // Parse the ring in at most two contiguous chunks
+  while(tail != head) {
+    end = (head > tail) ? head : handle.rx_buffer_size;
+    merged |= gps_ubx_demux(&handle.ubx, &handle.nmea,
+                            (const uint8_t *)&handle.rx_buffer_ptr[tail],
+                            end - tail);
+    tail = (end == handle.rx_buffer_size) ? 0 : end;
+    handle.rx_tail = tail;
+  }
+
+  if(merged & (GPS_NMEA_RMC | GPS_UBX_NAV_PVT | GPS_UBX_NAV_POSLLH
+               | GPS_UBX_NAV_SOL | GPS_UBX_NAV_VELNED)) {
+    update_rmc_data(&handle.fix, &handle.latest_data);
   }
 
-  return SL_STATUS_IS_WAITING;
+  return (merged != 0) ? SL_STATUS_OK : SL_STATUS_IS_WAITING;
 }
 
 
@@ -518,6 +388,55 @@ sl_status_t gps_get_data(gps_data_t *data)
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *    Get the most recent fix merged from all the supported NMEA sentences.
+ *
+ * @param[out] fix
+ *    GPS fix with fixed-point coordinates
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_get_fix(gps_fix_t *fix)
+{
+  if(fix == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  memcpy(fix, &handle.fix, sizeof(gps_fix_t));
+  handle.fix.updated = 0;
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the receive path counters.
+ *
+ * @param[out] stats
+ *    Counters since gps_init()
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_get_statistics(gps_statistics_t *stats)
+{
+  if(stats == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  stats->rx_overruns = handle.rx_overruns;
+  stats->sentences = handle.nmea.sentences;
+  stats->checksum_errors = handle.nmea.checksum_errors;
+  stats->format_errors = handle.nmea.format_errors;
+  stats->ubx_frames = handle.ubx.frames;
+  stats->ubx_checksum_errors = handle.ubx.checksum_errors;
+  stats->ubx_length_errors = handle.ubx.length_errors;
+  return SL_STATUS_OK;
+}
+
+
 /***************************************************************************//**
  * @brief
  *    Send NMEA command to gps module.
@@ -556,11 +475,7 @@ sl_status_t gps_send_cmd(char *cmd)
     }
 
     memcpy((char *)handle.tx_buffer_ptr, cmd, out_size);
-    handle.tx_buffer_out_size = out_size;
-
-    handle.tx_busy = true;
-
-    EUSART_IntEnable(EUART0, EUSART_IEN_TXFLIEN);
+    start_tx(out_size);
 
     return SL_STATUS_OK;
   }
@@ -569,6 +484,163 @@ sl_status_t gps_send_cmd(char *cmd)
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *    Send a UBX message to the gps module.
+ *
+ * @param[in] msg_class
+ *    Message class
+ *
+ * @param[in] msg_id
+ *    Message ID
+ *
+ * @param[in] payload
+ *    Message payload, may be NULL if length is 0
+ *
+ * @param[in] length
+ *    Payload length
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_ubx_send(uint8_t msg_class,
+                         uint8_t msg_id,
+                         const uint8_t *payload,
+                         uint16_t length)
+{
+  sl_status_t status;
+
+  if(payload == NULL && length > 0) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = ubx_check_tx();
+  if(status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return ubx_send_frame(gps_ubx_frame((uint8_t *)handle.tx_buffer_ptr,
+                                      handle.tx_buffer_max_size,
+                                      msg_class, msg_id, payload, length));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the output rate of a message with CFG-MSG.
+ *
+ * @param[in] msg_class
+ *    Class of the configured message
+ *
+ * @param[in] msg_id
+ *    ID of the configured message
+ *
+ * @param[in] rate
+ *    Output once every rate navigation solutions, 0 disables the message
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_ubx_config_msg(uint8_t msg_class, uint8_t msg_id, uint8_t rate)
+{
+  sl_status_t status = ubx_check_tx();
+
+  if(status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return ubx_send_frame(gps_ubx_frame_cfg_msg((uint8_t *)handle.tx_buffer_ptr,
+                                              handle.tx_buffer_max_size,
+                                              msg_class, msg_id, rate));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the navigation solution period with CFG-RATE.
+ *
+ * @param[in] meas_rate_ms
+ *    Measurement period in ms, 200 for 5 Hz
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_ubx_config_rate(uint16_t meas_rate_ms)
+{
+  sl_status_t status = ubx_check_tx();
+
+  if(status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return ubx_send_frame(gps_ubx_frame_cfg_rate((uint8_t *)handle.tx_buffer_ptr,
+                                               handle.tx_buffer_max_size,
+                                               meas_rate_ms));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Select the protocols of the receiver UART with CFG-PRT.
+ *
+ * @note
+ *    The baud rate stays 9600, the highest rate the EUART can receive in EM2.
+ *
+ * @param[in] in_proto
+ *    GPS_UBX_PROTO_xxx accepted by the receiver
+ *
+ * @param[in] out_proto
+ *    GPS_UBX_PROTO_xxx output by the receiver
+ *
+ * @return
+ *    Error status
+ ******************************************************************************/
+sl_status_t gps_ubx_config_prt(uint16_t in_proto, uint16_t out_proto)
+{
+  sl_status_t status = ubx_check_tx();
+
+  if(status != SL_STATUS_OK) {
+    return status;
+  }
+
+  return ubx_send_frame(gps_ubx_frame_cfg_prt((uint8_t *)handle.tx_buffer_ptr,
+                                              handle.tx_buffer_max_size,
+                                              GPS_BAUDRATE,
+                                              in_proto, out_proto));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the acknowledge of the last UBX configuration message.
+ *
+ * @note
+ *    The acknowledge is received by gps_process_action().
+ *
+ * @return
+ *    SL_STATUS_OK                  If the message was acknowledged.
+ *    SL_STATUS_IN_PROGRESS         If the acknowledge is pending.
+ *    SL_STATUS_FAIL                If the message was rejected.
+ *    SL_STATUS_TIMEOUT             If there was no acknowledge in time.
+ *    SL_STATUS_INVALID_STATE       If no configuration message was sent.
+ ******************************************************************************/
+sl_status_t gps_ubx_get_ack(void)
+{
+  switch(ubx_ack_state()) {
+    case GPS_UBX_ACK_ACKED:
+      return SL_STATUS_OK;
+    case GPS_UBX_ACK_PENDING:
+      return SL_STATUS_IN_PROGRESS;
+    case GPS_UBX_ACK_NAKED:
+      return SL_STATUS_FAIL;
+    case GPS_UBX_ACK_TIMEOUT:
+      return SL_STATUS_TIMEOUT;
+    default:
+      return SL_STATUS_INVALID_STATE;
+  }
+}
+
+
 /***************************************************************************//**
  * @brief
  *    Enable or disable to LDO power. Useful to power cycle and reset the GPS
@@ -602,7 +674,10 @@ void EUART0_RX_IRQHandler(void)
 {
   uint32_t flags = EUSART_IntGet(EUART0);
   if(flags & EUSART_IF_RXFLIF) {
+    // Empty the FIFO, parsing is left to gps_process_action()
+    while(EUART0->STATUS & EUSART_STATUS_RXFL) {
       process_char((char)(EUART0->RXDATA));
+    }
   }
 
   EUSART_IntClear(EUART0, flags);
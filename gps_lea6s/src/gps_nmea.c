@@ -0,0 +1,692 @@
+/***************************************************************************//**
+ * @file gps_nmea.c
+ * @brief NMEA 0183 parser for the GPS driver
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "gps_nmea.h"
+
+// Parser states
+#define NMEA_STATE_IDLE       0   // Waiting for '$'
+#define NMEA_STATE_BODY       1   // Between '$' and '*'
+#define NMEA_STATE_CHECKSUM_H 2   // First checksum digit
+#define NMEA_STATE_CHECKSUM_L 3   // Second checksum digit
+
+// Length of the address field, talker and sentence formatter
+#define NMEA_ADDRESS_LEN      5
+
+#define NMEA_DEG_E7           10000000L
+
+
+/***************************************************************************//**
+ * @brief
+ *    Gets a field of the current sentence.
+ *
+ * @param[in] parser
+ *    Parser state
+ *
+ * @param[in] index
+ *    Field index, 0 is the address field
+ *
+ * @return
+ *    NUL terminated field, empty if the sentence has less fields
+ ******************************************************************************/
+static const char *nmea_field(const gps_nmea_parser_t *parser, uint8_t index)
+{
+  if(index >= parser->fields) {
+    return "";
+  }
+  return &parser->sentence[parser->field[index]];
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Converts a hexadecimal checksum digit.
+ *
+ * @param[in] c
+ *    Character
+ *
+ * @return
+ *    Digit value, or -1 if not a hexadecimal digit
+ ******************************************************************************/
+static int8_t nmea_hex_digit(uint8_t c)
+{
+  if(c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if(c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if(c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Parses a decimal number into a fixed-point integer.
+ *
+ * @param[in] str
+ *    Field such as "-12.345"
+ *
+ * @param[in] decimals
+ *    Number of decimals of the result, further digits are rounded
+ *
+ * @param[out] value
+ *    Number scaled by 10^decimals
+ *
+ * @return
+ *    False if the field is empty or not a number
+ ******************************************************************************/
+static bool nmea_parse_fixed(const char *str, uint8_t decimals, int32_t *value)
+{
+  int32_t result = 0;
+  uint8_t frac = 0;
+  bool negative = false;
+  bool in_frac = false;
+  bool digits = false;
+  bool round_up = false;
+  bool rounded = false;
+
+  if(*str == '-') {
+    negative = true;
+    str++;
+  }
+
+  for(; *str != '\0'; str++) {
+    if(*str == '.' && !in_frac) {
+      in_frac = true;
+      continue;
+    }
+    if(*str < '0' || *str > '9') {
+      return false;
+    }
+    digits = true;
+    if(in_frac) {
+      if(frac == decimals) {
+        // First digit beyond the precision decides the rounding
+        if(!rounded) {
+          round_up = (*str >= '5');
+          rounded = true;
+        }
+        continue;
+      }
+      frac++;
+    }
+    result = result * 10 + (*str - '0');
+  }
+
+  if(!digits) {
+    return false;
+  }
+  for(; frac < decimals; frac++) {
+    result *= 10;
+  }
+  if(round_up) {
+    result++;
+  }
+
+  *value = negative ? -result : result;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Parses a coordinate into 1e-7 degrees.
+ *
+ * @param[in] str
+ *    Coordinate field: dddmm.mmmmm
+ *
+ * @param[in] hemisphere
+ *    Hemisphere field: N, S, E or W
+ *
+ * @param[out] value
+ *    Coordinate in 1e-7 degrees, south and west negative
+ *
+ * @return
+ *    False if a field is empty or malformed
+ ******************************************************************************/
+static bool nmea_parse_degmin(const char *str,
+                              const char *hemisphere,
+                              int32_t *value)
+{
+  uint32_t whole = 0;
+  uint32_t frac_e7 = 0;
+  uint32_t scale = NMEA_DEG_E7 / 10;
+  uint32_t minutes_e7;
+  bool in_frac = false;
+  bool digits = false;
+
+  for(; *str != '\0'; str++) {
+    if(*str == '.' && !in_frac) {
+      in_frac = true;
+      continue;
+    }
+    if(*str < '0' || *str > '9') {
+      return false;
+    }
+    digits = true;
+    if(!in_frac) {
+      whole = whole * 10 + (*str - '0');
+    } else {
+      // Minutes fraction in 1e-7, further digits are below the resolution
+      frac_e7 += (*str - '0') * scale;
+      scale /= 10;
+    }
+  }
+  if(!digits || whole > 18000) {
+    return false;
+  }
+
+  // Decimal Degrees = Degrees + Minutes / 60
+  minutes_e7 = (whole % 100) * NMEA_DEG_E7 + frac_e7;
+  *value = (int32_t)((whole / 100) * NMEA_DEG_E7 + (minutes_e7 + 30) / 60);
+
+  switch(hemisphere[0]) {
+    case 'S':
+    case 'W':
+      *value = -*value;
+      return true;
+    case 'N':
+    case 'E':
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Parses the UTC time field.
+ *
+ * @param[in] str
+ *    UTC time field: hhmmss.ss
+ *
+ * @param[out] fix
+ *    Fix to update
+ ******************************************************************************/
+static void nmea_parse_time(const char *str, gps_fix_t *fix)
+{
+  int32_t value;
+
+  if(nmea_parse_fixed(str, 3, &value) && value >= 0) {
+    // hhmmss[sss]
+    fix->utctime.millisec = value % 1000;
+    value /= 1000;
+    fix->utctime.sec = value % 100;
+    value /= 100;
+    fix->utctime.min = value % 100;
+    fix->utctime.hour = value / 100;
+  } else {
+    // Epoch Time: 00:00:00 1 Jan 1970
+    fix->utctime.hour = 0;
+    fix->utctime.min = 0;
+    fix->utctime.sec = 0;
+    fix->utctime.millisec = 0;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Parses a fixed-point field, or stores 0 if it is empty.
+ ******************************************************************************/
+static int32_t nmea_fixed_or_zero(const char *str, uint8_t decimals)
+{
+  int32_t value;
+
+  if(!nmea_parse_fixed(str, decimals, &value)) {
+    value = 0;
+  }
+  return value;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a RMC sentence into the fix.
+ *
+ * @details
+ *    RMC Recommended Minimum Navigation Information
+ *    $--RMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,xxxxxx,x.x,a,m,*hh
+ *    1) Time (UTC)
+ *    2) Status, V = Navigation receiver warning
+ *    3,4) Latitude, N or S
+ *    5,6) Longitude, E or W
+ *    7) Speed over ground, knots
+ *    8) Track made good, degrees true
+ *    9) Date, ddmmyy
+ *    10,11) Magnetic Variation, degrees, E or W
+ *    12) Mode indicator, NMEA 2.3 and later
+ *
+ * @return
+ *    False if the sentence is malformed
+ ******************************************************************************/
+static bool nmea_parse_rmc(gps_nmea_parser_t *parser, gps_fix_t *fix)
+{
+  int32_t value;
+
+  if(parser->fields < 12) {
+    return false;
+  }
+
+  nmea_parse_time(nmea_field(parser, 1), fix);
+  fix->valid = (nmea_field(parser, 2)[0] == 'A');
+
+  if(!nmea_parse_degmin(nmea_field(parser, 3), nmea_field(parser, 4),
+                        &fix->latitude_e7)) {
+    fix->latitude_e7 = 0;
+  }
+  if(!nmea_parse_degmin(nmea_field(parser, 5), nmea_field(parser, 6),
+                        &fix->longitude_e7)) {
+    fix->longitude_e7 = 0;
+  }
+
+  fix->speed_mknots = (uint32_t)nmea_fixed_or_zero(nmea_field(parser, 7), 3);
+  fix->course_cdeg = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 8), 2);
+
+  if(nmea_parse_fixed(nmea_field(parser, 9), 0, &value) && value >= 0) {
+    // ddmmyy
+    fix->utcdate.year = value % 100;
+    value /= 100;
+    fix->utcdate.month = value % 100;
+    fix->utcdate.day = value / 100;
+  } else {
+    // Epoch Time: 00:00:00 1 Jan 1970
+    fix->utcdate.day = 1;
+    fix->utcdate.month = 1;
+    fix->utcdate.year = 70;
+  }
+
+  value = nmea_fixed_or_zero(nmea_field(parser, 10), 2);
+  if(nmea_field(parser, 11)[0] == 'W') {
+    value = -value;
+  }
+  fix->mag_var_cdeg = (int16_t)value;
+
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a GGA sentence into the fix.
+ *
+ * @details
+ *    GGA Global Positioning System Fix Data
+ *    $--GGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,x.x,xxxx*hh
+ *    1) Time (UTC)
+ *    2,3) Latitude, N or S
+ *    4,5) Longitude, E or W
+ *    6) Fix quality, 0 = no fix
+ *    7) Number of satellites used
+ *    8) Horizontal dilution of precision
+ *    9,10) Altitude above mean sea level, meters
+ *    11,12) Geoid separation, meters
+ *    13) Age of differential corrections
+ *    14) Differential station ID
+ *
+ * @return
+ *    False if the sentence is malformed
+ ******************************************************************************/
+static bool nmea_parse_gga(gps_nmea_parser_t *parser, gps_fix_t *fix)
+{
+  if(parser->fields < 15) {
+    return false;
+  }
+
+  nmea_parse_time(nmea_field(parser, 1), fix);
+
+  if(!nmea_parse_degmin(nmea_field(parser, 2), nmea_field(parser, 3),
+                        &fix->latitude_e7)) {
+    fix->latitude_e7 = 0;
+  }
+  if(!nmea_parse_degmin(nmea_field(parser, 4), nmea_field(parser, 5),
+                        &fix->longitude_e7)) {
+    fix->longitude_e7 = 0;
+  }
+
+  fix->quality = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 6), 0);
+  fix->sats_used = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 7), 0);
+  fix->hdop_e2 = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 8), 2);
+  fix->altitude_mm = nmea_fixed_or_zero(nmea_field(parser, 9), 3);
+  fix->geoid_sep_mm = nmea_fixed_or_zero(nmea_field(parser, 11), 3);
+
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a GSA sentence into the fix.
+ *
+ * @details
+ *    GSA GNSS DOP and Active Satellites
+ *    $--GSA,a,x,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,x.x,x.x,x.x*hh
+ *    1) Selection mode, M = manual, A = automatic
+ *    2) Mode, 1 = no fix, 2 = 2D, 3 = 3D
+ *    3-14) PRN of the satellites used
+ *    15) Position dilution of precision
+ *    16) Horizontal dilution of precision
+ *    17) Vertical dilution of precision
+ *
+ * @return
+ *    False if the sentence is malformed
+ ******************************************************************************/
+static bool nmea_parse_gsa(gps_nmea_parser_t *parser, gps_fix_t *fix)
+{
+  uint8_t i;
+
+  if(parser->fields < 18) {
+    return false;
+  }
+
+  fix->mode = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 2), 0);
+  for(i = 0; i < GPS_NMEA_MAX_USED; i++) {
+    fix->used_prn[i] = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 3 + i),
+                                                   0);
+  }
+  fix->pdop_e2 = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 15), 2);
+  fix->hdop_e2 = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 16), 2);
+  fix->vdop_e2 = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 17), 2);
+
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Collects a GSV sentence, the satellites are merged into the fix with the
+ *    last sentence of the group.
+ *
+ * @details
+ *    GSV GNSS Satellites in View
+ *    $--GSV,x,x,xx,xx,xx,xxx,xx,....,xx,xx,xxx,xx*hh
+ *    1) Number of sentences in the group
+ *    2) Sentence number
+ *    3) Number of satellites in view
+ *    4-7) PRN, elevation, azimuth and C/N0 of a satellite, repeated for up
+ *         to 4 satellites
+ *
+ * @param[out] merged
+ *    Set to GPS_NMEA_GSV if the group is complete
+ *
+ * @return
+ *    False if the sentence is malformed
+ ******************************************************************************/
+static bool nmea_parse_gsv(gps_nmea_parser_t *parser,
+                           gps_fix_t *fix,
+                           uint8_t *merged)
+{
+  gps_satellite_t *sat;
+  int32_t total, number, in_view;
+  uint8_t i, index;
+
+  if(parser->fields < 4
+     || !nmea_parse_fixed(nmea_field(parser, 1), 0, &total)
+     || !nmea_parse_fixed(nmea_field(parser, 2), 0, &number)
+     || !nmea_parse_fixed(nmea_field(parser, 3), 0, &in_view)
+     || number < 1 || number > total || in_view < 0 || in_view > 255) {
+    return false;
+  }
+
+  // A group is only merged if all its sentences were received in order
+  if(number == 1) {
+    parser->gsv_next = 1;
+  }
+  if(number != parser->gsv_next) {
+    parser->gsv_next = 0;
+    return true;
+  }
+
+  for(i = 0; i < 4; i++) {
+    index = (uint8_t)((number - 1) * 4 + i);
+    if(index >= in_view || index >= GPS_NMEA_MAX_SATELLITES
+       || (4 + 4 * i) >= parser->fields) {
+      break;
+    }
+    sat = &parser->gsv[index];
+    sat->prn = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 4 + 4 * i), 0);
+    sat->elevation_deg = (int8_t)nmea_fixed_or_zero(nmea_field(parser,
+                                                               5 + 4 * i),
+                                                    0);
+    sat->azimuth_deg = (uint16_t)nmea_fixed_or_zero(nmea_field(parser,
+                                                               6 + 4 * i),
+                                                    0);
+    sat->snr_dbhz = (uint8_t)nmea_fixed_or_zero(nmea_field(parser, 7 + 4 * i),
+                                                0);
+  }
+  parser->gsv_next++;
+
+  if(number == total) {
+    index = (in_view < GPS_NMEA_MAX_SATELLITES)
+            ? (uint8_t)in_view : GPS_NMEA_MAX_SATELLITES;
+    memcpy(fix->sats, parser->gsv, index * sizeof(gps_satellite_t));
+    fix->sats_in_view = (uint8_t)in_view;
+    parser->gsv_next = 0;
+    *merged = GPS_NMEA_GSV;
+  }
+
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a VTG sentence into the fix.
+ *
+ * @details
+ *    VTG Course Over Ground and Ground Speed
+ *    $--VTG,x.x,T,x.x,M,x.x,N,x.x,K,m*hh
+ *    1,2) Course over ground, degrees true
+ *    3,4) Course over ground, degrees magnetic
+ *    5,6) Speed over ground, knots
+ *    7,8) Speed over ground, km/h
+ *    9) Mode indicator, NMEA 2.3 and later
+ *
+ * @return
+ *    False if the sentence is malformed
+ ******************************************************************************/
+static bool nmea_parse_vtg(gps_nmea_parser_t *parser, gps_fix_t *fix)
+{
+  if(parser->fields < 9) {
+    return false;
+  }
+
+  fix->course_cdeg = (uint16_t)nmea_fixed_or_zero(nmea_field(parser, 1), 2);
+  fix->speed_mknots = (uint32_t)nmea_fixed_or_zero(nmea_field(parser, 5), 3);
+  fix->speed_mkmh = (uint32_t)nmea_fixed_or_zero(nmea_field(parser, 7), 3);
+
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a complete sentence with a valid checksum into the fix.
+ *
+ * @param[in,out] parser
+ *    Parser state
+ *
+ * @return
+ *    GPS_NMEA_xxx sentence merged, 0 if none
+ ******************************************************************************/
+static uint8_t nmea_dispatch(gps_nmea_parser_t *parser)
+{
+  const char *address = nmea_field(parser, 0);
+  gps_fix_t *fix = parser->fix;
+  uint8_t merged = 0;
+  bool ok = true;
+
+  parser->sentences++;
+
+  // Any talker, only the sentence formatter is checked
+  if(strlen(address) != NMEA_ADDRESS_LEN) {
+    parser->format_errors++;
+    return 0;
+  }
+  address += 2;
+
+  if(memcmp(address, "RMC", 3) == 0) {
+    ok = nmea_parse_rmc(parser, fix);
+    merged = GPS_NMEA_RMC;
+  } else if(memcmp(address, "GGA", 3) == 0) {
+    ok = nmea_parse_gga(parser, fix);
+    merged = GPS_NMEA_GGA;
+  } else if(memcmp(address, "GSA", 3) == 0) {
+    ok = nmea_parse_gsa(parser, fix);
+    merged = GPS_NMEA_GSA;
+  } else if(memcmp(address, "GSV", 3) == 0) {
+    ok = nmea_parse_gsv(parser, fix, &merged);
+  } else if(memcmp(address, "VTG", 3) == 0) {
+    ok = nmea_parse_vtg(parser, fix);
+    merged = GPS_NMEA_VTG;
+  }
+
+  if(!ok) {
+    parser->format_errors++;
+    return 0;
+  }
+  fix->updated |= merged;
+  return merged;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initializes a NMEA parser.
+ ******************************************************************************/
+void gps_nmea_init(gps_nmea_parser_t *parser, gps_fix_t *fix)
+{
+  memset(parser, 0, sizeof(*parser));
+  parser->fix = fix;
+  parser->state = NMEA_STATE_IDLE;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Feeds received characters to the parser.
+ ******************************************************************************/
+uint8_t gps_nmea_process(gps_nmea_parser_t *parser,
+                         const uint8_t *data,
+                         size_t len)
+{
+  uint8_t merged = 0;
+  uint8_t c;
+  int8_t digit;
+
+  while(len-- > 0) {
+    c = *data++;
+
+    // Each NMEA sentence starts with '$', even in the middle of another one
+    if(c == '$') {
+      parser->state = NMEA_STATE_BODY;
+      parser->checksum = 0;
+      parser->length = 0;
+      parser->fields = 1;
+      parser->field[0] = 0;
+      continue;
+    }
+
+    switch(parser->state) {
+      case NMEA_STATE_BODY:
+        if(c == '*') {
+          parser->sentence[parser->length] = '\0';
+          parser->state = NMEA_STATE_CHECKSUM_H;
+        } else if(c < 0x20 || c > 0x7E
+                  || parser->length >= NMEA_MAX_LENGTH) {
+          // Line ended without checksum, or garbage
+          parser->format_errors++;
+          parser->state = NMEA_STATE_IDLE;
+        } else if(c == ',') {
+          if(parser->fields >= GPS_NMEA_MAX_FIELDS) {
+            parser->format_errors++;
+            parser->state = NMEA_STATE_IDLE;
+            break;
+          }
+          parser->checksum ^= c;
+          parser->sentence[parser->length++] = '\0';
+          parser->field[parser->fields++] = parser->length;
+        } else {
+          parser->checksum ^= c;
+          parser->sentence[parser->length++] = (char)c;
+        }
+        break;
+
+      case NMEA_STATE_CHECKSUM_H:
+        digit = nmea_hex_digit(c);
+        if(digit < 0) {
+          parser->format_errors++;
+          parser->state = NMEA_STATE_IDLE;
+          break;
+        }
+        parser->received_checksum = (uint8_t)(digit << 4);
+        parser->state = NMEA_STATE_CHECKSUM_L;
+        break;
+
+      case NMEA_STATE_CHECKSUM_L:
+        digit = nmea_hex_digit(c);
+        parser->state = NMEA_STATE_IDLE;
+        if(digit < 0) {
+          parser->format_errors++;
+          break;
+        }
+        parser->received_checksum |= (uint8_t)digit;
+        if(parser->received_checksum != parser->checksum) {
+          parser->checksum_errors++;
+          break;
+        }
+        merged |= nmea_dispatch(parser);
+        break;
+
+      default:
+        // Skip anything outside of a sentence
+        break;
+    }
+  }
+
+  return merged;
+}
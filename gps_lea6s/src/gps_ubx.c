@@ -0,0 +1,629 @@
+/***************************************************************************//**
+ * @file gps_ubx.c
+ * @brief UBX binary protocol for the GPS driver
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with
+ * the specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "gps_ubx.h"
+
+// Parser states
+#define UBX_STATE_SYNC_1      0   // Waiting for 0xB5
+#define UBX_STATE_SYNC_2      1   // Waiting for 0x62
+#define UBX_STATE_CLASS       2
+#define UBX_STATE_ID          3
+#define UBX_STATE_LENGTH_L    4
+#define UBX_STATE_LENGTH_H    5
+#define UBX_STATE_PAYLOAD     6
+#define UBX_STATE_CK_A        7
+#define UBX_STATE_CK_B        8
+
+// Smallest payload of the decoded messages
+#define UBX_LEN_NAV_POSLLH    28
+#define UBX_LEN_NAV_SOL       52
+#define UBX_LEN_NAV_PVT       84  // u-blox 7, u-blox 8 appends 8 bytes
+#define UBX_LEN_NAV_PVT_MAG   92  // With the magnetic declination
+#define UBX_LEN_NAV_VELNED    36
+#define UBX_LEN_ACK           2
+#define UBX_LEN_CFG_MSG       3
+#define UBX_LEN_CFG_RATE      6
+#define UBX_LEN_CFG_PRT       20
+
+// NAV-PVT valid and flags bits
+#define UBX_PVT_VALID_DATE    0x01
+#define UBX_PVT_VALID_TIME    0x02
+#define UBX_PVT_VALID_MAG     0x08
+#define UBX_PVT_GNSS_FIX_OK   0x01
+
+// NAV-SOL flags bits
+#define UBX_SOL_GPS_FIX_OK    0x01
+
+// CFG-PRT
+#define UBX_PRT_PORT_UART1    1
+#define UBX_PRT_MODE_8N1      0x000008D0
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reads a little endian unsigned 16-bit field.
+ ******************************************************************************/
+static uint16_t ubx_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reads a little endian unsigned 32-bit field.
+ ******************************************************************************/
+static uint32_t ubx_u32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+         | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reads a little endian signed 32-bit field.
+ ******************************************************************************/
+static int32_t ubx_i32(const uint8_t *p)
+{
+  return (int32_t)ubx_u32(p);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Writes a little endian 16-bit field.
+ ******************************************************************************/
+static void ubx_put_u16(uint8_t *p, uint16_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Writes a little endian 32-bit field.
+ ******************************************************************************/
+static void ubx_put_u32(uint8_t *p, uint32_t value)
+{
+  ubx_put_u16(p, (uint16_t)value);
+  ubx_put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Converts a UBX heading in 1e-5 degrees to 1/100 degrees.
+ ******************************************************************************/
+static uint16_t ubx_course_cdeg(int32_t heading_e5)
+{
+  uint32_t cdeg;
+
+  if(heading_e5 < 0) {
+    return 0;
+  }
+  cdeg = ((uint32_t)heading_e5 + 500) / 1000;
+  return (cdeg >= 36000) ? 0 : (uint16_t)cdeg;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Converts a UBX fix type to the GSA fix mode.
+ ******************************************************************************/
+static uint8_t ubx_fix_mode(uint8_t fix_type)
+{
+  switch(fix_type) {
+    case 2:
+      return 2;
+    case 3:
+    case 4:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a NAV-PVT message.
+ *
+ * @param[in] p
+ *    Payload
+ *
+ * @param[in] length
+ *    Payload length
+ *
+ * @param[out] fix
+ *    Fix to update
+ ******************************************************************************/
+static void ubx_parse_nav_pvt(const uint8_t *p, uint16_t length, gps_fix_t *fix)
+{
+  uint8_t valid = p[11];
+  int32_t nano = ubx_i32(&p[16]);
+  int32_t height = ubx_i32(&p[32]);
+  int32_t hmsl = ubx_i32(&p[36]);
+  uint32_t speed = (uint32_t)ubx_i32(&p[60]);   // mm/s
+
+  if(valid & UBX_PVT_VALID_TIME) {
+    fix->utctime.hour = p[8];
+    fix->utctime.min = p[9];
+    fix->utctime.sec = p[10];
+    // The fraction may be negative while the receiver rounds to the second
+    fix->utctime.millisec = (nano > 0) ? (uint16_t)((nano + 500000) / 1000000)
+                                       : 0;
+    if(fix->utctime.millisec > 999) {
+      fix->utctime.millisec = 999;
+    }
+  }
+  if(valid & UBX_PVT_VALID_DATE) {
+    fix->utcdate.day = p[7];
+    fix->utcdate.month = p[6];
+    fix->utcdate.year = (uint8_t)(ubx_u16(&p[4]) % 100);
+  }
+
+  fix->valid = (p[21] & UBX_PVT_GNSS_FIX_OK) != 0;
+  fix->quality = fix->valid ? 1 : 0;
+  fix->mode = ubx_fix_mode(p[20]);
+  fix->sats_used = p[23];
+  fix->longitude_e7 = ubx_i32(&p[24]);
+  fix->latitude_e7 = ubx_i32(&p[28]);
+  fix->altitude_mm = hmsl;
+  fix->geoid_sep_mm = height - hmsl;
+  fix->h_acc_mm = ubx_u32(&p[40]);
+  fix->v_acc_mm = ubx_u32(&p[44]);
+  fix->speed_mknots = (uint32_t)(((uint64_t)speed * 3600 + 926) / 1852);
+  fix->speed_mkmh = (uint32_t)(((uint64_t)speed * 36 + 5) / 10);
+  fix->course_cdeg = ubx_course_cdeg(ubx_i32(&p[64]));
+  fix->pdop_e2 = ubx_u16(&p[76]);
+  if((length >= UBX_LEN_NAV_PVT_MAG) && (valid & UBX_PVT_VALID_MAG)) {
+    fix->mag_var_cdeg = (int16_t)ubx_u16(&p[88]);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a NAV-POSLLH message.
+ *
+ * @param[in] p
+ *    Payload
+ *
+ * @param[out] fix
+ *    Fix to update
+ ******************************************************************************/
+static void ubx_parse_nav_posllh(const uint8_t *p, gps_fix_t *fix)
+{
+  int32_t height = ubx_i32(&p[12]);
+  int32_t hmsl = ubx_i32(&p[16]);
+
+  fix->longitude_e7 = ubx_i32(&p[4]);
+  fix->latitude_e7 = ubx_i32(&p[8]);
+  fix->altitude_mm = hmsl;
+  fix->geoid_sep_mm = height - hmsl;
+  fix->h_acc_mm = ubx_u32(&p[20]);
+  fix->v_acc_mm = ubx_u32(&p[24]);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a NAV-SOL message.
+ *
+ * @param[in] p
+ *    Payload
+ *
+ * @param[out] fix
+ *    Fix to update
+ ******************************************************************************/
+static void ubx_parse_nav_sol(const uint8_t *p, gps_fix_t *fix)
+{
+  fix->valid = (p[11] & UBX_SOL_GPS_FIX_OK) != 0;
+  fix->quality = fix->valid ? 1 : 0;
+  fix->mode = ubx_fix_mode(p[10]);
+  fix->pdop_e2 = ubx_u16(&p[44]);
+  fix->sats_used = p[47];
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Merges a NAV-VELNED message.
+ *
+ * @param[in] p
+ *    Payload
+ *
+ * @param[out] fix
+ *    Fix to update
+ ******************************************************************************/
+static void ubx_parse_nav_velned(const uint8_t *p, gps_fix_t *fix)
+{
+  uint32_t speed = ubx_u32(&p[20]);   // cm/s
+
+  fix->speed_mknots = (uint32_t)(((uint64_t)speed * 36000 + 926) / 1852);
+  fix->speed_mkmh = speed * 36;
+  fix->course_cdeg = ubx_course_cdeg(ubx_i32(&p[24]));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handles a frame with a valid checksum.
+ *
+ * @param[in,out] parser
+ *    Parser state
+ *
+ * @return
+ *    GPS_UBX_xxx message merged into the fix, 0 if none
+ ******************************************************************************/
+static uint16_t ubx_dispatch(gps_ubx_parser_t *parser)
+{
+  const uint8_t *p = parser->payload;
+  uint16_t length = parser->length;
+  gps_fix_t *fix = parser->fix;
+  uint16_t merged = 0;
+  uint16_t min_length = 0;
+
+  if(parser->msg_class == GPS_UBX_CLASS_NAV) {
+    switch(parser->msg_id) {
+      case GPS_UBX_ID_NAV_PVT:
+        min_length = UBX_LEN_NAV_PVT;
+        merged = GPS_UBX_NAV_PVT;
+        break;
+      case GPS_UBX_ID_NAV_POSLLH:
+        min_length = UBX_LEN_NAV_POSLLH;
+        merged = GPS_UBX_NAV_POSLLH;
+        break;
+      case GPS_UBX_ID_NAV_SOL:
+        min_length = UBX_LEN_NAV_SOL;
+        merged = GPS_UBX_NAV_SOL;
+        break;
+      case GPS_UBX_ID_NAV_VELNED:
+        min_length = UBX_LEN_NAV_VELNED;
+        merged = GPS_UBX_NAV_VELNED;
+        break;
+      default:
+        return 0;
+    }
+  } else if(parser->msg_class == GPS_UBX_CLASS_ACK) {
+    if(length < UBX_LEN_ACK) {
+      parser->length_errors++;
+    } else if((parser->ack_state == GPS_UBX_ACK_PENDING)
+              && (p[0] == parser->ack_class) && (p[1] == parser->ack_id)) {
+      parser->ack_state = (parser->msg_id == GPS_UBX_ID_ACK_ACK)
+                          ? GPS_UBX_ACK_ACKED : GPS_UBX_ACK_NAKED;
+    }
+    return 0;
+  } else {
+    return 0;
+  }
+
+  if(length < min_length) {
+    parser->length_errors++;
+    return 0;
+  }
+
+  switch(merged) {
+    case GPS_UBX_NAV_PVT:
+      ubx_parse_nav_pvt(p, length, fix);
+      break;
+    case GPS_UBX_NAV_POSLLH:
+      ubx_parse_nav_posllh(p, fix);
+      break;
+    case GPS_UBX_NAV_SOL:
+      ubx_parse_nav_sol(p, fix);
+      break;
+    default:
+      ubx_parse_nav_velned(p, fix);
+      break;
+  }
+
+  fix->updated |= merged;
+  return merged;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initializes a UBX parser.
+ ******************************************************************************/
+void gps_ubx_init(gps_ubx_parser_t *parser, gps_fix_t *fix)
+{
+  memset(parser, 0, sizeof(gps_ubx_parser_t));
+  parser->fix = fix;
+  parser->state = UBX_STATE_SYNC_1;
+  parser->ack_state = GPS_UBX_ACK_NONE;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Feeds received bytes to the parser up to the end of a frame.
+ ******************************************************************************/
+size_t gps_ubx_process(gps_ubx_parser_t *parser,
+                       const uint8_t *data,
+                       size_t len,
+                       uint16_t *merged)
+{
+  size_t i;
+  uint8_t c;
+
+  for(i = 0; i < len; i++) {
+    c = data[i];
+
+    switch(parser->state) {
+      case UBX_STATE_SYNC_1:
+        if(c != GPS_UBX_SYNC_CHAR_1) {
+          return i;
+        }
+        parser->state = UBX_STATE_SYNC_2;
+        break;
+
+      case UBX_STATE_SYNC_2:
+        if(c == GPS_UBX_SYNC_CHAR_2) {
+          parser->ck_a = 0;
+          parser->ck_b = 0;
+          parser->state = UBX_STATE_CLASS;
+        } else if(c != GPS_UBX_SYNC_CHAR_1) {
+          parser->state = UBX_STATE_SYNC_1;
+          return i;
+        }
+        break;
+
+      case UBX_STATE_CLASS:
+      case UBX_STATE_ID:
+      case UBX_STATE_LENGTH_L:
+      case UBX_STATE_LENGTH_H:
+        parser->ck_a += c;
+        parser->ck_b += parser->ck_a;
+        if(parser->state == UBX_STATE_CLASS) {
+          parser->msg_class = c;
+        } else if(parser->state == UBX_STATE_ID) {
+          parser->msg_id = c;
+        } else if(parser->state == UBX_STATE_LENGTH_L) {
+          parser->length = c;
+        } else {
+          parser->length |= (uint16_t)c << 8;
+          parser->index = 0;
+          // A frame that does not fit is dropped right away to resync sooner
+          if(parser->length > GPS_UBX_MAX_PAYLOAD) {
+            parser->length_errors++;
+            parser->state = UBX_STATE_SYNC_1;
+            return i + 1;
+          }
+          parser->state = (parser->length > 0) ? UBX_STATE_PAYLOAD
+                                               : UBX_STATE_CK_A;
+          break;
+        }
+        parser->state++;
+        break;
+
+      case UBX_STATE_PAYLOAD:
+        parser->ck_a += c;
+        parser->ck_b += parser->ck_a;
+        parser->payload[parser->index++] = c;
+        if(parser->index == parser->length) {
+          parser->state = UBX_STATE_CK_A;
+        }
+        break;
+
+      case UBX_STATE_CK_A:
+        // Leaves 0 in ck_a if the first checksum byte matches
+        parser->ck_a ^= c;
+        parser->state = UBX_STATE_CK_B;
+        break;
+
+      default:
+        parser->state = UBX_STATE_SYNC_1;
+        if((parser->ck_a != 0) || (c != parser->ck_b)) {
+          parser->checksum_errors++;
+          return i + 1;
+        }
+        parser->frames++;
+        *merged |= ubx_dispatch(parser);
+        return i + 1;
+    }
+  }
+
+  return i;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Checks if the parser is inside a frame.
+ ******************************************************************************/
+bool gps_ubx_in_frame(const gps_ubx_parser_t *parser)
+{
+  return parser->state != UBX_STATE_SYNC_1;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Splits a receiver output stream between the UBX and the NMEA parser.
+ ******************************************************************************/
+uint16_t gps_ubx_demux(gps_ubx_parser_t *ubx,
+                       gps_nmea_parser_t *nmea,
+                       const uint8_t *data,
+                       size_t len)
+{
+  const uint8_t *sync;
+  uint16_t merged = 0;
+  size_t n;
+
+  while(len > 0) {
+    if(gps_ubx_in_frame(ubx) || (data[0] == GPS_UBX_SYNC_CHAR_1)) {
+      // Returns without consuming if the second sync character is missing,
+      // the byte then goes to the NMEA parser
+      n = gps_ubx_process(ubx, data, len, &merged);
+    } else {
+      sync = memchr(data, GPS_UBX_SYNC_CHAR_1, len);
+      n = (sync != NULL) ? (size_t)(sync - data) : len;
+      merged |= gps_nmea_process(nmea, data, n);
+    }
+    data += n;
+    len -= n;
+  }
+
+  return merged;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Starts waiting for the acknowledge of a configuration message.
+ ******************************************************************************/
+void gps_ubx_expect_ack(gps_ubx_parser_t *parser,
+                        uint8_t msg_class,
+                        uint8_t msg_id)
+{
+  parser->ack_class = msg_class;
+  parser->ack_id = msg_id;
+  parser->ack_state = GPS_UBX_ACK_PENDING;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a UBX frame.
+ ******************************************************************************/
+uint16_t gps_ubx_frame(uint8_t *frame,
+                       uint16_t size,
+                       uint8_t msg_class,
+                       uint8_t msg_id,
+                       const uint8_t *payload,
+                       uint16_t length)
+{
+  uint8_t ck_a = 0;
+  uint8_t ck_b = 0;
+  uint16_t i;
+
+  if((size < GPS_UBX_FRAME_OVERHEAD)
+      || (length > size - GPS_UBX_FRAME_OVERHEAD)) {
+    return 0;
+  }
+
+  frame[0] = GPS_UBX_SYNC_CHAR_1;
+  frame[1] = GPS_UBX_SYNC_CHAR_2;
+  frame[2] = msg_class;
+  frame[3] = msg_id;
+  ubx_put_u16(&frame[4], length);
+  if(length > 0) {
+    // memmove, the payload may already be in place
+    memmove(&frame[GPS_UBX_HEADER_LENGTH], payload, length);
+  }
+
+  // Fletcher checksum over class, ID, length and payload
+  for(i = 2; i < GPS_UBX_HEADER_LENGTH + length; i++) {
+    ck_a += frame[i];
+    ck_b += ck_a;
+  }
+  frame[GPS_UBX_HEADER_LENGTH + length] = ck_a;
+  frame[GPS_UBX_HEADER_LENGTH + length + 1] = ck_b;
+
+  return length + GPS_UBX_FRAME_OVERHEAD;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-MSG frame.
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_msg(uint8_t *frame,
+                               uint16_t size,
+                               uint8_t msg_class,
+                               uint8_t msg_id,
+                               uint8_t rate)
+{
+  uint8_t payload[UBX_LEN_CFG_MSG];
+
+  payload[0] = msg_class;
+  payload[1] = msg_id;
+  payload[2] = rate;
+  return gps_ubx_frame(frame, size, GPS_UBX_CLASS_CFG, GPS_UBX_ID_CFG_MSG,
+                       payload, sizeof(payload));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-RATE frame.
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_rate(uint8_t *frame,
+                                uint16_t size,
+                                uint16_t meas_rate_ms)
+{
+  uint8_t payload[UBX_LEN_CFG_RATE];
+
+  ubx_put_u16(&payload[0], meas_rate_ms);
+  ubx_put_u16(&payload[2], 1);      // One navigation solution per measurement
+  ubx_put_u16(&payload[4], 0);      // Aligned to UTC
+  return gps_ubx_frame(frame, size, GPS_UBX_CLASS_CFG, GPS_UBX_ID_CFG_RATE,
+                       payload, sizeof(payload));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Builds a CFG-PRT frame for UART1.
+ ******************************************************************************/
+uint16_t gps_ubx_frame_cfg_prt(uint8_t *frame,
+                               uint16_t size,
+                               uint32_t baudrate,
+                               uint16_t in_proto,
+                               uint16_t out_proto)
+{
+  uint8_t payload[UBX_LEN_CFG_PRT];
+
+  memset(payload, 0, sizeof(payload));
+  payload[0] = UBX_PRT_PORT_UART1;
+  ubx_put_u32(&payload[4], UBX_PRT_MODE_8N1);
+  ubx_put_u32(&payload[8], baudrate);
+  ubx_put_u16(&payload[12], in_proto);
+  ubx_put_u16(&payload[14], out_proto);
+  return gps_ubx_frame(frame, size, GPS_UBX_CLASS_CFG, GPS_UBX_ID_CFG_PRT,
+                       payload, sizeof(payload));
+}
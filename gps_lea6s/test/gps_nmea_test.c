@@ -0,0 +1,235 @@
+/***************************************************************************//**
+ * @file  gps_nmea_test.c
+ * @brief Host test of the GPS NMEA parser.
+ *
+ * Replays a recorded LEA-6S NMEA log in chunks of random size, checks the
+ * merged fix, the checksum and length checks, and measures the parse
+ * throughput. A log file given on the command line is replayed as well.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc gps_nmea_test.c ../src/gps_nmea.c
+ *   ./a.out [nmea_log.txt]
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <gps_nmea.h>
+
+// Replays of the log used for the throughput measurement
+#define THROUGHPUT_ITERATIONS   20000
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+// One epoch of a LEA-6S with the default message set
+static const char nmea_log[] =
+  "$GPRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A*57\r\n"
+  "$GPVTG,77.52,T,,M,0.004,N,0.008,K,A*06\r\n"
+  "$GPGGA,083559.00,4717.11437,N,00833.91522,E,1,08,1.01,499.6,M,48.0,M,,*58\r\n"
+  "$GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.01,1.65*07\r\n"
+  "$GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36*7F\r\n"
+  "$GPGSV,3,2,10,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44*72\r\n"
+  "$GPGSV,3,3,10,26,82,187,47,28,43,056,46*77\r\n"
+  "$GPGLL,4717.11437,N,00833.91522,E,083559.00,A,A*6B\r\n";
+
+// Sentences with a valid checksum in one epoch of the log
+#define LOG_SENTENCES   8
+
+static int failed = 0;
+
+/***************************************************************************//**
+ * Feeds a buffer to the parser in chunks of 1 to 64 bytes.
+ ******************************************************************************/
+static uint8_t feed_random(gps_nmea_parser_t *parser,
+                           const uint8_t *data,
+                           size_t len)
+{
+  uint8_t merged = 0;
+  size_t chunk;
+
+  while (len > 0) {
+    chunk = 1 + (size_t)(rand() % 64);
+    if (chunk > len) {
+      chunk = len;
+    }
+    merged |= gps_nmea_process(parser, data, chunk);
+    data += chunk;
+    len -= chunk;
+  }
+
+  return merged;
+}
+
+/***************************************************************************//**
+ * Checks the fix against the values of the recorded epoch.
+ ******************************************************************************/
+static void check_fix(const gps_fix_t *fix)
+{
+  CHECK(fix->utctime.hour == 8);
+  CHECK(fix->utctime.min == 35);
+  CHECK(fix->utctime.sec == 59);
+  CHECK(fix->utctime.millisec == 0);
+  CHECK(fix->utcdate.day == 9);
+  CHECK(fix->utcdate.month == 12);
+  CHECK(fix->utcdate.year == 2);
+  CHECK(fix->valid);
+  CHECK(fix->quality == 1);
+  CHECK(fix->mode == 3);
+  CHECK(fix->sats_used == 8);
+  CHECK(fix->latitude_e7 == 472852395);
+  CHECK(fix->longitude_e7 == 85652537);
+  CHECK(fix->altitude_mm == 499600);
+  CHECK(fix->geoid_sep_mm == 48000);
+  CHECK(fix->speed_mknots == 4);
+  CHECK(fix->speed_mkmh == 8);
+  CHECK(fix->course_cdeg == 7752);
+  CHECK(fix->pdop_e2 == 194);
+  CHECK(fix->hdop_e2 == 101);
+  CHECK(fix->vdop_e2 == 165);
+  CHECK(fix->used_prn[0] == 23);
+  CHECK(fix->used_prn[7] == 28);
+  CHECK(fix->used_prn[8] == 0);
+  CHECK(fix->sats_in_view == 10);
+  CHECK(fix->sats[0].prn == 23);
+  CHECK(fix->sats[0].elevation_deg == 38);
+  CHECK(fix->sats[0].azimuth_deg == 230);
+  CHECK(fix->sats[0].snr_dbhz == 44);
+  CHECK(fix->sats[4].prn == 10);
+  CHECK(fix->sats[4].snr_dbhz == 0);
+  CHECK(fix->sats[9].prn == 28);
+  CHECK(fix->sats[9].azimuth_deg == 56);
+}
+
+/***************************************************************************//**
+ * Replays a log file and prints the parser counters.
+ ******************************************************************************/
+static void replay_file(const char *path)
+{
+  static gps_nmea_parser_t parser;
+  static gps_fix_t fix;
+  uint8_t buffer[256];
+  size_t len;
+  FILE *file = fopen(path, "rb");
+
+  if (file == NULL) {
+    printf("cannot open %s\n", path);
+    failed = 1;
+    return;
+  }
+
+  gps_nmea_init(&parser, &fix);
+  while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    feed_random(&parser, buffer, len);
+  }
+  fclose(file);
+
+  printf("%s: %lu sentences, %lu checksum errors, %lu format errors\n",
+         path, (unsigned long)parser.sentences,
+         (unsigned long)parser.checksum_errors,
+         (unsigned long)parser.format_errors);
+  printf("  last fix: %ld %ld valid %d sats %d/%d\n",
+         (long)fix.latitude_e7, (long)fix.longitude_e7, fix.valid,
+         fix.sats_used, fix.sats_in_view);
+}
+
+int main(int argc, char *argv[])
+{
+  static gps_nmea_parser_t parser;
+  static gps_fix_t fix;
+  char corrupted[sizeof(nmea_log)];
+  char long_sentence[2 * NMEA_MAX_LENGTH];
+  size_t len = strlen(nmea_log);
+  uint8_t merged;
+  clock_t start;
+  double seconds;
+
+  srand(1);
+
+  // Recorded epoch, fed in random chunks
+  gps_nmea_init(&parser, &fix);
+  merged = feed_random(&parser, (const uint8_t *)nmea_log, len);
+  CHECK(merged == (GPS_NMEA_RMC | GPS_NMEA_GGA | GPS_NMEA_GSA
+                   | GPS_NMEA_GSV | GPS_NMEA_VTG));
+  CHECK(parser.sentences == LOG_SENTENCES);
+  CHECK(parser.checksum_errors == 0);
+  CHECK(parser.format_errors == 0);
+  check_fix(&fix);
+
+  // A corrupted character drops the sentence and keeps the previous fix
+  memcpy(corrupted, nmea_log, sizeof(nmea_log));
+  corrupted[20] = '8';
+  gps_nmea_init(&parser, &fix);
+  merged = feed_random(&parser, (const uint8_t *)corrupted, len);
+  CHECK((merged & GPS_NMEA_RMC) == 0);
+  CHECK(parser.checksum_errors == 1);
+  CHECK(parser.sentences == LOG_SENTENCES - 1);
+
+  // A sentence longer than NMEA_MAX_LENGTH is dropped
+  memset(long_sentence, 'A', sizeof(long_sentence));
+  long_sentence[0] = '$';
+  gps_nmea_init(&parser, &fix);
+  gps_nmea_process(&parser, (const uint8_t *)long_sentence,
+                   sizeof(long_sentence));
+  merged = gps_nmea_process(&parser, (const uint8_t *)nmea_log, len);
+  CHECK(parser.format_errors == 1);
+  CHECK(parser.sentences == LOG_SENTENCES);
+  check_fix(&fix);
+
+  // Throughput
+  gps_nmea_init(&parser, &fix);
+  start = clock();
+  for (int i = 0; i < THROUGHPUT_ITERATIONS; i++) {
+    gps_nmea_process(&parser, (const uint8_t *)nmea_log, len);
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  CHECK(parser.sentences == (uint32_t)LOG_SENTENCES * THROUGHPUT_ITERATIONS);
+  if (seconds > 0) {
+    printf("throughput: %.1f MB/s, %.0f sentences/s\n",
+           len * (double)THROUGHPUT_ITERATIONS / seconds / 1e6,
+           parser.sentences / seconds);
+  }
+
+  for (int i = 1; i < argc; i++) {
+    replay_file(argv[i]);
+  }
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
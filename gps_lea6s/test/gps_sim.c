@@ -0,0 +1,379 @@
+/***************************************************************************//**
+ * @file  gps_sim.c
+ * @brief Host model of the byte stream of a u-blox receiver.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+
+#include <stdio.h>
+#include <string.h>
+#include "gps_sim.h"
+
+// Fastest measurement period of the LEA-6S and of later receivers
+#define SIM_MIN_RATE_MS_U6    200
+#define SIM_MIN_RATE_MS_U7    25
+
+// Payload lengths output by the model, NAV-PVT in the u-blox 8 format
+#define SIM_LEN_NAV_PVT       92
+#define SIM_LEN_NAV_POSLLH    28
+#define SIM_LEN_NAV_SOL       52
+#define SIM_LEN_NAV_VELNED    36
+
+static void put_u16(uint8_t *p, uint16_t value)
+{
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t value)
+{
+  put_u16(p, (uint16_t)value);
+  put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+/***************************************************************************//**
+ * Queues a UBX frame.
+ ******************************************************************************/
+static void sim_ubx(gps_sim_t *sim, uint8_t msg_class, uint8_t msg_id,
+                    const uint8_t *payload, uint16_t length)
+{
+  sim->out_len += gps_ubx_frame(&sim->out[sim->out_len],
+                                (uint16_t)(GPS_SIM_OUT_SIZE - sim->out_len),
+                                msg_class, msg_id, payload, length);
+}
+
+/***************************************************************************//**
+ * Queues a NMEA sentence, adding the '$', the checksum and <CR><LF>.
+ ******************************************************************************/
+static void sim_nmea(gps_sim_t *sim, const char *body)
+{
+  uint8_t checksum = 0;
+  const char *c;
+  int n;
+
+  for(c = body; *c != '\0'; c++) {
+    checksum ^= (uint8_t)*c;
+  }
+  n = snprintf((char *)&sim->out[sim->out_len],
+               GPS_SIM_OUT_SIZE - sim->out_len, "$%s*%02X\r\n", body,
+               checksum);
+  if(n > 0 && (size_t)n < GPS_SIM_OUT_SIZE - sim->out_len) {
+    sim->out_len += (size_t)n;
+  }
+}
+
+/***************************************************************************//**
+ * Formats a coordinate as NMEA degrees and minutes.
+ ******************************************************************************/
+static void sim_degmin(char *buf, size_t size, int32_t value_e7,
+                       int deg_digits, char pos, char neg)
+{
+  uint32_t abs_e7 = (uint32_t)(value_e7 < 0 ? -value_e7 : value_e7);
+  uint32_t deg = abs_e7 / 10000000;
+  uint32_t min_e5 = ((abs_e7 % 10000000) * 60 + 50) / 100;
+
+  snprintf(buf, size, "%0*u%02u.%05u,%c", deg_digits, (unsigned)deg,
+           (unsigned)(min_e5 / 100000), (unsigned)(min_e5 % 100000),
+           value_e7 < 0 ? neg : pos);
+}
+
+/***************************************************************************//**
+ * Queues the enabled NMEA sentences of the current solution.
+ ******************************************************************************/
+static void sim_output_nmea(gps_sim_t *sim)
+{
+  const gps_sim_truth_t *t = &sim->truth;
+  char body[128];
+  char time[16];
+  char lat[20];
+  char lon[20];
+  uint32_t mknots = (t->speed_mm_s * 3600 + 926) / 1852;
+  uint32_t mkmh = t->speed_mm_s * 36 / 10;
+  uint32_t cdeg = (uint32_t)(t->heading_e5 + 500) / 1000;
+
+  snprintf(time, sizeof(time), "%02u%02u%02u.%02u",
+           (unsigned)(t->time_ms / 3600000), (unsigned)(t->time_ms / 60000 % 60),
+           (unsigned)(t->time_ms / 1000 % 60), (unsigned)(t->time_ms % 1000 / 10));
+  sim_degmin(lat, sizeof(lat), t->latitude_e7, 2, 'N', 'S');
+  sim_degmin(lon, sizeof(lon), t->longitude_e7, 3, 'E', 'W');
+
+  if(sim->nmea_rate[GPS_SIM_NMEA_RMC] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_RMC] == 0) {
+    snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%s,%u.%03u,%u.%02u,091202,,,A",
+             time, lat, lon, (unsigned)(mknots / 1000),
+             (unsigned)(mknots % 1000), (unsigned)(cdeg / 100),
+             (unsigned)(cdeg % 100));
+    sim_nmea(sim, body);
+  }
+  if(sim->nmea_rate[GPS_SIM_NMEA_VTG] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_VTG] == 0) {
+    snprintf(body, sizeof(body), "GPVTG,%u.%02u,T,,M,%u.%03u,N,%u.%03u,K,A",
+             (unsigned)(cdeg / 100), (unsigned)(cdeg % 100),
+             (unsigned)(mknots / 1000), (unsigned)(mknots % 1000),
+             (unsigned)(mkmh / 1000), (unsigned)(mkmh % 1000));
+    sim_nmea(sim, body);
+  }
+  if(sim->nmea_rate[GPS_SIM_NMEA_GGA] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_GGA] == 0) {
+    snprintf(body, sizeof(body), "GPGGA,%s,%s,%s,1,%02u,1.01,%d.%d,M,%d.%d,M,,",
+             time, lat, lon, t->sats_used,
+             (int)(t->altitude_mm / 1000), (int)(t->altitude_mm % 1000 / 100),
+             (int)(t->geoid_sep_mm / 1000), (int)(t->geoid_sep_mm % 1000 / 100));
+    sim_nmea(sim, body);
+  }
+  if(sim->nmea_rate[GPS_SIM_NMEA_GSA] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_GSA] == 0) {
+    snprintf(body, sizeof(body),
+             "GPGSA,A,3,23,29,07,08,09,18,26,28,,,,,%u.%02u,1.01,1.65",
+             (unsigned)(t->pdop_e2 / 100), (unsigned)(t->pdop_e2 % 100));
+    sim_nmea(sim, body);
+  }
+  if(sim->nmea_rate[GPS_SIM_NMEA_GSV] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_GSV] == 0) {
+    sim_nmea(sim, "GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36");
+    sim_nmea(sim, "GPGSV,3,2,10,10,07,189,,05,05,220,,09,34,274,42,18,25,309,44");
+    sim_nmea(sim, "GPGSV,3,3,10,26,82,187,47,28,43,056,46");
+  }
+  if(sim->nmea_rate[GPS_SIM_NMEA_GLL] != 0
+     && sim->epoch % sim->nmea_rate[GPS_SIM_NMEA_GLL] == 0) {
+    snprintf(body, sizeof(body), "GPGLL,%s,%s,%s,A,A", lat, lon, time);
+    sim_nmea(sim, body);
+  }
+}
+
+/***************************************************************************//**
+ * Queues the enabled UBX NAV messages of the current solution.
+ ******************************************************************************/
+static void sim_output_ubx(gps_sim_t *sim)
+{
+  const gps_sim_truth_t *t = &sim->truth;
+  uint8_t p[SIM_LEN_NAV_PVT];
+  uint32_t sec = t->time_ms / 1000;
+
+  if(sim->pvt_rate != 0 && sim->epoch % sim->pvt_rate == 0) {
+    memset(p, 0, sizeof(p));
+    put_u32(&p[0], t->time_ms);
+    put_u16(&p[4], 2002);
+    p[6] = 12;
+    p[7] = 9;
+    p[8] = (uint8_t)(sec / 3600);
+    p[9] = (uint8_t)(sec / 60 % 60);
+    p[10] = (uint8_t)(sec % 60);
+    p[11] = 0x07;                       // Date, time, fully resolved
+    put_u32(&p[16], t->time_ms % 1000 * 1000000);
+    p[20] = 3;                          // 3D fix
+    p[21] = 0x01;                       // gnssFixOK
+    p[23] = t->sats_used;
+    put_u32(&p[24], (uint32_t)t->longitude_e7);
+    put_u32(&p[28], (uint32_t)t->latitude_e7);
+    put_u32(&p[32], (uint32_t)(t->altitude_mm + t->geoid_sep_mm));
+    put_u32(&p[36], (uint32_t)t->altitude_mm);
+    put_u32(&p[40], t->h_acc_mm);
+    put_u32(&p[44], t->v_acc_mm);
+    put_u32(&p[60], t->speed_mm_s);
+    put_u32(&p[64], (uint32_t)t->heading_e5);
+    put_u16(&p[76], t->pdop_e2);
+    sim_ubx(sim, GPS_UBX_CLASS_NAV, GPS_UBX_ID_NAV_PVT, p, SIM_LEN_NAV_PVT);
+  }
+  if(sim->posllh_rate != 0 && sim->epoch % sim->posllh_rate == 0) {
+    memset(p, 0, sizeof(p));
+    put_u32(&p[0], t->time_ms);
+    put_u32(&p[4], (uint32_t)t->longitude_e7);
+    put_u32(&p[8], (uint32_t)t->latitude_e7);
+    put_u32(&p[12], (uint32_t)(t->altitude_mm + t->geoid_sep_mm));
+    put_u32(&p[16], (uint32_t)t->altitude_mm);
+    put_u32(&p[20], t->h_acc_mm);
+    put_u32(&p[24], t->v_acc_mm);
+    sim_ubx(sim, GPS_UBX_CLASS_NAV, GPS_UBX_ID_NAV_POSLLH, p,
+            SIM_LEN_NAV_POSLLH);
+  }
+  if(sim->sol_rate != 0 && sim->epoch % sim->sol_rate == 0) {
+    memset(p, 0, sizeof(p));
+    put_u32(&p[0], t->time_ms);
+    p[10] = 3;                          // 3D fix
+    p[11] = 0x0D;                       // gpsFixOK, WKNSET, TOWSET
+    put_u16(&p[44], t->pdop_e2);
+    p[47] = t->sats_used;
+    sim_ubx(sim, GPS_UBX_CLASS_NAV, GPS_UBX_ID_NAV_SOL, p, SIM_LEN_NAV_SOL);
+  }
+  if(sim->velned_rate != 0 && sim->epoch % sim->velned_rate == 0) {
+    memset(p, 0, sizeof(p));
+    put_u32(&p[0], t->time_ms);
+    put_u32(&p[16], t->speed_mm_s / 10);
+    put_u32(&p[20], t->speed_mm_s / 10);
+    put_u32(&p[24], (uint32_t)t->heading_e5);
+    sim_ubx(sim, GPS_UBX_CLASS_NAV, GPS_UBX_ID_NAV_VELNED, p,
+            SIM_LEN_NAV_VELNED);
+  }
+}
+
+/***************************************************************************//**
+ * Applies a CFG message received from the driver.
+ ******************************************************************************/
+static bool sim_configure(gps_sim_t *sim, uint8_t msg_id,
+                          const uint8_t *p, uint16_t length)
+{
+  uint16_t min_rate = sim->pvt_supported ? SIM_MIN_RATE_MS_U7
+                                         : SIM_MIN_RATE_MS_U6;
+
+  switch(msg_id) {
+    case GPS_UBX_ID_CFG_MSG:
+      if(length != 3) {
+        return false;
+      }
+      if(p[0] == GPS_SIM_CLASS_NMEA && p[1] < GPS_SIM_NMEA_COUNT) {
+        sim->nmea_rate[p[1]] = p[2];
+      } else if(p[0] == GPS_UBX_CLASS_NAV && p[1] == GPS_UBX_ID_NAV_PVT
+                && sim->pvt_supported) {
+        sim->pvt_rate = p[2];
+      } else if(p[0] == GPS_UBX_CLASS_NAV && p[1] == GPS_UBX_ID_NAV_POSLLH) {
+        sim->posllh_rate = p[2];
+      } else if(p[0] == GPS_UBX_CLASS_NAV && p[1] == GPS_UBX_ID_NAV_SOL) {
+        sim->sol_rate = p[2];
+      } else if(p[0] == GPS_UBX_CLASS_NAV && p[1] == GPS_UBX_ID_NAV_VELNED) {
+        sim->velned_rate = p[2];
+      } else {
+        return false;
+      }
+      return true;
+
+    case GPS_UBX_ID_CFG_RATE:
+      if(length != 6 || get_u16(&p[0]) < min_rate || get_u16(&p[2]) != 1) {
+        return false;
+      }
+      sim->meas_rate_ms = get_u16(&p[0]);
+      return true;
+
+    case GPS_UBX_ID_CFG_PRT:
+      if(length != 20 || p[0] != 1) {
+        return false;
+      }
+      sim->baudrate = get_u32(&p[8]);
+      sim->out_proto = get_u16(&p[14]);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void gps_sim_init(gps_sim_t *sim, bool pvt_supported)
+{
+  gps_sim_truth_t *t = &sim->truth;
+
+  memset(sim, 0, sizeof(gps_sim_t));
+  sim->pvt_supported = pvt_supported;
+  sim->meas_rate_ms = 1000;
+  sim->baudrate = 9600;
+  sim->out_proto = GPS_UBX_PROTO_UBX | GPS_UBX_PROTO_NMEA;
+  memset(sim->nmea_rate, 1, sizeof(sim->nmea_rate));
+  gps_ubx_init(&sim->rx, &sim->rx_fix);
+
+  t->time_ms = (8 * 3600 + 35 * 60 + 59) * 1000;
+  t->latitude_e7 = 472852395;
+  t->longitude_e7 = 85652537;
+  t->altitude_mm = 499600;
+  t->geoid_sep_mm = 48000;
+  t->speed_mm_s = 10000;
+  t->heading_e5 = 4500000;
+  t->h_acc_mm = 2500;
+  t->v_acc_mm = 4000;
+  t->sats_used = 8;
+  t->pdop_e2 = 194;
+}
+
+void gps_sim_receive(gps_sim_t *sim, const uint8_t *data, size_t len)
+{
+  uint16_t merged = 0;
+  uint32_t frames;
+  uint8_t ack[2];
+  size_t n;
+
+  while(len > 0) {
+    frames = sim->rx.frames;
+    n = gps_ubx_process(&sim->rx, data, len, &merged);
+    // Anything else than UBX is ignored
+    if(n == 0) {
+      n = 1;
+    }
+    data += n;
+    len -= n;
+
+    if(sim->rx.frames != frames && sim->rx.msg_class == GPS_UBX_CLASS_CFG) {
+      ack[0] = sim->rx.msg_class;
+      ack[1] = sim->rx.msg_id;
+      sim_ubx(sim, GPS_UBX_CLASS_ACK,
+              sim_configure(sim, sim->rx.msg_id, sim->rx.payload,
+                            sim->rx.length)
+              ? GPS_UBX_ID_ACK_ACK : GPS_UBX_ID_ACK_NAK,
+              ack, sizeof(ack));
+    }
+  }
+}
+
+void gps_sim_epoch(gps_sim_t *sim)
+{
+  gps_sim_truth_t *t = &sim->truth;
+
+  // North east at 10 m/s
+  t->time_ms += sim->meas_rate_ms;
+  t->latitude_e7 += (int32_t)(sim->meas_rate_ms * 64 / 100);
+  t->longitude_e7 += (int32_t)(sim->meas_rate_ms * 94 / 100);
+  sim->epoch++;
+
+  if(sim->out_proto & GPS_UBX_PROTO_NMEA) {
+    sim_output_nmea(sim);
+  }
+  if(sim->out_proto & GPS_UBX_PROTO_UBX) {
+    sim_output_ubx(sim);
+  }
+}
+
+size_t gps_sim_read(gps_sim_t *sim, uint8_t *data, size_t size)
+{
+  size_t n = (sim->out_len < size) ? sim->out_len : size;
+
+  memcpy(data, sim->out, n);
+  memmove(sim->out, &sim->out[n], sim->out_len - n);
+  sim->out_len -= n;
+  return n;
+}
@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file  gps_sim.h
+ * @brief Host model of the byte stream of a u-blox receiver.
+ *
+ * Answers the UBX configuration messages of the driver with ACK-ACK or
+ * ACK-NAK and outputs the enabled NMEA sentences and UBX NAV messages of
+ * a receiver moving at constant speed.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+
+#ifndef GPS_SIM_H_
+#define GPS_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <gps_ubx.h>
+
+// Output bytes queued by the receiver
+#define GPS_SIM_OUT_SIZE      4096
+
+// NMEA sentence IDs of CFG-MSG, class 0xF0
+#define GPS_SIM_CLASS_NMEA    0xF0
+#define GPS_SIM_NMEA_GGA      0x00
+#define GPS_SIM_NMEA_GLL      0x01
+#define GPS_SIM_NMEA_GSA      0x02
+#define GPS_SIM_NMEA_GSV      0x03
+#define GPS_SIM_NMEA_RMC      0x04
+#define GPS_SIM_NMEA_VTG      0x05
+#define GPS_SIM_NMEA_COUNT    6
+
+// Position of the receiver
+typedef struct {
+  uint32_t time_ms;           ///< Time of day
+  int32_t latitude_e7;
+  int32_t longitude_e7;
+  int32_t altitude_mm;        ///< Above mean sea level
+  int32_t geoid_sep_mm;
+  uint32_t speed_mm_s;        ///< Ground speed
+  int32_t heading_e5;         ///< Course over ground in 1e-5 degrees
+  uint32_t h_acc_mm;
+  uint32_t v_acc_mm;
+  uint8_t sats_used;
+  uint16_t pdop_e2;
+} gps_sim_truth_t;
+
+// Receiver model
+typedef struct {
+  bool pvt_supported;         ///< u-blox 7 and later, not the LEA-6S
+  uint16_t meas_rate_ms;      ///< CFG-RATE measurement period
+  uint32_t baudrate;          ///< CFG-PRT baud rate
+  uint16_t out_proto;         ///< CFG-PRT output protocols
+  uint8_t nmea_rate[GPS_SIM_NMEA_COUNT]; ///< CFG-MSG rate of the sentences
+  uint8_t pvt_rate;           ///< CFG-MSG rate of the NAV messages
+  uint8_t posllh_rate;
+  uint8_t sol_rate;
+  uint8_t velned_rate;
+  uint32_t epoch;             ///< Navigation solutions output so far
+  gps_sim_truth_t truth;      ///< Position of the current solution
+  gps_ubx_parser_t rx;        ///< Commands received from the driver
+  gps_fix_t rx_fix;
+  uint8_t out[GPS_SIM_OUT_SIZE]; ///< Bytes to send to the driver
+  size_t out_len;
+} gps_sim_t;
+
+// Initializes a receiver with the LEA-6S default configuration, NMEA output
+// at 1 Hz.
+void gps_sim_init(gps_sim_t *sim, bool pvt_supported);
+
+// Receives bytes sent by the driver, CFG messages are acknowledged.
+void gps_sim_receive(gps_sim_t *sim, const uint8_t *data, size_t len);
+
+// Moves to the next navigation solution and queues its output.
+void gps_sim_epoch(gps_sim_t *sim);
+
+// Takes at most size queued bytes, returns the number of bytes.
+size_t gps_sim_read(gps_sim_t *sim, uint8_t *data, size_t size);
+
+#endif /* GPS_SIM_H_ */
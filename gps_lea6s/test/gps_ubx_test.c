@@ -0,0 +1,309 @@
+/***************************************************************************//**
+ * @file  gps_ubx_test.c
+ * @brief Host test of the GPS UBX framing and receiver configuration.
+ *
+ * Runs the UBX and NMEA parsers against a simulated receiver byte stream:
+ * configuration with ACK tracking, 5 Hz binary navigation solutions, mixed
+ * UBX and NMEA output, corrupted frames, and the bus load and parse time per
+ * fix of NMEA and UBX.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc gps_ubx_test.c gps_sim.c ../src/gps_ubx.c ../src/gps_nmea.c
+ *   ./a.out
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <gps_ubx.h>
+#include "gps_sim.h"
+
+// Replays of an epoch used for the parse time measurement
+#define THROUGHPUT_ITERATIONS   50000
+
+// UART bytes per second at 9600 baud, 8N1
+#define UART_BYTES_PER_SECOND   960
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// Driver side of the link
+static gps_sim_t sim;
+static gps_ubx_parser_t ubx;
+static gps_nmea_parser_t nmea;
+static gps_fix_t fix;
+
+/***************************************************************************//**
+ * Moves everything the receiver queued to the parsers in chunks of 1 to 64
+ * bytes, as the RX ring would hand them over.
+ ******************************************************************************/
+static uint16_t drain(size_t *bytes)
+{
+  uint8_t buffer[64];
+  uint16_t merged = 0;
+  size_t n;
+
+  while((n = gps_sim_read(&sim, buffer, 1 + (size_t)(rand() % 64))) > 0) {
+    merged |= gps_ubx_demux(&ubx, &nmea, buffer, n);
+    if(bytes != NULL) {
+      *bytes += n;
+    }
+  }
+  return merged;
+}
+
+/***************************************************************************//**
+ * Sends a configuration frame and returns the acknowledge state.
+ ******************************************************************************/
+static uint8_t configure(const uint8_t *frame, uint16_t length)
+{
+  CHECK(length > 0);
+  gps_ubx_expect_ack(&ubx, frame[2], frame[3]);
+  gps_sim_receive(&sim, frame, length);
+  drain(NULL);
+  return ubx.ack_state;
+}
+
+/***************************************************************************//**
+ * Resets both ends of the link.
+ ******************************************************************************/
+static void reset(bool pvt_supported)
+{
+  gps_sim_init(&sim, pvt_supported);
+  memset(&fix, 0, sizeof(fix));
+  gps_ubx_init(&ubx, &fix);
+  gps_nmea_init(&nmea, &fix);
+}
+
+/***************************************************************************//**
+ * Measures the parse time of one epoch of output in ns.
+ ******************************************************************************/
+static double parse_time_ns(const uint8_t *epoch, size_t len)
+{
+  clock_t start = clock();
+
+  for(int i = 0; i < THROUGHPUT_ITERATIONS; i++) {
+    gps_ubx_demux(&ubx, &nmea, epoch, len);
+  }
+  return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC
+         / THROUGHPUT_ITERATIONS;
+}
+
+int main(void)
+{
+  static const uint8_t cfg_msg_pvt[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51
+  };
+  uint8_t frame[64];
+  uint8_t nmea_epoch[1024];
+  uint8_t ubx_epoch[256];
+  uint8_t pvt_epoch[128];
+  size_t nmea_len, ubx_len, pvt_len;
+  size_t bytes;
+  uint16_t length;
+  uint16_t merged;
+  uint32_t frames;
+  double nmea_ns, ubx_ns, pvt_ns;
+
+  srand(1);
+
+  // Framing and Fletcher checksum against a frame from the receiver manual
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_PVT, 1);
+  CHECK(length == sizeof(cfg_msg_pvt));
+  CHECK(memcmp(frame, cfg_msg_pvt, sizeof(cfg_msg_pvt)) == 0);
+  CHECK(gps_ubx_frame(frame, 10, GPS_UBX_CLASS_CFG, GPS_UBX_ID_CFG_RATE,
+                      frame, 6) == 0);
+
+  // LEA-6S default output, NMEA at 1 Hz
+  reset(false);
+  bytes = 0;
+  for(int i = 0; i < 5; i++) {
+    gps_sim_epoch(&sim);
+    merged = drain(&bytes);
+    CHECK(merged == (GPS_NMEA_RMC | GPS_NMEA_GGA | GPS_NMEA_GSA
+                     | GPS_NMEA_GSV | GPS_NMEA_VTG));
+  }
+  CHECK(abs(fix.latitude_e7 - sim.truth.latitude_e7) <= 1);
+  CHECK(abs(fix.longitude_e7 - sim.truth.longitude_e7) <= 1);
+  CHECK(nmea.checksum_errors == 0 && nmea.format_errors == 0);
+
+  // Switch the LEA-6S to UBX output at 5 Hz
+  length = gps_ubx_frame_cfg_prt(frame, sizeof(frame), 9600,
+                                 GPS_UBX_PROTO_UBX | GPS_UBX_PROTO_NMEA,
+                                 GPS_UBX_PROTO_UBX);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  // No NAV-PVT before u-blox 7
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_PVT, 1);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_NAKED);
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_POSLLH, 1);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_SOL, 1);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_VELNED, 1);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  // 10 Hz is beyond the LEA-6S
+  length = gps_ubx_frame_cfg_rate(frame, sizeof(frame), 100);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_NAKED);
+  length = gps_ubx_frame_cfg_rate(frame, sizeof(frame), 200);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  CHECK(sim.meas_rate_ms == 200 && sim.out_proto == GPS_UBX_PROTO_UBX);
+
+  // The acknowledge of another message does not complete the pending one
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_SOL, 1);
+  gps_ubx_expect_ack(&ubx, GPS_UBX_CLASS_CFG, GPS_UBX_ID_CFG_RATE);
+  gps_sim_receive(&sim, frame, length);
+  drain(NULL);
+  CHECK(ubx.ack_state == GPS_UBX_ACK_PENDING);
+
+  // Binary solutions at 5 Hz
+  bytes = 0;
+  for(int i = 0; i < 25; i++) {
+    gps_sim_epoch(&sim);
+    merged = drain(&bytes);
+    CHECK(merged == (GPS_UBX_NAV_POSLLH | GPS_UBX_NAV_SOL
+                     | GPS_UBX_NAV_VELNED));
+  }
+  CHECK(fix.latitude_e7 == sim.truth.latitude_e7);
+  CHECK(fix.longitude_e7 == sim.truth.longitude_e7);
+  CHECK(fix.altitude_mm == 499600);
+  CHECK(fix.geoid_sep_mm == 48000);
+  CHECK(fix.h_acc_mm == 2500 && fix.v_acc_mm == 4000);
+  CHECK(fix.speed_mknots == 19438);
+  CHECK(fix.speed_mkmh == 36000);
+  CHECK(fix.course_cdeg == 4500);
+  CHECK(fix.valid && fix.mode == 3 && fix.quality == 1);
+  CHECK(fix.sats_used == 8 && fix.pdop_e2 == 194);
+  CHECK(ubx.checksum_errors == 0 && ubx.length_errors == 0);
+  printf("UBX 5 Hz: %lu bytes/s, %.0f%% of 9600 baud\n",
+         (unsigned long)(bytes / 5),
+         100.0 * bytes / 5 / UART_BYTES_PER_SECOND);
+  CHECK(bytes / 5 < UART_BYTES_PER_SECOND);
+
+  // u-blox 8 with NAV-PVT next to NMEA, sync characters in the payload
+  reset(true);
+  length = gps_ubx_frame_cfg_msg(frame, sizeof(frame), GPS_UBX_CLASS_NAV,
+                                 GPS_UBX_ID_NAV_PVT, 1);
+  CHECK(configure(frame, length) == GPS_UBX_ACK_ACKED);
+  sim.truth.h_acc_mm = 0x2462B524;
+  for(int i = 0; i < 10; i++) {
+    gps_sim_epoch(&sim);
+    merged = drain(NULL);
+    CHECK(merged == (GPS_NMEA_RMC | GPS_NMEA_GGA | GPS_NMEA_GSA
+                     | GPS_NMEA_GSV | GPS_NMEA_VTG | GPS_UBX_NAV_PVT));
+  }
+  CHECK(fix.latitude_e7 == sim.truth.latitude_e7);
+  CHECK(fix.h_acc_mm == 0x2462B524);
+  CHECK(fix.utctime.hour == 8 && fix.utctime.min == 36);
+  CHECK(fix.utctime.sec == 9 && fix.utctime.millisec == 0);
+  CHECK(fix.utcdate.year == 2 && fix.utcdate.month == 12);
+  CHECK(ubx.frames == 11 && ubx.checksum_errors == 0);
+  CHECK(nmea.sentences == 80);
+  CHECK(nmea.checksum_errors == 0 && nmea.format_errors == 0);
+
+  // A corrupted frame is dropped and the next one is decoded
+  gps_sim_epoch(&sim);
+  sim.out[sim.out_len - 20] ^= 0x40;
+  frames = ubx.frames;
+  merged = drain(NULL);
+  CHECK((merged & GPS_UBX_NAV_PVT) == 0);
+  CHECK(ubx.checksum_errors == 1 && ubx.frames == frames);
+  // A frame longer than the payload buffer is dropped
+  frame[0] = GPS_UBX_SYNC_CHAR_1;
+  frame[1] = GPS_UBX_SYNC_CHAR_2;
+  frame[2] = GPS_UBX_CLASS_NAV;
+  frame[3] = 0x30;
+  frame[4] = 0xFF;
+  frame[5] = 0xFF;
+  gps_ubx_demux(&ubx, &nmea, frame, 6);
+  CHECK(ubx.length_errors == 1 && !gps_ubx_in_frame(&ubx));
+  // A lone sync character does not swallow the next sentence
+  frame[0] = GPS_UBX_SYNC_CHAR_1;
+  gps_ubx_demux(&ubx, &nmea, frame, 1);
+  gps_sim_epoch(&sim);
+  merged = drain(NULL);
+  CHECK(merged == (GPS_NMEA_RMC | GPS_NMEA_GGA | GPS_NMEA_GSA
+                   | GPS_NMEA_GSV | GPS_NMEA_VTG | GPS_UBX_NAV_PVT));
+
+  // Bus load and parse time per fix
+  reset(true);
+  gps_sim_epoch(&sim);
+  nmea_len = gps_sim_read(&sim, nmea_epoch, sizeof(nmea_epoch));
+  sim.out_proto = GPS_UBX_PROTO_UBX;
+  sim.posllh_rate = 1;
+  sim.sol_rate = 1;
+  sim.velned_rate = 1;
+  gps_sim_epoch(&sim);
+  ubx_len = gps_sim_read(&sim, ubx_epoch, sizeof(ubx_epoch));
+  sim.posllh_rate = 0;
+  sim.sol_rate = 0;
+  sim.velned_rate = 0;
+  sim.pvt_rate = 1;
+  gps_sim_epoch(&sim);
+  pvt_len = gps_sim_read(&sim, pvt_epoch, sizeof(pvt_epoch));
+
+  nmea_ns = parse_time_ns(nmea_epoch, nmea_len);
+  ubx_ns = parse_time_ns(ubx_epoch, ubx_len);
+  pvt_ns = parse_time_ns(pvt_epoch, pvt_len);
+  CHECK(ubx.checksum_errors == 0 && nmea.checksum_errors == 0);
+
+  printf("per fix               bytes  5 Hz load  parse time\n");
+  printf("NMEA default set      %5lu  %8.0f%%  %7.0f ns\n",
+         (unsigned long)nmea_len,
+         100.0 * nmea_len * 5 / UART_BYTES_PER_SECOND, nmea_ns);
+  printf("POSLLH+SOL+VELNED     %5lu  %8.0f%%  %7.0f ns\n",
+         (unsigned long)ubx_len,
+         100.0 * ubx_len * 5 / UART_BYTES_PER_SECOND, ubx_ns);
+  printf("NAV-PVT               %5lu  %8.0f%%  %7.0f ns\n",
+         (unsigned long)pvt_len,
+         100.0 * pvt_len * 5 / UART_BYTES_PER_SECOND, pvt_ns);
+  CHECK(ubx_len * 5 < UART_BYTES_PER_SECOND);
+  CHECK(nmea_len * 5 > UART_BYTES_PER_SECOND);
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
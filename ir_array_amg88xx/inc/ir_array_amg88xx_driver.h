@@ -170,6 +170,19 @@ sl_status_t amg88xx_get_pixel_temperature_raw(unsigned char pixelAddr,
 sl_status_t amg88xx_get_sensor_array_temperatures(
   float temperature_grid[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS]);
 
+/***************************************************************************//**
+ * Gets the temperatures of the IR sensor array in fixed point.
+ * The frame is read in one I2C transfer and converted in place, with
+ * AMG88XX_Q_FRAC_BITS fractional bits, see ir_array_amg88xx_image.h.
+ * The temperature scale can be set globally with set_temperature_scale().
+ *
+ * @param temperature_grid Array of temperatures.
+ *
+ * @returns The result of the I2C transaction.
+ ******************************************************************************/
+sl_status_t amg88xx_get_sensor_array_temperatures_q(
+  int16_t temperature_grid[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS]);
+
 /***************************************************************************//**
  * Gets the raw temperatures of the IR sensor array.
  * For the pixel map check the amg88xx datasheet:
@@ -0,0 +1,174 @@
+/***************************************************************************//**
+ * @file ir_array_amg88xx_image.h
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+#ifndef IR_ARRAY_AMG88XX_IMAGE_H_
+#define IR_ARRAY_AMG88XX_IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                                   Defines
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Fixed point temperatures are int16_t with AMG88XX_Q_FRAC_BITS fractional
+ * bits, 1/64 degree, which covers the whole -512 to +511.75 degree range
+ * of the 12-bit pixel registers.
+ ******************************************************************************/
+#define AMG88XX_Q_FRAC_BITS           6
+#define AMG88XX_Q_ONE                 (1 << AMG88XX_Q_FRAC_BITS)
+
+/***************************************************************************//**
+ * Converts whole degrees to the fixed point format.
+ ******************************************************************************/
+#define AMG88XX_Q_FROM_DEGREES(d)     ((int16_t)((d) * AMG88XX_Q_ONE))
+
+/***************************************************************************//**
+ * Dimensions of the frames, the upscaled frame has 4x4 pixels per sensor
+ * pixel.
+ ******************************************************************************/
+#define AMG88XX_FRAME_ROWS            8
+#define AMG88XX_FRAME_COLUMNS         8
+#define AMG88XX_FRAME_PIXELS          (AMG88XX_FRAME_ROWS \
+                                       * AMG88XX_FRAME_COLUMNS)
+#define AMG88XX_UPSCALE_FACTOR        4
+#define AMG88XX_UPSCALED_ROWS         (AMG88XX_FRAME_ROWS \
+                                       * AMG88XX_UPSCALE_FACTOR)
+#define AMG88XX_UPSCALED_COLUMNS      (AMG88XX_FRAME_COLUMNS \
+                                       * AMG88XX_UPSCALE_FACTOR)
+#define AMG88XX_UPSCALED_PIXELS       (AMG88XX_UPSCALED_ROWS \
+                                       * AMG88XX_UPSCALED_COLUMNS)
+
+// -----------------------------------------------------------------------------
+//                            Variable declarations
+// -----------------------------------------------------------------------------
+enum amg88xx_upscale_t{AMG88XX_UPSCALE_BILINEAR,
+                       AMG88XX_UPSCALE_BICUBIC};
+
+/***************************************************************************//**
+ * Hot spot detector settings.
+ ******************************************************************************/
+typedef struct {
+  int16_t threshold;          ///< Pixels above this temperature are hot
+  uint16_t min_area;          ///< Smaller hot spots are not reported
+  bool eight_connected;       ///< Diagonal neighbours join a hot spot
+} amg88xx_blob_config_t;
+
+/***************************************************************************//**
+ * Hot spot found by amg88xx_image_find_blobs().
+ ******************************************************************************/
+typedef struct {
+  uint16_t area;              ///< Number of pixels
+  uint16_t x;                 ///< Centroid column, 8 fractional bits
+  uint16_t y;                 ///< Centroid row, 8 fractional bits
+  int16_t peak;               ///< Hottest pixel temperature
+} amg88xx_blob_t;
+
+/***************************************************************************//**
+ * Scratch memory of the hot spot detector, sized for the upscaled frame.
+ ******************************************************************************/
+typedef struct {
+  uint8_t visited[AMG88XX_UPSCALED_PIXELS / 8];
+  uint16_t stack[AMG88XX_UPSCALED_PIXELS];
+} amg88xx_blob_workspace_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * Converts a frame of raw pixel registers to fixed point temperatures.
+ * The pixels are 12-bit two's complement values in 0.25 degree steps.
+ * Works in place if raw and temperature are the same buffer.
+ *
+ * @param raw         Pixel registers, as read from the device.
+ * @param temperature Fixed point temperatures.
+ * @param count       Number of pixels.
+ * @param fahrenheit  Convert to fahrenheit instead of celsius.
+ ******************************************************************************/
+void amg88xx_image_convert(const uint16_t *raw,
+                           int16_t *temperature,
+                           uint16_t count,
+                           bool fahrenheit);
+
+/***************************************************************************//**
+ * Upscales an 8x8 frame to 32x32 pixels.
+ * Each output pixel is interpolated at its center from the sensor pixels,
+ * the edges are extended. Bicubic interpolation uses the Catmull-Rom spline,
+ * which can overshoot next to sharp edges. The results are saturated to the
+ * int16_t range.
+ *
+ * @param frame    Frame of AMG88XX_FRAME_PIXELS temperatures, row by row.
+ * @param upscaled Frame of AMG88XX_UPSCALED_PIXELS temperatures, row by row.
+ * @param mode     Interpolation.
+ ******************************************************************************/
+void amg88xx_image_upscale(const int16_t *frame,
+                           int16_t *upscaled,
+                           enum amg88xx_upscale_t mode);
+
+/***************************************************************************//**
+ * Finds the connected groups of hot pixels in a frame.
+ * The centroids are weighted by the temperature above the threshold.
+ * Hot spots are reported in the order their first pixel is found scanning the
+ * frame row by row.
+ *
+ * @param frame     Frame of temperatures, row by row.
+ * @param width     Number of columns.
+ * @param height    Number of rows, width * height must not exceed
+ *                  AMG88XX_UPSCALED_PIXELS.
+ * @param config    Detector settings.
+ * @param workspace Scratch memory.
+ * @param blobs     Hot spots found.
+ * @param max_blobs Size of the blobs array.
+ *
+ * @returns The number of hot spots found, which can be more than max_blobs.
+ ******************************************************************************/
+uint16_t amg88xx_image_find_blobs(const int16_t *frame,
+                                  uint8_t width,
+                                  uint8_t height,
+                                  const amg88xx_blob_config_t *config,
+                                  amg88xx_blob_workspace_t *workspace,
+                                  amg88xx_blob_t *blobs,
+                                  uint16_t max_blobs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IR_ARRAY_AMG88XX_IMAGE_H_
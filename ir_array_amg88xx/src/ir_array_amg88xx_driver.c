@@ -47,6 +47,7 @@
 #include "em_cmu.h"
 #include "sl_status.h"
 #include "ir_array_amg88xx_driver.h"
+#include "ir_array_amg88xx_image.h"
 
 // -----------------------------------------------------------------------------
 //                                Local Variables
@@ -287,11 +288,11 @@ sl_status_t amg88xx_get_pixel_temperature(unsigned char pixel_number,
   int16_t temperature = 0;
   sl_status_t result = amg88xx_get_pixel_temperature_raw(pixel_number,
                                                          &temperature);
-  if (temperature_scale == CELSIUS) {
-    *pixel_temperature = convert_raw_to_celsius(temperature);
-  } else {
-    *pixel_temperature = convert_raw_to_fahrenheit(temperature);
-  }
+  amg88xx_image_convert((uint16_t *)&temperature,
+                        &temperature,
+                        1,
+                        temperature_scale == FAHRENHEIT);
+  *pixel_temperature = (float)temperature * (1.0f / AMG88XX_Q_ONE);
   return result;
 }
 
@@ -309,23 +310,38 @@ sl_status_t amg88xx_get_pixel_temperature_raw(unsigned char pixel_number,
 sl_status_t amg88xx_get_sensor_array_temperatures(
   float temperature_grid[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS])
 {
-  uint8_t i = 0;
-  uint16_t temperature_grid_raw[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS];
-  uint32_t read_result;
+  int16_t temperature_grid_q[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS];
+  const int16_t *in = &temperature_grid_q[0][0];
+  float *out = &temperature_grid[0][0];
+  sl_status_t read_result;
+
+  read_result = amg88xx_get_sensor_array_temperatures_q(temperature_grid_q);
+  if (read_result == SL_STATUS_OK) {
+    for (uint8_t i = 0; i < SENSOR_ARRAY_ROWS * SENSOR_ARRAY_COLUMNS; i++) {
+      out[i] = (float)in[i] * (1.0f / AMG88XX_Q_ONE);
+    }
+  }
+
+  return read_result;
+}
+
+/***************************************************************************//**
+ * Get the fixed point temperatures of the IR sensor array.
+ ******************************************************************************/
+sl_status_t amg88xx_get_sensor_array_temperatures_q(
+  int16_t temperature_grid[SENSOR_ARRAY_COLUMNS][SENSOR_ARRAY_ROWS])
+{
+  sl_status_t read_result;
+
+  // Read the registers into the output and convert the frame in place.
   read_result = amg88xx_i2c_read(TEMPERATURE_REGISTER_START,
-                                 (void *)temperature_grid_raw,
+                                 (void *)temperature_grid,
                                  SENSOR_ARRAY_ROWS * SENSOR_ARRAY_COLUMNS * 2);
-  while ((read_result == SL_STATUS_OK) && (i < SENSOR_ARRAY_COLUMNS)) {
-    for (int j = 0; j < SENSOR_ARRAY_ROWS; j++) {
-      if (temperature_scale == CELSIUS) {
-        temperature_grid[i][j] = convert_raw_to_celsius(
-          temperature_grid_raw[i][j]);
-      } else {
-        temperature_grid[i][j] = convert_raw_to_fahrenheit(
-          temperature_grid_raw[i][j]);
-      }
-    }
-    i++;
+  if (read_result == SL_STATUS_OK) {
+    amg88xx_image_convert((uint16_t *)temperature_grid,
+                          &temperature_grid[0][0],
+                          SENSOR_ARRAY_ROWS * SENSOR_ARRAY_COLUMNS,
+                          temperature_scale == FAHRENHEIT);
   }
 
   return read_result;
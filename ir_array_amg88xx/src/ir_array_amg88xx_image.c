@@ -0,0 +1,314 @@
+/***************************************************************************//**
+ * @file ir_array_amg88xx_image.c
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ *
+ * EVALUATION QUALITY
+ * This code has been minimally tested to ensure that it builds with the
+ * specified dependency versions and is suitable as a demonstration for
+ * evaluation purposes only.
+ * This code will be maintained at the sole discretion of Silicon Labs.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ir_array_amg88xx_image.h"
+
+// -----------------------------------------------------------------------------
+//                                Local Variables
+// -----------------------------------------------------------------------------
+
+// Interpolation weights have 10 fractional bits.
+#define WEIGHT_SHIFT                  10
+
+/***************************************************************************//**
+ * Interpolation kernels, 4 taps per output phase.
+ * Output pixel 4k+p is centered at sensor coordinate k + (2p - 3) / 8, so the
+ * fractions are 5/8 and 7/8 after pixel k-1 for phases 0 and 1, and 1/8 and
+ * 3/8 after pixel k for phases 2 and 3. Taps start one pixel before the base.
+ ******************************************************************************/
+static const int16_t upscale_weights[2][AMG88XX_UPSCALE_FACTOR][4] = {
+  // Bilinear
+  {
+    { 0, 384, 640, 0 },
+    { 0, 128, 896, 0 },
+    { 0, 896, 128, 0 },
+    { 0, 640, 384, 0 },
+  },
+  // Catmull-Rom
+  {
+    { -45, 399, 745, -75 },
+    { -7, 93, 987, -49 },
+    { -49, 987, 93, -7 },
+    { -75, 745, 399, -45 },
+  },
+};
+
+// Base sensor pixel of each phase, relative to the output pixel / 4.
+static const int8_t upscale_base[AMG88XX_UPSCALE_FACTOR] = { -1, -1, 0, 0 };
+
+// -----------------------------------------------------------------------------
+//                                Local Functions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Saturates to the int16_t range.
+ ******************************************************************************/
+static int16_t saturate(int32_t value)
+{
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+/***************************************************************************//**
+ * Builds the tap positions and weights of each output pixel along one axis.
+ *
+ * @param length  Number of sensor pixels along the axis.
+ * @param weights Kernels of the interpolation.
+ * @param taps    Sensor pixel index of each tap, edges extended.
+ * @param kernel  Kernel of each output pixel.
+ ******************************************************************************/
+static void upscale_axis(uint8_t length,
+                         const int16_t (*weights)[4],
+                         uint8_t taps[][4],
+                         const int16_t *kernel[])
+{
+  for (uint8_t out = 0; out < length * AMG88XX_UPSCALE_FACTOR; out++) {
+    uint8_t phase = out % AMG88XX_UPSCALE_FACTOR;
+    int16_t base = (int16_t)(out / AMG88XX_UPSCALE_FACTOR)
+                   + upscale_base[phase] - 1;
+
+    for (uint8_t t = 0; t < 4; t++) {
+      int16_t index = base + t;
+      if (index < 0) {
+        index = 0;
+      } else if (index >= length) {
+        index = length - 1;
+      }
+      taps[out][t] = (uint8_t)index;
+    }
+    kernel[out] = weights[phase];
+  }
+}
+
+/***************************************************************************//**
+ * Marks a pixel as part of a hot spot, returns false if it already was.
+ ******************************************************************************/
+static bool blob_mark(uint8_t *visited, uint16_t pixel)
+{
+  uint8_t mask = (uint8_t)(1 << (pixel & 7));
+
+  if (visited[pixel >> 3] & mask) {
+    return false;
+  }
+  visited[pixel >> 3] |= mask;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//                                Global Functions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Converts a frame of raw pixel registers to fixed point temperatures.
+ ******************************************************************************/
+void amg88xx_image_convert(const uint16_t *raw,
+                           int16_t *temperature,
+                           uint16_t count,
+                           bool fahrenheit)
+{
+  // With 6 fractional bits a 0.25 degree step is 16, so shifting the 12-bit
+  // register to the top of the int16_t both scales and sign extends it.
+  if (!fahrenheit) {
+    for (uint16_t i = 0; i < count; i++) {
+      temperature[i] = (int16_t)(uint16_t)(raw[i] << 4);
+    }
+    return;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    int32_t scaled = (int32_t)(int16_t)(uint16_t)(raw[i] << 4) * 9;
+
+    // Rounded division by 5, then add 32 degrees.
+    scaled = (scaled >= 0) ? (scaled + 2) / 5 : (scaled - 2) / 5;
+    temperature[i] = saturate(scaled + (32 << AMG88XX_Q_FRAC_BITS));
+  }
+}
+
+/***************************************************************************//**
+ * Upscales an 8x8 frame to 32x32 pixels.
+ ******************************************************************************/
+void amg88xx_image_upscale(const int16_t *frame,
+                           int16_t *upscaled,
+                           enum amg88xx_upscale_t mode)
+{
+  const int16_t (*weights)[4] = upscale_weights[
+    (mode == AMG88XX_UPSCALE_BICUBIC) ? 1 : 0];
+  uint8_t column_taps[AMG88XX_UPSCALED_COLUMNS][4];
+  const int16_t *column_kernel[AMG88XX_UPSCALED_COLUMNS];
+  uint8_t row_taps[AMG88XX_UPSCALED_ROWS][4];
+  const int16_t *row_kernel[AMG88XX_UPSCALED_ROWS];
+  int16_t rows[AMG88XX_FRAME_ROWS][AMG88XX_UPSCALED_COLUMNS];
+
+  upscale_axis(AMG88XX_FRAME_COLUMNS, weights, column_taps, column_kernel);
+  upscale_axis(AMG88XX_FRAME_ROWS, weights, row_taps, row_kernel);
+
+  // Horizontal pass over the sensor rows.
+  for (uint8_t r = 0; r < AMG88XX_FRAME_ROWS; r++) {
+    const int16_t *in = &frame[r * AMG88XX_FRAME_COLUMNS];
+
+    for (uint8_t c = 0; c < AMG88XX_UPSCALED_COLUMNS; c++) {
+      const uint8_t *tap = column_taps[c];
+      const int16_t *w = column_kernel[c];
+      int32_t sum = (int32_t)w[0] * in[tap[0]]
+                    + (int32_t)w[1] * in[tap[1]]
+                    + (int32_t)w[2] * in[tap[2]]
+                    + (int32_t)w[3] * in[tap[3]];
+
+      rows[r][c] = saturate((sum + (1 << (WEIGHT_SHIFT - 1))) >> WEIGHT_SHIFT);
+    }
+  }
+
+  // Vertical pass over the upscaled columns.
+  for (uint8_t r = 0; r < AMG88XX_UPSCALED_ROWS; r++) {
+    const uint8_t *tap = row_taps[r];
+    const int16_t *w = row_kernel[r];
+    const int16_t *in0 = rows[tap[0]];
+    const int16_t *in1 = rows[tap[1]];
+    const int16_t *in2 = rows[tap[2]];
+    const int16_t *in3 = rows[tap[3]];
+    int16_t *out = &upscaled[r * AMG88XX_UPSCALED_COLUMNS];
+
+    for (uint8_t c = 0; c < AMG88XX_UPSCALED_COLUMNS; c++) {
+      int32_t sum = (int32_t)w[0] * in0[c]
+                    + (int32_t)w[1] * in1[c]
+                    + (int32_t)w[2] * in2[c]
+                    + (int32_t)w[3] * in3[c];
+
+      out[c] = saturate((sum + (1 << (WEIGHT_SHIFT - 1))) >> WEIGHT_SHIFT);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Finds the connected groups of hot pixels in a frame.
+ ******************************************************************************/
+uint16_t amg88xx_image_find_blobs(const int16_t *frame,
+                                  uint8_t width,
+                                  uint8_t height,
+                                  const amg88xx_blob_config_t *config,
+                                  amg88xx_blob_workspace_t *workspace,
+                                  amg88xx_blob_t *blobs,
+                                  uint16_t max_blobs)
+{
+  static const int8_t neighbours[8][2] = {
+    { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+    { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 },
+  };
+  uint16_t pixels = (uint16_t)width * height;
+  uint8_t neighbour_count = config->eight_connected ? 8 : 4;
+  int16_t threshold = config->threshold;
+  uint16_t found = 0;
+
+  if (pixels > AMG88XX_UPSCALED_PIXELS) {
+    return 0;
+  }
+  memset(workspace->visited, 0, (pixels + 7) / 8);
+
+  for (uint16_t start = 0; start < pixels; start++) {
+    uint32_t area = 0;
+    uint32_t sum_w = 0;
+    uint32_t sum_wx = 0;
+    uint32_t sum_wy = 0;
+    int16_t peak = INT16_MIN;
+    uint16_t top = 0;
+
+    if ((frame[start] <= threshold)
+        || !blob_mark(workspace->visited, start)) {
+      continue;
+    }
+
+    // Flood fill, every pixel is pushed at most once.
+    workspace->stack[top++] = start;
+    while (top > 0) {
+      uint16_t pixel = workspace->stack[--top];
+      uint8_t x = (uint8_t)(pixel % width);
+      uint8_t y = (uint8_t)(pixel / width);
+      int16_t value = frame[pixel];
+      uint32_t w = (uint32_t)((int32_t)value - threshold);
+
+      area++;
+      sum_w += w;
+      sum_wx += w * x;
+      sum_wy += w * y;
+      if (value > peak) {
+        peak = value;
+      }
+
+      for (uint8_t n = 0; n < neighbour_count; n++) {
+        int16_t nx = (int16_t)x + neighbours[n][0];
+        int16_t ny = (int16_t)y + neighbours[n][1];
+        uint16_t next;
+
+        if ((nx < 0) || (nx >= width) || (ny < 0) || (ny >= height)) {
+          continue;
+        }
+        next = (uint16_t)(ny * width + nx);
+        if ((frame[next] > threshold)
+            && blob_mark(workspace->visited, next)) {
+          workspace->stack[top++] = next;
+        }
+      }
+    }
+
+    if (area < config->min_area) {
+      continue;
+    }
+    if (found < max_blobs) {
+      blobs[found].area = (uint16_t)area;
+      blobs[found].x = (uint16_t)((((uint64_t)sum_wx << 8) + sum_w / 2)
+                                  / sum_w);
+      blobs[found].y = (uint16_t)((((uint64_t)sum_wy << 8) + sum_w / 2)
+                                  / sum_w);
+      blobs[found].peak = peak;
+    }
+    found++;
+  }
+
+  return found;
+}
@@ -45,6 +45,7 @@ void app_get_thermistor_temperature(sl_cli_command_arg_t *arguments);
 void app_get_thermistor_temperature_raw(sl_cli_command_arg_t *arguments);
 void app_get_sensor_array_temperatures(sl_cli_command_arg_t *arguments);
 void app_get_sensor_array_temperatures_raw(sl_cli_command_arg_t *arguments);
+void app_get_hot_spots(sl_cli_command_arg_t *arguments);
 void app_sensor_wakeup(sl_cli_command_arg_t *arguments);
 void app_sensor_sleep(sl_cli_command_arg_t *arguments);
 void app_sensor_60_sec_standby(sl_cli_command_arg_t *arguments);
@@ -87,6 +88,12 @@ static const sl_cli_command_info_t cli_cmd_get_sensor_array_temepratures_raw = \
                  "",
                  { SL_CLI_ARG_END, });
 
+static const sl_cli_command_info_t cli_cmd_get_hot_spots = \
+  SL_CLI_COMMAND(app_get_hot_spots,
+                 "Get the hot spots of the upscaled sensor array",
+                 "threshold in degrees" SL_CLI_UNIT_SEPARATOR,
+                 { SL_CLI_ARG_INT16, SL_CLI_ARG_END, });
+
 static const sl_cli_command_info_t cli_cmd_sensor_wakeup = \
   SL_CLI_COMMAND(app_sensor_wakeup,
                  "Puts the device to normal mode from any other state.",
@@ -151,6 +158,7 @@ static const sl_cli_command_entry_t temperature_group_table[] = {
   { "raw", &cli_cmd_get_thermistor_temeprature_raw, false },
   { "array", &cli_cmd_get_sensor_array_temepratures, false },
   { "array_raw", &cli_cmd_get_sensor_array_temepratures_raw, false },
+  { "hot_spots", &cli_cmd_get_hot_spots, false },
   { NULL, NULL, false },
 };
 static const sl_cli_command_info_t cli_cmd_temperature_group = \
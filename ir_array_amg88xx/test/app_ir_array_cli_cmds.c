@@ -16,10 +16,12 @@
  ******************************************************************************/
 
 #include <stdint.h>
+#include <stdlib.h>
 #include "sl_cli.h"
 #include "sl_cli_arguments.h"
 #include "sl_cli_handles.h"
 #include "ir_array_amg88xx_driver.h"
+#include "ir_array_amg88xx_image.h"
 
 void app_set_tempereture_scale(sl_cli_command_arg_t *arguments)
 {
@@ -107,6 +109,53 @@ void app_get_sensor_array_temperatures_raw(sl_cli_command_arg_t *arguments)
   }
 }
 
+void app_get_hot_spots(sl_cli_command_arg_t *arguments)
+{
+  static amg88xx_blob_workspace_t workspace;
+  int16_t temperature_grid[8][8];
+  int16_t upscaled[AMG88XX_UPSCALED_PIXELS];
+  amg88xx_blob_t blobs[4];
+  amg88xx_blob_config_t config = {
+    .threshold = (int16_t)(sl_cli_get_argument_int16(arguments, 0)
+                           * AMG88XX_Q_ONE),
+    .min_area = 8,
+    .eight_connected = true,
+  };
+  uint16_t count;
+  int peak;
+  sl_status_t read_result;
+
+  read_result = amg88xx_get_sensor_array_temperatures_q(temperature_grid);
+  if (read_result != SL_STATUS_OK) {
+    printf("Error: i2c read failed");
+    return;
+  }
+
+  amg88xx_image_upscale(&temperature_grid[0][0],
+                        upscaled,
+                        AMG88XX_UPSCALE_BILINEAR);
+  count = amg88xx_image_find_blobs(upscaled,
+                                   AMG88XX_UPSCALED_COLUMNS,
+                                   AMG88XX_UPSCALED_ROWS,
+                                   &config,
+                                   &workspace,
+                                   blobs,
+                                   4);
+  printf("Hot spots: %u\n", count);
+  for (uint16_t i = 0; (i < count) && (i < 4); i++) {
+    // Centroids of the 32x32 frame, with 8 fractional bits.
+    // The sign is printed apart, the integer part of -0.5 is 0.
+    peak = abs(blobs[i].peak);
+    printf("x: %u.%02u, y: %u.%02u, area: %u, peak: %s%d.%02d\n",
+           blobs[i].x >> 8, ((blobs[i].x & 0xFF) * 100) >> 8,
+           blobs[i].y >> 8, ((blobs[i].y & 0xFF) * 100) >> 8,
+           blobs[i].area,
+           (blobs[i].peak < 0) ? "-" : "",
+           peak / AMG88XX_Q_ONE,
+           ((peak % AMG88XX_Q_ONE) * 100) / AMG88XX_Q_ONE);
+  }
+}
+
 void app_sensor_wakeup(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
@@ -0,0 +1,393 @@
+/***************************************************************************//**
+ * @file  ir_array_amg88xx_image_test.c
+ * @brief Host test and benchmark of the AMG88xx frame pipeline.
+ *
+ * Converts synthetic frames with two people in front of a warm background,
+ * upscales them to 32x32 and finds the hot spots. Checks the conversion, the
+ * interpolation against a float reference and the hot spot centroids, then
+ * measures the time per frame of each stage next to the float path.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc ir_array_amg88xx_image_test.c \
+ *     ../src/ir_array_amg88xx_image.c -lm
+ *   ./a.out
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <ir_array_amg88xx_image.h>
+
+// Frames processed by the benchmark
+#define BENCHMARK_FRAMES        20000
+
+// Largest difference to the float interpolation, in 1/64 degree
+#define INTERPOLATION_TOLERANCE 2
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+// Person in the synthetic frame, in sensor pixel coordinates
+typedef struct {
+  float x;
+  float y;
+  float degrees;
+} person_t;
+
+static int failed = 0;
+
+// Keeps the benchmark loops from being optimized away
+static volatile int32_t sink;
+
+/***************************************************************************//**
+ * Encodes degrees celsius as a 12-bit two's complement pixel register.
+ ******************************************************************************/
+static uint16_t pixel_register(float degrees)
+{
+  return (uint16_t)((int16_t)lroundf(degrees * 4.0f) & 0x0FFF);
+}
+
+/***************************************************************************//**
+ * Renders a 22 degree room with people as gaussian spots, plus noise.
+ ******************************************************************************/
+static void render_frame(uint16_t raw[AMG88XX_FRAME_PIXELS],
+                         const person_t *people,
+                         int count,
+                         unsigned int seed)
+{
+  srand(seed);
+  for (int r = 0; r < AMG88XX_FRAME_ROWS; r++) {
+    for (int c = 0; c < AMG88XX_FRAME_COLUMNS; c++) {
+      float degrees = 22.0f + (float)(rand() % 5 - 2) * 0.25f;
+
+      for (int p = 0; p < count; p++) {
+        float dx = (float)c - people[p].x;
+        float dy = (float)r - people[p].y;
+        degrees += (people[p].degrees - 22.0f)
+                   * expf(-(dx * dx + dy * dy) / 1.5f);
+      }
+      raw[r * AMG88XX_FRAME_COLUMNS + c] = pixel_register(degrees);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Float reference, the per pixel conversion of the driver.
+ ******************************************************************************/
+static void convert_float(const uint16_t *raw, float *degrees)
+{
+  for (int i = 0; i < AMG88XX_FRAME_PIXELS; i++) {
+    degrees[i] = (float)((int16_t)(raw[i] << 4) >> 4) * 0.25f;
+  }
+}
+
+/***************************************************************************//**
+ * Float reference of the bilinear upscaler, edges extended.
+ ******************************************************************************/
+static void upscale_float(const float *frame, float *upscaled)
+{
+  for (int r = 0; r < AMG88XX_UPSCALED_ROWS; r++) {
+    float y = ((float)r + 0.5f) / AMG88XX_UPSCALE_FACTOR - 0.5f;
+    int y0 = (int)floorf(y);
+    float fy = y - (float)y0;
+    int ya = (y0 < 0) ? 0 : y0;
+    int yb = (y0 + 1 >= AMG88XX_FRAME_ROWS) ? AMG88XX_FRAME_ROWS - 1 : y0 + 1;
+
+    for (int c = 0; c < AMG88XX_UPSCALED_COLUMNS; c++) {
+      float x = ((float)c + 0.5f) / AMG88XX_UPSCALE_FACTOR - 0.5f;
+      int x0 = (int)floorf(x);
+      float fx = x - (float)x0;
+      int xa = (x0 < 0) ? 0 : x0;
+      int xb = (x0 + 1 >= AMG88XX_FRAME_COLUMNS)
+               ? AMG88XX_FRAME_COLUMNS - 1 : x0 + 1;
+      float top = frame[ya * 8 + xa] * (1.0f - fx) + frame[ya * 8 + xb] * fx;
+      float bottom = frame[yb * 8 + xa] * (1.0f - fx)
+                     + frame[yb * 8 + xb] * fx;
+
+      upscaled[r * AMG88XX_UPSCALED_COLUMNS + c] = top * (1.0f - fy)
+                                                   + bottom * fy;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Checks the register conversion.
+ ******************************************************************************/
+static void test_convert(void)
+{
+  static const uint16_t raw[] = { 0x0064, 0x0000, 0x0FFF, 0x0F38, 0x07FF };
+  int16_t celsius[5];
+  int16_t fahrenheit[5];
+
+  amg88xx_image_convert(raw, celsius, 5, false);
+  amg88xx_image_convert(raw, fahrenheit, 5, true);
+
+  CHECK(celsius[0] == AMG88XX_Q_FROM_DEGREES(25));
+  CHECK(celsius[1] == 0);
+  CHECK(celsius[2] == -AMG88XX_Q_ONE / 4);
+  CHECK(celsius[3] == AMG88XX_Q_FROM_DEGREES(-50));
+  CHECK(celsius[4] == AMG88XX_Q_FROM_DEGREES(511.75));
+  CHECK(fahrenheit[0] == AMG88XX_Q_FROM_DEGREES(77));
+  CHECK(fahrenheit[1] == AMG88XX_Q_FROM_DEGREES(32));
+  CHECK(fahrenheit[3] == AMG88XX_Q_FROM_DEGREES(-58));
+  // 953.15 degrees fahrenheit saturates
+  CHECK(fahrenheit[4] == INT16_MAX);
+}
+
+/***************************************************************************//**
+ * Checks the upscalers on flat, ramp and real frames.
+ ******************************************************************************/
+static void test_upscale(void)
+{
+  static const person_t people[] = { { 2.0f, 3.0f, 32.0f } };
+  uint16_t raw[AMG88XX_FRAME_PIXELS];
+  int16_t frame[AMG88XX_FRAME_PIXELS];
+  int16_t upscaled[AMG88XX_UPSCALED_PIXELS];
+  float frame_f[AMG88XX_FRAME_PIXELS];
+  float upscaled_f[AMG88XX_UPSCALED_PIXELS];
+  int worst = 0;
+
+  // A flat frame stays flat with both kernels.
+  for (int i = 0; i < AMG88XX_FRAME_PIXELS; i++) {
+    frame[i] = AMG88XX_Q_FROM_DEGREES(21.25);
+  }
+  for (int mode = 0; mode < 2; mode++) {
+    int flat = 1;
+    amg88xx_image_upscale(frame, upscaled, (enum amg88xx_upscale_t)mode);
+    for (int i = 0; i < AMG88XX_UPSCALED_PIXELS; i++) {
+      flat &= (upscaled[i] == frame[0]);
+    }
+    CHECK(flat);
+  }
+
+  // A horizontal ramp of 1 degree per pixel is exact away from the edges.
+  for (int i = 0; i < AMG88XX_FRAME_PIXELS; i++) {
+    frame[i] = AMG88XX_Q_FROM_DEGREES(20 + i % 8);
+  }
+  for (int mode = 0; mode < 2; mode++) {
+    amg88xx_image_upscale(frame, upscaled, (enum amg88xx_upscale_t)mode);
+    // Columns 10 and 13 are centered at sensor coordinates 2.125 and 2.875
+    CHECK(upscaled[5 * 32 + 10] == AMG88XX_Q_FROM_DEGREES(22.125));
+    CHECK(upscaled[31 * 32 + 13] == AMG88XX_Q_FROM_DEGREES(22.875));
+  }
+
+  // Fixed point bilinear matches the float reference.
+  render_frame(raw, people, 1, 1);
+  amg88xx_image_convert(raw, frame, AMG88XX_FRAME_PIXELS, false);
+  convert_float(raw, frame_f);
+  amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BILINEAR);
+  upscale_float(frame_f, upscaled_f);
+  for (int i = 0; i < AMG88XX_UPSCALED_PIXELS; i++) {
+    int error = abs(upscaled[i]
+                    - (int)lroundf(upscaled_f[i] * AMG88XX_Q_ONE));
+    if (error > worst) {
+      worst = error;
+    }
+  }
+  printf("bilinear: worst difference to float %d/%d degree\n",
+         worst, AMG88XX_Q_ONE);
+  CHECK(worst <= INTERPOLATION_TOLERANCE);
+
+  // Catmull-Rom keeps the peak closer to the sensor pixel.
+  amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BICUBIC);
+  CHECK(upscaled[13 * 32 + 9] > AMG88XX_Q_FROM_DEGREES(28));
+}
+
+/***************************************************************************//**
+ * Checks the hot spot detector on two people.
+ ******************************************************************************/
+static void test_blobs(void)
+{
+  static const person_t people[] = {
+    { 1.5f, 2.0f, 34.0f },
+    { 5.5f, 5.0f, 33.0f },
+  };
+  amg88xx_blob_config_t config = {
+    .threshold = AMG88XX_Q_FROM_DEGREES(26),
+    .min_area = 4,
+    .eight_connected = true,
+  };
+  static amg88xx_blob_workspace_t workspace;
+  uint16_t raw[AMG88XX_FRAME_PIXELS];
+  int16_t frame[AMG88XX_FRAME_PIXELS];
+  int16_t upscaled[AMG88XX_UPSCALED_PIXELS];
+  amg88xx_blob_t blobs[4];
+  uint16_t count;
+
+  render_frame(raw, people, 2, 2);
+  amg88xx_image_convert(raw, frame, AMG88XX_FRAME_PIXELS, false);
+  amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BILINEAR);
+  count = amg88xx_image_find_blobs(upscaled,
+                                   AMG88XX_UPSCALED_COLUMNS,
+                                   AMG88XX_UPSCALED_ROWS,
+                                   &config, &workspace, blobs, 4);
+  CHECK(count == 2);
+  for (int b = 0; (b < count) && (b < 2); b++) {
+    // Back to sensor pixel coordinates
+    float x = ((float)blobs[b].x / 256.0f + 0.5f) / 4.0f - 0.5f;
+    float y = ((float)blobs[b].y / 256.0f + 0.5f) / 4.0f - 0.5f;
+
+    printf("hot spot %d: area %u, centroid %.2f,%.2f, peak %.2f\n",
+           b, blobs[b].area, x, y, (float)blobs[b].peak / AMG88XX_Q_ONE);
+    CHECK(fabsf(x - people[b].x) < 0.25f);
+    CHECK(fabsf(y - people[b].y) < 0.25f);
+    CHECK(blobs[b].peak > AMG88XX_Q_FROM_DEGREES(29));
+  }
+
+  // Only the count is returned beyond max_blobs.
+  CHECK(amg88xx_image_find_blobs(upscaled, 32, 32, &config, &workspace,
+                                 blobs, 1) == 2);
+
+  // The same spots on the sensor frame, and the minimum area.
+  count = amg88xx_image_find_blobs(frame, 8, 8, &config, &workspace,
+                                   blobs, 4);
+  CHECK(count == 2);
+  config.min_area = 1000;
+  CHECK(amg88xx_image_find_blobs(upscaled, 32, 32, &config, &workspace,
+                                 blobs, 4) == 0);
+
+  // Two pixels touching at a corner only join with 8-connectivity.
+  for (int i = 0; i < AMG88XX_FRAME_PIXELS; i++) {
+    frame[i] = 0;
+  }
+  frame[2 * 8 + 2] = AMG88XX_Q_FROM_DEGREES(30);
+  frame[3 * 8 + 3] = AMG88XX_Q_FROM_DEGREES(30);
+  config.min_area = 1;
+  config.eight_connected = true;
+  CHECK(amg88xx_image_find_blobs(frame, 8, 8, &config, &workspace,
+                                 blobs, 4) == 1);
+  CHECK(blobs[0].x == (uint16_t)(2.5 * 256) && blobs[0].area == 2);
+  config.eight_connected = false;
+  CHECK(amg88xx_image_find_blobs(frame, 8, 8, &config, &workspace,
+                                 blobs, 4) == 2);
+}
+
+/***************************************************************************//**
+ * Returns the time per frame of a benchmark loop in ns.
+ ******************************************************************************/
+static double ns_per_frame(clock_t start)
+{
+  return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / BENCHMARK_FRAMES;
+}
+
+/***************************************************************************//**
+ * Measures each stage of the pipeline.
+ ******************************************************************************/
+static void benchmark(void)
+{
+  static const person_t people[] = {
+    { 1.5f, 2.0f, 34.0f },
+    { 5.5f, 5.0f, 33.0f },
+  };
+  amg88xx_blob_config_t config = {
+    .threshold = AMG88XX_Q_FROM_DEGREES(26),
+    .min_area = 4,
+    .eight_connected = true,
+  };
+  static amg88xx_blob_workspace_t workspace;
+  uint16_t raw[AMG88XX_FRAME_PIXELS];
+  int16_t frame[AMG88XX_FRAME_PIXELS];
+  int16_t upscaled[AMG88XX_UPSCALED_PIXELS];
+  float frame_f[AMG88XX_FRAME_PIXELS];
+  float upscaled_f[AMG88XX_UPSCALED_PIXELS];
+  amg88xx_blob_t blobs[4];
+  double convert_ns, bilinear_ns, bicubic_ns, blobs_ns;
+  double convert_f_ns, bilinear_f_ns;
+  clock_t start;
+
+  render_frame(raw, people, 2, 3);
+
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    raw[i & 63] ^= 1;
+    amg88xx_image_convert(raw, frame, AMG88XX_FRAME_PIXELS, false);
+    sink += frame[i & 63];
+  }
+  convert_ns = ns_per_frame(start);
+
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    raw[i & 63] ^= 1;
+    convert_float(raw, frame_f);
+    sink += (int32_t)frame_f[i & 63];
+  }
+  convert_f_ns = ns_per_frame(start);
+
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    frame[i & 63] ^= 1;
+    amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BILINEAR);
+    sink += upscaled[i & 1023];
+  }
+  bilinear_ns = ns_per_frame(start);
+
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    frame[i & 63] ^= 1;
+    amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BICUBIC);
+    sink += upscaled[i & 1023];
+  }
+  bicubic_ns = ns_per_frame(start);
+
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    frame_f[i & 63] += 0.25f;
+    upscale_float(frame_f, upscaled_f);
+    sink += (int32_t)upscaled_f[i & 1023];
+  }
+  bilinear_f_ns = ns_per_frame(start);
+
+  amg88xx_image_upscale(frame, upscaled, AMG88XX_UPSCALE_BILINEAR);
+  start = clock();
+  for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+    config.threshold ^= 1;
+    sink += amg88xx_image_find_blobs(upscaled, 32, 32, &config, &workspace,
+                                     blobs, 4);
+  }
+  blobs_ns = ns_per_frame(start);
+
+  printf("per frame: convert %.0f ns (float %.0f ns), "
+         "bilinear %.0f ns (float %.0f ns), bicubic %.0f ns, "
+         "hot spots %.0f ns\n",
+         convert_ns, convert_f_ns, bilinear_ns, bilinear_f_ns,
+         bicubic_ns, blobs_ns);
+}
+
+int main(void)
+{
+  test_convert();
+  test_upscale();
+  test_blobs();
+  benchmark();
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
@@ -0,0 +1,132 @@
+/***************************************************************************//**
+ * @file ir_encode.h
+ * @brief IR protocol encoder, mark/space durations.
+ * @version 0.0.1
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2018 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef __IRENCODE_H__
+
+/***************************************************************************//**
+ * @addtogroup IR Encoder
+ * @brief IR Encoder
+ *   Encodes IR frames as a list of mark and space durations, without any
+ *   hardware dependency. The IR Generator Driver plays the list with the
+ *   LDMA.
+ * @{
+ ******************************************************************************/
+
+#define __IRENCODE_H__
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------
+  define / Typedef
+  ----------------------------------------------*/
+#define IR_DURATION_MAX					200
+
+typedef enum {
+  CODE_NEC,
+  CODE_SONY,
+  CODE_NEC_EXT,
+  CODE_RC5,
+  CODE_RC6,
+  CODE_NUM
+}code_t;
+
+typedef struct {
+  uint16_t duration[IR_DURATION_MAX];	// us, marks at even, spaces at odd index
+  uint16_t count;						// odd, the list ends with a mark
+}ir_timing_t;
+
+/*----------------------------------------------
+  prototype
+  ----------------------------------------------*/
+
+/**
+ * @brief Encodes a frame as mark/space durations.
+ *
+ * @param timing list of durations to fill
+ * @param code IR protocol
+ * @param address device address: NEC 8 bits, NEC extended 16 bits,
+ *                SONY 7 bits, RC5 5 bits, RC6 8 bits
+ * @param command command: 8 bits, RC5 7 bits (6 bits, or RC5X)
+ * @param repeat NEC and NEC extended: send the repeat code
+ * @param toggle RC5/RC6 toggle bit, flipped on each new key press
+ *
+ * @return false if the code is unknown
+ *
+ */
+extern bool ir_encode_frame(ir_timing_t *timing, code_t code,
+                            uint16_t address, uint16_t command,
+                            bool repeat, bool toggle);
+
+/**
+ * @brief Copies raw mark/space durations.
+ *
+ * @param timing list of durations to fill
+ * @param duration durations in us, starting with a mark
+ * @param count number of durations, a trailing space is dropped
+ *
+ * @return false if the durations do not fit or start with a 0 us mark
+ *
+ */
+extern bool ir_encode_raw(ir_timing_t *timing, const uint16_t *duration,
+                          uint16_t count);
+
+/**
+ * @brief Returns the carrier frequency of a protocol.
+ *
+ * @param code IR protocol
+ *
+ * @return carrier frequency in Hz
+ *
+ */
+extern uint32_t ir_encode_carrier(code_t code);
+
+/**
+ * @brief Converts the durations to TIMER TOP values.
+ *
+ * @param timing list of durations
+ * @param timer_hz frequency the TIMER counts at
+ * @param max_top largest TOP of the TIMER
+ * @param top TOP of each duration, timing->count values
+ *
+ * @return none
+ *
+ */
+extern void ir_encode_top(const ir_timing_t *timing, uint32_t timer_hz,
+                          uint32_t max_top, uint32_t *top);
+
+#ifdef __cplusplus
+}
+#endif
+/** @} (end addtogroup IR Encoder) */
+#endif
@@ -40,6 +40,7 @@
 #define __IRGENELATE_H__
 #include "em_gpio.h"
 #include "em_timer.h"
+#include "ir_encode.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,36 +55,23 @@ extern "C" {
 #define BSP_MODULATION_PORT	gpioPortD
 #define BSP_MODULATION_PIN	3
 
-#define TABLE_INDEX_NUM					18
-#define NEC_REPEAT_HEAD_SPACE_BIT_SIZE	4
-#define BIT(n)							(1<<n)
-#define STREAM_BIT_NUM					(200)
+// LDMA channel writing the mark/space durations to TIMER1
+#ifndef IR_LDMA_CHANNEL
+#define IR_LDMA_CHANNEL		0
+#endif
 
-typedef enum {
-  CODE_NEC,
-  CODE_SONY,
-  CODE_NUM
-}code_t;
+// TIMER1 counts the durations at about this frequency
+#define IR_TIMEBASE_HZ		1000000
 
-typedef enum {
-  HEAD_PULSE,
-  HEAD_SPACE,
-  HEAD_NUM
-}head_t;
+#define TABLE_INDEX_NUM					18
+#define BIT(n)							(1<<n)
 
 typedef struct {
   code_t code;
-  uint16_t carrier[CODE_NUM];
-  uint16_t timebase[CODE_NUM];
-  float dutycycle[CODE_NUM];
-  uint8_t head_bit_size[CODE_NUM][HEAD_NUM];
-  uint8_t address_length[CODE_NUM];
-  uint8_t command_length[CODE_NUM];
-
-  uint8_t index;
-  uint8_t stream_index;
-  bool stream_active;
-  bool stream[STREAM_BIT_NUM];
+  bool toggle;									// RC5/RC6 toggle bit of the last key
+  volatile bool stream_active;
+  ir_timing_t timing;							// frame being sent, in us
+  uint32_t top[IR_DURATION_MAX + 2];			// TIMER1 TOP of each duration
 }ir_t;
 
 typedef void (*ir_callback_t)(void);
@@ -114,14 +102,38 @@ extern void ir_generate_init(code_t ir_code,ir_callback_t cb);
  */
 extern void ir_generate_stop(void);
 /**
- * @brief configure ir signal stream.
+ * @brief configure ir signal stream and start sending it.
+ *
+ * @param address, command, repeat flag for NEC protocol, or key held for
+ *        RC5/RC6 (the toggle bit is not flipped)
+ *
+ * @return false if the last stream is still being sent
+ *
+ */
+extern bool ir_generate_stream(uint16_t address, uint16_t command, bool repeat);
+
+/**
+ * @brief start sending raw mark/space durations at the carrier of the
+ *        IR code/protocol.
+ *
+ * @param duration durations in us, starting with a mark
+ * @param count number of durations, up to IR_DURATION_MAX
+ *
+ * @return false if the last stream is still being sent or the durations
+ *         are not valid
+ *
+ */
+extern bool ir_generate_raw(const uint16_t *duration, uint16_t count);
+
+/**
+ * @brief check if a stream is being sent.
  *
  * @param none
  *
- * @return none
+ * @return true until the callback of the stream is called
  *
  */
-extern void ir_generate_stream(uint16_t address, uint16_t command, bool repeat);
+extern bool ir_generate_is_busy(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,326 @@
+/***************************************************************************//**
+ * @file ir_encode.c
+ * @brief IR protocol encoder, mark/space durations.
+ * @version 0.0.1
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2018 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include "ir_encode.h"
+
+// NEC timing in us
+#define NEC_HEAD_MARK			9000
+#define NEC_HEAD_SPACE			4500
+#define NEC_REPEAT_SPACE		2250
+#define NEC_BIT_MARK			560
+#define NEC_ZERO_SPACE			560
+#define NEC_ONE_SPACE			1690
+
+// SONY SIRC timing in us
+#define SONY_HEAD_MARK			2400
+#define SONY_ZERO_MARK			600
+#define SONY_ONE_MARK			1200
+#define SONY_SPACE				600
+
+// RC5 half bit and RC6 unit in us
+#define RC5_HALF_BIT			889
+#define RC6_UNIT				444
+
+static const uint32_t ir_carrier[CODE_NUM] = {
+  38000,	// NEC
+  40000,	// SONY
+  38000,	// NEC extended
+  36000,	// RC5
+  36000,	// RC6
+};
+
+/*
+ * Appends a mark or a space. A duration at the level of the last one is
+ * merged into it, which builds the Manchester codes from half bits, and a
+ * leading space is dropped as the line idles there anyway.
+ */
+static bool ir_timing_add(ir_timing_t *timing, bool mark, uint16_t us)
+{
+  bool last_mark = (timing->count & 1) != 0;
+
+  if (timing->count == 0) {
+    if (!mark)
+      return true;
+  } else if (mark == last_mark) {
+    timing->duration[timing->count - 1] += us;
+    return true;
+  }
+
+  if (timing->count >= IR_DURATION_MAX)
+    return false;
+
+  timing->duration[timing->count++] = us;
+  return true;
+}
+
+// NEC, NEC extended and SONY send LSB first
+static bool ir_encode_pulse_bits(ir_timing_t *timing, code_t code,
+                                 uint32_t data, uint8_t length)
+{
+  bool ok = true;
+
+  for (uint8_t i = 0; i < length; i++, data >>= 1) {
+    if (code == CODE_SONY) {
+      ok &= ir_timing_add(timing, true, (data & 1) ? SONY_ONE_MARK : SONY_ZERO_MARK);
+      ok &= ir_timing_add(timing, false, SONY_SPACE);
+    } else {
+      ok &= ir_timing_add(timing, true, NEC_BIT_MARK);
+      ok &= ir_timing_add(timing, false, (data & 1) ? NEC_ONE_SPACE : NEC_ZERO_SPACE);
+    }
+  }
+  return ok;
+}
+
+/*
+ * RC5 and RC6 send MSB first, each bit as two half bits of opposite level.
+ * RC5 sends a 1 as space then mark, RC6 as mark then space.
+ */
+static bool ir_encode_manchester(ir_timing_t *timing, bool one_first_mark,
+                                 uint32_t data, uint8_t length, uint16_t half)
+{
+  bool ok = true;
+
+  while (length-- > 0) {
+    bool first = (((data >> length) & 1) != 0) == one_first_mark;
+
+    ok &= ir_timing_add(timing, first, half);
+    ok &= ir_timing_add(timing, !first, half);
+  }
+  return ok;
+}
+
+static bool ir_encode_nec(ir_timing_t *timing, bool extended,
+                          uint16_t address, uint16_t command, bool repeat)
+{
+  bool ok = ir_timing_add(timing, true, NEC_HEAD_MARK);
+  code_t code = extended ? CODE_NEC_EXT : CODE_NEC;
+
+  if (repeat) {
+    ok &= ir_timing_add(timing, false, NEC_REPEAT_SPACE);
+  } else {
+    ok &= ir_timing_add(timing, false, NEC_HEAD_SPACE);
+
+    // address -> address complemented (or address high byte) -> command -> command complemented
+    if (extended) {
+      ok &= ir_encode_pulse_bits(timing, code, address, 16);
+    } else {
+      ok &= ir_encode_pulse_bits(timing, code, address, 8);
+      ok &= ir_encode_pulse_bits(timing, code, (uint8_t)~address, 8);
+    }
+    ok &= ir_encode_pulse_bits(timing, code, command, 8);
+    ok &= ir_encode_pulse_bits(timing, code, (uint8_t)~command, 8);
+  }
+
+  // Send trailing (pulse)
+  ok &= ir_timing_add(timing, true, NEC_BIT_MARK);
+  return ok;
+}
+
+static bool ir_encode_sony(ir_timing_t *timing, uint16_t address, uint16_t command)
+{
+  bool ok = ir_timing_add(timing, true, SONY_HEAD_MARK);
+
+  ok &= ir_timing_add(timing, false, SONY_SPACE);
+
+  // command -> address, 8 and 7 bits as in earlier versions of the driver
+  ok &= ir_encode_pulse_bits(timing, CODE_SONY, command, 8);
+  ok &= ir_encode_pulse_bits(timing, CODE_SONY, address, 7);
+  return ok;
+}
+
+static bool ir_encode_rc5(ir_timing_t *timing, uint16_t address, uint16_t command,
+                          bool toggle)
+{
+  uint32_t frame;
+
+  // S1, S2 (inverted command bit 6, RC5X), toggle, 5 address bits, 6 command bits
+  frame = 1;
+  frame = (frame << 1) | ((command & 0x40) ? 0 : 1);
+  frame = (frame << 1) | (toggle ? 1 : 0);
+  frame = (frame << 5) | (address & 0x1F);
+  frame = (frame << 6) | (command & 0x3F);
+
+  return ir_encode_manchester(timing, false, frame, 14, RC5_HALF_BIT);
+}
+
+static bool ir_encode_rc6(ir_timing_t *timing, uint16_t address, uint16_t command,
+                          bool toggle)
+{
+  bool ok = ir_timing_add(timing, true, 6 * RC6_UNIT);
+
+  ok &= ir_timing_add(timing, false, 2 * RC6_UNIT);
+
+  // start bit 1, mode 0
+  ok &= ir_encode_manchester(timing, true, 0x8, 4, RC6_UNIT);
+
+  // trailer bit of double width carries the toggle
+  ok &= ir_encode_manchester(timing, true, toggle ? 1 : 0, 1, 2 * RC6_UNIT);
+
+  ok &= ir_encode_manchester(timing, true,
+                             ((uint32_t)(address & 0xFF) << 8) | (command & 0xFF),
+                             16, RC6_UNIT);
+  return ok;
+}
+
+/**
+ * @brief Encodes a frame as mark/space durations.
+ *
+ * @param timing list of durations to fill
+ * @param code IR protocol
+ * @param address device address
+ * @param command command
+ * @param repeat NEC and NEC extended: send the repeat code
+ * @param toggle RC5/RC6 toggle bit
+ *
+ * @return false if the code is unknown
+ *
+ */
+bool ir_encode_frame(ir_timing_t *timing, code_t code,
+                     uint16_t address, uint16_t command,
+                     bool repeat, bool toggle)
+{
+  bool ok;
+
+  timing->count = 0;
+
+  switch (code) {
+    case CODE_NEC:
+    case CODE_NEC_EXT:
+      ok = ir_encode_nec(timing, (code == CODE_NEC_EXT), address, command, repeat);
+      break;
+
+    case CODE_SONY:
+      ok = ir_encode_sony(timing, address, command);
+      break;
+
+    case CODE_RC5:
+      ok = ir_encode_rc5(timing, address, command, toggle);
+      break;
+
+    case CODE_RC6:
+      ok = ir_encode_rc6(timing, address, command, toggle);
+      break;
+
+    default:
+      ok = false;
+      break;
+  }
+
+  // the line idles as a space after the frame
+  if ((timing->count & 1) == 0 && timing->count > 0)
+    timing->count--;
+
+  return ok;
+}
+
+/**
+ * @brief Copies raw mark/space durations.
+ *
+ * @param timing list of durations to fill
+ * @param duration durations in us, starting with a mark
+ * @param count number of durations
+ *
+ * @return false if the durations do not fit or start with a 0 us mark
+ *
+ */
+bool ir_encode_raw(ir_timing_t *timing, const uint16_t *duration, uint16_t count)
+{
+  timing->count = 0;
+
+  if ((duration == NULL) || (count == 0) || (duration[0] == 0))
+    return false;
+
+  // a trailing space is the idle line
+  if ((count & 1) == 0)
+    count--;
+
+  if (count > IR_DURATION_MAX)
+    return false;
+
+  for (uint16_t i = 0; i < count; i++)
+    timing->duration[i] = duration[i];
+  timing->count = count;
+
+  return true;
+}
+
+/**
+ * @brief Returns the carrier frequency of a protocol.
+ *
+ * @param code IR protocol
+ *
+ * @return carrier frequency in Hz
+ *
+ */
+uint32_t ir_encode_carrier(code_t code)
+{
+  if (code >= CODE_NUM)
+    return ir_carrier[CODE_NEC];
+
+  return ir_carrier[code];
+}
+
+/**
+ * @brief Converts the durations to TIMER TOP values.
+ *
+ * @details
+ *   Each duration is rounded against the end time of the frame, so that the
+ *   rounding errors do not add up over the frame.
+ *
+ * @param timing list of durations
+ * @param timer_hz frequency the TIMER counts at
+ * @param max_top largest TOP of the TIMER
+ * @param top TOP of each duration, timing->count values
+ *
+ * @return none
+ *
+ */
+void ir_encode_top(const ir_timing_t *timing, uint32_t timer_hz,
+                   uint32_t max_top, uint32_t *top)
+{
+  uint32_t end_us = 0;
+  uint32_t elapsed = 0;
+  uint32_t end, ticks;
+
+  for (uint16_t i = 0; i < timing->count; i++) {
+    end_us += timing->duration[i];
+    end = (uint32_t)(((uint64_t)end_us * timer_hz + 500000) / 1000000);
+    ticks = (end > elapsed) ? end - elapsed : 0;
+
+    if (ticks < 2)
+      ticks = 2;
+    else if (ticks > max_top + 1)
+      ticks = max_top + 1;
+
+    elapsed += ticks;
+    top[i] = ticks - 1;
+  }
+}
@@ -33,6 +33,7 @@
 #include "em_emu.h"
 #include "em_chip.h"
 #include "em_gpio.h"
+#include "em_ldma.h"
 #include "em_prs.h"
 #include "em_timer.h"
 #include "ir_generate.h"
@@ -60,151 +61,149 @@ const uint8_t ir_table[TABLE_INDEX_NUM][2] = {
 
 static ir_t ir = {
   .code = CODE_NEC,
-  .carrier = {38000, 40000},
-  .timebase = {1769, 1659},
-  .dutycycle = {0.335, 0.335},
-  .head_bit_size = {{16,8}, {4,1}},
-  .address_length = {8,7},
-  .command_length = {8,8},
+  .toggle = false,
   .stream_active = false,
-  .stream_index = 0,
 };
 
 static ir_callback_t ir_complete_callback = 0;
 
-__STATIC_INLINE void ir_generate_stream_head(bool * stream, bool repeat)
+// TIMER1 frequency, set by ir_generate_timebase()
+static uint32_t ir_timebase_freq = IR_TIMEBASE_HZ;
+
+// space before the first mark, and after the last one while the LDMA ends
+#define IR_GUARD_TICKS		100
+
+static LDMA_Descriptor_t ir_descriptor;
+
+/*
+ * TIMER1 toggles the modulation output on each overflow, and the LDMA writes
+ * the TOP of the next duration to the TOP buffer on each overflow, so the
+ * frame is sent without the CPU. The last transfer happens when the last
+ * mark ends.
+ */
+__STATIC_INLINE void ir_generate_start(void)
 {
-  uint8_t i;
-  uint8_t spaceSize = ir.head_bit_size[ir.code][HEAD_SPACE];
+  LDMA_TransferCfg_t transfer = LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_TIMER1_UFOF);
+
+  ir_encode_top(&ir.timing, ir_timebase_freq, TIMER_MaxCount(TIMER1), ir.top);
+  ir.top[ir.timing.count] = IR_GUARD_TICKS;
+  ir.top[ir.timing.count + 1] = IR_GUARD_TICKS;
+
+  ir.stream_active = true;
+
+  // guard space, then the first mark from the TOP buffer
+  TIMER_CounterSet(TIMER1, 0);
+  TIMER_TopSet(TIMER1, IR_GUARD_TICKS);
+  TIMER_TopBufSet(TIMER1, ir.top[0]);
+
+  // the rest of the durations and the two guards
+  ir_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(&ir.top[1],
+                                                                     &TIMER1->TOPB,
+                                                                     ir.timing.count + 1);
+  ir_descriptor.xfer.size = ldmaCtrlSizeWord;
+  LDMA_StartTransfer(IR_LDMA_CHANNEL, &transfer, &ir_descriptor);
 
-  if ((repeat == true) && (ir.code == CODE_NEC)){
-	spaceSize = NEC_REPEAT_HEAD_SPACE_BIT_SIZE; //2.25ms for repeat stream
+  TIMER_Enable(TIMER0, true);
+  TIMER_Enable(TIMER1, true);
+}
+
+/**
+ * @brief configure ir signal stream and start sending it.
+ *
+ * @param address, command, repeat flag for NEC protocol, or key held for
+ *        RC5/RC6 (the toggle bit is not flipped)
+ *
+ * @return false if the last stream is still being sent
+ *
+ */
+bool ir_generate_stream(uint16_t address, uint16_t command, bool repeat)
+{
+  if (ir.stream_active){
+    return false;
   }
 
-  // pulse, NEC: 16 for 9ms, SONY: 4 for 2.4ms
-  for (i = 0; i < ir.head_bit_size[ir.code][HEAD_PULSE]; i++){
-	stream[ir.index++] = true;
+  // RC5/RC6 flip the toggle bit on each new key press
+  if (repeat == false){
+    ir.toggle = !ir.toggle;
   }
 
-  // space, NEC: 8 for 4.5ms, SONY: 1 for 0.6ms
-  for (i = 0; i < spaceSize; i++){
-	stream[ir.index++] = false;
+  if (!ir_encode_frame(&ir.timing, ir.code, address, command, repeat, ir.toggle)){
+    return false;
   }
+
+  ir_generate_start();
+  return true;
 }
 
-__STATIC_INLINE void ir_generate_stream_logic(bool * stream, bool bit)
+/**
+ * @brief start sending raw mark/space durations at the carrier of the
+ *        IR code/protocol.
+ *
+ * @param duration durations in us, starting with a mark
+ * @param count number of durations, up to IR_DURATION_MAX
+ *
+ * @return false if the last stream is still being sent or the durations
+ *         are not valid
+ *
+ */
+bool ir_generate_raw(const uint16_t *duration, uint16_t count)
 {
-  bool * start_point = stream;
-  switch (ir.code) {
-    case CODE_NEC:
-      // 1(1 pulse, 3 spaces),0(1 pulse, 1 space)
-      *stream++ = true;
-      *stream++ = false;
-      if (bit){
-        *stream++ = false;
-        *stream++ = false;
-      }
-      break;
-
-    case CODE_SONY:
-	  // 1(2 pulse, 1 spaces), 0(1 pulse, 1 space)
-      *stream++ = true;
-      if (bit){
-        *stream++ = true;
-      }
-      *stream++ = false;
-      break;
-
-    default:
-      *stream = false;
-      break;
+  if (ir.stream_active){
+    return false;
   }
-  ir.index += (stream - start_point);
-}
 
-__STATIC_INLINE void ir_generate_stream_byte(uint16_t stream_data, uint8_t length)
-{
-  //NEC, SONY send in LSB
-  for (uint8_t i = 0; i < length; i++){
-    ir_generate_stream_logic(&ir.stream[ir.index], (stream_data&BIT(0)));
-    stream_data >>= 1; //move left to get next bit
+  if (!ir_encode_raw(&ir.timing, duration, count)){
+    return false;
   }
+
+  ir_generate_start();
+  return true;
 }
 
 /**
- * @brief configure ir signal stream.
+ * @brief check if a stream is being sent.
  *
- * @param address, command, repeat flag for NEC protocol
+ * @param none
  *
- * @return none
+ * @return true until the callback of the stream is called
  *
  */
-void ir_generate_stream(uint16_t address, uint16_t command, bool repeat)
-{  
-  while (ir.stream_active); // Wait until done transmitting last code
-
-  ir.index = 0;
-  ir_generate_stream_head(&ir.stream[ir.index], repeat);
-  switch (ir.code) {
-    case CODE_NEC:
-      // address -> address complemented -> command -> command complemented
-      if(repeat == false){
-        ir_generate_stream_byte(address, ir.address_length[ir.code]);
-        ir_generate_stream_byte((~address), ir.address_length[ir.code]);
-        ir_generate_stream_byte(command, ir.command_length[ir.code]);
-        ir_generate_stream_byte((~command), ir.command_length[ir.code]);
-      }
-      // Send trailing (pulse)
-      ir.stream[ir.index++] = true;
-      break;
-
-    case CODE_SONY:
-      // command -> address
-      ir_generate_stream_byte(command, ir.command_length[ir.code]);
-      ir_generate_stream_byte(address, ir.address_length[ir.code]);
-      break;
-
-    default:
-      break;
-  }
-  ir.stream[ir.index] = false;
-
-  ir.stream_active = true;			// Enable sending code
-  ir.stream_index = 0;				// start from 0, stop when ir.stream_index >= ir.index
-  
-  TIMER_Enable(TIMER1, true);
+bool ir_generate_is_busy(void)
+{
+  return ir.stream_active;
 }
 
-__STATIC_INLINE void ir_generate_send(void)
+void LDMA_IRQHandler(void)
 {
-  // Clear flag for TIMER1 overflow interrupt
-  TIMER_IntClear(TIMER1, TIMER_IF_OF);
+  uint32_t flags = LDMA_IntGetEnabled();
+  uint32_t mask = 1UL << IR_LDMA_CHANNEL;
 
-  if (ir.stream_active){
-    // Send a pulse
-    if (ir.stream[ir.stream_index]) {
-      TIMER_Enable(TIMER0, true);
-      GPIO_PinOutSet(BSP_MODULATION_PORT, BSP_MODULATION_PIN);
-    } else {
-	  // Send a space
-      TIMER_Enable(TIMER0, false);
-      GPIO_PinOutClear(BSP_MODULATION_PORT, BSP_MODULATION_PIN);
-    }
-    ir.stream_index++;
+  if (flags & mask){
+    LDMA_IntClear(mask);
 
-    // Done sending the stream
-    if (ir.stream_index >= ir.index) {
-      ir.stream_index = 0;
-      ir.stream_active = false;
-    }
-  } else {
-	//TIMER_Enable(TIMER0, false);
+    // the last mark has ended, the modulation output is low
     ir_generate_stop();
-    GPIO_PinOutClear(BSP_MODULATION_PORT, BSP_MODULATION_PIN);
-    ir_complete_callback();
+    ir.stream_active = false;
+
+    if (ir_complete_callback){
+      ir_complete_callback();
+    }
   }
 }
 
+/*
+ * TIMER1 CC0 toggles the modulation output on each overflow, starting low
+ */
+static void ir_generate_modulation_cc(void)
+{
+  TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
+
+  timerCCInit.mode = timerCCModeCompare;
+  timerCCInit.cofoa = timerOutputActionToggle;
+  timerCCInit.coist = false;
+  TIMER_InitCC(TIMER1, 0, &timerCCInit);
+}
+
 /**
  * @brief stop ir signal generate.
  *
@@ -215,8 +214,18 @@ __STATIC_INLINE void ir_generate_send(void)
  */
 void ir_generate_stop(void)
 {
+  LDMA_StopTransfer(IR_LDMA_CHANNEL);
   TIMER_Enable(TIMER0, false);
   TIMER_Enable(TIMER1, false);
+
+  // If the LDMA interrupt was held off past the last guard, one more
+  // overflow toggled the modulation back high. Hold the pin low from the
+  // GPIO while CC0 is reset to its low initial state, so that the next
+  // frame does not start inverted.
+  GPIO->TIMERROUTE[1].ROUTEEN = 0;
+  GPIO_PinOutClear(BSP_MODULATION_PORT, BSP_MODULATION_PIN);
+  ir_generate_modulation_cc();
+  GPIO->TIMERROUTE[1].ROUTEEN = GPIO_TIMER_ROUTEEN_CC0PEN;
 }
 
 __STATIC_INLINE void ir_generate_pin(void)
@@ -226,18 +235,6 @@ __STATIC_INLINE void ir_generate_pin(void)
   GPIO_PinModeSet(BSP_MODULATION_PORT, BSP_MODULATION_PIN, gpioModePushPull, 0);
 }
 
-#if 0	//no need a interrupt for change the duty cycle
-void TIMER0_IRQHandler(void)
-{
-  // Acknowledge the interrupt
-  uint32_t flags = TIMER_IntGet(TIMER0);
-  TIMER_IntClear(TIMER0, flags);
-
-  // Update CCVB to alter duty cycle starting next period
-  //TIMER_CompareBufSet(TIMER0, 0, (uint32_t)(topValue * dutyCycle));
-}
-#endif
-
 __STATIC_INLINE void ir_generate_carrier(void)
 {
   uint32_t timerFreq = 0;
@@ -268,54 +265,57 @@ __STATIC_INLINE void ir_generate_carrier(void)
 
   // set PWM period
   timerFreq = CMU_ClockFreqGet(cmuClock_TIMER0) / (timerInit.prescale + 1);
-  topValue = (timerFreq / ir.carrier[ir.code]);
+  topValue = (timerFreq / ir_encode_carrier(ir.code));
   // Set top value to overflow at the desired PWM_FREQ frequency
   TIMER_TopSet(TIMER0, topValue);
 
-  // Set compare value for initial duty cycle
-  TIMER_CompareSet(TIMER0, 0, (uint32_t)(topValue * ir.dutycycle[ir.code]));
-
-  #if 0	//no need to start here and no need a interrupt for change the duty cycle
-  // Start the timer
-  TIMER_Enable(TIMER0, true);
-
-  // Enable TIMER0 compare event interrupts to update the duty cycle
-  TIMER_IntEnable(TIMER0, TIMER_IEN_CC0);
-  NVIC_EnableIRQ(TIMER0_IRQn);
-  #endif
-}
-
-void TIMER1_IRQHandler(void)
-{
-  // Acknowledge the interrupt
-  uint32_t flags = TIMER_IntGet(TIMER1);
-  TIMER_IntClear(TIMER1, flags);
-  ir_generate_send();
+  // Set compare value for a 1/3 duty cycle
+  TIMER_CompareSet(TIMER0, 0, topValue / 3);
 }
 
 __STATIC_INLINE void ir_generate_timebase(void)
 {
   uint32_t timerFreq = 0;
+  uint32_t prescale = 0;
 
   CMU_ClockEnable(cmuClock_TIMER1, true);
 
   // Initialize the timer
   TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
-  timerInit.prescale = timerPrescale1;
+
+  // Count at about IR_TIMEBASE_HZ, the durations are up to 65 ms
+  timerFreq = CMU_ClockFreqGet(cmuClock_TIMER1);
+  prescale = timerFreq / IR_TIMEBASE_HZ;
+  if (prescale < 1){
+    prescale = 1;
+  } else if (prescale > 1024){
+    prescale = 1024;
+  }
+  timerInit.prescale = (TIMER_Prescale_TypeDef)(prescale - 1);
   timerInit.enable = false;
+  // Clear the overflow DMA request when the LDMA writes the TOP buffer
+  timerInit.dmaClrAct = true;
 
   // Configure but do not start the timer
   TIMER_Init(TIMER1, &timerInit);
 
-  timerFreq = CMU_ClockFreqGet(cmuClock_TIMER1) / (timerInit.prescale + 1);
-  TIMER_TopSet(TIMER1, (timerFreq / ir.timebase[ir.code]));
+  // Route Timer1 CC0 output to the modulation pin
+  GPIO->TIMERROUTE[1].ROUTEEN  = GPIO_TIMER_ROUTEEN_CC0PEN;
+  GPIO->TIMERROUTE[1].CC0ROUTE = (BSP_MODULATION_PORT << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT)
+								| (BSP_MODULATION_PIN << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
 
-  // Start the timer
-  //TIMER_Enable(TIMER1, true);
+  // Configure CC Channel 0 to toggle the modulation on overflow
+  ir_generate_modulation_cc();
 
-  // Enable TIMER1 compare event interrupts to update the duty cycle
-  TIMER_IntEnable(TIMER1, TIMER_IF_OF);
-  NVIC_EnableIRQ(TIMER1_IRQn);
+  ir_timebase_freq = timerFreq / prescale;
+}
+
+__STATIC_INLINE void ir_generate_dma(void)
+{
+  // Initialize the LDMA, its interrupt ends the stream
+  CMU_ClockEnable(cmuClock_LDMA, true);
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+  LDMA_Init(&ldmaInit);
 }
 
 __STATIC_INLINE void ir_generate_code(code_t ir_code)
@@ -337,6 +337,6 @@ void ir_generate_init(code_t ir_code, ir_callback_t cb)
   ir_generate_pin();
   ir_generate_carrier();
   ir_generate_timebase();
-  //ir_generate_stream(0xFF, 0xFF, false); // for test
+  ir_generate_dma();
   ir_complete_callback = cb;
 }
@@ -0,0 +1,375 @@
+/***************************************************************************//**
+ * @file ir_encode_test.c
+ * @brief Host test of the IR protocol encoder
+ *
+ * Decodes the mark/space durations generated for every protocol with a
+ * reference decoder, and checks the TIMER TOP values played by the LDMA.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc ir_encode_test.c ../src/ir_encode.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2018 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "ir_encode.h"
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// within 10% of the protocol timing
+static int near(uint16_t us, uint16_t expected)
+{
+  return abs((int)us - (int)expected) * 10 <= expected;
+}
+
+static int is_mark(uint16_t i)
+{
+  return (i & 1) == 0;
+}
+
+// NEC and NEC extended, 32 bits LSB first from the space lengths
+static int nec_decode(const ir_timing_t *t, uint32_t *data, int *repeat)
+{
+  const uint16_t *d = t->duration;
+
+  if (t->count < 3 || !near(d[0], 9000))
+    return 0;
+
+  if (t->count == 3 && near(d[1], 2250) && near(d[2], 560)) {
+    *repeat = 1;
+    return 1;
+  }
+
+  if (t->count != 67 || !near(d[1], 4500) || !near(d[66], 560))
+    return 0;
+
+  *repeat = 0;
+  *data = 0;
+  for (int i = 0; i < 32; i++) {
+    if (!near(d[2 + 2 * i], 560))
+      return 0;
+    if (near(d[3 + 2 * i], 1690))
+      *data |= 1UL << i;
+    else if (!near(d[3 + 2 * i], 560))
+      return 0;
+  }
+  return 1;
+}
+
+// SONY, 15 bits LSB first from the mark lengths
+static int sony_decode(const ir_timing_t *t, uint32_t *data)
+{
+  const uint16_t *d = t->duration;
+
+  if (t->count != 31 || !near(d[0], 2400) || !near(d[1], 600))
+    return 0;
+
+  *data = 0;
+  for (int i = 0; i < 15; i++) {
+    if (near(d[2 + 2 * i], 1200))
+      *data |= 1UL << i;
+    else if (!near(d[2 + 2 * i], 600))
+      return 0;
+    if (i < 14 && !near(d[3 + 2 * i], 600))
+      return 0;
+  }
+  return 1;
+}
+
+// Splits the durations into levels of one unit, 1 for a mark
+static int levels(const ir_timing_t *t, uint16_t unit, uint8_t *level, int size)
+{
+  int n = 0;
+
+  for (uint16_t i = 0; i < t->count; i++) {
+    int units = (t->duration[i] + unit / 2) / unit;
+
+    if (units < 1 || !near(t->duration[i], (uint16_t)(units * unit)))
+      return -1;
+    while (units-- > 0) {
+      if (n >= size)
+        return -1;
+      level[n++] = is_mark(i);
+    }
+  }
+
+  // the idle line after the frame
+  while (n < size)
+    level[n++] = 0;
+
+  return n;
+}
+
+// RC5, 14 bits MSB first, 1 is space then mark
+static int rc5_decode(const ir_timing_t *t, uint32_t *frame)
+{
+  uint8_t level[29];
+
+  // the dropped space of the first half bit of S1
+  level[0] = 0;
+  if (levels(t, 889, &level[1], 28) < 0)
+    return 0;
+
+  *frame = 0;
+  for (int i = 0; i < 14; i++) {
+    uint8_t a = level[2 * i];
+    uint8_t b = level[2 * i + 1];
+
+    if (a == b)
+      return 0;
+    *frame = (*frame << 1) | (b ? 1 : 0);
+  }
+  return 1;
+}
+
+// RC6 mode 0, 1 is mark then space, double width trailer bit
+static int rc6_decode(const ir_timing_t *t, uint8_t *mode, int *toggle,
+                      uint32_t *data)
+{
+  uint8_t level[6 + 2 + 8 + 4 + 32];
+  int i, p;
+
+  if (levels(t, 444, level, sizeof(level)) < 0)
+    return 0;
+
+  for (i = 0; i < 6; i++)
+    if (!level[i])
+      return 0;
+  if (level[6] || level[7])
+    return 0;
+
+  // start bit, then 3 mode bits
+  p = 8;
+  if (!(level[p] && !level[p + 1]))
+    return 0;
+  p += 2;
+
+  *mode = 0;
+  for (i = 0; i < 3; i++, p += 2) {
+    if (level[p] == level[p + 1])
+      return 0;
+    *mode = (uint8_t)((*mode << 1) | level[p]);
+  }
+
+  if (level[p] != level[p + 1] || level[p + 2] != level[p + 3]
+      || level[p] == level[p + 2])
+    return 0;
+  *toggle = level[p];
+  p += 4;
+
+  *data = 0;
+  for (i = 0; i < 16; i++, p += 2) {
+    if (level[p] == level[p + 1])
+      return 0;
+    *data = (*data << 1) | level[p];
+  }
+  return 1;
+}
+
+// Every list starts and ends with a mark, no duration of 0
+static void check_shape(const ir_timing_t *t)
+{
+  CHECK(t->count > 0);
+  CHECK((t->count & 1) == 1);
+  for (uint16_t i = 0; i < t->count; i++)
+    CHECK(t->duration[i] > 0);
+}
+
+static void test_nec(void)
+{
+  ir_timing_t t;
+  uint32_t data = 0;
+  int repeat = 0;
+
+  for (uint32_t n = 0; n < 2000; n++) {
+    uint16_t address = (uint16_t)(n * 40503u);
+    uint16_t command = (uint16_t)((n * 7) & 0xFF);
+
+    CHECK(ir_encode_frame(&t, CODE_NEC, address, command, false, false));
+    check_shape(&t);
+    CHECK(nec_decode(&t, &data, &repeat) && !repeat);
+    CHECK((data & 0xFF) == (address & 0xFF));
+    CHECK(((data >> 8) & 0xFF) == (~address & 0xFF));
+    CHECK(((data >> 16) & 0xFF) == command);
+    CHECK(((data >> 24) & 0xFF) == (~command & 0xFF));
+
+    CHECK(ir_encode_frame(&t, CODE_NEC_EXT, address, command, false, false));
+    check_shape(&t);
+    CHECK(nec_decode(&t, &data, &repeat) && !repeat);
+    CHECK((data & 0xFFFF) == address);
+    CHECK(((data >> 16) & 0xFF) == command);
+    CHECK(((data >> 24) & 0xFF) == (~command & 0xFF));
+  }
+
+  CHECK(ir_encode_frame(&t, CODE_NEC, 0x12, 0x34, true, false));
+  CHECK(nec_decode(&t, &data, &repeat) && repeat);
+  CHECK(ir_encode_frame(&t, CODE_NEC_EXT, 0x1234, 0x56, true, false));
+  CHECK(nec_decode(&t, &data, &repeat) && repeat);
+}
+
+static void test_sony(void)
+{
+  ir_timing_t t;
+  uint32_t data = 0;
+
+  for (uint16_t address = 0; address < 128; address++) {
+    for (uint16_t command = 0; command < 256; command += 17) {
+      CHECK(ir_encode_frame(&t, CODE_SONY, address, command, false, false));
+      check_shape(&t);
+      CHECK(sony_decode(&t, &data));
+      CHECK((data & 0xFF) == command);
+      CHECK((data >> 8) == address);
+    }
+  }
+}
+
+static void test_rc5(void)
+{
+  ir_timing_t t;
+  uint32_t frame = 0;
+
+  for (uint16_t address = 0; address < 32; address++) {
+    for (uint16_t command = 0; command < 128; command++) {
+      for (int toggle = 0; toggle < 2; toggle++) {
+        CHECK(ir_encode_frame(&t, CODE_RC5, address, command, false, toggle));
+        check_shape(&t);
+        CHECK(rc5_decode(&t, &frame));
+        CHECK((frame >> 13) == 1);
+        CHECK(((frame >> 12) & 1) == !(command & 0x40));
+        CHECK(((frame >> 11) & 1) == (uint32_t)toggle);
+        CHECK(((frame >> 6) & 0x1F) == address);
+        CHECK((frame & 0x3F) == (command & 0x3F));
+        // half bits merge into marks and spaces of 1 or 2 half bits
+        for (uint16_t i = 0; i < t.count; i++)
+          CHECK(t.duration[i] == 889 || t.duration[i] == 2 * 889);
+      }
+    }
+  }
+}
+
+static void test_rc6(void)
+{
+  ir_timing_t t;
+  uint32_t data = 0;
+  uint8_t mode = 0xFF;
+  int toggle = -1;
+
+  for (uint32_t n = 0; n < 4096; n++) {
+    uint16_t address = (uint16_t)(n & 0xFF);
+    uint16_t command = (uint16_t)((n * 37) & 0xFF);
+    int tog = (n >> 8) & 1;
+
+    CHECK(ir_encode_frame(&t, CODE_RC6, address, command, false, tog));
+    check_shape(&t);
+    CHECK(rc6_decode(&t, &mode, &toggle, &data));
+    CHECK(mode == 0);
+    CHECK(toggle == tog);
+    CHECK(data == (((uint32_t)address << 8) | command));
+  }
+}
+
+static void test_raw(void)
+{
+  const uint16_t even[] = { 3400, 1700, 430, 1300, 430, 430, 430, 8000 };
+  const uint16_t bad[] = { 0, 500, 500 };
+  uint16_t big[IR_DURATION_MAX + 2];
+  ir_timing_t t;
+
+  // the trailing space is dropped
+  CHECK(ir_encode_raw(&t, even, 8));
+  CHECK(t.count == 7);
+  for (uint16_t i = 0; i < 7; i++)
+    CHECK(t.duration[i] == even[i]);
+
+  CHECK(!ir_encode_raw(&t, bad, 3));
+  CHECK(!ir_encode_raw(&t, NULL, 3));
+
+  for (uint16_t i = 0; i < IR_DURATION_MAX + 2; i++)
+    big[i] = 500;
+  CHECK(!ir_encode_raw(&t, big, IR_DURATION_MAX + 1));
+  CHECK(ir_encode_raw(&t, big, IR_DURATION_MAX));
+  CHECK(t.count == IR_DURATION_MAX - 1);
+
+  CHECK(!ir_encode_frame(&t, CODE_NUM, 0, 0, false, false));
+  CHECK(ir_encode_carrier(CODE_RC5) == 36000);
+  CHECK(ir_encode_carrier(CODE_NEC) == 38000);
+}
+
+// TOP values played by the LDMA stay within one tick of the frame timeline
+static void test_top(void)
+{
+  const uint32_t timer_hz[] = { 1010526, 1000000, 999000, 4800000 };
+  ir_timing_t t;
+  uint32_t top[IR_DURATION_MAX];
+
+  for (unsigned k = 0; k < sizeof(timer_hz) / sizeof(timer_hz[0]); k++) {
+    uint64_t us = 0, ticks = 0;
+
+    CHECK(ir_encode_frame(&t, CODE_NEC, 0x5A, 0xC3, false, false));
+    ir_encode_top(&t, timer_hz[k], 0xFFFF, top);
+
+    for (uint16_t i = 0; i < t.count; i++) {
+      double expected;
+
+      us += t.duration[i];
+      ticks += top[i] + 1;
+      expected = (double)us * timer_hz[k] / 1e6;
+      CHECK(ticks >= expected - 1.0 && ticks <= expected + 1.0);
+    }
+  }
+
+  // a duration longer than the TIMER is clamped
+  {
+    const uint16_t raw[] = { 60000, 10, 500 };
+
+    CHECK(ir_encode_raw(&t, raw, 3));
+    ir_encode_top(&t, 4800000, 0xFFFF, top);
+    CHECK(top[0] == 0xFFFF);
+    CHECK(top[1] >= 1);
+  }
+}
+
+int main(void)
+{
+  test_nec();
+  test_sony();
+  test_rc5();
+  test_rc6();
+  test_raw();
+  test_top();
+
+  printf(failed ? "FAILED\n" : "PASSED\n");
+
+  return failed;
+}
@@ -91,5 +91,8 @@ int main(void)
       }
 
     }
+
+    // the LDMA sends the stream, sleep until the next TIMER2 tick
+    EMU_EnterEM1();
   }
 }
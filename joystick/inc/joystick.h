@@ -43,6 +43,7 @@ extern "C" {
 #endif
 
 #include "sl_status.h"
+#include "sl_i2cspm.h"
 #include "stdbool.h"
 
 #define JOYSTICK_I2C_ADDRESS 0x20
@@ -57,15 +58,83 @@ extern "C" {
 #define JOYSTICK_READ_BUTTON_STATE      0x07  /* Current Button State (clears Reg 0x08) */
 #define JOYSTICK_READ_BUTTON_STATUS     0x08  /* Indicator for if button was pressed since last
                                                * read of button state (Reg 0x07). Clears after read */
+
+/* Registers 0x03 to 0x08 are read in a single burst per sample */
+#define JOYSTICK_SAMPLE_LENGTH          6
+
+/* Range of the 10-bit positions */
+#define JOYSTICK_POSITION_MIN           0
+#define JOYSTICK_POSITION_CENTER        512
+#define JOYSTICK_POSITION_MAX           1023
+
+/* Fractional bits of the filtered positions kept by the poller */
+#define JOYSTICK_FILTER_FRAC_BITS       4
+
 //  Struct of Firmware version.
 typedef struct frw_rev {
   uint8_t major;
   uint8_t minor;
 } frw_rev_t;
 
+//  Struct of one sample of all the inputs.
+typedef struct joystick_sample {
+  uint16_t horizontal;    ///< 10-bit horizontal position
+  uint16_t vertical;      ///< 10-bit vertical position
+  uint8_t button;         ///< Button state, 0 while the button is pressed
+  uint8_t button_status;  ///< 1 if the button was pressed since the
+                          ///<   previous sample
+} joystick_sample_t;
+
+//  Struct of the poller settings of a joystick.
+typedef struct joystick_poll_config {
+  uint16_t deadzone;      ///< Positions within this distance of the center
+                          ///<   are reported as JOYSTICK_POSITION_CENTER
+  uint8_t filter_shift;   ///< Each sample moves the filtered position by
+                          ///<   2^-filter_shift of the difference, 0 disables
+                          ///<   the filter
+  uint16_t threshold;     ///< Smallest position change that is notified
+} joystick_poll_config_t;
+
+#define JOYSTICK_POLL_CONFIG_DEFAULT \
+  {                                  \
+    .deadzone = 16,                  \
+    .filter_shift = 1,               \
+    .threshold = 8,                  \
+  }
+
+struct joystick;
+
+/**************************************************************************//**
+ * @brief
+ *  Called by joystick_poll_process() when the filtered position or the button
+ *  of a joystick changed.
+ * @param[in] joystick
+ *  The joystick that changed.
+ * @param[in] sample
+ *  The filtered positions and the button of the last sample.
+ *****************************************************************************/
+typedef void (*joystick_callback_t)(struct joystick *joystick,
+                                    const joystick_sample_t *sample);
+
+//  Struct of a joystick instance, all fields are managed by the driver.
+typedef struct joystick {
+  sl_i2cspm_t *i2cspm;            ///< I2C instance the joystick is on
+  uint8_t address;                ///< 7-bit I2C address
+  joystick_poll_config_t config;  ///< Poller settings
+  joystick_callback_t callback;   ///< Poller change callback
+  joystick_sample_t reported;     ///< Last notified sample
+  int32_t filtered_horizontal;    ///< Filtered positions, with
+  int32_t filtered_vertical;      ///<   JOYSTICK_FILTER_FRAC_BITS fraction
+  bool primed;                    ///< The poller has read a first sample
+  uint32_t read_errors;           ///< Samples the poller failed to read
+  struct joystick *next;          ///< Next joystick polled
+} joystick_t;
+
 /**************************************************************************//**
  * @brief
  *  Initialize the Joystick.
+ * @note
+ *  Uses the joystick at JOYSTICK_I2C_ADDRESS on the qwiic I2C instance.
  * @return
  *  @retval SL_STATUS_OK An joystick device is present on the I2C bus
  *  @retval SL_STATUS_INITIALIZATION No Joystick device present
@@ -141,6 +210,135 @@ bool joystick_present(uint8_t *device_id);
  *****************************************************************************/
 sl_status_t joystick_send_command(uint8_t *data, uint8_t command);
 
+/**************************************************************************//**
+ * @brief
+ *  Initialize a joystick instance.
+ * @param[out] joystick
+ *  The joystick instance.
+ * @param[in] i2cspm
+ *  The I2C instance the joystick is connected to.
+ * @param[in] address
+ *  The 7-bit I2C address of the joystick.
+ * @return
+ *  @retval SL_STATUS_OK The joystick is present on the I2C bus
+ *  @retval SL_STATUS_NULL_POINTER Invalid parameter
+ *  @retval SL_STATUS_INITIALIZATION No Joystick device present
+ *****************************************************************************/
+sl_status_t joystick_instance_init(joystick_t *joystick,
+                                   sl_i2cspm_t *i2cspm,
+                                   uint8_t address);
+
+/**************************************************************************//**
+ * @brief
+ *  Check whether a joystick instance is present on its I2C bus or not.
+ * @param[in] joystick
+ *  The joystick instance.
+ * @param[out] device_id
+ *  The ID register, may be NULL.
+ * @return
+ *  @retval true The joystick is present on the I2C bus
+ *  @retval false The joystick is not present
+ *****************************************************************************/
+bool joystick_instance_present(joystick_t *joystick, uint8_t *device_id);
+
+/**************************************************************************//**
+ * @brief
+ *  Read Firmware Version from a joystick instance.
+ * @param[in] joystick
+ *  The joystick instance.
+ * @param[out] fwRev
+ *  The internal firmware Version.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_TRANSMIT I2C transmission error
+ *****************************************************************************/
+sl_status_t joystick_instance_get_firmware_version(joystick_t *joystick,
+                                                   frw_rev_t *fwRev);
+
+/**************************************************************************//**
+ * @brief
+ *  Reads both positions and the button of a joystick instance.
+ * @note
+ *  Registers 0x03 to 0x08 are read in a single I2C transfer, so the positions
+ *  and the button belong to the same sample. Reading the button state clears
+ *  the button status of the joystick.
+ * @param[in] joystick
+ *  The joystick instance.
+ * @param[out] sample
+ *  The raw sample.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_TRANSMIT I2C transmission error
+ *****************************************************************************/
+sl_status_t joystick_read_sample(joystick_t *joystick,
+                                 joystick_sample_t *sample);
+
+/**************************************************************************//**
+ * @brief
+ *  Adds a joystick instance to the poller.
+ * @note
+ *  The first sample read is always notified. After that the callback is only
+ *  called when the button changes, a whole press happened between two samples
+ *  (button released with button_status set), or a filtered position moved by
+ *  at least the threshold, to or from the center, or to either end of its
+ *  range.
+ * @param[in] joystick
+ *  An initialized joystick instance.
+ * @param[in] config
+ *  The poller settings, copied into the instance.
+ * @param[in] callback
+ *  Called from joystick_poll_process() on changes.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_NULL_POINTER Invalid parameter
+ *  @retval SL_STATUS_ALREADY_EXISTS The joystick is already polled
+ *****************************************************************************/
+sl_status_t joystick_poll_add(joystick_t *joystick,
+                              const joystick_poll_config_t *config,
+                              joystick_callback_t callback);
+
+/**************************************************************************//**
+ * @brief
+ *  Removes a joystick instance from the poller.
+ * @param[in] joystick
+ *  The joystick instance.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_NOT_FOUND The joystick is not polled
+ *****************************************************************************/
+sl_status_t joystick_poll_remove(joystick_t *joystick);
+
+/**************************************************************************//**
+ * @brief
+ *  Starts the poller timer.
+ * @param[in] period_ms
+ *  The sampling period, 5 for 200 Hz.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_INVALID_PARAMETER The period is 0
+ *  @retval SL_STATUS_FAIL The timer could not be started
+ *****************************************************************************/
+sl_status_t joystick_poll_start(uint32_t period_ms);
+
+/**************************************************************************//**
+ * @brief
+ *  Stops the poller timer.
+ * @return
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_FAIL The timer could not be stopped
+ *****************************************************************************/
+sl_status_t joystick_poll_stop(void);
+
+/**************************************************************************//**
+ * @brief
+ *  Samples every polled joystick once per elapsed poller period.
+ * @note
+ *  Should be called from the main loop. The timer only flags that a period
+ *  elapsed, the I2C transfers run here. Periods missed while the main loop was
+ *  busy are merged into one sample.
+ *****************************************************************************/
+void joystick_poll_process(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,27 +40,78 @@
 #include "sl_i2cspm_qwiic_config.h"
 #include "sl_sleeptimer.h"
 
+// Joystick used by the functions without an instance parameter.
+static joystick_t joystick_default = {
+  .i2cspm = SL_I2CSPM_QWIIC_PERIPHERAL,
+  .address = JOYSTICK_I2C_ADDRESS,
+};
+
+// Joysticks sampled by the poller.
+static joystick_t *poll_list = NULL;
+static sl_sleeptimer_timer_handle_t poll_timer;
+static volatile bool poll_pending = false;
+
 /**************************************************************************//**
  * @brief
- *  Initialize the Joystick.
+ *  Reads consecutive registers in a single I2C transfer.
+ * @param[in] joystick
+ *  The joystick instance.
+ * @param[in] reg
+ *  The first register.
+ * @param[out] data
+ *  The register values.
+ * @param[in] len
+ *  The number of registers.
  * @return
- *  @retval SL_STATUS_OK An joystick device is present on the I2C bus
- *  @retval SL_STATUS_INITIALIZATION No Joystick device present
+ *  @retval SL_STATUS_OK Success
+ *  @retval SL_STATUS_TRANSMIT I2C transmission error
  *****************************************************************************/
-sl_status_t joystick_init(void)
+static sl_status_t joystick_read_registers(joystick_t *joystick,
+                                           uint8_t reg,
+                                           uint8_t *data,
+                                           uint16_t len)
 {
-  sl_status_t status = SL_STATUS_OK;
+  I2C_TransferSeq_TypeDef    seq;
+  I2C_TransferReturn_TypeDef ret;
 
-  if (!joystick_present(NULL)) {
-    /* Wait for joystick to become ready */
-      sl_sleeptimer_delay_millisecond(80);
+  seq.addr  = joystick->address << 1;
+  seq.flags = I2C_FLAG_WRITE_READ;
+  /* Select register to read from, the joystick auto-increments */
+  seq.buf[0].data = &reg;
+  seq.buf[0].len  = 1;
+  /* Select location/length of data to be read */
+  seq.buf[1].data = data;
+  seq.buf[1].len  = len;
 
-    if (!joystick_present(NULL)) {
-      status = SL_STATUS_INITIALIZATION;
-    }
+  ret = I2CSPM_Transfer(joystick->i2cspm, &seq);
+  if (ret != i2cTransferDone) {
+    return SL_STATUS_TRANSMIT;
   }
 
-  return status;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Converts the MSB and LSB registers to a 10-bit position.
+ *****************************************************************************/
+static uint16_t joystick_position(const uint8_t *data)
+{
+  return (((uint16_t) data[0] << 8) | data[1]) >> 6;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Initialize the Joystick.
+ * @return
+ *  @retval SL_STATUS_OK An joystick device is present on the I2C bus
+ *  @retval SL_STATUS_INITIALIZATION No Joystick device present
+ *****************************************************************************/
+sl_status_t joystick_init(void)
+{
+  return joystick_instance_init(&joystick_default,
+                                SL_I2CSPM_QWIIC_PERIPHERAL,
+                                JOYSTICK_I2C_ADDRESS);
 }
 
 /**************************************************************************//**
@@ -74,33 +125,7 @@ sl_status_t joystick_init(void)
  *****************************************************************************/
 sl_status_t joystick_get_firmware_version(frw_rev_t *fwRev)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_write_data[2];
-  uint8_t                    i2c_read_data[2];
-
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = JOYSTICK_READ_FWREV_1;
-  i2c_write_data[1] = JOYSTICK_READ_FWREV_2;
-  seq.buf[0].data   = i2c_write_data;
-  seq.buf[0].len    = 2;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 2;
-
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-
-  if (ret != i2cTransferDone) {
-    fwRev->major = 0;
-    fwRev->minor = 0;
-    return SL_STATUS_TRANSMIT;
-  }
-  fwRev->major = i2c_read_data[0];
-  fwRev->minor = i2c_read_data[1];
-
-  return SL_STATUS_OK;
+  return joystick_instance_get_firmware_version(&joystick_default, fwRev);
 }
 
 /**************************************************************************//**
@@ -114,30 +139,16 @@ sl_status_t joystick_get_firmware_version(frw_rev_t *fwRev)
  *****************************************************************************/
 sl_status_t joystick_read_horizontal_position(uint16_t *data)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_write_data[2];
-  uint8_t                    i2c_read_data[2];
+  uint8_t i2c_read_data[2];
 
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = JOYSTICK_READ_HORIZONTAL_POSITION_MSB;
-  i2c_write_data[1] = JOYSTICK_READ_HORIZONTAL_POSITION_LSB;
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = 2;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 2;
-
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-
-  if (ret != i2cTransferDone) {
+  if (joystick_read_registers(&joystick_default,
+                              JOYSTICK_READ_HORIZONTAL_POSITION_MSB,
+                              i2c_read_data, 2) != SL_STATUS_OK) {
     *data = 0;
     return SL_STATUS_TRANSMIT;
   }
 
-  *data = (((uint16_t) i2c_read_data[0] << 8) | i2c_read_data[1]) >> 6;
+  *data = joystick_position(i2c_read_data);
 
   return SL_STATUS_OK;
 }
@@ -153,30 +164,16 @@ sl_status_t joystick_read_horizontal_position(uint16_t *data)
  *****************************************************************************/
 sl_status_t joystick_read_vertical_position(uint16_t *data)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_write_data[2];
-  uint8_t                    i2c_read_data[2];
+  uint8_t i2c_read_data[2];
 
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = JOYSTICK_READ_VERTICAL_POSITION_MSB;
-  i2c_write_data[1] = JOYSTICK_READ_VERTICAL_POSITION_LSB;
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = 2;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 2;
-
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-
-  if (ret != i2cTransferDone) {
+  if (joystick_read_registers(&joystick_default,
+                              JOYSTICK_READ_VERTICAL_POSITION_MSB,
+                              i2c_read_data, 2) != SL_STATUS_OK) {
     *data = 0;
     return SL_STATUS_TRANSMIT;
   }
 
-  *data = (((uint16_t) i2c_read_data[0] << 8) | i2c_read_data[1]) >> 6;
+  *data = joystick_position(i2c_read_data);
 
   return SL_STATUS_OK;
 }
@@ -192,31 +189,7 @@ sl_status_t joystick_read_vertical_position(uint16_t *data)
  *****************************************************************************/
 sl_status_t joystick_read_button_position(uint8_t *data)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_write_data[1];
-  uint8_t                    i2c_read_data[1];
-
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = JOYSTICK_READ_BUTTON_STATE;
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 1;
-
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-
-  if (ret != i2cTransferDone) {
-    *data = 0;
-    return SL_STATUS_TRANSMIT;
-  }
-
-  *data = i2c_read_data[0];
-
-  return SL_STATUS_OK;
+  return joystick_send_command(data, JOYSTICK_READ_BUTTON_STATE);
 }
 
 /**************************************************************************//**
@@ -230,30 +203,7 @@ sl_status_t joystick_read_button_position(uint8_t *data)
  *****************************************************************************/
 bool joystick_present(uint8_t *device_id)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_read_data[1];
-  uint8_t                    i2c_write_data[1];
-
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = JOYSTICK_READ_ID; // Read ID
-  seq.buf[0].data   = i2c_write_data;
-  seq.buf[0].len    = 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 1;
-
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-  if (ret != i2cTransferDone) {
-    return false;
-  }
-
-  if (NULL != device_id) {
-    *device_id = i2c_read_data[0];
-  }
-  return true;
+  return joystick_instance_present(&joystick_default, device_id);
 }
 
 /**************************************************************************//**
@@ -270,27 +220,337 @@ bool joystick_present(uint8_t *device_id)
  *****************************************************************************/
 sl_status_t joystick_send_command(uint8_t *data, uint8_t command)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t                    i2c_read_data[1];
-  uint8_t                    i2c_write_data[1];
+  if (joystick_read_registers(&joystick_default, command, data, 1)
+      != SL_STATUS_OK) {
+    *data = 0;
+    return SL_STATUS_TRANSMIT;
+  }
 
-  seq.addr  = JOYSTICK_I2C_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE_READ;
-  /* Select command to issue */
-  i2c_write_data[0] = command;
-  seq.buf[0].data   = i2c_write_data;
-  seq.buf[0].len    = 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 1;
+  return SL_STATUS_OK;
+}
 
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
+/**************************************************************************//**
+ * @brief
+ *  Initialize a joystick instance.
+ *****************************************************************************/
+sl_status_t joystick_instance_init(joystick_t *joystick,
+                                   sl_i2cspm_t *i2cspm,
+                                   uint8_t address)
+{
+  if ((joystick == NULL) || (i2cspm == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
 
-  if (ret != i2cTransferDone) {
-    *data = 0;
+  // Keep the instance in the poller list if it is re-initialized.
+  joystick->i2cspm = i2cspm;
+  joystick->address = address;
+  joystick->primed = false;
+  joystick->read_errors = 0;
+
+  if (!joystick_instance_present(joystick, NULL)) {
+    /* Wait for joystick to become ready */
+    sl_sleeptimer_delay_millisecond(80);
+
+    if (!joystick_instance_present(joystick, NULL)) {
+      return SL_STATUS_INITIALIZATION;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Check whether a joystick instance is present on its I2C bus or not.
+ *****************************************************************************/
+bool joystick_instance_present(joystick_t *joystick, uint8_t *device_id)
+{
+  uint8_t i2c_read_data[1];
+
+  if (joystick_read_registers(joystick, JOYSTICK_READ_ID,
+                              i2c_read_data, 1) != SL_STATUS_OK) {
+    return false;
+  }
+
+  if (NULL != device_id) {
+    *device_id = i2c_read_data[0];
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read Firmware Version from a joystick instance.
+ *****************************************************************************/
+sl_status_t joystick_instance_get_firmware_version(joystick_t *joystick,
+                                                   frw_rev_t *fwRev)
+{
+  uint8_t i2c_read_data[2];
+
+  if (joystick_read_registers(joystick, JOYSTICK_READ_FWREV_1,
+                              i2c_read_data, 2) != SL_STATUS_OK) {
+    fwRev->major = 0;
+    fwRev->minor = 0;
     return SL_STATUS_TRANSMIT;
   }
-  *data = i2c_read_data[0];
+  fwRev->major = i2c_read_data[0];
+  fwRev->minor = i2c_read_data[1];
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Reads both positions and the button of a joystick instance.
+ *****************************************************************************/
+sl_status_t joystick_read_sample(joystick_t *joystick,
+                                 joystick_sample_t *sample)
+{
+  uint8_t i2c_read_data[JOYSTICK_SAMPLE_LENGTH];
+
+  if (joystick_read_registers(joystick,
+                              JOYSTICK_READ_HORIZONTAL_POSITION_MSB,
+                              i2c_read_data,
+                              JOYSTICK_SAMPLE_LENGTH) != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  sample->horizontal = joystick_position(&i2c_read_data[0]);
+  sample->vertical = joystick_position(&i2c_read_data[2]);
+  sample->button = i2c_read_data[4];
+  sample->button_status = i2c_read_data[5];
+
   return SL_STATUS_OK;
 }
+
+/**************************************************************************//**
+ * @brief
+ *  Filters one axis and applies the deadzone.
+ * @param[in,out] filtered
+ *  The filtered position, with JOYSTICK_FILTER_FRAC_BITS fraction.
+ * @param[in] position
+ *  The new raw position.
+ * @param[in] config
+ *  The poller settings.
+ * @return
+ *  The position to report.
+ *****************************************************************************/
+static uint16_t poll_filter(int32_t *filtered,
+                            uint16_t position,
+                            const joystick_poll_config_t *config)
+{
+  int32_t target = (int32_t)position << JOYSTICK_FILTER_FRAC_BITS;
+  int32_t value;
+
+  // First order IIR, the rounding keeps the output from sticking one count
+  // away from a constant input.
+  *filtered += (target - *filtered
+                + (1 << config->filter_shift >> 1)) >> config->filter_shift;
+  value = (*filtered + (1 << (JOYSTICK_FILTER_FRAC_BITS - 1)))
+          >> JOYSTICK_FILTER_FRAC_BITS;
+
+  if ((value >= JOYSTICK_POSITION_CENTER - config->deadzone)
+      && (value <= JOYSTICK_POSITION_CENTER + config->deadzone)) {
+    return JOYSTICK_POSITION_CENTER;
+  }
+
+  return (uint16_t)value;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Checks if a position change is worth notifying.
+ *****************************************************************************/
+static bool poll_moved(uint16_t position,
+                       uint16_t reported,
+                       uint16_t threshold)
+{
+  uint16_t delta;
+
+  if (position == reported) {
+    return false;
+  }
+  delta = (position > reported) ? position - reported : reported - position;
+
+  // Never hold back the rest position or a full deflection.
+  return (delta >= threshold)
+         || (position == JOYSTICK_POSITION_CENTER)
+         || (reported == JOYSTICK_POSITION_CENTER)
+         || (position == JOYSTICK_POSITION_MIN)
+         || (position == JOYSTICK_POSITION_MAX);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Updates the poller state of a joystick with a new sample.
+ * @return
+ *  True if the change should be notified.
+ *****************************************************************************/
+static bool poll_update(joystick_t *joystick, joystick_sample_t *sample)
+{
+  const joystick_poll_config_t *config = &joystick->config;
+  bool changed;
+
+  if (!joystick->primed) {
+    joystick->filtered_horizontal =
+      (int32_t)sample->horizontal << JOYSTICK_FILTER_FRAC_BITS;
+    joystick->filtered_vertical =
+      (int32_t)sample->vertical << JOYSTICK_FILTER_FRAC_BITS;
+  }
+
+  sample->horizontal = poll_filter(&joystick->filtered_horizontal,
+                                   sample->horizontal, config);
+  sample->vertical = poll_filter(&joystick->filtered_vertical,
+                                 sample->vertical, config);
+
+  changed = !joystick->primed
+            || (sample->button != joystick->reported.button)
+            || ((sample->button_status != 0)
+                && (sample->button != 0)
+                && (joystick->reported.button != 0))
+            || poll_moved(sample->horizontal, joystick->reported.horizontal,
+                          config->threshold)
+            || poll_moved(sample->vertical, joystick->reported.vertical,
+                          config->threshold);
+  joystick->primed = true;
+
+  if (changed) {
+    joystick->reported = *sample;
+  }
+
+  return changed;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Poller timer callback, the samples are read by joystick_poll_process().
+ *****************************************************************************/
+static void poll_timer_cb(sl_sleeptimer_timer_handle_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  poll_pending = true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Adds a joystick instance to the poller.
+ *****************************************************************************/
+sl_status_t joystick_poll_add(joystick_t *joystick,
+                              const joystick_poll_config_t *config,
+                              joystick_callback_t callback)
+{
+  joystick_t *item;
+
+  if ((joystick == NULL) || (config == NULL) || (callback == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  for (item = poll_list; item != NULL; item = item->next) {
+    if (item == joystick) {
+      return SL_STATUS_ALREADY_EXISTS;
+    }
+  }
+
+  joystick->config = *config;
+  if (joystick->config.threshold == 0) {
+    joystick->config.threshold = 1;
+  }
+  if (joystick->config.filter_shift > 8) {
+    joystick->config.filter_shift = 8;
+  }
+  joystick->callback = callback;
+  joystick->primed = false;
+  joystick->next = poll_list;
+  poll_list = joystick;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Removes a joystick instance from the poller.
+ *****************************************************************************/
+sl_status_t joystick_poll_remove(joystick_t *joystick)
+{
+  joystick_t **link;
+
+  for (link = &poll_list; *link != NULL; link = &(*link)->next) {
+    if (*link == joystick) {
+      *link = joystick->next;
+      joystick->next = NULL;
+      return SL_STATUS_OK;
+    }
+  }
+
+  return SL_STATUS_NOT_FOUND;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Starts the poller timer.
+ *****************************************************************************/
+sl_status_t joystick_poll_start(uint32_t period_ms)
+{
+  if (period_ms == 0) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sl_sleeptimer_stop_timer(&poll_timer);
+  poll_pending = true;
+  if (sl_sleeptimer_start_periodic_timer_ms(&poll_timer,
+                                            period_ms,
+                                            poll_timer_cb,
+                                            NULL,
+                                            0,
+                                            SL_SLEEPTIMER_NO_HIGH_PRECISION_HF_CLOCKS_REQUIRED_FLAG)
+      != SL_STATUS_OK) {
+    poll_pending = false;
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Stops the poller timer.
+ *****************************************************************************/
+sl_status_t joystick_poll_stop(void)
+{
+  poll_pending = false;
+  if (sl_sleeptimer_stop_timer(&poll_timer) != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Samples every polled joystick once per elapsed poller period.
+ *****************************************************************************/
+void joystick_poll_process(void)
+{
+  joystick_sample_t sample;
+  joystick_t *joystick;
+  joystick_t *next;
+
+  if (!poll_pending) {
+    return;
+  }
+  poll_pending = false;
+
+  for (joystick = poll_list; joystick != NULL; joystick = next) {
+    // The callback may remove the joystick from the list.
+    next = joystick->next;
+
+    if (joystick_read_sample(joystick, &sample) != SL_STATUS_OK) {
+      joystick->read_errors++;
+      continue;
+    }
+    if (poll_update(joystick, &sample)) {
+      joystick->callback(joystick, &sample);
+    }
+  }
+}
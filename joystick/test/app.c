@@ -36,24 +36,26 @@
 ******************************************************************************/
 #include "joystick.h"
 #include "sl_app_log.h"
-#include "sl_sleeptimer.h"
+#include "sl_i2cspm_instances.h"
 
-#define READING_INTERVAL_MSEC 200
+#define READING_INTERVAL_MSEC 20
 
-// Periodic timer handle.
-static sl_sleeptimer_timer_handle_t app_periodic_timer;
+// Joystick on the qwiic connector.
+static joystick_t joystick;
 
-static void app_periodic_timer_cb(sl_sleeptimer_timer_handle_t *timer, void *data);
+static void app_joystick_cb(joystick_t *handle,
+                            const joystick_sample_t *sample);
 
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
+  joystick_poll_config_t config = JOYSTICK_POLL_CONFIG_DEFAULT;
   sl_status_t sc;
 
   // Init joystick.
-  sc = joystick_init();
+  sc = joystick_instance_init(&joystick, sl_i2cspm_qwiic, JOYSTICK_I2C_ADDRESS);
   if (sc != SL_STATUS_OK) {
     sl_app_log("Warning! Failed to init Joystick\n");
   }
@@ -61,13 +63,11 @@ void app_init(void)
     sl_app_log("Joystick initialized\n");
   }
 
-  // Start timer used for periodic indications.
-  sc = sl_sleeptimer_start_periodic_timer_ms(&app_periodic_timer,
-                                             READING_INTERVAL_MSEC,
-                                             app_periodic_timer_cb,
-                                             NULL,
-                                             0,
-                                             SL_SLEEPTIMER_NO_HIGH_PRECISION_HF_CLOCKS_REQUIRED_FLAG);
+  // Only log the changes, each sample is a single I2C transfer.
+  sc = joystick_poll_add(&joystick, &config, app_joystick_cb);
+  if (sc == SL_STATUS_OK) {
+    sc = joystick_poll_start(READING_INTERVAL_MSEC);
+  }
   if (sc != SL_STATUS_OK) {
     sl_app_log("Warning! Failed to start timer\n");
   }
@@ -81,35 +81,21 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-
+  joystick_poll_process();
 }
 
 /**************************************************************************//**
- * Timer callback
- * Called periodically to reading data from joystick.
+ * Joystick callback
+ * Called when the position or the button of the joystick changed.
  *****************************************************************************/
-static void app_periodic_timer_cb(sl_sleeptimer_timer_handle_t *timer, void *data)
+static void app_joystick_cb(joystick_t *handle,
+                            const joystick_sample_t *sample)
 {
-  (void)data;
-  (void)timer;
-  sl_status_t sc;
-  uint16_t data_pos;
-
-  // Reading current horizontal position
-  sc = joystick_read_horizontal_position(&data_pos);
-  if (sc != SL_STATUS_OK) {
-    sl_app_log("Warning! Invalid Joystick reading\n");
-  }
-  else {
-    sl_app_log("X = %d, ", data_pos);
-  }
+  (void)handle;
 
-  // Reading current vertical position
-  sc = joystick_read_vertical_position(&data_pos);
-  if (sc != SL_STATUS_OK) {
-    sl_app_log("Warning! Invalid Joystick reading\n");
-  }
-  else {
-    sl_app_log("Y = %d\n", data_pos);
-  }
+  sl_app_log("X = %d, Y = %d%s\n",
+             sample->horizontal,
+             sample->vertical,
+             (sample->button == 0) ? ", pressed"
+             : (sample->button_status != 0) ? ", clicked" : "");
 }
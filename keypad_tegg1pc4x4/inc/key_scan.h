@@ -34,7 +34,9 @@
  * @addtogroup Key Pad Driver
  * @brief Key Pad Driver
  *  KEY_ROW_PINS, KEY_COLUMN_PINS define the key detect pin,
- *  Initialize with key_init(). Put key_scan() in a 10ms time slice.
+ *  Initialize with key_init(). Put key_scan() in a 10ms time slice, and stop
+ *  the time slice when key_scan() returns false. The wakeup callback is
+ *  called when a key is pressed again.
  * @{
  ******************************************************************************/
 
@@ -42,6 +44,7 @@
 
 /*****************   INCLUDES  **********************************************************/
 #include <stdbool.h>
+#include <stdint.h>
 #include "em_gpio.h"
 /***************** END OF INCLUDES *****************************************************/
 
@@ -57,6 +60,14 @@ extern "C" {
 #define KEY_ROW_PINS		{{gpioPortB, 0}, {gpioPortB, 1}, {gpioPortB, 2}, {gpioPortB, 3}}
 #define KEY_COLUMN_PINS		{{gpioPortC, 0}, {gpioPortC, 1}, {gpioPortC, 2}, {gpioPortC, 3}}
 
+#define KEY_NUM				(KEY_ROW_NUM * KEY_COLUMN_NUM)
+
+// Key events kept until read by key_get_event()
+#define KEY_EVENT_QUEUE_SIZE	16
+
+// Bit of a key in the key_get_state() bitmap, KEY_CODE01 is bit 0
+#define KEY_BIT(code)		(1u << ((code) - KEY_CODE01))
+
 typedef struct {
   GPIO_Port_TypeDef   port;
   unsigned int        pin;
@@ -96,11 +107,25 @@ typedef enum {
 /***************** END OF DEFINITIONS ***************************************************/
 
 /*****************    ENUM  /STRUCT******************************************************/
+typedef enum {
+  KEY_EVENT_PRESS,          // Key went down, after debouncing
+  KEY_EVENT_RELEASE,        // Key went up, after debouncing
+  KEY_EVENT_LONG_PRESS      // Key held for KEY_TIME_LONG
+}key_event_type_t;
+
+typedef struct {
+  key_code_t key;           // KEY_CODE01 to KEY_CODE16
+  key_event_type_t type;
+  uint16_t keys;            // Keys down after the scan, see KEY_BIT()
+}key_event_t;
+
 typedef struct {
- uint8_t value;
- uint8_t last_value;
- uint16_t press_10ms;
- bool pressed;
+  uint16_t state;           // Debounced keys down, bit n is key n + 1
+  uint16_t count0;          // Vertical counter, bit 0 and bit 1 of the
+  uint16_t count1;          //   consecutive samples that differ from state
+  uint16_t press_10ms[KEY_NUM]; // Time each key has been down
+  uint8_t value;            // Key code reported to the key callback
+  uint16_t value_10ms;      // Time the key code has been down
 }key_scan_t;
 
 typedef void (*key_callback_t)(key_code_t key);
@@ -120,10 +145,42 @@ extern void key_init(key_callback_t cb, key_wakeup_callback_t wakeup_cb);
  *
  * @param none
  *
- * @return none
+ * @return true while a key is down or bouncing, keep calling key_scan().
+ *   false when all keys are up, the time slice can be stopped until the
+ *   wakeup callback is called.
+ *
+ */
+extern bool key_scan(void);
+
+/**
+ * @brief Get the oldest key event.
+ *
+ * @param event, filled with the event
+ *
+ * @return false if there is no event.
+ *
+ */
+extern bool key_get_event(key_event_t *event);
+
+/**
+ * @brief Get the debounced keys down.
+ *
+ * @param none
+ *
+ * @return bitmap of the keys down, see KEY_BIT().
+ *
+ */
+extern uint16_t key_get_state(void);
+
+/**
+ * @brief Get the number of key events lost because the queue was full.
+ *
+ * @param none
+ *
+ * @return lost events since key_init().
  *
  */
-extern void key_scan(void);
+extern uint32_t key_get_event_overruns(void);
 
 #ifdef __cplusplus
 }
@@ -28,89 +28,170 @@
  * 3. This notice may not be removed or altered from any source distribution.
  *
  ******************************************************************************/
-#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 #include "key_scan.h"
 #include "gpiointerrupt.h"
 
+// Column pins on the same port with consecutive numbers, read at once
+typedef struct {
+  GPIO_Port_TypeDef   port;
+  uint8_t             pin;      // First pin of the group
+  uint8_t             column;   // First column of the group
+  uint8_t             mask;     // Columns of the group, from bit 0
+} key_column_group_t;
+
 static const key_io_t key_row_pins[KEY_ROW_NUM] = KEY_ROW_PINS;
 static const key_io_t key_column_pins[KEY_COLUMN_NUM] = KEY_COLUMN_PINS;
 
+static key_column_group_t key_column_groups[KEY_COLUMN_NUM];
+static uint8_t key_column_group_num;
+static uint32_t key_column_int_mask;
+
 static key_scan_t key;
 static key_callback_t key_callback = 0;
 
-const uint16_t key_map[KEY_CODE_NUM][2]=
+static key_event_t key_events[KEY_EVENT_QUEUE_SIZE];
+static volatile uint8_t key_event_head;
+static volatile uint8_t key_event_tail;
+static uint32_t key_event_overruns;
+
+// Keys pressed together reported with their own code
+static const struct {
+  uint16_t keys;
+  key_code_t code;
+} key_chords[] =
 {
-  {0x7FFF, KEY_CODE01,},
-  {0xBFFF, KEY_CODE02,},
-  {0xDFFF, KEY_CODE03,},
-  {0xEFFF, KEY_CODE04,},
-  {0xF7FF, KEY_CODE05,},
-  {0xFBFF, KEY_CODE06,},
-  {0xFDFF, KEY_CODE07,},
-  {0xFEFF, KEY_CODE08,},
-  {0xFF7F, KEY_CODE09,},
-  {0xFFBF, KEY_CODE10,},
-  {0xFFDF, KEY_CODE11,},
-  {0xFFEF, KEY_CODE12,},
-  {0xFFF7, KEY_CODE13,},
-  {0xFFFB, KEY_CODE14,},
-  {0xFFFD, KEY_CODE15,},
-  {0xFFFE, KEY_CODE16,},
-  {0x3FFF, KEY_CODE17,},
-  {0x77FF, KEY_CODE18,},
+  {KEY_BIT(KEY_CODE01) | KEY_BIT(KEY_CODE02), KEY_CODE17},
+  {KEY_BIT(KEY_CODE01) | KEY_BIT(KEY_CODE05), KEY_CODE18},
 };
 
-__STATIC_INLINE uint8_t key_decode(uint16_t val)
+__STATIC_INLINE uint8_t key_decode(uint16_t keys)
 {
   uint8_t i;
-  for (i = 0; i < KEY_CODE_NUM; i++) {
-    if (key_map[i][0] == val) {
-      return key_map[i][1];
+
+  if (keys == 0) {
+    return KEY_NONE;
+  }
+  // Single key
+  if ((keys & (keys - 1)) == 0) {
+    for (i = 0; (keys & (1u << i)) == 0; i++) {
+    }
+    return KEY_CODE01 + i;
+  }
+  for (i = 0; i < sizeof(key_chords) / sizeof(key_chords[0]); i++) {
+    if (key_chords[i].keys == keys) {
+      return key_chords[i].code;
     }
   }
   return KEY_NONE;
 }
 
-__STATIC_INLINE void key_10ms_timer(void)
-{	
-  //printf("key scan=%d\r\n",key.pressed);
-  if (key.pressed == true) {
-    if(key.value != key.last_value){
-    //key change
-    key.last_value = key.value;
-    key.press_10ms = 0;
+/**
+ * @brief Read all columns, one port read per column group.
+ *
+ * @param none
+ *
+ * @return bit c set if column c is pulled low.
+ *
+ */
+__STATIC_INLINE uint16_t key_read_columns(void)
+{
+  uint16_t columns = 0;
+
+  for (uint8_t g = 0; g < key_column_group_num; g++) {
+    uint32_t din = GPIO_PortInGet(key_column_groups[g].port);
+    columns |= ((din >> key_column_groups[g].pin) & key_column_groups[g].mask)
+               << key_column_groups[g].column;
   }
 
-  key.press_10ms++;
+  // Columns are pulled up, a key down pulls its column to the low row
+  return ~columns & ((1u << KEY_COLUMN_NUM) - 1);
+}
 
-  switch (key.press_10ms) {
-    case KEY_TIME_SHORT:
-      key_callback(key.value);
-      break;
+/**
+ * @brief Sample the whole key matrix.
+ *
+ * @param none
+ *
+ * @return bit n set if key n + 1 is down.
+ *
+ */
+__STATIC_INLINE uint16_t key_sample(void)
+{
+  uint16_t keys = 0;
 
-    case KEY_TIME_CONTINUE_START:
-      if ((key.value == KEY_CODE01) ||(key.value == KEY_CODE02)){
-        key.press_10ms -= KEY_TIME_CONTINUE_OFFSET;
-        key_callback(key.value);
-      }
-      break;
+  //Prepare, set all rows high
+  for (uint8_t r = 0; r < KEY_ROW_NUM; r++) {
+    GPIO_PinOutSet(key_row_pins[r].port, key_row_pins[r].pin);
+  }
+
+  //Key scan main part
+  for (uint8_t r = 0; r < KEY_ROW_NUM; r++) {
+    GPIO_PinOutClear(key_row_pins[r].port, key_row_pins[r].pin);
+    keys |= key_read_columns() << (r * KEY_COLUMN_NUM);
+    GPIO_PinOutSet(key_row_pins[r].port, key_row_pins[r].pin);
+  }
 
-    case KEY_TIME_LONG:
-      //printf("KEY_TIME_LONG\r\n");
-      break;
+  //Key interrupt desire a low edge, so set all rows low.
+  for (uint8_t r = 0; r < KEY_ROW_NUM; r++) {
+    GPIO_PinOutClear(key_row_pins[r].port, key_row_pins[r].pin);
+  }
 
-    case KEY_TIME_SUPER_LONG:
-      //printf("KEY_TIME_SUPER_LONG\r\n");
-      break;
+  return keys;
+}
 
-    case KEY_TIME_OVER:
-      key.press_10ms = KEY_TIME_SUPER_LONG;
-      //printf("KEY_TIME_OVER\r\n");
-      break;
+__STATIC_INLINE void key_queue_event(uint8_t index, key_event_type_t type)
+{
+  uint8_t next = key_event_head + 1;
+
+  if (next == KEY_EVENT_QUEUE_SIZE) {
+    next = 0;
+  }
+  if (next == key_event_tail) {
+    key_event_overruns++;
+    return;
+  }
+
+  key_events[key_event_head].key = (key_code_t)(KEY_CODE01 + index);
+  key_events[key_event_head].type = type;
+  key_events[key_event_head].keys = key.state;
+  key_event_head = next;
+}
+
+/**
+ * @brief Report the key code of the keys down to the key callback.
+ *
+ * @param changed, keys that changed in this scan
+ *
+ * @return none
+ *
+ */
+__STATIC_INLINE void key_10ms_timer(uint16_t changed)
+{
+  uint8_t last_value = key.value;
+
+  if (changed != 0) {
+    //key change
+    key.value = key_decode(key.state);
+    key.value_10ms = 0;
+    if (key.value != KEY_NONE) {
+      key_callback(key.value);
+    } else if (last_value != KEY_NONE) { //Release
+      key_callback(KEY_NONE);
     }
-  } else if (key.press_10ms > 0) { //Release
-	key.press_10ms = 0;
-	key_callback(KEY_NONE);
+    return;
+  }
+
+  if (key.value == KEY_NONE) {
+    return;
+  }
+
+  key.value_10ms++;
+  if ((key.value_10ms == KEY_TIME_CONTINUE_START)
+      && ((key.value == KEY_CODE01) || (key.value == KEY_CODE02))) {
+    key.value_10ms -= KEY_TIME_CONTINUE_OFFSET;
+    key_callback(key.value);
   }
 }
 
@@ -124,9 +205,12 @@ __STATIC_INLINE void key_10ms_timer(void)
  */
 void key_init(key_callback_t cb, key_wakeup_callback_t wakeup_cb)
 {
-  key.pressed = false;
-  key.press_10ms = 0;
-  key.value = KEY_NONE;
+  key_column_group_t *group = NULL;
+
+  memset(&key, 0, sizeof(key));
+  key_event_head = 0;
+  key_event_tail = 0;
+  key_event_overruns = 0;
 
   key_callback = cb;
 
@@ -136,7 +220,23 @@ void key_init(key_callback_t cb, key_wakeup_callback_t wakeup_cb)
 
   GPIOINT_Init();
 
+  key_column_group_num = 0;
+  key_column_int_mask = 0;
   for(uint8_t c = 0; c < KEY_COLUMN_NUM; c++) {
+    // Extend the group while the pins follow each other on the same port
+    if ((group != NULL)
+        && (group->port == key_column_pins[c].port)
+        && ((unsigned int)(group->pin + c - group->column) == key_column_pins[c].pin)) {
+      group->mask = (group->mask << 1) | 1;
+    } else {
+      group = &key_column_groups[key_column_group_num++];
+      group->port = key_column_pins[c].port;
+      group->pin = key_column_pins[c].pin;
+      group->column = c;
+      group->mask = 1;
+    }
+    key_column_int_mask |= 1u << key_column_pins[c].pin;
+
     GPIO_PinModeSet(key_column_pins[c].port, key_column_pins[c].pin, gpioModeInputPullFilter, 1);
     GPIO_ExtIntConfig(key_column_pins[c].port, key_column_pins[c].pin, key_column_pins[c].pin, false, true, true);
     GPIOINT_CallbackRegister(key_column_pins[c].pin, wakeup_cb);
@@ -148,41 +248,112 @@ void key_init(key_callback_t cb, key_wakeup_callback_t wakeup_cb)
  *
  * @param none
  *
- * @return none
+ * @return true while a key is down or bouncing.
  *
  */
-void key_scan(void)
-{	
-  uint32_t result = 0;
+bool key_scan(void)
+{
+  uint16_t sample;
+  uint16_t delta;
+  uint16_t changed;
+  uint16_t bit;
+  bool active;
 
-  //Prepare, set all rows high
-  for (uint8_t r = 0; r< KEY_ROW_NUM; r++) {
-    GPIO_PinOutSet(key_row_pins[r].port, key_row_pins[r].pin);
-  }
+  // Column edges caused by the scan must not wake up the application
+  GPIO_IntDisable(key_column_int_mask);
 
-  //Key scan main part
-  for (uint8_t r = 0; r< KEY_ROW_NUM; r++) {
-    GPIO_PinOutClear(key_row_pins[r].port, key_row_pins[r].pin);
-    for (uint8_t c = 0; c< KEY_COLUMN_NUM; c++) {
-      result |= GPIO_PinInGet(key_column_pins[c].port, key_column_pins[c].pin);
-      result <<= 1;
+  sample = key_sample();
+
+  // Debounce all keys in parallel with a 2-bit vertical counter, a key
+  // changes state after 4 consecutive samples that differ from it.
+  delta = sample ^ key.state;
+  key.count1 = (key.count1 ^ key.count0) & delta;
+  key.count0 = ~key.count0 & delta;
+  changed = delta & ~(key.count0 | key.count1);
+  key.state ^= changed;
+
+  if ((key.state | changed) != 0) {
+    for (uint8_t k = 0; k < KEY_NUM; k++) {
+      bit = 1u << k;
+      if (changed & bit) {
+        key.press_10ms[k] = 0;
+        key_queue_event(k, (key.state & bit) ? KEY_EVENT_PRESS
+                                             : KEY_EVENT_RELEASE);
+      } else if ((key.state & bit) && (key.press_10ms[k] < KEY_TIME_OVER)) {
+        key.press_10ms[k]++;
+        if (key.press_10ms[k] == KEY_TIME_LONG) {
+          key_queue_event(k, KEY_EVENT_LONG_PRESS);
+        }
+      }
     }
-    GPIO_PinOutSet(key_row_pins[r].port, key_row_pins[r].pin);
   }
 
-  //Key interrupt desire a low edge, so set all rows low.
-  for (uint8_t r = 0; r< KEY_ROW_NUM; r++) {
-    GPIO_PinOutClear(key_row_pins[r].port, key_row_pins[r].pin);
+  if (key_callback != NULL) {
+    key_10ms_timer(changed);
+  }
+
+  active = (key.state | key.count0 | key.count1) != 0;
+  if (!active) {
+    // Back to idle, the next key press wakes up the application
+    GPIO_IntClear(key_column_int_mask);
+    GPIO_IntEnable(key_column_int_mask);
+    // A key pressed after the sample has already had its edge
+    if (key_read_columns() != 0) {
+      GPIO_IntDisable(key_column_int_mask);
+      active = true;
+    }
   }
 
-  result >>= 1;
+  return active;
+}
 
-  key.value = key_decode(result);
-  if (key.value == KEY_NONE) {
-	key.pressed = false;
-  } else {
-	key.pressed = true;
+/**
+ * @brief Get the oldest key event.
+ *
+ * @param event, filled with the event
+ *
+ * @return false if there is no event.
+ *
+ */
+bool key_get_event(key_event_t *event)
+{
+  uint8_t tail = key_event_tail;
+
+  if (tail == key_event_head) {
+    return false;
   }
-  key_10ms_timer();
+
+  *event = key_events[tail];
+  tail++;
+  if (tail == KEY_EVENT_QUEUE_SIZE) {
+    tail = 0;
+  }
+  key_event_tail = tail;
+  return true;
+}
+
+/**
+ * @brief Get the debounced keys down.
+ *
+ * @param none
+ *
+ * @return bitmap of the keys down, see KEY_BIT().
+ *
+ */
+uint16_t key_get_state(void)
+{
+  return key.state;
 }
 
+/**
+ * @brief Get the number of key events lost because the queue was full.
+ *
+ * @param none
+ *
+ * @return lost events since key_init().
+ *
+ */
+uint32_t key_get_event_overruns(void)
+{
+  return key_event_overruns;
+}
@@ -4,6 +4,7 @@
 #include "em_cmu.h"
 #include "em_emu.h"
 #include "em_timer.h"
+#include "em_core.h"
 #include "retargetserial.h"
 #include "key_scan.h"
 
@@ -43,7 +44,6 @@ void TIMER2_init(void)
 }
 
 
-uint8_t key_test = 0xFF;
 uint8_t key_repeat = 0xFF;
 /**
  * @brief key press wakeup callback
@@ -55,11 +55,7 @@ uint8_t key_repeat = 0xFF;
  */
 void app_key_wakeup(uint8_t pin)
 {
-  //Test code, key jitter, avoid multiple set the timer.
-  if(key_test == pin)
-	  return;
-  key_test = pin;
-
+  (void)pin;
   //printf("key wakeup %d\r\n", pin);
   //Start the key timer
   TIMER_Enable(TIMER2, true);
@@ -77,17 +73,34 @@ void app_key_detect(key_code_t key)
 {
   if(key == KEY_NONE){
 	printf("key release\r\n");
-	key_test =0xFF;
-	//Key have release, stop the key timer
-	TIMER_Enable(TIMER2, false);
   }else{
 	key_repeat = key;
 	printf("key detect %d\r\n", key);
   }
 }
 
+/**
+ * @brief print the queued key events
+ *
+ * @param none
+ *
+ * @return none
+ *
+ */
+void app_key_events(void)
+{
+  static const char *type[] = {"press", "release", "long press"};
+  key_event_t event;
+
+  while (key_get_event(&event)) {
+	printf("key %d %s, keys down 0x%04x\r\n", event.key, type[event.type], event.keys);
+  }
+}
+
 int main(void)
 {
+  CORE_DECLARE_IRQ_STATE;
+
   /* Chip errata */
   CHIP_Init();
 
@@ -105,7 +118,15 @@ int main(void)
 		 timer_5ms -= 2; //make a 10ms time slice.
 		 //GPIO_PinOutToggle(gpioPortD,3);
 		 //printf("key scan\r\n");
-		 key_scan();
+		 //A wakeup between the last scan and stopping the timer must not be lost
+		 CORE_ENTER_CRITICAL();
+		 if (!key_scan()) {
+			 //All keys are up, stop the key timer until the next wakeup
+			 TIMER_Enable(TIMER2, false);
+			 timer_5ms = 0;
+		 }
+		 CORE_EXIT_CRITICAL();
+		 app_key_events();
 	 }
   }
 }
@@ -42,8 +42,35 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "sl_status.h"
 
+/**
+ *  Number of daisy-chained click boards. Board 0 is the one on the mikroBUS
+ *  socket and shows the leftmost digits, each further board is chained to the
+ *  MAX6969 serial output of the previous one.
+ */
+#ifndef LED_7SEG_BOARD_COUNT
+#define LED_7SEG_BOARD_COUNT    1
+#endif
+
+/**
+ *  Number of digits, numbered from 0 on the left
+ */
+#define LED_7SEG_DIGIT_COUNT    (2 * LED_7SEG_BOARD_COUNT)
+
+/**
+ *  Segments of a glyph, bit 0 to 6 are segments a to g
+ */
+#define LED_7SEG_SEGMENT_DOT    0x80
+#define LED_7SEG_SEGMENT_MINUS  0x40
+
+/**
+ *  Number of brightness steps of a contrast fade
+ */
+#define LED_7SEG_FADE_STEPS     32
+
 /**
  *  State of dot
  */
@@ -68,11 +95,11 @@ sl_status_t led_7seg_init(void);
 
 /***************************************************************************//**
  * @brief
- *    Write a number on LED 7-segment display via SPI interface.
+ *    Write a number on the two digits of board 0 and update the display.
  *
  * @note
  *    The data received on the MISO wire is discarded.
- *    @n This function is blocking and returns when the transfer is complete.
+ *    @n This function is non-blocking, see led_7seg_update().
  *
  * @param[in] number
  *    Transmit number that will display on the 7-segment.
@@ -99,6 +126,212 @@ sl_status_t led_7seg_display_number(uint8_t number, dot_state_t dot);
  ******************************************************************************/
 void led_7seg_set_contrast(uint8_t percent);
 
+/***************************************************************************//**
+ * @brief
+ *    Fade the light intensity of LED 7-segment to a new value.
+ *
+ * @note
+ *    The LDMA writes the brightness steps to the PWM compare buffer on the
+ *    compare match of each PWM period, the CPU is not involved once the
+ *    fade is started.
+ *    A fade is stopped by led_7seg_set_contrast() or a new fade.
+ *
+ * @param[in] percent
+ *   Percent of the light intensity at the end of the fade.
+ *
+ * @param[in] duration_ms
+ *   Duration of the fade, up to LED_7SEG_FADE_STEPS * 2048 PWM periods.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the fade is too long,
+ *    @ref SL_STATUS_FAIL if no LDMA channel is available
+ ******************************************************************************/
+sl_status_t led_7seg_fade_contrast(uint8_t percent, uint32_t duration_ms);
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a contrast fade is running.
+ ******************************************************************************/
+bool led_7seg_is_fading(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the glyph of a character.
+ *
+ * @param[in] c
+ *    Character, digits, letters (case-insensitive), '-', '_', '=' and ' '.
+ *
+ * @return
+ *    Segments of the glyph, blank for a character without a glyph.
+ ******************************************************************************/
+uint8_t led_7seg_glyph(char c);
+
+/***************************************************************************//**
+ * @brief
+ *    Set the segments of a digit in the frame buffer.
+ *
+ * @param[in] digit
+ *    Digit, 0 being the leftmost one.
+ *
+ * @param[in] segments
+ *    Segments to light, including the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success or @ref SL_STATUS_INVALID_PARAMETER if the
+ *    digit is out of the display
+ ******************************************************************************/
+sl_status_t led_7seg_set_glyph(uint16_t digit, uint8_t segments);
+
+/***************************************************************************//**
+ * @brief
+ *    Write a string in a field of the frame buffer.
+ *
+ * @note
+ *    A '.' lights the dot of the previous character. The string is left
+ *    aligned and the rest of the field is blanked.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] str
+ *    String to write.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the string was truncated
+ ******************************************************************************/
+sl_status_t led_7seg_display_string(uint16_t first,
+                                    uint16_t width,
+                                    const char *str);
+
+/***************************************************************************//**
+ * @brief
+ *    Write an integer in a field of the frame buffer.
+ *
+ * @note
+ *    The number is right aligned. A number that does not fit the field
+ *    shows as dashes.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write.
+ *
+ * @param[in] base
+ *    10 or 16.
+ *
+ * @param[in] zero_pad
+ *    Fill the field with leading zeros.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display or
+ *    the base is not supported,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_int(uint16_t first,
+                                 uint16_t width,
+                                 int32_t value,
+                                 uint8_t base,
+                                 bool zero_pad);
+
+/***************************************************************************//**
+ * @brief
+ *    Write a fixed-point number in a field of the frame buffer.
+ *
+ * @note
+ *    The number is right aligned, with the dot after the integer part.
+ *    A number that does not fit the field shows as dashes.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write, in units of 10^-decimals.
+ *
+ * @param[in] decimals
+ *    Number of digits after the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_fixed(uint16_t first,
+                                   uint16_t width,
+                                   int32_t value,
+                                   uint8_t decimals);
+
+/***************************************************************************//**
+ * @brief
+ *    Write a floating-point number in a field of the frame buffer.
+ *
+ * @note
+ *    The number is rounded to the number of decimals and written as
+ *    led_7seg_display_fixed() does.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write.
+ *
+ * @param[in] decimals
+ *    Number of digits after the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_float(uint16_t first,
+                                   uint16_t width,
+                                   float value,
+                                   uint8_t decimals);
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the frame buffer.
+ ******************************************************************************/
+void led_7seg_clear(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Send the frame buffer to the display chain if it has changed.
+ *
+ * @note
+ *    The frame is sent in the background by SPIDRV. If a frame is still
+ *    being sent, the new frame is sent right after it from the transfer
+ *    complete callback, so that the display always ends up with the last
+ *    frame. The frame buffer can be written again as soon as this function
+ *    returns.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ ******************************************************************************/
+sl_status_t led_7seg_update(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a frame is being sent.
+ ******************************************************************************/
+bool led_7seg_is_busy(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,12 +36,27 @@
 *
 ******************************************************************************/
 #include <led_7seg.h>
+#include <string.h>
+#include "em_core.h"
+#include "em_ldma.h"
+#include "dmadrv.h"
 #include "spidrv.h"
 #include "sl_spidrv_instances.h"
 #include "sl_pwm_instances.h"
+#include "sl_pwm_init_mikroe_config.h"
 
 #define spi_handle      sl_spidrv_mikroe_handle
-#define LED_7SEG_DOT    0x80
+#define LED_7SEG_DOT    LED_7SEG_SEGMENT_DOT
+
+/* PWM compare buffer register */
+#if defined(_TIMER_CC_OCB_MASK)
+#define PWM_COMPARE_BUFFER  OCB
+#else
+#define PWM_COMPARE_BUFFER  CCVB
+#endif
+
+/* Largest transfer count of an LDMA descriptor */
+#define LED_7SEG_FADE_MAX_REPEAT  2048
 
 static const uint8_t number_array[16] =
 {
@@ -63,6 +78,56 @@ static const uint8_t number_array[16] =
     0x71   // F
 };
 
+static const uint8_t letter_array[26] =
+{
+    0x77,  // A
+    0x7C,  // b
+    0x39,  // C
+    0x5E,  // d
+    0x79,  // E
+    0x71,  // F
+    0x3D,  // G
+    0x76,  // H
+    0x30,  // I
+    0x1E,  // J
+    0x75,  // K
+    0x38,  // L
+    0x37,  // M
+    0x54,  // n
+    0x5C,  // o
+    0x73,  // P
+    0x67,  // q
+    0x50,  // r
+    0x6D,  // S
+    0x78,  // t
+    0x3E,  // U
+    0x1C,  // v
+    0x2A,  // W
+    0x76,  // X
+    0x6E,  // y
+    0x5B   // Z
+};
+
+/* Frame buffer, written by the application */
+static uint8_t frame[LED_7SEG_DIGIT_COUNT];
+/* Frame being sent, in the shift order of the chain */
+static uint8_t tx_buffer[LED_7SEG_DIGIT_COUNT];
+/* The frame buffer differs from the last frame sent */
+static volatile bool frame_dirty = true;
+/* A frame is being sent */
+static volatile bool tx_busy = false;
+/* An update was requested while a frame was being sent */
+static volatile bool tx_pending = false;
+
+/* Contrast fade, one LDMA descriptor per brightness step */
+static unsigned int fade_channel;
+static bool fade_channel_allocated = false;
+static volatile bool fading = false;
+static uint32_t fade_compare[LED_7SEG_FADE_STEPS];
+static LDMA_Descriptor_t fade_desc[LED_7SEG_FADE_STEPS];
+
+static sl_status_t start_transfer(void);
+
 /***************************************************************************//**
  * @brief
  *   Initialize LED 7-Segment.
@@ -76,7 +141,8 @@ sl_status_t led_7seg_init(void)
 {
   sl_status_t sc;
 
-  /* Display number 0 */
+  /* Display number 0 on the first board, blank the others */
+  led_7seg_clear();
   sc = led_7seg_display_number(0, LED_7SEG_NO_DOT);
   // Set the light intensity of LED 7-segment to 50%
   led_7seg_set_contrast(50);
@@ -88,11 +154,11 @@ sl_status_t led_7seg_init(void)
 
 /***************************************************************************//**
  * @brief
- *    Write a number on LED 7-segment display via SPI interface.
+ *    Write a number on the two digits of board 0 and update the display.
  *
  * @note
  *    The data received on the MISO wire is discarded.
- *    @n This function is blocking and returns when the transfer is complete.
+ *    @n This function is non-blocking, see led_7seg_update().
  *
  * @param[in] number
  *    Transmit number that will display on the 7-segment.
@@ -105,52 +171,37 @@ sl_status_t led_7seg_init(void)
  ******************************************************************************/
 sl_status_t led_7seg_display_number(uint8_t number, dot_state_t dot)
 {
-  Ecode_t ret;
-
   uint8_t right_digit;
   uint8_t left_digit;
-  uint8_t data_buf[2];
 
   number %= 100;
 
-  left_digit = number / 10;
-  right_digit = number % 10;
+  left_digit = number_array[number / 10];
+  right_digit = number_array[number % 10];
 
-  if (dot == LED_7SEG_NO_DOT) {
-    right_digit = number_array[right_digit];
-    left_digit = number_array[left_digit];
-  }
-  else if (dot == LED_7SEG_LEFT_DOT) {
-    right_digit = number_array[right_digit];
-    left_digit = number_array[left_digit] | LED_7SEG_DOT;
+  if ((dot == LED_7SEG_LEFT_DOT) || (dot == LED_7SEG_LEFT_RIGHT_DOT)) {
+    left_digit |= LED_7SEG_DOT;
   }
-  else if (dot == LED_7SEG_RIGHT_DOT) {
-    right_digit = number_array[right_digit] | LED_7SEG_DOT;
-    left_digit = number_array[left_digit];
-  }
-  else if (dot == LED_7SEG_LEFT_RIGHT_DOT) {
-    right_digit = number_array[right_digit] | LED_7SEG_DOT;
-    left_digit = number_array[left_digit] | LED_7SEG_DOT;
+  if ((dot == LED_7SEG_RIGHT_DOT) || (dot == LED_7SEG_LEFT_RIGHT_DOT)) {
+    right_digit |= LED_7SEG_DOT;
   }
 
-  if (left_digit == 0) {
-    data_buf[0] = right_digit;
-    data_buf[1] = 0;
-  }
-  else {
-    data_buf[0] = right_digit;
-    data_buf[1] = left_digit;
-  }
+  led_7seg_set_glyph(0, left_digit);
+  led_7seg_set_glyph(1, right_digit);
 
-  /* Send a block transfer to slave. */
-  ret = SPIDRV_MTransmitB(spi_handle, data_buf, 2);
-  if (ret != ECODE_EMDRV_SPIDRV_OK) {
-    return SL_STATUS_FAIL;
-  }
+  return led_7seg_update();
+}
 
-  /* Note that at this point all the data is loaded into the fifo, this does
-   * not necessarily mean that the transfer is complete. */
-  return SL_STATUS_OK;
+/***************************************************************************//**
+ * @brief
+ *    Stop a contrast fade, the PWM keeps the last brightness step.
+ ******************************************************************************/
+static void stop_fade(void)
+{
+  if (fading) {
+    DMADRV_StopTransfer(fade_channel);
+    fading = false;
+  }
 }
 
 /***************************************************************************//**
@@ -167,6 +218,621 @@ sl_status_t led_7seg_display_number(uint8_t number, dot_state_t dot)
  ******************************************************************************/
 void led_7seg_set_contrast(uint8_t percent)
 {
+   stop_fade();
    // Set duty cycle
    sl_pwm_set_duty_cycle(&sl_pwm_mikroe, percent);
 }
+
+/***************************************************************************//**
+ * @brief
+ *    Get the LDMA request of a PWM compare channel.
+ ******************************************************************************/
+static LDMA_PeripheralSignal_t get_compare_signal(TIMER_TypeDef *timer,
+                                                  uint8_t channel)
+{
+  LDMA_PeripheralSignal_t signal = ldmaPeripheralSignal_TIMER0_CC0;
+
+  switch ((uint32_t)timer) {
+#if defined(TIMER1_BASE)
+    case TIMER1_BASE:
+      signal = ldmaPeripheralSignal_TIMER1_CC0;
+      break;
+#endif
+#if defined(TIMER2_BASE)
+    case TIMER2_BASE:
+      signal = ldmaPeripheralSignal_TIMER2_CC0;
+      break;
+#endif
+#if defined(TIMER3_BASE)
+    case TIMER3_BASE:
+      signal = ldmaPeripheralSignal_TIMER3_CC0;
+      break;
+#endif
+#if defined(TIMER4_BASE)
+    case TIMER4_BASE:
+      signal = ldmaPeripheralSignal_TIMER4_CC0;
+      break;
+#endif
+    default:
+      break;
+  }
+
+  // The CC0, CC1 and CC2 requests of a TIMER are consecutive
+  return (LDMA_PeripheralSignal_t)(signal + channel);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    LDMA callback of the last brightness step of a fade.
+ ******************************************************************************/
+static bool fade_complete(unsigned int channel,
+                          unsigned int sequenceNo,
+                          void *userParam)
+{
+  (void)channel;
+  (void)sequenceNo;
+  (void)userParam;
+
+  fading = false;
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Fade the light intensity of LED 7-segment to a new value.
+ *
+ * @note
+ *    The LDMA writes the brightness steps to the PWM compare buffer on the
+ *    compare match of each PWM period, the CPU is not involved once the
+ *    fade is started.
+ *    A fade is stopped by led_7seg_set_contrast() or a new fade.
+ *
+ * @param[in] percent
+ *   Percent of the light intensity at the end of the fade.
+ *
+ * @param[in] duration_ms
+ *   Duration of the fade, up to LED_7SEG_FADE_STEPS * 2048 PWM periods.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the fade is too long,
+ *    @ref SL_STATUS_FAIL if no LDMA channel is available
+ ******************************************************************************/
+sl_status_t led_7seg_fade_contrast(uint8_t percent, uint32_t duration_ms)
+{
+  TIMER_TypeDef *timer = sl_pwm_mikroe.timer;
+  uint32_t top = TIMER_TopGet(timer);
+  uint32_t periods;
+  uint32_t steps = LED_7SEG_FADE_STEPS;
+  uint32_t repeat;
+  int32_t start;
+  int32_t level;
+  uint32_t i;
+  LDMA_TransferCfg_t fade_cfg;
+
+  if (percent > 100) {
+    percent = 100;
+  }
+
+  // One brightness step is written per PWM period
+  periods = (uint32_t)(((uint64_t)duration_ms * SL_PWM_MIKROE_FREQUENCY) / 1000);
+  if (periods < steps) {
+    steps = periods;
+  }
+  if (steps == 0) {
+    led_7seg_set_contrast(percent);
+    return SL_STATUS_OK;
+  }
+  repeat = periods / steps;
+  if (repeat > LED_7SEG_FADE_MAX_REPEAT) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // SPIDRV has initialized DMADRV, which shares out the LDMA channels
+  if (!fade_channel_allocated) {
+    if (DMADRV_AllocateChannel(&fade_channel, NULL) != ECODE_EMDRV_DMADRV_OK) {
+      return SL_STATUS_FAIL;
+    }
+    fade_channel_allocated = true;
+  }
+
+  stop_fade();
+  start = sl_pwm_get_duty_cycle(&sl_pwm_mikroe);
+
+  for (i = 0; i < steps; i++) {
+    // Brightness in 0.01 %, the last step reaches the new value
+    level = (start * 100)
+            + ((((int32_t)percent - start) * 100 * (int32_t)(i + 1))
+               / (int32_t)steps);
+    fade_compare[i] = (uint32_t)(((uint64_t)top * (uint32_t)level) / 10000);
+
+    // Each step is written on `repeat` compare matches
+    if (i + 1 < steps) {
+      fade_desc[i] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(
+        &fade_compare[i], &timer->CC[sl_pwm_mikroe.channel].PWM_COMPARE_BUFFER, repeat, 1);
+    } else {
+      fade_desc[i] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(
+        &fade_compare[i], &timer->CC[sl_pwm_mikroe.channel].PWM_COMPARE_BUFFER, repeat);
+    }
+    fade_desc[i].xfer.size = ldmaCtrlSizeWord;
+    fade_desc[i].xfer.srcInc = ldmaCtrlSrcIncNone;
+  }
+
+  // The compare match request is cleared by the write of the compare buffer
+  fade_cfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(
+    get_compare_signal(timer, sl_pwm_mikroe.channel));
+
+  fading = true;
+  if (DMADRV_LdmaStartTransfer((int)fade_channel, &fade_cfg, fade_desc,
+                               fade_complete, NULL) != ECODE_EMDRV_DMADRV_OK) {
+    fading = false;
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a contrast fade is running.
+ ******************************************************************************/
+bool led_7seg_is_fading(void)
+{
+  return fading;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Get the glyph of a character.
+ *
+ * @param[in] c
+ *    Character, digits, letters (case-insensitive), '-', '_', '=' and ' '.
+ *
+ * @return
+ *    Segments of the glyph, blank for a character without a glyph.
+ ******************************************************************************/
+uint8_t led_7seg_glyph(char c)
+{
+  if ((c >= '0') && (c <= '9')) {
+    return number_array[c - '0'];
+  }
+  if ((c >= 'A') && (c <= 'Z')) {
+    return letter_array[c - 'A'];
+  }
+  if ((c >= 'a') && (c <= 'z')) {
+    return letter_array[c - 'a'];
+  }
+  if (c == '-') {
+    return LED_7SEG_SEGMENT_MINUS;
+  }
+  if (c == '_') {
+    return 0x08;
+  }
+  if (c == '=') {
+    return 0x48;
+  }
+
+  return 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Check that a field is within the display.
+ ******************************************************************************/
+static bool is_valid_field(uint16_t first, uint16_t width)
+{
+  return (width > 0) && ((uint32_t)first + width <= LED_7SEG_DIGIT_COUNT);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Copy glyphs into the frame buffer.
+ *
+ * @note
+ *    The copy is atomic with respect to the transfer complete callback,
+ *    which may start sending the frame buffer.
+ ******************************************************************************/
+static void write_frame(uint16_t first, const uint8_t *glyphs, uint16_t count)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (memcmp(&frame[first], glyphs, count) != 0) {
+    memcpy(&frame[first], glyphs, count);
+    frame_dirty = true;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Format a number, right aligned in a field.
+ *
+ * @return
+ *    false if the number does not fit the field
+ ******************************************************************************/
+static bool format_number(uint8_t *field,
+                          uint16_t width,
+                          int32_t value,
+                          uint8_t base,
+                          uint8_t decimals,
+                          bool zero_pad)
+{
+  uint32_t magnitude = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+  int32_t pos = (int32_t)width - 1;
+  uint32_t digits = 0;
+
+  memset(field, 0, width);
+
+  // At least one digit before the dot
+  do {
+    if (pos < 0) {
+      return false;
+    }
+    field[pos] = number_array[magnitude % base];
+    if ((decimals > 0) && (digits == decimals)) {
+      field[pos] |= LED_7SEG_DOT;
+    }
+    magnitude /= base;
+    digits++;
+    pos--;
+  } while ((magnitude != 0) || (digits <= decimals));
+
+  if (zero_pad) {
+    while (pos >= ((value < 0) ? 1 : 0)) {
+      field[pos--] = number_array[0];
+    }
+  }
+
+  if (value < 0) {
+    if (pos < 0) {
+      return false;
+    }
+    field[pos] = LED_7SEG_SEGMENT_MINUS;
+  }
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Write a number in a field of the frame buffer, dashes if it does not fit.
+ ******************************************************************************/
+static sl_status_t write_number(uint16_t first,
+                                uint16_t width,
+                                int32_t value,
+                                uint8_t base,
+                                uint8_t decimals,
+                                bool zero_pad)
+{
+  uint8_t field[LED_7SEG_DIGIT_COUNT];
+  sl_status_t sc = SL_STATUS_OK;
+
+  if (!format_number(field, width, value, base, decimals, zero_pad)) {
+    memset(field, LED_7SEG_SEGMENT_MINUS, width);
+    sc = SL_STATUS_WOULD_OVERFLOW;
+  }
+  write_frame(first, field, width);
+
+  return sc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Set the segments of a digit in the frame buffer.
+ *
+ * @param[in] digit
+ *    Digit, 0 being the leftmost one.
+ *
+ * @param[in] segments
+ *    Segments to light, including the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success or @ref SL_STATUS_INVALID_PARAMETER if the
+ *    digit is out of the display
+ ******************************************************************************/
+sl_status_t led_7seg_set_glyph(uint16_t digit, uint8_t segments)
+{
+  if (!is_valid_field(digit, 1)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  write_frame(digit, &segments, 1);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Write a string in a field of the frame buffer.
+ *
+ * @note
+ *    A '.' lights the dot of the previous character. The string is left
+ *    aligned and the rest of the field is blanked.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] str
+ *    String to write.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the string was truncated
+ ******************************************************************************/
+sl_status_t led_7seg_display_string(uint16_t first,
+                                    uint16_t width,
+                                    const char *str)
+{
+  uint8_t field[LED_7SEG_DIGIT_COUNT];
+  uint16_t pos = 0;
+  sl_status_t sc = SL_STATUS_OK;
+
+  if (!is_valid_field(first, width) || (str == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  memset(field, 0, width);
+
+  for (; *str != '\0'; str++) {
+    if ((*str == '.') && (pos > 0) && !(field[pos - 1] & LED_7SEG_DOT)) {
+      field[pos - 1] |= LED_7SEG_DOT;
+    } else if (pos < width) {
+      field[pos++] = (*str == '.') ? LED_7SEG_DOT : led_7seg_glyph(*str);
+    } else {
+      sc = SL_STATUS_WOULD_OVERFLOW;
+      break;
+    }
+  }
+
+  write_frame(first, field, width);
+
+  return sc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Write an integer in a field of the frame buffer.
+ *
+ * @note
+ *    The number is right aligned. A number that does not fit the field
+ *    shows as dashes.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write.
+ *
+ * @param[in] base
+ *    10 or 16.
+ *
+ * @param[in] zero_pad
+ *    Fill the field with leading zeros.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display or
+ *    the base is not supported,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_int(uint16_t first,
+                                 uint16_t width,
+                                 int32_t value,
+                                 uint8_t base,
+                                 bool zero_pad)
+{
+  if (!is_valid_field(first, width) || ((base != 10) && (base != 16))) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  return write_number(first, width, value, base, 0, zero_pad);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Write a fixed-point number in a field of the frame buffer.
+ *
+ * @note
+ *    The number is right aligned, with the dot after the integer part.
+ *    A number that does not fit the field shows as dashes.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write, in units of 10^-decimals.
+ *
+ * @param[in] decimals
+ *    Number of digits after the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_fixed(uint16_t first,
+                                   uint16_t width,
+                                   int32_t value,
+                                   uint8_t decimals)
+{
+  if (!is_valid_field(first, width)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  return write_number(first, width, value, 10, decimals, false);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Write a floating-point number in a field of the frame buffer.
+ *
+ * @note
+ *    The number is rounded to the number of decimals and written as
+ *    led_7seg_display_fixed() does.
+ *
+ * @param[in] first
+ *    First digit of the field.
+ *
+ * @param[in] width
+ *    Number of digits of the field.
+ *
+ * @param[in] value
+ *    Number to write.
+ *
+ * @param[in] decimals
+ *    Number of digits after the dot.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success,
+ *    @ref SL_STATUS_INVALID_PARAMETER if the field is out of the display,
+ *    @ref SL_STATUS_WOULD_OVERFLOW if the number does not fit the field
+ ******************************************************************************/
+sl_status_t led_7seg_display_float(uint16_t first,
+                                   uint16_t width,
+                                   float value,
+                                   uint8_t decimals)
+{
+  uint8_t field[LED_7SEG_DIGIT_COUNT];
+  uint8_t i;
+
+  if (!is_valid_field(first, width)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  for (i = 0; i < decimals; i++) {
+    value *= 10.0f;
+  }
+
+  // Out of the int32_t range, or not a number
+  if (!((value < 2147483520.0f) && (value > -2147483520.0f))) {
+    memset(field, LED_7SEG_SEGMENT_MINUS, width);
+    write_frame(first, field, width);
+    return SL_STATUS_WOULD_OVERFLOW;
+  }
+
+  return write_number(first, width,
+                      (int32_t)(value + ((value < 0.0f) ? -0.5f : 0.5f)),
+                      10, decimals, false);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the frame buffer.
+ ******************************************************************************/
+void led_7seg_clear(void)
+{
+  uint8_t field[LED_7SEG_DIGIT_COUNT];
+
+  memset(field, 0, sizeof(field));
+  write_frame(0, field, LED_7SEG_DIGIT_COUNT);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    SPIDRV callback of a frame transfer. Sends the frame again if it has
+ *    changed since and an update was requested in between.
+ ******************************************************************************/
+static void transfer_complete(SPIDRV_Handle_t handle,
+                              Ecode_t transferStatus,
+                              int itemsTransferred)
+{
+  (void)handle;
+  (void)transferStatus;
+  (void)itemsTransferred;
+
+  tx_busy = false;
+
+  if (tx_pending) {
+    tx_pending = false;
+    if (frame_dirty) {
+      start_transfer();
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start sending the frame buffer. Called with the interrupts masked or
+ *    from the transfer complete callback.
+ ******************************************************************************/
+static sl_status_t start_transfer(void)
+{
+  Ecode_t ret;
+  uint16_t board;
+  uint16_t pos;
+
+  // The MAX6969 registers form one shift register, the data of the last
+  // board of the chain is sent first. Each board takes the right digit
+  // first.
+  for (board = 0; board < LED_7SEG_BOARD_COUNT; board++) {
+    pos = 2 * (LED_7SEG_BOARD_COUNT - 1 - board);
+    tx_buffer[pos] = frame[(2 * board) + 1];
+    tx_buffer[pos + 1] = frame[2 * board];
+  }
+
+  frame_dirty = false;
+  tx_busy = true;
+
+  /* Send a non-blocking transfer to slave, the chain latches the frame when
+   * the chip select is released at the end of the transfer. */
+  ret = SPIDRV_MTransmit(spi_handle, tx_buffer, sizeof(tx_buffer),
+                         transfer_complete);
+  if (ret != ECODE_EMDRV_SPIDRV_OK) {
+    tx_busy = false;
+    frame_dirty = true;
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Send the frame buffer to the display chain if it has changed.
+ *
+ * @note
+ *    The frame is sent in the background by SPIDRV. If a frame is still
+ *    being sent, the new frame is sent right after it from the transfer
+ *    complete callback, so that the display always ends up with the last
+ *    frame. The frame buffer can be written again as soon as this function
+ *    returns.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ ******************************************************************************/
+sl_status_t led_7seg_update(void)
+{
+  sl_status_t sc = SL_STATUS_OK;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (tx_busy) {
+    tx_pending = true;
+  } else if (frame_dirty) {
+    sc = start_transfer();
+  }
+  CORE_EXIT_ATOMIC();
+
+  return sc;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a frame is being sent.
+ ******************************************************************************/
+bool led_7seg_is_busy(void)
+{
+  return tx_busy;
+}
@@ -75,4 +75,17 @@ void app_process_action(void)
     led_7seg_display_number(i*11, LED_7SEG_NO_DOT);
     sl_sleeptimer_delay_millisecond(1000);
   }
+
+  // Count tenths of seconds at 100 Hz across the whole chain while the
+  // brightness fades out and in without CPU involvement.
+  led_7seg_fade_contrast(0, 2000);
+  for (int i = 0; i < 400; i++) {
+    if (i == 200) {
+      led_7seg_fade_contrast(100, 2000);
+    }
+    led_7seg_display_fixed(0, LED_7SEG_DIGIT_COUNT, i / 10, 1);
+    led_7seg_update();
+    sl_sleeptimer_delay_millisecond(10);
+  }
+  led_7seg_set_contrast(50);
 }
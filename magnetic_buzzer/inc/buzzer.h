@@ -41,6 +41,7 @@ extern "C"{
 
 #include "buzzer_pwm.h"
 #include "buzzer_pwm_config.h"
+#include "buzzer_sequencer.h"
 
 /***************************************************************************//**
  * @addtogroup Buzzer Driver
@@ -105,15 +106,6 @@ typedef struct
   buzzer_volume_t volume;       /**< buzzer volume level */
 } buzzer_t;
 
-/***************************************************************************//**
- * @brief
- *    Buzzer musical note structure
- ******************************************************************************/
-typedef struct buzzer_note {
-  uint16_t  note;       /**< musical note */
-  uint16_t  duration;   /**< beat of the musical note */
-} buzzer_note_t;
-
 /***************************************************************************//**
  * @brief
  *    Buzzer melody structure
@@ -365,6 +357,97 @@ sl_status_t buzzer_end_sound(buzzer_t *buzzer);
  ******************************************************************************/
 sl_status_t buzzer_begin_sound(buzzer_t *buzzer, uint16_t freq);
 
+/***************************************************************************//**
+ * @brief
+ *  Computes the TIMER values of a melody for buzzer_queue_melody().
+ *
+ * @note
+ *  The melody is not modified and can be shared by several sequences. The
+ *  volume of the buzzer is applied at load time, the sequence has to be
+ *  loaded again after a change of the volume.
+ *
+ * @param[in] buzzer
+ *  The instance of buzzer_t.
+ *  See #buzzer_t object definition for the detailed explanation.
+ *
+ * @param[in,out] sequence
+ *  The sequence, with the steps storage set.
+ *
+ * @param[in] melody
+ *  Notes of the melody, a note of BUZZER_NOTE_SILENCE is a rest.
+ *
+ * @param[in] len
+ *  Number of notes, or 0 for a melody ended by BUZZER_END_MELODY.
+ *
+ * @param[in] envelope
+ *  Volume envelope of the notes.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER Pointer to NULL.
+ *  SL_STATUS_WOULD_OVERFLOW The storage of the sequence is too small.
+ *  SL_STATUS_INVALID_RANGE A note is out of the range of the TIMER.
+ ******************************************************************************/
+sl_status_t buzzer_load_melody(buzzer_t *buzzer,
+                               buzzer_sequence_t *sequence,
+                               const buzzer_note_t *melody,
+                               uint16_t len,
+                               const buzzer_envelope_t *envelope);
+
+/***************************************************************************//**
+ * @brief
+ *  Queues a melody on the buzzer.
+ *
+ * @note
+ *  The notes are advanced by the overflow interrupt of the PWM TIMER, which
+ *  is enabled while a melody is playing. The driver defines the interrupt
+ *  handler of BUZZER_PWM_PERIPHERAL. A melody of a higher priority than the
+ *  melody playing replaces it.
+ *
+ * @param[in] buzzer
+ *  The instance of buzzer_t, on BUZZER_PWM_PERIPHERAL.
+ *  See #buzzer_t object definition for the detailed explanation.
+ *
+ * @param[in] sequence
+ *  The melody, loaded by buzzer_load_melody(). It must stay valid until it
+ *  has been played.
+ *
+ * @param[in] priority
+ *  Priority of the melody, higher plays first.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER Pointer to NULL.
+ *  SL_STATUS_INVALID_PARAMETER The buzzer is not on BUZZER_PWM_PERIPHERAL.
+ *  SL_STATUS_FULL The queue is full.
+ ******************************************************************************/
+sl_status_t buzzer_queue_melody(buzzer_t *buzzer,
+                                const buzzer_sequence_t *sequence,
+                                uint8_t priority);
+
+/***************************************************************************//**
+ * @brief
+ *  Stops the melody playing and drops the melodies queued.
+ *
+ * @param[in] buzzer
+ *  The instance of buzzer_t.
+ *  See #buzzer_t object definition for the detailed explanation.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER Pointer to NULL.
+ ******************************************************************************/
+sl_status_t buzzer_stop_melody(buzzer_t *buzzer);
+
+/***************************************************************************//**
+ * @brief
+ *  Checks if a queued melody is playing or waiting.
+ *
+ * @return
+ *  true if a melody is playing or waiting.
+ ******************************************************************************/
+bool buzzer_is_playing(void);
+
 /** @} (end addtogroup buzzer driver) */
 
 #ifdef __cplusplus
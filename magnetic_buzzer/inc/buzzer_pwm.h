@@ -227,6 +227,18 @@ void buzzer_pwm_set_frequency(buzzer_pwm_instance_t *pwm, uint32_t freq);
  ******************************************************************************/
 uint32_t buzzer_pwm_get_frequency(buzzer_pwm_instance_t *pwm);
 
+/***************************************************************************//**
+ * @brief
+ *    Gets the frequency the TIMER counts at, after the prescaler.
+ *
+ * @param[in] pwm
+ *    PWM driver instance
+ *
+ * @return
+ *    The TIMER counter frequency
+ ******************************************************************************/
+uint32_t buzzer_pwm_get_timer_frequency(buzzer_pwm_instance_t *pwm);
+
 /** @} (end addtogroup pwm) */
 
 #ifdef __cplusplus
@@ -0,0 +1,280 @@
+/***************************************************************************//**
+ * @file buzzer_sequencer.h
+ * @brief Note timeline and melody queue of the magnetic buzzer
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#ifndef BUZZER_SEQUENCER_H
+#define BUZZER_SEQUENCER_H
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+/***************************************************************************//**
+ * @addtogroup Buzzer Sequencer
+ * @brief Buzzer Sequencer
+ * @{
+ *
+ * The sequencer plays melodies from the PWM TIMER overflow interrupt. When a
+ * melody is loaded, the TIMER TOP and compare values and the number of PWM
+ * periods of every note and envelope step are computed, so that the
+ * interrupt only counts PWM periods and loads the buffered TOP and compare
+ * values at the step boundaries. The sequencer has no hardware dependency.
+ *
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief
+ *    Number of duty cycle steps of the attack and of the decay
+ ******************************************************************************/
+#define BUZZER_ENVELOPE_STEPS       8
+
+/***************************************************************************//**
+ * @brief
+ *    Number of melodies waiting to be played
+ ******************************************************************************/
+#define BUZZER_QUEUE_SIZE           4
+
+/***************************************************************************//**
+ * @brief
+ *    Frequency of a silent note
+ ******************************************************************************/
+#define BUZZER_NOTE_SILENCE         0
+
+/***************************************************************************//**
+ * @brief
+ *    Buzzer musical note structure
+ ******************************************************************************/
+typedef struct buzzer_note {
+  uint16_t  note;       /**< musical note */
+  uint16_t  duration;   /**< beat of the musical note */
+} buzzer_note_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Volume envelope of the notes of a melody
+ ******************************************************************************/
+typedef struct {
+  uint16_t attack_ms;       /**< rise from silence to the volume */
+  uint16_t decay_ms;        /**< fall from the volume to the sustain level */
+  uint8_t sustain_percent;  /**< sustain level, percent of the volume */
+} buzzer_envelope_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Envelope playing every note at the volume
+ ******************************************************************************/
+#define BUZZER_ENVELOPE_NONE        { 0, 0, 100 }
+
+/***************************************************************************//**
+ * @brief
+ *    Envelope of a plucked note
+ ******************************************************************************/
+#define BUZZER_ENVELOPE_DEFAULT     { 10, 60, 50 }
+
+/***************************************************************************//**
+ * @brief
+ *    Precomputed note of a melody
+ ******************************************************************************/
+typedef struct {
+  uint32_t top;             /**< TIMER TOP value */
+  uint32_t peak;            /**< compare value at the volume */
+  uint32_t periods;         /**< PWM periods of the note */
+  uint16_t attack_periods;  /**< PWM periods per attack step, 0 for none */
+  uint16_t decay_periods;   /**< PWM periods per decay step, 0 for none */
+} buzzer_step_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Melody loaded for the sequencer. The melody itself is not modified, the
+ *    same sequence can be played any number of times.
+ ******************************************************************************/
+typedef struct {
+  buzzer_step_t *steps;     /**< storage for the notes, set by the caller */
+  uint16_t max_steps;       /**< size of the storage */
+  uint16_t count;           /**< number of notes loaded */
+  uint16_t sustain;         /**< sustain level, 1/256 of the volume */
+} buzzer_sequence_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Melody waiting in the queue
+ ******************************************************************************/
+typedef struct {
+  const buzzer_sequence_t *sequence;  /**< melody */
+  uint8_t priority;                   /**< higher plays first */
+} buzzer_queue_entry_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Sequencer state, advanced once per PWM period
+ ******************************************************************************/
+typedef struct {
+  const buzzer_sequence_t *sequence;  /**< melody playing, NULL if idle */
+  uint8_t priority;                   /**< priority of the melody playing */
+  uint16_t index;                     /**< note playing */
+  uint32_t position;                  /**< PWM periods played of the note */
+  uint32_t top;                       /**< TOP value output */
+  uint32_t compare;                   /**< compare value output */
+  buzzer_queue_entry_t queue[BUZZER_QUEUE_SIZE];  /**< melodies waiting */
+  uint8_t queue_count;                /**< number of melodies waiting */
+} buzzer_sequencer_t;
+
+/***************************************************************************//**
+ * @brief
+ *  Computes the TIMER values of a melody.
+ *
+ * @param[in,out] sequence
+ *  Sequence, with the steps storage set.
+ *
+ * @param[in] melody
+ *  Notes of the melody, a note of BUZZER_NOTE_SILENCE is a rest.
+ *
+ * @param[in] len
+ *  Number of notes.
+ *
+ * @param[in] envelope
+ *  Volume envelope of the notes.
+ *
+ * @param[in] volume
+ *  Duty cycle of the notes at the volume, in percent.
+ *
+ * @param[in] timer_hz
+ *  Frequency of the PWM TIMER counter.
+ *
+ * @param[in] max_top
+ *  Largest TOP value of the PWM TIMER.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER Pointer to NULL.
+ *  SL_STATUS_WOULD_OVERFLOW The storage is too small.
+ *  SL_STATUS_INVALID_RANGE A note is out of the range of the TIMER.
+ ******************************************************************************/
+sl_status_t buzzer_sequence_load(buzzer_sequence_t *sequence,
+                                 const buzzer_note_t *melody,
+                                 uint16_t len,
+                                 const buzzer_envelope_t *envelope,
+                                 uint8_t volume,
+                                 uint32_t timer_hz,
+                                 uint32_t max_top);
+
+/***************************************************************************//**
+ * @brief
+ *  Initializes a sequencer, with no melody playing or waiting.
+ *
+ * @param[out] sequencer
+ *  The sequencer.
+ ******************************************************************************/
+void buzzer_sequencer_init(buzzer_sequencer_t *sequencer);
+
+/***************************************************************************//**
+ * @brief
+ *  Queues a melody.
+ *
+ * @note
+ *  A melody of a higher priority than the melody playing replaces it, the
+ *  melody playing is dropped. Otherwise the melody waits for the melodies
+ *  of the same or a higher priority queued before it.
+ *
+ * @param[in] sequencer
+ *  The sequencer.
+ *
+ * @param[in] sequence
+ *  The melody, loaded by buzzer_sequence_load().
+ *
+ * @param[in] priority
+ *  Priority of the melody, higher plays first.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER Pointer to NULL.
+ *  SL_STATUS_FULL The queue is full.
+ ******************************************************************************/
+sl_status_t buzzer_sequencer_queue(buzzer_sequencer_t *sequencer,
+                                   const buzzer_sequence_t *sequence,
+                                   uint8_t priority);
+
+/***************************************************************************//**
+ * @brief
+ *  Stops the melody playing and empties the queue.
+ *
+ * @param[in] sequencer
+ *  The sequencer.
+ ******************************************************************************/
+void buzzer_sequencer_stop(buzzer_sequencer_t *sequencer);
+
+/***************************************************************************//**
+ * @brief
+ *  Advances the sequencer by one PWM period.
+ *
+ * @note
+ *  Called from the PWM TIMER overflow interrupt. The values returned are
+ *  written to the TOP and compare buffers, and apply from the next PWM
+ *  period on.
+ *
+ * @param[in] sequencer
+ *  The sequencer.
+ *
+ * @param[out] top
+ *  TIMER TOP value.
+ *
+ * @param[out] compare
+ *  TIMER compare value.
+ *
+ * @return
+ *  true if the TOP and compare values change.
+ ******************************************************************************/
+bool buzzer_sequencer_tick(buzzer_sequencer_t *sequencer,
+                           uint32_t *top,
+                           uint32_t *compare);
+
+/***************************************************************************//**
+ * @brief
+ *  Checks if a melody is playing or waiting.
+ *
+ * @param[in] sequencer
+ *  The sequencer.
+ ******************************************************************************/
+bool buzzer_sequencer_is_busy(const buzzer_sequencer_t *sequencer);
+
+/** @} (end addtogroup Buzzer Sequencer) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUZZER_SEQUENCER_H
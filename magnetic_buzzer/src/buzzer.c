@@ -34,11 +34,22 @@
  ******************************************************************************/
 #include "buzzer.h"
 #include "sl_sleeptimer.h"
+#include "em_core.h"
+
+// interrupt of the PWM TIMER
+#define BUZZER_TIMER_IRQ_HANDLER(n)   BUZZER_TIMER_IRQ_HANDLER_(n)
+#define BUZZER_TIMER_IRQ_HANDLER_(n)  TIMER##n##_IRQHandler
+#define BUZZER_TIMER_IRQN(n)          BUZZER_TIMER_IRQN_(n)
+#define BUZZER_TIMER_IRQN_(n)         TIMER##n##_IRQn
 
 // timer handle
 static sl_sleeptimer_timer_handle_t timer_play_sound_handle;
 static sl_sleeptimer_timer_handle_t timer_play_melody_handle;
 
+// melodies queued on the PWM TIMER
+static buzzer_sequencer_t sequencer;
+static bool sequencer_initialized = false;
+
 // buzzer callback function
 static void timer_buzzer_cb(sl_sleeptimer_timer_handle_t *handle, void *data);
 
@@ -289,4 +300,129 @@ static void timer_buzzer_cb(sl_sleeptimer_timer_handle_t *handle, void *data)
   }
 }
 
+/***************************************************************************//**
+ *  Computes the TIMER values of a melody
+ ******************************************************************************/
+sl_status_t buzzer_load_melody(buzzer_t *buzzer,
+                               buzzer_sequence_t *sequence,
+                               const buzzer_note_t *melody,
+                               uint16_t len,
+                               const buzzer_envelope_t *envelope)
+{
+  if ((buzzer == NULL) || (melody == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  // a melody of the legacy format ends at the first rest
+  if (len == 0) {
+    while (melody[len].note != BUZZER_NOTE_REST) {
+      len++;
+    }
+  }
+
+  return buzzer_sequence_load(sequence,
+                              melody,
+                              len,
+                              envelope,
+                              (uint8_t)buzzer->volume,
+                              buzzer_pwm_get_timer_frequency(&buzzer->pwm),
+                              TIMER_MaxCount(buzzer->pwm.timer));
+}
+
+/***************************************************************************//**
+ *  Queues a melody
+ ******************************************************************************/
+sl_status_t buzzer_queue_melody(buzzer_t *buzzer,
+                                const buzzer_sequence_t *sequence,
+                                uint8_t priority)
+{
+  sl_status_t retval;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((buzzer == NULL) || (sequence == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (buzzer->pwm.timer != BUZZER_PWM_PERIPHERAL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (!sequencer_initialized) {
+    buzzer_sequencer_init(&sequencer);
+    sequencer_initialized = true;
+  }
+  retval = buzzer_sequencer_queue(&sequencer, sequence, priority);
+  CORE_EXIT_ATOMIC();
+
+  if (retval != SL_STATUS_OK) {
+    return retval;
+  }
+
+  // the next notes are loaded on the overflows of the TIMER
+  TIMER_IntEnable(BUZZER_PWM_PERIPHERAL, TIMER_IEN_OF);
+  NVIC_EnableIRQ(BUZZER_TIMER_IRQN(BUZZER_PWM_PERIPHERAL_NO));
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Stops the melody playing and drops the melodies queued
+ ******************************************************************************/
+sl_status_t buzzer_stop_melody(buzzer_t *buzzer)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (buzzer == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (sequencer_initialized) {
+    buzzer_sequencer_stop(&sequencer);
+  }
+  TIMER_IntDisable(BUZZER_PWM_PERIPHERAL, TIMER_IEN_OF);
+  CORE_EXIT_ATOMIC();
+
+  buzzer_pwm_set_duty_cycle(&buzzer->pwm, buzzer_VOL0);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Checks if a queued melody is playing or waiting
+ ******************************************************************************/
+bool buzzer_is_playing(void)
+{
+  return sequencer_initialized && buzzer_sequencer_is_busy(&sequencer);
+}
+
+/***************************************************************************//**
+ *  PWM TIMER interrupt handler, loads the TIMER values of the next period
+ ******************************************************************************/
+void BUZZER_TIMER_IRQ_HANDLER(BUZZER_PWM_PERIPHERAL_NO)(void)
+{
+  uint32_t top, compare;
+  uint32_t flags = TIMER_IntGet(BUZZER_PWM_PERIPHERAL);
+
+  TIMER_IntClear(BUZZER_PWM_PERIPHERAL, flags);
+
+  if (!(flags & TIMER_IF_OF)) {
+    return;
+  }
+
+  // both buffers load on the same overflow, the waveform changes at the end
+  // of a PWM period only
+  if (buzzer_sequencer_tick(&sequencer, &top, &compare)) {
+    TIMER_TopBufSet(BUZZER_PWM_PERIPHERAL, top);
+    TIMER_CompareBufSet(BUZZER_PWM_PERIPHERAL,
+                        BUZZER_PWM_OUTPUT_CHANNEL,
+                        compare);
+  }
+
+  if (!buzzer_sequencer_is_busy(&sequencer)) {
+    TIMER_IntDisable(BUZZER_PWM_PERIPHERAL, TIMER_IEN_OF);
+  }
+}
+
 /** @} (end group buzzer driver) */
@@ -290,3 +290,19 @@ uint32_t buzzer_pwm_get_frequency(buzzer_pwm_instance_t *pwm)
 
   return freq;
 }
+
+uint32_t buzzer_pwm_get_timer_frequency(buzzer_pwm_instance_t *pwm)
+{
+  CMU_Clock_TypeDef timer_clock = get_timer_clock(pwm->timer);
+
+  // Prescaler selected by buzzer_pwm_init()
+#if defined(_TIMER_CFG_PRESC_MASK)
+  uint32_t presc = ((pwm->timer->CFG & _TIMER_CFG_PRESC_MASK)
+                    >> _TIMER_CFG_PRESC_SHIFT) + 1U;
+#else
+  uint32_t presc = 1U << ((pwm->timer->CTRL & _TIMER_CTRL_PRESC_MASK)
+                          >> _TIMER_CTRL_PRESC_SHIFT);
+#endif
+
+  return (uint32_t)CMU_ClockFreqGet(timer_clock) / presc;
+}
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ * @file buzzer_sequencer.c
+ * @brief Note timeline and melody queue of the magnetic buzzer
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#include <stddef.h>
+#include "buzzer_sequencer.h"
+
+// Envelope levels are in 1/256 of the volume
+#define BUZZER_LEVEL_FULL           256U
+
+// TOP of a silent note, keeps the interrupt rate of a 1 kHz note
+#define BUZZER_SILENCE_FREQ         1000U
+
+static bool buzzer_sequencer_dequeue(buzzer_sequencer_t *sequencer);
+static uint32_t buzzer_step_periods(uint32_t ms,
+                                    uint32_t timer_hz,
+                                    uint32_t period);
+
+/***************************************************************************//**
+ * @addtogroup Buzzer Sequencer
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ *  Computes the TIMER values of a melody
+ ******************************************************************************/
+sl_status_t buzzer_sequence_load(buzzer_sequence_t *sequence,
+                                 const buzzer_note_t *melody,
+                                 uint16_t len,
+                                 const buzzer_envelope_t *envelope,
+                                 uint8_t volume,
+                                 uint32_t timer_hz,
+                                 uint32_t max_top)
+{
+  uint64_t elapsed_ms = 0;
+  uint64_t elapsed_ticks = 0;
+  uint64_t end_ticks;
+  uint32_t freq, period, periods;
+  uint8_t sustain;
+
+  if ((sequence == NULL)
+      || (sequence->steps == NULL)
+      || (melody == NULL)
+      || (envelope == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (len > sequence->max_steps) {
+    return SL_STATUS_WOULD_OVERFLOW;
+  }
+
+  if (volume > 100) {
+    volume = 100;
+  }
+
+  sustain = (envelope->sustain_percent > 100) ? 100 : envelope->sustain_percent;
+
+  for (uint16_t i = 0; i < len; i++) {
+    buzzer_step_t *step = &sequence->steps[i];
+
+    freq = (melody[i].note == BUZZER_NOTE_SILENCE)
+           ? BUZZER_SILENCE_FREQ : melody[i].note;
+    period = (timer_hz + (freq / 2)) / freq;
+
+    if ((period < 2) || ((period - 1) > max_top)) {
+      return SL_STATUS_INVALID_RANGE;
+    }
+
+    // Note lengths are rounded against the end of the note in the melody,
+    // so that the rounding errors do not add up over the melody
+    elapsed_ms += melody[i].duration;
+    end_ticks = (elapsed_ms * timer_hz) / 1000;
+    periods = 0;
+    if (end_ticks > elapsed_ticks) {
+      periods = (uint32_t)((end_ticks - elapsed_ticks + (period / 2)) / period);
+    }
+    elapsed_ticks += (uint64_t)periods * period;
+
+    step->top = period - 1;
+    step->peak = (melody[i].note == BUZZER_NOTE_SILENCE)
+                 ? 0 : (step->top * volume) / 100;
+    step->periods = periods;
+    step->attack_periods = (uint16_t)buzzer_step_periods(envelope->attack_ms,
+                                                         timer_hz,
+                                                         period);
+    step->decay_periods = (uint16_t)buzzer_step_periods(envelope->decay_ms,
+                                                        timer_hz,
+                                                        period);
+  }
+
+  sequence->count = len;
+  sequence->sustain = (uint16_t)((sustain * BUZZER_LEVEL_FULL) / 100);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Initializes a sequencer
+ ******************************************************************************/
+void buzzer_sequencer_init(buzzer_sequencer_t *sequencer)
+{
+  sequencer->sequence = NULL;
+  sequencer->priority = 0;
+  sequencer->index = 0;
+  sequencer->position = 0;
+  sequencer->top = 0;
+  sequencer->compare = 0;
+  sequencer->queue_count = 0;
+}
+
+/***************************************************************************//**
+ *  Queues a melody
+ ******************************************************************************/
+sl_status_t buzzer_sequencer_queue(buzzer_sequencer_t *sequencer,
+                                   const buzzer_sequence_t *sequence,
+                                   uint8_t priority)
+{
+  uint8_t slot;
+
+  if ((sequencer == NULL) || (sequence == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  // preempts a melody of a lower priority
+  if ((sequencer->sequence != NULL) && (priority > sequencer->priority)) {
+    sequencer->sequence = sequence;
+    sequencer->priority = priority;
+    sequencer->index = 0;
+    sequencer->position = 0;
+
+    return SL_STATUS_OK;
+  }
+
+  if (sequencer->queue_count >= BUZZER_QUEUE_SIZE) {
+    return SL_STATUS_FULL;
+  }
+
+  // waits behind the melodies of the same or a higher priority
+  slot = sequencer->queue_count;
+  while ((slot > 0) && (sequencer->queue[slot - 1].priority < priority)) {
+    sequencer->queue[slot] = sequencer->queue[slot - 1];
+    slot--;
+  }
+
+  sequencer->queue[slot].sequence = sequence;
+  sequencer->queue[slot].priority = priority;
+  sequencer->queue_count++;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Stops the melody playing and empties the queue
+ ******************************************************************************/
+void buzzer_sequencer_stop(buzzer_sequencer_t *sequencer)
+{
+  sequencer->sequence = NULL;
+  sequencer->queue_count = 0;
+  sequencer->compare = 0;
+}
+
+/***************************************************************************//**
+ *  Advances the sequencer by one PWM period
+ ******************************************************************************/
+bool buzzer_sequencer_tick(buzzer_sequencer_t *sequencer,
+                           uint32_t *top,
+                           uint32_t *compare)
+{
+  const buzzer_step_t *step = NULL;
+  uint32_t level, position, ramp;
+  bool changed;
+
+  // finds the note of the next PWM period, skipping the notes too short
+  // for one period
+  while (step == NULL) {
+    if ((sequencer->sequence == NULL) && !buzzer_sequencer_dequeue(sequencer)) {
+      break;
+    }
+
+    if (sequencer->index >= sequencer->sequence->count) {
+      sequencer->sequence = NULL;
+    } else if (sequencer->position >= sequencer->sequence->steps[sequencer->index].periods) {
+      sequencer->index++;
+      sequencer->position = 0;
+    } else {
+      step = &sequencer->sequence->steps[sequencer->index];
+    }
+  }
+
+  if (step == NULL) {
+    // idle, silent at the last frequency
+    changed = (sequencer->compare != 0);
+    sequencer->compare = 0;
+  } else {
+    position = sequencer->position++;
+    ramp = step->attack_periods * BUZZER_ENVELOPE_STEPS;
+
+    if (position < ramp) {
+      // attack from silence to the volume
+      level = ((position / step->attack_periods) + 1) * BUZZER_LEVEL_FULL
+              / BUZZER_ENVELOPE_STEPS;
+    } else {
+      position -= ramp;
+      ramp = step->decay_periods * BUZZER_ENVELOPE_STEPS;
+
+      if (position < ramp) {
+        // decay from the volume to the sustain level
+        level = BUZZER_LEVEL_FULL
+                - ((BUZZER_LEVEL_FULL - sequencer->sequence->sustain)
+                   * ((position / step->decay_periods) + 1)
+                   / BUZZER_ENVELOPE_STEPS);
+      } else {
+        level = sequencer->sequence->sustain;
+      }
+    }
+
+    level = (step->peak * level) / BUZZER_LEVEL_FULL;
+
+    changed = (sequencer->top != step->top) || (sequencer->compare != level);
+    sequencer->top = step->top;
+    sequencer->compare = level;
+  }
+
+  *top = sequencer->top;
+  *compare = sequencer->compare;
+
+  return changed;
+}
+
+/***************************************************************************//**
+ *  Checks if a melody is playing or waiting
+ ******************************************************************************/
+bool buzzer_sequencer_is_busy(const buzzer_sequencer_t *sequencer)
+{
+  return (sequencer->sequence != NULL) || (sequencer->queue_count > 0);
+}
+
+/***************************************************************************//**
+ *  Starts the first melody of the queue
+ ******************************************************************************/
+static bool buzzer_sequencer_dequeue(buzzer_sequencer_t *sequencer)
+{
+  if (sequencer->queue_count == 0) {
+    return false;
+  }
+
+  sequencer->sequence = sequencer->queue[0].sequence;
+  sequencer->priority = sequencer->queue[0].priority;
+  sequencer->index = 0;
+  sequencer->position = 0;
+
+  sequencer->queue_count--;
+  for (uint8_t i = 0; i < sequencer->queue_count; i++) {
+    sequencer->queue[i] = sequencer->queue[i + 1];
+  }
+
+  return true;
+}
+
+/***************************************************************************//**
+ *  Converts the length of an envelope ramp to PWM periods per step
+ ******************************************************************************/
+static uint32_t buzzer_step_periods(uint32_t ms,
+                                    uint32_t timer_hz,
+                                    uint32_t period)
+{
+  uint64_t periods;
+
+  if (ms == 0) {
+    return 0;
+  }
+
+  periods = ((uint64_t)ms * timer_hz)
+            / ((uint64_t)1000 * BUZZER_ENVELOPE_STEPS * period);
+
+  if (periods == 0) {
+    return 1;
+  }
+
+  return (periods > UINT16_MAX) ? UINT16_MAX : (uint32_t)periods;
+}
+
+/** @} (end addtogroup Buzzer Sequencer) */
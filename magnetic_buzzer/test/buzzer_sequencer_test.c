@@ -0,0 +1,396 @@
+/***************************************************************************//**
+ * @file buzzer_sequencer_test.c
+ * @brief Host test of the magnetic buzzer note timeline
+ *
+ * Runs the sequencer as the PWM TIMER overflow interrupt does and checks the
+ * start time and frequency of every note, the attack and decay envelope, the
+ * silence at the end of a melody, the priority queue, and that playing a
+ * melody leaves it unchanged.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc -I<gsdk>/platform/common/inc buzzer_sequencer_test.c \
+ *       ../src/buzzer_sequencer.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buzzer_sequencer.h"
+
+// TIMER counting at 1 MHz, 16 bits
+#define TIMER_HZ              1000000UL
+#define MAX_TOP               0xFFFFUL
+
+#define VOLUME                10
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// One PWM period as output by the interrupt
+typedef struct {
+  uint64_t start;             // TIMER ticks since the melody started
+  uint32_t top;
+  uint32_t compare;
+  uint16_t index;             // note of the melody
+  const buzzer_sequence_t *sequence;
+} period_t;
+
+#define MAX_PERIODS           200000
+
+static period_t trace[MAX_PERIODS];
+
+// Runs the overflow interrupt until the sequencer is idle, returns the
+// number of PWM periods played
+static unsigned run(buzzer_sequencer_t *seq, unsigned *changes)
+{
+  unsigned n = 0;
+  uint64_t t = 0;
+  uint32_t top, compare;
+
+  *changes = 0;
+
+  while (buzzer_sequencer_is_busy(seq) && (n < MAX_PERIODS)) {
+    if (buzzer_sequencer_tick(seq, &top, &compare)) {
+      (*changes)++;
+    }
+
+    if (!buzzer_sequencer_is_busy(seq)) {
+      // the silence closing the melody
+      CHECK(compare == 0);
+      break;
+    }
+
+    trace[n].start = t;
+    trace[n].top = top;
+    trace[n].compare = compare;
+    trace[n].index = seq->index;
+    trace[n].sequence = seq->sequence;
+    t += top + 1;
+    n++;
+  }
+
+  return n;
+}
+
+// Start of every note, and the frequency played, against the melody
+static void test_timeline(void)
+{
+  static buzzer_note_t melody[300];
+  static buzzer_step_t steps[300];
+  buzzer_note_t copy[300];
+  buzzer_sequence_t sequence = { steps, 300, 0, 0 };
+  buzzer_envelope_t envelope = BUZZER_ENVELOPE_NONE;
+  buzzer_sequencer_t seq;
+  uint64_t expected_ms = 0;
+  unsigned n, changes, i, note;
+  int seen[300] = { 0 };
+  uint32_t worst = 0;
+
+  // awkward frequencies and lengths, rounding to PWM periods every note
+  for (i = 0; i < 300; i++) {
+    melody[i].note = (uint16_t)(1047 + (i * 131) % 3900);
+    melody[i].duration = (uint16_t)(37 + (i * 7) % 23);
+  }
+  melody[17].note = BUZZER_NOTE_SILENCE;
+  memcpy(copy, melody, sizeof(copy));
+
+  CHECK(buzzer_sequence_load(&sequence, melody, 300, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_OK);
+  CHECK(sequence.count == 300);
+
+  buzzer_sequencer_init(&seq);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence, 0) == SL_STATUS_OK);
+  n = run(&seq, &changes);
+
+  for (i = 0; i < n; i++) {
+    note = trace[i].index;
+
+    if (!seen[note]) {
+      uint64_t start_ms = 0;
+      uint64_t expected, error;
+      unsigned j;
+
+      seen[note] = 1;
+      for (j = 0; j < note; j++) {
+        start_ms += melody[j].duration;
+      }
+      expected = start_ms * TIMER_HZ / 1000;
+      error = (trace[i].start > expected) ? trace[i].start - expected
+              : expected - trace[i].start;
+
+      // within one PWM period of the melody, at the start and at the end
+      CHECK(error <= trace[i].top + 1);
+      if (error > worst) {
+        worst = (uint32_t)error;
+      }
+    }
+
+    if (melody[note].note == BUZZER_NOTE_SILENCE) {
+      CHECK(trace[i].compare == 0);
+    } else {
+      double hz = (double)TIMER_HZ / (trace[i].top + 1);
+      CHECK(abs((int)(hz + 0.5) - melody[note].note) * 200 <= melody[note].note);
+      CHECK(trace[i].compare == trace[i].top * VOLUME / 100);
+    }
+  }
+
+  for (i = 0; i < 300; i++) {
+    CHECK(seen[i]);
+    expected_ms += melody[i].duration;
+  }
+
+  // total length of the melody
+  {
+    uint64_t end = trace[n - 1].start + trace[n - 1].top + 1;
+    uint64_t expected = expected_ms * TIMER_HZ / 1000;
+    CHECK(((end > expected) ? end - expected : expected - end) <= 1000);
+  }
+
+  // the melody is not modified
+  CHECK(memcmp(copy, melody, sizeof(copy)) == 0);
+
+  printf("timeline: %u notes, %u periods, %u register writes, "
+         "worst onset error %u us\n", 300, n, changes, worst);
+}
+
+// Attack to the volume, decay to the sustain level, sustain
+static void test_envelope(void)
+{
+  buzzer_note_t melody[] = {
+    { 2000, 200 }, { BUZZER_NOTE_SILENCE, 50 }, { 1047, 150 }
+  };
+  buzzer_step_t steps[3];
+  buzzer_sequence_t sequence = { steps, 3, 0, 0 };
+  buzzer_envelope_t envelope = BUZZER_ENVELOPE_DEFAULT;
+  buzzer_sequencer_t seq;
+  unsigned n, changes, i;
+  uint32_t top = 0, compare = 0, peak, sustain, previous = 0;
+  int falling = 0;
+  int reached_peak = 0;
+
+  CHECK(buzzer_sequence_load(&sequence, melody, 3, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_OK);
+
+  buzzer_sequencer_init(&seq);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence, 0) == SL_STATUS_OK);
+  n = run(&seq, &changes);
+
+  peak = steps[0].peak;
+  sustain = peak * sequence.sustain / 256;
+  CHECK(peak == steps[0].top * VOLUME / 100);
+
+  for (i = 0; (i < n) && (trace[i].index == 0); i++) {
+    uint32_t c = trace[i].compare;
+    uint64_t ms = trace[i].start / (TIMER_HZ / 1000);
+
+    if (reached_peak && (c < peak)) {
+      falling = 1;
+    }
+
+    if (!falling) {
+      // attack rises by steps to the peak within 10 ms
+      CHECK(c >= previous);
+      CHECK(c > 0);
+      if (c == peak) {
+        reached_peak = 1;
+        CHECK(ms <= 10);
+      }
+    }
+
+    if (falling) {
+      CHECK(c <= previous);
+      CHECK(c >= sustain);
+    }
+
+    // sustained after the decay
+    if (ms >= 75) {
+      CHECK(c == sustain);
+    }
+    previous = c;
+  }
+  CHECK(reached_peak);
+  CHECK(falling);
+
+  // the rest is silent, the next note starts with an attack again
+  for (; (i < n) && (trace[i].index == 1); i++) {
+    CHECK(trace[i].compare == 0);
+  }
+  CHECK((i < n) && (trace[i].index == 2));
+  CHECK(trace[i].compare < steps[2].peak);
+
+  // the last period is followed by silence, then nothing changes
+  CHECK(!buzzer_sequencer_is_busy(&seq));
+  CHECK(!buzzer_sequencer_tick(&seq, &top, &compare));
+  CHECK(compare == 0);
+
+  // at most two register writes per envelope step
+  CHECK(changes <= 3 * 2 * (2 * BUZZER_ENVELOPE_STEPS + 2));
+}
+
+// Priorities, preemption and a full queue
+static void test_queue(void)
+{
+  buzzer_note_t melody[] = { { 1500, 20 }, { 2500, 20 } };
+  buzzer_step_t steps[6][2];
+  buzzer_sequence_t sequence[6];
+  buzzer_envelope_t envelope = BUZZER_ENVELOPE_NONE;
+  buzzer_sequencer_t seq;
+  uint32_t top, compare;
+  const buzzer_sequence_t *order[8];
+  unsigned n, changes, i, played = 0;
+
+  for (i = 0; i < 6; i++) {
+    sequence[i].steps = steps[i];
+    sequence[i].max_steps = 2;
+    CHECK(buzzer_sequence_load(&sequence[i], melody, 2, &envelope, VOLUME,
+                               TIMER_HZ, MAX_TOP) == SL_STATUS_OK);
+  }
+
+  buzzer_sequencer_init(&seq);
+  CHECK(!buzzer_sequencer_is_busy(&seq));
+  CHECK(!buzzer_sequencer_tick(&seq, &top, &compare));
+
+  // 0 plays, 1 waits
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[0], 1) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_tick(&seq, &top, &compare));
+  CHECK(seq.sequence == &sequence[0]);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[1], 1) == SL_STATUS_OK);
+
+  // 2 replaces 0 at once
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[2], 3) == SL_STATUS_OK);
+  CHECK(seq.sequence == &sequence[2]);
+  CHECK(seq.index == 0 && seq.position == 0);
+
+  // 3 and 4 go before 1, in the order queued; 5 does not fit
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[3], 2) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[4], 2) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[5], 0) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[5], 0) == SL_STATUS_FULL);
+  CHECK(buzzer_sequencer_queue(NULL, &sequence[5], 0) == SL_STATUS_NULL_POINTER);
+
+  n = run(&seq, &changes);
+  for (i = 0; i < n; i++) {
+    if ((played == 0) || (order[played - 1] != trace[i].sequence)) {
+      CHECK(played < 8);
+      order[played++] = trace[i].sequence;
+    }
+  }
+
+  CHECK(played == 5);
+  CHECK(order[0] == &sequence[2]);
+  CHECK(order[1] == &sequence[3]);
+  CHECK(order[2] == &sequence[4]);
+  CHECK(order[3] == &sequence[1]);
+  CHECK(order[4] == &sequence[5]);
+
+  // stop drops everything
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[0], 0) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence[1], 0) == SL_STATUS_OK);
+  CHECK(buzzer_sequencer_tick(&seq, &top, &compare));
+  buzzer_sequencer_stop(&seq);
+  CHECK(!buzzer_sequencer_is_busy(&seq));
+  CHECK(!buzzer_sequencer_tick(&seq, &top, &compare));
+  CHECK(compare == 0);
+}
+
+// A loaded sequence plays the same every time
+static void test_replay(void)
+{
+  buzzer_note_t melody[] = {
+    { 1319, 120 }, { 1568, 80 }, { 0, 40 }, { 2093, 300 }, { 0, 0 },
+    { 1760, 90 }
+  };
+  buzzer_step_t steps[6], copy[6];
+  buzzer_sequence_t sequence = { steps, 6, 0, 0 };
+  buzzer_envelope_t envelope = BUZZER_ENVELOPE_DEFAULT;
+  buzzer_sequencer_t seq;
+  static period_t first[MAX_PERIODS];
+  unsigned n1, n2, changes;
+
+  CHECK(buzzer_sequence_load(&sequence, melody, 6, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_OK);
+  memcpy(copy, steps, sizeof(copy));
+
+  // a note of 0 ms is skipped
+  CHECK(steps[4].periods == 0);
+
+  buzzer_sequencer_init(&seq);
+  CHECK(buzzer_sequencer_queue(&seq, &sequence, 0) == SL_STATUS_OK);
+  n1 = run(&seq, &changes);
+  memcpy(first, trace, n1 * sizeof(period_t));
+
+  CHECK(buzzer_sequencer_queue(&seq, &sequence, 0) == SL_STATUS_OK);
+  n2 = run(&seq, &changes);
+
+  CHECK(n1 == n2);
+  CHECK(memcmp(first, trace, n1 * sizeof(period_t)) == 0);
+  CHECK(memcmp(copy, steps, sizeof(copy)) == 0);
+}
+
+// Load errors
+static void test_load(void)
+{
+  buzzer_note_t low[] = { { 10, 100 } };
+  buzzer_note_t ok[] = { { 2000, 100 }, { 3000, 100 } };
+  buzzer_step_t steps[1];
+  buzzer_sequence_t sequence = { steps, 1, 0, 0 };
+  buzzer_envelope_t envelope = BUZZER_ENVELOPE_NONE;
+
+  CHECK(buzzer_sequence_load(&sequence, low, 1, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_INVALID_RANGE);
+  CHECK(buzzer_sequence_load(&sequence, ok, 2, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_WOULD_OVERFLOW);
+  CHECK(buzzer_sequence_load(&sequence, ok, 1, NULL, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_NULL_POINTER);
+  CHECK(buzzer_sequence_load(&sequence, ok, 1, &envelope, VOLUME,
+                             TIMER_HZ, MAX_TOP) == SL_STATUS_OK);
+}
+
+int main(void)
+{
+  test_timeline();
+  test_envelope();
+  test_queue();
+  test_replay();
+  test_load();
+
+  printf(failed ? "FAILED\n" : "PASSED\n");
+
+  return failed;
+}
@@ -54,6 +54,21 @@
 extern "C" {
 #endif
 
+/// First I2C block of the user memory, holding the NDEF TLV
+#define NT3H2X11_USER_MEMORY_FIRST_BLOCK   (0x01)
+/// Last I2C block of the user memory, 0x37 for NT3H2111 and 0x77 for NT3H2211
+#ifndef NT3H2X11_USER_MEMORY_LAST_BLOCK
+#define NT3H2X11_USER_MEMORY_LAST_BLOCK    (0x37)
+#endif
+/// First I2C block of the SRAM used in pass-through mode
+#define NT3H2X11_SRAM_FIRST_BLOCK          (0xF8)
+/// SRAM size, data is passed through in chunks of this size
+#define NT3H2X11_SRAM_SIZE                 (64)
+/// Number of NS_REG polls while waiting for the EEPROM write cycle to end
+#ifndef NT3H2X11_EEPROM_BUSY_MAX_POLLS
+#define NT3H2X11_EEPROM_BUSY_MAX_POLLS     (100)
+#endif
+
 typedef struct {
   nt3h2x11_i2c_init_t i2c_init;
   nt3h2x11_fd_init_t  fd_init;
@@ -85,9 +100,44 @@ typedef enum {
 typedef enum {
   nt3h2x11_err_none               = 0,
   nt3h2x11_err_i2c_error          = 1,
-  nt3h2x11_err_invalid_reg_addr   = 2
+  nt3h2x11_err_invalid_reg_addr   = 2,
+  nt3h2x11_err_timeout            = 3,
+  nt3h2x11_err_eeprom_write       = 4,
+  nt3h2x11_err_no_ndef            = 5,
+  nt3h2x11_err_buffer_too_small   = 6,
+  nt3h2x11_err_busy               = 7,
+  nt3h2x11_err_no_data            = 8,
+  nt3h2x11_err_no_field           = 9
 } nt3h2x11_error_code_t;
 
+/// Pass-through transfer direction.
+typedef enum {
+  nt3h2x11_pthru_i2c_to_nfc       = 0,
+  nt3h2x11_pthru_nfc_to_i2c       = 1
+} nt3h2x11_pthru_dir_t;
+
+/**************************************************************************//**
+ * @brief
+ *  Pass-through data source, fills the next SRAM chunk (I2C to NFC).
+ *
+ * @param[out] data
+ *  Buffer of NT3H2X11_SRAM_SIZE bytes
+ *
+ * @returns
+ *  Number of bytes filled, 0 if there is no more data. A chunk shorter than
+ *  NT3H2X11_SRAM_SIZE is padded with zeros.
+ *****************************************************************************/
+typedef uint8_t (*nt3h2x11_pthru_source_t) (uint8_t* data);
+
+/**************************************************************************//**
+ * @brief
+ *  Pass-through data sink, consumes a received SRAM chunk (NFC to I2C).
+ *
+ * @param[in] data
+ *  Buffer of NT3H2X11_SRAM_SIZE bytes
+ *****************************************************************************/
+typedef void (*nt3h2x11_pthru_sink_t) (const uint8_t* data);
+
 /// NC_REG type. Details please refer to NT3H2111_2211 datasheet Table 13 and 14.
 typedef struct {
   bool    nfcs_i2c_rst_on_off;
@@ -209,6 +259,28 @@ nt3h2x11_i2c_clock_str_t nt3h2x11_i2c_decode_clock_str (uint8_t reg_value);
 
 nt3h2x11_reg_lock_t nt3h2x11_decode_reg_lock (uint8_t reg_value);
 
+nt3h2x11_i2c_ns_reg_t nt3h2x11_decode_ns_reg (uint8_t reg_value);
+
+nt3h2x11_error_code_t nt3h2x11_wait_eeprom_ready (void);
+
+nt3h2x11_error_code_t nt3h2x11_read_blocks (uint8_t mema, uint8_t count, uint8_t* data);
+
+nt3h2x11_error_code_t nt3h2x11_write_blocks (uint8_t mema, uint8_t count, const uint8_t* data);
+
+nt3h2x11_error_code_t nt3h2x11_ndef_read (uint8_t* message, uint16_t size, uint16_t* length);
+
+nt3h2x11_error_code_t nt3h2x11_ndef_write (const uint8_t* message, uint16_t length);
+
+nt3h2x11_error_code_t nt3h2x11_pthru_start (nt3h2x11_pthru_dir_t dir);
+
+nt3h2x11_error_code_t nt3h2x11_pthru_stop (void);
+
+nt3h2x11_error_code_t nt3h2x11_pthru_write_chunk (const uint8_t* data);
+
+nt3h2x11_error_code_t nt3h2x11_pthru_read_chunk (uint8_t* data);
+
+nt3h2x11_error_code_t nt3h2x11_pthru_pump (nt3h2x11_pthru_source_t source, nt3h2x11_pthru_sink_t sink, uint32_t* chunks);
+
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +57,8 @@ extern "C" {
 
 /// NT3H2x11 Default I2C address
 #define NT3H2X11_DEFAULT_I2C_ADDR          (0x55 << 1)
+/// NT3H2x11 memory block size
+#define NT3H2X11_BLOCK_SIZE                (16)
 
 typedef struct {
   bool                enable;
@@ -37,6 +37,7 @@
 ... */
 
 #include <stdint.h>
+#include <string.h>
 #include "em_cmu.h"
 #include "../inc/nt3h2x11.h"
 #include "../inc/nt3h2x11_i2c.h"
@@ -82,6 +83,29 @@
 #define TRANSFER_DIR_I2C_TO_NFC                             (0)
 #define TRANSFER_DIR_NFC_TO_I2C                             (1)
 
+#define NT3H2X11_NS_REG_EEPROM_WR_ERR_M                     (BIT2_MASK)
+
+#define NT3H2X11_NDEF_TLV_NULL                              (0x00)
+#define NT3H2X11_NDEF_TLV_MESSAGE                           (0x03)
+#define NT3H2X11_NDEF_TLV_TERMINATOR                        (0xFE)
+#define NT3H2X11_NDEF_TLV_LONG_LENGTH                       (0xFF)
+
+#define NT3H2X11_SRAM_BLOCKS                                (NT3H2X11_SRAM_SIZE / NT3H2X11_BLOCK_SIZE)
+#define NT3H2X11_USER_MEMORY_SIZE                           ((NT3H2X11_USER_MEMORY_LAST_BLOCK - NT3H2X11_USER_MEMORY_FIRST_BLOCK + 1) * NT3H2X11_BLOCK_SIZE)
+
+/// Block wise byte reader used to parse TLVs in user memory.
+typedef struct {
+  uint8_t block;
+  uint8_t pos;
+  uint8_t data[NT3H2X11_BLOCK_SIZE];
+} nt3h2x11_block_reader_t;
+
+/// Pass-through transfer direction set by nt3h2x11_pthru_start.
+static nt3h2x11_pthru_dir_t pthru_dir;
+/// Chunk got from the source but not yet accepted by SRAM.
+static uint8_t pthru_pending[NT3H2X11_SRAM_SIZE];
+static bool    pthru_pending_valid;
+
 extern void nt3h2x11_i2c_init (nt3h2x11_i2c_init_t i2c_init);
 
 extern i2c_transfer_return_t nt3h2x11_i2c_read (uint8_t mema, uint8_t* data);
@@ -92,6 +116,8 @@ extern i2c_transfer_return_t nt3h2x11_i2c_read_reg (uint8_t mema, uint8_t rega,
 
 extern i2c_transfer_return_t nt3h2x11_i2c_write_reg (uint8_t mema, uint8_t rega, uint8_t regdat);
 
+extern i2c_transfer_return_t nt3h2x11_i2c_write_reg_masked (uint8_t mema, uint8_t rega, uint8_t mask, uint8_t regdat);
+
 extern void nt3h2x11_fd_init (nt3h2x11_fd_init_t fd_init);
 
 /**************************************************************************//**
@@ -491,3 +517,558 @@ nt3h2x11_reg_lock_t nt3h2x11_decode_reg_lock (uint8_t reg_value) {
 
   return reg_lock;
 }
+
+/**************************************************************************//**
+ * @brief
+ *  Decode one byte of raw NS_REG data.
+ *
+ * @param[in] reg_value
+ *  Raw NS_REG data to be decoded
+ *
+ * @returns
+ *  Decoded NS_REG data
+ *
+ * @note
+ *  Details for NS_REG. Please refer to NT3H2111_2211 product data sheet
+ *  section 8.3.12.
+ *****************************************************************************/
+nt3h2x11_i2c_ns_reg_t nt3h2x11_decode_ns_reg (uint8_t reg_value) {
+
+  nt3h2x11_i2c_ns_reg_t ns_reg;
+
+  ns_reg.ndef_data_read   = (reg_value & BIT7_MASK) != 0;
+  ns_reg.i2c_locked       = (reg_value & BIT6_MASK) != 0;
+  ns_reg.rf_locked        = (reg_value & BIT5_MASK) != 0;
+  ns_reg.sram_i2c_ready   = (reg_value & BIT4_MASK) != 0;
+  ns_reg.sram_rf_ready    = (reg_value & BIT3_MASK) != 0;
+  ns_reg.eeprom_wr_err    = (reg_value & BIT2_MASK) != 0;
+  ns_reg.eeprom_wr_busy   = (reg_value & BIT1_MASK) != 0;
+  ns_reg.rf_firld_present = (reg_value & BIT0_MASK) != 0;
+
+  return ns_reg;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read and decode the NS_REG session register.
+ *
+ * @param[out] ns_reg
+ *  Decoded NS_REG data
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+static nt3h2x11_error_code_t nt3h2x11_read_ns_reg (nt3h2x11_i2c_ns_reg_t* ns_reg) {
+
+  nt3h2x11_reg_read_result_t result;
+
+  result = nt3h2x11_i2c_read_session_reg(session_reg_ns_reg);
+  if (result.err == nt3h2x11_err_none) {
+    *ns_reg = nt3h2x11_decode_ns_reg(result.reg_value);
+  }
+
+  return result.err;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Wait for the ongoing EEPROM write cycle to end.
+ *
+ * @returns
+ *  Any error code, nt3h2x11_err_eeprom_write if the write cycle failed.
+ *
+ * @note
+ *  NT3H2x11 may not acknowledge I2C while programming the EEPROM, failed
+ *  reads of NS_REG are counted as busy polls.
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_wait_eeprom_ready (void) {
+
+  nt3h2x11_i2c_ns_reg_t ns_reg;
+
+  for (uint32_t i = 0; i < NT3H2X11_EEPROM_BUSY_MAX_POLLS; i++) {
+
+    if (nt3h2x11_read_ns_reg(&ns_reg) != nt3h2x11_err_none) {
+      continue;
+    }
+
+    if (ns_reg.eeprom_wr_busy) {
+      continue;
+    }
+
+    if (ns_reg.eeprom_wr_err) {
+      /* Error flag has to be cleared by writing 0b. */
+      nt3h2x11_i2c_write_reg_masked(NT3H2X11_I2C_SESSION_REGS_MEM_ADDR, session_reg_ns_reg,
+                                    NT3H2X11_NS_REG_EEPROM_WR_ERR_M, 0);
+      return nt3h2x11_err_eeprom_write;
+    }
+
+    return nt3h2x11_err_none;
+  }
+
+  return nt3h2x11_err_timeout;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read consecutive memory blocks from NT3H2x11.
+ *
+ * @param[in] mema
+ *  Memory address of the first block
+ *
+ * @param[in] count
+ *  Number of blocks
+ *
+ * @param[out] data
+ *  Data buffer of count * NT3H2X11_BLOCK_SIZE bytes to hold the result
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_read_blocks (uint8_t mema, uint8_t count, uint8_t* data) {
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (nt3h2x11_i2c_read(mema + i, &data[i * NT3H2X11_BLOCK_SIZE]) != i2cTransferDone) {
+      return nt3h2x11_err_i2c_error;
+    }
+  }
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Write consecutive memory blocks to NT3H2x11. Blocks in EEPROM wait for
+ *  the write cycle to end before the next block is written.
+ *
+ * @param[in] mema
+ *  Memory address of the first block
+ *
+ * @param[in] count
+ *  Number of blocks
+ *
+ * @param[in] data
+ *  count * NT3H2X11_BLOCK_SIZE bytes to be written
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_write_blocks (uint8_t mema, uint8_t count, const uint8_t* data) {
+
+  uint8_t block[NT3H2X11_BLOCK_SIZE];
+  nt3h2x11_error_code_t err;
+
+  for (uint8_t i = 0; i < count; i++) {
+
+    memcpy(block, &data[i * NT3H2X11_BLOCK_SIZE], NT3H2X11_BLOCK_SIZE);
+    if (nt3h2x11_i2c_write(mema + i, block) != i2cTransferDone) {
+      return nt3h2x11_err_i2c_error;
+    }
+
+    /* SRAM writes do not start an EEPROM write cycle. */
+    if ((uint8_t)(mema + i) < NT3H2X11_SRAM_FIRST_BLOCK) {
+      err = nt3h2x11_wait_eeprom_ready();
+      if (err != nt3h2x11_err_none) {
+        return err;
+      }
+    }
+  }
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get the next byte of user memory, reading a new block when needed.
+ *****************************************************************************/
+static nt3h2x11_error_code_t nt3h2x11_block_reader_next (nt3h2x11_block_reader_t* reader, uint8_t* byte) {
+
+  if (reader->pos >= NT3H2X11_BLOCK_SIZE) {
+    if (reader->block >= NT3H2X11_USER_MEMORY_LAST_BLOCK) {
+      return nt3h2x11_err_no_ndef;
+    }
+    reader->block++;
+    reader->pos = 0;
+    if (nt3h2x11_i2c_read(reader->block, reader->data) != i2cTransferDone) {
+      return nt3h2x11_err_i2c_error;
+    }
+  }
+
+  *byte = reader->data[reader->pos++];
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read the NDEF message from user memory.
+ *
+ *  The NDEF message TLV is searched from the start of user memory, the
+ *  message is then read in whole blocks straight into the caller buffer.
+ *
+ * @param[out] message
+ *  Buffer to hold the NDEF message
+ *
+ * @param[in] size
+ *  Size of the buffer
+ *
+ * @param[out] length
+ *  Length of the NDEF message
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_ndef_read (uint8_t* message, uint16_t size, uint16_t* length) {
+
+  nt3h2x11_block_reader_t reader;
+  nt3h2x11_error_code_t err;
+  uint8_t tag, byte;
+  uint16_t tlv_length, copied, chunk;
+
+  reader.block = NT3H2X11_USER_MEMORY_FIRST_BLOCK - 1;
+  reader.pos = NT3H2X11_BLOCK_SIZE;
+
+  while (true) {
+
+    err = nt3h2x11_block_reader_next(&reader, &tag);
+    if (err != nt3h2x11_err_none) {
+      return err;
+    }
+
+    if (tag == NT3H2X11_NDEF_TLV_NULL) {
+      continue;
+    }
+    if (tag == NT3H2X11_NDEF_TLV_TERMINATOR) {
+      return nt3h2x11_err_no_ndef;
+    }
+
+    /* One byte length, or 0xFF followed by two bytes length. */
+    err = nt3h2x11_block_reader_next(&reader, &byte);
+    if (err != nt3h2x11_err_none) {
+      return err;
+    }
+    tlv_length = byte;
+    if (byte == NT3H2X11_NDEF_TLV_LONG_LENGTH) {
+      err = nt3h2x11_block_reader_next(&reader, &byte);
+      if (err != nt3h2x11_err_none) {
+        return err;
+      }
+      tlv_length = (uint16_t)byte << 8;
+      err = nt3h2x11_block_reader_next(&reader, &byte);
+      if (err != nt3h2x11_err_none) {
+        return err;
+      }
+      tlv_length |= byte;
+    }
+
+    if (tag == NT3H2X11_NDEF_TLV_MESSAGE) {
+      break;
+    }
+
+    /* Skip the value of any other TLV. */
+    for (uint16_t i = 0; i < tlv_length; i++) {
+      err = nt3h2x11_block_reader_next(&reader, &byte);
+      if (err != nt3h2x11_err_none) {
+        return err;
+      }
+    }
+  }
+
+  *length = tlv_length;
+  if (tlv_length > size) {
+    return nt3h2x11_err_buffer_too_small;
+  }
+
+  /* Rest of the current block. */
+  copied = NT3H2X11_BLOCK_SIZE - reader.pos;
+  if (copied > tlv_length) {
+    copied = tlv_length;
+  }
+  memcpy(message, &reader.data[reader.pos], copied);
+
+  /* Whole blocks straight into the caller buffer. */
+  while ((tlv_length - copied) >= NT3H2X11_BLOCK_SIZE) {
+    if (reader.block >= NT3H2X11_USER_MEMORY_LAST_BLOCK) {
+      return nt3h2x11_err_no_ndef;
+    }
+    reader.block++;
+    chunk = (tlv_length - copied) / NT3H2X11_BLOCK_SIZE;
+    if (chunk > (uint16_t)(NT3H2X11_USER_MEMORY_LAST_BLOCK - reader.block + 1)) {
+      chunk = NT3H2X11_USER_MEMORY_LAST_BLOCK - reader.block + 1;
+    }
+    err = nt3h2x11_read_blocks(reader.block, (uint8_t)chunk, &message[copied]);
+    if (err != nt3h2x11_err_none) {
+      return err;
+    }
+    reader.block += chunk - 1;
+    copied += chunk * NT3H2X11_BLOCK_SIZE;
+  }
+
+  /* Last partial block. */
+  if (copied < tlv_length) {
+    if (reader.block >= NT3H2X11_USER_MEMORY_LAST_BLOCK) {
+      return nt3h2x11_err_no_ndef;
+    }
+    reader.block++;
+    if (nt3h2x11_i2c_read(reader.block, reader.data) != i2cTransferDone) {
+      return nt3h2x11_err_i2c_error;
+    }
+    memcpy(&message[copied], reader.data, tlv_length - copied);
+  }
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Write an NDEF message to user memory.
+ *
+ *  The message is wrapped in an NDEF message TLV followed by a terminator
+ *  TLV and written block by block, waiting for each EEPROM write cycle.
+ *
+ * @param[in] message
+ *  NDEF message
+ *
+ * @param[in] length
+ *  Length of the NDEF message
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_ndef_write (const uint8_t* message, uint16_t length) {
+
+  uint8_t header[4];
+  uint8_t block[NT3H2X11_BLOCK_SIZE];
+  uint16_t header_length, total, offset, pos;
+  nt3h2x11_error_code_t err;
+
+  header[0] = NT3H2X11_NDEF_TLV_MESSAGE;
+  if (length < NT3H2X11_NDEF_TLV_LONG_LENGTH) {
+    header[1] = (uint8_t)length;
+    header_length = 2;
+  } else {
+    header[1] = NT3H2X11_NDEF_TLV_LONG_LENGTH;
+    header[2] = (uint8_t)(length >> 8);
+    header[3] = (uint8_t)length;
+    header_length = 4;
+  }
+
+  /* Header, message and terminator. */
+  total = header_length + length + 1;
+  if (total > NT3H2X11_USER_MEMORY_SIZE) {
+    return nt3h2x11_err_buffer_too_small;
+  }
+
+  for (offset = 0; offset < total; offset += NT3H2X11_BLOCK_SIZE) {
+
+    for (uint8_t i = 0; i < NT3H2X11_BLOCK_SIZE; i++) {
+      pos = offset + i;
+      if (pos < header_length) {
+        block[i] = header[pos];
+      } else if (pos < header_length + length) {
+        block[i] = message[pos - header_length];
+      } else if (pos == header_length + length) {
+        block[i] = NT3H2X11_NDEF_TLV_TERMINATOR;
+      } else {
+        block[i] = 0;
+      }
+    }
+
+    err = nt3h2x11_write_blocks(NT3H2X11_USER_MEMORY_FIRST_BLOCK + offset / NT3H2X11_BLOCK_SIZE, 1, block);
+    if (err != nt3h2x11_err_none) {
+      return err;
+    }
+  }
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Enable SRAM pass-through mode.
+ *
+ * @param[in] dir
+ *  Transfer direction
+ *
+ * @returns
+ *  Any error code, nt3h2x11_err_no_field if no NFC field is present.
+ *
+ * @note
+ *  NT3H2x11 leaves pass-through mode when the NFC field is switched off.
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_pthru_start (nt3h2x11_pthru_dir_t dir) {
+
+  nt3h2x11_i2c_ns_reg_t ns_reg;
+  nt3h2x11_error_code_t err;
+
+  err = nt3h2x11_read_ns_reg(&ns_reg);
+  if (err != nt3h2x11_err_none) {
+    return err;
+  }
+  if (!ns_reg.rf_firld_present) {
+    return nt3h2x11_err_no_field;
+  }
+
+  /* Direction may only be changed while pass-through is off. */
+  if (nt3h2x11_i2c_write_reg_masked(NT3H2X11_I2C_SESSION_REGS_MEM_ADDR, session_reg_nc_reg,
+                                    NT3H2X11_NC_REG_PTHRU_ON_OFF_M | NT3H2X11_NC_REG_TRANSFER_DIR_M,
+                                    (uint8_t)dir << NT3H2X11_NC_REG_TRANSFER_DIR_SHIFT) != i2cTransferDone) {
+    return nt3h2x11_err_i2c_error;
+  }
+  if (nt3h2x11_i2c_write_reg_masked(NT3H2X11_I2C_SESSION_REGS_MEM_ADDR, session_reg_nc_reg,
+                                    NT3H2X11_NC_REG_PTHRU_ON_OFF_M,
+                                    ON << NT3H2X11_NC_REG_PTHRU_ON_OFF_SHIFT) != i2cTransferDone) {
+    return nt3h2x11_err_i2c_error;
+  }
+
+  pthru_dir = dir;
+  pthru_pending_valid = false;
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Disable SRAM pass-through mode.
+ *
+ * @returns
+ *  Any error code
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_pthru_stop (void) {
+
+  pthru_pending_valid = false;
+
+  if (nt3h2x11_i2c_write_reg_masked(NT3H2X11_I2C_SESSION_REGS_MEM_ADDR, session_reg_nc_reg,
+                                    NT3H2X11_NC_REG_PTHRU_ON_OFF_M, OFF) != i2cTransferDone) {
+    return nt3h2x11_err_i2c_error;
+  }
+
+  return nt3h2x11_err_none;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Write one SRAM chunk to be read by the NFC reader (I2C to NFC).
+ *
+ * @param[in] data
+ *  NT3H2X11_SRAM_SIZE bytes to be written
+ *
+ * @returns
+ *  Any error code, nt3h2x11_err_busy if the previous chunk has not been read
+ *  by the NFC reader yet.
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_pthru_write_chunk (const uint8_t* data) {
+
+  nt3h2x11_i2c_ns_reg_t ns_reg;
+  nt3h2x11_error_code_t err;
+
+  err = nt3h2x11_read_ns_reg(&ns_reg);
+  if (err != nt3h2x11_err_none) {
+    return err;
+  }
+  if (!ns_reg.rf_firld_present) {
+    return nt3h2x11_err_no_field;
+  }
+  if (ns_reg.sram_rf_ready || ns_reg.rf_locked) {
+    return nt3h2x11_err_busy;
+  }
+
+  /* Writing the last SRAM block hands the SRAM over to NFC. */
+  return nt3h2x11_write_blocks(NT3H2X11_SRAM_FIRST_BLOCK, NT3H2X11_SRAM_BLOCKS, data);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Read one SRAM chunk written by the NFC reader (NFC to I2C).
+ *
+ * @param[out] data
+ *  Buffer of NT3H2X11_SRAM_SIZE bytes
+ *
+ * @returns
+ *  Any error code, nt3h2x11_err_no_data if the NFC reader has not written a
+ *  chunk yet.
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_pthru_read_chunk (uint8_t* data) {
+
+  nt3h2x11_i2c_ns_reg_t ns_reg;
+  nt3h2x11_error_code_t err;
+
+  err = nt3h2x11_read_ns_reg(&ns_reg);
+  if (err != nt3h2x11_err_none) {
+    return err;
+  }
+  if (!ns_reg.rf_firld_present) {
+    return nt3h2x11_err_no_field;
+  }
+  if (!ns_reg.sram_i2c_ready) {
+    return nt3h2x11_err_no_data;
+  }
+
+  /* Reading the last SRAM block hands the SRAM back to NFC. */
+  return nt3h2x11_read_blocks(NT3H2X11_SRAM_FIRST_BLOCK, NT3H2X11_SRAM_BLOCKS, data);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Move as many SRAM chunks as possible in the direction set by
+ *  nt3h2x11_pthru_start, without waiting for the NFC reader.
+ *
+ *  Call it from the main loop or after a field detection interrupt.
+ *
+ * @param[in] source
+ *  Data source used in I2C to NFC direction
+ *
+ * @param[in] sink
+ *  Data sink used in NFC to I2C direction
+ *
+ * @param[out] chunks
+ *  Number of chunks moved, may be NULL
+ *
+ * @returns
+ *  nt3h2x11_err_none if there is nothing more to move right now,
+ *  nt3h2x11_err_no_data once the source is exhausted, or any error code.
+ *****************************************************************************/
+nt3h2x11_error_code_t nt3h2x11_pthru_pump (nt3h2x11_pthru_source_t source, nt3h2x11_pthru_sink_t sink, uint32_t* chunks) {
+
+  uint8_t data[NT3H2X11_SRAM_SIZE];
+  nt3h2x11_error_code_t err;
+  uint32_t moved = 0;
+  uint8_t length;
+
+  while (true) {
+
+    if (pthru_dir == nt3h2x11_pthru_nfc_to_i2c) {
+      err = nt3h2x11_pthru_read_chunk(data);
+      if (err != nt3h2x11_err_none) {
+        break;
+      }
+      sink(data);
+    } else {
+      if (!pthru_pending_valid) {
+        memset(pthru_pending, 0, sizeof(pthru_pending));
+        length = source(pthru_pending);
+        if (length == 0) {
+          err = nt3h2x11_err_no_data;
+          break;
+        }
+        pthru_pending_valid = true;
+      }
+      err = nt3h2x11_pthru_write_chunk(pthru_pending);
+      if (err != nt3h2x11_err_none) {
+        break;
+      }
+      pthru_pending_valid = false;
+    }
+    moved++;
+  }
+
+  if (chunks != NULL) {
+    *chunks = moved;
+  }
+
+  /* Waiting for the NFC reader is not an error. */
+  if ((err == nt3h2x11_err_busy)
+      || ((err == nt3h2x11_err_no_data) && (pthru_dir == nt3h2x11_pthru_nfc_to_i2c))) {
+    return nt3h2x11_err_none;
+  }
+
+  return err;
+}
@@ -41,9 +41,6 @@
 #include "em_cmu.h"
 #include "../inc/nt3h2x11_i2c.h"
 
-/// NT3H2x11 memory block size
-#define NT3H2X11_BLOCK_SIZE                (16)
-
 static I2C_TypeDef *nt3h2x11_i2c_port;
 
 /**************************************************************************//**
@@ -259,7 +256,7 @@ i2c_transfer_return_t nt3h2x11_i2c_read_reg (uint8_t mema, uint8_t rega, uint8_t
   /* Assign mema. */
   buff[0] = mema;
   /* Assign rega. */
-  buff[0] = rega;
+  buff[1] = rega;
   /* Write addresses. */
   nt3h2x11_internal_i2c_write(NT3H2X11_DEFAULT_I2C_ADDR, 2, buff);
   /* Read regdat from NT3H2x11.  */
@@ -268,7 +265,7 @@ i2c_transfer_return_t nt3h2x11_i2c_read_reg (uint8_t mema, uint8_t rega, uint8_t
 
 /**************************************************************************//**
  * @brief
- *  Write data to a register in NT3H2x11.
+ *  Write selected bits of a register in NT3H2x11.
  *
  * @param[in] mema
  *  Memory address
@@ -276,6 +273,9 @@ i2c_transfer_return_t nt3h2x11_i2c_read_reg (uint8_t mema, uint8_t rega, uint8_t
  * @param[in] rega
  *  Register address
  *
+ * @param[in] mask
+ *  Bits of the register to be written
+ *
  * @param[in] regdat
  *  Data to be written to targeted register
  *
@@ -286,15 +286,42 @@ i2c_transfer_return_t nt3h2x11_i2c_read_reg (uint8_t mema, uint8_t rega, uint8_t
  *  Details for I2C WRITE register operation, please refer to NT3H2111_2211
  *  product data sheet section 9.8.
  *****************************************************************************/
-i2c_transfer_return_t nt3h2x11_i2c_write_reg (uint8_t mema, uint8_t rega, uint8_t regdat) {
-  /* Buffer to hold mema, rega and data. */
-  uint8_t buff[3];
+i2c_transfer_return_t nt3h2x11_i2c_write_reg_masked (uint8_t mema, uint8_t rega, uint8_t mask, uint8_t regdat) {
+  /* Buffer to hold mema, rega, mask and data. */
+  uint8_t buff[4];
   /* Assign mema. */
   buff[0] = mema;
   /* Assign rega. */
   buff[1] = rega;
+  /* Assign mask. */
+  buff[2] = mask;
   /* Assign regdat. */
-  buff[2] = regdat;
+  buff[3] = regdat;
   /* Write to NT3H2x11. */
-  return nt3h2x11_internal_i2c_write(NT3H2X11_DEFAULT_I2C_ADDR, 3, buff);
+  return nt3h2x11_internal_i2c_write(NT3H2X11_DEFAULT_I2C_ADDR, 4, buff);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Write data to a register in NT3H2x11.
+ *
+ * @param[in] mema
+ *  Memory address
+ *
+ * @param[in] rega
+ *  Register address
+ *
+ * @param[in] regdat
+ *  Data to be written to targeted register
+ *
+ * @returns
+ *  I2C transfer status.
+ *
+ * @note
+ *  Details for I2C WRITE register operation, please refer to NT3H2111_2211
+ *  product data sheet section 9.8.
+ *****************************************************************************/
+i2c_transfer_return_t nt3h2x11_i2c_write_reg (uint8_t mema, uint8_t rega, uint8_t regdat) {
+  /* Write all bits of the register. */
+  return nt3h2x11_i2c_write_reg_masked(mema, rega, 0xFF, regdat);
 }
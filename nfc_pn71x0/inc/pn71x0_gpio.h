@@ -47,6 +47,8 @@
 
 #define __PN71X0_GPIO_H__
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "em_gpio.h"
 
 #ifdef __cplusplus
@@ -60,6 +62,8 @@ typedef struct {
   uint8_t             irq_pin;
 } pn71x0_gpio_init_t;
 
+bool pn71x0_gpio_irq_asserted(void);
+
 #ifdef __cplusplus
 }
 #endif
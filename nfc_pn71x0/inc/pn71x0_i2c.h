@@ -55,6 +55,30 @@
 extern "C" {
 #endif
 
+/// Enable NCI packet logging, set to 0 to compile the logger out
+#ifndef PN71X0_NCI_LOG_ENABLE
+#define PN71X0_NCI_LOG_ENABLE           (1)
+#endif
+
+/// Number of packet buffers in the pool, has to be a power of 2
+#ifndef PN71X0_NCI_PACKET_POOL_SIZE
+#define PN71X0_NCI_PACKET_POOL_SIZE     (4)
+#endif
+
+/// Time to wait for a packet in interrupt mode before giving up, in ms
+#ifndef PN71X0_NCI_RECEIVE_TIMEOUT_MS
+#define PN71X0_NCI_RECEIVE_TIMEOUT_MS   (1000)
+#endif
+
+/// NCI packet header size
+#define PN71X0_NCI_HEADER_SIZE          (3)
+/// NCI maximum packet size, header plus 255 bytes payload
+#define PN71X0_NCI_MAX_PACKET_SIZE      (PN71X0_NCI_HEADER_SIZE + 255)
+/// Number of NCI logical connections
+#define PN71X0_NCI_MAX_CONNECTIONS      (16)
+/// Credit value meaning flow control is not used on a connection
+#define PN71X0_NCI_CREDITS_UNLIMITED    (0xFF)
+
 typedef struct {
   I2C_TypeDef        *i2c_port;
   GPIO_Port_TypeDef   scl_port;
@@ -71,6 +95,28 @@ typedef I2C_TransferReturn_TypeDef i2c_transfer_return_t;
 
 void pn71x0_i2c_init (pn71x0_i2c_init_t i2c_init);
 
+void pn71x0_i2c_irq_mode_start (void);
+
+void pn71x0_i2c_irq_mode_stop (void);
+
+void pn71x0_i2c_irq_pin_handler (void);
+
+void pn71x0_i2c_irq_handler (void);
+
+uint8_t* pn71x0_nci_receive_get (void);
+
+uint8_t* pn71x0_nci_packet_alloc (void);
+
+void pn71x0_nci_packet_release (uint8_t* packet);
+
+bool pn71x0_nci_send_enqueue (uint8_t* packet);
+
+uint32_t pn71x0_nci_send_process (void);
+
+void pn71x0_nci_set_credits (uint8_t conn_id, uint8_t credits);
+
+uint8_t pn71x0_nci_get_credits (uint8_t conn_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,8 @@
 
 static GPIO_Port_TypeDef   ven_port;
 static uint8_t             ven_pin;
+static GPIO_Port_TypeDef   irq_port;
+static uint8_t             irq_pin;
 
 /**************************************************************************//**
  * @brief
@@ -72,6 +74,20 @@ void pn71x0_gpio_init (pn71x0_gpio_init_t gpio_init) {
     /* Store VEN ports and pins for reset use. */
     ven_port = gpio_init.ven_port;
     ven_pin  = gpio_init.ven_pin;
+    /* Store IRQ ports and pins for the interrupt driven receive path. */
+    irq_port = gpio_init.irq_port;
+    irq_pin  = gpio_init.irq_pin;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Check the PN71x0 IRQ pin.
+ *
+ * @returns
+ *  True if PN71x0 has a packet pending to be read.
+ *****************************************************************************/
+bool pn71x0_gpio_irq_asserted(void) {
+    return GPIO_PinInGet(irq_port, irq_pin) != 0;
 }
 
 /**************************************************************************//**
@@ -37,10 +37,14 @@
 ... */
 
 #include <stdint.h>
+#include <string.h>
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_i2c.h"
 #include "em_gpio.h"
+#include "sl_sleeptimer.h"
 #include "../inc/pn71x0_i2c.h"
+#include "../inc/pn71x0_gpio.h"
 #include "nci.h"
 #include "nci_tml.h"
 
@@ -53,6 +57,64 @@
 /// I2C port to be used
 static I2C_TypeDef *pn71x0_i2c_port;
 
+#if (PN71X0_NCI_LOG_ENABLE)
+#define PN71X0_NCI_LOG_PACKET(title, packet)                   \
+  do {                                                         \
+    nci_tml_log(title);                                        \
+    nci_tml_packet_log(packet, (packet)[2] + PN71X0_NCI_HEADER_SIZE); \
+    nci_tml_log_ln(" ");                                       \
+  } while (0)
+#else
+#define PN71X0_NCI_LOG_PACKET(title, packet)   do { } while (0)
+#endif
+
+/// Index mask of the packet queues
+#define PN71X0_NCI_QUEUE_MASK           (PN71X0_NCI_PACKET_POOL_SIZE - 1)
+
+#if (PN71X0_NCI_PACKET_POOL_SIZE & PN71X0_NCI_QUEUE_MASK) != 0
+#error "PN71X0_NCI_PACKET_POOL_SIZE has to be a power of 2"
+#endif
+
+/// NCI message types
+#define PN71X0_NCI_MT_DATA              (0x00)
+#define PN71X0_NCI_MT_NTF               (0x03)
+/// Notifications carrying connection credits
+#define PN71X0_NCI_GID_CORE             (0x00)
+#define PN71X0_NCI_OID_CONN_CREDITS     (0x06)
+#define PN71X0_NCI_GID_RF               (0x01)
+#define PN71X0_NCI_OID_INTF_ACTIVATED   (0x05)
+
+/// Interrupt driven receive states
+typedef enum {
+  pn71x0_rx_idle,
+  pn71x0_rx_header,
+  pn71x0_rx_payload,
+  pn71x0_rx_tx_lock
+} pn71x0_rx_state_t;
+
+/// Fixed size packet queue holding pool buffer indices
+typedef struct {
+  uint8_t          index[PN71X0_NCI_PACKET_POOL_SIZE];
+  volatile uint8_t head;
+  volatile uint8_t tail;
+} pn71x0_nci_queue_t;
+
+/// Packet buffer pool
+static uint8_t nci_pool[PN71X0_NCI_PACKET_POOL_SIZE][PN71X0_NCI_MAX_PACKET_SIZE];
+/// Buffers not in use
+static pn71x0_nci_queue_t nci_free_queue;
+/// Received packets, filled from interrupt context
+static pn71x0_nci_queue_t nci_ready_queue;
+/// Packets waiting to be sent
+static pn71x0_nci_queue_t nci_send_queue;
+/// Credits available per logical connection
+static volatile uint8_t nci_credits[PN71X0_NCI_MAX_CONNECTIONS];
+
+static bool nci_irq_mode;
+static volatile pn71x0_rx_state_t nci_rx_state;
+static I2C_TransferSeq_TypeDef nci_rx_seq;
+static uint8_t nci_rx_index;
+
 /**************************************************************************//**
  * @brief
  *  I2C initialization for PN71x0 communication.
@@ -186,10 +248,517 @@ static i2c_transfer_return_t pn71x0_i2c_write (uint8_t address, uint32_t size, u
   return result;
 }
 
+/**************************************************************************//**
+ * @brief
+ *  Get the NVIC interrupt number of the I2C port in use.
+ *****************************************************************************/
+static IRQn_Type pn71x0_i2c_irqn (void) {
+
+#if defined(I2C1)
+  if (pn71x0_i2c_port == I2C1) {
+      return I2C1_IRQn;
+  }
+#endif
+#if defined(I2C2)
+  if (pn71x0_i2c_port == I2C2) {
+      return I2C2_IRQn;
+  }
+#endif
+  return I2C0_IRQn;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Number of entries in a packet queue.
+ *****************************************************************************/
+static uint8_t pn71x0_nci_queue_count (const pn71x0_nci_queue_t* queue) {
+  return (uint8_t)(queue->head - queue->tail);
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Add a buffer index to a packet queue. The queue can never overflow as it
+ *  is as large as the pool.
+ *****************************************************************************/
+static void pn71x0_nci_queue_push (pn71x0_nci_queue_t* queue, uint8_t index) {
+  queue->index[queue->head & PN71X0_NCI_QUEUE_MASK] = index;
+  queue->head++;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Take the oldest buffer index from a packet queue.
+ *
+ * @returns
+ *  Buffer index, PN71X0_NCI_PACKET_POOL_SIZE if the queue is empty.
+ *****************************************************************************/
+static uint8_t pn71x0_nci_queue_pop (pn71x0_nci_queue_t* queue) {
+
+  uint8_t index;
+
+  if (pn71x0_nci_queue_count(queue) == 0) {
+      return PN71X0_NCI_PACKET_POOL_SIZE;
+  }
+  index = queue->index[queue->tail & PN71X0_NCI_QUEUE_MASK];
+  queue->tail++;
+
+  return index;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Take a buffer from the free queue, the free queue is shared between
+ *  thread and interrupt context.
+ *****************************************************************************/
+static uint8_t pn71x0_nci_free_pop (void) {
+
+  uint8_t index;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_CRITICAL();
+  index = pn71x0_nci_queue_pop(&nci_free_queue);
+  CORE_EXIT_CRITICAL();
+
+  return index;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get the pool index of a packet buffer.
+ *
+ * @returns
+ *  Buffer index, PN71X0_NCI_PACKET_POOL_SIZE if not a pool buffer.
+ *****************************************************************************/
+static uint8_t pn71x0_nci_packet_index (const uint8_t* packet) {
+
+  for (uint8_t i = 0; i < PN71X0_NCI_PACKET_POOL_SIZE; i++) {
+      if (packet == nci_pool[i]) {
+          return i;
+      }
+  }
+  return PN71X0_NCI_PACKET_POOL_SIZE;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Update connection credits from received notifications.
+ *
+ * @param[in] packet
+ *  Received packet.
+ *****************************************************************************/
+static void pn71x0_nci_update_credits (const uint8_t* packet) {
+
+  uint8_t mt  = packet[0] >> 5;
+  uint8_t gid = packet[0] & 0x0F;
+  uint8_t oid = packet[1] & 0x3F;
+  uint8_t len = packet[2];
+  const uint8_t* payload = &packet[PN71X0_NCI_HEADER_SIZE];
+
+  if (mt != PN71X0_NCI_MT_NTF) {
+      return;
+  }
+
+  if ((gid == PN71X0_NCI_GID_CORE) && (oid == PN71X0_NCI_OID_CONN_CREDITS)) {
+      /* Number of entries followed by (Conn ID, Credits) pairs. */
+      for (uint8_t i = 0; (i < payload[0]) && (2 + 2 * i < len); i++) {
+          uint8_t conn_id = payload[1 + 2 * i] & 0x0F;
+          uint8_t credits = payload[2 + 2 * i];
+
+          if (nci_credits[conn_id] != PN71X0_NCI_CREDITS_UNLIMITED) {
+              credits += nci_credits[conn_id];
+          }
+          nci_credits[conn_id] = credits;
+      }
+  } else if ((gid == PN71X0_NCI_GID_RF) && (oid == PN71X0_NCI_OID_INTF_ACTIVATED)
+             && (len > 5)) {
+      /* Initial number of credits of the static RF connection. */
+      nci_credits[0] = payload[5];
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Start reading a packet into a free pool buffer, called when the IRQ pin
+ *  is asserted and no transfer is ongoing.
+ *****************************************************************************/
+static void pn71x0_nci_rx_start (void) {
+
+  I2C_TransferReturn_TypeDef ret;
+
+  nci_rx_index = pn71x0_nci_free_pop();
+  if (nci_rx_index >= PN71X0_NCI_PACKET_POOL_SIZE) {
+      /* No buffer, the packet stays in PN71x0 until one is released. */
+      nci_rx_state = pn71x0_rx_idle;
+      return;
+  }
+
+  nci_rx_seq.addr        = PN71X0_I2C_ADDR;
+  nci_rx_seq.flags       = I2C_FLAG_READ;
+  nci_rx_seq.buf[0].data = nci_pool[nci_rx_index];
+  nci_rx_seq.buf[0].len  = PN71X0_NCI_HEADER_SIZE;
+  nci_rx_state = pn71x0_rx_header;
+
+  ret = I2C_TransferInit(pn71x0_i2c_port, &nci_rx_seq);
+  if (ret != i2cTransferInProgress) {
+      pn71x0_nci_queue_push(&nci_free_queue, nci_rx_index);
+      nci_rx_state = pn71x0_rx_idle;
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Lock the I2C port for a blocking transfer from thread context.
+ *****************************************************************************/
+static void pn71x0_nci_tx_lock (void) {
+
+  CORE_DECLARE_IRQ_STATE;
+
+  if (!nci_irq_mode) {
+      return;
+  }
+
+  while (true) {
+      CORE_ENTER_CRITICAL();
+      if (nci_rx_state == pn71x0_rx_idle) {
+          nci_rx_state = pn71x0_rx_tx_lock;
+          CORE_EXIT_CRITICAL();
+          break;
+      }
+      CORE_EXIT_CRITICAL();
+  }
+  NVIC_DisableIRQ(pn71x0_i2c_irqn());
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Unlock the I2C port and pick up any packet signaled in the meantime.
+ *****************************************************************************/
+static void pn71x0_nci_tx_unlock (void) {
+
+  CORE_DECLARE_IRQ_STATE;
+
+  if (!nci_irq_mode) {
+      return;
+  }
+
+  NVIC_ClearPendingIRQ(pn71x0_i2c_irqn());
+  NVIC_EnableIRQ(pn71x0_i2c_irqn());
+
+  CORE_ENTER_CRITICAL();
+  nci_rx_state = pn71x0_rx_idle;
+  if (pn71x0_gpio_irq_asserted()) {
+      pn71x0_nci_rx_start();
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Write one packet with retries.
+ *
+ * @param[in] packet
+ *  Packet to be written.
+ *
+ * @returns
+ *  I2C transfer result code.
+ *****************************************************************************/
+static i2c_transfer_return_t pn71x0_nci_write_packet (uint8_t* packet) {
+
+  i2c_transfer_return_t i2c_ret = i2cTransferNack;
+
+  pn71x0_nci_tx_lock();
+  for (int i = 0; i < PN71X0_I2C_MAX_RETRIES; i++) {
+
+      i2c_ret = pn71x0_i2c_write(PN71X0_I2C_ADDR, packet[2] + PN71X0_NCI_HEADER_SIZE, packet);
+
+      if (i2c_ret == i2cTransferDone) {
+          break;
+      }
+  }
+  pn71x0_nci_tx_unlock();
+
+  return i2c_ret;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Start the interrupt driven receive path. Received packets are read into
+ *  the packet pool as soon as PN71x0 asserts its IRQ pin.
+ *
+ *  The application has to call pn71x0_i2c_irq_pin_handler from the GPIO
+ *  interrupt of the IRQ pin and pn71x0_i2c_irq_handler from the interrupt
+ *  handler of the I2C port.
+ *****************************************************************************/
+void pn71x0_i2c_irq_mode_start (void) {
+
+  CORE_DECLARE_IRQ_STATE;
+
+  nci_free_queue.head  = 0;
+  nci_free_queue.tail  = 0;
+  nci_ready_queue.head = 0;
+  nci_ready_queue.tail = 0;
+  nci_send_queue.head  = 0;
+  nci_send_queue.tail  = 0;
+  for (uint8_t i = 0; i < PN71X0_NCI_PACKET_POOL_SIZE; i++) {
+      pn71x0_nci_queue_push(&nci_free_queue, i);
+  }
+  memset((void *)nci_credits, PN71X0_NCI_CREDITS_UNLIMITED, sizeof(nci_credits));
+
+  nci_rx_state = pn71x0_rx_idle;
+  nci_irq_mode = true;
+
+  NVIC_ClearPendingIRQ(pn71x0_i2c_irqn());
+  NVIC_EnableIRQ(pn71x0_i2c_irqn());
+
+  /* A packet may already be pending, the edge would be lost otherwise. */
+  CORE_ENTER_CRITICAL();
+  if (pn71x0_gpio_irq_asserted()) {
+      pn71x0_nci_rx_start();
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Stop the interrupt driven receive path and return to blocking reads.
+ *****************************************************************************/
+void pn71x0_i2c_irq_mode_stop (void) {
+
+  pn71x0_nci_tx_lock();
+  nci_irq_mode = false;
+  nci_rx_state = pn71x0_rx_idle;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  PN71x0 IRQ pin handler, has to be called from the GPIO interrupt.
+ *****************************************************************************/
+void pn71x0_i2c_irq_pin_handler (void) {
+
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_CRITICAL();
+  if (nci_irq_mode && (nci_rx_state == pn71x0_rx_idle)) {
+      pn71x0_nci_rx_start();
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * @brief
+ *  I2C interrupt handler, has to be called from the interrupt handler of
+ *  the I2C port in use.
+ *****************************************************************************/
+void pn71x0_i2c_irq_handler (void) {
+
+  I2C_TransferReturn_TypeDef ret;
+  uint8_t* packet;
+
+  if ((nci_rx_state != pn71x0_rx_header) && (nci_rx_state != pn71x0_rx_payload)) {
+      return;
+  }
+
+  ret = I2C_Transfer(pn71x0_i2c_port);
+  if (ret == i2cTransferInProgress) {
+      return;
+  }
+
+  packet = nci_pool[nci_rx_index];
+
+  if (ret != i2cTransferDone) {
+      /* Drop the packet, PN71x0 keeps IRQ asserted so it is read again. */
+      pn71x0_nci_queue_push(&nci_free_queue, nci_rx_index);
+  } else if ((nci_rx_state == pn71x0_rx_header) && (packet[2] != 0)) {
+      nci_rx_seq.buf[0].data = &packet[PN71X0_NCI_HEADER_SIZE];
+      nci_rx_seq.buf[0].len  = packet[2];
+      nci_rx_state = pn71x0_rx_payload;
+      if (I2C_TransferInit(pn71x0_i2c_port, &nci_rx_seq) == i2cTransferInProgress) {
+          return;
+      }
+      pn71x0_nci_queue_push(&nci_free_queue, nci_rx_index);
+  } else {
+      pn71x0_nci_update_credits(packet);
+      pn71x0_nci_queue_push(&nci_ready_queue, nci_rx_index);
+  }
+
+  nci_rx_state = pn71x0_rx_idle;
+  if (pn71x0_gpio_irq_asserted()) {
+      pn71x0_nci_rx_start();
+  }
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get the oldest received packet without copying it. The packet has to be
+ *  returned with pn71x0_nci_packet_release once processed.
+ *
+ * @returns
+ *  Received packet, NULL if no packet is ready.
+ *****************************************************************************/
+uint8_t* pn71x0_nci_receive_get (void) {
+
+  uint8_t index = pn71x0_nci_queue_pop(&nci_ready_queue);
+
+  if (index >= PN71X0_NCI_PACKET_POOL_SIZE) {
+      return NULL;
+  }
+
+  PN71X0_NCI_LOG_PACKET("NCI TML receive:    ", nci_pool[index]);
+
+  return nci_pool[index];
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get a free packet buffer to be filled and queued for sending.
+ *
+ * @returns
+ *  Packet buffer of PN71X0_NCI_MAX_PACKET_SIZE bytes, NULL if the pool is
+ *  exhausted.
+ *****************************************************************************/
+uint8_t* pn71x0_nci_packet_alloc (void) {
+
+  uint8_t index = pn71x0_nci_free_pop();
+
+  if (index >= PN71X0_NCI_PACKET_POOL_SIZE) {
+      return NULL;
+  }
+  return nci_pool[index];
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Return a packet buffer to the pool.
+ *
+ * @param[in] packet
+ *  Buffer got from pn71x0_nci_receive_get or pn71x0_nci_packet_alloc.
+ *****************************************************************************/
+void pn71x0_nci_packet_release (uint8_t* packet) {
+
+  uint8_t index = pn71x0_nci_packet_index(packet);
+  CORE_DECLARE_IRQ_STATE;
+
+  if (index >= PN71X0_NCI_PACKET_POOL_SIZE) {
+      return;
+  }
+
+  CORE_ENTER_CRITICAL();
+  pn71x0_nci_queue_push(&nci_free_queue, index);
+  /* Reading may have stalled on an empty pool. */
+  if (nci_irq_mode && (nci_rx_state == pn71x0_rx_idle)
+      && pn71x0_gpio_irq_asserted()) {
+      pn71x0_nci_rx_start();
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Queue a pool packet for sending. Ownership of the buffer moves to the
+ *  driver, it is released once the packet is sent.
+ *
+ * @param[in] packet
+ *  Buffer got from pn71x0_nci_packet_alloc.
+ *
+ * @returns
+ *  True if the packet was queued.
+ *****************************************************************************/
+bool pn71x0_nci_send_enqueue (uint8_t* packet) {
+
+  uint8_t index = pn71x0_nci_packet_index(packet);
+
+  if (index >= PN71X0_NCI_PACKET_POOL_SIZE) {
+      return false;
+  }
+
+  pn71x0_nci_queue_push(&nci_send_queue, index);
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Send queued packets in order. Data packets are only sent while their
+ *  connection has credits left, the queue stalls on the first packet that
+ *  has to wait so packet order is kept.
+ *
+ * @returns
+ *  Number of packets sent.
+ *****************************************************************************/
+uint32_t pn71x0_nci_send_process (void) {
+
+  uint32_t sent = 0;
+  uint8_t* packet;
+  uint8_t conn_id;
+  CORE_DECLARE_IRQ_STATE;
+
+  while (pn71x0_nci_queue_count(&nci_send_queue) != 0) {
+
+      packet = nci_pool[nci_send_queue.index[nci_send_queue.tail & PN71X0_NCI_QUEUE_MASK]];
+      conn_id = packet[0] & 0x0F;
+
+      if (((packet[0] >> 5) == PN71X0_NCI_MT_DATA)
+          && (nci_credits[conn_id] == 0)) {
+          break;
+      }
+
+      if (pn71x0_nci_write_packet(packet) != i2cTransferDone) {
+          break;
+      }
+
+      /* Only a packet which went out uses a credit. */
+      if ((packet[0] >> 5) == PN71X0_NCI_MT_DATA) {
+          CORE_ENTER_CRITICAL();
+          if ((nci_credits[conn_id] != 0)
+              && (nci_credits[conn_id] != PN71X0_NCI_CREDITS_UNLIMITED)) {
+              nci_credits[conn_id]--;
+          }
+          CORE_EXIT_CRITICAL();
+      }
+      PN71X0_NCI_LOG_PACKET("NCI TML transceive: ", packet);
+
+      pn71x0_nci_queue_pop(&nci_send_queue);
+      pn71x0_nci_packet_release(packet);
+      sent++;
+  }
+
+  return sent;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Set the credits of a logical connection.
+ *
+ * @param[in] conn_id
+ *  Logical connection identifier.
+ *
+ * @param[in] credits
+ *  Number of credits, PN71X0_NCI_CREDITS_UNLIMITED to disable flow control.
+ *****************************************************************************/
+void pn71x0_nci_set_credits (uint8_t conn_id, uint8_t credits) {
+  nci_credits[conn_id & 0x0F] = credits;
+}
+
+/**************************************************************************//**
+ * @brief
+ *  Get the credits left on a logical connection.
+ *
+ * @param[in] conn_id
+ *  Logical connection identifier.
+ *
+ * @returns
+ *  Number of credits, PN71X0_NCI_CREDITS_UNLIMITED if flow control is off.
+ *****************************************************************************/
+uint8_t pn71x0_nci_get_credits (uint8_t conn_id) {
+  return nci_credits[conn_id & 0x0F];
+}
+
 /**************************************************************************//**
  * @brief
  *  NCI TML receive function wrapper for PN71x0 I2C.
  *
+ *  In interrupt mode the packet is taken from the ready queue, otherwise it
+ *  is read with blocking I2C transfers.
+ *
  * @param[out] packet
  *  Packet buffer to hold the received packet.
  *
@@ -199,10 +768,27 @@ static i2c_transfer_return_t pn71x0_i2c_write (uint8_t address, uint32_t size, u
 nci_tml_err_t nci_tml_receive (uint8_t* packet) {
 
   i2c_transfer_return_t i2c_ret;
+  uint8_t* ready;
+  uint32_t start;
+  uint32_t timeout;
+
+  if (nci_irq_mode) {
+      start = sl_sleeptimer_get_tick_count();
+      timeout = sl_sleeptimer_ms_to_tick(PN71X0_NCI_RECEIVE_TIMEOUT_MS);
+      while ((ready = pn71x0_nci_receive_get()) == NULL) {
+          /* Wait for the interrupt driven read to complete. */
+          if ((sl_sleeptimer_get_tick_count() - start) >= timeout) {
+              return nci_tml_err_comm_bus;
+          }
+      }
+      memcpy(packet, ready, ready[2] + PN71X0_NCI_HEADER_SIZE);
+      pn71x0_nci_packet_release(ready);
+      return nci_tml_err_none;
+  }
 
   for (int i = 0; i < PN71X0_I2C_MAX_RETRIES; i++) {
 
-      i2c_ret = pn71x0_i2c_read(PN71X0_I2C_ADDR, 3, packet);
+      i2c_ret = pn71x0_i2c_read(PN71X0_I2C_ADDR, PN71X0_NCI_HEADER_SIZE, packet);
 
       if (i2c_ret == i2cTransferDone) {
           break;
@@ -216,7 +802,7 @@ nci_tml_err_t nci_tml_receive (uint8_t* packet) {
   if (packet[2] != 0) {
       for (int i = 0; i < PN71X0_I2C_MAX_RETRIES; i++) {
           /* . */
-          i2c_ret = pn71x0_i2c_read(PN71X0_I2C_ADDR, packet[2], &packet[3]);
+          i2c_ret = pn71x0_i2c_read(PN71X0_I2C_ADDR, packet[2], &packet[PN71X0_NCI_HEADER_SIZE]);
 
           if (i2c_ret == i2cTransferDone) {
               break;
@@ -228,9 +814,7 @@ nci_tml_err_t nci_tml_receive (uint8_t* packet) {
       }
   }
 
-  nci_tml_log("NCI TML receive:    ");
-  nci_tml_packet_log(packet, packet[2] + 3);
-  nci_tml_log_ln(" ");
+  PN71X0_NCI_LOG_PACKET("NCI TML receive:    ", packet);
 
   return nci_tml_err_none;
 }
@@ -247,24 +831,11 @@ nci_tml_err_t nci_tml_receive (uint8_t* packet) {
  *****************************************************************************/
 nci_tml_err_t nci_tml_transceive (uint8_t* packet) {
 
-  i2c_transfer_return_t i2c_ret;
-
-  for (int i = 0; i < PN71X0_I2C_MAX_RETRIES; i++) {
-
-      i2c_ret = pn71x0_i2c_write(PN71X0_I2C_ADDR, packet[2] + 3, packet);
-
-      if (i2c_ret == i2cTransferDone) {
-          break;
-      }
-  }
-
-  if( i2c_ret != i2cTransferDone) {
+  if (pn71x0_nci_write_packet(packet) != i2cTransferDone) {
       return nci_tml_err_comm_bus;
   }
 
-  nci_tml_log("NCI TML transceive: ");
-  nci_tml_packet_log(packet, packet[2] + 3);
-  nci_tml_log_ln(" ");
+  PN71X0_NCI_LOG_PACKET("NCI TML transceive: ", packet);
 
   return nci_tml_err_none;
 }
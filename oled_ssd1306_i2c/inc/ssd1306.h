@@ -127,6 +127,41 @@ sl_status_t ssd1306_init(void);
  *****************************************************************************/
 sl_status_t ssd1306_draw(const void *data);
 
+/**************************************************************************//**
+ * @brief
+ *   Draw a window of a frame buffer to SSD1306.
+ *
+ * @details
+ *   The column and page window is set with one command, then the pixels are
+ *   sent in one data transfer if the window spans the width of the display,
+ *   or in one transfer per page otherwise.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer of the whole display, as for
+ *   ssd1306_draw(). Only the bytes inside the window are sent.
+ *
+ * @param[in] x
+ *   First column of the window
+ *
+ * @param[in] page
+ *   First page of the window
+ *
+ * @param[in] width
+ *   Number of columns in the window
+ *
+ * @param[in] pages
+ *   Number of pages in the window
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors, SL_STATUS_INVALID_PARAMETER if the
+ *   window is outside the display.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_window(const void *data,
+                                uint8_t x,
+                                uint8_t page,
+                                uint8_t width,
+                                uint8_t pages);
+
 /**************************************************************************//**
  * @brief
  *   Get a handle to SSD1306.
@@ -40,4 +40,7 @@
 #define SSD1306_DISPLAY_WIDTH           64
 #define SSD1306_DISPLAY_HEIGHT          48
 
+/* First column of the display in the SSD1306 RAM */
+#define SSD1306_COLUMN_OFFSET           32
+
 #endif
@@ -59,6 +59,78 @@ static const ssd1306_t *oled = NULL;
 /* Dimensions of the display */
 static glib_display_geometry_t dimensions;
 
+/* Number of 8 pixel rows (pages) of the display */
+#define GLIB_PAGES              (SSD1306_DISPLAY_HEIGHT / 8)
+
+/* Window of the glib_frame_buffer changed since the last update, in columns
+ * and pages, bounds included. */
+static bool dirty = false;
+static uint8_t dirty_x_min;
+static uint8_t dirty_x_max;
+static uint8_t dirty_page_min;
+static uint8_t dirty_page_max;
+
+/* Pages moved by the last hardware scroll, the display RAM no longer
+ * matches the glib_frame_buffer there until the scroll is stopped. */
+static uint8_t scroll_page_min;
+static uint8_t scroll_page_max;
+static bool scroll_active = false;
+
+/**************************************************************************//**
+ * Add a window to the part of the display to update.
+ *****************************************************************************/
+static void glib_mark_dirty(uint8_t x_min, uint8_t x_max,
+                            uint8_t page_min, uint8_t page_max)
+{
+  if (!dirty) {
+    dirty_x_min = x_min;
+    dirty_x_max = x_max;
+    dirty_page_min = page_min;
+    dirty_page_max = page_max;
+    dirty = true;
+    return;
+  }
+
+  if (x_min < dirty_x_min) {
+    dirty_x_min = x_min;
+  }
+  if (x_max > dirty_x_max) {
+    dirty_x_max = x_max;
+  }
+  if (page_min < dirty_page_min) {
+    dirty_page_min = page_min;
+  }
+  if (page_max > dirty_page_max) {
+    dirty_page_max = page_max;
+  }
+}
+
+/**************************************************************************//**
+ * Record the pages moved by a hardware scroll.
+ *****************************************************************************/
+static void glib_scroll_started(uint8_t start_page_addr, uint8_t end_page_addr)
+{
+  if (start_page_addr >= GLIB_PAGES) {
+    return;
+  }
+  if (end_page_addr >= GLIB_PAGES) {
+    end_page_addr = GLIB_PAGES - 1;
+  }
+
+  if (!scroll_active) {
+    scroll_page_min = start_page_addr;
+    scroll_page_max = end_page_addr;
+    scroll_active = true;
+  } else {
+    if (start_page_addr < scroll_page_min) {
+      scroll_page_min = start_page_addr;
+    }
+    if (end_page_addr > scroll_page_max) {
+      scroll_page_max = end_page_addr;
+    }
+  }
+}
+
 /**************************************************************************//**
  * @brief
  *   Initialization function for the glib.
@@ -90,6 +162,9 @@ glib_status_t glib_init(void)
   dimensions.xSize = oled->width;
   dimensions.ySize = oled->height;
 
+  /* The display RAM content is unknown after reset */
+  glib_mark_dirty(0, SSD1306_DISPLAY_WIDTH - 1, 0, GLIB_PAGES - 1);
+
   return GLIB_OK;
 }
 
@@ -117,6 +192,7 @@ glib_status_t glib_clear(glib_context_t *pContext)
   for (i = 0; i < sizeof(glib_frame_buffer); i++) {
       glib_frame_buffer[i] = (pContext->backgroundColor == Black) ? 0x00 : 0xFF;
   }
+  glib_mark_dirty(0, SSD1306_DISPLAY_WIDTH - 1, 0, GLIB_PAGES - 1);
 
   return GLIB_OK;
 }
@@ -143,10 +219,11 @@ glib_status_t glib_draw_pixel(glib_context_t *pContext, int32_t x, int32_t y)
     return GLIB_ERROR_INVALID_ARGUMENT;
   }
 
-  if ((x > dimensions.xSize)
-   || (y > dimensions.ySize)) {
+  if ((x < 0) || (x >= dimensions.xSize)
+   || (y < 0) || (y >= dimensions.ySize)) {
       return GLIB_ERROR_INVALID_REGION;
   }
+  glib_mark_dirty(x, x, y / 8, y / 8);
 
   if (pContext->foregroundColor == White) {
     glib_frame_buffer[x + (y / 8) * dimensions.xSize] |= 1 << (y % 8);
@@ -180,10 +257,11 @@ glib_status_t glib_earse_pixel(glib_context_t *pContext, int32_t x, int32_t y)
     return GLIB_ERROR_INVALID_ARGUMENT;
   }
 
-  if ((x > dimensions.xSize)
-   || (y > dimensions.ySize)) {
+  if ((x < 0) || (x >= dimensions.xSize)
+   || (y < 0) || (y >= dimensions.ySize)) {
       return GLIB_ERROR_INVALID_REGION;
   }
+  glib_mark_dirty(x, x, y / 8, y / 8);
 
   if (pContext->foregroundColor == White) {
     glib_frame_buffer[x + (y / 8) * dimensions.xSize] &= ~(1 << (y % 8));
@@ -482,7 +560,24 @@ glib_status_t glib_draw_circle(glib_context_t *pContext, uint8_t par_x, uint8_t
 ******************************************************************************/
 glib_status_t glib_update_display(void)
 {
-  return ((ssd1306_draw(glib_frame_buffer) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_OUT_OF_MEMORY);
+  sl_status_t sc;
+
+  if (!dirty) {
+    return GLIB_OK;
+  }
+
+  /* Only the window changed since the last update is sent */
+  sc = ssd1306_draw_window(glib_frame_buffer,
+                           dirty_x_min,
+                           dirty_page_min,
+                           dirty_x_max - dirty_x_min + 1,
+                           dirty_page_max - dirty_page_min + 1);
+  if (sc != SL_STATUS_OK) {
+    return GLIB_ERROR_OUT_OF_MEMORY;
+  }
+  dirty = false;
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
@@ -505,6 +600,10 @@ glib_status_t glib_draw_bmp(glib_context_t *pContext, const uint8_t *data)
 {
   (void) pContext;
 
+  /* The bitmap bypasses the glib_frame_buffer, the next update redraws the
+   * whole display from it */
+  glib_mark_dirty(0, SSD1306_DISPLAY_WIDTH - 1, 0, GLIB_PAGES - 1);
+
   return ((ssd1306_draw(data) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_OUT_OF_MEMORY);
 }
 
@@ -563,7 +662,12 @@ glib_status_t glib_set_contrast(uint8_t value)
  *****************************************************************************/
 glib_status_t glib_scroll_right(uint8_t start_page_addr, uint8_t end_page_addr)
 {
-  return ((ssd1306_scroll_right(start_page_addr, end_page_addr) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
+  if (ssd1306_scroll_right(start_page_addr, end_page_addr) != SL_STATUS_OK) {
+    return GLIB_ERROR_IO;
+  }
+  glib_scroll_started(start_page_addr, end_page_addr);
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
@@ -581,7 +685,12 @@ glib_status_t glib_scroll_right(uint8_t start_page_addr, uint8_t end_page_addr)
  *****************************************************************************/
 glib_status_t glib_scroll_left(uint8_t start_page_addr, uint8_t end_page_addr)
 {
-  return ((ssd1306_scroll_left(start_page_addr, end_page_addr) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
+  if (ssd1306_scroll_left(start_page_addr, end_page_addr) != SL_STATUS_OK) {
+    return GLIB_ERROR_IO;
+  }
+  glib_scroll_started(start_page_addr, end_page_addr);
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
@@ -599,7 +708,13 @@ glib_status_t glib_scroll_left(uint8_t start_page_addr, uint8_t end_page_addr)
  *****************************************************************************/
 glib_status_t glib_scroll_diag_right(uint8_t start_page_addr, uint8_t end_page_addr)
 {
-  return ((ssd1306_scroll_diag_right(start_page_addr, end_page_addr) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
+  if (ssd1306_scroll_diag_right(start_page_addr, end_page_addr) != SL_STATUS_OK) {
+    return GLIB_ERROR_IO;
+  }
+  /* The vertical scroll moves the rows of all pages */
+  glib_scroll_started(0, GLIB_PAGES - 1);
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
@@ -617,19 +732,92 @@ glib_status_t glib_scroll_diag_right(uint8_t start_page_addr, uint8_t end_page_a
  *****************************************************************************/
 glib_status_t glib_scroll_diag_left(uint8_t start_page_addr, uint8_t end_page_addr)
 {
-  return ((ssd1306_scroll_diag_left(start_page_addr, end_page_addr) == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
+  if (ssd1306_scroll_diag_left(start_page_addr, end_page_addr) != SL_STATUS_OK) {
+    return GLIB_ERROR_IO;
+  }
+  /* The vertical scroll moves the rows of all pages */
+  glib_scroll_started(0, GLIB_PAGES - 1);
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
  * @brief
  *   Stop scroll to glib.
  *
+ * @details
+ *   The SSD1306 leaves the scrolled content in its RAM, the scrolled pages
+ *   are redrawn from the glib_frame_buffer.
+ *
  * @return
  *   GLIB_OK if there are no errors.
  *****************************************************************************/
 glib_status_t glib_stop_scroll(void)
 {
-  return ((ssd1306_stop_scroll() == SL_STATUS_OK) ? GLIB_OK : GLIB_ERROR_IO);
+  if (ssd1306_stop_scroll() != SL_STATUS_OK) {
+    return GLIB_ERROR_IO;
+  }
+  if (!scroll_active) {
+    return GLIB_OK;
+  }
+  scroll_active = false;
+  glib_mark_dirty(0, SSD1306_DISPLAY_WIDTH - 1, scroll_page_min, scroll_page_max);
+
+  return glib_update_display();
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Scroll pages of the glib_frame_buffer horizontally.
+ *
+ * @details
+ *   The columns of the pages are rotated, the columns moved out at one side
+ *   come back at the other side. The pages are sent at the next
+ *   glib_update_display() as one transfer, a ticker can be moved by calling
+ *   both periodically without redrawing its content.
+ *
+ * @param[in] start_page_addr
+ *   Start page address
+ *
+ * @param[in] end_page_addr
+ *   End page address
+ *
+ * @param[in] columns
+ *   Number of columns to move, to the right if positive or to the left if
+ *   negative.
+ *
+ * @return
+ *   GLIB_OK if there are no errors.
+ *****************************************************************************/
+glib_status_t glib_scroll_step(uint8_t start_page_addr, uint8_t end_page_addr,
+                               int8_t columns)
+{
+  static uint8_t line[SSD1306_DISPLAY_WIDTH];
+  uint8_t *row;
+  int32_t shift;
+  uint8_t page;
+
+  if ((start_page_addr > end_page_addr) || (end_page_addr >= GLIB_PAGES)) {
+    return GLIB_ERROR_INVALID_ARGUMENT;
+  }
+
+  shift = columns % SSD1306_DISPLAY_WIDTH;
+  if (shift < 0) {
+    shift += SSD1306_DISPLAY_WIDTH;
+  }
+  if (shift == 0) {
+    return GLIB_OK;
+  }
+
+  for (page = start_page_addr; page <= end_page_addr; page++) {
+    row = &glib_frame_buffer[page * SSD1306_DISPLAY_WIDTH];
+    memcpy(line, row, SSD1306_DISPLAY_WIDTH);
+    memcpy(row + shift, line, SSD1306_DISPLAY_WIDTH - shift);
+    memcpy(row, line + SSD1306_DISPLAY_WIDTH - shift, shift);
+  }
+  glib_mark_dirty(0, SSD1306_DISPLAY_WIDTH - 1, start_page_addr, end_page_addr);
+
+  return GLIB_OK;
 }
 
 /**************************************************************************//**
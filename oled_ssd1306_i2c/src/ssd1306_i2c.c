@@ -38,6 +38,10 @@
 #include "sl_i2cspm.h"
 #include "sl_i2cspm_qwiic_config.h"
 
+static sl_status_t ssd1306_i2c_write(uint8_t control,
+                                     const void *data,
+                                     uint16_t len);
+
 /***************************************************************************//**
  * @brief
  *   Initialize the i2c interface.
@@ -69,31 +73,7 @@ void ssd1306_i2c_init(void)
  ******************************************************************************/
 sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
 {
-  I2C_TransferSeq_TypeDef    seq;
-  I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
-  const uint8_t *ptr = cmd;
-
-  seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  /* Select register and data to write */
-  i2c_write_data[0] = 0x00; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i + 1] = ptr[i];
-  }
-
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
-  ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
-  if (ret != i2cTransferDone) {
-    return SL_STATUS_TRANSMIT;
-  }
-
-  return SL_STATUS_OK;
+  return ssd1306_i2c_write(0x00, cmd, len);
 }
 
 /***************************************************************************//**
@@ -112,26 +92,29 @@ sl_status_t ssd1306_send_command(const void *cmd, uint8_t len)
  * @return
  *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
-sl_status_t ssd1306_send_data(const void *data, uint8_t len)
+sl_status_t ssd1306_send_data(const void *data, uint16_t len)
+{
+  return ssd1306_i2c_write(0x40, data, len);
+}
+
+/***************************************************************************//**
+ * Write a control byte followed by the buffer in one I2C transaction.
+ ******************************************************************************/
+static sl_status_t ssd1306_i2c_write(uint8_t control,
+                                     const void *data,
+                                     uint16_t len)
 {
   I2C_TransferSeq_TypeDef    seq;
   I2C_TransferReturn_TypeDef ret;
-  uint8_t i2c_write_data[len];
-  uint8_t i2c_read_data[1];
-  const uint8_t *ptr = data;
 
   seq.addr  = SSD1306_SLAVE_ADDRESS << 1;
-  seq.flags = I2C_FLAG_WRITE;
-  /* Select register and data to write */
-  i2c_write_data[0] = 0x40; // 0x00 for cmd, 0x40 for data
-  for (int i = 0; i < len; i++) {
-    i2c_write_data[i+1] = ptr[i];
-  }
-  seq.buf[0].data = i2c_write_data;
-  seq.buf[0].len  = len + 1;
-  /* Select location/length of data to be read */
-  seq.buf[1].data = i2c_read_data;
-  seq.buf[1].len  = 0;
+  /* The control byte and the buffer are sent back to back without a
+   * repeated start, so the buffer does not need to be copied. */
+  seq.flags = I2C_FLAG_WRITE_WRITE;
+  seq.buf[0].data = &control; // 0x00 for cmd, 0x40 for data
+  seq.buf[0].len  = 1;
+  seq.buf[1].data = (uint8_t *)data;
+  seq.buf[1].len  = len;
   ret = I2CSPM_Transfer(SL_I2CSPM_QWIIC_PERIPHERAL, &seq);
   if (ret != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
@@ -139,4 +122,3 @@ sl_status_t ssd1306_send_data(const void *data, uint8_t len)
 
   return SL_STATUS_OK;
 }
-
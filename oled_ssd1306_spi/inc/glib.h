@@ -329,6 +329,8 @@ glib_status_t glib_draw_circle(glib_context_t *pContext, uint8_t par_x, uint8_t
 *  @brief
 *  Update the display device with contents of active glib_frame_buffer.
 *
+*  Only the window of columns and pages drawn since the last update is sent.
+*
 *  @return
 *  Returns GLIB_OK is successful, error otherwise.
 ******************************************************************************/                         
@@ -447,11 +449,41 @@ glib_status_t glib_scroll_diag_left(uint8_t start_page_addr, uint8_t end_page_ad
  * @brief
  *   Stop scroll to glib.
  *
+ * @details
+ *   The SSD1306 leaves the scrolled content in its RAM, the scrolled pages
+ *   are redrawn from the glib_frame_buffer.
+ *
  * @return
  *   GLIB_OK if there are no errors.
  *****************************************************************************/
 glib_status_t glib_stop_scroll(void);
 
+/**************************************************************************//**
+ * @brief
+ *   Scroll pages of the glib_frame_buffer horizontally.
+ *
+ * @details
+ *   The columns of the pages are rotated, the columns moved out at one side
+ *   come back at the other side. The pages are sent at the next
+ *   glib_update_display() as one transfer, a ticker can be moved by calling
+ *   both periodically without redrawing its content.
+ *
+ * @param[in] start_page_addr
+ *   Start page address
+ *
+ * @param[in] end_page_addr
+ *   End page address
+ *
+ * @param[in] columns
+ *   Number of columns to move, to the right if positive or to the left if
+ *   negative.
+ *
+ * @return
+ *   GLIB_OK if there are no errors.
+ *****************************************************************************/
+glib_status_t glib_scroll_step(uint8_t start_page_addr, uint8_t end_page_addr,
+                               int8_t columns);
+
 /**************************************************************************//**
  * @brief
  *   Set the display ON/OFF to glib.
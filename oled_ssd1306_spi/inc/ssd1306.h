@@ -40,6 +40,7 @@
 
 #include "ssd1306_config.h"
 #include "sl_status.h"
+#include "ssd1306_spi.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -127,6 +128,62 @@ sl_status_t ssd1306_init(void);
  *****************************************************************************/
 sl_status_t ssd1306_draw(const void *data);
 
+/**************************************************************************//**
+ * @brief
+ *   Draw a window of a frame buffer to SSD1306.
+ *
+ * @details
+ *   The column and page window is set with one command, then the pixels are
+ *   sent in one data transfer if the window spans the width of the display,
+ *   or in one transfer per page otherwise.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer of the whole display, as for
+ *   ssd1306_draw(). Only the bytes inside the window are sent.
+ *
+ * @param[in] x
+ *   First column of the window
+ *
+ * @param[in] page
+ *   First page of the window
+ *
+ * @param[in] width
+ *   Number of columns in the window
+ *
+ * @param[in] pages
+ *   Number of pages in the window
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors, SL_STATUS_INVALID_PARAMETER if the
+ *   window is outside the display.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_window(const void *data,
+                                uint8_t x,
+                                uint8_t page,
+                                uint8_t width,
+                                uint8_t pages);
+
+/**************************************************************************//**
+ * @brief
+ *   Draw total of rows to SSD1306 without waiting for the transfer.
+ *
+ * @details
+ *   The window is set up with a blocking command, then the frame is sent by
+ *   DMA. The buffer must not be modified until the callback is called, and
+ *   other SSD1306 calls return SL_STATUS_BUSY until then.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer to draw.
+ *
+ * @param[in] callback
+ *   Function called when the frame has been sent, can be NULL.
+ *
+ * @return
+ *   SL_STATUS_OK if the transfer was started.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_async(const void *data,
+                               ssd1306_transfer_callback_t callback);
+
 /**************************************************************************//**
  * @brief
  *   Get a handle to SSD1306.
@@ -37,6 +37,7 @@
 #ifndef SSD1306_SPI_H
 #define SSD1306_SPI_H
 
+#include <stdbool.h>
 #include "sl_status.h"
 
 #ifdef __cplusplus
@@ -49,6 +50,15 @@ extern "C" {
 #define SSD1306_RS_GPIO_PORT                   gpioPortC
 #define SSD1306_RS_GPIO_PIN                    6
 
+/***************************************************************************//**
+ * @brief
+ *    Completion callback of a non-blocking transfer.
+ *
+ * @param[in] status
+ *    @ref SL_STATUS_OK if the transfer completed, an error code otherwise.
+ ******************************************************************************/
+typedef void (*ssd1306_transfer_callback_t)(sl_status_t status);
+
 /***************************************************************************//**
  * @brief
  *   Initialize gpio used in the SPI interface.
@@ -74,7 +84,8 @@ void ssd1306_spi_init(void);
  *    Number of bytes in transfer.
  *
  * @return
- *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
 sl_status_t ssd1306_send_command(const void *cmd, int len);
 
@@ -93,10 +104,45 @@ sl_status_t ssd1306_send_command(const void *cmd, int len);
  *    Number of bytes in transfer.
  *
  * @return
- *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
 sl_status_t ssd1306_send_data(const void *data, int len);
 
+/***************************************************************************//**
+ * @brief
+ *    Send non-blocking data over SPI interface.
+ *
+ * @note
+ *    The transfer is done by the SPIDRV DMA channel. The data buffer must not
+ *    be modified until the callback is called.
+ *
+ * @param[in] data
+ *    Transmit data buffer.
+ *
+ * @param[in] len
+ *    Number of bytes in transfer.
+ *
+ * @param[in] callback
+ *    Function called when the transfer is complete, can be NULL.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
+ ******************************************************************************/
+sl_status_t ssd1306_send_data_async(const void *data,
+                                    int len,
+                                    ssd1306_transfer_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a non-blocking transfer is in progress.
+ *
+ * @return
+ *    true until the callback of the last non-blocking transfer is called.
+ ******************************************************************************/
+bool ssd1306_spi_is_busy(void);
+
 #ifdef __cplusplus
 }
 #endif
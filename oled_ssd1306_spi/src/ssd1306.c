@@ -87,6 +87,10 @@ const uint8_t cmd_buff[] = {
     SSD1306_SETVCOMDETECT,  /* 0xDB Set VCOMH Deselect Level */
     0x20,
 
+    SSD1306_MEMORYMODE, /* 0x20 Set Memory Addressing Mode */
+    0x00, /* Horizontal addressing, the pointer wraps to the next page
+             at the end of the column window */
+
     SSD1306_DEACTIVATE_SCROLL,  /* Stop scroll */
 
     SSD1306_DISPLAYON /*  0xAF Set OLED Display On */
@@ -129,33 +133,121 @@ sl_status_t ssd1306_init(void)
  *****************************************************************************/
 sl_status_t ssd1306_draw(const void *data)
 {
-  sl_status_t sc = SL_STATUS_OK;
+  return ssd1306_draw_window(data, 0, 0,
+                             SSD1306_DISPLAY_WIDTH,
+                             SSD1306_DISPLAY_HEIGHT / 8);
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Draw a window of a frame buffer to SSD1306.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer of the whole display, as for
+ *   ssd1306_draw(). Only the bytes inside the window are sent.
+ *
+ * @param[in] x
+ *   First column of the window
+ *
+ * @param[in] page
+ *   First page of the window
+ *
+ * @param[in] width
+ *   Number of columns in the window
+ *
+ * @param[in] pages
+ *   Number of pages in the window
+ *
+ * @return
+ *   SL_STATUS_OK if there are no errors.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_window(const void *data,
+                                uint8_t x,
+                                uint8_t page,
+                                uint8_t width,
+                                uint8_t pages)
+{
+  sl_status_t sc;
   unsigned int i;
   const uint8_t *ptr = data;
-  uint8_t cmd;
-  uint8_t no_pages = SSD1306_DISPLAY_HEIGHT / 8;
-
-  /* Get start address to draw from */
-  for ( i = 0; i < no_pages; i++ ) {
-  /* Send update command and first line address */
-    cmd = 0xB0 + i;  /* Set the current RAM page address. */
-    sc += ssd1306_send_command(&cmd, 1);
-    cmd = 0x00;  /* Set Lower Column Start Address for Page Addressing Mode */
-    sc += ssd1306_send_command(&cmd, 1);
-    cmd = 0x12;  /* Set Higher Column Start Address for Page Addressing Mode */
-    sc += ssd1306_send_command(&cmd, 1);
-
-  /* Send pixels for this page */
-    sc += ssd1306_send_data(ptr, SSD1306_DISPLAY_WIDTH);
-    ptr += SSD1306_DISPLAY_WIDTH;
+  uint8_t cmd_buff[6];
+
+  if ((data == NULL) || (width == 0) || (pages == 0)
+      || (x + width > SSD1306_DISPLAY_WIDTH)
+      || (page + pages > SSD1306_DISPLAY_HEIGHT / 8)) {
+    return SL_STATUS_INVALID_PARAMETER;
   }
+
+  /* In horizontal addressing mode the RAM pointer runs through the window
+   * and wraps to the next page by itself, so it is set up only once. */
+  cmd_buff[0] = SSD1306_COLUMNADDR;   /* 0x21 Set Column Address */
+  cmd_buff[1] = SSD1306_COLUMN_OFFSET + x;
+  cmd_buff[2] = SSD1306_COLUMN_OFFSET + x + width - 1;
+  cmd_buff[3] = SSD1306_PAGEADDR;     /* 0x22 Set Page Address */
+  cmd_buff[4] = page;
+  cmd_buff[5] = page + pages - 1;
+  sc = ssd1306_send_command(cmd_buff, sizeof(cmd_buff));
   if (sc != SL_STATUS_OK) {
-    return SL_STATUS_TRANSMIT;
+    return sc;
+  }
+
+  ptr += page * SSD1306_DISPLAY_WIDTH + x;
+  if (width == SSD1306_DISPLAY_WIDTH) {
+    /* Full width pages are contiguous in the buffer, send them at once */
+    return ssd1306_send_data(ptr, width * pages);
+  }
+
+  for (i = 0; i < pages; i++) {
+    sc = ssd1306_send_data(ptr, width);
+    if (sc != SL_STATUS_OK) {
+      return sc;
+    }
+    ptr += SSD1306_DISPLAY_WIDTH;
   }
 
   return SL_STATUS_OK;
 }
 
+/**************************************************************************//**
+ * @brief
+ *   Draw total of rows to SSD1306 without waiting for the transfer.
+ *
+ * @param[in] data
+ *   Pointer to the pixel matrix buffer to draw.
+ *
+ * @param[in] callback
+ *   Function called when the frame has been sent, can be NULL.
+ *
+ * @return
+ *   SL_STATUS_OK if the transfer was started.
+ *****************************************************************************/
+sl_status_t ssd1306_draw_async(const void *data,
+                               ssd1306_transfer_callback_t callback)
+{
+  sl_status_t sc;
+  uint8_t cmd_buff[6] = {
+      SSD1306_COLUMNADDR,     //  0x21 Set Column Address
+      SSD1306_COLUMN_OFFSET,
+      SSD1306_COLUMN_OFFSET + SSD1306_DISPLAY_WIDTH - 1,
+      SSD1306_PAGEADDR,       //  0x22 Set Page Address
+      0,
+      SSD1306_DISPLAY_HEIGHT / 8 - 1
+  };
+
+  if (data == NULL) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sc = ssd1306_send_command(cmd_buff, sizeof(cmd_buff));
+  if (sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return ssd1306_send_data_async(data,
+                                 SSD1306_DISPLAY_WIDTH * SSD1306_DISPLAY_HEIGHT / 8,
+                                 callback);
+}
+
 /**************************************************************************//**
  * @brief
  *   Get a handle to SSD1306.
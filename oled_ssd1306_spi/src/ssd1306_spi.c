@@ -42,6 +42,14 @@
 
 #define spi_handle    sl_spidrv_mikroe_handle
 
+/* Set while a non-blocking data transfer is in progress */
+static volatile bool transfer_busy = false;
+static ssd1306_transfer_callback_t transfer_callback = NULL;
+
+static void transfer_complete(SPIDRV_Handle_t handle,
+                              Ecode_t transfer_status,
+                              int items_transferred);
+
 /***************************************************************************//**
  * @brief
  *   Initialize gpio used in the SPI interface.
@@ -78,12 +86,17 @@ void ssd1306_spi_init(void)
  *    Number of bytes in transfer.
  *
  * @return
- *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
 sl_status_t ssd1306_send_command(const void *cmd, int len)
 {
   Ecode_t ret;
 
+  if (transfer_busy) {
+    return SL_STATUS_BUSY;
+  }
+
   /* Clear DC pin to send command */
   GPIO_PinOutClear(SSD1306_SPI_DC_PORT, SSD1306_SPI_DC_PIN);
 
@@ -113,12 +126,17 @@ sl_status_t ssd1306_send_command(const void *cmd, int len)
  *    Number of bytes in transfer.
  *
  * @return
- *    @ref SL_STATUS_OK on success or @ref SL_STATUS_FAIL on failure
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
  ******************************************************************************/
 sl_status_t ssd1306_send_data(const void *data, int len)
 {
   Ecode_t ret;
 
+  if (transfer_busy) {
+    return SL_STATUS_BUSY;
+  }
+
   /* Set DC pin to send data */
   GPIO_PinOutSet(SSD1306_SPI_DC_PORT, SSD1306_SPI_DC_PIN);
 
@@ -133,3 +151,75 @@ sl_status_t ssd1306_send_data(const void *data, int len)
   return SL_STATUS_OK;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Send non-blocking data over SPI interface.
+ *
+ * @note
+ *    The transfer is done by the SPIDRV DMA channel. The data buffer must not
+ *    be modified until the callback is called.
+ *
+ * @param[in] data
+ *    Transmit data buffer.
+ *
+ * @param[in] len
+ *    Number of bytes in transfer.
+ *
+ * @param[in] callback
+ *    Function called when the transfer is complete, can be NULL.
+ *
+ * @return
+ *    @ref SL_STATUS_OK on success, @ref SL_STATUS_BUSY while a non-blocking
+ *    transfer is in progress or @ref SL_STATUS_FAIL on failure
+ ******************************************************************************/
+sl_status_t ssd1306_send_data_async(const void *data,
+                                    int len,
+                                    ssd1306_transfer_callback_t callback)
+{
+  Ecode_t ret;
+
+  if (transfer_busy) {
+    return SL_STATUS_BUSY;
+  }
+  transfer_busy = true;
+  transfer_callback = callback;
+
+  /* Set DC pin to send data */
+  GPIO_PinOutSet(SSD1306_SPI_DC_PORT, SSD1306_SPI_DC_PIN);
+
+  ret = SPIDRV_MTransmit(spi_handle, data, len, transfer_complete);
+  if (ret != ECODE_EMDRV_SPIDRV_OK) {
+    transfer_busy = false;
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a non-blocking transfer is in progress.
+ ******************************************************************************/
+bool ssd1306_spi_is_busy(void)
+{
+  return transfer_busy;
+}
+
+/***************************************************************************//**
+ * SPIDRV callback of the non-blocking transfer.
+ ******************************************************************************/
+static void transfer_complete(SPIDRV_Handle_t handle,
+                              Ecode_t transfer_status,
+                              int items_transferred)
+{
+  ssd1306_transfer_callback_t callback = transfer_callback;
+
+  (void) handle;
+  (void) items_transferred;
+
+  transfer_busy = false;
+  if (callback != NULL) {
+    callback((transfer_status == ECODE_EMDRV_SPIDRV_OK)
+             ? SL_STATUS_OK : SL_STATUS_FAIL);
+  }
+}
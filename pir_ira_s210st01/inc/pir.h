@@ -77,10 +77,11 @@ typedef enum {
  *   ADC IRQ callback function
  *
  * @note
- *   This function is called whenever an ADC interrupt is received. It's up to
- *   the application to decide how to handle the interrupt. However, in order to
- *   detect motion properly, pir_detect_motion function must be called within
- *   30ms after receiving the interrupt to process the latest ADC sample .
+ *   This function is called whenever the LDMA completes a block of
+ *   PIR_DMA_BLOCK_SIZE samples or an ADC sample breaks the detector window.
+ *   It's up to the application to decide how to handle the interrupt. However,
+ *   pir_detect_motion function must be called before the LDMA wraps around the
+ *   PIR_DMA_BLOCK_COUNT blocks, otherwise samples are lost.
  ******************************************************************************/
 typedef void (*pir_adc_irq_callback_t)();
 
@@ -109,6 +110,19 @@ typedef struct {
   bool motion_status;                       ///< Whether motion was detected.
 } pir_sample_t;
 
+/// Motion detector state of one PIR channel.
+typedef struct {
+  int32_t  win_base;                        ///< The low frequency mean of the PIR input signal.
+  int32_t  win_half;                        ///< Half of the peak to peak window size.
+  int32_t  thresh_high;                     ///< The upper threshold of the detector window.
+  int32_t  thresh_low;                      ///< The lower threshold of the detector window.
+  int32_t  thresh_max;                      ///< The highest value of the upper threshold.
+  int32_t  thresh_min;                      ///< The lowest value of the lower threshold.
+  uint32_t lockout_counter;                 ///< The time, in samples, remaining on the lockout window after detection.
+  uint32_t lockout_samples;                 ///< The lockout window length in samples.
+  uint8_t  sample_shift;                    ///< Left shift applied to the input samples.
+} pir_detector_t;
+
 /// Initialization structure for PIR driver.
 typedef struct {
   pir_opamp_mode_t opamp_mode;                                      ///< Use internal or external opamp.
@@ -154,8 +168,9 @@ sl_status_t pir_init(pir_init_t *pir_init, bool adc_enter_em2);
  *   Runs the motion detection algorithm
  *
  * @note
- *   This algorithms takes roughly 150us and must run on the latest ADC sample
- *   after receiving the ADC interrupt.
+ *   Processes all ADC samples captured by the LDMA since the last call as a
+ *   batch, including the block being filled, and moves the ADC window
+ *   comparator thresholds once per batch.
  *
  * @return
  *    Returns zero on OK, non-zero otherwise
@@ -204,6 +219,76 @@ sl_status_t pir_read_queue(pir_sample_t *pir_sample);
  ******************************************************************************/
 uint16_t pir_get_queue_size(sl_status_t *status);
 
+/***************************************************************************//**
+ * @brief
+ *   Gets the number of ADC samples lost because pir_detect_motion was not
+ *   called before the LDMA wrapped around the sample ring.
+ *
+ * @return
+ *   The number of lost samples since pir_start.
+ ******************************************************************************/
+uint32_t pir_get_overrun_count(void);
+
+/***************************************************************************//**
+ * @brief
+ *   Initializes a motion detector.
+ *
+ * @details
+ *   pir_detect_motion uses its own detector for the on-board PIR sensor.
+ *   Additional detectors can be run by the application, one per PIR channel.
+ *
+ * @param[out] detector
+ *   Pointer to the detector
+ *
+ * @param[in] win_size
+ *   The peak to peak window size for motion detection in lsb
+ *
+ * @param[in] motion_on_time
+ *   The duration of time (in seconds) motion on being asserted after detected
+ *
+ * @param[in] differential
+ *   True for signed differential samples, false for single ended samples
+ ******************************************************************************/
+void pir_detector_init(pir_detector_t *detector,
+                       uint32_t win_size,
+                       uint32_t motion_on_time,
+                       bool differential);
+
+/***************************************************************************//**
+ * @brief
+ *   Runs the motion detection algorithm on a block of samples.
+ *
+ * @details
+ *   The window and low pass filter state is kept in local variables for the
+ *   whole block and written back to the detector once. Interleaved samples of
+ *   several channels are processed one channel at a time by passing the
+ *   first sample of the channel and the number of channels as stride.
+ *
+ * @param[in,out] detector
+ *   Pointer to the detector of the channel
+ *
+ * @param[in] samples
+ *   Pointer to the first sample of the channel
+ *
+ * @param[in] count
+ *   Number of samples of the channel to process
+ *
+ * @param[in] stride
+ *   Distance between two samples of the channel
+ *
+ * @param[out] trace
+ *   Optional buffer of count PIR samples for debugging, may be NULL.
+ *   The timestamps are not filled.
+ *
+ * @return
+ *   The motion status after the last sample.
+ ******************************************************************************/
+bool pir_detector_process(pir_detector_t *detector,
+                          const int32_t *samples,
+                          uint32_t count,
+                          uint32_t stride,
+                          pir_sample_t *trace);
+
 /** @} (end addtogroup PIR) */
 
 #ifdef __cplusplus
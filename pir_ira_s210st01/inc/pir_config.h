@@ -23,6 +23,23 @@
 extern "C" {
 #endif
 
+// LDMA channel capturing the ADC samples.
+#ifndef PIR_LDMA_CHANNEL
+#define PIR_LDMA_CHANNEL      0
+#endif
+
+// ADC samples per LDMA block, the CPU is woken up once per block.
+// Must be a multiple of 4 (ADC FIFO depth).
+#ifndef PIR_DMA_BLOCK_SIZE
+#define PIR_DMA_BLOCK_SIZE    8
+#endif
+
+// Number of blocks in the ADC sample ring, 2 for ping-pong operation.
+// PIR_DMA_BLOCK_SIZE * PIR_DMA_BLOCK_COUNT must be a power of 2.
+#ifndef PIR_DMA_BLOCK_COUNT
+#define PIR_DMA_BLOCK_COUNT   4
+#endif
+
 #ifdef EFM32PG12B500F1024GL125 /* BRD2501: SLSTK3402A: PG12 STK */
 
 // PIR Occupancy Sensor Analog Pins
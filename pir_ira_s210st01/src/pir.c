@@ -23,13 +23,32 @@
 #include "em_opamp.h"
 #include "em_adc.h"
 #include "em_letimer.h"
+#include "em_ldma.h"
+#include "em_core.h"
 
 #include <pir.h>
 #include <pir_config.h>
 #include <stdbool.h>
 #include <stdio.h>
 
-#define ADC_SAMPLE_QUEUE_SIZE    4         // Must be at least 4
+// Sampling frequency set by the CRYOTIMER period, 1024 / 32 = 32 Hz.
+#define PIR_SAMPLE_RATE_HZ                 32
+// LETIMER ticks (1024 Hz) between two samples.
+#define PIR_TIMESTAMP_TICKS_PER_SAMPLE     (1024 / PIR_SAMPLE_RATE_HZ)
+// Left shift to bring the oversampled ADC data to 16 bits.
+#define ADC_SAMPLE_SHIFT                   3
+// Low pass filter coefficient of the window base, a = 2^-PIR_LPF_SHIFT.
+#define PIR_LPF_SHIFT                      5
+
+#define ADC_RING_SIZE                      (PIR_DMA_BLOCK_SIZE * PIR_DMA_BLOCK_COUNT)
+#define ADC_RING_MASK                      (ADC_RING_SIZE - 1)
+
+#if (ADC_RING_SIZE & ADC_RING_MASK) != 0
+#error "PIR_DMA_BLOCK_SIZE * PIR_DMA_BLOCK_COUNT must be a power of 2"
+#endif
+#if (PIR_DMA_BLOCK_SIZE % 4) != 0
+#error "PIR_DMA_BLOCK_SIZE must be a multiple of the ADC FIFO depth (4)"
+#endif
 
 /// PIR sample queue structure
 typedef struct {
@@ -40,17 +59,29 @@ typedef struct {
   pir_sample_t *sample;                    ///< Pointer to PIR sample buffer.
 } sample_queue_t;
 
+/// Lock-free single producer, single consumer ring of ADC samples.
+/// The LDMA fills one block after the other, the LDMA IRQ is the only writer
+/// of head and the detector is the only writer of tail.
+typedef struct {
+  volatile uint32_t head;                  ///< Samples captured, multiple of PIR_DMA_BLOCK_SIZE.
+  uint32_t tail;                           ///< Samples processed by the pir_detector.
+  uint32_t overruns;                       ///< Samples overwritten before being processed.
+  int32_t data[ADC_RING_SIZE];             ///< Raw ADC data written by the LDMA.
+} adc_ring_t;
+
 static pir_init_t pir_instance;      // An instance that holds the configuration
-static uint32_t lockout_counter = 0; // The time, in samples, remaining on the lockout window after detection.
-static int32_t win_base = 0;         // The low frequency mean of the PIR input signal.
+static pir_detector_t pir_detector;  // Motion detector of the PIR input signal.
+static bool motion_state = false;    // Motion status reported to the application.
+static bool capture_running = false; // LDMA capture is running.
+static uint32_t timestamp_base = 0;  // Timestamp of the first sample after pir_start().
 
 /// The adcSource variable should be set to adcSourceAdcDiff for PIR operation.
 /// The single ended modes are additional modes for signal chain analysis with a voltage source.
 static pir_adc_source_t adc_source = pir_adc_source_diff;
 
 static sample_queue_t app_queue;   // Buffer PIR samples for application layer debugging.
-static sample_queue_t adc_queue;   // Buffer ADC samples for motion detection algorithm.
-static pir_sample_t adc_sample_queue[ADC_SAMPLE_QUEUE_SIZE]; // ADC sample buffer.
+static adc_ring_t adc_ring;        // Buffer ADC samples for motion detection algorithm.
+static LDMA_Descriptor_t adc_dma_desc[PIR_DMA_BLOCK_COUNT]; // One descriptor per ring block.
 
 /***************************************************************************//**
  * @brief
@@ -60,36 +91,37 @@ static pir_sample_t adc_sample_queue[ADC_SAMPLE_QUEUE_SIZE]; // ADC sample buffe
  *  conversions, the resolution is 16-bit, regardless if the OVS setting
  *  does not achieve 16-bit resolution.
  *
- * @param[in] win_base
- *  The midpoint of the window. Thresholds are the base +/- 0.5*winSize
+ * @param[in] pos_thresh
+ *  The upper threshold of the window, already clamped by the pir_detector.
  *
- * @param[in] win_size
- *  The total peak to peak width of the window.
+ * @param[in] neg_thresh
+ *  The lower threshold of the window, already clamped by the pir_detector.
  ******************************************************************************/
-static void update_adc_thresholds(int32_t win_base, uint32_t win_size)
+static void update_adc_thresholds(int32_t pos_thresh, int32_t neg_thresh)
 {
-  int32_t pos_thresh = win_base + win_size / 2;
-  int32_t neg_thresh = win_base - win_size / 2;
-
-  // Ensure thresholds are within int16_t for ADC window comparator.
-  int32_t pos_thresh_max, neg_thresh_min;
-  if (adc_source == pir_adc_source_diff) {
-	pos_thresh_max = 32767;
-	neg_thresh_min = -32768;
-  } else {
-	pos_thresh_max = 65535;
-    neg_thresh_min = 0;
-  }
+  ADC0->CMPTHR = ((pos_thresh << _ADC_CMPTHR_ADGT_SHIFT) & _ADC_CMPTHR_ADGT_MASK)
+                 | ((neg_thresh << _ADC_CMPTHR_ADLT_SHIFT) & _ADC_CMPTHR_ADLT_MASK);
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Clamps the window around the base to the range of the ADC comparator.
+ ******************************************************************************/
+static inline void detector_window(int32_t win_base, int32_t win_half,
+                                   int32_t thresh_max, int32_t thresh_min,
+                                   int32_t *thresh_high, int32_t *thresh_low)
+{
+  int32_t pos_thresh = win_base + win_half;
+  int32_t neg_thresh = win_base - win_half;
 
-  if (pos_thresh > pos_thresh_max) {
-	pos_thresh = pos_thresh_max;
+  if (pos_thresh > thresh_max) {
+    pos_thresh = thresh_max;
   }
-  if (neg_thresh < neg_thresh_min) {
-	neg_thresh = neg_thresh_min;
+  if (neg_thresh < thresh_min) {
+    neg_thresh = thresh_min;
   }
-
-  ADC0->CMPTHR = ((pos_thresh << _ADC_CMPTHR_ADGT_SHIFT) & _ADC_CMPTHR_ADGT_MASK)
-                 | ((neg_thresh << _ADC_CMPTHR_ADLT_SHIFT) & _ADC_CMPTHR_ADLT_MASK);
+  *thresh_high = pos_thresh;
+  *thresh_low = neg_thresh;
 }
 
 /***************************************************************************//**
@@ -164,6 +196,8 @@ static void init_adc(bool adc_enter_em2)
   adcInitSingle.prsSel = adcPRSSELCh0;
   adcInitSingle.leftAdjust = true;
   adcInitSingle.acqTime = adcAcqTime64;
+  // Let the ADC wake the LDMA in EM2 so the CPU only wakes per block.
+  adcInitSingle.singleDmaEm2Wu = adc_enter_em2;
 
 
   switch (adc_source) {
@@ -194,12 +228,12 @@ static void init_adc(bool adc_enter_em2)
   ADC_Init(ADC0, &adcInit);
   ADC_InitSingle(ADC0, &adcInitSingle);
 
-  // Set ADC FIFO level to max to minimize EM0 wakeups when the ADC sample remains within window.
-  static const uint32_t dataValidLevel = 3; // ADC SINGLE IRQ is when DVL+1 single channels are available in the FIFO.
+  // Set ADC FIFO level to max, the LDMA then moves 4 samples per request.
+  static const uint32_t dataValidLevel = 3; // ADC SINGLE DMA request is when DVL+1 single channels are available in the FIFO.
   ADC0->SINGLECTRLX &= ~_ADC_SINGLECTRLX_DVL_MASK;
   ADC0->SINGLECTRLX |= (dataValidLevel << _ADC_SINGLECTRLX_DVL_SHIFT);
 
-  update_adc_thresholds(win_base, pir_instance.win_size);
+  update_adc_thresholds(pir_detector.thresh_high, pir_detector.thresh_low);
 
   // Initialize the CRYOTIMER.
   CMU_OscillatorEnable(cmuOsc_ULFRCO, true, true);
@@ -249,6 +283,31 @@ static void init_timestamp_clock(void)
   LETIMER_Init(LETIMER0, &letimerInit);
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Initialize the LDMA descriptor loop capturing the ADC samples.
+ *
+ * @details
+ *  Each descriptor fills one block of the ADC ring and links to the next one,
+ *  the last one links back to the first. The LDMA interrupt is raised once
+ *  per block.
+ ******************************************************************************/
+static void init_ldma(void)
+{
+  CMU_ClockEnable(cmuClock_LDMA, true);
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+  LDMA_Init(&ldmaInit);
+
+  for (uint32_t i = 0; i < PIR_DMA_BLOCK_COUNT; i++) {
+    int32_t link = (i == PIR_DMA_BLOCK_COUNT - 1) ? -(int32_t)i : 1;
+    adc_dma_desc[i] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(
+      &ADC0->SINGLEDATA, &adc_ring.data[i * PIR_DMA_BLOCK_SIZE],
+      PIR_DMA_BLOCK_SIZE, link);
+    adc_dma_desc[i].xfer.size = ldmaCtrlSizeWord;
+    adc_dma_desc[i].xfer.blockSize = ldmaCtrlBlockSizeUnit4;
+  }
+}
+
 /***************************************************************************//**
  * @brief
  *   Enqueue the PIR sample.
@@ -276,10 +335,10 @@ static void enqueue_sample(sample_queue_t *queue, pir_sample_t sample)
  * @brief
  *   Dequeue the PIR sample.
  ******************************************************************************/
-static void dequeue_sample(sample_queue_t *queue, pir_sample_t *sample)
+static bool dequeue_sample(sample_queue_t *queue, pir_sample_t *sample)
 {
   if (queue->used < 1) {
-	sample = NULL;
+    return false;
   }
 
   *sample = queue->sample[queue->tail];
@@ -288,6 +347,8 @@ static void dequeue_sample(sample_queue_t *queue, pir_sample_t *sample)
 	queue->tail = 0;
   }
   queue->used -= 1;
+
+  return true;
 }
 
 /***************************************************************************//**
@@ -323,8 +384,10 @@ sl_status_t pir_init(pir_init_t *pir_init, bool adc_enter_em2)
 	  return SL_STATUS_INVALID_CONFIGURATION;
   }
 
-  adc_queue.size = ADC_SAMPLE_QUEUE_SIZE;
-  adc_queue.sample = adc_sample_queue;
+  pir_detector_init(&pir_detector, pir_instance.win_size,
+                    pir_instance.motion_on_time,
+                    adc_source == pir_adc_source_diff);
+  pir_detector.sample_shift = ADC_SAMPLE_SHIFT;
 
   // Peripheral initialization
   if (pir_init->opamp_mode == pir_opamp_mode_internal) {
@@ -334,8 +397,10 @@ sl_status_t pir_init(pir_init_t *pir_init, bool adc_enter_em2)
 	init_timestamp_clock();
   }
   init_adc(adc_enter_em2);
+  init_ldma();
 
   // Default to motion off state
+  motion_state = false;
   pir_instance.motion_detection_callback(false);
 
   return SL_STATUS_OK;
@@ -347,12 +412,28 @@ sl_status_t pir_init(pir_init_t *pir_init, bool adc_enter_em2)
  ******************************************************************************/
 sl_status_t pir_start(void)
 {
-  lockout_counter = 0;
+  LDMA_TransferCfg_t adcDmaCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_ADC0_SINGLE);
+
+  if (capture_running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  pir_detector.lockout_counter = 0;
+  adc_ring.head = 0;
+  adc_ring.tail = 0;
+  adc_ring.overruns = 0;
+  if (pir_instance.use_timestamp) {
+    timestamp_base = ~LETIMER_CounterGet(LETIMER0);
+  }
+
+  // Drop stale conversions so that the FIFO and the ring stay aligned.
+  ADC0->SINGLEFIFOCLEAR = ADC_SINGLEFIFOCLEAR_SINGLEFIFOCLEAR;
+  LDMA_StartTransfer(PIR_LDMA_CHANNEL, &adcDmaCfg, &adc_dma_desc[0]);
+  capture_running = true;
 
   ADC_Start(ADC0, adcStartSingle);
-  // Wake up on FIFO reaching threshold.
-  ADC_IntEnable(ADC0, ADC_IF_SINGLE);
-  // Wake up on ADC exceeding window threshold.
+  // Wake up on ADC exceeding window threshold, blocks are signaled by the LDMA.
   ADC_IntEnable(ADC0, ADC_IF_SINGLECMP);
   NVIC_EnableIRQ(ADC0_IRQn);
 
@@ -365,85 +446,180 @@ sl_status_t pir_start(void)
  ******************************************************************************/
 sl_status_t pir_stop(void)
 {
-  ADC_IntDisable(ADC0, ADC_IF_SINGLE);
   ADC_IntDisable(ADC0, ADC_IF_SINGLECMP);
   NVIC_DisableIRQ(ADC0_IRQn);
+  LDMA_StopTransfer(PIR_LDMA_CHANNEL);
+  capture_running = false;
 
   return SL_STATUS_OK;
 }
 
 /***************************************************************************//**
  * @brief
- *   Runs the motion detection algorithm
- *
- * @note
- *   This algorithms takes roughly 150us and must run on the latest ADC sample
- *   after receiving the ADC interrupt.
+ *   Initializes a motion pir_detector.
  ******************************************************************************/
-sl_status_t pir_detect_motion(void)
+void pir_detector_init(pir_detector_t *detector,
+                       uint32_t win_size,
+                       uint32_t motion_on_time,
+                       bool differential)
 {
+  detector->win_base = 0;
+  detector->win_half = (int32_t)(win_size / 2);
+  if (differential) {
+    detector->thresh_max = 32767;
+    detector->thresh_min = -32768;
+  } else {
+    detector->thresh_max = 65535;
+    detector->thresh_min = 0;
+  }
+  detector->lockout_counter = 0;
+  detector->lockout_samples = motion_on_time * PIR_SAMPLE_RATE_HZ;
+  detector->sample_shift = 0;
+  detector_window(detector->win_base, detector->win_half,
+                  detector->thresh_max, detector->thresh_min,
+                  &detector->thresh_high, &detector->thresh_low);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Runs the motion detection algorithm on a block of samples.
+ ******************************************************************************/
+bool pir_detector_process(pir_detector_t *detector,
+                          const int32_t *samples,
+                          uint32_t count,
+                          uint32_t stride,
+                          pir_sample_t *trace)
+{
+  // Keep the detector state in locals for the whole block.
+  int32_t win_base = detector->win_base;
+  int32_t win_half = detector->win_half;
+  int32_t thresh_high = detector->thresh_high;
+  int32_t thresh_low = detector->thresh_low;
+  int32_t thresh_max = detector->thresh_max;
+  int32_t thresh_min = detector->thresh_min;
+  uint32_t lockout_counter = detector->lockout_counter;
+  uint32_t lockout_samples = detector->lockout_samples;
+  uint8_t sample_shift = detector->sample_shift;
   bool motion = false;
-  uint32_t num_of_samples = 0;
-  pir_sample_t adc_sample;
-  pir_sample_t pir_sample;
-  int32_t adc_thresh_high, adc_thresh_low;
-
-  // Read out each ADC sample, update the LPF mean, and check if it was within the window thresholds
-  while (adc_queue.used > 0) {
-	num_of_samples++;
-	dequeue_sample(&adc_queue, &adc_sample);
-    // Capture the ADC and winBase of the current sample.
-	pir_sample.adc_sample = adc_sample.adc_sample;
-	pir_sample.win_base = win_base;
-    if (adc_source == pir_adc_source_diff) {
-      adc_thresh_high = ((int16_t) ((ADC0->CMPTHR & _ADC_CMPTHR_ADGT_MASK) >> _ADC_CMPTHR_ADGT_SHIFT));
-      adc_thresh_low = ((int16_t) ((ADC0->CMPTHR & _ADC_CMPTHR_ADLT_MASK) >> _ADC_CMPTHR_ADLT_SHIFT));
-    } else if ((adc_source == pir_adc_source_pos) || (adc_source == pir_adc_source_neg)) {
-      adc_thresh_high = ((uint16_t) ((ADC0->CMPTHR & _ADC_CMPTHR_ADGT_MASK) >> _ADC_CMPTHR_ADGT_SHIFT));
-      adc_thresh_low = ((uint16_t) ((ADC0->CMPTHR & _ADC_CMPTHR_ADLT_MASK) >> _ADC_CMPTHR_ADLT_SHIFT));
-    } else {
-      return SL_STATUS_FAIL;
+  bool broken;
+
+  for (uint32_t i = 0; i < count; i++) {
+    int32_t sample = (int32_t)((uint32_t)*samples << sample_shift);
+    samples += stride;
+
+    if (trace != NULL) {
+      trace[i].adc_sample = sample;
+      trace[i].win_base = win_base;
+      trace[i].adc_upper_threshold = thresh_high;
+      trace[i].adc_lower_threshold = thresh_low;
     }
 
     // If window was broken, move window thresholds to include the latest ADC reading.
-    // Thresholds are recalculated in software because samples are batch processed.
-    if (adc_sample.adc_sample > adc_thresh_high) {
-      win_base = adc_sample.adc_sample - pir_instance.win_size / 2;
-      motion = true;
-    } else if (adc_sample.adc_sample < adc_thresh_low) {
-      win_base = adc_sample.adc_sample + pir_instance.win_size / 2;
-      motion = true;
+    broken = true;
+    if (sample > thresh_high) {
+      win_base = sample - win_half;
+    } else if (sample < thresh_low) {
+      win_base = sample + win_half;
     } else {
       // Window was not broken, update winBase to follow the low frequency drift using a DT 1st order LPF.
-      // Let a = 2^-a_shift
+      // Let a = 2^-PIR_LPF_SHIFT
       // Equivalent continuous RC is given by Ts * (1-a) / a
-      uint32_t a_shift = 5;
-      win_base = (adc_sample.adc_sample >> a_shift) + (win_base - (win_base >> a_shift));
+      win_base = (sample >> PIR_LPF_SHIFT) + (win_base - (win_base >> PIR_LPF_SHIFT));
+      broken = false;
+    }
+    detector_window(win_base, win_half, thresh_max, thresh_min,
+                    &thresh_high, &thresh_low);
+
+    if (broken) {
+      lockout_counter = lockout_samples;
+      motion = true;
+    } else if (lockout_counter > 0) {
+      lockout_counter--;
+      motion = (lockout_counter > 0);
+    } else {
+      motion = false;
+    }
+
+    if (trace != NULL) {
+      trace[i].motion_status = motion;
     }
+  }
 
-    update_adc_thresholds(win_base, pir_instance.win_size);
+  detector->win_base = win_base;
+  detector->thresh_high = thresh_high;
+  detector->thresh_low = thresh_low;
+  detector->lockout_counter = lockout_counter;
 
-    // Enqueue the PIR sample
-    pir_sample.timestamp_ms = adc_sample.timestamp_ms;
-    pir_sample.motion_status = (lockout_counter > 0 || motion);
-    pir_sample.adc_upper_threshold = adc_thresh_high;
-    pir_sample.adc_lower_threshold = adc_thresh_low;
-    enqueue_sample(&app_queue, pir_sample);
+  return (count > 0) ? motion : (lockout_counter > 0);
+}
 
-  } // while (data_valid)
+/***************************************************************************//**
+ * @brief
+ *   Runs the motion detection algorithm
+ *
+ * @note
+ *   Processes every sample captured since the last call in blocks of at most
+ *   PIR_DMA_BLOCK_SIZE samples, including the samples of the block the LDMA
+ *   is currently filling.
+ ******************************************************************************/
+sl_status_t pir_detect_motion(void)
+{
+  pir_sample_t trace[PIR_DMA_BLOCK_SIZE];
+  pir_sample_t *trace_buf = (app_queue.sample != NULL) ? trace : NULL;
+  uint32_t head, end, index, count;
+  uint32_t partial = 0;
+  bool motion = motion_state;
+  CORE_DECLARE_IRQ_STATE;
+
+  if (!capture_running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  // Snapshot the completed blocks and the progress of the active one.
+  CORE_ENTER_ATOMIC();
+  head = adc_ring.head;
+  partial = PIR_DMA_BLOCK_SIZE - LDMA_TransferRemainingCount(PIR_LDMA_CHANNEL);
+  CORE_EXIT_ATOMIC();
+  end = head + partial;
+
+  // The LDMA has overwritten the oldest blocks if the detector fell behind.
+  if ((head - adc_ring.tail) > (ADC_RING_SIZE - PIR_DMA_BLOCK_SIZE)) {
+    uint32_t tail = head - (ADC_RING_SIZE - PIR_DMA_BLOCK_SIZE);
+    adc_ring.overruns += tail - adc_ring.tail;
+    adc_ring.tail = tail;
+  }
+
+  while (adc_ring.tail != end) {
+    index = adc_ring.tail & ADC_RING_MASK;
+    count = end - adc_ring.tail;
+    if (count > ADC_RING_SIZE - index) {
+      count = ADC_RING_SIZE - index;
+    }
+    if (count > PIR_DMA_BLOCK_SIZE) {
+      count = PIR_DMA_BLOCK_SIZE;
+    }
 
-  if (lockout_counter > 0) {
-	lockout_counter -= (num_of_samples < lockout_counter) ? num_of_samples : lockout_counter;
-    if (lockout_counter == 0) {
-      // Motion off
-      pir_instance.motion_detection_callback(false);
+    motion = pir_detector_process(&pir_detector, &adc_ring.data[index],
+                                  count, 1, trace_buf);
+
+    if (trace_buf != NULL) {
+      for (uint32_t i = 0; i < count; i++) {
+        trace[i].timestamp_ms = (int32_t)((timestamp_base
+                                           + (adc_ring.tail + i)
+                                           * PIR_TIMESTAMP_TICKS_PER_SAMPLE)
+                                          & 0xFFFF);
+        enqueue_sample(&app_queue, trace[i]);
+      }
     }
+    adc_ring.tail += count;
   }
 
-  // Motion On
-  if (motion) {
-	lockout_counter = pir_instance.motion_on_time * 32; // 32Hz
-	pir_instance.motion_detection_callback(true);
+  // Move the hardware window once per batch.
+  update_adc_thresholds(pir_detector.thresh_high, pir_detector.thresh_low);
+
+  if (motion != motion_state) {
+    motion_state = motion;
+    pir_instance.motion_detection_callback(motion);
   }
 
   return SL_STATUS_OK;
@@ -452,32 +628,41 @@ sl_status_t pir_detect_motion(void)
 /***************************************************************************//**
  * @brief
  *  ADC interrupt handler
+ *
+ * @details
+ *  Only raised when a sample breaks the window, the samples themselves are
+ *  moved by the LDMA.
  ******************************************************************************/
 void ADC0_IRQHandler(void)
 {
   uint32_t flags;
-  pir_sample_t adc_sample;
-  static int32_t last_timestamp = -1;
 
   flags = ADC_IntGetEnabled(ADC0);
   ADC_IntClear(ADC0, flags);
   NVIC_ClearPendingIRQ(ADC0_IRQn);
 
-  // Enqueue the ADC sample
-  while(ADC0->SINGLEFIFOCOUNT > 0)
-  {
-	if ((last_timestamp < 0) && pir_instance.use_timestamp) {
-	  last_timestamp = ~LETIMER_CounterGet(LETIMER0);
-	}
-	// adjust this with over-sampling for OSR < 64. Need to left shift to get to 16b.
-	adc_sample.adc_sample = ADC_DataSingleGet(ADC0) << 3;
-	adc_sample.timestamp_ms = last_timestamp;
-	enqueue_sample(&adc_queue, adc_sample);
-  }
-
   pir_instance.adc_irq_callback();
 }
 
+/***************************************************************************//**
+ * @brief
+ *  LDMA interrupt handler
+ *
+ * @details
+ *  Publishes a completed block to the pir_detector.
+ ******************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t flags = LDMA_IntGetEnabled();
+  uint32_t mask = 1UL << PIR_LDMA_CHANNEL;
+
+  if (flags & mask) {
+    LDMA_IntClear(mask);
+    adc_ring.head += PIR_DMA_BLOCK_SIZE;
+    pir_instance.adc_irq_callback();
+  }
+}
+
 /***************************************************************************//**
  * @brief
  *   Reads out a sample from the PIR sample queue.
@@ -490,7 +675,9 @@ sl_status_t pir_read_queue(pir_sample_t *pir_sample)
   if (app_queue.sample == NULL) {
     return SL_STATUS_FAIL;
   }
-  dequeue_sample(&app_queue, pir_sample);
+  if (!dequeue_sample(&app_queue, pir_sample)) {
+    return SL_STATUS_EMPTY;
+  }
 
   return SL_STATUS_OK;
 }
@@ -513,3 +700,12 @@ uint16_t pir_get_queue_size(sl_status_t *status)
 
   return app_queue.used;
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Gets the number of ADC samples lost because the detector fell behind.
+ ******************************************************************************/
+uint32_t pir_get_overrun_count(void)
+{
+  return adc_ring.overruns;
+}
@@ -181,7 +181,7 @@ extern "C" {
 
 #define VCNL4040_PS_SMART_PERS_MASK           ~(1 << 4)
 #define VCNL4040_PS_SMART_PERS_DISABLE        0
-#define VCNL4040_PS_SMART_PERS_ENABLE         (1 << 1)
+#define VCNL4040_PS_SMART_PERS_ENABLE         (1 << 4)
 
 #define VCNL4040_PS_AF_MASK                   ~(1 << 3)
 #define VCNL4040_PS_AF_DISABLE                0
@@ -200,7 +200,7 @@ extern "C" {
 
 #define VCNL4040_LED_I_MASK                   ~((1 << 2) | (1 << 1) | (1 << 0))
 #define VCNL4040_LED_50MA                     0
-#define VCNL4040_LED_75MA                     (1 << 1)
+#define VCNL4040_LED_75MA                     (1 << 0)
 #define VCNL4040_LED_100MA                    (1 << 1)
 #define VCNL4040_LED_120MA                    ((1 << 1) | (1 << 0))
 #define VCNL4040_LED_140MA                    (1 << 2)
@@ -285,6 +285,30 @@ typedef enum {
  *   TBD.
  ******************************************************************************/
 typedef void (*vcnl4040_norm_interrupt_callback_t)(vcnl4040_irq_source_t irq);
+
+/***************************************************************************//**
+ * @brief
+ *  Structure to store the data of one sampling sequence
+ ******************************************************************************/
+typedef struct {
+  uint32_t timestamp;  /*!< sleeptimer tick count when the sequence started,
+                            or of the INT edge in interrupt mode */
+  uint16_t proximity;  /*!< PS_DATA, 0 if the proximity sensor is off */
+  uint16_t ambient;    /*!< ALS_DATA, 0 if the ambient light sensor is off */
+  uint16_t white;      /*!< WHITE_DATA, 0 if the white channel is off */
+  uint8_t  int_flags;  /*!< INT_FLAG upper byte (VCNL4040_INT_FLAG_xxx),
+                            0 if the flags were not read */
+} vcnl4040_sample_t;
+
+/***************************************************************************//**
+ * @brief
+ *   VCNL4040 interrupt mode callback function
+ *
+ * @details
+ *   This callback function is executed in vcnl4040_process_action() in the
+ *   main loop, with the interrupt flags and the data read after an INT edge.
+ ******************************************************************************/
+typedef void (*vcnl4040_sample_callback_t)(const vcnl4040_sample_t *sample);
 // -----------------------------------------------------------------------------
 //                       Public Function Definitions
 // -----------------------------------------------------------------------------
@@ -744,12 +768,17 @@ sl_status_t vcnl4040_get_proximity(uint16_t *proximity_data);
 
 /***************************************************************************//**
  * @brief
- *  This function reads the interrupt flag and checks PS_IF_CLOSE interrupt
- *  status.
+ *  This function checks PS_IF_CLOSE interrupt status.
  *
  * @param[out] isClose
  *  Returns true if the prox value rises above the upper threshold
  *
+ * @note
+ *  The INT_FLAG register clears on read. The flags read by any call are kept
+ *  by the driver until they are reported. A check only reads INT_FLAG if its
+ *  flag was already reported since the last read, so after a
+ *  vcnl4040_sample() with read_flags set the four checks need no transfer.
+ *
  * @return
  *  SL_STATUS_OK if there are no errors.
  *  SL_STATUS_TRANSMIT if I2C transmit failed.
@@ -758,12 +787,14 @@ sl_status_t vcnl4040_is_close(bool *is_close);
 
 /***************************************************************************//**
  * @brief
- *  This function reads the interrupt flag and checks PS_IF_AWAY interrupt
- *  status.
+ *  This function checks PS_IF_AWAY interrupt status.
  *
  * @param[out] isAway
  *  Returns true if the prox value drops below the lower threshold
  *
+ * @note
+ *  See vcnl4040_is_close() for how the flags are cached.
+ *
  * @return
  *  SL_STATUS_OK if there are no errors.
  *  SL_STATUS_TRANSMIT if I2C transmit failed.
@@ -984,12 +1015,14 @@ sl_status_t vcnl4040_get_white(uint16_t *white_data);
 
 /***************************************************************************//**
  * @brief
- *  This function reads the interrupt flag and checks PS_IF_H interrupt
- *  status.
+ *  This function checks ALS_IF_H interrupt status.
  *
  * @param[out] isLight
  *  Returns true if the ALS value rises above the upper threshold
  *
+ * @note
+ *  See vcnl4040_is_close() for how the flags are cached.
+ *
  * @return
  *  SL_STATUS_OK if there are no errors.
  *  SL_STATUS_TRANSMIT if I2C transmit failed.
@@ -998,12 +1031,14 @@ sl_status_t vcnl4040_is_light(bool *is_light);
 
 /***************************************************************************//**
  * @brief
- *  This function reads the interrupt flag and checks PS_IF_L interrupt
- *  status.
+ *  This function checks ALS_IF_L interrupt status.
  *
  * @param[out] isDark
  *  Returns true if the ALS value drops below the lower threshold
  *
+ * @note
+ *  See vcnl4040_is_close() for how the flags are cached.
+ *
  * @return
  *  SL_STATUS_OK if there are no errors.
  *  SL_STATUS_TRANSMIT if I2C transmit failed.
@@ -1046,6 +1081,109 @@ sl_status_t vcnl4040_is_interrupt(bool *isLight,
                                   bool *isClose,
                                   bool *isAway);
 
+/***************************************************************************//**
+ * @brief
+ *  This function starts a configuration transaction.
+ *
+ * @details
+ *  The configuration functions always update a shadow of the ALS_CONF,
+ *  PS_CONF1/PS_CONF2 and PS_CONF3/PS_MS registers and write the whole 16-bit
+ *  register, which costs one transfer and no read. Between
+ *  vcnl4040_config_begin() and vcnl4040_config_commit() they only update the
+ *  shadow, and the commit writes each changed register once.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_STATE if a transaction is already started.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_begin(void);
+
+/***************************************************************************//**
+ * @brief
+ *  This function writes the configuration registers changed since
+ *  vcnl4040_config_begin() and ends the transaction.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_STATE if no transaction is started.
+ *  SL_STATUS_TRANSMIT if I2C transmit failed, the registers already written
+ *  are written back and the configuration is left as before the transaction.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_commit(void);
+
+/***************************************************************************//**
+ * @brief
+ *  This function drops the changes made since vcnl4040_config_begin() and
+ *  ends the transaction.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_STATE if no transaction is started.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_abort(void);
+
+/***************************************************************************//**
+ * @brief
+ *  This function reads the proximity, ambient light and white light data in
+ *  one sequence of transfers.
+ *
+ * @param[out] sample
+ *  The data with the sleeptimer tick count of the start of the sequence.
+ *
+ * @param[in] read_flags
+ *  If true, INT_FLAG is read in the same sequence, see vcnl4040_is_close().
+ *
+ * @note
+ *  Channels that are powered off are not read and returned as 0.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_NULL_POINTER if sample is NULL.
+ *  SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vcnl4040_sample(vcnl4040_sample_t *sample, bool read_flags);
+
+/***************************************************************************//**
+ * @brief
+ *  This function starts the interrupt mode. Each falling edge of the INT pin
+ *  set in vcnl4040_config.h makes the next vcnl4040_process_action() read
+ *  INT_FLAG and the data together and pass them to the callback.
+ *
+ * @param[in] callback
+ *  Function pointer that points to the sample callback function, can be NULL.
+ *
+ * @note
+ *  The interrupts themselves are enabled with
+ *  vcnl4040_set_proximity_int_type() and vcnl4040_enable_ambient_interrupts().
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_STATE if the interrupt mode is already started.
+ ******************************************************************************/
+sl_status_t vcnl4040_interrupt_mode_start(vcnl4040_sample_callback_t callback);
+
+/***************************************************************************//**
+ * @brief
+ *  This function stops the interrupt mode.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_INVALID_STATE if the interrupt mode is not started.
+ ******************************************************************************/
+sl_status_t vcnl4040_interrupt_mode_stop(void);
+
+/***************************************************************************//**
+ * @brief
+ *  This function is called in the main application process action sequence
+ *  in interrupt mode. If the INT pin was asserted, it reads INT_FLAG first,
+ *  which releases the pin, then the data, and calls the sample callback.
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors or nothing to read.
+ *  SL_STATUS_TRANSMIT if I2C transmit failed.
+ ******************************************************************************/
+sl_status_t vcnl4040_process_action(void);
+
 /***************************************************************************//**
  * @brief
  *  This function returns the version code of the sensor.
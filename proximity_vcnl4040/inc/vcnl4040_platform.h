@@ -85,6 +85,35 @@ sl_status_t vcnl4040_i2c_read_command(sl_i2cspm_t *i2cspm,
                                       uint8_t command,
                                       uint16_t *data);
 
+/***************************************************************************//**
+ * @brief
+ *  Read several 'command code' locations back to back
+ *
+ * @details
+ *  The device only returns the two bytes of the addressed location per
+ *  read, this schedules one write/read transfer per location without any
+ *  other bus access in between.
+ *
+ * @param[in] commands
+ *  Command code locations
+ *
+ * @param[out] data
+ *  Data read from the registers, one per location
+ *
+ * @param[in] count
+ *  Number of locations
+ *
+ * @return
+ *  SL_STATUS_OK if there are no errors.
+ *  SL_STATUS_TRANSMIT if I2C transmit failed, the following locations are
+ *  not read.
+ ******************************************************************************/
+sl_status_t vcnl4040_i2c_read_commands(sl_i2cspm_t *i2cspm,
+                                       uint8_t address,
+                                       const uint8_t *commands,
+                                       uint16_t *data,
+                                       uint8_t count);
+
 /***************************************************************************//**
  * @brief
  *  Write two consecutive bytes to a given 'command code' location
@@ -38,10 +38,31 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include "em_core.h"
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
+#include "sl_sleeptimer.h"
 #include "vcnl4040_platform.h"
 #include "vcnl4040.h"
+#include "vcnl4040_config.h"
 #include "sl_i2cspm_instances.h"
 
+// -----------------------------------------------------------------------------
+//                       Macros
+// -----------------------------------------------------------------------------
+
+// Shadowed configuration registers
+#define VCNL4040_SHADOW_ALS_CONF      0   // ALS_CONF
+#define VCNL4040_SHADOW_PS_CONF1      1   // PS_CONF1 (lower), PS_CONF2 (upper)
+#define VCNL4040_SHADOW_PS_CONF3      2   // PS_CONF3 (lower), PS_MS (upper)
+#define VCNL4040_SHADOW_COUNT         3
+
+#define VCNL4040_INT_FLAG_ALL         (VCNL4040_INT_FLAG_ALS_LOW    \
+                                       | VCNL4040_INT_FLAG_ALS_HIGH \
+                                       | VCNL4040_INT_FLAG_CLOSE    \
+                                       | VCNL4040_INT_FLAG_AWAY)
+
 // -----------------------------------------------------------------------------
 //                       Local Variables
 // -----------------------------------------------------------------------------
@@ -81,6 +102,40 @@ static SL_VCNL4040_Sensor_Config_TypeDef vcnl4040_cfg = {
 static sl_i2cspm_t *vcnl4040_i2cspm_instance = NULL;
 static bool vcnl4040_is_initialized = false;
 static vcnl4040_norm_interrupt_callback_t vcnl4040_interrupt_callback = NULL;
+
+static const uint8_t vcnl4040_shadow_command[VCNL4040_SHADOW_COUNT] = {
+  VCNL4040_ALS_CONF,
+  VCNL4040_PS_CONF1,
+  VCNL4040_PS_CONF3,
+};
+static uint16_t vcnl4040_shadow[VCNL4040_SHADOW_COUNT];
+static uint16_t vcnl4040_shadow_saved[VCNL4040_SHADOW_COUNT];
+static SL_VCNL4040_Sensor_Config_TypeDef vcnl4040_cfg_saved;
+static uint8_t vcnl4040_shadow_dirty = 0;
+static bool vcnl4040_config_pending = false;
+
+static uint8_t vcnl4040_int_flags = 0;   /* flags read and not reported yet */
+static uint8_t vcnl4040_int_known = 0;   /* flags not reported since the last
+                                            INT_FLAG read */
+
+static vcnl4040_sample_callback_t vcnl4040_sample_callback = NULL;
+static bool vcnl4040_int_mode = false;
+static volatile bool vcnl4040_int_asserted = false;
+static volatile uint32_t vcnl4040_int_timestamp = 0;
+
+// -----------------------------------------------------------------------------
+//                       Local Function Prototypes
+// -----------------------------------------------------------------------------
+
+static sl_status_t vcnl4040_shadow_write(uint8_t command,
+                                         bool command_height,
+                                         uint8_t mask,
+                                         uint8_t data);
+static sl_status_t vcnl4040_read_int_flags(uint8_t *flags);
+static sl_status_t vcnl4040_check_int_flag(uint8_t flag, bool *is_set);
+static sl_status_t vcnl4040_read_sample(vcnl4040_sample_t *sample,
+                                        bool read_flags);
+static void vcnl4040_int_pin_callback(uint8_t pin);
 // -----------------------------------------------------------------------------
 //                       Public Function
 // -----------------------------------------------------------------------------
@@ -110,6 +165,19 @@ sl_status_t vcnl4040_init(sl_i2cspm_t *i2cspm_instance)
     return SL_STATUS_FAIL;
   }
 
+  // Seed the shadow, the registers keep their values over an MCU reset
+  if (vcnl4040_i2c_read_commands(vcnl4040_i2cspm_instance,
+                                 SL_VCNL4040_I2C_BUS_ADDRESS,
+                                 vcnl4040_shadow_command,
+                                 vcnl4040_shadow,
+                                 VCNL4040_SHADOW_COUNT) != SL_STATUS_OK) {
+    return SL_STATUS_FAIL;
+  }
+  vcnl4040_config_pending = false;
+  vcnl4040_int_flags = 0;
+  vcnl4040_int_known = 0;
+
+  vcnl4040_config_begin();
   sc |= vcnl4040_set_ir_led_sink_current(0x7);
   sc |= vcnl4040_set_ir_duty_cycle(0x0);
   sc |= vcnl4040_set_proximity_integration_time(0x7);
@@ -119,6 +187,7 @@ sl_status_t vcnl4040_init(sl_i2cspm_t *i2cspm_instance)
   sc |= vcnl4040_set_ambient_integration_time(0x0);
   sc |= vcnl4040_power_on_ambient(true);
   sc |= vcnl4040_enable_white_channel(true);
+  sc |= vcnl4040_config_commit();
 
   if (sc != SL_STATUS_OK) {
     return SL_STATUS_FAIL;
@@ -133,6 +202,9 @@ sl_status_t vcnl4040_init(sl_i2cspm_t *i2cspm_instance)
  *****************************************************************************/
 sl_status_t vcnl4040_deinit(void)
 {
+  if (vcnl4040_int_mode) {
+    vcnl4040_interrupt_mode_stop();
+  }
   vcnl4040_i2cspm_instance = NULL;
   vcnl4040_is_initialized = false;
 
@@ -178,12 +250,10 @@ sl_status_t vcnl4040_set_ir_duty_cycle(uint8_t duty_value)
   }
   vcnl4040_cfg.PSDuty = duty_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF1,
-                                           LOWER,
-                                           (uint8_t)VCNL4040_PS_DUTY_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF1,
+                               LOWER,
+                               (uint8_t)VCNL4040_PS_DUTY_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -236,12 +306,10 @@ sl_status_t vcnl4040_set_ir_led_sink_current(uint8_t current_value)
   }
   vcnl4040_cfg.IRLEDCurrent = current_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_MS,
-                                           UPPER,
-                                           VCNL4040_LED_I_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_MS,
+                               UPPER,
+                               VCNL4040_LED_I_MASK,
+                               send_data);
 }
 
 /***************************************************************************//**
@@ -282,12 +350,10 @@ sl_status_t vcnl4040_set_proximity_interrupt_persistence(uint8_t pers_value)
   }
   vcnl4040_cfg.PSPersistence = pers_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF1,
-                                           LOWER,
-                                           VCNL4040_PS_PERS_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF1,
+                               LOWER,
+                               VCNL4040_PS_PERS_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -340,12 +406,10 @@ sl_status_t vcnl4040_set_proximity_integration_time(uint8_t time_value)
   }
   vcnl4040_cfg.PSIntegrationTime = time_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_ALS_CONF,
-                                           LOWER,
-                                           VCNL4040_PS_IT_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF1,
+                               LOWER,
+                               VCNL4040_PS_IT_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -375,12 +439,10 @@ sl_status_t vcnl4040_power_on_proximity(bool enable)
   }
   vcnl4040_cfg.PSEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF1,
-                                           LOWER,
-                                           VCNL4040_PS_SD_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF1,
+                               LOWER,
+                               VCNL4040_PS_SD_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -410,12 +472,10 @@ sl_status_t vcnl4040_set_proximity_resolution(uint8_t resolution_value)
   }
   vcnl4040_cfg.PSResolution = resolution_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF2,
-                                           UPPER,
-                                           VCNL4040_PS_HD_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF2,
+                               UPPER,
+                               VCNL4040_PS_HD_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -456,12 +516,10 @@ sl_status_t vcnl4040_set_proximity_int_type(uint8_t interrupt_value)
   }
   vcnl4040_cfg.PSInterruptType = interrupt_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF2,
-                                           UPPER,
-                                           VCNL4040_PS_INT_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF2,
+                               UPPER,
+                               VCNL4040_PS_INT_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -491,12 +549,10 @@ sl_status_t vcnl4040_enable_smart_persistence(bool enable)
   }
   vcnl4040_cfg.PSSmartPersEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF3,
-                                           LOWER,
-                                           VCNL4040_PS_SMART_PERS_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF3,
+                               LOWER,
+                               VCNL4040_PS_SMART_PERS_MASK,
+                               send_data);
 }
 
 /***************************************************************************//**
@@ -525,12 +581,10 @@ sl_status_t vcnl4040_enable_active_force_mode(bool enable)
   }
   vcnl4040_cfg.PSActiveForceEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF3,
-                                           LOWER,
-                                           VCNL4040_PS_AF_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_CONF3,
+                               LOWER,
+                               VCNL4040_PS_AF_MASK,
+                               send_data);
 }
 
 /***************************************************************************//**
@@ -551,12 +605,16 @@ sl_status_t vcnl4040_get_active_force_mode_enabled(bool *enabled)
  ******************************************************************************/
 sl_status_t vcnl4040_trigger_proximity_measurement(void)
 {
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_CONF3,
-                                           LOWER,
-                                           VCNL4040_PS_TRIG_MASK,
-                                           VCNL4040_PS_TRIG_TRIGGER);
+  uint16_t value;
+
+  // PS_TRIG clears itself, it is not kept in the shadow
+  value = vcnl4040_config_pending ? vcnl4040_shadow_saved[VCNL4040_SHADOW_PS_CONF3]
+          : vcnl4040_shadow[VCNL4040_SHADOW_PS_CONF3];
+
+  return vcnl4040_i2c_write_command(vcnl4040_i2cspm_instance,
+                                    SL_VCNL4040_I2C_BUS_ADDRESS,
+                                    VCNL4040_PS_CONF3,
+                                    value | VCNL4040_PS_TRIG_TRIGGER);
 }
 
 /***************************************************************************//**
@@ -572,12 +630,10 @@ sl_status_t vcnl4040_enable_proximity_logic_mode(bool enable)
   }
   vcnl4040_cfg.PSLogicEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_MS,
-                                           UPPER,
-                                           VCNL4040_PS_MS_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_MS,
+                               UPPER,
+                               VCNL4040_PS_MS_MASK,
+                               send_data);
 }
 
 /***************************************************************************//**
@@ -686,43 +742,25 @@ sl_status_t vcnl4040_get_proximity(uint16_t *proximity_data)
 }
 
 /***************************************************************************//**
- *  Reads the interrupt flag and checks PS_IF_CLOSE interrupt status.
+ *  Checks PS_IF_CLOSE interrupt status.
  ******************************************************************************/
 sl_status_t vcnl4040_is_close(bool *is_close)
 {
-  uint8_t data;
-  sl_status_t ret;
-
   if (is_close == NULL) {
     return SL_STATUS_NULL_POINTER;
   }
-  ret = vcnl4040_i2c_read_command_upper(vcnl4040_i2cspm_instance,
-                                        SL_VCNL4040_I2C_BUS_ADDRESS,
-                                        VCNL4040_INT_FLAG,
-                                        &data);
-  *is_close = (bool)(data & VCNL4040_INT_FLAG_CLOSE);
-
-  return ret;
+  return vcnl4040_check_int_flag(VCNL4040_INT_FLAG_CLOSE, is_close);
 }
 
 /***************************************************************************//**
- *  Reads the interrupt flag and checks PS_IF_AWAY interrupt status.
+ *  Checks PS_IF_AWAY interrupt status.
  ******************************************************************************/
 sl_status_t vcnl4040_is_away(bool *is_away)
 {
-  uint8_t data;
-  sl_status_t ret;
-
   if (is_away == NULL) {
     return SL_STATUS_NULL_POINTER;
   }
-  ret = vcnl4040_i2c_read_command_upper(vcnl4040_i2cspm_instance,
-                                        SL_VCNL4040_I2C_BUS_ADDRESS,
-                                        VCNL4040_INT_FLAG,
-                                        &data);
-  *is_away = (bool)(data & VCNL4040_INT_FLAG_AWAY);
-
-  return ret;
+  return vcnl4040_check_int_flag(VCNL4040_INT_FLAG_AWAY, is_away);
 }
 
 /**************************************************************************//**
@@ -750,12 +788,10 @@ sl_status_t vcnl4040_set_ambient_interrupt_persistence(uint8_t pers_value)
   }
   vcnl4040_cfg.ALSPersistence = pers_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_ALS_CONF,
-                                           LOWER,
-                                           VCNL4040_ALS_PERS_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_ALS_CONF,
+                               LOWER,
+                               VCNL4040_ALS_PERS_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -785,12 +821,10 @@ sl_status_t vcnl4040_enable_ambient_interrupts(bool enable)
   }
   vcnl4040_cfg.ALSIntEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_ALS_CONF,
-                                           LOWER,
-                                           VCNL4040_ALS_INT_EN_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_ALS_CONF,
+                               LOWER,
+                               VCNL4040_ALS_INT_EN_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -820,12 +854,10 @@ sl_status_t vcnl4040_power_on_ambient(bool enable)
   }
   vcnl4040_cfg.ALSEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_ALS_CONF,
-                                           LOWER,
-                                           VCNL4040_ALS_SD_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_ALS_CONF,
+                               LOWER,
+                               VCNL4040_ALS_SD_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -866,12 +898,10 @@ sl_status_t vcnl4040_set_ambient_integration_time(uint8_t time_value)
   }
   vcnl4040_cfg.ALSIntegrationTime = time_value;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_ALS_CONF,
-                                           LOWER,
-                                           (uint8_t)VCNL4040_ALS_IT_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_ALS_CONF,
+                               LOWER,
+                               (uint8_t)VCNL4040_ALS_IT_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -967,12 +997,10 @@ sl_status_t vcnl4040_enable_white_channel(bool enable)
   }
   vcnl4040_cfg.WhiteEnabled = enable;
 
-  return vcnl4040_i2c_masked_write_command(vcnl4040_i2cspm_instance,
-                                           SL_VCNL4040_I2C_BUS_ADDRESS,
-                                           VCNL4040_PS_MS,
-                                           UPPER,
-                                           (uint8_t)VCNL4040_WHITE_EN_MASK,
-                                           send_data);
+  return vcnl4040_shadow_write(VCNL4040_PS_MS,
+                               UPPER,
+                               (uint8_t)VCNL4040_WHITE_EN_MASK,
+                               send_data);
 }
 
 /**************************************************************************//**
@@ -983,7 +1011,7 @@ sl_status_t vcnl4040_get_white_channel_enabled(bool *enable)
   if (enable == NULL) {
     return SL_STATUS_NULL_POINTER;
   }
-  *enable = vcnl4040_cfg.ALSEnabled;
+  *enable = vcnl4040_cfg.WhiteEnabled;
 
   return SL_STATUS_OK;
 }
@@ -1003,43 +1031,25 @@ sl_status_t vcnl4040_get_white(uint16_t *white_data)
 }
 
 /***************************************************************************//**
- *  Reads the interrupt flag and checks PS_IF_H interrupt status.
+ *  Checks ALS_IF_H interrupt status.
  ******************************************************************************/
 sl_status_t vcnl4040_is_light(bool *is_light)
 {
-  uint8_t data;
-  sl_status_t ret;
-
   if (is_light == NULL) {
     return SL_STATUS_NULL_POINTER;
   }
-  ret = vcnl4040_i2c_read_command_upper(vcnl4040_i2cspm_instance,
-                                        SL_VCNL4040_I2C_BUS_ADDRESS,
-                                        VCNL4040_INT_FLAG,
-                                        &data);
-  *is_light = data & VCNL4040_INT_FLAG_ALS_HIGH;
-
-  return ret;
+  return vcnl4040_check_int_flag(VCNL4040_INT_FLAG_ALS_HIGH, is_light);
 }
 
 /***************************************************************************//**
- *  Reads the interrupt flag and checks PS_IF_L interrupt status.
+ *  Checks ALS_IF_L interrupt status.
  ******************************************************************************/
 sl_status_t vcnl4040_is_dark(bool *is_dark)
 {
-  uint8_t data;
-  sl_status_t ret;
-
   if (is_dark == NULL) {
     return SL_STATUS_NULL_POINTER;
   }
-  ret = vcnl4040_i2c_read_command_upper(vcnl4040_i2cspm_instance,
-                                        SL_VCNL4040_I2C_BUS_ADDRESS,
-                                        VCNL4040_INT_FLAG,
-                                        &data);
-  *is_dark = data & VCNL4040_INT_FLAG_ALS_LOW;
-
-  return ret;
+  return vcnl4040_check_int_flag(VCNL4040_INT_FLAG_ALS_LOW, is_dark);
 }
 
 /***************************************************************************//**
@@ -1067,10 +1077,15 @@ sl_status_t vcnl4040_is_interrupt(bool *is_light,
   sl_status_t ret;
   uint8_t data;
 
-  ret = vcnl4040_i2c_read_command_upper(vcnl4040_i2cspm_instance,
-                                        SL_VCNL4040_I2C_BUS_ADDRESS,
-                                        VCNL4040_INT_FLAG,
-                                        &data);
+  ret = vcnl4040_read_int_flags(&data);
+  if (ret != SL_STATUS_OK) {
+    return ret;
+  }
+  // Also report the flags kept from earlier reads
+  data = vcnl4040_int_flags;
+  vcnl4040_int_flags = 0;
+  vcnl4040_int_known = 0;
+
   if (data & VCNL4040_INT_AWAY_MASK) {
     *is_away = true;
     irq_source = INT_AWAY;
@@ -1094,6 +1109,176 @@ sl_status_t vcnl4040_is_interrupt(bool *is_light,
   return ret;
 }
 
+/***************************************************************************//**
+ *  Starts a configuration transaction.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_begin(void)
+{
+  if (vcnl4040_config_pending) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  memcpy(vcnl4040_shadow_saved, vcnl4040_shadow, sizeof(vcnl4040_shadow));
+  vcnl4040_cfg_saved = vcnl4040_cfg;
+  vcnl4040_shadow_dirty = 0;
+  vcnl4040_config_pending = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Writes the changed configuration registers and ends the transaction.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_commit(void)
+{
+  uint8_t i, j;
+
+  if (!vcnl4040_config_pending) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  vcnl4040_config_pending = false;
+
+  for (i = 0; i < VCNL4040_SHADOW_COUNT; i++) {
+    if ((vcnl4040_shadow_dirty & (1 << i)) == 0) {
+      continue;
+    }
+    if (vcnl4040_i2c_write_command(vcnl4040_i2cspm_instance,
+                                   SL_VCNL4040_I2C_BUS_ADDRESS,
+                                   vcnl4040_shadow_command[i],
+                                   vcnl4040_shadow[i]) != SL_STATUS_OK) {
+      // Put back the registers already written so that the device, the
+      // shadow and the settings all hold the configuration before the
+      // transaction, as after vcnl4040_config_abort()
+      for (j = 0; j < i; j++) {
+        if (vcnl4040_shadow_dirty & (1 << j)) {
+          vcnl4040_i2c_write_command(vcnl4040_i2cspm_instance,
+                                     SL_VCNL4040_I2C_BUS_ADDRESS,
+                                     vcnl4040_shadow_command[j],
+                                     vcnl4040_shadow_saved[j]);
+        }
+      }
+      memcpy(vcnl4040_shadow, vcnl4040_shadow_saved, sizeof(vcnl4040_shadow));
+      vcnl4040_cfg = vcnl4040_cfg_saved;
+      return SL_STATUS_TRANSMIT;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Drops the configuration changes and ends the transaction.
+ ******************************************************************************/
+sl_status_t vcnl4040_config_abort(void)
+{
+  if (!vcnl4040_config_pending) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  memcpy(vcnl4040_shadow, vcnl4040_shadow_saved, sizeof(vcnl4040_shadow));
+  vcnl4040_cfg = vcnl4040_cfg_saved;
+  vcnl4040_config_pending = false;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Reads the proximity, ambient and white data in one sequence.
+ ******************************************************************************/
+sl_status_t vcnl4040_sample(vcnl4040_sample_t *sample, bool read_flags)
+{
+  if (sample == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  sample->timestamp = sl_sleeptimer_get_tick_count();
+
+  return vcnl4040_read_sample(sample, read_flags);
+}
+
+/***************************************************************************//**
+ *  Starts the interrupt mode.
+ ******************************************************************************/
+sl_status_t vcnl4040_interrupt_mode_start(vcnl4040_sample_callback_t callback)
+{
+  if (vcnl4040_int_mode) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  vcnl4040_sample_callback = callback;
+
+  // INT is an open drain output, active low
+  GPIOINT_Init();
+  GPIO_PinModeSet(SL_VCNL4040_CONFIG_INT_PORT,
+                  SL_VCNL4040_CONFIG_INT_PIN,
+                  gpioModeInputPullFilter,
+                  1);
+  GPIOINT_CallbackRegister(SL_VCNL4040_CONFIG_INT_PIN,
+                           vcnl4040_int_pin_callback);
+  GPIO_ExtIntConfig(SL_VCNL4040_CONFIG_INT_PORT,
+                    SL_VCNL4040_CONFIG_INT_PIN,
+                    SL_VCNL4040_CONFIG_INT_PIN,
+                    false,
+                    true,
+                    true);
+  vcnl4040_int_mode = true;
+
+  // The pin stays low until INT_FLAG is read, an interrupt raised before
+  // the pin was armed would never give an edge
+  vcnl4040_int_timestamp = sl_sleeptimer_get_tick_count();
+  vcnl4040_int_asserted = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Stops the interrupt mode.
+ ******************************************************************************/
+sl_status_t vcnl4040_interrupt_mode_stop(void)
+{
+  if (!vcnl4040_int_mode) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  GPIO_ExtIntConfig(SL_VCNL4040_CONFIG_INT_PORT,
+                    SL_VCNL4040_CONFIG_INT_PIN,
+                    SL_VCNL4040_CONFIG_INT_PIN,
+                    false,
+                    false,
+                    false);
+  vcnl4040_int_mode = false;
+  vcnl4040_int_asserted = false;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Reads INT_FLAG and the data after an INT edge in interrupt mode.
+ ******************************************************************************/
+sl_status_t vcnl4040_process_action(void)
+{
+  vcnl4040_sample_t sample;
+  bool asserted;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  asserted = vcnl4040_int_asserted;
+  vcnl4040_int_asserted = false;
+  sample.timestamp = vcnl4040_int_timestamp;
+  CORE_EXIT_ATOMIC();
+
+  if (!asserted) {
+    return SL_STATUS_OK;
+  }
+
+  if (vcnl4040_read_sample(&sample, true) != SL_STATUS_OK) {
+    // The pin is still low, retry on the next call
+    vcnl4040_int_asserted = vcnl4040_int_mode;
+    return SL_STATUS_TRANSMIT;
+  }
+
+  if (vcnl4040_sample_callback != NULL) {
+    vcnl4040_sample_callback(&sample);
+  }
+
+  return SL_STATUS_OK;
+}
+
 /***************************************************************************//**
  *  Gets the version code of the sensor.
  ******************************************************************************/
@@ -1110,3 +1295,181 @@ sl_status_t vcnl4040_get_core_version(sl_vcnl4040_core_version_t *version)
 
   return SL_STATUS_OK;
 }
+
+// -----------------------------------------------------------------------------
+//                       Local Functions
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ *  Updates a byte of a shadowed register and writes the whole register,
+ *  or only marks it for vcnl4040_config_commit() in a transaction.
+ ******************************************************************************/
+static sl_status_t vcnl4040_shadow_write(uint8_t command,
+                                         bool command_height,
+                                         uint8_t mask,
+                                         uint8_t data)
+{
+  uint16_t previous;
+  uint16_t value;
+  uint8_t index;
+  sl_status_t ret;
+
+  switch (command) {
+  case VCNL4040_ALS_CONF:
+    index = VCNL4040_SHADOW_ALS_CONF;
+    break;
+  case VCNL4040_PS_CONF1:
+    index = VCNL4040_SHADOW_PS_CONF1;
+    break;
+  case VCNL4040_PS_CONF3:
+    index = VCNL4040_SHADOW_PS_CONF3;
+    break;
+  default:
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  previous = vcnl4040_shadow[index];
+  if (command_height == LOWER) {
+    value = (uint16_t)((previous & (0xFF00 | mask)) | data);
+  } else {
+    value = (uint16_t)((previous & (0x00FF | ((uint16_t)mask << 8)))
+                       | ((uint16_t)data << 8));
+  }
+  vcnl4040_shadow[index] = value;
+
+  if (vcnl4040_config_pending) {
+    vcnl4040_shadow_dirty |= (uint8_t)(1 << index);
+    return SL_STATUS_OK;
+  }
+
+  ret = vcnl4040_i2c_write_command(vcnl4040_i2cspm_instance,
+                                   SL_VCNL4040_I2C_BUS_ADDRESS,
+                                   command,
+                                   value);
+  if (ret != SL_STATUS_OK) {
+    vcnl4040_shadow[index] = previous;
+  }
+
+  return ret;
+}
+
+/***************************************************************************//**
+ *  Reads INT_FLAG, which clears it, and keeps the flags until reported.
+ ******************************************************************************/
+static sl_status_t vcnl4040_read_int_flags(uint8_t *flags)
+{
+  uint16_t data;
+  sl_status_t ret;
+
+  ret = vcnl4040_i2c_read_command(vcnl4040_i2cspm_instance,
+                                  SL_VCNL4040_I2C_BUS_ADDRESS,
+                                  VCNL4040_INT_FLAG,
+                                  &data);
+  if (ret != SL_STATUS_OK) {
+    return ret;
+  }
+  *flags = (uint8_t)(data >> 8);
+  vcnl4040_int_flags |= *flags;
+  vcnl4040_int_known = VCNL4040_INT_FLAG_ALL;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Reports and clears a kept interrupt flag, reading INT_FLAG only if the
+ *  flag was already reported since the last read.
+ ******************************************************************************/
+static sl_status_t vcnl4040_check_int_flag(uint8_t flag, bool *is_set)
+{
+  uint8_t flags;
+  sl_status_t ret;
+
+  if ((vcnl4040_int_known & flag) == 0) {
+    ret = vcnl4040_read_int_flags(&flags);
+    if (ret != SL_STATUS_OK) {
+      *is_set = false;
+      return ret;
+    }
+  }
+  *is_set = (vcnl4040_int_flags & flag) != 0;
+  vcnl4040_int_flags &= (uint8_t)~flag;
+  vcnl4040_int_known &= (uint8_t)~flag;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  Reads INT_FLAG if requested, then the data of the enabled channels, in
+ *  one sequence. The timestamp is left to the caller.
+ ******************************************************************************/
+static sl_status_t vcnl4040_read_sample(vcnl4040_sample_t *sample,
+                                        bool read_flags)
+{
+  uint8_t commands[3];
+  uint16_t data[3];
+  uint8_t count = 0;
+  uint8_t i;
+  bool als_on;
+
+  sample->proximity = 0;
+  sample->ambient = 0;
+  sample->white = 0;
+  sample->int_flags = 0;
+
+  // INT_FLAG first, reading it releases the INT pin. The flags are kept
+  // even if reading the data fails.
+  if (read_flags
+      && (vcnl4040_read_int_flags(&sample->int_flags) != SL_STATUS_OK)) {
+    return SL_STATUS_TRANSMIT;
+  }
+  if ((vcnl4040_shadow[VCNL4040_SHADOW_PS_CONF1]
+       & VCNL4040_PS_SD_POWER_OFF) == 0) {
+    commands[count++] = VCNL4040_PS_DATA;
+  }
+  als_on = (vcnl4040_shadow[VCNL4040_SHADOW_ALS_CONF]
+            & VCNL4040_ALS_SD_POWER_OFF) == 0;
+  if (als_on) {
+    commands[count++] = VCNL4040_ALS_DATA;
+  }
+  if (als_on && ((vcnl4040_shadow[VCNL4040_SHADOW_PS_CONF3]
+                  & (VCNL4040_WHITE_DISABLE << 8)) == 0)) {
+    commands[count++] = VCNL4040_WHITE_DATA;
+  }
+
+  if (vcnl4040_i2c_read_commands(vcnl4040_i2cspm_instance,
+                                 SL_VCNL4040_I2C_BUS_ADDRESS,
+                                 commands,
+                                 data,
+                                 count) != SL_STATUS_OK) {
+    return SL_STATUS_TRANSMIT;
+  }
+
+  for (i = 0; i < count; i++) {
+    switch (commands[i]) {
+    case VCNL4040_PS_DATA:
+      sample->proximity = data[i];
+      break;
+    case VCNL4040_ALS_DATA:
+      sample->ambient = data[i];
+      break;
+    default:
+      sample->white = data[i];
+      break;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *  INT pin callback, only notes the edge for vcnl4040_process_action().
+ *
+ * @note This function is called from ISR context.
+ ******************************************************************************/
+static void vcnl4040_int_pin_callback(uint8_t pin)
+{
+  (void)pin;
+
+  vcnl4040_int_timestamp = sl_sleeptimer_get_tick_count();
+  vcnl4040_int_asserted = true;
+}
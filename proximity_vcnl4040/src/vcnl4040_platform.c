@@ -69,6 +69,25 @@ sl_status_t vcnl4040_i2c_read_command(sl_i2cspm_t *i2cspm,
   return ret;
 }
 
+/***************************************************************************//**
+ *  Read several 'command code' locations back to back
+ ******************************************************************************/
+sl_status_t vcnl4040_i2c_read_commands(sl_i2cspm_t *i2cspm,
+                                       uint8_t address,
+                                       const uint8_t *commands,
+                                       uint16_t *data,
+                                       uint8_t count)
+{
+  sl_status_t ret = SL_STATUS_OK;
+  uint8_t i;
+
+  for (i = 0; (i < count) && (ret == SL_STATUS_OK); i++) {
+    ret = vcnl4040_i2c_read_command(i2cspm, address, commands[i], &data[i]);
+  }
+
+  return ret;
+}
+
 /***************************************************************************//**
  *  Write two consecutive bytes to a given 'command code' location
  ******************************************************************************/
@@ -194,7 +213,8 @@ sl_status_t vcnl4040_i2c_masked_write_command(sl_i2cspm_t *i2cspm,
     }
     reg_value &= mask;
     reg_value |= data;
-    ret = vcnl4040_i2c_write_command_lower(i2cspm, address, command, data);
+    ret = vcnl4040_i2c_write_command_lower(i2cspm, address, command,
+                                           reg_value);
 
     return ret;
   } else {
@@ -204,7 +224,8 @@ sl_status_t vcnl4040_i2c_masked_write_command(sl_i2cspm_t *i2cspm,
     }
     reg_value &= mask;
     reg_value |= data;
-    ret = vcnl4040_i2c_write_command_upper(i2cspm, address, command, data);
+    ret = vcnl4040_i2c_write_command_upper(i2cspm, address, command,
+                                           reg_value);
 
     return ret;
   }
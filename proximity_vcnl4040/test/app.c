@@ -73,21 +73,17 @@ static void timer_callback(sl_simple_timer_t *timer, void *data)
   (void)&timer;
   (void)&data;
 
-  uint16_t prox;
-  uint16_t ambient;
-  uint16_t white;
+  vcnl4040_sample_t sample;
 
-  sc |= vcnl4040_get_proximity(&prox);
-  sc |= vcnl4040_get_ambient(&ambient);
-  sc |= vcnl4040_get_white(&white);
+  sc = vcnl4040_sample(&sample, false);
 
   if (sc != SL_STATUS_OK) {
     app_log("\r > Reading data failed\n");
   } else {
     app_log(
       "\r > Proximity value: % 4d\tAmbient light value: % 4d\tWhite light value: % 4d\n",
-      prox,
-      ambient,
-      white);
+      sample.proximity,
+      sample.ambient,
+      sample.white);
   }
 }
@@ -52,6 +52,8 @@ extern "C" {
 
 #define RFID_UID_LEN    10      // 10 ASCII defined by the datasheet
 #define RFID_PACKET_LEN 14      // [DATA(10) + CHECKSUM(2) + CR(1) + LF(1)] = 14
+#define RFID_FRAME_LEN  16      // [STX(1) + PACKET(14) + ETX(1)] = 16
+#define RFID_RX_BUFFER_SIZE 64  // room for a burst of 3 frames
 
 #define PACKET_START    0x02
 #define PACKET_END      0x03
@@ -62,16 +64,16 @@ typedef struct {
 } rfid_uid_t;
 
 typedef struct {
-  char      *rx_buffer_ptr;     // pointer to static buffer
-  uint16_t   rx_buffer_size;    // size of buffer
+  char      *rx_buffer_ptr;     // pointer to static buffer used as RX ring
+  uint16_t   rx_buffer_size;    // size of buffer, more than RFID_FRAME_LEN
 } rfid_init_t;
 
-#define RFID_DECLARE_RX_BUFFER    static char rfid_rx_buffer[RFID_PACKET_LEN]
+#define RFID_DECLARE_RX_BUFFER    static char rfid_rx_buffer[RFID_RX_BUFFER_SIZE]
 
 #define RFID_INIT_DEFAULT                                                      \
 {                                                                              \
   rfid_rx_buffer,                                                              \
-  RFID_PACKET_LEN                                                              \
+  RFID_RX_BUFFER_SIZE                                                          \
 }
 
 /***************************************************************************//**
@@ -88,13 +90,29 @@ sl_status_t rfid_init(rfid_init_t *init);
 
 /***************************************************************************//**
  * @brief
- *    Process complete & valid packet reception
+ *    Decode the received chars up to the end of the next packet
+ *
+ * @note
+ *    The RX interrupt only stores the chars in the ring. Returns after each
+ *    completed packet, so that every card read in a burst is reported. Call
+ *    again until SL_STATUS_IS_WAITING is returned.
  *
  * @return
- *    sl_status_t
+ *    SL_STATUS_OK if a valid packet was received,
+ *    SL_STATUS_INVALID_COUNT if a packet with a wrong length or checksum was
+ *    received, SL_STATUS_IS_WAITING if the ring is empty
  ******************************************************************************/
 sl_status_t rfid_process_action(void);
 
+/***************************************************************************//**
+ * @brief
+ *    Get the number of chars dropped because the RX ring was full
+ *
+ * @return
+ *    Number of dropped chars since rfid_init()
+ ******************************************************************************/
+uint32_t rfid_get_overrun_count(void);
+
 /***************************************************************************//**
  * @brief
  *    Get the last read card UID
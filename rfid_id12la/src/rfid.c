@@ -52,14 +52,17 @@
 
 
 typedef struct {
-  volatile char     *rx_buffer_ptr;     // Pointer to store the received data
-  volatile uint16_t rx_buffer_idx;      // Index to place next received char
-  uint16_t          rx_buffer_size;     // Max size of the receive buffer
-  volatile bool     rx_is_complete;     // Indicator that a full packet has
-                                        //    been received
-  volatile bool     rx_is_processed;    // Indicator that the received packet
-                                        //    has been processed by the
-                                        //    application
+  volatile char     *rx_buffer_ptr;     // Ring of received chars
+  uint16_t          rx_buffer_size;     // Size of the ring
+  volatile uint16_t rx_head;            // Index to place next received char,
+                                        //    written by the ISR only
+  volatile uint16_t rx_tail;            // Index of next char to decode,
+                                        //    written by the thread only
+  volatile uint32_t rx_overruns;        // Chars dropped on a full ring
+
+  char              frame[RFID_PACKET_LEN]; // Packet being decoded
+  uint16_t          frame_idx;          // Chars of the packet so far
+  bool              in_frame;           // A start of packet was received
 
   rfid_uid_t        latest_data;        // The UID of the last card scanned
 } rfid_handle_t;
@@ -129,24 +132,26 @@ static void gpio_init(void)
  ******************************************************************************/
 sl_status_t rfid_init(rfid_init_t *init)
 {
-  // ensure that buffer size is correct and ptr is not NULL
-  if(init->rx_buffer_size < RFID_PACKET_LEN || init->rx_buffer_ptr == NULL) {
+  // ensure that a full frame fits the ring and ptr is not NULL
+  if(init->rx_buffer_size <= RFID_FRAME_LEN || init->rx_buffer_ptr == NULL) {
       return SL_STATUS_INVALID_PARAMETER;
   }
 
+  // setup handle before the RX interrupt is enabled
+  handle.rx_buffer_ptr    = init->rx_buffer_ptr;
+  handle.rx_buffer_size   = init->rx_buffer_size;
+  handle.rx_head          = 0;
+  handle.rx_tail          = 0;
+  handle.rx_overruns      = 0;
+  handle.frame_idx        = 0;
+  handle.in_frame         = false;
+
   // initialize GPIO
   gpio_init();
 
   // initialize EUART
   euart_init();
 
-  // setup handle
-  handle.rx_buffer_ptr    = init->rx_buffer_ptr;
-  handle.rx_buffer_size   = init->rx_buffer_size;
-  handle.rx_buffer_idx    = 0;
-  handle.rx_is_complete   = false;
-  handle.rx_is_processed  = false;
-
   return SL_STATUS_OK;
 }
 
@@ -181,44 +186,6 @@ static sl_status_t rfid_format(char *rfid_packet, rfid_uid_t *rfid)
 }
 
 
-/***************************************************************************//**
- * @brief
- *    Handle new UART char
- *
- * @param[in]  rfid_char
- *    Received UART char to process
- ******************************************************************************/
-static void process_char(char rfid_char)
-{
-  // is_data_valid is set to true when a start of packet frame has been received
-  //  and is set to false when the end of packet frame is received
-  static bool is_data_valid = false;
-
-  // a start of frame has been received, store incoming char until end of packet
-  if(is_data_valid && !(rfid_char == PACKET_START)) {
-      // check for overflow
-      if(handle.rx_buffer_idx < handle.rx_buffer_size + 1) {
-          // check if packet is complete
-          if(rfid_char == PACKET_END) {
-              handle.rx_is_processed  = false;
-              handle.rx_is_complete   = true;
-              handle.rx_buffer_idx    = 0;
-              is_data_valid           = false;
-          } else {
-              // store char into buffer
-              handle.rx_buffer_ptr[handle.rx_buffer_idx++] = rfid_char;
-              handle.rx_is_complete = false;
-          }
-      }
-  } else if(rfid_char == PACKET_START) {
-      // set incoming data as valid
-      is_data_valid = true;
-      // reset rx buffer index
-      handle.rx_buffer_idx = 0;
-  }
-}
-
-
 /***************************************************************************//**
  * @brief
  *    Convert ASCII to decimal representation
@@ -246,57 +213,129 @@ static int8_t ascii_to_int(char ch)
  * @return
  *    true if checksum matches calculated
  ******************************************************************************/
-static bool is_valid_checksum(volatile char* rfid_packet)
+static bool is_valid_checksum(const char* rfid_packet)
 {
+  int8_t digit[RFID_UID_LEN + 2];
+
+  // every char of the UID and the checksum is a hex digit
+  for(uint8_t index = 0; index < RFID_UID_LEN + 2; index++) {
+      digit[index] = ascii_to_int(rfid_packet[index]);
+      if(digit[index] < 0) {
+          return false;
+      }
+  }
+
   // get checksum sent in packet
-  uint16_t checksum = ascii_to_int(rfid_packet[10]) << 8 | ascii_to_int(rfid_packet[11]);
+  uint8_t checksum = (uint8_t)(digit[RFID_UID_LEN] << 4 | digit[RFID_UID_LEN + 1]);
 
   // placeholder for calculated checksum
-  uint16_t calc = 0;
-  for(uint8_t index = 0; index < RFID_UID_LEN;) {
+  uint8_t calc = 0;
+  for(uint8_t index = 0; index < RFID_UID_LEN; index += 2) {
       // calculate the xor checksum from the card_uid received in packet
-      calc ^= ascii_to_int(rfid_packet[index]) << 8 | ascii_to_int(rfid_packet[index+1]);
-
-      index = index + 2;
+      calc ^= (uint8_t)(digit[index] << 4 | digit[index + 1]);
   }
 
   // ensure calculated checksum matches checksum set in packet
-  if(calc != checksum) {
-      return false;
-  }
-
-  return true;
+  return calc == checksum;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Process complete & valid packet reception
+ *    Decode a received char
+ *
+ * @param[in]  rfid_char
+ *    Received char
  *
  * @return
- *    sl_status_t
+ *    SL_STATUS_OK if a valid packet was completed,
+ *    SL_STATUS_INVALID_COUNT if a packet with a wrong length or checksum was
+ *    completed, SL_STATUS_IS_WAITING otherwise
  ******************************************************************************/
-sl_status_t rfid_process_action(void)
+static sl_status_t decode_char(char rfid_char)
 {
-  // check to see if there is data to process
-  if(!handle.rx_is_processed & handle.rx_is_complete) {
-      handle.rx_is_processed = true;
-      handle.rx_is_complete = false;
+  if(rfid_char == PACKET_START) {
+      // a new packet starts, drop any partial one
+      handle.in_frame   = true;
+      handle.frame_idx  = 0;
+      return SL_STATUS_IS_WAITING;
+  }
+
+  if(!handle.in_frame) {
+      return SL_STATUS_IS_WAITING;
+  }
 
-      // validate checksum
-      if(!is_valid_checksum(handle.rx_buffer_ptr)) {
+  if(rfid_char == PACKET_END) {
+      handle.in_frame = false;
+
+      // chars lost on a ring overrun show up as a short packet
+      if(handle.frame_idx != RFID_PACKET_LEN
+         || !is_valid_checksum(handle.frame)) {
           handle.latest_data.valid = false;
           return SL_STATUS_INVALID_COUNT;
       }
 
       // copy card_uid from packet to handle card_uid
-      return rfid_format((char *)handle.rx_buffer_ptr, &handle.latest_data);
+      return rfid_format(handle.frame, &handle.latest_data);
+  }
+
+  if(handle.frame_idx >= RFID_PACKET_LEN) {
+      // end of packet missing
+      handle.in_frame = false;
+      handle.latest_data.valid = false;
+      return SL_STATUS_INVALID_COUNT;
+  }
+
+  handle.frame[handle.frame_idx++] = rfid_char;
+  return SL_STATUS_IS_WAITING;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Decode the received chars up to the end of the next packet
+ *
+ * @note
+ *    Returns after each completed packet, so that every card read in a burst
+ *    is reported. Call again until SL_STATUS_IS_WAITING is returned.
+ *
+ * @return
+ *    SL_STATUS_OK if a valid packet was received,
+ *    SL_STATUS_INVALID_COUNT if a packet with a wrong length or checksum was
+ *    received, SL_STATUS_IS_WAITING if the ring is empty
+ ******************************************************************************/
+sl_status_t rfid_process_action(void)
+{
+  sl_status_t status;
+  uint16_t tail = handle.rx_tail;
+
+  while(tail != handle.rx_head) {
+      char rfid_char = handle.rx_buffer_ptr[tail];
+      if(++tail == handle.rx_buffer_size) {
+          tail = 0;
+      }
+      handle.rx_tail = tail;
+
+      status = decode_char(rfid_char);
+      if(status != SL_STATUS_IS_WAITING) {
+          return status;
+      }
   }
 
   return SL_STATUS_IS_WAITING;
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *    Get the number of chars dropped because the ring was full
+ ******************************************************************************/
+uint32_t rfid_get_overrun_count(void)
+{
+  return handle.rx_overruns;
+}
+
+
 /***************************************************************************//**
  * @brief
  *    Get the last read card UID
@@ -330,9 +369,21 @@ void EUART0_RX_IRQHandler(void)
   // get set flags
   uint32_t flags = EUSART_IntGet(EUART0);
 
-  // process received char
+  // push every char of the FIFO into the ring, decoding is done by
+  //  rfid_process_action()
   if(flags & EUSART_IF_RXFLIF) {
-      process_char((char)(EUART0->RXDATA));
+      while(EUART0->STATUS & EUSART_STATUS_RXFL) {
+          char rfid_char = (char)(EUART0->RXDATA);
+          uint16_t head = handle.rx_head;
+          uint16_t next = (head + 1 == handle.rx_buffer_size) ? 0 : head + 1;
+
+          if(next == handle.rx_tail) {
+              handle.rx_overruns++;
+          } else {
+              handle.rx_buffer_ptr[head] = rfid_char;
+              handle.rx_head = next;
+          }
+      }
   }
 
   // clear flags
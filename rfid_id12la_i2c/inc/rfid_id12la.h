@@ -106,6 +106,33 @@ typedef struct {
   id12la_tag_t id12la_data[ID12LA_MAX_STORAGE_TAG];
 } id12la_tag_list_t;
 
+/* Reader array */
+#define ID12LA_ARRAY_MAX_READERS    8
+#define ID12LA_ARRAY_HISTORY_SIZE   4     // tags remembered per reader
+#define ID12LA_READ_INTERVAL_MS     20    // between two reads of a reader
+#define ID12LA_ERROR_BACKOFF_MS     1000  // before retrying a failed reader
+
+/* Called from id12la_array_process() for each new tag */
+typedef void (*id12la_tag_callback_t)(uint8_t reader, const id12la_tag_t *tag);
+
+typedef struct {
+  sl_i2cspm_t *i2cspm;                  // I2C peripheral of the readers
+  const uint8_t *addresses;             // I2C address of each reader
+  uint8_t reader_count;                 // up to ID12LA_ARRAY_MAX_READERS
+  uint16_t duplicate_window_ms;         // a tag read again by the same reader
+                                        //   within this time is not reported,
+                                        //   0 reports every read
+  id12la_tag_callback_t callback;       // new tag callback
+} id12la_array_config_t;
+
+typedef struct {
+  uint32_t reads;                       // successful I2C reads
+  uint32_t tags;                        // tags reported
+  uint32_t duplicates;                  // tags suppressed as duplicates
+  uint32_t checksum_errors;             // tags dropped on checksum mismatch
+  uint32_t i2c_errors;                  // failed I2C reads
+} id12la_reader_stats_t;
+
 /***************************************************************************//**
  * @brief
  *    Initialize the id12la
@@ -167,6 +194,52 @@ sl_status_t id12la_scan_address(void);
  ******************************************************************************/
 uint8_t id12la_get_i2c_address(void);
 
+/***************************************************************************//**
+ * @brief
+ *    Initialize the polling of an array of readers sharing an I2C bus.
+ *
+ * @param[in] config
+ *    Reader array configuration, the addresses are copied.
+ *
+ * @return
+ *    sl_status_t error code
+ ******************************************************************************/
+sl_status_t id12la_array_init(const id12la_array_config_t *config);
+
+/***************************************************************************//**
+ * @brief
+ *    Poll the next reader of the array which is due.
+ *
+ * @note
+ *    Does at most one 10 byte I2C read per call and never waits, the readers
+ *    are polled in round robin every ID12LA_READ_INTERVAL_MS. A reader which
+ *    fails to answer is retried after ID12LA_ERROR_BACKOFF_MS, so that it does
+ *    not slow down the others. Call it from the main loop.
+ *
+ * @return
+ *    SL_STATUS_OK if a reader was read,
+ *    SL_STATUS_IS_WAITING if no reader is due,
+ *    SL_STATUS_TRANSMIT if the read failed,
+ *    SL_STATUS_NOT_INITIALIZED if id12la_array_init() was not called
+ ******************************************************************************/
+sl_status_t id12la_array_process(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the statistics of a reader of the array.
+ *
+ * @param[in] reader
+ *    Index of the reader in the configured addresses
+ *
+ * @param[out] stats
+ *    Reader statistics
+ *
+ * @return
+ *    sl_status_t error code
+ ******************************************************************************/
+sl_status_t id12la_array_get_stats(uint8_t reader,
+                                   id12la_reader_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
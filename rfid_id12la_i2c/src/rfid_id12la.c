@@ -37,21 +37,58 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <string.h>
 #include "rfid_id12la.h"
 
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+typedef struct {
+  uint8_t id_tag[5];
+  uint32_t last_tick;                   // tick of the last read of the tag
+  bool used;
+} seen_tag_t;
+
+typedef struct {
+  uint8_t address;
+  uint32_t next_tick;                   // tick the reader is due at
+  seen_tag_t seen[ID12LA_ARRAY_HISTORY_SIZE];
+  id12la_reader_stats_t stats;
+} array_reader_t;
+
+typedef struct {
+  sl_i2cspm_t *i2cspm;
+  array_reader_t readers[ID12LA_ARRAY_MAX_READERS];
+  uint8_t reader_count;
+  uint8_t next_reader;                  // round robin position
+  uint32_t window_ticks;
+  uint32_t interval_ticks;
+  uint32_t backoff_ticks;
+  id12la_tag_callback_t callback;
+  bool is_initialized;
+} reader_array_t;
+/** @endcond */
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 static sl_i2cspm_t *id12la_i2cpsm_instance;
 static bool id12la_is_initialized = false;
 static uint8_t id12la_address_i2c = 0x7D;
+static reader_array_t reader_array;
 
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 // Local prototypes
-static sl_status_t i2c_write_blocking(uint8_t *src, uint32_t len);
-static sl_status_t i2c_read_blocking(uint8_t *dest, uint32_t len);
+static sl_status_t i2c_write_blocking(sl_i2cspm_t *i2cspm, uint8_t address,
+                                      uint8_t *src, uint32_t len);
+static sl_status_t i2c_read_blocking(sl_i2cspm_t *i2cspm, uint8_t address,
+                                     uint8_t *dest, uint32_t len);
 static bool compare_checksum(uint8_t *ptag);
 static sl_status_t get_tag(uint8_t *i2c_rx_buffer);
+static void parse_tag(const uint8_t *tag_infor, id12la_tag_t *tag);
+static bool is_duplicate(array_reader_t *reader, const uint8_t *id_tag,
+                         uint32_t now);
 
 /** @endcond */
 
@@ -74,7 +111,8 @@ sl_status_t id12la_init(sl_i2cspm_t *i2cspm)
   // Update i2cspm instance
   id12la_i2cpsm_instance = i2cspm;
 
-  ret = i2c_write_blocking(NULL, 0);
+  ret = i2c_write_blocking(id12la_i2cpsm_instance, id12la_address_i2c,
+                           NULL, 0);
   if (ret != SL_STATUS_OK) {
     return ret;
   }
@@ -119,16 +157,7 @@ sl_status_t id12la_get_all_tag(id12la_tag_list_t *tag_list, uint8_t *tag_count)
       break;
     }
 
-    tag_list->id12la_data[i].checksum_valid = compare_checksum(tag_infor);
-
-    for (uint8_t j = 0; j <= 5; j++) {
-      tag_list->id12la_data[i].id_tag[j] = tag_infor[j];
-    }
-
-    tag_list->id12la_data[i].time = (uint32_t)(tag_infor[6] << 24)
-                                    | (uint32_t)(tag_infor[7] << 16)
-                                    | (uint32_t)(tag_infor[8] << 8)
-                                    | (uint32_t)(tag_infor[9]);
+    parse_tag(tag_infor, &tag_list->id12la_data[i]);
   }
   // update tag count.
   *tag_count = i;
@@ -158,7 +187,8 @@ sl_status_t id12la_change_address_i2c(uint8_t new_address)
   data_to_send[0] = ID12LA_ADDRESS_LOCATION;
   data_to_send[1] = new_address;
 
-  ret = i2c_write_blocking(data_to_send, 2);
+  ret = i2c_write_blocking(id12la_i2cpsm_instance, id12la_address_i2c,
+                           data_to_send, 2);
 
   if (ret == SL_STATUS_OK) {
     id12la_address_i2c = new_address;
@@ -176,7 +206,8 @@ sl_status_t id12la_scan_address()
   }
   for (uint8_t address = 1; address < 127; address++) {
     id12la_address_i2c = address;
-    if (i2c_write_blocking(NULL, 0) == SL_STATUS_OK) {
+    if (i2c_write_blocking(id12la_i2cpsm_instance, address,
+                           NULL, 0) == SL_STATUS_OK) {
       return SL_STATUS_OK;
     }
   }
@@ -191,6 +222,131 @@ uint8_t id12la_get_i2c_address(void)
   return id12la_address_i2c;
 }
 
+/***************************************************************************//**
+ *    initialize the polling of an array of readers
+ ******************************************************************************/
+sl_status_t id12la_array_init(const id12la_array_config_t *config)
+{
+  uint32_t now;
+
+  if ((config == NULL) || (config->i2cspm == NULL)
+      || (config->addresses == NULL) || (config->callback == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if ((config->reader_count == 0)
+      || (config->reader_count > ID12LA_ARRAY_MAX_READERS)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  memset(&reader_array, 0, sizeof(reader_array));
+
+  reader_array.window_ticks =
+    sl_sleeptimer_ms_to_tick(config->duplicate_window_ms);
+  reader_array.interval_ticks =
+    sl_sleeptimer_ms_to_tick(ID12LA_READ_INTERVAL_MS);
+  reader_array.backoff_ticks =
+    sl_sleeptimer_ms_to_tick(ID12LA_ERROR_BACKOFF_MS);
+
+  // All readers are due at once
+  now = sl_sleeptimer_get_tick_count();
+  for (uint8_t i = 0; i < config->reader_count; i++) {
+    reader_array.readers[i].address = config->addresses[i];
+    reader_array.readers[i].next_tick = now;
+  }
+
+  reader_array.i2cspm = config->i2cspm;
+  reader_array.reader_count = config->reader_count;
+  reader_array.callback = config->callback;
+  reader_array.is_initialized = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *    poll the next reader of the array which is due
+ ******************************************************************************/
+sl_status_t id12la_array_process(void)
+{
+  sl_status_t ret;
+  array_reader_t *reader = NULL;
+  uint8_t index = 0;
+  uint8_t tag_infor[10] = { 0 };
+  id12la_tag_t tag;
+  uint32_t now;
+
+  if (!reader_array.is_initialized) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+
+  // Find the next due reader, starting after the last one read
+  now = sl_sleeptimer_get_tick_count();
+  for (uint8_t i = 0; i < reader_array.reader_count; i++) {
+    index = (uint8_t)((reader_array.next_reader + i)
+                      % reader_array.reader_count);
+    if ((int32_t)(now - reader_array.readers[index].next_tick) >= 0) {
+      reader = &reader_array.readers[index];
+      break;
+    }
+  }
+
+  if (reader == NULL) {
+    return SL_STATUS_IS_WAITING;
+  }
+  reader_array.next_reader = (uint8_t)((index + 1) % reader_array.reader_count);
+
+  ret = i2c_read_blocking(reader_array.i2cspm, reader->address, tag_infor, 10);
+  if (ret != SL_STATUS_OK) {
+    reader->stats.i2c_errors++;
+    reader->next_tick = now + reader_array.backoff_ticks;
+    return ret;
+  }
+
+  // The reader needs some time before its next tag can be read
+  reader->stats.reads++;
+  reader->next_tick = now + reader_array.interval_ticks;
+
+  // checksum = 0 => the reader's buffer has no data left
+  if (tag_infor[5] == 0) {
+    return SL_STATUS_OK;
+  }
+
+  parse_tag(tag_infor, &tag);
+  if (!tag.checksum_valid) {
+    reader->stats.checksum_errors++;
+  } else if (is_duplicate(reader, tag.id_tag, now)) {
+    reader->stats.duplicates++;
+  } else {
+    reader->stats.tags++;
+    reader_array.callback(index, &tag);
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ *    get the statistics of a reader of the array
+ ******************************************************************************/
+sl_status_t id12la_array_get_stats(uint8_t reader,
+                                   id12la_reader_stats_t *stats)
+{
+  if (stats == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  if (!reader_array.is_initialized) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+
+  if (reader >= reader_array.reader_count) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  *stats = reader_array.readers[reader].stats;
+
+  return SL_STATUS_OK;
+}
+
 /***************************************************************************//**
  *    get the RFID tag's information from the Qwiic RFID Reader
  ******************************************************************************/
@@ -198,11 +354,70 @@ static sl_status_t get_tag(uint8_t *i2c_rx_buffer)
 {
   sl_status_t ret;
 
-  ret = i2c_read_blocking(i2c_rx_buffer, 10);
-  sl_sleeptimer_delay_millisecond(20);
+  ret = i2c_read_blocking(id12la_i2cpsm_instance, id12la_address_i2c,
+                          i2c_rx_buffer, 10);
+  sl_sleeptimer_delay_millisecond(ID12LA_READ_INTERVAL_MS);
   return ret;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    This function fills a tag from the 10 bytes read from the reader:
+ *    5 bytes ID, 1 byte checksum and 4 bytes scan time
+ ******************************************************************************/
+static void parse_tag(const uint8_t *tag_infor, id12la_tag_t *tag)
+{
+  tag->checksum_valid = compare_checksum((uint8_t *)tag_infor);
+
+  for (uint8_t j = 0; j <= 5; j++) {
+    tag->id_tag[j] = tag_infor[j];
+  }
+
+  tag->time = ((uint32_t)tag_infor[6] << 24)
+              | ((uint32_t)tag_infor[7] << 16)
+              | ((uint32_t)tag_infor[8] << 8)
+              | (uint32_t)tag_infor[9];
+}
+
+/***************************************************************************//**
+ * @brief
+ *    This function checks if a tag was read by the reader within the
+ *    duplicate window, and records the read. A tag held on the reader stays
+ *    suppressed as every read restarts the window.
+ *
+ * @return
+ *    true if the tag shall not be reported
+ ******************************************************************************/
+static bool is_duplicate(array_reader_t *reader, const uint8_t *id_tag,
+                         uint32_t now)
+{
+  seen_tag_t *entry = NULL;
+  bool duplicate = false;
+
+  for (uint8_t i = 0; i < ID12LA_ARRAY_HISTORY_SIZE; i++) {
+    seen_tag_t *seen = &reader->seen[i];
+
+    if (seen->used && (memcmp(seen->id_tag, id_tag, 5) == 0)) {
+      duplicate = (now - seen->last_tick) < reader_array.window_ticks;
+      entry = seen;
+      break;
+    }
+
+    // Otherwise replace a free entry or the least recently read one
+    if ((entry == NULL) || !seen->used
+        || (entry->used && ((now - seen->last_tick)
+                            > (now - entry->last_tick)))) {
+      entry = seen;
+    }
+  }
+
+  memcpy(entry->id_tag, id_tag, 5);
+  entry->last_tick = now;
+  entry->used = true;
+
+  return duplicate;
+}
+
 /***************************************************************************//**
  * @brief
  *    This function calculate checksum and compare it to checksum value of
@@ -225,18 +440,19 @@ static bool compare_checksum(uint8_t *ptag)
 }
 
 /*Block write to RFID*/
-static sl_status_t i2c_write_blocking(uint8_t *src, uint32_t len)
+static sl_status_t i2c_write_blocking(sl_i2cspm_t *i2cspm, uint8_t address,
+                                      uint8_t *src, uint32_t len)
 {
   I2C_TransferSeq_TypeDef seq;
 
-  seq.addr = id12la_address_i2c << 1;
+  seq.addr = address << 1;
   seq.flags = I2C_FLAG_WRITE;
 
   /*Write buffer*/
   seq.buf[0].data = src;
   seq.buf[0].len = len;
 
-  if (I2CSPM_Transfer(id12la_i2cpsm_instance, &seq) != i2cTransferDone) {
+  if (I2CSPM_Transfer(i2cspm, &seq) != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
   }
 
@@ -244,18 +460,19 @@ static sl_status_t i2c_write_blocking(uint8_t *src, uint32_t len)
 }
 
 /* Block read from RFID */
-static sl_status_t i2c_read_blocking(uint8_t *dest, uint32_t len)
+static sl_status_t i2c_read_blocking(sl_i2cspm_t *i2cspm, uint8_t address,
+                                     uint8_t *dest, uint32_t len)
 {
   I2C_TransferSeq_TypeDef seq;
 
-  seq.addr = id12la_address_i2c << 1;
+  seq.addr = address << 1;
   seq.flags = I2C_FLAG_READ;
 
   /*Read buffer*/
   seq.buf[0].data = dest;
   seq.buf[0].len = len;
 
-  if (I2CSPM_Transfer(id12la_i2cpsm_instance, &seq) != i2cTransferDone) {
+  if (I2CSPM_Transfer(i2cspm, &seq) != i2cTransferDone) {
     return SL_STATUS_TRANSMIT;
   }
 
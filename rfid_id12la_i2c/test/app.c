@@ -39,8 +39,11 @@
 #include "sl_sleeptimer.h"
 #include "rfid_id12la.h"
 
-static id12la_tag_list_t id12la_all_tag_data;
-static uint8_t count_tag = 0;
+// Readers polled by the application, add the address of each reader
+// connected to the Qwiic bus
+static uint8_t reader_addresses[] = { ID12LA_DEFAULT_ADDRESS };
+
+static void tag_callback(uint8_t reader, const id12la_tag_t *tag);
 
 /***************************************************************************//**
  * Initialize application.
@@ -57,9 +60,21 @@ void app_init(void)
     app_assert_status(ret);
     app_log("I2C address is: 0x%02X\n", id12la_get_i2c_address());
     app_log("rfid begins successfully, ready to scan some tags\n");
+    reader_addresses[0] = id12la_get_i2c_address();
   } else {
     app_log("rfid inits successfully, ready scans some tags\n");
   }
+
+  // A tag held on a reader is reported once
+  id12la_array_config_t config = {
+    .i2cspm = sl_i2cspm_qwiic,
+    .addresses = reader_addresses,
+    .reader_count = sizeof(reader_addresses),
+    .duplicate_window_ms = 1000,
+    .callback = tag_callback,
+  };
+  ret = id12la_array_init(&config);
+  app_assert_status(ret);
 }
 
 /***************************************************************************//**
@@ -67,27 +82,24 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  if (id12la_get_all_tag(&id12la_all_tag_data, &count_tag) != SL_STATUS_OK) {
+  if (id12la_array_process() == SL_STATUS_TRANSMIT) {
     app_log("error while scanning tags, check connection!!!\n");
   }
+}
 
-  if (count_tag > 0) {
-    app_log("count tag: %d\n", count_tag);
-
-    for (uint8_t i = 0; i < count_tag; i++) {
-      if (id12la_all_tag_data.id12la_data[i].checksum_valid == true) {
-        app_log("ID (last byte is checksum): 0x%02X 0x%02X 0x%02X 0x%02X \
-                0x%02X 0x%02X\n",
-                id12la_all_tag_data.id12la_data[i].id_tag[0], \
-                id12la_all_tag_data.id12la_data[i].id_tag[1], \
-                id12la_all_tag_data.id12la_data[i].id_tag[2], \
-                id12la_all_tag_data.id12la_data[i].id_tag[3], \
-                id12la_all_tag_data.id12la_data[i].id_tag[4], \
-                id12la_all_tag_data.id12la_data[i].id_tag[5]);
-        app_log("Scan time: %d\n\n", id12la_all_tag_data.id12la_data[i].time);
-      } else {
-        app_log("Tag %d : checksum error, please scan the tag again\n");
-      }
-    }
-  }
+/***************************************************************************//**
+ * New tag callback.
+ ******************************************************************************/
+static void tag_callback(uint8_t reader, const id12la_tag_t *tag)
+{
+  app_log("Reader %d ID (last byte is checksum): 0x%02X 0x%02X 0x%02X 0x%02X \
+          0x%02X 0x%02X\n",
+          reader,
+          tag->id_tag[0], \
+          tag->id_tag[1], \
+          tag->id_tag[2], \
+          tag->id_tag[3], \
+          tag->id_tag[4], \
+          tag->id_tag[5]);
+  app_log("Scan time: %lu\n\n", (unsigned long)tag->time);
 }
@@ -49,6 +49,21 @@ static sen17731_calibration_t calib = {
   .wet_value = 1023,
 };
 
+// Registered sensors, handles point into this table
+static sen17731_device_t device_table[SEN17731_MAX_DEVICES];
+
+// Addresses found by the last bus scan
+static uint16_t scan_cache[SEN17731_MAX_DEVICES];
+static uint8_t scan_cache_count;
+static bool scan_cache_valid = false;
+
+// Poll engine state
+static bool poll_busy = false;
+static uint8_t poll_index;
+static uint8_t poll_cmd = GET_VALUE;
+static uint8_t poll_rx[2];
+static I2C_TransferSeq_TypeDef poll_seq;
+
 // -----------------------------------------------------------------------------
 //                       Local Function
 // -----------------------------------------------------------------------------
@@ -63,6 +78,22 @@ static sl_status_t sen17731_write_blocking(uint8_t *pdata, uint8_t len);
  *****************************************************************************/
 static sl_status_t sen17731_read_blocking(uint8_t *pdata, uint8_t len);
 
+/**************************************************************************//**
+ *  Converts the sensor ADC reading to the raw moisture value.
+ *****************************************************************************/
+static uint16_t sen17731_to_raw(const uint8_t *recv_data);
+
+/**************************************************************************//**
+ *  Applies calibration to a raw moisture value.
+ *****************************************************************************/
+static uint8_t sen17731_calibrate(uint16_t value,
+                                  const sen17731_calibration_t *range);
+
+/**************************************************************************//**
+ *  Starts the poll transfer of the next registered device.
+ *****************************************************************************/
+static bool sen17731_poll_next(void);
+
 // -----------------------------------------------------------------------------
 //                       Public Function
 // -----------------------------------------------------------------------------
@@ -96,6 +127,18 @@ sl_status_t sen17731_set_address(uint16_t address)
 
   sc = sen17731_write_blocking(send_data, 2);
   if (sc == SL_STATUS_OK) {
+    // Keep the scan cache and the device table in line with the new address
+    for (uint8_t i = 0; i < scan_cache_count; i++) {
+      if (scan_cache[i] == sen17731_i2c_addr) {
+        scan_cache[i] = address;
+      }
+    }
+    for (uint8_t i = 0; i < SEN17731_MAX_DEVICES; i++) {
+      if (device_table[i].in_use
+          && (device_table[i].address == sen17731_i2c_addr)) {
+        device_table[i].address = address;
+      }
+    }
     sen17731_i2c_addr = address;
   }
   return sc;
@@ -107,22 +150,45 @@ sl_status_t sen17731_set_address(uint16_t address)
 sl_status_t sen17731_scan_address(uint16_t *address, uint8_t *num_dev)
 {
   sl_status_t sc;
-  *num_dev = 0;
+  uint16_t selected_addr = sen17731_i2c_addr;
 
   if ((address == NULL) | (num_dev == NULL)) {
     return SL_STATUS_NULL_POINTER;
   }
-  for (uint16_t addr = 0x08; addr < 0x78; addr++) {
-    sen17731_i2c_addr = addr;
-    sc = sen17731_write_blocking(NULL, 0);
-    if (sc == SL_STATUS_OK) {
-      *(address + *num_dev) = addr;
-      (*num_dev)++;
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+  *num_dev = 0;
+
+  if (!scan_cache_valid) {
+    scan_cache_count = 0;
+    for (uint16_t addr = 0x08; addr < 0x78; addr++) {
+      sen17731_i2c_addr = addr;
+      sc = sen17731_write_blocking(NULL, 0);
+      if ((sc == SL_STATUS_OK) && (scan_cache_count < SEN17731_MAX_DEVICES)) {
+        scan_cache[scan_cache_count++] = addr;
+      }
     }
+    sen17731_i2c_addr = selected_addr;
+    scan_cache_valid = true;
+  }
+
+  for (uint8_t i = 0; i < scan_cache_count; i++) {
+    address[i] = scan_cache[i];
   }
+  *num_dev = scan_cache_count;
+
   return SL_STATUS_OK;
 }
 
+/**************************************************************************//**
+ *  Drops the cached scan result.
+ *****************************************************************************/
+void sen17731_scan_clear_cache(void)
+{
+  scan_cache_valid = false;
+}
+
 /**************************************************************************//**
  *  Selects device on the I2C bus.
  *****************************************************************************/
@@ -212,12 +278,8 @@ sl_status_t sen17731_get_moisture(uint8_t *moisture)
   if (sc != SL_STATUS_OK) {
     return sc;
   }
-  if (value < calib.dry_value) {
-    *moisture = 0;
-  } else {
-    *moisture = (uint8_t)((value - calib.dry_value) * 100
-                          / (calib.wet_value - calib.dry_value));
-  }
+  *moisture = sen17731_calibrate(value, &calib);
+
   return SL_STATUS_OK;
 }
 
@@ -238,11 +300,278 @@ sl_status_t sen17731_get_moisture_raw(uint16_t *value)
     return sc;
   }
 
+  *value = sen17731_to_raw(recv_data);
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Registers a sensor in the device table.
+ *****************************************************************************/
+sl_status_t sen17731_device_add(uint16_t address, sen17731_device_t **handle)
+{
+  sen17731_device_t *free_entry = NULL;
+
+  if (handle == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if ((address < 0x07) | (address > 0x78)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  for (uint8_t i = 0; i < SEN17731_MAX_DEVICES; i++) {
+    if (device_table[i].in_use && (device_table[i].address == address)) {
+      *handle = &device_table[i];
+      return SL_STATUS_OK;
+    }
+    if (!device_table[i].in_use && (free_entry == NULL)) {
+      free_entry = &device_table[i];
+    }
+  }
+  if (free_entry == NULL) {
+    return SL_STATUS_FULL;
+  }
+
+  free_entry->in_use = true;
+  free_entry->address = address;
+  free_entry->calib.dry_value = 0;
+  free_entry->calib.wet_value = 1023;
+  free_entry->raw = 0;
+  free_entry->moisture = 0;
+  free_entry->status = SL_STATUS_NOT_READY;
+  *handle = free_entry;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Registers all sensors found by the bus scan.
+ *****************************************************************************/
+sl_status_t sen17731_device_add_scanned(uint8_t *num_dev)
+{
+  uint16_t address[SEN17731_MAX_DEVICES];
+  sen17731_device_t *handle;
+  uint8_t found;
+  sl_status_t sc;
+
+  if (num_dev == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  *num_dev = 0;
+
+  sc = sen17731_scan_address(address, &found);
+  if (sc != SL_STATUS_OK) {
+    return sc;
+  }
+  for (uint8_t i = 0; i < found; i++) {
+    sc = sen17731_device_add(address[i], &handle);
+    if (sc != SL_STATUS_OK) {
+      return sc;
+    }
+    (*num_dev)++;
+  }
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Removes a sensor from the device table.
+ *****************************************************************************/
+sl_status_t sen17731_device_remove(sen17731_device_t *handle)
+{
+  if (handle == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+  handle->in_use = false;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Sets the calibration of a registered sensor.
+ *****************************************************************************/
+sl_status_t sen17731_device_set_calibration(sen17731_device_t *handle,
+                                            const sen17731_calibration_t *range)
+{
+  if ((handle == NULL) | (range == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  // wet value have to be greater than the dry value.
+  if ((range->dry_value > range->wet_value) | (range->wet_value > 1023)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  handle->calib = *range;
+  if (handle->status == SL_STATUS_OK) {
+    handle->moisture = sen17731_calibrate(handle->raw, &handle->calib);
+  }
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Gets the calibrated moisture value of the last poll.
+ *****************************************************************************/
+sl_status_t sen17731_device_get_moisture(const sen17731_device_t *handle,
+                                         uint8_t *moisture)
+{
+  if ((handle == NULL) | (moisture == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if (handle->status != SL_STATUS_OK) {
+    return handle->status;
+  }
+  *moisture = handle->moisture;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Starts reading all registered sensors.
+ *****************************************************************************/
+sl_status_t sen17731_poll_start(void)
+{
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+
+  poll_busy = true;
+  poll_index = 0;
+  if (!sen17731_poll_next()) {
+    poll_busy = false;
+    return SL_STATUS_EMPTY;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Advances the poll engine.
+ *****************************************************************************/
+sl_status_t sen17731_poll_process(void)
+{
+  I2C_TransferReturn_TypeDef ret;
+  sen17731_device_t *dev;
+
+  if (!poll_busy) {
+    return SL_STATUS_OK;
+  }
+
+  ret = I2C_Transfer(sen17731_i2cspm_instance);
+  if (ret == i2cTransferInProgress) {
+    return SL_STATUS_IN_PROGRESS;
+  }
+
+  dev = &device_table[poll_index];
+  if (ret == i2cTransferDone) {
+    dev->raw = sen17731_to_raw(poll_rx);
+    dev->status = SL_STATUS_OK;
+  } else {
+    dev->status = SL_STATUS_TRANSMIT;
+  }
+
+  poll_index++;
+  if (sen17731_poll_next()) {
+    return SL_STATUS_IN_PROGRESS;
+  }
+
+  // All sensors read, apply the calibration in one pass
+  for (uint8_t i = 0; i < SEN17731_MAX_DEVICES; i++) {
+    dev = &device_table[i];
+    if (dev->in_use && (dev->status == SL_STATUS_OK)) {
+      dev->moisture = sen17731_calibrate(dev->raw, &dev->calib);
+    }
+  }
+  poll_busy = false;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ *  Checks if the poll engine is running.
+ *****************************************************************************/
+bool sen17731_poll_is_busy(void)
+{
+  return poll_busy;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Starts the poll transfer of the next registered device.
+ *
+ * @details
+ *  Devices failing to start a transfer are marked and skipped.
+ *
+ * @retval true A transfer is in progress.
+ * @retval false No more devices to read.
+ ******************************************************************************/
+static bool sen17731_poll_next(void)
+{
+  I2C_TransferReturn_TypeDef ret;
+
+  for (; poll_index < SEN17731_MAX_DEVICES; poll_index++) {
+    if (!device_table[poll_index].in_use) {
+      continue;
+    }
+
+    poll_seq.addr = device_table[poll_index].address << 1;
+    poll_seq.flags = I2C_FLAG_WRITE_READ;
+    poll_seq.buf[0].data = &poll_cmd;
+    poll_seq.buf[0].len = 1;
+    poll_seq.buf[1].data = poll_rx;
+    poll_seq.buf[1].len = 2;
+
+    ret = I2C_TransferInit(sen17731_i2cspm_instance, &poll_seq);
+    if (ret == i2cTransferInProgress) {
+      return true;
+    }
+    device_table[poll_index].status = SL_STATUS_TRANSMIT;
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Converts the sensor ADC reading to the raw moisture value.
+ *
+ * @param[in] recv_data
+ *  Two bytes read from the sensor.
+ *
+ * @return Raw moisture value.
+ ******************************************************************************/
+static uint16_t sen17731_to_raw(const uint8_t *recv_data)
+{
   /* The ADC value increases from 0 -> 1023 according to the decreament of
    * the moisture value. */
-  *value = 0x3ff - ((uint16_t)(recv_data[1] << 8) + (uint16_t)recv_data[0]);
+  return 0x3ff - ((uint16_t)(recv_data[1] << 8) + (uint16_t)recv_data[0]);
+}
 
-  return SL_STATUS_OK;
+/***************************************************************************//**
+ * @brief
+ *  Applies calibration to a raw moisture value.
+ *
+ * @param[in] value
+ *  Raw moisture value.
+ * @param[in] range
+ *  Dry and wet values of the sensor.
+ *
+ * @return Moisture percentage.
+ ******************************************************************************/
+static uint8_t sen17731_calibrate(uint16_t value,
+                                  const sen17731_calibration_t *range)
+{
+  if ((value <= range->dry_value) || (range->wet_value == range->dry_value)) {
+    return 0;
+  }
+  if (value >= range->wet_value) {
+    return 100;
+  }
+  return (uint8_t)((value - range->dry_value) * 100
+                   / (range->wet_value - range->dry_value));
 }
 
 /***************************************************************************//**
@@ -265,6 +594,10 @@ static sl_status_t sen17731_write_blocking(uint8_t *pdata, uint8_t len)
   I2C_TransferSeq_TypeDef seq;
   I2C_TransferReturn_TypeDef ret;
 
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+
   seq.addr = sen17731_i2c_addr << 1;
   seq.flags = I2C_FLAG_WRITE;
 
@@ -297,6 +630,10 @@ static sl_status_t sen17731_read_blocking(uint8_t *pdata, uint8_t len)
   I2C_TransferReturn_TypeDef ret;
   uint8_t send_data = GET_VALUE;
 
+  if (poll_busy) {
+    return SL_STATUS_BUSY;
+  }
+
   seq.addr = sen17731_i2c_addr << 1;
   seq.flags = I2C_FLAG_WRITE_READ;
 
@@ -108,6 +108,20 @@ typedef struct {
   uint16_t wet_value;       /*!< value in wetest environment */
 } sen17731_calibration_t;
 
+/***************************************************************************//**
+ * @brief
+ *  Entry of the device table, one per registered sensor. A pointer to the
+ *  entry is the device handle.
+ ******************************************************************************/
+typedef struct {
+  bool in_use;                    /*!< entry holds a registered sensor */
+  uint16_t address;               /*!< I2C address of the sensor */
+  sen17731_calibration_t calib;   /*!< calibration of the sensor */
+  uint16_t raw;                   /*!< raw value of the last poll */
+  uint8_t moisture;               /*!< calibrated value of the last poll */
+  sl_status_t status;             /*!< result of the last poll */
+} sen17731_device_t;
+
 // -----------------------------------------------------------------------------
 //                       Public Function Definitions
 // -----------------------------------------------------------------------------
@@ -282,6 +296,125 @@ sl_status_t sen17731_get_moisture(uint8_t *moisture);
  ******************************************************************************/
 sl_status_t sen17731_get_moisture_raw(uint16_t *value);
 
+/***************************************************************************//**
+ * @brief
+ *  Drops the cached scan result.
+ *
+ * @details
+ *  sen17731_scan_address() probes the bus only once and returns the cached
+ *  addresses afterwards. Call this function when sensors are plugged or
+ *  unplugged to force a new scan.
+ ******************************************************************************/
+void sen17731_scan_clear_cache(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Registers a sensor in the device table.
+ *
+ * @param[in] address
+ *  The I2C address of the sensor.
+ * @param[out] handle
+ *  Handle of the sensor, the existing one if the address is registered.
+ *
+ * @details
+ *  A new sensor starts with the full 0 - 1023 calibration range.
+ *
+ * @retval SL_STATUS_OK Success
+ * @retval SL_STATUS_FULL No free entry, see SEN17731_MAX_DEVICES
+ * @retval SL_STATUS_BUSY Poll engine is running
+ ******************************************************************************/
+sl_status_t sen17731_device_add(uint16_t address, sen17731_device_t **handle);
+
+/***************************************************************************//**
+ * @brief
+ *  Registers all sensors found by sen17731_scan_address().
+ *
+ * @param[out] num_dev
+ *  The number of registered sensors.
+ *
+ * @retval SL_STATUS_OK Success
+ * @retval SL_STATUS_FULL No free entry, see SEN17731_MAX_DEVICES
+ ******************************************************************************/
+sl_status_t sen17731_device_add_scanned(uint8_t *num_dev);
+
+/***************************************************************************//**
+ * @brief
+ *  Removes a sensor from the device table.
+ *
+ * @param[in] handle
+ *  Handle of the sensor.
+ *
+ * @retval SL_STATUS_OK Success
+ * @retval SL_STATUS_BUSY Poll engine is running
+ ******************************************************************************/
+sl_status_t sen17731_device_remove(sen17731_device_t *handle);
+
+/***************************************************************************//**
+ * @brief
+ *  Sets the calibration of a registered sensor.
+ *
+ * @param[in] handle
+ *  Handle of the sensor.
+ * @param[in] range
+ *  Dry and wet values of the sensor.
+ *
+ * @retval SL_STATUS_OK Success
+ * @retval SL_STATUS_INVALID_PARAMETER Invalid range
+ ******************************************************************************/
+sl_status_t sen17731_device_set_calibration(sen17731_device_t *handle,
+                                            const sen17731_calibration_t *range);
+
+/***************************************************************************//**
+ * @brief
+ *  Gets the calibrated moisture value read by the last poll.
+ *
+ * @param[in] handle
+ *  Handle of the sensor.
+ * @param[out] moisture
+ *  The soil moisture value percentage.
+ *
+ * @retval SL_STATUS_OK Success
+ * @retval SL_STATUS_NOT_READY Sensor has not been polled yet
+ * @retval SL_STATUS_TRANSMIT Last poll of the sensor failed
+ ******************************************************************************/
+sl_status_t sen17731_device_get_moisture(const sen17731_device_t *handle,
+                                         uint8_t *moisture);
+
+/***************************************************************************//**
+ * @brief
+ *  Starts reading all registered sensors.
+ *
+ * @details
+ *  The sensors are read one after the other with non-blocking I2C
+ *  transfers driven by sen17731_poll_process(). Once all sensors are read
+ *  the calibration of each sensor is applied in one pass. Blocking
+ *  functions of the driver return SL_STATUS_BUSY while the poll runs.
+ *
+ * @retval SL_STATUS_OK Poll started
+ * @retval SL_STATUS_BUSY Poll already running
+ * @retval SL_STATUS_EMPTY No sensor registered
+ ******************************************************************************/
+sl_status_t sen17731_poll_start(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Advances the poll engine, call it from the main loop or the I2C
+ *  interrupt handler.
+ *
+ * @retval SL_STATUS_OK Poll finished or not running
+ * @retval SL_STATUS_IN_PROGRESS Poll running
+ ******************************************************************************/
+sl_status_t sen17731_poll_process(void);
+
+/***************************************************************************//**
+ * @brief
+ *  Checks if the poll engine is running.
+ *
+ * @retval true Poll running
+ * @retval false Poll finished or not running
+ ******************************************************************************/
+bool sen17731_poll_is_busy(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,4 +40,7 @@
 #define SEN17731_DEFAULT_DEVICE_ADDRESS
 #define SEN17731_DEFAULT_I2CSPM_INSTANCE      (SL_I2CSPM_QWIIC_PERIPHERAL)
 
+// Number of sensors in the device table and in the scan cache
+#define SEN17731_MAX_DEVICES                  (16)
+
 #endif /* SEN17731_CONFIG_H_ */
@@ -51,6 +51,8 @@ static void test_sen17731_set_wet_value(void);
 static void test_sen17731_get_range_values(void);
 static void test_sen17731_get_moisture_raw(void);
 static void test_sen17731_get_moisture(void);
+static void test_sen17731_device_table(void);
+static void test_sen17731_poll(void);
 
 // -----------------------------------------------------------------------------
 //                       Local Variables
@@ -67,7 +69,9 @@ testCase_t testSuite[] = {
   { &test_sen17731_set_wet_value, "test_sen17731_set_wet_value" },
   { &test_sen17731_get_range_values, "test_sen17731_get_range_values" },
   { &test_sen17731_get_moisture_raw, "test_sen17731_get_moisture_raw" },
-  { &test_sen17731_get_moisture, "test_sen17731_get_moisture" }
+  { &test_sen17731_get_moisture, "test_sen17731_get_moisture" },
+  { &test_sen17731_device_table, "test_sen17731_device_table" },
+  { &test_sen17731_poll, "test_sen17731_poll" }
 };
 
 // -----------------------------------------------------------------------------
@@ -226,6 +230,75 @@ static void test_sen17731_get_moisture(void)
   TEST_ASSERT(status == SL_STATUS_OK);
 }
 
+/**
+ * @brief Test fucntion for the device table
+ */
+static void test_sen17731_device_table(void)
+{
+  sl_status_t status;
+  sen17731_device_t *handle;
+  sen17731_device_t *same;
+  sen17731_calibration_t range;
+  uint8_t num_dev;
+
+  status = sen17731_device_add(0x28, NULL);
+  TEST_ASSERT(status == SL_STATUS_NULL_POINTER);
+
+  status = sen17731_device_add(0x06, &handle);
+  TEST_ASSERT(status == SL_STATUS_INVALID_PARAMETER);
+
+  status = sen17731_device_add(0x28, &handle);
+  TEST_ASSERT(status == SL_STATUS_OK);
+
+  status = sen17731_device_add(0x28, &same);
+  TEST_ASSERT((status == SL_STATUS_OK) && (same == handle));
+
+  range.dry_value = 600;
+  range.wet_value = 300;
+  status = sen17731_device_set_calibration(handle, &range);
+  TEST_ASSERT(status == SL_STATUS_INVALID_PARAMETER);
+
+  range.dry_value = 300;
+  range.wet_value = 600;
+  status = sen17731_device_set_calibration(handle, &range);
+  TEST_ASSERT(status == SL_STATUS_OK);
+
+  status = sen17731_device_add_scanned(&num_dev);
+  TEST_ASSERT((status == SL_STATUS_OK) && (num_dev > 0));
+}
+
+/**
+ * @brief Test fucntion for the poll engine
+ */
+static void test_sen17731_poll(void)
+{
+  sl_status_t status;
+  sen17731_device_t *handle;
+  uint8_t moisture;
+
+  status = sen17731_device_add(0x28, &handle);
+  TEST_ASSERT(status == SL_STATUS_OK);
+
+  status = sen17731_poll_start();
+  TEST_ASSERT(status == SL_STATUS_OK);
+
+  status = sen17731_poll_start();
+  TEST_ASSERT(status == SL_STATUS_BUSY);
+
+  status = sen17731_get_moisture(&moisture);
+  TEST_ASSERT(status == SL_STATUS_BUSY);
+
+  while (sen17731_poll_process() == SL_STATUS_IN_PROGRESS) {
+  }
+  TEST_ASSERT(!sen17731_poll_is_busy());
+
+  status = sen17731_device_get_moisture(handle, &moisture);
+  TEST_ASSERT((status == SL_STATUS_OK) && (moisture <= 100));
+
+  status = sen17731_device_remove(handle);
+  TEST_ASSERT(status == SL_STATUS_OK);
+}
+
 // -----------------------------------------------------------------------------
 //                       Public Function Definitions
 // -----------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+/***************************************************************************//**
+ * @file sl_sdc_wav_player.h
+ * @brief Storage Device Controls WAV streaming player include file
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ ********************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#ifndef SL_SDC_WAV_PLAYER_H
+#define SL_SDC_WAV_PLAYER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ff.h"
+#include "sl_status.h"
+#include "sl_sdc_wav_player_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes per buffer of the prefetch queue
+#define SDC_WAV_PLAYER_BUFFER_SIZE  (SDC_WAV_PLAYER_BUFFER_SECTORS * FF_MIN_SS)
+
+// Player counters
+typedef struct {
+  uint32_t reads;       ///< f_read() calls of the refills
+  uint32_t sectors;     ///< Sectors read by the refills
+  uint32_t underruns;   ///< Reads that found fewer samples than requested
+  uint8_t min_level;    ///< Fewest buffers queued after a read, before eof
+} sdc_wav_player_stats_t;
+
+// WAV player, the fields below format are private
+typedef struct {
+  uint32_t sample_rate;         ///< Sample rate of the open file
+  uint8_t channels;             ///< Interleaved channels of the open file
+
+  FIL file;
+  bool open;
+  bool refilling;               // Refill in progress, up to a full queue
+  uint16_t skip;                // Header bytes at the start of the next fill
+  uint32_t data_left;           // File bytes left to queue
+  volatile bool eof;            // Last buffer queued
+  volatile uint32_t filled;     // Buffers queued, written by the main loop
+  volatile uint32_t played;     // Buffers played, written by the consumer
+  uint16_t consumed;            // Sample bytes taken from the oldest buffer
+  volatile uint16_t start[SDC_WAV_PLAYER_BUFFER_COUNT];
+  volatile uint16_t end[SDC_WAV_PLAYER_BUFFER_COUNT];
+  sdc_wav_player_stats_t stats;
+  uint32_t buffer[SDC_WAV_PLAYER_BUFFER_COUNT][SDC_WAV_PLAYER_BUFFER_SIZE / 4];
+} sdc_wav_player_t;
+
+/***************************************************************************//**
+ * @brief
+ *   Open a WAV file for streaming.
+ *
+ * @details
+ *   The RIFF header is parsed up to the data chunk. Only 16 bit PCM with one
+ *   or two channels is supported. Call sdc_wav_player_process() once to fill
+ *   the queue before starting the consumer.
+ *
+ * @param[out] player
+ *   Pointer to the player
+ *
+ * @param[in] path
+ *   Path of the file on a mounted volume
+ *
+ * @return
+ *   @ref SL_STATUS_OK on success,
+ *   @ref SL_STATUS_NOT_FOUND if the file or its data chunk is missing,
+ *   @ref SL_STATUS_INVALID_SIGNATURE if the file is not a WAV file,
+ *   @ref SL_STATUS_NOT_SUPPORTED if the sample format is not supported,
+ *   @ref SL_STATUS_IO on a file system error
+ ******************************************************************************/
+sl_status_t sdc_wav_player_open(sdc_wav_player_t *player, const TCHAR *path);
+
+/***************************************************************************//**
+ * @brief
+ *   Close the file of the player.
+ *
+ * @param[in] player
+ *   Pointer to the player. The consumer must not read it any more.
+ *
+ * @return
+ *   @ref SL_STATUS_OK on success or @ref SL_STATUS_IO on failure
+ ******************************************************************************/
+sl_status_t sdc_wav_player_close(sdc_wav_player_t *player);
+
+/***************************************************************************//**
+ * @brief
+ *   Refill the queue from the file, to be called from the main loop.
+ *
+ * @details
+ *   Nothing is read while more than SDC_WAV_PLAYER_LOW_WATERMARK buffers
+ *   are queued. Below it, each call reads the free buffers that follow each
+ *   other in memory with one sector aligned f_read(), so that the card
+ *   serves them with a multiple block read, until the queue is full again.
+ *
+ * @param[in] player
+ *   Pointer to the player
+ *
+ * @return
+ *   @ref SL_STATUS_OK on success, @ref SL_STATUS_NOT_INITIALIZED if no file
+ *   is open or @ref SL_STATUS_IO on a read error
+ ******************************************************************************/
+sl_status_t sdc_wav_player_process(sdc_wav_player_t *player);
+
+/***************************************************************************//**
+ * @brief
+ *   Take samples from the queue.
+ *
+ * @details
+ *   The signature matches the producer callback of the audio_dac streaming
+ *   sources, with the player as context. It can be called from an interrupt
+ *   while sdc_wav_player_process() runs in the main loop.
+ *
+ * @param[in] context
+ *   Pointer to the player
+ *
+ * @param[out] samples
+ *   Buffer for interleaved 16 bit samples
+ *
+ * @param[in] count
+ *   Number of samples requested, a multiple of the channels
+ *
+ * @param[out] end
+ *   Set to true if the samples returned are the last ones of the file
+ *
+ * @return
+ *   Number of samples written, whole frames only. Fewer than requested
+ *   without end set is an underrun.
+ ******************************************************************************/
+uint32_t sdc_wav_player_read(void *context,
+                             int16_t *samples,
+                             uint32_t count,
+                             bool *end);
+
+/***************************************************************************//**
+ * @brief
+ *   Get the player counters.
+ *
+ * @param[in] player
+ *   Pointer to the player
+ *
+ * @param[out] stats
+ *   Pointer to the counters to fill
+ ******************************************************************************/
+void sdc_wav_player_get_stats(const sdc_wav_player_t *player,
+                              sdc_wav_player_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SL_SDC_WAV_PLAYER_H
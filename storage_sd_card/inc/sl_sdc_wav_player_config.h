@@ -0,0 +1,49 @@
+/***************************************************************************//**
+ * @file sl_sdc_wav_player_config.h
+ * @brief WAV player configuration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ ********************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#ifndef SL_SDC_WAV_PLAYER_CONFIG_H
+#define SL_SDC_WAV_PLAYER_CONFIG_H
+
+// Number of buffers of the prefetch queue
+#define SDC_WAV_PLAYER_BUFFER_COUNT         4
+
+// Sectors per buffer. 4 sectors hold 11.6 ms of 44.1 kHz stereo 16 bit audio.
+#define SDC_WAV_PLAYER_BUFFER_SECTORS       4
+
+// A refill starts once this many buffers or fewer are left to play, and
+// reads until the queue is full. The buffers left must cover the longest
+// read latency of the card.
+#define SDC_WAV_PLAYER_LOW_WATERMARK        2
+
+#endif /* SL_SDC_WAV_PLAYER_CONFIG_H */
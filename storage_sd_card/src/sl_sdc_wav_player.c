@@ -0,0 +1,353 @@
+/***************************************************************************//**
+ * @file sl_sdc_wav_player.c
+ * @brief Storage Device Controls WAV streaming player
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ ********************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+#include <string.h>
+
+#include "sl_sdc_wav_player.h"
+
+#define WAV_FORMAT_PCM        0x0001
+#define WAV_FORMAT_EXTENSIBLE 0xfffe
+
+// Bytes of a WAVE_FORMAT_EXTENSIBLE fmt chunk
+#define WAV_FMT_MAX_SIZE      40
+
+static uint16_t get_le16(const BYTE *p);
+static uint32_t get_le32(const BYTE *p);
+static sl_status_t read_exact(FIL *file, BYTE *buff, UINT btr);
+static sl_status_t parse_header(sdc_wav_player_t *player,
+                                FSIZE_t *data_start,
+                                FSIZE_t *data_size);
+
+/***************************************************************************//**
+ * Open a WAV file for streaming.
+ ******************************************************************************/
+sl_status_t sdc_wav_player_open(sdc_wav_player_t *player, const TCHAR *path)
+{
+  FRESULT res;
+  sl_status_t status;
+  FSIZE_t data_start, data_size;
+
+  player->open = false;
+
+  res = f_open(&player->file, path, FA_READ);
+  if ((res == FR_NO_FILE) || (res == FR_NO_PATH)) {
+    return SL_STATUS_NOT_FOUND;
+  } else if (res != FR_OK) {
+    return SL_STATUS_IO;
+  }
+
+  status = parse_header(player, &data_start, &data_size);
+  if (status == SL_STATUS_OK) {
+    // Start the queue on the sector holding the first sample, so that every
+    // refill reads whole sectors from a sector boundary straight into the
+    // buffers.
+    if (f_lseek(&player->file, data_start - data_start % FF_MIN_SS) != FR_OK) {
+      status = SL_STATUS_IO;
+    }
+  }
+  if (status != SL_STATUS_OK) {
+    (void)f_close(&player->file);
+    return status;
+  }
+
+  player->skip = (uint16_t)(data_start % FF_MIN_SS);
+  player->data_left = (uint32_t)(player->skip + data_size);
+  // The first call of sdc_wav_player_process() fills the whole queue
+  player->refilling = true;
+  player->filled = 0;
+  player->played = 0;
+  player->consumed = 0;
+  player->eof = (data_size == 0);
+  memset(&player->stats, 0, sizeof(player->stats));
+  player->stats.min_level = SDC_WAV_PLAYER_BUFFER_COUNT;
+  player->open = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Close the file of the player.
+ ******************************************************************************/
+sl_status_t sdc_wav_player_close(sdc_wav_player_t *player)
+{
+  if (!player->open) {
+    return SL_STATUS_OK;
+  }
+  player->open = false;
+
+  return (f_close(&player->file) == FR_OK) ? SL_STATUS_OK : SL_STATUS_IO;
+}
+
+/***************************************************************************//**
+ * Refill the queue from the file.
+ ******************************************************************************/
+sl_status_t sdc_wav_player_process(sdc_wav_player_t *player)
+{
+  uint32_t queued, slot, count, bytes, n, i;
+  UINT br;
+
+  if (!player->open) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  if (player->eof) {
+    return SL_STATUS_OK;
+  }
+
+  queued = player->filled - player->played;
+  if (!player->refilling) {
+    if (queued > SDC_WAV_PLAYER_LOW_WATERMARK) {
+      return SL_STATUS_OK;
+    }
+    player->refilling = true;
+  }
+
+  // The free buffers up to the end of the array are read at once, fewer
+  // commands to the card and no copy through the sector buffer of FatFs
+  slot = player->filled % SDC_WAV_PLAYER_BUFFER_COUNT;
+  count = SDC_WAV_PLAYER_BUFFER_COUNT - queued;
+  if (count > SDC_WAV_PLAYER_BUFFER_COUNT - slot) {
+    count = SDC_WAV_PLAYER_BUFFER_COUNT - slot;
+  }
+  bytes = count * SDC_WAV_PLAYER_BUFFER_SIZE;
+  if (bytes > player->data_left) {
+    bytes = player->data_left;
+  }
+
+  if (f_read(&player->file, player->buffer[slot], bytes, &br) != FR_OK) {
+    return SL_STATUS_IO;
+  }
+  player->stats.reads++;
+  player->stats.sectors += (br + FF_MIN_SS - 1) / FF_MIN_SS;
+
+  // A short read means the file is shorter than its header says
+  player->data_left = (br < bytes) ? 0 : player->data_left - br;
+
+  for (i = 0; (i < count) && (br > 0); i++) {
+    n = (br > SDC_WAV_PLAYER_BUFFER_SIZE) ? SDC_WAV_PLAYER_BUFFER_SIZE : br;
+    player->start[slot + i] = (player->skip < n) ? player->skip : (uint16_t)n;
+    player->end[slot + i] = (uint16_t)n;
+    player->skip = 0;
+    br -= n;
+  }
+  queued += i;
+
+  // Publish the buffers before the end of the file
+  player->filled += i;
+  if (player->data_left == 0) {
+    player->eof = true;
+  } else if (queued == SDC_WAV_PLAYER_BUFFER_COUNT) {
+    player->refilling = false;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Take samples from the queue.
+ ******************************************************************************/
+uint32_t sdc_wav_player_read(void *context,
+                             int16_t *samples,
+                             uint32_t count,
+                             bool *end)
+{
+  sdc_wav_player_t *player = context;
+  uint8_t *out = (uint8_t *)samples;
+  uint32_t frame = player->channels * sizeof(int16_t);
+  uint32_t avail = 0;
+  uint32_t bytes, copied, filled, slot, n;
+  bool eof;
+
+  // eof is set after the last buffer is published, read it first
+  eof = player->eof;
+  filled = player->filled;
+
+  for (n = player->played; n != filled; n++) {
+    slot = n % SDC_WAV_PLAYER_BUFFER_COUNT;
+    avail += player->end[slot] - player->start[slot];
+  }
+  avail -= player->consumed;
+
+  bytes = count * sizeof(int16_t);
+  if (bytes > avail) {
+    bytes = avail - avail % frame;
+  }
+  copied = bytes;
+
+  // Samples are stored little endian in the file, as in memory
+  while (bytes > 0) {
+    slot = player->played % SDC_WAV_PLAYER_BUFFER_COUNT;
+    n = player->end[slot] - player->start[slot] - player->consumed;
+    if (n > bytes) {
+      n = bytes;
+    }
+    memcpy(out,
+           (const uint8_t *)player->buffer[slot] + player->start[slot]
+           + player->consumed,
+           n);
+    out += n;
+    bytes -= n;
+    player->consumed += (uint16_t)n;
+
+    if (player->consumed == player->end[slot] - player->start[slot]) {
+      player->consumed = 0;
+      player->played++;
+    }
+  }
+
+  // A partial frame at the end of a truncated file is dropped
+  *end = eof && ((avail - copied) < frame);
+  if ((copied < count * sizeof(int16_t)) && !*end) {
+    player->stats.underruns++;
+  }
+  if (!eof && (filled - player->played < player->stats.min_level)) {
+    player->stats.min_level = (uint8_t)(filled - player->played);
+  }
+
+  return copied / sizeof(int16_t);
+}
+
+/***************************************************************************//**
+ * Get the player counters.
+ ******************************************************************************/
+void sdc_wav_player_get_stats(const sdc_wav_player_t *player,
+                              sdc_wav_player_stats_t *stats)
+{
+  *stats = player->stats;
+}
+
+/***************************************************************************//**
+ * Read little endian values.
+ ******************************************************************************/
+static uint16_t get_le16(const BYTE *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const BYTE *p)
+{
+  return (uint32_t)get_le16(p) | ((uint32_t)get_le16(p + 2) << 16);
+}
+
+/***************************************************************************//**
+ * Read btr bytes, SL_STATUS_NOT_FOUND if the file ends before.
+ ******************************************************************************/
+static sl_status_t read_exact(FIL *file, BYTE *buff, UINT btr)
+{
+  UINT br;
+
+  if (f_read(file, buff, btr, &br) != FR_OK) {
+    return SL_STATUS_IO;
+  }
+
+  return (br == btr) ? SL_STATUS_OK : SL_STATUS_NOT_FOUND;
+}
+
+/***************************************************************************//**
+ * Parse the RIFF header up to the data chunk.
+ ******************************************************************************/
+static sl_status_t parse_header(sdc_wav_player_t *player,
+                                FSIZE_t *data_start,
+                                FSIZE_t *data_size)
+{
+  BYTE hdr[WAV_FMT_MAX_SIZE];
+  FSIZE_t pos = 12;
+  uint32_t size;
+  uint16_t format, bits;
+  uint16_t block_align = 0;
+  bool fmt_found = false;
+  sl_status_t status;
+
+  status = read_exact(&player->file, hdr, 12);
+  if (status == SL_STATUS_IO) {
+    return status;
+  }
+  if ((status != SL_STATUS_OK)
+      || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+    return SL_STATUS_INVALID_SIGNATURE;
+  }
+
+  for (;;) {
+    if (f_lseek(&player->file, pos) != FR_OK) {
+      return SL_STATUS_IO;
+    }
+    status = read_exact(&player->file, hdr, 8);
+    if (status != SL_STATUS_OK) {
+      return status;
+    }
+    size = get_le32(hdr + 4);
+
+    if (!memcmp(hdr, "fmt ", 4)) {
+      if (size < 16) {
+        return SL_STATUS_INVALID_SIGNATURE;
+      }
+      status = read_exact(&player->file, hdr,
+                          (size < WAV_FMT_MAX_SIZE) ? size : WAV_FMT_MAX_SIZE);
+      if (status != SL_STATUS_OK) {
+        return status;
+      }
+
+      format = get_le16(hdr);
+      if ((format == WAV_FORMAT_EXTENSIBLE) && (size >= 26)) {
+        // First two bytes of the sub format GUID
+        format = get_le16(hdr + 24);
+      }
+      player->channels = (uint8_t)get_le16(hdr + 2);
+      player->sample_rate = get_le32(hdr + 4);
+      block_align = get_le16(hdr + 12);
+      bits = get_le16(hdr + 14);
+
+      if ((format != WAV_FORMAT_PCM) || (bits != 16)
+          || (player->channels < 1) || (player->channels > 2)
+          || (block_align != player->channels * sizeof(int16_t))
+          || (player->sample_rate == 0)) {
+        return SL_STATUS_NOT_SUPPORTED;
+      }
+      fmt_found = true;
+    } else if (!memcmp(hdr, "data", 4)) {
+      if (!fmt_found) {
+        return SL_STATUS_INVALID_SIGNATURE;
+      }
+      *data_start = pos + 8;
+      *data_size = size;
+      if (*data_size > f_size(&player->file) - *data_start) {
+        *data_size = f_size(&player->file) - *data_start;
+      }
+      *data_size -= *data_size % block_align;
+      return SL_STATUS_OK;
+    }
+
+    // Chunks are padded to an even size
+    pos += 8 + (FSIZE_t)size + (size & 1);
+  }
+}
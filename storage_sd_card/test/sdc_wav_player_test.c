@@ -0,0 +1,522 @@
+/***************************************************************************//**
+ * @file sdc_wav_player_test.c
+ * @brief Host harness of the SD card WAV streaming player
+ *
+ * Runs the player and FatFs on a RAM disk holding a FAT16 volume, with a
+ * timing model of the SPI SD card and a simulated DAC that pulls one slot
+ * of samples at every slot boundary, as the audio_dac streaming interrupt
+ * does. Disk reads advance the simulated clock, and the DAC interrupts that
+ * fall within a read run before it returns. Every sample played is checked
+ * against the generated file, and playback must finish without underrun.
+ *
+ * Build and run on the host:
+ *   gcc -O2 -I../inc -I<gsdk>/platform/common/inc sdc_wav_player_test.c
+ *       ../src/sl_sdc_wav_player.c ../src/ff.c ../src/ffunicode.c
+ *   ./a.out
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2022 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ff.h"
+#include "diskio.h"
+#include "sl_sdc_wav_player.h"
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// -----------------------------------------------------------------------------
+// RAM disk with a FAT16 volume, 2 KiB clusters
+
+#define SECTOR_SIZE       512
+#define DISK_SECTORS      32768
+#define CLUSTER_SECTORS   4
+#define FAT_SECTORS       32
+#define ROOT_ENTRIES      512
+#define ROOT_SECTORS      (ROOT_ENTRIES * 32 / SECTOR_SIZE)
+#define DATA_START        (1 + FAT_SECTORS + ROOT_SECTORS)
+
+static uint8_t disk[DISK_SECTORS * SECTOR_SIZE];
+static uint32_t next_cluster;
+static uint32_t root_files;
+
+static void put_le16(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+  put_le16(p, v);
+  put_le16(p + 2, v >> 16);
+}
+
+static void disk_format(void)
+{
+  uint8_t *bs = disk;
+  uint8_t *fat = disk + SECTOR_SIZE;
+
+  memset(disk, 0, sizeof(disk));
+  bs[0] = 0xeb;
+  bs[1] = 0x3c;
+  bs[2] = 0x90;
+  memcpy(bs + 3, "MSDOS5.0", 8);
+  put_le16(bs + 11, SECTOR_SIZE);
+  bs[13] = CLUSTER_SECTORS;
+  put_le16(bs + 14, 1);               // reserved sectors
+  bs[16] = 1;                         // FATs
+  put_le16(bs + 17, ROOT_ENTRIES);
+  put_le16(bs + 19, DISK_SECTORS);
+  bs[21] = 0xf8;
+  put_le16(bs + 22, FAT_SECTORS);
+  put_le16(bs + 24, 63);
+  put_le16(bs + 26, 255);
+  bs[36] = 0x80;
+  bs[38] = 0x29;
+  memcpy(bs + 43, "NO NAME    ", 11);
+  memcpy(bs + 54, "FAT16   ", 8);
+  bs[510] = 0x55;
+  bs[511] = 0xaa;
+
+  put_le16(fat, 0xfff8);
+  put_le16(fat + 2, 0xffff);
+  next_cluster = 2;
+  root_files = 0;
+}
+
+// Store a file in every other cluster, so that reads cross fragments
+static void disk_add_file(const char *name83, const uint8_t *data,
+                          uint32_t size)
+{
+  uint8_t *fat = disk + SECTOR_SIZE;
+  uint8_t *dir = disk + (1 + FAT_SECTORS) * SECTOR_SIZE + root_files * 32;
+  uint32_t cluster_size = CLUSTER_SECTORS * SECTOR_SIZE;
+  uint32_t first = next_cluster;
+  uint32_t cluster = first;
+
+  for (uint32_t done = 0; done < size; done += cluster_size) {
+    uint32_t n = (size - done < cluster_size) ? size - done : cluster_size;
+    uint32_t next = cluster + 2;
+
+    memcpy(disk + (DATA_START + (cluster - 2) * CLUSTER_SECTORS)
+           * SECTOR_SIZE, data + done, n);
+    put_le16(fat + cluster * 2, (done + n < size) ? next : 0xffff);
+    cluster = next;
+  }
+  next_cluster = cluster + 1;
+
+  memcpy(dir, name83, 11);
+  dir[11] = 0x20;
+  put_le16(dir + 26, (size > 0) ? first : 0);
+  put_le32(dir + 28, size);
+  root_files++;
+}
+
+// -----------------------------------------------------------------------------
+// Timing model of the SD card over SPI and the simulated DAC
+
+typedef struct {
+  uint32_t spi_hz;          // SPI clock
+  uint32_t access_us;       // command to first data block
+  uint32_t block_gap_us;    // between blocks of a multiple block read
+  uint32_t spike_every;     // every Nth command is slow, 0 for never
+  uint32_t spike_us;        // access time of a slow command
+} card_model_t;
+
+typedef struct {
+  uint32_t rate;
+  uint8_t channels;
+  uint32_t frames;          // frames in the file
+  uint32_t slot_frames;     // frames pulled per DAC interrupt
+  uint32_t chunk_frames;    // frames per read callback
+} dac_model_t;
+
+static const card_model_t *card;
+static const dac_model_t *dac;
+static sdc_wav_player_t player;
+
+static uint64_t now_ns;
+static uint64_t read_ns;
+static uint64_t longest_read_ns;
+static uint32_t commands;
+
+static uint64_t next_slot;  // index of the next DAC interrupt
+static uint32_t frame_pos;  // next frame expected from the player
+static uint32_t mismatches;
+static uint32_t short_slots;
+static bool dac_ended;
+
+static int16_t sample_value(uint32_t frame, uint8_t channel)
+{
+  return (int16_t)(frame * 7 + channel * 10000);
+}
+
+static uint64_t slot_time_ns(uint64_t slot)
+{
+  return slot * dac->slot_frames * 1000000000ULL / dac->rate;
+}
+
+// One DAC interrupt, the slot is pulled in chunks like the source mixer does
+static void dac_interrupt(void)
+{
+  int16_t chunk[2 * 64];
+  uint32_t frames = 0;
+  bool end = false;
+
+  while (!end && (frames < dac->slot_frames)) {
+    uint32_t want = dac->slot_frames - frames;
+    uint32_t got;
+
+    if (want > dac->chunk_frames) {
+      want = dac->chunk_frames;
+    }
+    got = sdc_wav_player_read(&player, chunk, want * dac->channels, &end)
+          / dac->channels;
+    for (uint32_t f = 0; f < got; f++) {
+      for (uint8_t c = 0; c < dac->channels; c++) {
+        if (chunk[f * dac->channels + c] != sample_value(frame_pos, c)) {
+          mismatches++;
+        }
+      }
+      frame_pos++;
+    }
+    frames += got;
+    if (got < want) {
+      break;
+    }
+  }
+
+  if (end) {
+    dac_ended = true;
+  } else if (frames < dac->slot_frames) {
+    short_slots++;
+  }
+}
+
+static void dac_run_until(uint64_t t)
+{
+  while (!dac_ended && (slot_time_ns(next_slot) <= t)) {
+    dac_interrupt();
+    next_slot++;
+  }
+}
+
+static void advance(uint64_t ns)
+{
+  now_ns += ns;
+  dac_run_until(now_ns);
+}
+
+// -----------------------------------------------------------------------------
+// Media access interface of FatFs on the RAM disk
+
+DSTATUS disk_status(BYTE pdrv)
+{
+  return (pdrv == 0) ? 0 : STA_NOINIT;
+}
+
+DSTATUS disk_initialize(BYTE pdrv)
+{
+  return disk_status(pdrv);
+}
+
+dresult_t disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+  uint64_t ns = 0;
+
+  if ((pdrv != 0) || (sector + count > DISK_SECTORS)) {
+    return RES_PARERR;
+  }
+  memcpy(buff, disk + sector * SECTOR_SIZE, count * SECTOR_SIZE);
+
+  if (card != NULL) {
+    commands++;
+    // Command, access time, then per block the token, data and CRC
+    ns += 8 * 8 * 1000000000ULL / card->spi_hz;
+    ns += ((card->spike_every != 0) && (commands % card->spike_every == 0))
+          ? card->spike_us * 1000ULL : card->access_us * 1000ULL;
+    ns += (uint64_t)count * (SECTOR_SIZE + 3) * 8 * 1000000000ULL
+          / card->spi_hz;
+    ns += (uint64_t)(count - 1) * card->block_gap_us * 1000;
+    read_ns += ns;
+    if (ns > longest_read_ns) {
+      longest_read_ns = ns;
+    }
+    advance(ns);
+  }
+
+  return RES_OK;
+}
+
+dresult_t disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+  if ((pdrv != 0) || (sector + count > DISK_SECTORS)) {
+    return RES_PARERR;
+  }
+  memcpy(disk + sector * SECTOR_SIZE, buff, count * SECTOR_SIZE);
+
+  return RES_OK;
+}
+
+dresult_t disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+  (void)buff;
+
+  return ((pdrv == 0) && (cmd == CTRL_SYNC)) ? RES_OK : RES_PARERR;
+}
+
+DWORD get_fattime(void)
+{
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// WAV files
+
+// Build a WAV file, extra bytes of a LIST chunk before the data move the
+// first sample off the sector boundary
+static uint8_t *wav_build(uint32_t rate, uint8_t channels, uint16_t bits,
+                          uint32_t frames, uint32_t list_size, uint32_t *size)
+{
+  uint32_t data_size = frames * channels * 2;
+  uint32_t list_chunk = list_size ? 8 + list_size + (list_size & 1) : 0;
+  uint8_t *wav;
+  uint8_t *p;
+
+  *size = 12 + 24 + list_chunk + 8 + data_size;
+  wav = calloc(1, *size);
+  p = wav;
+
+  memcpy(p, "RIFF", 4);
+  put_le32(p + 4, *size - 8);
+  memcpy(p + 8, "WAVE", 4);
+  p += 12;
+
+  memcpy(p, "fmt ", 4);
+  put_le32(p + 4, 16);
+  put_le16(p + 8, 1);
+  put_le16(p + 10, channels);
+  put_le32(p + 12, rate);
+  put_le32(p + 16, rate * channels * bits / 8);
+  put_le16(p + 20, channels * bits / 8);
+  put_le16(p + 22, bits);
+  p += 24;
+
+  if (list_size) {
+    memcpy(p, "LIST", 4);
+    put_le32(p + 4, list_size);
+    p += list_chunk;
+  }
+
+  memcpy(p, "data", 4);
+  put_le32(p + 4, data_size);
+  p += 8;
+  for (uint32_t f = 0; f < frames; f++) {
+    for (uint8_t c = 0; c < channels; c++) {
+      put_le16(p, (uint16_t)sample_value(f, c));
+      p += 2;
+    }
+  }
+
+  return wav;
+}
+
+static void add_wav(const char *name83, uint32_t rate, uint8_t channels,
+                    uint16_t bits, uint32_t frames, uint32_t list_size)
+{
+  uint32_t size;
+  uint8_t *wav = wav_build(rate, channels, bits, frames, list_size, &size);
+
+  disk_add_file(name83, wav, size);
+  free(wav);
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+
+static void test_open_errors(void)
+{
+  static const uint8_t text[] = "not a wav file";
+
+  disk_add_file("TEXT    TXT", text, sizeof(text));
+  add_wav("PCM8    WAV", 8000, 1, 8, 100, 0);
+
+  CHECK(sdc_wav_player_open(&player, "missing.wav") == SL_STATUS_NOT_FOUND);
+  CHECK(sdc_wav_player_open(&player, "text.txt")
+        == SL_STATUS_INVALID_SIGNATURE);
+  CHECK(sdc_wav_player_open(&player, "pcm8.wav") == SL_STATUS_NOT_SUPPORTED);
+  CHECK(sdc_wav_player_process(&player) == SL_STATUS_NOT_INITIALIZED);
+}
+
+static void test_format(void)
+{
+  int16_t s[8];
+  bool end;
+
+  // 8 kHz mono, the first sample is 78 bytes into the file
+  CHECK(sdc_wav_player_open(&player, "voice.wav") == SL_STATUS_OK);
+  CHECK(player.sample_rate == 8000);
+  CHECK(player.channels == 1);
+
+  // Nothing queued yet
+  CHECK(sdc_wav_player_read(&player, s, 8, &end) == 0);
+  CHECK(!end);
+
+  CHECK(sdc_wav_player_process(&player) == SL_STATUS_OK);
+  CHECK(sdc_wav_player_read(&player, s, 8, &end) == 8);
+  CHECK(!end);
+  CHECK((s[0] == sample_value(0, 0)) && (s[7] == sample_value(7, 0)));
+
+  CHECK(sdc_wav_player_close(&player) == SL_STATUS_OK);
+}
+
+static void test_short_file(void)
+{
+  int16_t s[64];
+  uint32_t n;
+  bool end;
+
+  CHECK(sdc_wav_player_open(&player, "short.wav") == SL_STATUS_OK);
+  CHECK(sdc_wav_player_process(&player) == SL_STATUS_OK);
+  n = sdc_wav_player_read(&player, s, 64, &end);
+  CHECK(n == 2 * 10);
+  CHECK(end);
+  CHECK((s[0] == sample_value(0, 0)) && (s[19] == sample_value(9, 1)));
+  CHECK(sdc_wav_player_close(&player) == SL_STATUS_OK);
+}
+
+static void run_playback(const char *title, const char *path,
+                         const card_model_t *model, const dac_model_t *dm)
+{
+  sdc_wav_player_stats_t stats;
+  uint32_t reads_before;
+  uint64_t duration_ns;
+  uint32_t buffer_us = (uint32_t)((uint64_t)SDC_WAV_PLAYER_BUFFER_SIZE
+                                  * 1000000 / (dm->rate * dm->channels * 2));
+
+  card = NULL;
+  dac = dm;
+  now_ns = 0;
+  read_ns = 0;
+  longest_read_ns = 0;
+  commands = 0;
+  next_slot = 0;
+  frame_pos = 0;
+  mismatches = 0;
+  short_slots = 0;
+  dac_ended = false;
+
+  CHECK(sdc_wav_player_open(&player, path) == SL_STATUS_OK);
+  CHECK(sdc_wav_player_process(&player) == SL_STATUS_OK);
+
+  // Both slots of the DAC ring are filled before its LDMA starts, then
+  // each slot is refilled once it has been played
+  card = model;
+  dac_interrupt();
+  dac_interrupt();
+  next_slot = 1;
+
+  // Main loop, idle until the next DAC interrupt when nothing was read
+  while (!dac_ended) {
+    reads_before = player.stats.reads;
+    CHECK(sdc_wav_player_process(&player) == SL_STATUS_OK);
+    if (player.stats.reads != reads_before) {
+      advance(20000);
+    } else {
+      now_ns = slot_time_ns(next_slot);
+      dac_run_until(now_ns);
+    }
+  }
+  card = NULL;
+
+  sdc_wav_player_get_stats(&player, &stats);
+  CHECK(sdc_wav_player_close(&player) == SL_STATUS_OK);
+
+  duration_ns = (uint64_t)dm->frames * 1000000000ULL / dm->rate;
+  printf("  %s\n", title);
+  printf("    %lu reads, %.1f sectors per read, card busy %.1f%%\n",
+         (unsigned long)stats.reads,
+         (double)stats.sectors / stats.reads,
+         100.0 * read_ns / duration_ns);
+  printf("    longest read %.2f ms, fewest buffers left %u (%.1f ms)\n",
+         longest_read_ns / 1e6, stats.min_level,
+         stats.min_level * buffer_us / 1000.0);
+  printf("    underruns %lu, short slots %lu, mismatches %lu\n",
+         (unsigned long)stats.underruns, (unsigned long)short_slots,
+         (unsigned long)mismatches);
+
+  CHECK(frame_pos == dm->frames);
+  CHECK(mismatches == 0);
+  CHECK(stats.underruns == 0);
+  CHECK(short_slots == 0);
+  // Refills are multiple block reads
+  CHECK(stats.sectors >= 2 * stats.reads);
+}
+
+int main(void)
+{
+  static FATFS fs;
+  // 8 MHz SPI, typical access time, then a card with long stalls
+  static const card_model_t typical = { 8000000, 800, 20, 0, 0 };
+  static const card_model_t stalls = { 8000000, 800, 20, 50, 15000 };
+  static const dac_model_t cd = { 44100, 2, 3 * 44100, 512, 32 };
+  static const dac_model_t voice = { 8000, 1, 8000, 256, 32 };
+
+  disk_format();
+  add_wav("MUSIC   WAV", cd.rate, cd.channels, 16, cd.frames, 0);
+  add_wav("VOICE   WAV", voice.rate, voice.channels, 16, voice.frames, 26);
+  add_wav("SHORT   WAV", 44100, 2, 16, 10, 0);
+
+  CHECK(f_mount(&fs, "", 1) == FR_OK);
+
+  test_open_errors();
+  test_format();
+  test_short_file();
+
+  printf("Queue of %u buffers of %u bytes, refill at %u buffers left\n",
+         SDC_WAV_PLAYER_BUFFER_COUNT, SDC_WAV_PLAYER_BUFFER_SIZE,
+         SDC_WAV_PLAYER_LOW_WATERMARK);
+  run_playback("44.1 kHz stereo, typical card", "music.wav", &typical, &cd);
+  run_playback("44.1 kHz stereo, 15 ms stall every 50 commands", "music.wav",
+               &stalls, &cd);
+  run_playback("8 kHz mono, 15 ms stall every 50 commands", "voice.wav",
+               &stalls, &voice);
+
+  (void)f_mount(NULL, "", 0);
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
@@ -51,6 +51,9 @@
 // Platform status
 #include "sl_status.h"
 
+// Phase-angle calculations
+#include "triacdrv_phase.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -71,7 +74,8 @@ extern "C" {
    *  gate enable pulse can be fired automatically and with zero CPU
    *  intervention. In addition to initializing the necessary hardware,
    *  the driver includes functions to get and set the duty cycle
-   *  (between 0 and 100% in 1% increments) and to monitor the half-wave
+   *  (between 0 and 100% in 1% increments) or the power delivered to
+   *  the load (between 0 and 1000 per-mille) and to monitor the half-wave
    *  duty cycle periods as a kind of calibration to account for some
    *  level of potential variation in the incoming DC waveform due to
    *  poor line conditions.
@@ -146,11 +150,23 @@ extern "C" {
    *  and running with either 0% or 100% duty cycle, depending on the
    *  setting of the initOn member of the initialization structure.
    *
-   *  While the output duty cycle can be changed immediately by calling
-   *  triacdrv_set_duty_cycle() with an integer parameter between 0 and
-   *  100%, it is recommended to first call triacdrv_calibrate() for
-   *  some number of 60 Hz cycles in order to tune the detected maximum
-   *  and minimum half-wave lengths.
+   *  The output can be changed by calling triacdrv_set_duty_cycle()
+   *  with an integer parameter between 0 and 100%, which positions the
+   *  gate enable pulse linearly in time, or triacdrv_set_power() with
+   *  an integer parameter between 0 and TRIACDRV_MAX_POWER per-mille,
+   *  which positions it so that the RMS power delivered to a resistive
+   *  load is linear in the setpoint.  Neither function waits: the
+   *  TIMER capture interrupt scales the new setting to the half-wave
+   *  that just ended and updates the compare values at the next
+   *  zero-crossing.  triacdrv_calibrate() measures some number of
+   *  half-waves to tune the detected maximum and minimum half-wave
+   *  lengths.
+   *
+   *  The application must call triacdrv_timer_irq_handler() from the
+   *  IRQ handler of the TIMER selected in the initialization
+   *  structure, e.g. TIMER1_IRQHandler().  The capture interrupt is
+   *  only enabled until a new setting is applied, so no CPU cycles are
+   *  used in the steady state.
    *
    * ## Energy Modes
    *
@@ -284,7 +300,10 @@ typedef struct
 sl_status_t triacdrv_calibrate(uint32_t count);
 uint32_t triacdrv_get_duty_cycle(void);
 sl_status_t triacdrv_set_duty_cycle(uint32_t duty);
+uint32_t triacdrv_get_power(void);
+sl_status_t triacdrv_set_power(uint32_t power);
 sl_status_t triacdrv_init(const TRIACDRV_Init_TypeDef *init);
+void triacdrv_timer_irq_handler(void);
 
 /** @} (end addtogroup triac) */
 
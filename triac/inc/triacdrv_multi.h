@@ -0,0 +1,183 @@
+/***************************************************************************//**
+* @file triacdrv_multi.h
+* @brief Multi-load triac controllers sharing one zero-crossing detector
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#ifndef TRIACDRV_MULTI_H
+#define TRIACDRV_MULTI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "triacdrv.h"
+#include "triacdrv_pll.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /***************************************************************************//**
+   * @addtogroup triac
+   * @{
+   *
+   * ## Multi-Load Controllers
+   *
+   *  A single zero-crossing detector (one ACMP and one PRS channel) is
+   *  shared by any number of controllers.  Each controller owns one
+   *  free-running 16-bit TIMER: CC0 captures the zero-crossing edges
+   *  and feeds a TRIACDRV_Pll_TypeDef estimator, and CC1 to CC3 drive
+   *  the gate enable outputs of up to TRIACDRV_MAX_LOADS loads
+   *  directly from their TIMER CC pins.  Two controllers therefore
+   *  drive a four-channel board from one MCU.
+   *
+   *  Gate enable pulses are placed at the predicted zero-crossing plus
+   *  the phase of the load, so detector jitter and glitches do not move
+   *  them, and they keep firing through a few missing edges.  The
+   *  compare output action of each channel is switched by the TIMER
+   *  interrupt at the start and end of every pulse, so unlike the
+   *  single-load driver this costs two short interrupts per load and
+   *  half-wave.  A pulse whose end has passed by the time the interrupt
+   *  runs is ended TRIACDRV_MULTI_LEAD_TIME later rather than missed.
+   *
+   *  Call triacdrv_zero_cross_init() once, then triacdrv_ctrl_init()
+   *  for each controller, and call triacdrv_ctrl_irq_handler() from the
+   *  IRQ handler of each controller TIMER.  No gate enable pulse is
+   *  output until the estimator is locked, nor after it unlocks when
+   *  the mains is lost.
+   *
+   ******************************************************************************/
+
+// Maximum number of loads of a controller (TIMER CC1 to CC3)
+#define TRIACDRV_MAX_LOADS                3
+
+/*
+ * Minimum time in microseconds between programming a compare value
+ * and the compare match.  Must cover the TIMER interrupt latency.
+ */
+#define TRIACDRV_MULTI_LEAD_TIME          10
+
+// Zero-crossing detector initialization structure
+typedef struct
+{
+  // ACMP used for zero crossing detection
+  ACMP_TypeDef                *acmp;
+
+  // APORT ACMP input channel
+  ACMP_Channel_TypeDef        acmpInput;
+
+  // PRS channel carrying the ACMP edges to the controller TIMERs
+  uint32_t                    acmpPrsChannel;
+
+  // Input waveform type
+  TRIACDRV_InputWave_Typedef  inputWave;
+
+  // Threshold voltage for zero-crossing in mV
+  uint32_t                    zeroThreshold;
+
+  // AVDD supply voltage in mV
+  uint32_t                    avdd;
+} TRIACDRV_ZeroCrossInit_TypeDef;
+
+// Gate enable output of a load
+typedef struct
+{
+  // TIMER CC channel (1 to 3) driving the gate enable
+  uint32_t                    channel;
+
+  // Output port, pin, and TIMER CCn location of the channel
+  GPIO_Port_TypeDef           port;
+  uint32_t                    pin;
+  uint32_t                    loc;
+} TRIACDRV_LoadInit_TypeDef;
+
+// Controller initialization structure
+typedef struct
+{
+  // TIMER used for zero-crossing capture and the gate enable outputs
+  TIMER_TypeDef               *timer;
+
+  // Gate enable pulse width in microseconds
+  uint32_t                    pulseWidth;
+
+  // Number of loads and their outputs
+  uint32_t                    loadCount;
+  TRIACDRV_LoadInit_TypeDef   loads[TRIACDRV_MAX_LOADS];
+} TRIACDRV_CtrlInit_TypeDef;
+
+// Gate enable pulse state of a load
+typedef enum
+{
+  triacLoadIdle,              // No pulse scheduled
+  triacLoadRise,              // Waiting for the pulse rising edge
+  triacLoadFall,              // Waiting for the pulse falling edge
+} TRIACDRV_LoadState_Typedef;
+
+// Load state
+typedef struct
+{
+  uint32_t                    channel;
+  volatile uint32_t           phase;    // Gate enable phase
+  volatile uint32_t           power;    // Power setpoint (per-mille)
+  TRIACDRV_LoadState_Typedef  state;
+  uint32_t                    fallTime; // Pulse falling edge (ticks)
+} TRIACDRV_Load_TypeDef;
+
+// Controller state, owned by the application and used by the driver
+typedef struct
+{
+  TIMER_TypeDef               *timer;
+  IRQn_Type                   timerIRQn;
+  uint32_t                    pulseWidthTicks;
+  uint32_t                    leadTicks;
+  uint32_t                    wraps;    // TIMER overflow count
+  TRIACDRV_Pll_TypeDef        pll;
+  uint32_t                    loadCount;
+  TRIACDRV_Load_TypeDef       loads[TRIACDRV_MAX_LOADS];
+} TRIACDRV_Ctrl_TypeDef;
+
+// Function prototypes (user API)
+sl_status_t triacdrv_zero_cross_init(const TRIACDRV_ZeroCrossInit_TypeDef *init);
+sl_status_t triacdrv_ctrl_init(TRIACDRV_Ctrl_TypeDef *ctrl, const TRIACDRV_CtrlInit_TypeDef *init);
+sl_status_t triacdrv_load_set_power(TRIACDRV_Ctrl_TypeDef *ctrl, uint32_t load, uint32_t power);
+uint32_t triacdrv_load_get_power(const TRIACDRV_Ctrl_TypeDef *ctrl, uint32_t load);
+bool triacdrv_ctrl_is_locked(const TRIACDRV_Ctrl_TypeDef *ctrl);
+uint32_t triacdrv_ctrl_get_frequency(const TRIACDRV_Ctrl_TypeDef *ctrl);
+void triacdrv_ctrl_irq_handler(TRIACDRV_Ctrl_TypeDef *ctrl);
+
+/** @} (end addtogroup triac) */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* TRIACDRV_MULTI_H */
@@ -0,0 +1,79 @@
+/***************************************************************************//**
+* @file triacdrv_phase.h
+* @brief Triac gate enable phase-angle calculations
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#ifndef TRIACDRV_PHASE_H
+#define TRIACDRV_PHASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Gate enable phase, i.e. the delay after the zero-crossing as a
+ * fraction of the half-wave, in 1/65536 units.  A phase of
+ * TRIACDRV_PHASE_OFF never fires the triac.
+ */
+#define TRIACDRV_PHASE_OFF                65536
+
+// Maximum power setpoint (per-mille of the full RMS power)
+#define TRIACDRV_MAX_POWER                1000
+
+// Number of segments of the phase-angle lookup table
+#define TRIACDRV_PHASE_LUT_SEGMENTS       64
+
+// Phase giving the power setpoint (per-mille) on a resistive load
+uint32_t triacdrv_phase_from_power(uint32_t power);
+
+// Power (per-mille) delivered to a resistive load at the phase
+uint32_t triacdrv_power_from_phase(uint32_t phase);
+
+// Phase of a gate enable duty cycle (percent), linear in time
+uint32_t triacdrv_phase_from_duty(uint32_t duty);
+
+// Compare values of the gate enable pulse for a measured half-wave
+bool triacdrv_phase_compare(uint32_t phase,
+                            uint32_t halfWave,
+                            uint32_t pulseWidthTicks,
+                            uint32_t *riseTime,
+                            uint32_t *fallTime);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* TRIACDRV_PHASE_H */
@@ -0,0 +1,131 @@
+/***************************************************************************//**
+* @file triacdrv_pll.h
+* @brief Mains zero-crossing tracking and prediction
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#ifndef TRIACDRV_PLL_H
+#define TRIACDRV_PLL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Range of mains frequencies the estimator locks to, in Hz
+#define TRIACDRV_PLL_MIN_FREQUENCY        45
+#define TRIACDRV_PLL_MAX_FREQUENCY        65
+
+// Consistent half-waves needed to lock
+#define TRIACDRV_PLL_LOCK_COUNT           4
+
+// Consecutive out-of-window captures that unlock the estimator
+#define TRIACDRV_PLL_MAX_REJECTS          4
+
+// Consecutive half-waves predicted without a capture before unlocking
+#define TRIACDRV_PLL_MAX_COAST            8
+
+/*
+ * A capture more than 1/2^TRIACDRV_PLL_WINDOW_SHIFT of the half-wave
+ * away from the predicted zero-crossing is rejected as a glitch.
+ */
+#define TRIACDRV_PLL_WINDOW_SHIFT         4
+
+/*
+ * Loop gains: each accepted capture moves the predicted zero-crossing
+ * by 1/2^TRIACDRV_PLL_PHASE_SHIFT and the half-wave length by
+ * 1/2^TRIACDRV_PLL_FREQ_SHIFT of the prediction error.
+ */
+#define TRIACDRV_PLL_PHASE_SHIFT          2
+#define TRIACDRV_PLL_FREQ_SHIFT           4
+
+// Zero-crossing estimator state
+typedef enum
+{
+  triacPllSearch,     // No zero-crossing reference
+  triacPllAcquire,    // Measuring half-waves
+  triacPllLocked,     // Predicting zero-crossings
+} TRIACDRV_PllState_Typedef;
+
+/*
+ * Zero-crossing estimator.  Times are TIMER ticks of which only the
+ * lower 24 bits are significant, so a 16-bit TIMER extended by its
+ * overflow count can feed it directly.  Internally, times and the
+ * half-wave length have 8 fractional bits.
+ */
+typedef struct
+{
+  TRIACDRV_PllState_Typedef state;
+  uint32_t tickFreq;    // TIMER tick frequency in Hz
+  uint32_t zero;        // Last zero-crossing
+  uint32_t period;      // Half-wave length
+  uint32_t minPeriod;   // Half-wave length at TRIACDRV_PLL_MAX_FREQUENCY
+  uint32_t maxPeriod;   // Half-wave length at TRIACDRV_PLL_MIN_FREQUENCY
+  uint32_t count;       // Consistent half-waves while acquiring
+  uint32_t rejects;     // Consecutive out-of-window captures
+  uint32_t coasted;     // Consecutive half-waves without a capture
+  uint32_t glitches;    // Captures rejected since initialization
+  uint32_t missed;      // Zero-crossings predicted without a capture
+} TRIACDRV_Pll_TypeDef;
+
+// Initialize an estimator for a TIMER tick frequency
+void triacdrv_pll_init(TRIACDRV_Pll_TypeDef *pll, uint32_t tickFreq);
+
+// Feed the TIMER capture of a zero-crossing detector edge
+void triacdrv_pll_update(TRIACDRV_Pll_TypeDef *pll, uint32_t capture);
+
+// Account for zero-crossings that passed without a capture
+void triacdrv_pll_coast(TRIACDRV_Pll_TypeDef *pll, uint32_t now);
+
+// Time of the next zero-crossing plus offset, at least lead after now
+bool triacdrv_pll_schedule(const TRIACDRV_Pll_TypeDef *pll,
+                           uint32_t now,
+                           uint32_t offset,
+                           uint32_t lead,
+                           uint32_t *time);
+
+// Tracked half-wave length in TIMER ticks
+uint32_t triacdrv_pll_get_half_wave(const TRIACDRV_Pll_TypeDef *pll);
+
+// Tracked mains frequency in mHz, 0 when not locked
+uint32_t triacdrv_pll_get_frequency(const TRIACDRV_Pll_TypeDef *pll);
+
+// Is the estimator predicting zero-crossings?
+bool triacdrv_pll_is_locked(const TRIACDRV_Pll_TypeDef *pll);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* TRIACDRV_PLL_H */
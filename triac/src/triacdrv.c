@@ -34,6 +34,9 @@
 ******************************************************************************/
 
 #include "triacdrv.h"
+#include "triacdrv_phase.h"
+#include "em_core.h"
+#include "triacdrv_private.h"
 
 #ifdef TRIACDRV_DEBUG
 #include "triacdrv_debug.h"
@@ -50,17 +53,34 @@ sl_status_t triacdrv_initCheckPrsGPIO(uint32_t channel, GPIO_Port_TypeDef port,
 #endif /* TRIACDRV_DISABLE_HW_RESOURCE_CHECKING */
 sl_status_t triacdrv_initPRS(ACMP_TypeDef *acmp, uint32_t acmpChannel, TIMER_TypeDef *tmr, uint32_t tmrChannel);
 void triacdrv_initTIMER(TIMER_TypeDef *tmr, uint32_t prsChannel, uint32_t pwidth, bool initOn);
-void triacdrv_initACMP(ACMP_TypeDef *acmp, ACMP_Channel_TypeDef acmpInput, TRIACDRV_InputWave_Typedef waveType, uint32_t avdd, uint32_t threshold);
+static void triacdrv_requestUpdate(uint32_t phase);
+static void triacdrv_flushCapture(void);
 
 // Global variables
 static bool               triacdrvIsInitialized = false;
 static uint32_t           triacdrvTimerFreq;
 static TIMER_TypeDef      *triacdrvTimer;
+static IRQn_Type          triacdrvTimerIRQn;
 static uint32_t           triacdrvPulseWidthTicks;
 static volatile uint32_t  triacdrvDutyPercent = 0;
+static volatile uint32_t  triacdrvPowerPermille = 0;
 static volatile uint32_t  triacdrvPulseRiseTime;
 static volatile uint32_t  triacdrvPulseFallTime;
 
+/*
+ * Gate enable phase requested by triacdrv_set_duty_cycle() or
+ * triacdrv_set_power().  The capture interrupt applies it at the next
+ * zero-crossing, scaled to the half-wave that just ended.  The
+ * interrupt is only enabled while an update or a calibration is
+ * pending, so the steady state still runs without CPU intervention.
+ */
+static volatile uint32_t  triacdrvPhase = TRIACDRV_PHASE_OFF;
+static volatile bool      triacdrvUpdatePending = false;
+static volatile uint32_t  triacdrvCalibrateCount = 0;
+
+// The first capture occurs at CNT = 0 and must be ignored
+static volatile bool      triacdrvDiscardCapture = true;
+
 /*
  * Tracking for the maximum and minimum measured half-cycle time.
  * These are set to the maximum possible value.  Because the initial
@@ -85,7 +105,7 @@ static volatile uint32_t  triacdrvHalfWaveMin = _TIMER_CNT_MASK;
  ******************************************************************************/
 sl_status_t triacdrv_calibrate(uint32_t count)
 {
-  uint32_t length;
+  CORE_DECLARE_IRQ_STATE;
 
   if (triacdrvIsInitialized == false)
     return SL_STATUS_NOT_INITIALIZED;
@@ -93,28 +113,21 @@ sl_status_t triacdrv_calibrate(uint32_t count)
   if (count > TRIACDRV_MAX_CAL_COUNT)
     return SL_STATUS_INVALID_RANGE;
 
-  while (count > 0)
-  {
-    // Wait for a half-cycle to be measured
-    while ((TIMER_IntGet(triacdrvTimer) & TIMER_IF_CC0) == 0);
+  if (count == 0)
+    return SL_STATUS_OK;
 
-    /*
-     * See if most recently captured half-cycle count is shorter than
-     * the last one saved.  This code works on the premise that the
-     * gate enable is fired some amount of time AFTER the last
-     * zero-crossing, so it tries to keep the duty cycle adjusted
-     * relative to the smallest measured half-cycle time.
-     */
-    length = TIMER_CaptureGet(triacdrvTimer, 0);
+  // Have the capture interrupt measure the next count half-cycles
+  CORE_ENTER_ATOMIC();
+  if ((triacdrvCalibrateCount == 0) && !triacdrvUpdatePending
+      && !triacdrvDiscardCapture)
+    triacdrv_flushCapture();
+  triacdrvCalibrateCount = count;
+  TIMER_IntEnable(triacdrvTimer, TIMER_IEN_CC0);
+  CORE_EXIT_ATOMIC();
 
-    if (length < triacdrvHalfWaveMin)
-      triacdrvHalfWaveMin = length;
+  // Wait for the half-cycles to be measured
+  while (triacdrvCalibrateCount > 0);
 
-    if (length > triacdrvHalfWaveMax)
-      triacdrvHalfWaveMax = length;
-
-    count--;
-  }
   return SL_STATUS_OK;
 }
 
@@ -123,6 +136,9 @@ sl_status_t triacdrv_calibrate(uint32_t count)
  *   Set the triac gate enable duty cycle.
  *
  * @details
+ *   The duty cycle maps linearly onto the time after the
+ *   zero-crossing.  The new gate enable timing takes effect at the
+ *   next zero-crossing.
  *
  * @note
  *
@@ -131,7 +147,7 @@ sl_status_t triacdrv_calibrate(uint32_t count)
  ******************************************************************************/
 sl_status_t triacdrv_set_duty_cycle(uint32_t duty)
 {
-  uint32_t length;
+  uint32_t phase;
 
   if (triacdrvIsInitialized == false)
     return SL_STATUS_NOT_INITIALIZED;
@@ -140,54 +156,164 @@ sl_status_t triacdrv_set_duty_cycle(uint32_t duty)
   if (duty > 100)
     return SL_STATUS_INVALID_RANGE;
 
-  /*
-   * Make sure the half cycle times are sane values.  If not, measure
-   * an incoming half-cycle.
-   */
-  if (triacdrvHalfWaveMin == _TIMER_CNT_MASK)
-  {
-    while ((TIMER_IntGet(triacdrvTimer) & TIMER_IF_CC0) == 0);
+  phase = triacdrv_phase_from_duty(duty);
 
-    triacdrvHalfWaveMin = TIMER_CaptureGet(triacdrvTimer, 0);
-    triacdrvHalfWaveMax = triacdrvHalfWaveMin;
-  }
-  /*
-   * Already have a measured half-cycle.  See if most recently
-   * captured half-cycle count is shorter than the last one saved.
-   * This code works on the premise that the gate enable is fired some
-   * amount of time AFTER the last zero-crossing, so it tries to
-   * keep the duty cycle adjusted relative to the smallest measured
-   * half-cycle time.
-   */
+  triacdrvDutyPercent = duty;
+  triacdrvPowerPermille = triacdrv_power_from_phase(phase);
+  triacdrv_requestUpdate(phase);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set the power delivered to the load.
+ *
+ * @details
+ *   The setpoint is translated to the phase angle that delivers this
+ *   fraction of the full RMS power to a resistive load.  The new gate
+ *   enable timing takes effect at the next zero-crossing.
+ *
+ * @note
+ *
+ * @param[in] power
+ *   An integer power between 0 and TRIACDRV_MAX_POWER per-mille.
+ ******************************************************************************/
+sl_status_t triacdrv_set_power(uint32_t power)
+{
+  uint32_t phase;
+
+  if (triacdrvIsInitialized == false)
+    return SL_STATUS_NOT_INITIALIZED;
+
+  if (power > TRIACDRV_MAX_POWER)
+    return SL_STATUS_INVALID_RANGE;
+
+  phase = triacdrv_phase_from_power(power);
+
+  triacdrvPowerPermille = power;
+  if (phase >= TRIACDRV_PHASE_OFF)
+    triacdrvDutyPercent = 0;
   else
-  {
-    length = TIMER_CaptureGet(triacdrvTimer, 0);
+    triacdrvDutyPercent = 100 - (((phase * 100) + 32768) >> 16);
+  triacdrv_requestUpdate(phase);
 
-    if (length < triacdrvHalfWaveMin)
-      triacdrvHalfWaveMin = length;
+  return SL_STATUS_OK;
+}
 
-    if (length > triacdrvHalfWaveMax)
-      triacdrvHalfWaveMax = length;
-  }
+/***************************************************************************//**
+ * @brief
+ *   Return the power delivered to the load.
+ *
+ * @details
+ *
+ * @note
+ *
+ * @param
+ *   None.
+ ******************************************************************************/
+uint32_t triacdrv_get_power(void)
+{
+  return triacdrvPowerPermille;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   TIMER interrupt handler of TRIACDRV.
+ *
+ * @details
+ *   Must be called from the IRQ handler of the TIMER selected in the
+ *   initialization structure.  Each CC0 capture is the length of the
+ *   half-wave that just ended, and the counter has just restarted, so
+ *   this is where the gate enable compare values are updated.
+ *
+ * @note
+ *
+ * @param
+ *   None.
+ ******************************************************************************/
+void triacdrv_timer_irq_handler(void)
+{
+  uint32_t flags, length, rise, fall;
+
+  flags = TIMER_IntGetEnabled(triacdrvTimer);
+  TIMER_IntClear(triacdrvTimer, flags);
 
-  // Calculate the new match times from the wavelength
-  if (duty > 0)
+  if ((flags & TIMER_IF_CC0) == 0)
+    return;
+
+  length = TIMER_CaptureGet(triacdrvTimer, 0);
+
+  if (triacdrvDiscardCapture)
   {
-    triacdrvPulseRiseTime = (100 - duty) * (triacdrvHalfWaveMin / 100);
-    triacdrvPulseFallTime = triacdrvPulseRiseTime + triacdrvPulseWidthTicks;
+    triacdrvDiscardCapture = false;
   }
   else
   {
-    triacdrvPulseRiseTime = triacdrvHalfWaveMax;
-    triacdrvPulseFallTime = triacdrvHalfWaveMax;
+    /*
+     * See if most recently captured half-cycle count is shorter or
+     * longer than the ones saved.
+     */
+    if ((triacdrvHalfWaveMin == _TIMER_CNT_MASK) || (length < triacdrvHalfWaveMin))
+      triacdrvHalfWaveMin = length;
+
+    if ((triacdrvHalfWaveMax == _TIMER_CNT_MASK) || (length > triacdrvHalfWaveMax))
+      triacdrvHalfWaveMax = length;
+
+    if (triacdrvCalibrateCount > 0)
+      triacdrvCalibrateCount--;
+
+    // Position the gate enable pulse in the half-wave just started
+    if (triacdrvUpdatePending)
+    {
+      if (!triacdrv_phase_compare(triacdrvPhase, length,
+                                  triacdrvPulseWidthTicks, &rise, &fall))
+      {
+        rise = _TIMER_CNT_MASK;
+        fall = _TIMER_CNT_MASK;
+      }
+
+      triacdrvPulseRiseTime = rise;
+      triacdrvPulseFallTime = fall;
+      TIMER_CompareSet(triacdrvTimer, 1, rise);
+      TIMER_CompareSet(triacdrvTimer, 2, fall);
+      triacdrvUpdatePending = false;
+    }
   }
 
-  // Set the new duty cycle and firing time
-  triacdrvDutyPercent = duty;
-  TIMER_CompareSet(triacdrvTimer, 1, triacdrvPulseRiseTime);
-  TIMER_CompareSet(triacdrvTimer, 2, triacdrvPulseFallTime);
+  // Nothing left to do until the next update or calibration
+  if (!triacdrvUpdatePending && (triacdrvCalibrateCount == 0))
+    TIMER_IntDisable(triacdrvTimer, TIMER_IEN_CC0);
+}
 
-  return SL_STATUS_OK;
+/***************************************************************************//**
+ * Private function that drops stale CC0 captures, so that the capture
+ * interrupt measures the next half-wave once it is enabled again.
+ ******************************************************************************/
+static void triacdrv_flushCapture(void)
+{
+  while (triacdrvTimer->STATUS & TIMER_STATUS_ICV0)
+    (void)triacdrvTimer->CC[0].CCV;
+
+  TIMER_IntClear(triacdrvTimer, TIMER_IF_CC0 | TIMER_IF_ICBOF0);
+}
+
+/***************************************************************************//**
+ * Private function that hands a new gate enable phase to the capture
+ * interrupt.
+ ******************************************************************************/
+static void triacdrv_requestUpdate(uint32_t phase)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if ((triacdrvCalibrateCount == 0) && !triacdrvUpdatePending
+      && !triacdrvDiscardCapture)
+    triacdrv_flushCapture();
+  triacdrvPhase = phase;
+  triacdrvUpdatePending = true;
+  TIMER_IntEnable(triacdrvTimer, TIMER_IEN_CC0);
+  CORE_EXIT_ATOMIC();
 }
 
 /***************************************************************************//**
@@ -473,10 +599,14 @@ void triacdrv_initTIMER(TIMER_TypeDef *tmr,
     TIMER_CompareSet(tmr, 1, triacdrvPulseRiseTime);
     TIMER_CompareSet(tmr, 2, triacdrvPulseFallTime);
     triacdrvDutyPercent = 0;
+    triacdrvPowerPermille = 0;
+    triacdrvPhase = TRIACDRV_PHASE_OFF;
   }
   else
   {
     triacdrvDutyPercent = 100;
+    triacdrvPowerPermille = TRIACDRV_MAX_POWER;
+    triacdrvPhase = 0;
     triacdrvPulseRiseTime = 0;
     triacdrvPulseFallTime = triacdrvPulseRiseTime + triacdrvPulseWidthTicks;
   }
@@ -486,20 +616,18 @@ void triacdrv_initTIMER(TIMER_TypeDef *tmr,
   TIMER_InitCC(tmr, 2, &cc2init);
 
   /*
-   * Initialize CC0 and wait for first capture, which occurs at
-   * CNT = 0.  All subsequent CC0 captures will be the CNT value
-   * where the zero-crossing rising or falling edge occurs.
+   * Initialize CC0 and let the capture interrupt throw away the first
+   * capture, which occurs at CNT = 0.  All subsequent CC0 captures
+   * will be the CNT value where the zero-crossing rising or falling
+   * edge occurs.
    */
-  TIMER_InitCC(tmr, 0, &cc0init);
-
-  while ((TIMER_IntGet(tmr) & TIMER_IF_CC0) == 0);
+  triacdrvDiscardCapture = true;
+  TIMER_IntClear(tmr, TIMER_IF_CC0 | TIMER_IF_ICBOF0);
+  TIMER_IntEnable(tmr, TIMER_IEN_CC0);
+  NVIC_ClearPendingIRQ(triacdrvTimerIRQn);
+  NVIC_EnableIRQ(triacdrvTimerIRQn);
 
-  /*
-   * First edge detected CNT = 0; read CCV to throw it away,
-   * then clear the CC0 flag.
-   */
-  (void)tmr->CC[0].CCV;
-  TIMER_IntClear(tmr, TIMER_IF_CC0);
+  TIMER_InitCC(tmr, 0, &cc0init);
 }
 
 /***************************************************************************//**
@@ -511,36 +639,116 @@ sl_status_t triacdrv_initPRS(ACMP_TypeDef *acmp, uint32_t acmpChannel, TIMER_Typ
   sl_status_t rc = SL_STATUS_OK;
   uint32_t acmpProducer, tmrProducer, tmrSignalCC1, tmrSignalCC2, tmpFreq;
   CMU_Clock_TypeDef acmpClock, timerClock;
+  IRQn_Type timerIRQn;
+
+  // Figure out which ACMP and TIMER to use, but don't do anything right now.
+  rc = triacdrv_getAcmpResources(acmp, &acmpProducer, &acmpClock);
+  if (rc != SL_STATUS_OK)
+    return rc;
+
+  rc = triacdrv_getTimerResources(tmr, &tmrProducer, &tmrSignalCC1,
+                                  &tmrSignalCC2, &timerClock, &timerIRQn);
+  if (rc != SL_STATUS_OK)
+    return rc;
+
+  /*
+   * Make sure the selected TIMER clock is at least 1 MHz.  Assuming
+   * it is, save this frequency and the timer for use elsewhere.
+   */
+  tmpFreq = CMU_ClockFreqGet(timerClock);
+  if (tmpFreq >= TRIACDRV_MIN_TIMER_FREQUENCY)
+  {
+    triacdrvTimerFreq = tmpFreq;
+    triacdrvTimer = tmr;
+    triacdrvTimerIRQn = timerIRQn;
+  }
+  else
+    return SL_STATUS_INVALID_RANGE;
+
+  /*
+   * ACMP and TIMER selections are valid.  Rnable their respective
+   * clocks, as well as the GPIO and PRS clocks.
+   */
+  CMU_ClockEnable(cmuClock_PRS, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(acmpClock, true);
+  CMU_ClockEnable(timerClock, true);
+
+  // Make ACMP output available on PRS channel for TIMER
+  PRS_SourceSignalSet(acmpChannel,
+                      acmpProducer,
+                      PRS_CH_CTRL_SIGSEL_ACMP0OUT,
+                      prsEdgeBoth);
+
+#ifdef TRIACDRV_DEBUG_PRSACMP
+  GPIO_PinModeSet(TRIACDRV_DEBUG_PRSACMP_PORT, TRIACDRV_DEBUG_PRSACMP_PIN, gpioModePushPull, 0);
+
+  // Route ACMP PRS output to debug pin
+  PRS_GpioOutputLocation(acmpChannel, TRIACDRV_DEBUG_PRSACMP_LOC);
+#endif
+
+  // Assign TIMER CC1 to the selected PRS channel
+  PRS_SourceSignalSet (tmrChannel, tmrProducer, tmrSignalCC1, prsEdgeOff);
+
+#ifdef TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT
+  GPIO_PinModeSet(TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_PORT, TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_PIN, gpioModePushPull, 0);
+
+  // Route CC1 PRS output to debug pin
+  PRS_GpioOutputLocation(tmrChannel, TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_LOC);
+#endif
+
+  // Assign TIMER CC2 to the paired PRS channel
+  PRS_SourceSignalSet (tmrChannel + 1, tmrProducer, tmrSignalCC2, prsEdgeOff);
+
+#ifdef TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT
+  GPIO_PinModeSet(TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_PORT, TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_PIN, gpioModePushPull, 1);
+
+  // Route CC2 PRS output to debug pin
+  PRS_GpioOutputLocation(tmrChannel + 1, TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_LOC);
+#endif
+
+  // AND the PRS channel for CC1 with the channel for CC2
+  PRS->CH[tmrChannel].CTRL |= PRS_CH_CTRL_ANDNEXT;
 
+  return rc;
+}
+
+/***************************************************************************//**
+ * Private function that finds the PRS producer and clock of an ACMP.
+ ******************************************************************************/
+sl_status_t triacdrv_getAcmpResources(ACMP_TypeDef *acmp,
+                                      uint32_t *producer,
+                                      CMU_Clock_TypeDef *clock)
+{
   // Figure out which ACMP to use, but don't do anything right now.
   if (false)
     { }
 #if defined(ACMP0)
   else if (acmp == ACMP0)
   {
-    acmpProducer = PRS_CH_CTRL_SOURCESEL_ACMP0;
-    acmpClock = cmuClock_ACMP0;
+    *producer = PRS_CH_CTRL_SOURCESEL_ACMP0;
+    *clock = cmuClock_ACMP0;
   }
 #endif
 #if defined(ACMP1)
   else if (acmp == ACMP1)
   {
-    acmpProducer = PRS_CH_CTRL_SOURCESEL_ACMP1;
-    acmpClock = cmuClock_ACMP1;
+    *producer = PRS_CH_CTRL_SOURCESEL_ACMP1;
+    *clock = cmuClock_ACMP1;
   }
 #endif
 #if defined(ACMP2)
   else if (acmp == ACMP2)
   {
-    acmpProducer = PRS_CH_CTRL_SOURCESEL_ACMP2;
-    acmpClock = cmuClock_ACMP2;
+    *producer = PRS_CH_CTRL_SOURCESEL_ACMP2;
+    *clock = cmuClock_ACMP2;
   }
 #endif
 #if defined(ACMP3)
   else if (acmp == ACMP3)
   {
-    acmpProducer = PRS_CH_CTRL_SOURCESEL_ACMP3;
-    acmpClock = cmuClock_ACMP1;
+    *producer = PRS_CH_CTRL_SOURCESEL_ACMP3;
+    *clock = cmuClock_ACMP1;
   }
 #endif
 #ifndef TRIACDRV_DISABLE_HW_RESOURCE_CHECKING
@@ -548,70 +756,91 @@ sl_status_t triacdrv_initPRS(ACMP_TypeDef *acmp, uint32_t acmpChannel, TIMER_Typ
     return SL_STATUS_INVALID_CONFIGURATION;
 #endif /* TRIACDRV_DISABLE_HW_RESOURCE_CHECKING */
 
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Private function that finds the PRS producer and signals, clock and IRQ
+ * of a TIMER.
+ ******************************************************************************/
+sl_status_t triacdrv_getTimerResources(TIMER_TypeDef *tmr,
+                                       uint32_t *producer,
+                                       uint32_t *signalCC1,
+                                       uint32_t *signalCC2,
+                                       CMU_Clock_TypeDef *clock,
+                                       IRQn_Type *irqn)
+{
   // Figure out which TIMER to use, but don't do anything right now.
   if (false)
     { }
 #if defined(TIMER0)
   else if (tmr == TIMER0)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER0;
-    tmrSignalCC1 = PRS_TIMER0_CC1;
-    tmrSignalCC2 = PRS_TIMER0_CC2;
-    timerClock = cmuClock_TIMER0;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER0;
+    *signalCC1 = PRS_TIMER0_CC1;
+    *signalCC2 = PRS_TIMER0_CC2;
+    *clock = cmuClock_TIMER0;
+    *irqn = TIMER0_IRQn;
   }
 #endif
 #if defined(TIMER1)
   else if (tmr == TIMER1)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER1;
-    tmrSignalCC1 = PRS_TIMER1_CC1;
-    tmrSignalCC2 = PRS_TIMER1_CC2;
-    timerClock = cmuClock_TIMER1;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER1;
+    *signalCC1 = PRS_TIMER1_CC1;
+    *signalCC2 = PRS_TIMER1_CC2;
+    *clock = cmuClock_TIMER1;
+    *irqn = TIMER1_IRQn;
   }
 #endif
 #if defined(TIMER2)
   else if (tmr == TIMER2)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER2;
-    tmrSignalCC1 = PRS_TIMER2_CC1;
-    tmrSignalCC2 = PRS_TIMER2_CC2;
-    timerClock = cmuClock_TIMER2;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER2;
+    *signalCC1 = PRS_TIMER2_CC1;
+    *signalCC2 = PRS_TIMER2_CC2;
+    *clock = cmuClock_TIMER2;
+    *irqn = TIMER2_IRQn;
   }
 #endif
 #if defined(TIMER3)
   else if (tmr == TIMER3)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER3;
-    tmrSignalCC1 = PRS_TIMER3_CC1;
-    tmrSignalCC2 = PRS_TIMER3_CC2;
-    timerClock = cmuClock_TIMER3;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER3;
+    *signalCC1 = PRS_TIMER3_CC1;
+    *signalCC2 = PRS_TIMER3_CC2;
+    *clock = cmuClock_TIMER3;
+    *irqn = TIMER3_IRQn;
   }
 #endif
 #if defined(TIMER4)
   else if (tmr == TIMER4)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER4;
-    tmrSignalCC1 = PRS_TIMER4_CC1;
-    tmrSignalCC2 = PRS_TIMER4_CC2;
-    timerClock = cmuClock_TIMER4;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER4;
+    *signalCC1 = PRS_TIMER4_CC1;
+    *signalCC2 = PRS_TIMER4_CC2;
+    *clock = cmuClock_TIMER4;
+    *irqn = TIMER4_IRQn;
   }
 #endif
 #if defined(TIMER5)
   else if (tmr == TIMER5)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER5;
-    tmrSignalCC1 = PRS_TIMER5_CC1;
-    tmrSignalCC2 = PRS_TIMER5_CC2;
-    timerClock = cmuClock_TIMER5;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER5;
+    *signalCC1 = PRS_TIMER5_CC1;
+    *signalCC2 = PRS_TIMER5_CC2;
+    *clock = cmuClock_TIMER5;
+    *irqn = TIMER5_IRQn;
   }
 #endif
 #if defined(TIMER6)
   else if (tmr == TIMER6)
   {
-    tmrProducer = PRS_CH_CTRL_SOURCESEL_TIMER6;
-    tmrSignalCC1 = PRS_TIMER6_CC1;
-    tmrSignalCC2 = PRS_TIMER6_CC2;
-    timerClock = cmuClock_TIMER6;
+    *producer = PRS_CH_CTRL_SOURCESEL_TIMER6;
+    *signalCC1 = PRS_TIMER6_CC1;
+    *signalCC2 = PRS_TIMER6_CC2;
+    *clock = cmuClock_TIMER6;
+    *irqn = TIMER6_IRQn;
   }
 #endif
 #ifndef TRIACDRV_DISABLE_HW_RESOURCE_CHECKING
@@ -619,65 +848,7 @@ sl_status_t triacdrv_initPRS(ACMP_TypeDef *acmp, uint32_t acmpChannel, TIMER_Typ
     return SL_STATUS_INVALID_CONFIGURATION;
 #endif /* TRIACDRV_DISABLE_HW_RESOURCE_CHECKING */
 
-  /*
-   * Make sure the selected TIMER clock is at least 1 MHz.  Assuming
-   * it is, save this frequency and the timer for use elsewhere.
-   */
-  tmpFreq = CMU_ClockFreqGet(timerClock);
-  if (tmpFreq >= TRIACDRV_MIN_TIMER_FREQUENCY)
-  {
-    triacdrvTimerFreq = tmpFreq;
-    triacdrvTimer = tmr;
-  }
-  else
-    return SL_STATUS_INVALID_RANGE;
-
-  /*
-   * ACMP and TIMER selections are valid.  Rnable their respective
-   * clocks, as well as the GPIO and PRS clocks.
-   */
-  CMU_ClockEnable(cmuClock_PRS, true);
-  CMU_ClockEnable(cmuClock_GPIO, true);
-  CMU_ClockEnable(acmpClock, true);
-  CMU_ClockEnable(timerClock, true);
-
-  // Make ACMP output available on PRS channel for TIMER
-  PRS_SourceSignalSet(acmpChannel,
-                      acmpProducer,
-                      PRS_CH_CTRL_SIGSEL_ACMP0OUT,
-                      prsEdgeBoth);
-
-#ifdef TRIACDRV_DEBUG_PRSACMP
-  GPIO_PinModeSet(TRIACDRV_DEBUG_PRSACMP_PORT, TRIACDRV_DEBUG_PRSACMP_PIN, gpioModePushPull, 0);
-
-  // Route ACMP PRS output to debug pin
-  PRS_GpioOutputLocation(acmpChannel, TRIACDRV_DEBUG_PRSACMP_LOC);
-#endif
-
-  // Assign TIMER CC1 to the selected PRS channel
-  PRS_SourceSignalSet (tmrChannel, tmrProducer, tmrSignalCC1, prsEdgeOff);
-
-#ifdef TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT
-  GPIO_PinModeSet(TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_PORT, TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_PIN, gpioModePushPull, 0);
-
-  // Route CC1 PRS output to debug pin
-  PRS_GpioOutputLocation(tmrChannel, TRIACDRV_DEBUG_PULSE_RISE_PRS_OUT_LOC);
-#endif
-
-  // Assign TIMER CC2 to the paired PRS channel
-  PRS_SourceSignalSet (tmrChannel + 1, tmrProducer, tmrSignalCC2, prsEdgeOff);
-
-#ifdef TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT
-  GPIO_PinModeSet(TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_PORT, TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_PIN, gpioModePushPull, 1);
-
-  // Route CC2 PRS output to debug pin
-  PRS_GpioOutputLocation(tmrChannel + 1, TRIACDRV_DEBUG_PULSE_FALL_PRS_OUT_LOC);
-#endif
-
-  // AND the PRS channel for CC1 with the channel for CC2
-  PRS->CH[tmrChannel].CTRL |= PRS_CH_CTRL_ANDNEXT;
-
-  return rc;
+  return SL_STATUS_OK;
 }
 
 /***************************************************************************//**
@@ -0,0 +1,491 @@
+/***************************************************************************//**
+* @file triacdrv_multi.c
+* @brief Multi-load triac controllers sharing one zero-crossing detector
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#include "triacdrv_multi.h"
+#include "triacdrv_private.h"
+#include "em_gpio.h"
+
+// Function prototypes (private API)
+static uint32_t triacdrv_ctrl_now(const TRIACDRV_Ctrl_TypeDef *ctrl);
+static void triacdrv_ctrl_setAction(TIMER_TypeDef *tmr, uint32_t ch, TIMER_OutputAction_TypeDef action);
+static void triacdrv_ctrl_serviceLoad(TRIACDRV_Ctrl_TypeDef *ctrl, TRIACDRV_Load_TypeDef *load, bool match, uint32_t now);
+
+// Global variables
+static bool               triacdrvZeroCrossIsInitialized = false;
+static uint32_t           triacdrvZeroCrossPrsChannel;
+
+/*
+ * Controller times are TIMER ticks extended by the overflow count of
+ * the 16-bit counter.  Only the lower 24 bits are significant, which
+ * covers far more than the full mains cycle that any two compared
+ * times are apart.
+ */
+static int32_t triacdrv_ctrl_diff(uint32_t a, uint32_t b)
+{
+  return (int32_t)((a - b) << 8) >> 8;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize the zero-crossing detector shared by the controllers.
+ *
+ * @details
+ *   Sets up the ACMP and routes both edges of its output to a PRS
+ *   channel, from which each controller TIMER captures them.
+ *
+ * @note
+ *   The ACMP and PRS channel must not be the ones used by
+ *   triacdrv_init().
+ *
+ * @param[in] init
+ *   A pointer to the zero-crossing detector initialization structure.
+ ******************************************************************************/
+sl_status_t triacdrv_zero_cross_init(const TRIACDRV_ZeroCrossInit_TypeDef *init)
+{
+  sl_status_t rc;
+  uint32_t acmpProducer;
+  CMU_Clock_TypeDef acmpClock;
+
+  // If already initialized, return OK
+  if (triacdrvZeroCrossIsInitialized == true)
+    return SL_STATUS_OK;
+
+  if ((init->avdd > TRIACDRV_MAX_AVDD) ||
+      (init->avdd < TRIACDRV_MIN_AVDD))
+    return SL_STATUS_INVALID_RANGE;
+
+  if ((init->zeroThreshold < TRIACDRV_MIN_ZERO_THRESHOLD) ||
+      (init->zeroThreshold > TRIACDRV_MAX_ZERO_THRESHOLD))
+    return SL_STATUS_INVALID_RANGE;
+
+#ifndef TRIACDRV_DISABLE_HW_RESOURCE_CHECKING
+  if (init->acmpPrsChannel >= PRS_CHAN_COUNT)
+    return SL_STATUS_INVALID_PARAMETER;
+#endif /* TRIACDRV_DISABLE_HW_RESOURCE_CHECKING */
+
+  rc = triacdrv_getAcmpResources(init->acmp, &acmpProducer, &acmpClock);
+  if (rc != SL_STATUS_OK)
+    return rc;
+
+  CMU_ClockEnable(cmuClock_PRS, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(acmpClock, true);
+
+  // Make ACMP output available on PRS channel for the TIMERs
+  PRS_SourceSignalSet(init->acmpPrsChannel,
+                      acmpProducer,
+                      PRS_CH_CTRL_SIGSEL_ACMP0OUT,
+                      prsEdgeBoth);
+
+  triacdrv_initACMP(init->acmp, init->acmpInput, init->inputWave,
+                    init->avdd, init->zeroThreshold);
+
+  triacdrvZeroCrossPrsChannel = init->acmpPrsChannel;
+  triacdrvZeroCrossIsInitialized = true;
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a multi-load controller.
+ *
+ * @details
+ *   The controller TIMER runs freely from the end of this function.
+ *   All loads are initially off, and no gate enable pulse is output
+ *   until the zero-crossing estimator is locked, which takes
+ *   TRIACDRV_PLL_LOCK_COUNT half-waves.
+ *
+ * @note
+ *   triacdrv_zero_cross_init() must be called first.
+ *
+ * @param[out] ctrl
+ *   The controller state, which must stay allocated.
+ *
+ * @param[in] init
+ *   A pointer to the controller initialization structure.
+ ******************************************************************************/
+sl_status_t triacdrv_ctrl_init(TRIACDRV_Ctrl_TypeDef *ctrl,
+                               const TRIACDRV_CtrlInit_TypeDef *init)
+{
+  sl_status_t rc;
+  uint32_t tmrProducer, tmrSignalCC1, tmrSignalCC2, freq, tmrpresc, i, j, ch;
+  CMU_Clock_TypeDef timerClock;
+  IRQn_Type timerIRQn;
+  TIMER_TypeDef *tmr = init->timer;
+
+  if (triacdrvZeroCrossIsInitialized == false)
+    return SL_STATUS_NOT_INITIALIZED;
+
+  if ((init->pulseWidth == 0) || (init->pulseWidth > TRIACDRV_MAX_ENABLE_PULSE_WIDTH))
+    return SL_STATUS_INVALID_RANGE;
+
+  if ((init->loadCount == 0) || (init->loadCount > TRIACDRV_MAX_LOADS))
+    return SL_STATUS_INVALID_RANGE;
+
+  // Each load needs a CC channel of its own; CC0 captures the zero-crossings
+  for (i = 0; i < init->loadCount; i++)
+  {
+    ch = init->loads[i].channel;
+
+    if ((ch == 0) || (ch > TRIACDRV_MAX_LOADS))
+      return SL_STATUS_INVALID_PARAMETER;
+
+    for (j = 0; j < i; j++)
+    {
+      if (init->loads[j].channel == ch)
+        return SL_STATUS_INVALID_PARAMETER;
+    }
+
+    if (!(GPIO_PORT_PIN_VALID(init->loads[i].port, init->loads[i].pin)))
+      return SL_STATUS_INVALID_CONFIGURATION;
+  }
+
+  rc = triacdrv_getTimerResources(tmr, &tmrProducer, &tmrSignalCC1,
+                                  &tmrSignalCC2, &timerClock, &timerIRQn);
+  if (rc != SL_STATUS_OK)
+    return rc;
+
+  freq = CMU_ClockFreqGet(timerClock);
+  if (freq < TRIACDRV_MIN_TIMER_FREQUENCY)
+    return SL_STATUS_INVALID_RANGE;
+
+  /*
+   * Find the smallest TIMER prescaler for which a full cycle at the
+   * lowest mains frequency fits in the 16-bit counter, so that every
+   * compare value scheduled within the next cycle is unambiguous.
+   */
+  tmrpresc = timerPrescale1;
+
+  while (((freq >> tmrpresc) / TRIACDRV_PLL_MIN_FREQUENCY) >= 0xFFFF)
+    tmrpresc++;
+
+  freq >>= tmrpresc;
+
+  ctrl->timer = tmr;
+  ctrl->timerIRQn = timerIRQn;
+  ctrl->pulseWidthTicks = (uint32_t)(((uint64_t)freq * init->pulseWidth) / 1000000);
+  ctrl->leadTicks = (uint32_t)(((uint64_t)freq * TRIACDRV_MULTI_LEAD_TIME) / 1000000) + 1;
+  ctrl->wraps = 0;
+  ctrl->loadCount = init->loadCount;
+  triacdrv_pll_init(&ctrl->pll, freq);
+
+  for (i = 0; i < init->loadCount; i++)
+  {
+    ctrl->loads[i].channel = init->loads[i].channel;
+    ctrl->loads[i].phase = TRIACDRV_PHASE_OFF;
+    ctrl->loads[i].power = 0;
+    ctrl->loads[i].state = triacLoadIdle;
+    ctrl->loads[i].fallTime = 0;
+  }
+
+  CMU_ClockEnable(timerClock, true);
+
+  // Free-running counter over the full 16-bit range
+  TIMER_Init_TypeDef timerinit = TIMER_INIT_DEFAULT;
+  timerinit.prescale = (TIMER_Prescale_TypeDef)tmrpresc;
+  timerinit.enable = false;
+
+  TIMER_Init(tmr, &timerinit);
+  TIMER_TopSet(tmr, 0xFFFF);
+  TIMER_CounterSet(tmr, 0);
+
+  /*
+   * The gate enable outputs start low with no compare output action.
+   * The TIMER interrupt switches the action to set and then clear
+   * around each pulse.
+   */
+  TIMER_InitCC_TypeDef ccinit = TIMER_INITCC_DEFAULT;
+  ccinit.mode = timerCCModeCompare;
+  ccinit.cmoa = timerOutputActionNone;
+
+  for (i = 0; i < init->loadCount; i++)
+  {
+    ch = init->loads[i].channel;
+
+    TIMER_InitCC(tmr, ch, &ccinit);
+
+    GPIO_PinModeSet(init->loads[i].port, init->loads[i].pin, gpioModePushPull, 0);
+
+    // CCn locations are 8 bits apart in ROUTELOC0
+    tmr->ROUTELOC0 = (tmr->ROUTELOC0 & ~(_TIMER_ROUTELOC0_CC0LOC_MASK << (ch * 8)))
+                     | (init->loads[i].loc << (ch * 8));
+    tmr->ROUTEPEN |= (TIMER_ROUTEPEN_CC0PEN << ch);
+  }
+
+  // CC0 captures each zero-crossing edge from the PRS
+  TIMER_InitCC_TypeDef cc0init = TIMER_INITCC_DEFAULT;
+  cc0init.edge = timerEdgeRising;
+  cc0init.mode = timerCCModeCapture;
+  cc0init.prsInput = true;
+  cc0init.prsSel = (TIMER_PRSSEL_TypeDef)triacdrvZeroCrossPrsChannel;
+
+  TIMER_InitCC(tmr, 0, &cc0init);
+
+  TIMER_IntClear(tmr, _TIMER_IF_MASK);
+  TIMER_IntEnable(tmr, TIMER_IEN_CC0 | TIMER_IEN_OF);
+  NVIC_ClearPendingIRQ(timerIRQn);
+  NVIC_EnableIRQ(timerIRQn);
+
+  TIMER_Enable(tmr, true);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set the power delivered to a load.
+ *
+ * @details
+ *   The setpoint is translated to the phase angle that delivers this
+ *   fraction of the full RMS power to a resistive load.  It takes
+ *   effect with the next gate enable pulse scheduled, i.e. within a
+ *   half-wave.
+ *
+ * @note
+ *
+ * @param[in] ctrl
+ *   The controller.
+ *
+ * @param[in] load
+ *   Index of the load in the controller initialization structure.
+ *
+ * @param[in] power
+ *   An integer power between 0 and TRIACDRV_MAX_POWER per-mille.
+ ******************************************************************************/
+sl_status_t triacdrv_load_set_power(TRIACDRV_Ctrl_TypeDef *ctrl,
+                                    uint32_t load,
+                                    uint32_t power)
+{
+  if (load >= ctrl->loadCount)
+    return SL_STATUS_INVALID_PARAMETER;
+
+  if (power > TRIACDRV_MAX_POWER)
+    return SL_STATUS_INVALID_RANGE;
+
+  ctrl->loads[load].power = power;
+  ctrl->loads[load].phase = triacdrv_phase_from_power(power);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the power delivered to a load, 0 for an invalid load.
+ ******************************************************************************/
+uint32_t triacdrv_load_get_power(const TRIACDRV_Ctrl_TypeDef *ctrl,
+                                 uint32_t load)
+{
+  if (load >= ctrl->loadCount)
+    return 0;
+
+  return ctrl->loads[load].power;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return true if the controller predicts the zero-crossings and
+ *   fires the loads.
+ ******************************************************************************/
+bool triacdrv_ctrl_is_locked(const TRIACDRV_Ctrl_TypeDef *ctrl)
+{
+  return triacdrv_pll_is_locked(&ctrl->pll);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the tracked mains frequency in mHz, 0 when not locked.
+ ******************************************************************************/
+uint32_t triacdrv_ctrl_get_frequency(const TRIACDRV_Ctrl_TypeDef *ctrl)
+{
+  return triacdrv_pll_get_frequency(&ctrl->pll);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   TIMER interrupt handler of a multi-load controller.
+ *
+ * @details
+ *   Must be called from the IRQ handler of the controller TIMER, e.g.
+ *   TIMER0_IRQHandler().  Feeds the zero-crossing captures to the
+ *   estimator, extends the counter on overflow, and moves each load
+ *   through its gate enable pulse.
+ *
+ * @note
+ *
+ * @param[in] ctrl
+ *   The controller.
+ ******************************************************************************/
+void triacdrv_ctrl_irq_handler(TRIACDRV_Ctrl_TypeDef *ctrl)
+{
+  TIMER_TypeDef *tmr = ctrl->timer;
+  uint32_t capture[2];
+  uint32_t captures = 0;
+  uint32_t flags, wraps, now, i;
+  TRIACDRV_Load_TypeDef *load;
+
+  // Read the captures before the flags so that an overflow in between is seen
+  while ((captures < 2) && (tmr->STATUS & TIMER_STATUS_ICV0))
+    capture[captures++] = tmr->CC[0].CCV;
+
+  flags = TIMER_IntGetEnabled(tmr);
+  TIMER_IntClear(tmr, flags | TIMER_IF_ICBOF0);
+
+  // A capture taken after the flags were read is handled right away
+  if (tmr->STATUS & TIMER_STATUS_ICV0)
+    NVIC_SetPendingIRQ(ctrl->timerIRQn);
+
+  wraps = ctrl->wraps;
+  if (flags & TIMER_IF_OF)
+    ctrl->wraps = wraps + 1;
+
+  for (i = 0; i < captures; i++)
+  {
+    /*
+     * With an overflow pending, a capture in the lower half of the
+     * count was taken after the overflow.
+     */
+    if ((flags & TIMER_IF_OF) && (capture[i] < 0x8000))
+      triacdrv_pll_update(&ctrl->pll, ((wraps + 1) << 16) | capture[i]);
+    else
+      triacdrv_pll_update(&ctrl->pll, (wraps << 16) | capture[i]);
+  }
+
+  now = triacdrv_ctrl_now(ctrl);
+  triacdrv_pll_coast(&ctrl->pll, now);
+
+  for (i = 0; i < ctrl->loadCount; i++)
+  {
+    load = &ctrl->loads[i];
+    triacdrv_ctrl_serviceLoad(ctrl, load,
+                              (flags & (TIMER_IF_CC0 << load->channel)) != 0,
+                              now);
+  }
+}
+
+/***************************************************************************//**
+ * Private function that returns the extended TIMER count.  Must be
+ * called from the TIMER interrupt handler.
+ ******************************************************************************/
+static uint32_t triacdrv_ctrl_now(const TRIACDRV_Ctrl_TypeDef *ctrl)
+{
+  uint32_t count = TIMER_CounterGet(ctrl->timer);
+  uint32_t wraps = ctrl->wraps;
+
+  // Overflow not serviced yet
+  if ((TIMER_IntGet(ctrl->timer) & TIMER_IF_OF) && (count < 0x8000))
+    wraps++;
+
+  return (wraps << 16) | count;
+}
+
+/***************************************************************************//**
+ * Private function that sets the compare match output action of a CC
+ * channel.
+ ******************************************************************************/
+static void triacdrv_ctrl_setAction(TIMER_TypeDef *tmr,
+                                   uint32_t ch,
+                                   TIMER_OutputAction_TypeDef action)
+{
+  tmr->CC[ch].CTRL = (tmr->CC[ch].CTRL & ~_TIMER_CC_CTRL_CMOA_MASK)
+                     | ((uint32_t)action << _TIMER_CC_CTRL_CMOA_SHIFT);
+}
+
+/***************************************************************************//**
+ * Private function that moves a load through its gate enable pulse.
+ *
+ * A scheduled rising edge is dropped when the estimator unlocks.  At
+ * the rising edge compare match, the falling edge is scheduled, and
+ * at the falling edge compare match, the pulse of the next half-wave.
+ ******************************************************************************/
+static void triacdrv_ctrl_serviceLoad(TRIACDRV_Ctrl_TypeDef *ctrl,
+                                      TRIACDRV_Load_TypeDef *load,
+                                      bool match,
+                                      uint32_t now)
+{
+  TIMER_TypeDef *tmr = ctrl->timer;
+  uint32_t ch = load->channel;
+  uint32_t rise, fall, time;
+
+  if (load->state == triacLoadRise)
+  {
+    if (match)
+    {
+      // The gate enable is high; end the pulse late rather than never
+      time = load->fallTime;
+      if (triacdrv_ctrl_diff(time, now) < (int32_t)ctrl->leadTicks)
+        time = now + ctrl->leadTicks;
+
+      TIMER_CompareSet(tmr, ch, time & 0xFFFF);
+      triacdrv_ctrl_setAction(tmr, ch, timerOutputActionClear);
+      load->state = triacLoadFall;
+      return;
+    }
+
+    if (triacdrv_pll_is_locked(&ctrl->pll))
+      return;
+
+    triacdrv_ctrl_setAction(tmr, ch, timerOutputActionNone);
+    load->state = triacLoadIdle;
+  }
+  else if (load->state == triacLoadFall)
+  {
+    if (!match)
+      return;
+
+    triacdrv_ctrl_setAction(tmr, ch, timerOutputActionNone);
+    load->state = triacLoadIdle;
+  }
+
+  // Schedule the pulse of the next half-wave, if any
+  if (!triacdrv_phase_compare(load->phase,
+                              triacdrv_pll_get_half_wave(&ctrl->pll),
+                              ctrl->pulseWidthTicks,
+                              &rise,
+                              &fall)
+      || !triacdrv_pll_schedule(&ctrl->pll, now, rise, ctrl->leadTicks, &time))
+  {
+    TIMER_IntDisable(tmr, TIMER_IEN_CC0 << ch);
+    return;
+  }
+
+  load->fallTime = time + (fall - rise);
+
+  TIMER_IntClear(tmr, TIMER_IF_CC0 << ch);
+  TIMER_IntEnable(tmr, TIMER_IEN_CC0 << ch);
+  TIMER_CompareSet(tmr, ch, time & 0xFFFF);
+  triacdrv_ctrl_setAction(tmr, ch, timerOutputActionSet);
+  load->state = triacLoadRise;
+}
@@ -0,0 +1,212 @@
+/***************************************************************************//**
+* @file triacdrv_phase.c
+* @brief Triac gate enable phase-angle calculations
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#include "triacdrv_phase.h"
+
+/*
+ * Power delivered to a resistive load when firing the triac at the
+ * phase angle a (0 to pi) of each half-wave, relative to full power:
+ *
+ * P(a) = 1 - a / pi + sin(2 * a) / (2 * pi)
+ *
+ * The table holds P(j * pi / 64) in 1/65536 units (P(0) clamped to
+ * 65535).  Indexing it by phase angle rather than by power keeps the
+ * linear interpolation accurate near 0 and full power, where the
+ * angle changes quickly for a small change of power.  The inverse
+ * lookup is within 0.25 per-mille of the exact setpoint.
+ */
+static const uint16_t triacdrvPowerLut[TRIACDRV_PHASE_LUT_SEGMENTS + 1] =
+{
+  65535, 65534, 65523, 65492, 65432, 65333, 65187, 64985,
+  64719, 64383, 63969, 63471, 62884, 62205, 61430, 60556,
+  59582, 58508, 57334, 56061, 54692, 53231, 51681, 50047,
+  48335, 46553, 44707, 42805, 40856, 38868, 36851, 34814,
+  32768, 30722, 28685, 26668, 24680, 22731, 20829, 18983,
+  17201, 15489, 13855, 12305, 10844,  9475,  8202,  7028,
+   5954,  4980,  4106,  3331,  2652,  2065,  1567,  1153,
+    817,   551,   349,   203,   104,    44,    13,     2,
+      0
+};
+
+/***************************************************************************//**
+ * @brief
+ *   Return the gate enable phase that delivers a power setpoint.
+ *
+ * @param[in] power
+ *   Power setpoint between 0 and TRIACDRV_MAX_POWER per-mille.
+ *
+ * @return
+ *   The phase in 1/65536 of the half-wave, TRIACDRV_PHASE_OFF for 0.
+ ******************************************************************************/
+uint32_t triacdrv_phase_from_power(uint32_t power)
+{
+  uint32_t target, lo, hi, mid, step;
+
+  if (power == 0)
+    return TRIACDRV_PHASE_OFF;
+
+  if (power >= TRIACDRV_MAX_POWER)
+    return 0;
+
+  // Power setpoint in the 1/65536 units of the table
+  target = ((power << 16) + (TRIACDRV_MAX_POWER / 2)) / TRIACDRV_MAX_POWER;
+
+  if (target >= triacdrvPowerLut[0])
+    return 0;
+
+  // Find the segment with lut[lo] > target >= lut[lo + 1]
+  lo = 0;
+  hi = TRIACDRV_PHASE_LUT_SEGMENTS;
+
+  while ((hi - lo) > 1)
+  {
+    mid = (lo + hi) / 2;
+
+    if (triacdrvPowerLut[mid] > target)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  // Interpolate the phase within the segment
+  step = triacdrvPowerLut[lo] - triacdrvPowerLut[lo + 1];
+
+  return ((lo << 16) + (((triacdrvPowerLut[lo] - target) << 16) / step))
+         / TRIACDRV_PHASE_LUT_SEGMENTS;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the power delivered at a gate enable phase.
+ *
+ * @param[in] phase
+ *   The phase in 1/65536 of the half-wave.
+ *
+ * @return
+ *   The power in per-mille of the full RMS power.
+ ******************************************************************************/
+uint32_t triacdrv_power_from_phase(uint32_t phase)
+{
+  uint32_t index, frac, power;
+
+  if (phase >= TRIACDRV_PHASE_OFF)
+    return 0;
+
+  index = (phase * TRIACDRV_PHASE_LUT_SEGMENTS) >> 16;
+  frac = (phase * TRIACDRV_PHASE_LUT_SEGMENTS) & 0xFFFF;
+
+  power = triacdrvPowerLut[index]
+          - (((triacdrvPowerLut[index] - triacdrvPowerLut[index + 1]) * frac) >> 16);
+
+  return ((power * TRIACDRV_MAX_POWER) + 32768) >> 16;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the gate enable phase of a duty cycle.
+ *
+ * @details
+ *   The duty cycle maps linearly onto the time after the
+ *   zero-crossing, as in earlier versions of the driver.
+ *
+ * @param[in] duty
+ *   Duty cycle between 0 and 100%.
+ *
+ * @return
+ *   The phase in 1/65536 of the half-wave, TRIACDRV_PHASE_OFF for 0.
+ ******************************************************************************/
+uint32_t triacdrv_phase_from_duty(uint32_t duty)
+{
+  if (duty == 0)
+    return TRIACDRV_PHASE_OFF;
+
+  if (duty >= 100)
+    return 0;
+
+  return ((100 - duty) << 16) / 100;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Calculate the compare values of the gate enable pulse.
+ *
+ * @details
+ *   The phase is scaled to the measured half-wave without losing
+ *   precision to an integer divide.  The pulse is kept at least one
+ *   pulse width clear of the next zero-crossing, as the reload-start
+ *   of the TIMER there would otherwise cut it short and could fire the
+ *   triac at the start of the next half-wave.
+ *
+ * @param[in] phase
+ *   The phase in 1/65536 of the half-wave.
+ *
+ * @param[in] halfWave
+ *   The measured half-wave in TIMER ticks (up to 16 bits).
+ *
+ * @param[in] pulseWidthTicks
+ *   The gate enable pulse width in TIMER ticks.
+ *
+ * @param[out] riseTime
+ *   The TIMER count of the pulse rising edge.
+ *
+ * @param[out] fallTime
+ *   The TIMER count of the pulse falling edge.
+ *
+ * @return
+ *   False if the triac is not to be fired, leaving the outputs unset.
+ ******************************************************************************/
+bool triacdrv_phase_compare(uint32_t phase,
+                            uint32_t halfWave,
+                            uint32_t pulseWidthTicks,
+                            uint32_t *riseTime,
+                            uint32_t *fallTime)
+{
+  uint32_t rise, latest;
+
+  if ((phase >= TRIACDRV_PHASE_OFF) || (halfWave <= (2 * pulseWidthTicks)))
+    return false;
+
+  // 16-bit phase times 16-bit half-wave fits in 32 bits
+  rise = (phase * halfWave) >> 16;
+
+  latest = halfWave - (2 * pulseWidthTicks);
+  if (rise > latest)
+    rise = latest;
+
+  *riseTime = rise;
+  *fallTime = rise + pulseWidthTicks;
+
+  return true;
+}
@@ -0,0 +1,326 @@
+/***************************************************************************//**
+* @file triacdrv_pll.c
+* @brief Mains zero-crossing tracking and prediction
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#include "triacdrv_pll.h"
+
+/*
+ * The estimator is an alpha-beta tracker of the zero-crossing time
+ * and the half-wave length.  Once locked, each capture is compared to
+ * the zero-crossing predicted from the previous one.  Captures close
+ * to the prediction pull it by a fraction of the error, which filters
+ * the jitter of the zero-crossing detector, while captures outside a
+ * window around it (ACMP chatter, switching noise coupled into the
+ * sense input) are dropped.  Because the prediction keeps running
+ * when captures are dropped or missing, the gate enable pulses stay
+ * in place through short disturbances.
+ */
+
+// Signed difference of two times with 8 fractional bits
+static int32_t triacdrv_pll_diff(uint32_t a, uint32_t b)
+{
+  return (int32_t)(a - b);
+}
+
+/***************************************************************************//**
+ * Private function that restarts the half-wave measurement at a capture.
+ ******************************************************************************/
+static void triacdrv_pll_restart(TRIACDRV_Pll_TypeDef *pll, uint32_t time)
+{
+  pll->state = triacPllAcquire;
+  pll->zero = time;
+  pll->count = 0;
+}
+
+/***************************************************************************//**
+ * Private function that measures half-waves until enough consecutive
+ * ones agree to lock.
+ ******************************************************************************/
+static void triacdrv_pll_acquire(TRIACDRV_Pll_TypeDef *pll, uint32_t time)
+{
+  uint32_t elapsed = time - pll->zero;
+  int32_t err;
+
+  // Too early for a zero-crossing: chatter or a glitch
+  if (elapsed < pll->minPeriod)
+  {
+    pll->glitches++;
+    return;
+  }
+
+  // Too late: a zero-crossing was missed, start over
+  if (elapsed > pll->maxPeriod)
+  {
+    triacdrv_pll_restart(pll, time);
+    return;
+  }
+
+  err = triacdrv_pll_diff(elapsed, pll->period);
+
+  if ((pll->count == 0)
+      || ((uint32_t)((err < 0) ? -err : err) > (pll->period >> TRIACDRV_PLL_WINDOW_SHIFT)))
+  {
+    // First half-wave or one that does not match the previous ones
+    pll->period = elapsed;
+    pll->count = 1;
+  }
+  else
+  {
+    pll->period += err / 4;
+    pll->count++;
+  }
+
+  pll->zero = time;
+
+  if (pll->count >= TRIACDRV_PLL_LOCK_COUNT)
+  {
+    pll->state = triacPllLocked;
+    pll->rejects = 0;
+    pll->coasted = 0;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Initialize a zero-crossing estimator.
+ *
+ * @param[out] pll
+ *   The estimator.
+ *
+ * @param[in] tickFreq
+ *   TIMER tick frequency in Hz.  A full mains cycle must be less than
+ *   2^23 ticks.
+ ******************************************************************************/
+void triacdrv_pll_init(TRIACDRV_Pll_TypeDef *pll, uint32_t tickFreq)
+{
+  pll->state = triacPllSearch;
+  pll->tickFreq = tickFreq;
+  pll->zero = 0;
+  pll->minPeriod = (uint32_t)(((uint64_t)tickFreq << 8) / (2 * TRIACDRV_PLL_MAX_FREQUENCY));
+  pll->maxPeriod = (uint32_t)(((uint64_t)tickFreq << 8) / (2 * TRIACDRV_PLL_MIN_FREQUENCY));
+  pll->period = pll->maxPeriod;
+  pll->count = 0;
+  pll->rejects = 0;
+  pll->coasted = 0;
+  pll->glitches = 0;
+  pll->missed = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Feed the capture of a zero-crossing detector edge.
+ *
+ * @details
+ *   Captures within the window around a predicted zero-crossing
+ *   update the estimate; skipped zero-crossings are accounted for.
+ *   Other captures are counted as glitches and, if too many follow
+ *   in a row, unlock the estimator.
+ *
+ * @param[in,out] pll
+ *   The estimator.
+ *
+ * @param[in] capture
+ *   TIMER ticks at the edge.
+ ******************************************************************************/
+void triacdrv_pll_update(TRIACDRV_Pll_TypeDef *pll, uint32_t capture)
+{
+  uint32_t time = capture << 8;
+  uint32_t elapsed, n, predicted, window;
+  int32_t err;
+
+  if (pll->state == triacPllSearch)
+  {
+    triacdrv_pll_restart(pll, time);
+    return;
+  }
+
+  if (pll->state == triacPllAcquire)
+  {
+    triacdrv_pll_acquire(pll, time);
+    return;
+  }
+
+  elapsed = time - pll->zero;
+
+  // Chatter right after the last zero-crossing
+  if (elapsed < (pll->period / 2))
+  {
+    pll->glitches++;
+    return;
+  }
+
+  // Nearest predicted zero-crossing
+  n = (elapsed + (pll->period / 2)) / pll->period;
+  predicted = pll->zero + (n * pll->period);
+  err = triacdrv_pll_diff(time, predicted);
+  window = pll->period >> TRIACDRV_PLL_WINDOW_SHIFT;
+
+  if ((uint32_t)((err < 0) ? -err : err) > window)
+  {
+    pll->glitches++;
+
+    if (++pll->rejects > TRIACDRV_PLL_MAX_REJECTS)
+      triacdrv_pll_restart(pll, time);
+
+    return;
+  }
+
+  pll->rejects = 0;
+  pll->coasted = 0;
+  pll->missed += n - 1;
+  pll->zero = predicted + (err / (1 << TRIACDRV_PLL_PHASE_SHIFT));
+
+  // Only a single half-wave measures its length
+  if (n == 1)
+  {
+    pll->period += err / (1 << TRIACDRV_PLL_FREQ_SHIFT);
+
+    if (pll->period < pll->minPeriod)
+      pll->period = pll->minPeriod;
+    else if (pll->period > pll->maxPeriod)
+      pll->period = pll->maxPeriod;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance the estimate past zero-crossings that were not captured.
+ *
+ * @details
+ *   Must be called at least once every 2^23 ticks, e.g. on every
+ *   TIMER overflow, so that the estimator notices that the mains is
+ *   gone and unlocks after TRIACDRV_PLL_MAX_COAST half-waves.
+ *
+ * @param[in,out] pll
+ *   The estimator.
+ *
+ * @param[in] now
+ *   Current TIMER ticks.
+ ******************************************************************************/
+void triacdrv_pll_coast(TRIACDRV_Pll_TypeDef *pll, uint32_t now)
+{
+  uint32_t time = now << 8;
+  uint32_t limit;
+
+  if (pll->state != triacPllLocked)
+    return;
+
+  limit = pll->period + (pll->period >> TRIACDRV_PLL_WINDOW_SHIFT);
+
+  while (triacdrv_pll_diff(time, pll->zero) > (int32_t)limit)
+  {
+    pll->zero += pll->period;
+    pll->missed++;
+
+    if (++pll->coasted > TRIACDRV_PLL_MAX_COAST)
+    {
+      pll->state = triacPllSearch;
+      return;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Find the first predicted zero-crossing plus an offset that is at
+ *   least lead ticks after now.
+ *
+ * @param[in] pll
+ *   The estimator.
+ *
+ * @param[in] now
+ *   Current TIMER ticks.
+ *
+ * @param[in] offset
+ *   Delay after the zero-crossing in ticks, less than a half-wave.
+ *
+ * @param[in] lead
+ *   Minimum time from now in ticks.
+ *
+ * @param[out] time
+ *   The scheduled time in TIMER ticks (lower 24 bits).
+ *
+ * @return
+ *   false if the estimator is not locked.
+ ******************************************************************************/
+bool triacdrv_pll_schedule(const TRIACDRV_Pll_TypeDef *pll,
+                           uint32_t now,
+                           uint32_t offset,
+                           uint32_t lead,
+                           uint32_t *time)
+{
+  uint32_t t;
+
+  if (pll->state != triacPllLocked)
+    return false;
+
+  t = pll->zero + (offset << 8);
+
+  while (triacdrv_pll_diff(t, now << 8) < (int32_t)(lead << 8))
+    t += pll->period;
+
+  *time = (t + 128) >> 8;
+
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the tracked half-wave length in TIMER ticks.
+ ******************************************************************************/
+uint32_t triacdrv_pll_get_half_wave(const TRIACDRV_Pll_TypeDef *pll)
+{
+  return (pll->period + 128) >> 8;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return the tracked mains frequency in mHz, 0 when not locked.
+ ******************************************************************************/
+uint32_t triacdrv_pll_get_frequency(const TRIACDRV_Pll_TypeDef *pll)
+{
+  if (pll->state != triacPllLocked)
+    return 0;
+
+  return (uint32_t)((((uint64_t)pll->tickFreq << 8) * 500) / pll->period);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Return true if the estimator is predicting zero-crossings.
+ ******************************************************************************/
+bool triacdrv_pll_is_locked(const TRIACDRV_Pll_TypeDef *pll)
+{
+  return (pll->state == triacPllLocked);
+}
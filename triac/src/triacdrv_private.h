@@ -0,0 +1,54 @@
+/***************************************************************************//**
+* @file triacdrv_private.h
+* @brief Resource helpers shared by the TRIACDRV source files
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#ifndef TRIACDRV_PRIVATE_H
+#define TRIACDRV_PRIVATE_H
+
+#include "triacdrv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function prototypes (private API shared by triacdrv.c and triacdrv_multi.c)
+sl_status_t triacdrv_getAcmpResources(ACMP_TypeDef *acmp, uint32_t *producer, CMU_Clock_TypeDef *clock);
+sl_status_t triacdrv_getTimerResources(TIMER_TypeDef *tmr, uint32_t *producer, uint32_t *signalCC1, uint32_t *signalCC2, CMU_Clock_TypeDef *clock, IRQn_Type *irqn);
+void triacdrv_initACMP(ACMP_TypeDef *acmp, ACMP_Channel_TypeDef acmpInput, TRIACDRV_InputWave_Typedef waveType, uint32_t avdd, uint32_t threshold);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* TRIACDRV_PRIVATE_H */
@@ -56,8 +56,11 @@
  */
 #define LETIMER_TOP 273
 
-// Duty cycle value
-uint32_t triacDuty;   // initially off
+// Power setpoint in per-mille
+uint32_t triacPower;  // initially off
+
+// Power change per button press
+#define POWER_STEP    50
 
 /**************************************************************************//**
  * @brief
@@ -153,9 +156,9 @@ int main(void)
   if (triacdrv_init(&triacInit) != SL_STATUS_OK)
     __BKPT(0);
 
-  // Set initial duty cycle
-  triacDuty = 25;
-  triacdrv_set_duty_cycle(triacDuty);
+  // Set initial power to 25%
+  triacPower = 250;
+  triacdrv_set_power(triacPower);
 
   // Calibrate
   triacdrv_calibrate(60);
@@ -177,19 +180,28 @@ void GPIO_ODD_IRQHandler(void)
    * checking which interrupt flag is set (PB1 is given priority).
    */
   if ((flags & (1 << BSP_GPIO_PB1_PIN)))
-    // PB0 pressed; reduce duty cycle by 5%
-    if (triacDuty > 0)
-      triacDuty -= 5;
+    // PB0 pressed; reduce power by 5%
+    if (triacPower > 0)
+      triacPower -= POWER_STEP;
     else
-      triacDuty = 0;
-  // PB1 pressed; increase duty cycle by 5%
+      triacPower = 0;
+  // PB1 pressed; increase power by 5%
   else
-    if (triacDuty < 100)
-      triacDuty += 5;
+    if (triacPower < TRIACDRV_MAX_POWER)
+      triacPower += POWER_STEP;
     else
-      triacDuty = 100;
+      triacPower = TRIACDRV_MAX_POWER;
 
-  triacdrv_set_duty_cycle(triacDuty);
+  triacdrv_set_power(triacPower);
 
   GPIO_IntClear(flags);
 }
+
+/*
+ * TIMER1 is the TIMER selected by TRIAC_INIT_DEFAULT; TRIACDRV uses its
+ * capture interrupt to update the gate enable pulse.
+ */
+void TIMER1_IRQHandler(void)
+{
+  triacdrv_timer_irq_handler();
+}
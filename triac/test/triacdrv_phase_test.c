@@ -0,0 +1,260 @@
+/***************************************************************************//**
+* @file triacdrv_phase_test.c
+* @brief Host test of the power-linear gate enable positioning
+*
+* Models the ACMP zero-crossing detection and the TIMER CC0 capture of an
+* offset sine input, positions the gate enable pulse from each captured
+* half-wave with triacdrv_phase_compare() as the capture interrupt does,
+* and integrates the RMS power delivered to a resistive load from the
+* actual firing instant relative to the true zero-crossing.
+*
+* Build and run on the host:
+*   gcc -O2 -I../inc triacdrv_phase_test.c ../src/triacdrv_phase.c -lm
+*   ./a.out
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include "triacdrv_phase.h"
+
+#define PI                    3.14159265358979323846
+
+// HFPERCLK of the EFM32TG11 demonstration project (HFXO)
+#define HFPERCLK_HZ           48000000
+
+// Gate enable pulse width in microseconds
+#define PULSE_WIDTH_US        20
+
+// Half-waves averaged per setpoint
+#define HALF_WAVES            16
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// Mains and zero-crossing detector
+typedef struct {
+  double line_hz;             // Mains frequency
+  double amplitude_mv;        // Peak of the offset sine around AVDD / 2
+  double threshold_mv;        // ACMP hysteresis around AVDD / 2
+  double timer_hz;            // Prescaled TIMER clock
+  uint32_t pulse_ticks;       // Gate enable pulse width
+} mains_model_t;
+
+/***************************************************************************//**
+ * Prescales the TIMER clock as triacdrv_initTIMER() does.
+ ******************************************************************************/
+static void model_init(mains_model_t *model, double line_hz,
+                       double threshold_mv)
+{
+  uint32_t presc = 0;
+
+  while (((HFPERCLK_HZ >> presc) / 50) >= 0xFFFF)
+    presc++;
+
+  model->line_hz = line_hz;
+  model->amplitude_mv = 1650.0;
+  model->threshold_mv = threshold_mv;
+  model->timer_hz = (double)(HFPERCLK_HZ >> presc);
+  model->pulse_ticks = (uint32_t)(((uint64_t)(HFPERCLK_HZ >> presc)
+                                   * PULSE_WIDTH_US) / 1000000);
+}
+
+/***************************************************************************//**
+ * TIMER count at the ACMP edge of half-wave k.  The hysteresis delays the
+ * edge after the true zero-crossing until the input has moved by the
+ * threshold; the capture is quantized to TIMER ticks.
+ ******************************************************************************/
+static uint64_t edge_tick(const mains_model_t *model, int k)
+{
+  double delay = asin(model->threshold_mv / model->amplitude_mv) / PI;
+  double t = (k + delay) / (2.0 * model->line_hz);
+
+  return (uint64_t)floor(t * model->timer_hz);
+}
+
+/***************************************************************************//**
+ * Power delivered to a resistive load in half-wave k when the gate fires
+ * at the given TIMER count, relative to full power.
+ ******************************************************************************/
+static double half_wave_power(const mains_model_t *model, int k,
+                              uint64_t fire_tick)
+{
+  double t_zero = k / (2.0 * model->line_hz);
+  double a = (fire_tick / model->timer_hz - t_zero) * 2.0 * PI * model->line_hz;
+
+  if (a < 0)
+    a = 0;
+  if (a >= PI)
+    return 0;
+
+  return 1.0 - a / PI + sin(2.0 * a) / (2.0 * PI);
+}
+
+/***************************************************************************//**
+ * Delivered power (per-mille) for a gate enable phase, averaged over
+ * HALF_WAVES half-waves.  Each half-wave uses the capture of the previous
+ * one, as the capture interrupt does.
+ ******************************************************************************/
+static double delivered_power(const mains_model_t *model, uint32_t phase)
+{
+  double sum = 0;
+  uint32_t rise, fall;
+
+  for (int k = 1; k <= HALF_WAVES; k++) {
+    uint32_t capture = (uint32_t)(edge_tick(model, k) - edge_tick(model, k - 1));
+
+    if (triacdrv_phase_compare(phase, capture, model->pulse_ticks,
+                               &rise, &fall)) {
+      sum += half_wave_power(model, k, edge_tick(model, k) + rise);
+    }
+  }
+
+  return 1000.0 * sum / HALF_WAVES;
+}
+
+/***************************************************************************//**
+ * Worst deviation of the delivered power from the power setpoints.
+ ******************************************************************************/
+static double power_linearity(const mains_model_t *model)
+{
+  double worst = 0;
+
+  for (uint32_t power = 0; power <= TRIACDRV_MAX_POWER; power++) {
+    double err = fabs(delivered_power(model, triacdrv_phase_from_power(power))
+                      - power);
+    if (err > worst)
+      worst = err;
+  }
+
+  return worst;
+}
+
+/***************************************************************************//**
+ * Worst deviation of the delivered power from the duty cycle of the
+ * earlier time-linear positioning.
+ ******************************************************************************/
+static double duty_linearity(const mains_model_t *model)
+{
+  double worst = 0;
+
+  for (uint32_t duty = 0; duty <= 100; duty++) {
+    double err = fabs(delivered_power(model, triacdrv_phase_from_duty(duty))
+                      - duty * 10.0);
+    if (err > worst)
+      worst = err;
+  }
+
+  return worst;
+}
+
+int main(void)
+{
+  mains_model_t model;
+  double err;
+  uint32_t last, power;
+  int monotonic = 1;
+
+  // Table lookups
+  CHECK(triacdrv_phase_from_power(0) == TRIACDRV_PHASE_OFF);
+  CHECK(triacdrv_phase_from_power(TRIACDRV_MAX_POWER) == 0);
+  CHECK(triacdrv_phase_from_power(500) == 32768);
+  CHECK(triacdrv_power_from_phase(TRIACDRV_PHASE_OFF) == 0);
+  CHECK(triacdrv_power_from_phase(0) == TRIACDRV_MAX_POWER);
+  CHECK(triacdrv_phase_from_duty(0) == TRIACDRV_PHASE_OFF);
+  CHECK(triacdrv_phase_from_duty(100) == 0);
+
+  last = 0;
+  for (power = 1; power <= TRIACDRV_MAX_POWER; power++) {
+    uint32_t phase = triacdrv_phase_from_power(power);
+    int32_t round_trip = (int32_t)triacdrv_power_from_phase(phase) - (int32_t)power;
+
+    if ((power > 1) && (phase > last))
+      monotonic = 0;
+    CHECK(round_trip >= -1 && round_trip <= 1);
+    last = phase;
+  }
+  CHECK(monotonic);
+
+  // Compare values
+  {
+    uint32_t rise = 0, fall = 0;
+
+    CHECK(!triacdrv_phase_compare(TRIACDRV_PHASE_OFF, 30000, 60, &rise, &fall));
+    CHECK(triacdrv_phase_compare(0, 30000, 60, &rise, &fall));
+    CHECK(rise == 0 && fall == 60);
+    CHECK(triacdrv_phase_compare(32768, 30000, 60, &rise, &fall));
+    CHECK(rise == 15000 && fall == 15060);
+    CHECK(triacdrv_phase_compare(65535, 30000, 60, &rise, &fall));
+    CHECK(fall <= 30000 - 60);
+    CHECK(!triacdrv_phase_compare(0, 100, 60, &rise, &fall));
+  }
+
+  // Delivered power with the minimum ACMP hysteresis
+  printf("worst power error (per-mille)\n");
+  printf("input      hysteresis   power setpoint   duty cycle x 10\n");
+
+  model_init(&model, 50.0, 5.0);
+  err = power_linearity(&model);
+  printf("50 Hz      %7.0f mV  %15.2f  %16.1f\n",
+         model.threshold_mv, err, duty_linearity(&model));
+  CHECK(err < 3.0);
+  CHECK(duty_linearity(&model) > 50.0);
+
+  model_init(&model, 60.0, 5.0);
+  err = power_linearity(&model);
+  printf("60 Hz      %7.0f mV  %15.2f  %16.1f\n",
+         model.threshold_mv, err, duty_linearity(&model));
+  CHECK(err < 3.0);
+
+  // Mains frequency off nominal: the setpoint follows the captured half-wave
+  model_init(&model, 49.5, 5.0);
+  err = power_linearity(&model);
+  printf("49.5 Hz    %7.0f mV  %15.2f  %16.1f\n",
+         model.threshold_mv, err, duty_linearity(&model));
+  CHECK(err < 3.0);
+
+  // The default hysteresis delays the edges, shown for reference
+  model_init(&model, 50.0, 200.0);
+  printf("50 Hz      %7.0f mV  %15.2f  %16.1f\n",
+         model.threshold_mv, power_linearity(&model), duty_linearity(&model));
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}
@@ -0,0 +1,322 @@
+/***************************************************************************//**
+* @file triacdrv_pll_test.c
+* @brief Host test of the mains zero-crossing estimator
+*
+* Feeds the estimator TIMER captures of a mains input with jitter,
+* frequency drift, glitches, dropped edges and loss of the mains, with the
+* 16-bit TIMER extended by its overflow count as the multi-load controller
+* does, and checks the lock time, the prediction error, the glitch
+* rejection and the scheduling of the gate enable pulses of four loads.
+*
+* Build and run on the host:
+*   gcc -O2 -I../inc triacdrv_pll_test.c ../src/triacdrv_pll.c -lm
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Evaluation Quality
+* This code has been minimally tested to ensure that it builds and is suitable
+* as a demonstration for evaluation purposes only. This code will be maintained
+* at the sole discretion of Silicon Labs.
+******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "triacdrv_pll.h"
+
+// HFPERCLK of the EFM32TG11 demonstration project (HFXO)
+#define HFPERCLK_HZ           48000000
+
+// Lead time of the gate enable compare values in TIMER ticks
+#define LEAD_TICKS            16
+
+// Number of loads scheduled from the estimator
+#define LOADS                 4
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("line %d: check failed: %s\n", __LINE__, #cond);    \
+      failed = 1;                                                \
+    }                                                            \
+  } while (0)
+
+static int failed = 0;
+
+// Mains input and TIMER
+typedef struct {
+  TRIACDRV_Pll_TypeDef pll;
+  double timer_hz;            // Prescaled TIMER clock
+  double t;                   // Time of the last true zero-crossing (s)
+  double line_hz;             // Mains frequency
+  double drift_hz;            // Change of the mains frequency per second
+  double jitter_s;            // Peak zero-crossing detector jitter
+  uint64_t coast_tick;        // Next TIMER overflow
+  double worst_err_us;        // Worst prediction error while locked
+  double sum_sq_err_us;
+  uint32_t predictions;
+} sim_t;
+
+/***************************************************************************//**
+ * Prescales the TIMER clock as triacdrv_ctrl_init() does, so that a full
+ * cycle at the lowest mains frequency fits in the 16-bit counter.
+ ******************************************************************************/
+static void sim_init(sim_t *sim, double line_hz, double jitter_us)
+{
+  uint32_t presc = 0;
+
+  while (((HFPERCLK_HZ >> presc) / TRIACDRV_PLL_MIN_FREQUENCY) >= 0xFFFF)
+    presc++;
+
+  sim->timer_hz = (double)(HFPERCLK_HZ >> presc);
+  sim->t = 0.01234;
+  sim->line_hz = line_hz;
+  sim->drift_hz = 0;
+  sim->jitter_s = jitter_us * 1e-6;
+  sim->coast_tick = 0x10000;
+  sim->worst_err_us = 0;
+  sim->sum_sq_err_us = 0;
+  sim->predictions = 0;
+  triacdrv_pll_init(&sim->pll, (uint32_t)sim->timer_hz);
+}
+
+static uint64_t sim_tick(const sim_t *sim, double t)
+{
+  return (uint64_t)floor(t * sim->timer_hz);
+}
+
+// Lower 24 bits of the extended TIMER count, as seen by the estimator
+static uint32_t sim_time(uint64_t tick)
+{
+  return (uint32_t)(tick & 0xFFFFFF);
+}
+
+static double sim_jitter(const sim_t *sim)
+{
+  return sim->jitter_s * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+/***************************************************************************//**
+ * Calls the coast function on every TIMER overflow up to tick.
+ ******************************************************************************/
+static void sim_coast(sim_t *sim, uint64_t tick)
+{
+  while (sim->coast_tick <= tick) {
+    triacdrv_pll_coast(&sim->pll, sim_time(sim->coast_tick));
+    sim->coast_tick += 0x10000;
+  }
+}
+
+/***************************************************************************//**
+ * Captures a detector edge, overflows before it included.
+ ******************************************************************************/
+static void sim_capture(sim_t *sim, double t)
+{
+  uint64_t tick = sim_tick(sim, t);
+
+  sim_coast(sim, tick);
+  triacdrv_pll_update(&sim->pll, sim_time(tick));
+}
+
+/***************************************************************************//**
+ * Runs half-waves.  Before each zero-crossing, the prediction made just
+ * after the previous capture is compared to the true zero-crossing.
+ * With drop set, the edges are lost; with glitches set, spurious edges are
+ * captured in the middle of each half-wave.
+ ******************************************************************************/
+static void sim_run(sim_t *sim, int half_waves, int drop, int glitches)
+{
+  for (int k = 0; k < half_waves; k++) {
+    double half = 1.0 / (2.0 * sim->line_hz);
+    double next = sim->t + half;
+    uint32_t predicted;
+
+    // Prediction made when the last edge was serviced
+    if (!drop && triacdrv_pll_schedule(&sim->pll,
+                                       sim_time(sim_tick(sim, sim->t) + 200),
+                                       0, LEAD_TICKS, &predicted)) {
+      int32_t diff = (int32_t)((predicted - sim_time(sim_tick(sim, next))) << 8) >> 8;
+      double err_us = fabs(diff / sim->timer_hz * 1e6);
+
+      if (err_us > sim->worst_err_us)
+        sim->worst_err_us = err_us;
+      sim->sum_sq_err_us += err_us * err_us;
+      sim->predictions++;
+    }
+
+    for (int g = 0; g < glitches; g++)
+      sim_capture(sim, sim->t + half * (0.2 + 0.6 * rand() / RAND_MAX));
+
+    sim->t = next;
+    sim->line_hz += sim->drift_hz * half;
+
+    if (!drop)
+      sim_capture(sim, sim->t + sim_jitter(sim));
+  }
+
+  sim_coast(sim, sim_tick(sim, sim->t));
+}
+
+static void sim_reset_stats(sim_t *sim)
+{
+  sim->worst_err_us = 0;
+  sim->sum_sq_err_us = 0;
+  sim->predictions = 0;
+}
+
+static double sim_rms_us(const sim_t *sim)
+{
+  return sim->predictions ? sqrt(sim->sum_sq_err_us / sim->predictions) : 0;
+}
+
+/***************************************************************************//**
+ * Half-waves needed to lock.
+ ******************************************************************************/
+static int sim_lock(sim_t *sim)
+{
+  int n = 0;
+
+  while (!triacdrv_pll_is_locked(&sim->pll) && (n < 100)) {
+    sim_run(sim, 1, 0, 0);
+    n++;
+  }
+
+  return n;
+}
+
+int main(void)
+{
+  sim_t sim;
+  int n;
+  uint32_t glitches, missed;
+
+  srand(1);
+
+  printf("scenario                  half-waves  worst (us)  rms (us)\n");
+
+  // Lock and track 50 Hz with 20 us of detector jitter
+  sim_init(&sim, 50.0, 20.0);
+  n = sim_lock(&sim);
+  CHECK(n <= TRIACDRV_PLL_LOCK_COUNT + 1);
+  sim_run(&sim, 20, 0, 0);
+  sim_reset_stats(&sim);
+  sim_run(&sim, 2000, 0, 0);
+  printf("50 Hz, 20 us jitter       %10d  %10.1f  %8.1f\n", n,
+         sim.worst_err_us, sim_rms_us(&sim));
+  CHECK(sim.worst_err_us < 40.0);
+  CHECK(sim_rms_us(&sim) < 15.0);
+  CHECK(llabs((int64_t)triacdrv_pll_get_frequency(&sim.pll) - 50000) < 50);
+
+  // 60 Hz
+  sim_init(&sim, 60.0, 20.0);
+  n = sim_lock(&sim);
+  CHECK(n <= TRIACDRV_PLL_LOCK_COUNT + 1);
+  sim_run(&sim, 20, 0, 0);
+  sim_reset_stats(&sim);
+  sim_run(&sim, 2000, 0, 0);
+  printf("60 Hz, 20 us jitter       %10d  %10.1f  %8.1f\n", n,
+         sim.worst_err_us, sim_rms_us(&sim));
+  CHECK(sim.worst_err_us < 40.0);
+  CHECK(llabs((int64_t)triacdrv_pll_get_frequency(&sim.pll) - 60000) < 60);
+
+  // Frequency drifting at 0.1 Hz/s, well beyond what grids do
+  sim_init(&sim, 49.5, 20.0);
+  sim_lock(&sim);
+  sim_run(&sim, 20, 0, 0);
+  sim_reset_stats(&sim);
+  sim.drift_hz = 0.1;
+  sim_run(&sim, 1000, 0, 0);
+  printf("49.5 Hz + 0.1 Hz/s        %10d  %10.1f  %8.1f\n", 1000,
+         sim.worst_err_us, sim_rms_us(&sim));
+  CHECK(triacdrv_pll_is_locked(&sim.pll));
+  CHECK(sim.worst_err_us < 50.0);
+  CHECK(llabs((int64_t)triacdrv_pll_get_frequency(&sim.pll)
+              - (int64_t)(sim.line_hz * 1000)) < 50);
+
+  // Glitch bursts: three spurious edges in every half-wave
+  sim_init(&sim, 50.0, 20.0);
+  sim_lock(&sim);
+  sim_run(&sim, 20, 0, 0);
+  sim_reset_stats(&sim);
+  glitches = sim.pll.glitches;
+  sim_run(&sim, 50, 0, 3);
+  printf("glitch bursts             %10d  %10.1f  %8.1f\n", 50,
+         sim.worst_err_us, sim_rms_us(&sim));
+  CHECK(triacdrv_pll_is_locked(&sim.pll));
+  CHECK(sim.pll.glitches - glitches == 150);
+  CHECK(sim.worst_err_us < 40.0);
+
+  // Dropped edges: the prediction carries on
+  missed = sim.pll.missed;
+  sim_run(&sim, 3, 1, 0);
+  sim_reset_stats(&sim);
+  sim_run(&sim, 10, 0, 0);
+  printf("3 dropped edges           %10d  %10.1f  %8.1f\n", 3,
+         sim.worst_err_us, sim_rms_us(&sim));
+  CHECK(triacdrv_pll_is_locked(&sim.pll));
+  CHECK(sim.pll.missed - missed == 3);
+  CHECK(sim.worst_err_us < 40.0);
+
+  // Loss of the mains: unlock, then lock again when it returns
+  sim_run(&sim, 50, 1, 0);
+  CHECK(!triacdrv_pll_is_locked(&sim.pll));
+  CHECK(triacdrv_pll_get_frequency(&sim.pll) == 0);
+  n = sim_lock(&sim);
+  printf("mains loss, relock        %10d\n", n);
+  CHECK(n <= TRIACDRV_PLL_LOCK_COUNT + 2);
+
+  // Gate enable pulses of four loads from the same prediction
+  {
+    static const uint32_t offset_permille[LOADS] = { 0, 250, 500, 900 };
+    uint32_t half_ticks, now;
+    double half;
+
+    sim_run(&sim, 20, 0, 0);
+    half = 1.0 / (2.0 * sim.line_hz);
+    half_ticks = triacdrv_pll_get_half_wave(&sim.pll);
+    now = sim_time(sim_tick(&sim, sim.t) + 200);
+
+    for (int i = 0; i < LOADS; i++) {
+      uint32_t offset = half_ticks * offset_permille[i] / 1000;
+      uint32_t time;
+      double expect = sim.t + (offset / sim.timer_hz);
+      int32_t diff;
+
+      // A load whose time in this half-wave has passed fires in the next one
+      if (offset < 200 + LEAD_TICKS)
+        expect += half;
+
+      CHECK(triacdrv_pll_schedule(&sim.pll, now, offset, LEAD_TICKS, &time));
+      diff = (int32_t)((time - sim_time(sim_tick(&sim, expect))) << 8) >> 8;
+      printf("load %d at %3u per-mille   %+.1f us\n", i,
+             (unsigned)offset_permille[i], diff / sim.timer_hz * 1e6);
+      CHECK(fabs(diff / sim.timer_hz * 1e6) < 40.0);
+    }
+  }
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+  return failed;
+}